@@ -59,6 +59,9 @@ vtkSMPToolsAPI::vtkSMPToolsAPI()
 
   // Set max thread number from env
   this->RefreshNumberOfThread();
+
+  // Enable the instrumentation from env
+  vtkSMPToolsInstrumentation::GetInstance();
 }
 
 //------------------------------------------------------------------------------
@@ -154,6 +157,16 @@ void vtkSMPToolsAPI::RefreshNumberOfThread()
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::Finalize()
+{
+  // Only the STDThread backend owns threads, the other backends rely on
+  // libraries managing theirs.
+#if VTK_SMP_ENABLE_STDTHREAD
+  vtkSMPThreadPool::GetInstance().Shutdown();
+#endif
+}
+
 //------------------------------------------------------------------------------
 int vtkSMPToolsAPI::GetEstimatedNumberOfThreads()
 {
@@ -191,6 +204,30 @@ void vtkSMPToolsAPI::SetNestedParallelism(bool isNested)
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::SetInstrumentation(bool enable)
+{
+  vtkSMPToolsInstrumentation::GetInstance().SetEnabled(enable);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsAPI::GetInstrumentation()
+{
+  return vtkSMPToolsInstrumentation::IsEnabled();
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::SetInstrumentationVerbosity(int verbosity)
+{
+  vtkSMPToolsInstrumentation::GetInstance().SetLogVerbosity(verbosity);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsAPI::WriteInstrumentationTrace(const char* fileName)
+{
+  return fileName && vtkSMPToolsInstrumentation::GetInstance().WriteChromeTrace(fileName);
+}
+
 //------------------------------------------------------------------------------
 bool vtkSMPToolsAPI::GetNestedParallelism()
 {
@@ -24,6 +24,7 @@
 #include <memory>
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Common/vtkSMPToolsInstrumentation.h" // For vtkSMPToolsInstrumentedFunctor
 #if VTK_SMP_ENABLE_SEQUENTIAL
 #include "SMP/Sequential/vtkSMPToolsImpl.txx"
 #endif
@@ -64,6 +65,9 @@ public:
   //--------------------------------------------------------------------------------
   void Initialize(int numThreads = 0);
 
+  //--------------------------------------------------------------------------------
+  void Finalize();
+
   //--------------------------------------------------------------------------------
   int GetEstimatedNumberOfThreads();
 
@@ -104,23 +108,30 @@ public:
   template <typename FunctorInternal>
   void For(vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
   {
-    switch (this->ActivatedBackend)
+    if (vtkSMPToolsInstrumentation::IsEnabled())
     {
-      case BackendType::Sequential:
-        this->SequentialBackend->For(first, last, grain, fi);
-        break;
-      case BackendType::STDThread:
-        this->STDThreadBackend->For(first, last, grain, fi);
-        break;
-      case BackendType::TBB:
-        this->TBBBackend->For(first, last, grain, fi);
-        break;
-      case BackendType::OpenMP:
-        this->OpenMPBackend->For(first, last, grain, fi);
-        break;
+      vtkSMPToolsInstrumentedFunctor ifi(
+        &fi, ExecuteInstrumentedFunctor<FunctorInternal>, typeid(FunctorInternal));
+      this->DispatchFor(first, last, grain, ifi);
+    }
+    else
+    {
+      this->DispatchFor(first, last, grain, fi);
     }
   }
 
+  //--------------------------------------------------------------------------------
+  void SetInstrumentation(bool enable);
+
+  //--------------------------------------------------------------------------------
+  bool GetInstrumentation();
+
+  //--------------------------------------------------------------------------------
+  void SetInstrumentationVerbosity(int verbosity);
+
+  //--------------------------------------------------------------------------------
+  bool WriteInstrumentationTrace(const char* fileName);
+
   //--------------------------------------------------------------------------------
   template <typename InputIt, typename OutputIt, typename Functor>
   void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin, Functor& transform)
@@ -227,6 +238,66 @@ public:
     }
   }
 
+  //--------------------------------------------------------------------------------
+  template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+  T TransformReduce(InputIt inBegin, InputIt inEnd, T init, ReduceOp reduce, TransformOp transform)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        return this->SequentialBackend->TransformReduce(inBegin, inEnd, init, reduce, transform);
+      case BackendType::STDThread:
+        return this->STDThreadBackend->TransformReduce(inBegin, inEnd, init, reduce, transform);
+      case BackendType::TBB:
+        return this->TBBBackend->TransformReduce(inBegin, inEnd, init, reduce, transform);
+      case BackendType::OpenMP:
+        return this->OpenMPBackend->TransformReduce(inBegin, inEnd, init, reduce, transform);
+    }
+    return init;
+  }
+
+  //--------------------------------------------------------------------------------
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  void InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->InclusiveScan(inBegin, inEnd, outBegin, op);
+        break;
+      case BackendType::STDThread:
+        this->STDThreadBackend->InclusiveScan(inBegin, inEnd, outBegin, op);
+        break;
+      case BackendType::TBB:
+        this->TBBBackend->InclusiveScan(inBegin, inEnd, outBegin, op);
+        break;
+      case BackendType::OpenMP:
+        this->OpenMPBackend->InclusiveScan(inBegin, inEnd, outBegin, op);
+        break;
+    }
+  }
+
+  //--------------------------------------------------------------------------------
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  void ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->ExclusiveScan(inBegin, inEnd, outBegin, init, op);
+        break;
+      case BackendType::STDThread:
+        this->STDThreadBackend->ExclusiveScan(inBegin, inEnd, outBegin, init, op);
+        break;
+      case BackendType::TBB:
+        this->TBBBackend->ExclusiveScan(inBegin, inEnd, outBegin, init, op);
+        break;
+      case BackendType::OpenMP:
+        this->OpenMPBackend->ExclusiveScan(inBegin, inEnd, outBegin, init, op);
+        break;
+    }
+  }
+
   // disable copying
   vtkSMPToolsAPI(vtkSMPToolsAPI const&) = delete;
   void operator=(vtkSMPToolsAPI const&) = delete;
@@ -235,6 +306,27 @@ private:
   //--------------------------------------------------------------------------------
   vtkSMPToolsAPI();
 
+  //--------------------------------------------------------------------------------
+  template <typename FunctorInternal>
+  void DispatchFor(vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->For(first, last, grain, fi);
+        break;
+      case BackendType::STDThread:
+        this->STDThreadBackend->For(first, last, grain, fi);
+        break;
+      case BackendType::TBB:
+        this->TBBBackend->For(first, last, grain, fi);
+        break;
+      case BackendType::OpenMP:
+        this->OpenMPBackend->For(first, last, grain, fi);
+        break;
+    }
+  }
+
   //--------------------------------------------------------------------------------
   void RefreshNumberOfThread();
 
@@ -0,0 +1,296 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsInstrumentation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/Common/vtkSMPToolsInstrumentation.h"
+#include "vtkLogger.h"
+
+#include <algorithm> // For std::max
+#include <cstdlib>   // For std::getenv, std::free
+#include <fstream>   // For std::ofstream
+#include <iomanip>   // For std::setprecision
+
+#if defined(__GNUG__)
+#include <cxxabi.h> // For abi::__cxa_demangle
+#endif
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+namespace
+{
+// Maximum number of loops kept for the Chrome trace between two writes.
+constexpr std::size_t MaximumNumberOfTraceRegions = 1 << 16;
+
+thread_local std::vector<std::string> LocalLabels;
+
+//------------------------------------------------------------------------------
+std::string GetFunctorLabel(const std::type_info& type)
+{
+  std::string name = type.name();
+#if defined(__GNUG__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+  if (status == 0 && demangled)
+  {
+    name = demangled;
+  }
+  std::free(demangled);
+#endif
+
+  // Strip the vtkSMPTools wrapper to keep the user functor only.
+  const std::string wrapper = "vtkSMPTools_FunctorInternal<";
+  const std::size_t begin = name.find(wrapper);
+  const std::size_t end = name.rfind(',');
+  if (begin != std::string::npos && end != std::string::npos && end > begin)
+  {
+    name = name.substr(begin + wrapper.size(), end - begin - wrapper.size());
+  }
+  return name;
+}
+
+//------------------------------------------------------------------------------
+double ToSeconds(vtkSMPToolsInstrumentation::Clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+//------------------------------------------------------------------------------
+void WriteJSONString(std::ostream& os, const std::string& text)
+{
+  os << '"';
+  for (char c : text)
+  {
+    switch (c)
+    {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        os << c;
+    }
+  }
+  os << '"';
+}
+}
+
+std::atomic<bool> vtkSMPToolsInstrumentation::Enabled(false);
+
+//------------------------------------------------------------------------------
+vtkSMPToolsInstrumentation& vtkSMPToolsInstrumentation::GetInstance()
+{
+  static vtkSMPToolsInstrumentation instance;
+  return instance;
+}
+
+//------------------------------------------------------------------------------
+vtkSMPToolsInstrumentation::vtkSMPToolsInstrumentation()
+  : LogVerbosity(vtkLogger::VERBOSITY_INFO)
+  , Epoch(Clock::now())
+{
+  const char* enabled = std::getenv("VTK_SMP_INSTRUMENTATION");
+  const char* traceFileName = std::getenv("VTK_SMP_INSTRUMENTATION_TRACE");
+  if (traceFileName)
+  {
+    this->TraceFileName = traceFileName;
+  }
+  if ((enabled && std::atoi(enabled) != 0) || !this->TraceFileName.empty())
+  {
+    Enabled = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkSMPToolsInstrumentation::~vtkSMPToolsInstrumentation()
+{
+  if (!this->TraceFileName.empty())
+  {
+    this->WriteChromeTrace(this->TraceFileName);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsInstrumentation::SetEnabled(bool enabled)
+{
+  Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsInstrumentation::PushLabel(const char* label)
+{
+  LocalLabels.emplace_back(label ? label : "");
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsInstrumentation::PopLabel()
+{
+  if (!LocalLabels.empty())
+  {
+    LocalLabels.pop_back();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsInstrumentation::Report(RegionStatistics& region)
+{
+  double totalBusyTime = 0.0;
+  double maxBusyTime = 0.0;
+  for (const auto& thread : region.Threads)
+  {
+    totalBusyTime += thread.BusyTime;
+    maxBusyTime = std::max(maxBusyTime, thread.BusyTime);
+  }
+  const double meanBusyTime =
+    region.Threads.empty() ? 0.0 : totalBusyTime / static_cast<double>(region.Threads.size());
+  region.ImbalanceRatio = meanBusyTime > 0.0 ? maxBusyTime / meanBusyTime : 1.0;
+
+  vtkVLogF(vtkLogger::ConvertToVerbosity(this->LogVerbosity),
+    "vtkSMPTools::For '%s': %.3f ms, %lld chunks on %d threads, busy %.3f ms, imbalance %.2f",
+    region.Label.c_str(), 1000.0 * ToSeconds(region.End - region.Start),
+    static_cast<long long>(region.NumberOfChunks), static_cast<int>(region.Threads.size()),
+    1000.0 * totalBusyTime, region.ImbalanceRatio);
+
+  std::lock_guard<std::mutex> lock(this->TraceMutex);
+  if (this->TraceRegions.size() < MaximumNumberOfTraceRegions)
+  {
+    this->TraceRegions.emplace_back(std::move(region));
+  }
+  else if (!this->TraceOverflow)
+  {
+    this->TraceOverflow = true;
+    vtkLogF(WARNING,
+      "Too many vtkSMPTools::For recorded, the trace will be truncated. "
+      "Use vtkSMPTools::WriteInstrumentationTrace to write it more often.");
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkSMPToolsInstrumentation::GetTraceThreadId(std::thread::id id)
+{
+  auto it = std::find(this->TraceThreads.begin(), this->TraceThreads.end(), id);
+  if (it == this->TraceThreads.end())
+  {
+    this->TraceThreads.push_back(id);
+    return static_cast<int>(this->TraceThreads.size() - 1);
+  }
+  return static_cast<int>(it - this->TraceThreads.begin());
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsInstrumentation::WriteChromeTrace(const std::string& fileName)
+{
+  std::ofstream file(fileName);
+  if (!file)
+  {
+    vtkLogF(ERROR, "Cannot open '%s' to write the vtkSMPTools trace.", fileName.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->TraceMutex);
+  auto toMicroSeconds = [this](Clock::time_point time) {
+    return 1e6 * ToSeconds(time - this->Epoch);
+  };
+
+  // One event for the whole loop on the calling thread, then one event per
+  // thread spanning from its first chunk to its last one.
+  file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& region : this->TraceRegions)
+  {
+    file << (first ? "\n" : ",\n") << "{\"name\":";
+    first = false;
+    WriteJSONString(file, region.Label);
+    file << ",\"cat\":\"vtkSMPTools::For\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+         << this->GetTraceThreadId(region.CallingThread)
+         << ",\"ts\":" << toMicroSeconds(region.Start)
+         << ",\"dur\":" << toMicroSeconds(region.End) - toMicroSeconds(region.Start)
+         << ",\"args\":{\"chunks\":" << region.NumberOfChunks
+         << ",\"threads\":" << region.Threads.size() << ",\"imbalance\":" << region.ImbalanceRatio
+         << "}}";
+
+    for (const auto& thread : region.Threads)
+    {
+      file << ",\n{\"name\":";
+      WriteJSONString(file, region.Label);
+      file << ",\"cat\":\"vtkSMPTools::Chunks\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+           << this->GetTraceThreadId(thread.Id) << ",\"ts\":" << toMicroSeconds(thread.FirstStart)
+           << ",\"dur\":" << toMicroSeconds(thread.LastEnd) - toMicroSeconds(thread.FirstStart)
+           << ",\"args\":{\"chunks\":" << thread.NumberOfChunks
+           << ",\"busy_ms\":" << 1000.0 * thread.BusyTime << "}}";
+    }
+  }
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  this->TraceRegions.clear();
+  this->TraceOverflow = false;
+  return static_cast<bool>(file);
+}
+
+//------------------------------------------------------------------------------
+vtkSMPToolsInstrumentedFunctor::vtkSMPToolsInstrumentedFunctor(
+  void* functor, ExecutePtrType execute, const std::type_info& type)
+  : Functor(functor)
+  , ExecuteFunctor(execute)
+{
+  this->Statistics.Label =
+    LocalLabels.empty() ? GetFunctorLabel(type) : LocalLabels.back();
+  this->Statistics.CallingThread = std::this_thread::get_id();
+  this->Statistics.Start = vtkSMPToolsInstrumentation::Clock::now();
+}
+
+//------------------------------------------------------------------------------
+vtkSMPToolsInstrumentedFunctor::~vtkSMPToolsInstrumentedFunctor()
+{
+  this->Statistics.End = vtkSMPToolsInstrumentation::Clock::now();
+  vtkSMPToolsInstrumentation::GetInstance().Report(this->Statistics);
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsInstrumentedFunctor::Execute(vtkIdType first, vtkIdType last)
+{
+  const auto start = vtkSMPToolsInstrumentation::Clock::now();
+  this->ExecuteFunctor(this->Functor, first, last);
+  const auto end = vtkSMPToolsInstrumentation::Clock::now();
+
+  const std::thread::id id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  auto& threads = this->Statistics.Threads;
+  auto it = std::find_if(threads.begin(), threads.end(),
+    [&id](const vtkSMPToolsInstrumentation::ThreadStatistics& thread) { return thread.Id == id; });
+  if (it == threads.end())
+  {
+    threads.emplace_back();
+    it = threads.end() - 1;
+    it->Id = id;
+    it->FirstStart = start;
+  }
+  it->NumberOfChunks++;
+  it->BusyTime += ToSeconds(end - start);
+  it->LastEnd = end;
+  this->Statistics.NumberOfChunks++;
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
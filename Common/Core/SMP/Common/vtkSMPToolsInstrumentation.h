@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsInstrumentation.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPToolsInstrumentation - Opt-in profiling of vtkSMPTools::For
+//
+// .SECTION Description
+// When enabled, every vtkSMPTools::For is executed through an
+// vtkSMPToolsInstrumentedFunctor which measures the wall time of the loop,
+// the number of chunks and the busy time of each thread taking part in it.
+// The imbalance ratio of the loop is the busy time of the busiest thread
+// divided by the average busy time of the participating threads: 1 means a
+// perfectly balanced loop.
+//
+// Each loop is reported through vtkLogger and can also be recorded to be
+// exported as a Chrome trace JSON file (chrome://tracing, Perfetto).
+// The loops are labelled with the innermost vtkSMPTools::InstrumentationScope
+// of the calling thread, or with the name of the functor type otherwise.
+//
+// The instrumentation can also be enabled without modifying the code with
+// the VTK_SMP_INSTRUMENTATION environment variable. If
+// VTK_SMP_INSTRUMENTATION_TRACE is set to a file name, the trace is written
+// to this file when the process exits.
+
+#ifndef vtkSMPToolsInstrumentation_h
+#define vtkSMPToolsInstrumentation_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#include <atomic>   // For std::atomic
+#include <chrono>   // For std::chrono
+#include <mutex>    // For std::mutex
+#include <string>   // For std::string
+#include <thread>   // For std::thread::id
+#include <typeinfo> // For std::type_info
+#include <vector>   // For std::vector
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+class VTKCOMMONCORE_EXPORT vtkSMPToolsInstrumentation
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static vtkSMPToolsInstrumentation& GetInstance();
+
+  ~vtkSMPToolsInstrumentation();
+
+  // Cheap check done by vtkSMPToolsAPI before each For.
+  static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+  void SetEnabled(bool enabled);
+
+  // Verbosity used to log each loop, see vtkLogger::Verbosity.
+  void SetLogVerbosity(int verbosity) { this->LogVerbosity = verbosity; }
+  int GetLogVerbosity() { return this->LogVerbosity; }
+
+  // Write the loops recorded since the last call as a Chrome trace JSON file.
+  bool WriteChromeTrace(const std::string& fileName);
+
+  // Explicit labels, see vtkSMPTools::InstrumentationScope.
+  static void PushLabel(const char* label);
+  static void PopLabel();
+
+  // Statistics of a finished loop.
+  struct ThreadStatistics
+  {
+    std::thread::id Id;
+    vtkIdType NumberOfChunks = 0;
+    double BusyTime = 0.0; // seconds
+    Clock::time_point FirstStart;
+    Clock::time_point LastEnd;
+  };
+
+  struct RegionStatistics
+  {
+    std::string Label;
+    std::thread::id CallingThread;
+    Clock::time_point Start;
+    Clock::time_point End;
+    vtkIdType NumberOfChunks = 0;
+    double ImbalanceRatio = 1.0;
+    std::vector<ThreadStatistics> Threads;
+  };
+
+  void Report(RegionStatistics& region);
+
+  vtkSMPToolsInstrumentation(vtkSMPToolsInstrumentation const&) = delete;
+  void operator=(vtkSMPToolsInstrumentation const&) = delete;
+
+private:
+  vtkSMPToolsInstrumentation();
+
+  int GetTraceThreadId(std::thread::id id);
+
+  static std::atomic<bool> Enabled;
+  int LogVerbosity;
+  Clock::time_point Epoch;
+  std::string TraceFileName;
+
+  std::mutex TraceMutex;
+  std::vector<RegionStatistics> TraceRegions;
+  std::vector<std::thread::id> TraceThreads;
+  bool TraceOverflow = false;
+};
+
+// Type erased wrapper around the FunctorInternal of a For which measures each
+// chunk. Being non-template, the backends only instantiate their For once for
+// all the instrumented functors.
+class VTKCOMMONCORE_EXPORT vtkSMPToolsInstrumentedFunctor
+{
+public:
+  using ExecutePtrType = void (*)(void*, vtkIdType, vtkIdType);
+
+  vtkSMPToolsInstrumentedFunctor(void* functor, ExecutePtrType execute, const std::type_info& type);
+  ~vtkSMPToolsInstrumentedFunctor();
+
+  void Execute(vtkIdType first, vtkIdType last);
+
+  vtkSMPToolsInstrumentedFunctor(vtkSMPToolsInstrumentedFunctor const&) = delete;
+  void operator=(vtkSMPToolsInstrumentedFunctor const&) = delete;
+
+private:
+  void* Functor;
+  ExecutePtrType ExecuteFunctor;
+  std::mutex Mutex;
+  vtkSMPToolsInstrumentation::RegionStatistics Statistics;
+};
+
+template <typename FunctorInternal>
+void ExecuteInstrumentedFunctor(void* functor, vtkIdType first, vtkIdType last)
+{
+  reinterpret_cast<FunctorInternal*>(functor)->Execute(first, last);
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
@@ -16,7 +16,10 @@
 #ifndef vtkSMPToolsInternal_h
 #define vtkSMPToolsInternal_h
 
-#include <iterator> // For std::advance
+#include <algorithm> // For std::min, std::sort, std::merge
+#include <iterator>    // For std::advance
+#include <type_traits> // For std::is_default_constructible
+#include <vector>      // For std::vector
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace vtk
@@ -101,6 +104,422 @@ public:
   T operator()(T vtkNotUsed(inValue)) { return Value; }
 };
 
+struct IdentityFunctor
+{
+  template <typename T>
+  const T& operator()(const T& value) const
+  {
+    return value;
+  }
+};
+
+// Wraps the per-block results of the blocked reductions so that
+// std::vector<bool> is never used: its elements cannot be written concurrently.
+template <typename T>
+struct ReduceSlot
+{
+  T Value;
+};
+
+// Split [0, size) into blocks processed by the blocked reduce and scan
+// implementations. A few blocks per thread keeps the load balanced while the
+// minimum block size keeps the serial combination of the blocks negligible.
+struct ReduceBlocks
+{
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  vtkIdType NumberOfBlocks;
+
+  ReduceBlocks(vtkIdType size, int numberOfThreads)
+    : Size(size)
+  {
+    const vtkIdType minBlockSize = 1024;
+    const vtkIdType maxBlocks = std::max<vtkIdType>(1, (size + minBlockSize - 1) / minBlockSize);
+    const vtkIdType numberOfBlocks =
+      std::min<vtkIdType>(maxBlocks, 4 * static_cast<vtkIdType>(std::max(1, numberOfThreads)));
+    this->BlockSize = (size + numberOfBlocks - 1) / numberOfBlocks;
+    this->NumberOfBlocks = (size + this->BlockSize - 1) / this->BlockSize;
+  }
+
+  vtkIdType GetBegin(vtkIdType block) const { return block * this->BlockSize; }
+  vtkIdType GetEnd(vtkIdType block) const
+  {
+    return std::min(this->Size, (block + 1) * this->BlockSize);
+  }
+};
+
+template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+class TransformReduceCall
+{
+  InputIt In;
+  const ReduceBlocks& Blocks;
+  ReduceOp& Reduce;
+  TransformOp& Transform;
+  std::vector<ReduceSlot<T>>& Partials;
+
+public:
+  TransformReduceCall(InputIt _in, const ReduceBlocks& _blocks, ReduceOp& _reduce,
+    TransformOp& _transform, std::vector<ReduceSlot<T>>& _partials)
+    : In(_in)
+    , Blocks(_blocks)
+    , Reduce(_reduce)
+    , Transform(_transform)
+    , Partials(_partials)
+  {
+  }
+
+  void Execute(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType begin = this->Blocks.GetBegin(block);
+      const vtkIdType end = this->Blocks.GetEnd(block);
+      InputIt itIn(In);
+      std::advance(itIn, begin);
+      T value = Transform(*itIn);
+      ++itIn;
+      for (vtkIdType it = begin + 1; it < end; it++)
+      {
+        value = Reduce(value, Transform(*itIn));
+        ++itIn;
+      }
+      this->Partials[block].Value = value;
+    }
+  }
+};
+
+// Second pass of the blocked scans: every block is scanned starting from the
+// carry computed from the sums of the previous blocks.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+class ScanCall
+{
+  InputIt In;
+  OutputIt Out;
+  const ReduceBlocks& Blocks;
+  BinaryOp& Op;
+  const std::vector<ReduceSlot<T>>& Carries;
+  bool Exclusive;
+
+public:
+  ScanCall(InputIt _in, OutputIt _out, const ReduceBlocks& _blocks, BinaryOp& _op,
+    const std::vector<ReduceSlot<T>>& _carries, bool _exclusive)
+    : In(_in)
+    , Out(_out)
+    , Blocks(_blocks)
+    , Op(_op)
+    , Carries(_carries)
+    , Exclusive(_exclusive)
+  {
+  }
+
+  void Execute(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType begin = this->Blocks.GetBegin(block);
+      const vtkIdType end = this->Blocks.GetEnd(block);
+      InputIt itIn(In);
+      OutputIt itOut(Out);
+      std::advance(itIn, begin);
+      std::advance(itOut, begin);
+      if (this->Exclusive)
+      {
+        T carry = this->Carries[block].Value;
+        for (vtkIdType it = begin; it < end; it++)
+        {
+          // Read before writing so that the scan can be done in place.
+          T value = *itIn;
+          *itOut = carry;
+          carry = Op(carry, value);
+          ++itIn;
+          ++itOut;
+        }
+      }
+      else
+      {
+        // Inclusive scans have no initial value: the first block starts from
+        // its first element.
+        T carry = block == 0 ? T(*itIn) : Op(this->Carries[block].Value, *itIn);
+        *itOut = carry;
+        ++itIn;
+        ++itOut;
+        for (vtkIdType it = begin + 1; it < end; it++)
+        {
+          carry = Op(carry, *itIn);
+          *itOut = carry;
+          ++itIn;
+          ++itOut;
+        }
+      }
+    }
+  }
+};
+
+// Parallel TransformReduce built on top of the For of a backend. The blocks
+// are combined in order, so op only needs to be associative and the result
+// does not depend on how the blocks were scheduled.
+template <typename Backend, typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+T BlockedTransformReduce(
+  Backend& backend, InputIt begin, InputIt end, T init, ReduceOp reduce, TransformOp transform)
+{
+  const vtkIdType size = std::distance(begin, end);
+  if (size <= 0)
+  {
+    return init;
+  }
+
+  ReduceBlocks blocks(size, backend.GetEstimatedNumberOfThreads());
+  std::vector<ReduceSlot<T>> partials(blocks.NumberOfBlocks, ReduceSlot<T>{ init });
+  TransformReduceCall<InputIt, T, ReduceOp, TransformOp> exec(
+    begin, blocks, reduce, transform, partials);
+  backend.For(0, blocks.NumberOfBlocks, 1, exec);
+
+  T result = init;
+  for (const auto& partial : partials)
+  {
+    result = reduce(result, partial.Value);
+  }
+  return result;
+}
+
+// Parallel scan built on top of the For of a backend: the sums of the blocks
+// are computed in parallel, scanned serially, then each block is scanned in
+// parallel from its carry. When exclusive is false, init is ignored.
+template <typename Backend, typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+void BlockedScan(Backend& backend, InputIt begin, InputIt end, OutputIt outBegin, T init,
+  BinaryOp op, bool exclusive)
+{
+  const vtkIdType size = std::distance(begin, end);
+  if (size <= 0)
+  {
+    return;
+  }
+
+  ReduceBlocks blocks(size, backend.GetEstimatedNumberOfThreads());
+  std::vector<ReduceSlot<T>> carries(blocks.NumberOfBlocks, ReduceSlot<T>{ init });
+  if (blocks.NumberOfBlocks > 1)
+  {
+    IdentityFunctor identity;
+    std::vector<ReduceSlot<T>> sums(blocks.NumberOfBlocks, ReduceSlot<T>{ init });
+    TransformReduceCall<InputIt, T, BinaryOp, IdentityFunctor> reduceExec(
+      begin, blocks, op, identity, sums);
+    // The last block sum is never used.
+    backend.For(0, blocks.NumberOfBlocks - 1, 1, reduceExec);
+
+    carries[1].Value = exclusive ? op(init, sums[0].Value) : sums[0].Value;
+    for (vtkIdType block = 2; block < blocks.NumberOfBlocks; ++block)
+    {
+      carries[block].Value = op(carries[block - 1].Value, sums[block - 1].Value);
+    }
+  }
+
+  ScanCall<InputIt, OutputIt, T, BinaryOp> scanExec(
+    begin, outBegin, blocks, op, carries, exclusive);
+  backend.For(0, blocks.NumberOfBlocks, 1, scanExec);
+}
+
+struct LessFunctor
+{
+  template <typename T>
+  bool operator()(const T& a, const T& b) const
+  {
+    return a < b;
+  }
+};
+
+template <typename RandomAccessIterator, typename Compare>
+class SortCall
+{
+protected:
+  RandomAccessIterator Begin;
+  const ReduceBlocks& Blocks;
+  Compare& Comp;
+
+public:
+  SortCall(RandomAccessIterator _begin, const ReduceBlocks& _blocks, Compare& _comp)
+    : Begin(_begin)
+    , Blocks(_blocks)
+    , Comp(_comp)
+  {
+  }
+
+  void Execute(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; block++)
+    {
+      std::sort(this->Begin + this->Blocks.GetBegin(block),
+        this->Begin + this->Blocks.GetEnd(block), this->Comp);
+    }
+  }
+};
+
+// Merges pairs of sorted runs of blocks from Input into Output. Each task
+// writes one block of the output: the parts of the two runs merged into this
+// block are found by a binary search along the merge path, so that the last
+// merges are as parallel as the first ones.
+template <typename InputIt, typename OutputIt, typename Compare>
+class MergeCall
+{
+protected:
+  InputIt Input;
+  OutputIt Output;
+  const ReduceBlocks& Blocks;
+  Compare& Comp;
+
+  // Number of elements of a taken from the first k elements of the stable
+  // merge of a (size m) and b (size n).
+  vtkIdType CoRank(InputIt a, vtkIdType m, InputIt b, vtkIdType n, vtkIdType k) const
+  {
+    vtkIdType low = std::max<vtkIdType>(0, k - n);
+    vtkIdType high = std::min(k, m);
+    while (low < high)
+    {
+      const vtkIdType i = low + (high - low) / 2;
+      if (this->Comp(b[k - i - 1], a[i]))
+      {
+        high = i;
+      }
+      else
+      {
+        low = i + 1;
+      }
+    }
+    return low;
+  }
+
+public:
+  // Number of sorted blocks in each of the two runs merged together.
+  vtkIdType RunSize = 1;
+
+  MergeCall(InputIt _input, OutputIt _output, const ReduceBlocks& _blocks, Compare& _comp)
+    : Input(_input)
+    , Output(_output)
+    , Blocks(_blocks)
+    , Comp(_comp)
+  {
+  }
+
+  void Execute(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; block++)
+    {
+      const vtkIdType firstBlock = block - block % (2 * this->RunSize);
+      const vtkIdType middleBlock =
+        std::min(firstBlock + this->RunSize, this->Blocks.NumberOfBlocks);
+      const vtkIdType lastBlock =
+        std::min(firstBlock + 2 * this->RunSize, this->Blocks.NumberOfBlocks);
+
+      const vtkIdType first = this->Blocks.GetBegin(firstBlock);
+      const vtkIdType middle = this->Blocks.GetEnd(middleBlock - 1);
+      const vtkIdType last = this->Blocks.GetEnd(lastBlock - 1);
+      const vtkIdType outBegin = this->Blocks.GetBegin(block);
+      const vtkIdType outEnd = this->Blocks.GetEnd(block);
+
+      InputIt a = this->Input + first;
+      InputIt b = this->Input + middle;
+      const vtkIdType m = middle - first;
+      const vtkIdType n = last - middle;
+      const vtkIdType i0 = this->CoRank(a, m, b, n, outBegin - first);
+      const vtkIdType i1 = this->CoRank(a, m, b, n, outEnd - first);
+      const vtkIdType j0 = outBegin - first - i0;
+      const vtkIdType j1 = outEnd - first - i1;
+      std::merge(std::make_move_iterator(a + i0), std::make_move_iterator(a + i1),
+        std::make_move_iterator(b + j0), std::make_move_iterator(b + j1), this->Output + outBegin,
+        this->Comp);
+    }
+  }
+};
+
+template <typename InputIt, typename OutputIt>
+class MoveCall
+{
+protected:
+  InputIt Input;
+  OutputIt Output;
+  const ReduceBlocks& Blocks;
+
+public:
+  MoveCall(InputIt _input, OutputIt _output, const ReduceBlocks& _blocks)
+    : Input(_input)
+    , Output(_output)
+    , Blocks(_blocks)
+  {
+  }
+
+  void Execute(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const vtkIdType first = this->Blocks.GetBegin(beginBlock);
+    const vtkIdType last = this->Blocks.GetEnd(endBlock - 1);
+    std::move(this->Input + first, this->Input + last, this->Output + first);
+  }
+};
+
+// Values that cannot be default constructed in the merge buffer are sorted
+// serially.
+template <typename Backend, typename RandomAccessIterator, typename Compare>
+void BlockedSort(Backend& vtkNotUsed(backend), RandomAccessIterator begin,
+  RandomAccessIterator end, Compare comp, std::false_type)
+{
+  std::sort(begin, end, comp);
+}
+
+// Parallel merge sort built on top of the For of a backend: the blocks are
+// sorted in parallel, then pairs of sorted runs are merged in parallel, back
+// and forth between the range and a buffer, until a single run remains.
+template <typename Backend, typename RandomAccessIterator, typename Compare>
+void BlockedSort(Backend& backend, RandomAccessIterator begin, RandomAccessIterator end,
+  Compare comp, std::true_type)
+{
+  using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using BufferIterator = typename std::vector<ValueType>::iterator;
+
+  const vtkIdType size = std::distance(begin, end);
+  ReduceBlocks blocks(size, backend.GetEstimatedNumberOfThreads());
+  if (blocks.NumberOfBlocks <= 1)
+  {
+    std::sort(begin, end, comp);
+    return;
+  }
+
+  SortCall<RandomAccessIterator, Compare> sortExec(begin, blocks, comp);
+  backend.For(0, blocks.NumberOfBlocks, 1, sortExec);
+
+  std::vector<ValueType> buffer(size);
+  MergeCall<RandomAccessIterator, BufferIterator, Compare> toBuffer(
+    begin, buffer.begin(), blocks, comp);
+  MergeCall<BufferIterator, RandomAccessIterator, Compare> fromBuffer(
+    buffer.begin(), begin, blocks, comp);
+  bool inBuffer = false;
+  for (vtkIdType runSize = 1; runSize < blocks.NumberOfBlocks; runSize *= 2)
+  {
+    if (inBuffer)
+    {
+      fromBuffer.RunSize = runSize;
+      backend.For(0, blocks.NumberOfBlocks, 1, fromBuffer);
+    }
+    else
+    {
+      toBuffer.RunSize = runSize;
+      backend.For(0, blocks.NumberOfBlocks, 1, toBuffer);
+    }
+    inBuffer = !inBuffer;
+  }
+
+  if (inBuffer)
+  {
+    MoveCall<BufferIterator, RandomAccessIterator> moveExec(buffer.begin(), begin, blocks);
+    backend.For(0, blocks.NumberOfBlocks, 1, moveExec);
+  }
+}
+
+template <typename Backend, typename RandomAccessIterator, typename Compare>
+void BlockedSort(
+  Backend& backend, RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  BlockedSort(backend, begin, end, comp, std::is_default_constructible<ValueType>());
+}
+
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -126,7 +126,7 @@ template <typename RandomAccessIterator>
 void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end)
 {
-  std::sort(begin, end);
+  BlockedSort(*this, begin, end, LessFunctor());
 }
 
 //--------------------------------------------------------------------------------
@@ -135,7 +135,35 @@ template <typename RandomAccessIterator, typename Compare>
 void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
 {
-  std::sort(begin, end, comp);
+  BlockedSort(*this, begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+T vtkSMPToolsImpl<BackendType::OpenMP>::TransformReduce(
+  InputIt inBegin, InputIt inEnd, T init, ReduceOp reduce, TransformOp transform)
+{
+  return BlockedTransformReduce(*this, inBegin, inEnd, init, reduce, transform);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::OpenMP>::InclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+{
+  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  BlockedScan(*this, inBegin, inEnd, outBegin, ValueType(), op, false);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::OpenMP>::ExclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+{
+  BlockedScan(*this, inBegin, inEnd, outBegin, init, op, true);
 }
 
 //--------------------------------------------------------------------------------
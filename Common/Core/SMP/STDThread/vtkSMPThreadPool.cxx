@@ -15,65 +15,374 @@
 
 #include "SMP/STDThread/vtkSMPThreadPool.h"
 
-#include <iostream>
+#include <algorithm> // For std::min
+#include <deque>     // For std::deque
+#include <exception> // For std::exception_ptr
+#include <thread>    // For std::thread
 
-vtk::detail::smp::vtkSMPThreadPool::vtkSMPThreadPool(int threadNumber)
+namespace vtk
 {
-  this->Threads.reserve(threadNumber);
-  for (int i = 0; i < threadNumber; ++i)
+namespace detail
+{
+namespace smp
+{
+
+// Number of times an idle thread looks for work before going to sleep. Keeping
+// threads awake a little while makes back to back parallel loops cheap.
+static constexpr int SpinCountBeforeSleep = 64;
+
+// Minimum capacity of the pool. More workers than cores may be started when
+// vtkSMPTools::Initialize() asks for more threads than cores.
+static constexpr int MinimumMaximumNumberOfWorkers = 1024;
+
+//------------------------------------------------------------------------------
+// A parallel loop in flight. It lives on the stack of the thread that called
+// ParallelFor(), which does not return before Pending reaches zero.
+struct vtkSMPThreadPool::Region
+{
+  ExecuteFunctorPtrType Execute;
+  void* Functor;
+  vtkIdType Grain;
+  vtkIdType Last;
+  // The chunks are executed by Caller and by the workers of lower index.
+  std::thread::id Caller;
+  int NumberOfWorkers;
+  std::atomic<vtkIdType> Pending;
+  std::atomic<std::thread::id> SingleThread;
+  std::atomic<bool> HasException;
+  std::exception_ptr Exception;
+};
+
+//------------------------------------------------------------------------------
+struct vtkSMPThreadPool::Job
+{
+  Region* Owner;
+  vtkIdType From;
+};
+
+//------------------------------------------------------------------------------
+struct vtkSMPThreadPool::Worker
+{
+  std::mutex Mutex;
+  std::deque<Job> Jobs;
+  std::thread Thread;
+};
+
+namespace
+{
+// Index of the pool worker running on this thread, -1 for any other thread.
+thread_local int LocalWorkerIndex = -1;
+// Innermost parallel loop the current thread is executing a chunk of.
+thread_local void* LocalRegion = nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool& vtkSMPThreadPool::GetInstance()
+{
+  // Never destroyed, see Shutdown().
+  static vtkSMPThreadPool* instance = new vtkSMPThreadPool;
+  return *instance;
+}
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool::vtkSMPThreadPool()
+  : Workers(std::max(
+      MinimumMaximumNumberOfWorkers, static_cast<int>(std::thread::hardware_concurrency())))
+  , NumberOfWorkers(0)
+  , NumberOfQueuedJobs(0)
+  , QueueGeneration(0)
+{
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::StartWorkers(int numberOfWorkers)
+{
+  if (this->NumberOfWorkers.load(std::memory_order_acquire) >= numberOfWorkers)
   {
-    this->Threads.emplace_back(std::bind(&vtkSMPThreadPool::ThreadJob, this));
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(this->StartMutex);
+  for (int i = this->NumberOfWorkers.load(); i < numberOfWorkers; ++i)
+  {
+    // The worker is published once started, the other threads only look at
+    // the deques of the published workers.
+    this->Workers[i].reset(new Worker);
+    this->Workers[i]->Thread = std::thread(&vtkSMPThreadPool::ThreadJob, this, i);
+    this->NumberOfWorkers.store(i + 1, std::memory_order_release);
   }
 }
 
-void vtk::detail::smp::vtkSMPThreadPool::Join()
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::Shutdown()
 {
+  std::unique_lock<std::mutex> startLock(this->StartMutex);
   {
-    std::unique_lock<std::mutex> lock(this->Mutex);
-
+    std::unique_lock<std::mutex> lock(this->SleepMutex);
     this->Joining = true;
-    this->ConditionVariable.notify_all();
   }
+  this->SleepCondition.notify_all();
 
-  for (auto& it : this->Threads)
+  const int numberOfWorkers = this->NumberOfWorkers.load();
+  for (int i = 0; i < numberOfWorkers; ++i)
+  {
+    this->Workers[i]->Thread.join();
+  }
+  this->NumberOfWorkers = 0;
+  for (int i = 0; i < numberOfWorkers; ++i)
   {
-    it.join();
+    this->Workers[i].reset();
   }
+
+  std::unique_lock<std::mutex> lock(this->SleepMutex);
+  this->Joining = false;
 }
 
-void vtk::detail::smp::vtkSMPThreadPool::DoJob(std::function<void(void)> job)
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType execute, void* functor, int numberOfThreads)
 {
-  std::unique_lock<std::mutex> lock(this->Mutex);
+  Region region;
+  region.Execute = execute;
+  region.Functor = functor;
+  region.Grain = grain;
+  region.Last = last;
+  region.Caller = std::this_thread::get_id();
+  region.NumberOfWorkers =
+    std::max(0, std::min(numberOfThreads - 1, this->GetMaximumNumberOfWorkers()));
+  region.SingleThread = std::thread::id();
+  region.HasException = false;
+
+  const vtkIdType numberOfJobs = (last - first + grain - 1) / grain;
+  region.Pending = numberOfJobs;
+
+  if (region.NumberOfWorkers == 0)
+  {
+    // Nobody would help us: do not bother queueing the jobs.
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      Job job{ &region, from };
+      this->RunJob(job);
+    }
+  }
+  else
+  {
+    this->StartWorkers(region.NumberOfWorkers);
+    this->QueueAndWait(region, first, numberOfJobs);
+  }
 
-  this->JobQueue.emplace(std::move(job));
-  this->ConditionVariable.notify_one();
+  if (region.HasException)
+  {
+    std::rethrow_exception(region.Exception);
+  }
 }
 
-void vtk::detail::smp::vtkSMPThreadPool::ThreadJob()
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::QueueAndWait(Region& region, vtkIdType first, vtkIdType numberOfJobs)
 {
-  std::function<void(void)> job;
+  const vtkIdType grain = region.Grain;
+  const vtkIdType last = region.Last;
 
-  while (true)
+  this->NumberOfQueuedJobs += numberOfJobs;
+  if (LocalWorkerIndex >= 0)
   {
+    // Nested loop: keep the jobs local, idle threads will steal them.
+    Worker& worker = *this->Workers[LocalWorkerIndex];
+    std::unique_lock<std::mutex> lock(worker.Mutex);
+    for (vtkIdType from = first; from < last; from += grain)
     {
-      std::unique_lock<std::mutex> lock(this->Mutex);
-
-      this->ConditionVariable.wait(
-        lock, [this] { return (!this->JobQueue.empty() || this->Joining); });
-
-      if (this->JobQueue.empty())
+      worker.Jobs.push_back(Job{ &region, from });
+    }
+  }
+  else
+  {
+    // Give each allowed worker a contiguous block of chunks.
+    const int numberOfWorkers = region.NumberOfWorkers;
+    vtkIdType jobId = 0;
+    vtkIdType from = first;
+    for (int i = 0; i < numberOfWorkers; ++i)
+    {
+      const vtkIdType endJobId = numberOfJobs * (i + 1) / numberOfWorkers;
+      Worker& worker = *this->Workers[i];
+      std::unique_lock<std::mutex> lock(worker.Mutex);
+      for (; jobId < endJobId; ++jobId, from += grain)
       {
-        return;
+        worker.Jobs.push_back(Job{ &region, from });
       }
+    }
+  }
 
-      job = std::move(this->JobQueue.front());
-      this->JobQueue.pop();
+  {
+    // Taking the lock ensures no thread misses the notification between
+    // looking for jobs and going to sleep.
+    std::unique_lock<std::mutex> lock(this->SleepMutex);
+    ++this->QueueGeneration;
+  }
+  this->SleepCondition.notify_all();
+  this->DoneCondition.notify_all();
+
+  // Help until every chunk of this loop is done, and sleep when the remaining
+  // chunks are executed by other threads.
+  int spinCount = 0;
+  while (region.Pending.load(std::memory_order_acquire) > 0)
+  {
+    const vtkIdType generation = this->QueueGeneration.load();
+    Job job;
+    if (this->PopJob(LocalWorkerIndex, job))
+    {
+      this->RunJob(job);
+      spinCount = 0;
+      continue;
     }
-    job();
+
+    if (++spinCount < SpinCountBeforeSleep)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    spinCount = 0;
+
+    std::unique_lock<std::mutex> lock(this->SleepMutex);
+    this->DoneCondition.wait(lock, [this, &region, generation] {
+      return region.Pending.load(std::memory_order_acquire) == 0 ||
+        this->QueueGeneration.load() != generation;
+    });
   }
 }
 
-std::vector<std::thread>* vtk::detail::smp::vtkSMPThreadPool::GetThreads()
+//------------------------------------------------------------------------------
+bool vtkSMPThreadPool::GetSingleThread()
 {
-  return &(this->Threads);
+  Region* region = static_cast<Region*>(LocalRegion);
+  return !region || region->SingleThread.load() == std::this_thread::get_id();
 }
+
+//------------------------------------------------------------------------------
+bool vtkSMPThreadPool::PopJob(int workerIndex, Job& job)
+{
+  if (this->NumberOfQueuedJobs.load(std::memory_order_relaxed) <= 0)
+  {
+    return false;
+  }
+
+  // LIFO on our own deque to keep nested work hot in cache. Our deque only
+  // holds jobs we may execute: the ones of the loops we called, and the ones
+  // given to us by a loop allowing us to work.
+  if (workerIndex >= 0)
+  {
+    Worker& worker = *this->Workers[workerIndex];
+    std::unique_lock<std::mutex> lock(worker.Mutex);
+    if (!worker.Jobs.empty())
+    {
+      job = worker.Jobs.back();
+      worker.Jobs.pop_back();
+      --this->NumberOfQueuedJobs;
+      return true;
+    }
+  }
+
+  // FIFO when stealing to stay away from the chunks the owner is working on.
+  const std::thread::id thisThread = std::this_thread::get_id();
+  const int numberOfWorkers = this->NumberOfWorkers.load(std::memory_order_acquire);
+  for (int offset = 1; offset <= numberOfWorkers; ++offset)
+  {
+    const int victimIndex = (workerIndex + offset + numberOfWorkers) % numberOfWorkers;
+    if (victimIndex == workerIndex)
+    {
+      continue;
+    }
+    Worker& victim = *this->Workers[victimIndex];
+    std::unique_lock<std::mutex> lock(victim.Mutex);
+    if (victim.Jobs.empty())
+    {
+      continue;
+    }
+    const Region* region = victim.Jobs.front().Owner;
+    if (region->Caller == thisThread ||
+      (workerIndex >= 0 && workerIndex < region->NumberOfWorkers))
+    {
+      job = victim.Jobs.front();
+      victim.Jobs.pop_front();
+      --this->NumberOfQueuedJobs;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::RunJob(Job& job)
+{
+  Region* region = job.Owner;
+  void* previousRegion = LocalRegion;
+  LocalRegion = region;
+
+  std::thread::id noThread;
+  region->SingleThread.compare_exchange_strong(noThread, std::this_thread::get_id());
+  try
+  {
+    region->Execute(region->Functor, job.From, region->Grain, region->Last);
+  }
+  catch (...)
+  {
+    // Keep the first exception, the thread owning the region rethrows it
+    // once all the chunks are done.
+    if (!region->HasException.exchange(true))
+    {
+      region->Exception = std::current_exception();
+    }
+  }
+
+  LocalRegion = previousRegion;
+  // region may be destroyed as soon as its last job is marked as done.
+  if (region->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    // Taking the lock ensures the caller does not miss the notification
+    // between checking Pending and going to sleep.
+    {
+      std::unique_lock<std::mutex> lock(this->SleepMutex);
+    }
+    this->DoneCondition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::ThreadJob(int workerIndex)
+{
+  LocalWorkerIndex = workerIndex;
+
+  int spinCount = 0;
+  while (true)
+  {
+    const vtkIdType generation = this->QueueGeneration.load();
+    Job job;
+    if (this->PopJob(workerIndex, job))
+    {
+      this->RunJob(job);
+      spinCount = 0;
+      continue;
+    }
+
+    if (++spinCount < SpinCountBeforeSleep)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    spinCount = 0;
+
+    // Jobs we may not execute stay queued: sleep until new ones are queued.
+    std::unique_lock<std::mutex> lock(this->SleepMutex);
+    this->SleepCondition.wait(lock, [this, generation] {
+      return this->Joining || this->QueueGeneration.load() != generation;
+    });
+    if (this->Joining)
+    {
+      return;
+    }
+  }
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
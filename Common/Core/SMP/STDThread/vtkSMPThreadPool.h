@@ -12,26 +12,44 @@
     PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
-// .NAME vtkSMPThreadPool - A thread pool implementation using std::thread
+// .NAME vtkSMPThreadPool - A persistent work-stealing thread pool using std::thread
 //
 // .SECTION Description
-// vtkSMPThreadPool class creates a thread pool of std::thread, the number
-// of thread must be specified at the initialization of the class.
-// The DoJob() method is used attributes the job to a free thread, if all
-// threads are working, the job is kept in a queue. Note that vtkSMPThreadPool
-// destructor joins threads and finish the jobs in the queue.
+// vtkSMPThreadPool is a process-wide singleton owning the worker threads of
+// the STDThread backend. The workers are started on demand, when a parallel
+// loop asks for more threads than the pool has, and live until Shutdown() is
+// called, so a parallel loop only pays for queueing its chunks instead of
+// spawning and joining threads. The pool may have more workers than the
+// machine has cores when vtkSMPTools::Initialize() asks for it.
+//
+// Each worker owns a deque of jobs. A worker pops jobs from the back of its
+// own deque and, when it runs out of work, steals from the front of the other
+// deques. The thread calling ParallelFor() takes part in the computation until
+// all the chunks of its loop are done, and sleeps when there is nothing left
+// it can do: this is what makes nested parallel loops work without
+// oversubscription, since a nested loop is pushed on the deque of the worker
+// executing the outer chunk and is executed by whichever thread is idle.
+//
+// Each loop records how many threads may execute its chunks, so that
+// concurrent or nested loops using different numbers of threads do not
+// interfere: the chunks of a loop are executed by its calling thread and by
+// the workers of index lower than its number of threads minus one.
+//
+// The pool is never destroyed, since joining threads during the static
+// destruction may deadlock: call vtkSMPTools::Finalize() to join the workers.
 
 #ifndef vtkSMPThreadPool_h
 #define vtkSMPThreadPool_h
 
-#include "vtkCommonCoreModule.h" // For export macro
+#include "SMP/Common/vtkSMPToolsImpl.h" // For ExecuteFunctorPtrType
+#include "vtkCommonCoreModule.h"        // For export macro
 #include "vtkSystemIncludes.h"
 
+#include <atomic>             // For std::atomic
 #include <condition_variable> // For std::condition_variable
-#include <functional>         // For std::function
+#include <memory>             // For std::unique_ptr
 #include <mutex>              // For std::mutex
-#include <queue>              // For std::queue
-#include <thread>             // For std::thread
+#include <vector>             // For std::vector
 
 namespace vtk
 {
@@ -43,21 +61,62 @@ namespace smp
 class VTKCOMMONCORE_EXPORT vtkSMPThreadPool
 {
 public:
-  explicit vtkSMPThreadPool(int ThreadNumber);
+  static vtkSMPThreadPool& GetInstance();
 
-  void Join();
-  void DoJob(std::function<void(void)> job);
-  std::vector<std::thread>* GetThreads();
+  // Execute the range [first, last) by chunks of grain elements using at most
+  // numberOfThreads threads, including the calling thread. This call blocks
+  // until every chunk has been executed. If chunks throw, the first exception
+  // is rethrown to the caller.
+  void ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+    ExecuteFunctorPtrType execute, void* functor, int numberOfThreads);
 
-private:
-  void ThreadJob();
+  // Returns true if the calling thread is the first thread that entered the
+  // innermost parallel loop it is executing, or if it is not executing any.
+  bool GetSingleThread();
+
+  // Number of threads started by the pool, the calling thread is not counted.
+  int GetNumberOfWorkers() const { return this->NumberOfWorkers.load(); }
+
+  // Maximum number of threads the pool may start.
+  int GetMaximumNumberOfWorkers() const { return static_cast<int>(this->Workers.size()); }
+
+  // Join all the workers. They are started again by the next parallel loop.
+  // Must not be called while a parallel loop is executed.
+  void Shutdown();
+
+  vtkSMPThreadPool(vtkSMPThreadPool const&) = delete;
+  void operator=(vtkSMPThreadPool const&) = delete;
 
 private:
-  std::mutex Mutex;
+  struct Region;
+  struct Job;
+  struct Worker;
+
+  vtkSMPThreadPool();
+  ~vtkSMPThreadPool() = default;
+
+  void StartWorkers(int numberOfWorkers);
+  void QueueAndWait(Region& region, vtkIdType first, vtkIdType numberOfJobs);
+  void ThreadJob(int workerIndex);
+  bool PopJob(int workerIndex, Job& job);
+  void RunJob(Job& job);
+
+  // Allocated once so that they can be read while workers are started, only
+  // the first NumberOfWorkers ones are started.
+  std::vector<std::unique_ptr<Worker>> Workers;
+  std::atomic<int> NumberOfWorkers;
+  std::mutex StartMutex;
+
+  std::atomic<vtkIdType> NumberOfQueuedJobs;
+  // Incremented each time jobs are queued, to wake up the sleeping threads.
+  std::atomic<vtkIdType> QueueGeneration;
+
+  std::mutex SleepMutex;
+  // Sleeping workers wait for jobs, threads calling ParallelFor() wait for
+  // jobs or for the end of their loop.
+  std::condition_variable SleepCondition;
+  std::condition_variable DoneCondition;
   bool Joining = false;
-  std::condition_variable ConditionVariable;
-  std::queue<std::function<void(void)>> JobQueue;
-  std::vector<std::thread> Threads;
 };
 
 } // namespace smp
@@ -16,9 +16,9 @@
 #include "SMP/Common/vtkSMPToolsImpl.h"
 #include "SMP/STDThread/vtkSMPToolsImpl.txx"
 
-#include <cstdlib> // For std::getenv()
-#include <stack>   // For std::stack
-#include <thread>  // For std::thread::hardware_concurrency()
+#include <algorithm> // For std::max()
+#include <cstdlib>   // For std::getenv()
+#include <thread>    // For std::thread::hardware_concurrency()
 
 namespace vtk
 {
@@ -27,14 +27,11 @@ namespace detail
 namespace smp
 {
 static int specifiedNumThreads = 0;
-static std::stack<std::thread::id> threadIdStack;
-static std::mutex threadIdStackLock;
 
 //------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int numThreads)
 {
-  const int maxThreads = std::thread::hardware_concurrency();
   if (numThreads == 0)
   {
     const char* vtkSmpNumThreads = std::getenv("VTK_SMP_MAX_THREADS");
@@ -49,7 +46,7 @@ void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int numThreads)
   }
   if (numThreads > 0)
   {
-    numThreads = std::min(numThreads, maxThreads);
+    // More threads than cores may be used, the pool starts them on demand.
     specifiedNumThreads = numThreads;
   }
 }
@@ -57,29 +54,15 @@ void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int numThreads)
 //------------------------------------------------------------------------------
 int GetNumberOfThreadsSTDThread()
 {
-  return specifiedNumThreads ? specifiedNumThreads : std::thread::hardware_concurrency();
-}
-
-//------------------------------------------------------------------------------
-void PushThreadId(std::thread::id id)
-{
-  threadIdStackLock.lock();
-  threadIdStack.emplace(id);
-  threadIdStackLock.unlock();
-}
-
-//------------------------------------------------------------------------------
-void PopThreadId()
-{
-  threadIdStackLock.lock();
-  threadIdStack.pop();
-  threadIdStackLock.unlock();
+  return specifiedNumThreads
+    ? specifiedNumThreads
+    : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
 }
 
 //------------------------------------------------------------------------------
 bool GetSingleThreadSTDThread()
 {
-  return threadIdStack.top() == std::this_thread::get_id();
+  return vtkSMPThreadPool::GetInstance().GetSingleThread();
 }
 
 //------------------------------------------------------------------------------
@@ -16,8 +16,7 @@
 #ifndef STDThreadvtkSMPToolsImpl_txx
 #define STDThreadvtkSMPToolsImpl_txx
 
-#include <algorithm>  // For std::sort
-#include <functional> // For std::bind
+#include <algorithm> // For std::sort
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
 #include "SMP/Common/vtkSMPToolsInternal.h" // For common vtk smp class
@@ -33,8 +32,6 @@ namespace smp
 
 int VTKCOMMONCORE_EXPORT GetNumberOfThreadsSTDThread();
 bool VTKCOMMONCORE_EXPORT GetSingleThreadSTDThread();
-void VTKCOMMONCORE_EXPORT PushThreadId(std::thread::id id);
-void VTKCOMMONCORE_EXPORT PopThreadId();
 
 //--------------------------------------------------------------------------------
 template <typename FunctorInternal>
@@ -76,17 +73,19 @@ void vtkSMPToolsImpl<BackendType::STDThread>::For(
     // (e.g only the 2 first nested For are in parallel)
     bool fromParallelCode = this->IsParallel.exchange(true);
 
-    vtkSMPThreadPool pool(threadNumber);
-    PushThreadId((pool.GetThreads())->at(0).get_id());
-
-    for (vtkIdType from = first; from < last; from += grain)
+    // The pool is persistent and shared by every (nested) loop: the calling
+    // thread executes chunks too, so no thread is spawned nor left waiting.
+    try
+    {
+      vtkSMPThreadPool::GetInstance().ParallelFor(
+        first, last, grain, ExecuteFunctorSTDThread<FunctorInternal>, &fi, threadNumber);
+    }
+    catch (...)
     {
-      auto job = std::bind(ExecuteFunctorSTDThread<FunctorInternal>, &fi, from, grain, last);
-      pool.DoJob(job);
+      this->IsParallel = fromParallelCode;
+      throw;
     }
-    pool.Join();
 
-    PopThreadId();
     // Atomic contortion to achieve this->IsParallel &= fromParallelCode.
     // This compare&exchange basically boils down to:
     // if (IsParallel == trueFlag)
@@ -144,7 +143,7 @@ template <typename RandomAccessIterator>
 void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end)
 {
-  std::sort(begin, end);
+  BlockedSort(*this, begin, end, LessFunctor());
 }
 
 //--------------------------------------------------------------------------------
@@ -153,7 +152,35 @@ template <typename RandomAccessIterator, typename Compare>
 void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
 {
-  std::sort(begin, end, comp);
+  BlockedSort(*this, begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+T vtkSMPToolsImpl<BackendType::STDThread>::TransformReduce(
+  InputIt inBegin, InputIt inEnd, T init, ReduceOp reduce, TransformOp transform)
+{
+  return BlockedTransformReduce(*this, inBegin, inEnd, init, reduce, transform);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::STDThread>::InclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+{
+  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  BlockedScan(*this, inBegin, inEnd, outBegin, ValueType(), op, false);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::STDThread>::ExclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+{
+  BlockedScan(*this, inBegin, inEnd, outBegin, init, op, true);
 }
 
 //--------------------------------------------------------------------------------
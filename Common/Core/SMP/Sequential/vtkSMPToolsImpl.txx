@@ -104,6 +104,54 @@ void vtkSMPToolsImpl<BackendType::Sequential>::Sort(
   std::sort(begin, end, comp);
 }
 
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+T vtkSMPToolsImpl<BackendType::Sequential>::TransformReduce(
+  InputIt inBegin, InputIt inEnd, T init, ReduceOp reduce, TransformOp transform)
+{
+  for (; inBegin != inEnd; ++inBegin)
+  {
+    init = reduce(init, transform(*inBegin));
+  }
+  return init;
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::Sequential>::InclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+{
+  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  if (inBegin == inEnd)
+  {
+    return;
+  }
+  ValueType carry = *inBegin;
+  *outBegin = carry;
+  for (++inBegin, ++outBegin; inBegin != inEnd; ++inBegin, ++outBegin)
+  {
+    carry = op(carry, *inBegin);
+    *outBegin = carry;
+  }
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+void vtkSMPToolsImpl<BackendType::Sequential>::ExclusiveScan(
+  InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+{
+  for (; inBegin != inEnd; ++inBegin, ++outBegin)
+  {
+    // Read before writing so that the scan can be done in place.
+    T value = *inBegin;
+    *outBegin = init;
+    init = op(init, value);
+  }
+}
+
 //--------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::Sequential>::Initialize(int);
@@ -14,6 +14,7 @@
 =========================================================================*/
 
 #include "vtkBitArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -22,6 +23,7 @@
 #include "vtkSortDataArray.h"
 #include "vtkStringArray.h"
 #include "vtkTimerLog.h"
+#include "vtkUnsignedLongLongArray.h"
 #include "vtkVariantArray.h"
 
 #include "vtkSmartPointer.h"
@@ -773,6 +775,123 @@ int TestMultiComponent()
   return errors;
 }
 
+int TestLookupValues(bool useHashLookup)
+{
+  int errors = 0;
+
+  // Value i % 1000 first appears at index i % 1000, plus a NaN at the end.
+  const vtkIdType arrSize = 100000;
+  VTK_CREATE(vtkFloatArray, arr);
+  arr->SetNumberOfValues(arrSize + 1);
+  for (vtkIdType i = 0; i < arrSize; ++i)
+  {
+    arr->SetValue(i, static_cast<float>(i % 1000));
+  }
+  arr->SetValue(arrSize, std::numeric_limits<float>::quiet_NaN());
+  arr->SetUseHashLookup(useHashLookup);
+
+  VTK_CREATE(vtkFloatArray, needles);
+  needles->SetNumberOfComponents(2);
+  needles->SetNumberOfTuples(1001);
+  for (vtkIdType i = 0; i < 2002; ++i)
+  {
+    needles->SetValue(i, static_cast<float>(999 - i));
+  }
+  needles->SetValue(2001, std::numeric_limits<float>::quiet_NaN());
+
+  VTK_CREATE(vtkIdList, ids);
+  arr->LookupValues(needles, ids);
+  if (ids->GetNumberOfIds() != 2002)
+  {
+    cerr << "ERROR: batched lookup returned " << ids->GetNumberOfIds() << " ids instead of 2002"
+         << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < 2001; ++i)
+  {
+    const vtkIdType expected = i < 1000 ? 999 - i : -1;
+    if (ids->GetId(i) != expected)
+    {
+      cerr << "ERROR: batched lookup of " << 999 - i << " found " << ids->GetId(i)
+           << " instead of " << expected << endl;
+      errors++;
+    }
+  }
+  if (ids->GetId(2001) != arrSize)
+  {
+    cerr << "ERROR: batched lookup of NaN found " << ids->GetId(2001) << " instead of " << arrSize
+         << endl;
+    errors++;
+  }
+
+  // Values of another type go through a conversion, inexact ones are not found.
+  VTK_CREATE(vtkIdTypeArray, idNeedles);
+  idNeedles->InsertNextValue(42);
+  idNeedles->InsertNextValue(1000);
+  idNeedles->InsertNextValue(std::numeric_limits<vtkIdType>::max());
+  VTK_CREATE(vtkDoubleArray, doubleNeedles);
+  doubleNeedles->InsertNextValue(42.5);
+  doubleNeedles->InsertNextValue(7.0);
+  arr->LookupValues(idNeedles, ids);
+  if (ids->GetNumberOfIds() != 3 || ids->GetId(0) != 42 || ids->GetId(1) != -1 ||
+    ids->GetId(2) != -1)
+  {
+    cerr << "ERROR: batched lookup of vtkIdType values failed" << endl;
+    errors++;
+  }
+  arr->LookupValues(doubleNeedles, ids);
+  if (ids->GetNumberOfIds() != 2 || ids->GetId(0) != -1 || ids->GetId(1) != 7)
+  {
+    cerr << "ERROR: batched lookup of double values failed" << endl;
+    errors++;
+  }
+
+  // Integers of another type are compared exactly, even above 2^53.
+  const vtkIdType big = (vtkIdType(1) << 53) + 1;
+  VTK_CREATE(vtkIdTypeArray, bigArr);
+  bigArr->InsertNextValue(big - 1);
+  bigArr->InsertNextValue(big);
+  bigArr->SetUseHashLookup(useHashLookup);
+  VTK_CREATE(vtkUnsignedLongLongArray, bigNeedles);
+  bigNeedles->InsertNextValue(static_cast<unsigned long long>(big));
+  bigNeedles->InsertNextValue(std::numeric_limits<unsigned long long>::max());
+  bigArr->LookupValues(bigNeedles, ids);
+  if (ids->GetNumberOfIds() != 2 || ids->GetId(0) != 1 || ids->GetId(1) != -1)
+  {
+    cerr << "ERROR: batched lookup of 64 bit values failed" << endl;
+    errors++;
+  }
+
+  // The single value lookups return every occurrence in order.
+  VTK_CREATE(vtkIdList, list);
+  arr->LookupValue(7, list);
+  if (list->GetNumberOfIds() != arrSize / 1000)
+  {
+    cerr << "ERROR: lookup found " << list->GetNumberOfIds() << " matches but there should be "
+         << arrSize / 1000 << endl;
+    errors++;
+  }
+  for (vtkIdType i = 0; i < list->GetNumberOfIds(); ++i)
+  {
+    if (list->GetId(i) != 7 + 1000 * i)
+    {
+      cerr << "ERROR: lookup returned " << list->GetId(i) << " at " << i << endl;
+      errors++;
+      break;
+    }
+  }
+
+  // The lookup is rebuilt once cleared after a modification.
+  arr->SetValue(0, 5000);
+  arr->ClearLookup();
+  if (arr->LookupValue(5000) != 0 || arr->LookupValue(0) != 1000)
+  {
+    cerr << "ERROR: lookup was not updated after the array was modified" << endl;
+    errors++;
+  }
+  return errors;
+}
+
 int TestArrayLookup(int argc, char* argv[])
 {
   vtkIdType min = 100;
@@ -847,5 +966,7 @@ int TestArrayLookup(int argc, char* argv[])
     cerr << endl;
   }
   errors += TestMultiComponent();
+  errors += TestLookupValues(false);
+  errors += TestLookupValues(true);
   return errors;
 }
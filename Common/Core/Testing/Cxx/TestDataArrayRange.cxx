@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayRange.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMathUtilities.h"
+#include "vtkNew.h"
+#include "vtkSOADataArrayTemplate.h"
+#include "vtkShortArray.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+// Reference ranges, computed value by value. As in vtkDataArray, they start
+// from the bounds of the value type.
+void ReferenceRange(vtkDataArray* array, int comp, bool finiteOnly, double range[2])
+{
+  range[0] = array->GetDataTypeMax();
+  range[1] = array->GetDataTypeMin();
+  for (vtkIdType t = 0; t < array->GetNumberOfTuples(); ++t)
+  {
+    const double value = array->GetComponent(t, comp);
+    if (!finiteOnly || !std::isinf(value))
+    {
+      vtkMathUtilities::UpdateRange(range[0], range[1], value);
+    }
+  }
+}
+
+int CheckRanges(vtkDataArray* array)
+{
+  for (int comp = 0; comp < array->GetNumberOfComponents(); ++comp)
+  {
+    double range[2];
+    double expected[2];
+    array->GetRange(range, comp);
+    ReferenceRange(array, comp, false, expected);
+    VTK_TEST_CHECK(range[0] == expected[0] && range[1] == expected[1]);
+    array->GetFiniteRange(range, comp);
+    ReferenceRange(array, comp, true, expected);
+    VTK_TEST_CHECK(range[0] == expected[0] && range[1] == expected[1]);
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename ArrayT>
+int TestKernels(bool withSpecialValues)
+{
+  using ValueType = typename ArrayT::ValueType;
+  // Sizes around the blocks of the vectorized kernels, and all the
+  // specialized numbers of components.
+  for (int numComps = 1; numComps <= 10; ++numComps)
+  {
+    for (vtkIdType numTuples : { 1, 7, 16, 17, 1000, 1003 })
+    {
+      vtkNew<ArrayT> array;
+      array->SetNumberOfComponents(numComps);
+      array->SetNumberOfTuples(numTuples);
+      for (vtkIdType i = 0; i < array->GetNumberOfValues(); ++i)
+      {
+        array->SetValue(i, static_cast<ValueType>((i * 7919) % 201 - 100));
+      }
+      if (withSpecialValues)
+      {
+        const vtkIdType last = array->GetNumberOfValues() - 1;
+        array->SetValue(last / 2, std::numeric_limits<ValueType>::infinity());
+        array->SetValue(last / 3, -std::numeric_limits<ValueType>::infinity());
+        array->SetValue(last, std::numeric_limits<ValueType>::quiet_NaN());
+        array->SetValue(0, std::numeric_limits<ValueType>::quiet_NaN());
+      }
+      array->Modified();
+      if (CheckRanges(array) != EXIT_SUCCESS)
+      {
+        std::cerr << array->GetClassName() << " with " << numComps << " components and "
+                  << numTuples << " tuples" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // The appended tuples go through the same kernels, from an offset that
+      // is not aligned on their blocks.
+      const vtkIdType numValues = array->GetNumberOfValues();
+      for (vtkIdType i = 0; i < 37 * numComps; ++i)
+      {
+        array->InsertNextValue(static_cast<ValueType>((i * 104729) % 301 - 150));
+      }
+      if (withSpecialValues)
+      {
+        array->SetValue(numValues + 5, std::numeric_limits<ValueType>::infinity());
+        array->SetValue(numValues + 7, std::numeric_limits<ValueType>::quiet_NaN());
+      }
+      array->ModifiedTuples(numTuples, numTuples + 37);
+      if (CheckRanges(array) != EXIT_SUCCESS)
+      {
+        std::cerr << array->GetClassName() << " with " << numComps << " components and "
+                  << numTuples << " tuples, appended" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestIncremental()
+{
+  vtkNew<vtkFloatArray> array;
+  array->SetNumberOfComponents(2);
+  for (int i = 0; i < 100; ++i)
+  {
+    const float tuple[2] = { static_cast<float>(i), static_cast<float>(-i) };
+    array->InsertNextTypedTuple(tuple);
+  }
+  double range[2];
+  array->GetRange(range, 0);
+  VTK_TEST_CHECK(range[0] == 0 && range[1] == 99);
+
+  // Appended tuples are merged.
+  const float appended[2] = { 500.f, std::numeric_limits<float>::infinity() };
+  array->InsertNextTypedTuple(appended);
+  array->ModifiedTuples(100, 101);
+  VTK_TEST_CHECK(CheckRanges(array) == EXIT_SUCCESS);
+  array->GetRange(range, 0);
+  VTK_TEST_CHECK(range[1] == 500);
+
+  // Overwriting a covered tuple requires a full scan, which shrinks the range.
+  const double bound[2] = { 1., -1000. };
+  array->SetTuple(100, bound);
+  array->ModifiedTuples(100, 101);
+  VTK_TEST_CHECK(CheckRanges(array) == EXIT_SUCCESS);
+  array->GetRange(range, 0);
+  VTK_TEST_CHECK(range[1] == 99);
+  array->GetFiniteRange(range, 1);
+  VTK_TEST_CHECK(range[0] == -1000 && range[1] == 0);
+
+  // Shrinking and refilling the array is detected.
+  array->SetNumberOfTuples(10);
+  array->Modified();
+  VTK_TEST_CHECK(CheckRanges(array) == EXIT_SUCCESS);
+  for (int i = 0; i < 5; ++i)
+  {
+    const float tuple[2] = { -5.f, 5.f };
+    array->InsertNextTypedTuple(tuple);
+  }
+  array->ModifiedTuples(10, 15);
+  VTK_TEST_CHECK(CheckRanges(array) == EXIT_SUCCESS);
+  array->GetRange(range, 0);
+  VTK_TEST_CHECK(range[0] == -5 && range[1] == 9);
+
+  // Other array types, and 64 bit integers which are kept exactly.
+  vtkNew<vtkSOADataArrayTemplate<int>> soa;
+  soa->SetNumberOfComponents(1);
+  soa->SetNumberOfTuples(10);
+  for (int i = 0; i < 10; ++i)
+  {
+    soa->SetValue(i, i);
+  }
+  soa->GetRange(range, 0);
+  soa->InsertNextValue(-3);
+  soa->ModifiedTuples(10, 11);
+  soa->GetRange(range, 0);
+  VTK_TEST_CHECK(range[0] == -3 && range[1] == 9);
+
+  vtkNew<vtkTypeInt64Array> int64;
+  const vtkTypeInt64 large = vtkTypeInt64(1) << 60;
+  int64->InsertNextValue(large + 1);
+  int64->InsertNextValue(large + 3);
+  int64->GetRange(range, 0);
+  int64->InsertNextValue(large + 2);
+  int64->InsertNextValue(large - 1);
+  int64->ModifiedTuples(2, 4);
+  VTK_TEST_CHECK(CheckRanges(int64) == EXIT_SUCCESS);
+  int64->GetRange(range, 0);
+  VTK_TEST_CHECK(range[0] == static_cast<double>(large - 1));
+  VTK_TEST_CHECK(range[1] == static_cast<double>(large + 3));
+  return EXIT_SUCCESS;
+}
+}
+
+int TestDataArrayRange(int, char*[])
+{
+  if (TestKernels<vtkFloatArray>(true) != EXIT_SUCCESS ||
+    TestKernels<vtkDoubleArray>(true) != EXIT_SUCCESS ||
+    TestKernels<vtkFloatArray>(false) != EXIT_SUCCESS ||
+    TestKernels<vtkIntArray>(false) != EXIT_SUCCESS ||
+    TestKernels<vtkShortArray>(false) != EXIT_SUCCESS ||
+    TestKernels<vtkUnsignedCharArray>(false) != EXIT_SUCCESS ||
+    TestKernels<vtkTypeInt64Array>(false) != EXIT_SUCCESS ||
+    TestKernels<vtkSOADataArrayTemplate<double>>(true) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  return TestIncremental();
+}
@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkAffineArray.h"
+#include "vtkArrayDispatch.h"
+#include "vtkCompositeArray.h"
+#include "vtkConstantArray.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIndexedArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTypeList.h"
+
+#include <cstdlib>
+#include <functional>
+
+namespace
+{
+struct SumWorker
+{
+  double Sum = 0.0;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    for (auto value : vtk::DataArrayValueRange(array))
+    {
+      this->Sum += value;
+    }
+  }
+};
+
+struct Squares
+{
+  double operator()(vtkIdType idx) const { return static_cast<double>(idx * idx); }
+};
+
+int TestConstantAndAffine()
+{
+  vtkNew<vtkConstantArray<unsigned char>> constant;
+  constant->ConstructBackend(3);
+  constant->SetNumberOfComponents(2);
+  constant->SetNumberOfTuples(1000);
+  VTK_TEST_CHECK(constant->GetNumberOfValues() == 2000);
+  VTK_TEST_CHECK(constant->GetValue(1999) == 3);
+  VTK_TEST_CHECK(constant->GetComponent(10, 1) == 3.0);
+  VTK_TEST_CHECK(constant->GetActualMemorySize() == 1);
+
+  vtkNew<vtkAffineArray<vtkIdType>> ids;
+  ids->ConstructBackend(2, 10);
+  ids->SetNumberOfTuples(100);
+  VTK_TEST_CHECK(ids->GetValue(0) == 10);
+  VTK_TEST_CHECK(ids->GetValue(99) == 208);
+  double range[2];
+  ids->GetRange(range);
+  VTK_TEST_CHECK(range[0] == 10 && range[1] == 208);
+
+  // Dispatch on an explicit list, the default one only has them when the
+  // VTK_DISPATCH_*_ARRAYS options are enabled.
+  using Arrays = vtkTypeList::Create<vtkConstantArray<unsigned char>, vtkAffineArray<vtkIdType>>;
+  SumWorker worker;
+  VTK_TEST_CHECK((vtkArrayDispatch::DispatchByArray<Arrays>::Execute(ids.Get(), worker)));
+  VTK_TEST_CHECK(worker.Sum == 100 * 10 + 2 * 99 * 100 / 2);
+  VTK_TEST_CHECK((vtkArrayDispatch::DispatchByArray<Arrays>::Execute(constant.Get(), worker)));
+  VTK_TEST_CHECK(worker.Sum == 100 * 10 + 2 * 99 * 100 / 2 + 3 * 2000);
+
+  // Read-only, but copied into modifiable arrays by the pipeline.
+  auto copy = vtk::TakeSmartPointer(ids->NewInstance());
+  VTK_TEST_CHECK(copy != nullptr);
+  copy->DeepCopy(ids);
+  VTK_TEST_CHECK(copy->GetValue(99) == 208);
+  vtkDataArray* base = ids;
+  auto baseCopy = vtk::TakeSmartPointer(base->NewInstance());
+  VTK_TEST_CHECK(vtkArrayDownCast<vtkAOSDataArrayTemplate<vtkIdType>>(baseCopy) != nullptr);
+
+  // Materialized on demand.
+  vtkIdType* pointer = static_cast<vtkIdType*>(ids->GetVoidPointer(0));
+  VTK_TEST_CHECK(pointer && pointer[50] == 110);
+  VTK_TEST_CHECK(ids->GetActualMemorySize() > 1);
+  ids->Squeeze();
+  VTK_TEST_CHECK(ids->GetActualMemorySize() == 1);
+
+  // Copies share the backend.
+  vtkNew<vtkAffineArray<vtkIdType>> idsCopy;
+  idsCopy->DeepCopy(ids);
+  VTK_TEST_CHECK(idsCopy->GetBackend() == ids->GetBackend());
+  VTK_TEST_CHECK(idsCopy->GetNumberOfTuples() == 100);
+  return EXIT_SUCCESS;
+}
+
+int TestCompositeAndIndexed()
+{
+  vtkNew<vtkDoubleArray> first;
+  first->SetNumberOfComponents(2);
+  first->SetNumberOfTuples(10);
+  vtkNew<vtkIntArray> second;
+  second->SetNumberOfComponents(2);
+  second->SetNumberOfTuples(5);
+  for (vtkIdType i = 0; i < 20; ++i)
+  {
+    first->SetValue(i, i);
+  }
+  for (vtkIdType i = 0; i < 10; ++i)
+  {
+    second->SetValue(i, 20 + i);
+  }
+
+  vtkNew<vtkDoubleArray> empty;
+  empty->SetNumberOfComponents(2);
+  auto composite = vtk::ConcatenateDataArrays<double>({ first, empty, second });
+  VTK_TEST_CHECK(composite);
+  VTK_TEST_CHECK(composite->GetNumberOfComponents() == 2);
+  VTK_TEST_CHECK(composite->GetNumberOfTuples() == 15);
+  for (vtkIdType i = 0; i < 30; ++i)
+  {
+    VTK_TEST_CHECK(composite->GetValue(i) == i);
+  }
+  vtkNew<vtkIntArray> single;
+  VTK_TEST_CHECK(!vtk::ConcatenateDataArrays<double>({ first, single }));
+
+  vtkNew<vtkIdList> tupleIds;
+  tupleIds->InsertNextId(14);
+  tupleIds->InsertNextId(0);
+  tupleIds->InsertNextId(7);
+  vtkNew<vtkIndexedArray<double>> indexed;
+  indexed->ConstructBackend(tupleIds, composite);
+  indexed->SetNumberOfComponents(2);
+  indexed->SetNumberOfTuples(tupleIds->GetNumberOfIds());
+  double tuple[2];
+  indexed->GetTypedTuple(0, tuple);
+  VTK_TEST_CHECK(tuple[0] == 28 && tuple[1] == 29);
+  VTK_TEST_CHECK(indexed->GetTypedComponent(1, 1) == 1);
+  VTK_TEST_CHECK(indexed->GetComponent(2, 0) == 14);
+
+  vtkNew<vtkIntArray> intIds;
+  intIds->InsertNextValue(9);
+  vtkNew<vtkIndexedArray<double>> indexedByArray;
+  indexedByArray->ConstructBackend(static_cast<vtkDataArray*>(intIds), first);
+  indexedByArray->SetNumberOfComponents(2);
+  indexedByArray->SetNumberOfTuples(1);
+  VTK_TEST_CHECK(indexedByArray->GetValue(1) == 19);
+  return EXIT_SUCCESS;
+}
+
+int TestCustomBackend()
+{
+  vtkNew<vtkImplicitArray<Squares>> squares;
+  squares->SetNumberOfTuples(10);
+  VTK_TEST_CHECK(squares->GetValue(9) == 81);
+
+  vtkNew<vtkImplicitArray<std::function<float(vtkIdType)>>> lambda;
+  lambda->ConstructBackend([](vtkIdType idx) { return 0.5f * idx; });
+  lambda->SetNumberOfTuples(4);
+  VTK_TEST_CHECK(lambda->GetValue(3) == 1.5f);
+  VTK_TEST_CHECK(lambda->GetDataType() == VTK_FLOAT);
+
+  // Writing is an error and does not change the values.
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  lambda->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  lambda->SetValue(0, 10.f);
+  VTK_TEST_CHECK(errorObserver->GetError());
+  VTK_TEST_CHECK(lambda->GetValue(0) == 0.f);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestImplicitArray(int, char*[])
+{
+  if (TestConstantAndAffine() != EXIT_SUCCESS || TestCompositeAndIndexed() != EXIT_SUCCESS ||
+    TestCustomBackend() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
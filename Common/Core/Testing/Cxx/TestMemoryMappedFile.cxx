@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkArrayDispatch.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTestErrorObserver.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+constexpr int HeaderSize = 8;
+constexpr vtkIdType NumberOfTuples = 1000;
+
+struct SumWorker
+{
+  double Sum = 0.0;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    for (auto value : vtk::DataArrayValueRange(array))
+    {
+      this->Sum += value;
+    }
+  }
+};
+
+bool WriteFile(const char* fileName)
+{
+  // A small header followed by 3 float components per tuple, then 1 int per
+  // tuple, as written by a raw binary writer.
+  std::vector<float> points(3 * NumberOfTuples);
+  std::vector<int> ids(NumberOfTuples);
+  for (vtkIdType i = 0; i < NumberOfTuples; ++i)
+  {
+    points[3 * i] = static_cast<float>(i);
+    points[3 * i + 1] = static_cast<float>(2 * i);
+    points[3 * i + 2] = static_cast<float>(3 * i);
+    ids[i] = static_cast<int>(i);
+  }
+  std::ofstream file(fileName, std::ios::binary);
+  const char header[HeaderSize] = { 'V', 'T', 'K', 'R', 'A', 'W', '0', '1' };
+  file.write(header, HeaderSize);
+  file.write(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(float));
+  file.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int));
+  return static_cast<bool>(file);
+}
+}
+
+int TestMemoryMappedFile(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <temporary file>" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char* fileName = argv[1];
+  VTK_TEST_CHECK(WriteFile(fileName));
+
+  vtkNew<vtkFloatArray> points;
+  vtkNew<vtkIntArray> ids;
+  const vtkTypeUInt64 pointsSize = 3 * NumberOfTuples * sizeof(float);
+  {
+    vtkNew<vtkMemoryMappedFile> file;
+    file->SetFileName(fileName);
+    file->SetMappingModeToReadOnly();
+    VTK_TEST_CHECK(file->Map());
+    VTK_TEST_CHECK(file->GetLength() == HeaderSize + pointsSize + NumberOfTuples * sizeof(int));
+    VTK_TEST_CHECK(file->GetBlock(HeaderSize, file->GetLength()) == nullptr);
+    VTK_TEST_CHECK(static_cast<const float*>(file->GetBlock(HeaderSize, pointsSize))[5] == 3.f);
+
+    // Arrays cannot use read-only pages, since their values can be modified.
+    vtkNew<vtkTest::ErrorObserver> errorObserver;
+    points->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+    points->SetNumberOfComponents(3);
+    VTK_TEST_CHECK(!points->SetMappedArray(file, HeaderSize, 3 * NumberOfTuples));
+    VTK_TEST_CHECK(errorObserver->GetError());
+    VTK_TEST_CHECK(points->GetNumberOfTuples() == 0);
+
+    file->SetMappingModeToCopyOnWrite();
+    VTK_TEST_CHECK(file->Map());
+    VTK_TEST_CHECK(points->SetMappedArray(file, HeaderSize, 3 * NumberOfTuples));
+    VTK_TEST_CHECK(ids->SetMappedArray(file, HeaderSize + pointsSize, NumberOfTuples));
+
+    // Blocks must be in the file and aligned.
+    vtkNew<vtkDoubleArray> invalid;
+    invalid->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+    errorObserver->Clear();
+    VTK_TEST_CHECK(!invalid->SetMappedArray(file, HeaderSize + pointsSize, NumberOfTuples));
+    VTK_TEST_CHECK(errorObserver->GetError());
+    errorObserver->Clear();
+    VTK_TEST_CHECK(!invalid->SetMappedArray(file, 1, 1));
+    VTK_TEST_CHECK(errorObserver->GetError());
+    VTK_TEST_CHECK(invalid->GetNumberOfTuples() == 0);
+
+    // The arrays keep the mapping alive.
+    file->Unmap();
+    VTK_TEST_CHECK(!file->IsMapped());
+  }
+
+  VTK_TEST_CHECK(points->GetNumberOfTuples() == NumberOfTuples);
+  VTK_TEST_CHECK(ids->GetNumberOfTuples() == NumberOfTuples);
+  VTK_TEST_CHECK(points->GetComponent(10, 2) == 30.f);
+  VTK_TEST_CHECK(ids->GetValue(NumberOfTuples - 1) == NumberOfTuples - 1);
+
+  SumWorker worker;
+  VTK_TEST_CHECK(vtkArrayDispatch::Dispatch::Execute(ids.Get(), worker));
+  VTK_TEST_CHECK(worker.Sum == NumberOfTuples * (NumberOfTuples - 1) / 2);
+
+  // Growing a mapped array copies it to memory.
+  ids->InsertNextValue(-1);
+  ids->SetValue(0, 42);
+  VTK_TEST_CHECK(ids->GetValue(0) == 42);
+  VTK_TEST_CHECK(ids->GetValue(1) == 1);
+  VTK_TEST_CHECK(ids->GetValue(NumberOfTuples) == -1);
+
+  // Mapped arrays can be modified without changing the file, nor the other
+  // arrays mapping it.
+  vtkNew<vtkMemoryMappedFile> file;
+  file->SetFileName(fileName);
+  VTK_TEST_CHECK(file->GetMappingMode() == vtkMemoryMappedFile::CopyOnWrite);
+  VTK_TEST_CHECK(file->Map());
+  vtkNew<vtkFloatArray> copy;
+  copy->SetNumberOfComponents(3);
+  VTK_TEST_CHECK(copy->SetMappedArray(file, HeaderSize, 3 * NumberOfTuples));
+  copy->SetComponent(10, 2, -1.f);
+  VTK_TEST_CHECK(copy->GetComponent(10, 2) == -1.f);
+  VTK_TEST_CHECK(points->GetComponent(10, 2) == 30.f);
+
+  points->Initialize();
+  VTK_TEST_CHECK(points->GetNumberOfTuples() == 0);
+
+  return EXIT_SUCCESS;
+}
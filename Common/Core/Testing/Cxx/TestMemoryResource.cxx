@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryResource.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMallocMemoryResource.h"
+#include "vtkNew.h"
+#include "vtkPoolMemoryResource.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTestErrorObserver.h"
+
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+
+int TestBlockSizes()
+{
+  VTK_TEST_CHECK(vtkPoolMemoryResource::GetBlockSize(1) == 64);
+  VTK_TEST_CHECK(vtkPoolMemoryResource::GetBlockSize(64) == 64);
+  VTK_TEST_CHECK(vtkPoolMemoryResource::GetBlockSize(65) == 80);
+  VTK_TEST_CHECK(vtkPoolMemoryResource::GetBlockSize(128) == 128);
+  VTK_TEST_CHECK(vtkPoolMemoryResource::GetBlockSize(129) == 160);
+  for (std::size_t bytes = 1; bytes < 100000; bytes += 37)
+  {
+    const std::size_t blockSize = vtkPoolMemoryResource::GetBlockSize(bytes);
+    VTK_TEST_CHECK(blockSize >= bytes);
+    VTK_TEST_CHECK(bytes <= 64 || blockSize * 4 <= bytes * 5 + 64);
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestMallocResource()
+{
+  vtkNew<vtkMallocMemoryResource> resource;
+  void* a = resource->Allocate(1000);
+  void* b = resource->Allocate(3000);
+  VTK_TEST_CHECK(a && b);
+  VTK_TEST_CHECK(resource->GetBytesInUse() == 4000);
+  b = resource->Reallocate(b, 3000, 5000);
+  VTK_TEST_CHECK(b);
+  VTK_TEST_CHECK(resource->GetBytesInUse() == 6000);
+  resource->Deallocate(a, 1000);
+  resource->Deallocate(b, 5000);
+  VTK_TEST_CHECK(resource->GetBytesInUse() == 0);
+  VTK_TEST_CHECK(resource->GetHighWaterMark() == 6000);
+  VTK_TEST_CHECK(resource->GetNumberOfAllocations() == 2);
+  VTK_TEST_CHECK(resource->GetNumberOfDeallocations() == 2);
+  resource->ResetHighWaterMark();
+  VTK_TEST_CHECK(resource->GetHighWaterMark() == 0);
+  VTK_TEST_CHECK(resource->Allocate(0) == nullptr);
+  return EXIT_SUCCESS;
+}
+
+int TestArrayResource()
+{
+  vtkNew<vtkPoolMemoryResource> pool;
+  vtkMemoryResource* upstream = pool->GetUpstreamResource();
+
+  {
+    vtkNew<vtkDoubleArray> array;
+    array->SetMemoryResource(pool);
+    VTK_TEST_CHECK(array->GetMemoryResource() == pool);
+    array->SetNumberOfTuples(1000);
+    for (vtkIdType i = 0; i < 1000; ++i)
+    {
+      array->SetValue(i, i);
+    }
+    VTK_TEST_CHECK(pool->GetBytesInUse() == 1000 * sizeof(double));
+
+    // Growing keeps the values.
+    array->Resize(3000);
+    for (vtkIdType i = 0; i < 1000; ++i)
+    {
+      VTK_TEST_CHECK(array->GetValue(i) == i);
+    }
+    VTK_TEST_CHECK(pool->GetBytesInUse() == array->GetSize() * sizeof(double));
+
+    // An external buffer is not released to the pool.
+    double* external = static_cast<double*>(malloc(10 * sizeof(double)));
+    array->SetArray(external, 10, 0, vtkDoubleArray::VTK_DATA_ARRAY_FREE);
+    VTK_TEST_CHECK(pool->GetBytesInUse() == 0);
+    VTK_TEST_CHECK(pool->GetCachedBytes() > 0);
+
+    // But reallocating it moves it to the pool.
+    array->SetValue(0, 42);
+    array->Resize(20);
+    VTK_TEST_CHECK(array->GetValue(0) == 42);
+    VTK_TEST_CHECK(pool->GetBytesInUse() == array->GetSize() * sizeof(double));
+  }
+  VTK_TEST_CHECK(pool->GetBytesInUse() == 0);
+
+  // After the first step, the same sizes are served from the free lists.
+  vtkTypeUInt64 misses = 0;
+  const vtkTypeUInt64 hits = pool->GetNumberOfHits();
+  for (int step = 0; step < 10; ++step)
+  {
+    vtkNew<vtkDoubleArray> array;
+    array->SetMemoryResource(pool);
+    array->SetNumberOfTuples(3000);
+    array->FillValue(step);
+    if (step == 0)
+    {
+      misses = pool->GetNumberOfMisses();
+    }
+  }
+  VTK_TEST_CHECK(pool->GetNumberOfMisses() == misses);
+  VTK_TEST_CHECK(pool->GetNumberOfHits() >= hits + 9);
+
+  // Cached blocks are still held by the upstream resource.
+  VTK_TEST_CHECK(upstream->GetBytesInUse() == pool->GetCachedBytes());
+  VTK_TEST_CHECK(upstream->GetHighWaterMark() >= 3000 * sizeof(double));
+  pool->ReleaseCachedMemory();
+  VTK_TEST_CHECK(pool->GetCachedBytes() == 0);
+  VTK_TEST_CHECK(upstream->GetBytesInUse() == 0);
+
+  // Nothing is cached above the limit.
+  pool->SetMaximumCachedBytes(0);
+  {
+    vtkNew<vtkIntArray> array;
+    array->SetMemoryResource(pool);
+    array->SetNumberOfTuples(100);
+  }
+  VTK_TEST_CHECK(pool->GetCachedBytes() == 0);
+  VTK_TEST_CHECK(upstream->GetBytesInUse() == 0);
+
+  // The upstream resource cannot change while blocks are in use.
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  pool->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  vtkNew<vtkMallocMemoryResource> otherUpstream;
+  {
+    vtkNew<vtkIntArray> array;
+    array->SetMemoryResource(pool);
+    array->SetNumberOfTuples(100);
+    pool->SetUpstreamResource(otherUpstream);
+    VTK_TEST_CHECK(errorObserver->GetError());
+    VTK_TEST_CHECK(pool->GetUpstreamResource() == upstream);
+  }
+  VTK_TEST_CHECK(upstream->GetBytesInUse() == 0);
+  errorObserver->Clear();
+  pool->SetUpstreamResource(otherUpstream);
+  VTK_TEST_CHECK(!errorObserver->GetError());
+  VTK_TEST_CHECK(pool->GetUpstreamResource() == otherUpstream);
+  return EXIT_SUCCESS;
+}
+
+int TestDefaultResource()
+{
+  VTK_TEST_CHECK(vtkMemoryResource::GetDefaultResource() == nullptr);
+
+  vtkNew<vtkPoolMemoryResource> pool;
+  vtkNew<vtkFloatArray> before;
+  {
+    vtkMemoryResource::DefaultScope scope(pool);
+    VTK_TEST_CHECK(vtkMemoryResource::GetDefaultResource().Get() == pool);
+
+    vtkNew<vtkFloatArray> array;
+    VTK_TEST_CHECK(array->GetMemoryResource() == pool);
+    array->SetNumberOfComponents(3);
+    array->SetNumberOfTuples(100);
+    VTK_TEST_CHECK(pool->GetBytesInUse() == 300 * sizeof(float));
+
+    {
+      vtkNew<vtkMallocMemoryResource> other;
+      vtkMemoryResource::DefaultScope nested(other);
+      VTK_TEST_CHECK(vtkMemoryResource::GetDefaultResource().Get() == other);
+    }
+    VTK_TEST_CHECK(vtkMemoryResource::GetDefaultResource().Get() == pool);
+
+    // Arrays created before the scope are not affected.
+    VTK_TEST_CHECK(before->GetMemoryResource() == nullptr);
+    before->SetNumberOfTuples(100);
+    VTK_TEST_CHECK(pool->GetBytesInUse() == 300 * sizeof(float));
+
+    // Nor are the arrays created by other threads.
+    vtkMemoryResource* otherThreadResource = pool;
+    std::thread thread([&otherThreadResource]() {
+      vtkNew<vtkFloatArray> otherArray;
+      otherThreadResource = otherArray->GetMemoryResource();
+    });
+    thread.join();
+    VTK_TEST_CHECK(otherThreadResource == nullptr);
+  }
+  VTK_TEST_CHECK(vtkMemoryResource::GetDefaultResource() == nullptr);
+  VTK_TEST_CHECK(pool->GetBytesInUse() == 0);
+  VTK_TEST_CHECK(pool->GetHighWaterMark() == 300 * sizeof(float));
+  return EXIT_SUCCESS;
+}
+
+}
+
+int TestMemoryResource(int, char*[])
+{
+  if (TestBlockSizes() != EXIT_SUCCESS || TestMallocResource() != EXIT_SUCCESS ||
+    TestArrayResource() != EXIT_SUCCESS || TestDefaultResource() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -19,11 +19,13 @@
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
+#include <algorithm>
 #include <cstdlib>
 #include <deque>
 #include <functional>
 #include <numeric>
 #include <set>
+#include <string>
 #include <vector>
 
 static const int Target = 10000;
@@ -184,6 +186,20 @@ bool myComp(double a, double b)
   return (a < b);
 }
 
+// For sorting values that cannot be default constructed
+class NoDefaultValue
+{
+public:
+  explicit NoDefaultValue(int value)
+    : Value(value)
+  {
+  }
+
+  bool operator<(const NoDefaultValue& other) const { return this->Value < other.Value; }
+
+  int Value;
+};
+
 int doTestSMP()
 {
   std::cout << "Testing SMP Tools with " << vtkSMPTools::GetBackend() << " backend." << std::endl;
@@ -373,6 +389,54 @@ int doTestSMP()
     }
   }
 
+  // Large enough to be sorted by blocks and merged
+  std::vector<int> sortData(100003);
+  for (std::size_t i = 0; i < sortData.size(); ++i)
+  {
+    sortData[i] = static_cast<int>((i * 7919) % 1009);
+  }
+  std::vector<int> sortReference = sortData;
+  std::sort(sortReference.begin(), sortReference.end());
+  vtkSMPTools::Sort(sortData.begin(), sortData.end());
+  if (sortData != sortReference)
+  {
+    cerr << "Error: Bad large sort!" << endl;
+    return EXIT_FAILURE;
+  }
+  vtkSMPTools::Sort(sortData.begin(), sortData.end(), std::greater<int>());
+  if (!std::equal(sortData.begin(), sortData.end(), sortReference.rbegin()))
+  {
+    cerr << "Error: Bad large comparison sort!" << endl;
+    return EXIT_FAILURE;
+  }
+  // Other numbers of blocks, so that the last merge ends in either buffer
+  for (int numberOfThreads : { 2, 3 })
+  {
+    std::vector<int> scopeSortData(sortReference.rbegin(), sortReference.rend());
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ numberOfThreads },
+      [&]() { vtkSMPTools::Sort(scopeSortData.begin(), scopeSortData.end()); });
+    if (scopeSortData != sortReference)
+    {
+      cerr << "Error: Bad large sort with " << numberOfThreads << " threads!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  // Values without default constructor
+  std::vector<NoDefaultValue> noDefaultData;
+  for (int value : sortData)
+  {
+    noDefaultData.emplace_back(value);
+  }
+  vtkSMPTools::Sort(noDefaultData.begin(), noDefaultData.end());
+  for (std::size_t i = 0; i < noDefaultData.size(); ++i)
+  {
+    if (noDefaultData[i].Value != sortReference[i])
+    {
+      cerr << "Error: Bad sort of values without default constructor!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   // Test transform
   std::vector<double> transformData0 = { 51, 9, 3, -10, 27, 1, -5, 82, 31, 9, 21 };
   std::vector<double> transformData1 = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
@@ -491,6 +555,113 @@ int doTestSMP()
       return EXIT_FAILURE;
     }
   }
+
+  // Test reduce
+  std::vector<vtkIdType> reduceData0(100000);
+  std::iota(reduceData0.begin(), reduceData0.end(), 0);
+  const vtkIdType reduceTarget0 =
+    std::accumulate(reduceData0.begin(), reduceData0.end(), vtkIdType(7));
+  if (vtkSMPTools::Reduce(reduceData0.cbegin(), reduceData0.cend(), vtkIdType(7)) != reduceTarget0)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::Reduce applied on std::vector!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Non commutative operation: concatenation keeps the order of the values
+  std::vector<std::string> reduceData1(5000);
+  for (std::size_t i = 0; i < reduceData1.size(); ++i)
+  {
+    reduceData1[i] = static_cast<char>('a' + i % 26);
+  }
+  const std::string reduceTarget1 =
+    std::accumulate(reduceData1.begin(), reduceData1.end(), std::string(">"));
+  if (vtkSMPTools::Reduce(reduceData1.cbegin(), reduceData1.cend(), std::string(">")) !=
+    reduceTarget1)
+  {
+    cerr << "Error: vtkSMPTools::Reduce did not keep the order of a non commutative operation!"
+         << endl;
+    return EXIT_FAILURE;
+  }
+
+  if (vtkSMPTools::Reduce(reduceData0.cbegin(), reduceData0.cbegin(), 3) != 3)
+  {
+    cerr << "Error: vtkSMPTools::Reduce on an empty range should return init!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Test transform reduce
+  const auto maxMagnitude = vtkSMPTools::TransformReduce(transformRange4.cbegin(),
+    transformRange4.cend(), ValueType(0), [](ValueType a, ValueType b) { return std::max(a, b); },
+    computeMag);
+  if (maxMagnitude != 154)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::TransformReduce applied on "
+            "vtk::DataArrayTupleRange!"
+         << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Test scans
+  std::vector<vtkIdType> scanData0(reduceData0.size());
+  std::vector<vtkIdType> scanData1(reduceData0.size());
+  auto scanEnd0 =
+    vtkSMPTools::InclusiveScan(reduceData0.cbegin(), reduceData0.cend(), scanData0.begin());
+  vtkSMPTools::ExclusiveScan(
+    reduceData0.cbegin(), reduceData0.cend(), scanData1.begin(), vtkIdType(5));
+  vtkIdType sum = 0;
+  for (std::size_t i = 0; i < reduceData0.size(); ++i)
+  {
+    if (scanData1[i] != sum + 5)
+    {
+      cerr << "Error: Invalid output for vtkSMPTools::ExclusiveScan at index " << i << endl;
+      return EXIT_FAILURE;
+    }
+    sum += reduceData0[i];
+    if (scanData0[i] != sum)
+    {
+      cerr << "Error: Invalid output for vtkSMPTools::InclusiveScan at index " << i << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (scanEnd0 != scanData0.end())
+  {
+    cerr << "Error: vtkSMPTools::InclusiveScan did not return the end of the output!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // In place scan on a vtkDataArray
+  vtkNew<vtkAOSDataArrayTemplate<int>> scanArray;
+  scanArray->SetNumberOfValues(20000);
+  auto scanRange = vtk::DataArrayValueRange<1>(scanArray);
+  vtkSMPTools::Fill(scanRange.begin(), scanRange.end(), 1);
+  vtkSMPTools::InclusiveScan(scanRange.cbegin(), scanRange.cend(), scanRange.begin());
+  for (vtkIdType i = 0; i < scanArray->GetNumberOfValues(); ++i)
+  {
+    if (scanArray->GetValue(i) != i + 1)
+    {
+      cerr << "Error: Invalid output for in place vtkSMPTools::InclusiveScan at index " << i
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Non commutative operation
+  std::vector<std::string> scanData2(reduceData1.begin(), reduceData1.begin() + 3000);
+  std::vector<std::string> scanData3(scanData2.size());
+  vtkSMPTools::ExclusiveScan(
+    scanData2.cbegin(), scanData2.cend(), scanData3.begin(), std::string(">"));
+  std::string prefix = ">";
+  for (std::size_t i = 0; i < scanData2.size(); ++i)
+  {
+    if (scanData3[i] != prefix)
+    {
+      cerr << "Error: vtkSMPTools::ExclusiveScan did not keep the order of a non commutative "
+              "operation!"
+           << endl;
+      return EXIT_FAILURE;
+    }
+    prefix += scanData2[i];
+  }
   return EXIT_SUCCESS;
 }
 
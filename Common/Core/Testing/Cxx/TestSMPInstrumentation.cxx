@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPInstrumentation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLogger.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct LogCapture
+{
+  std::vector<std::string> Messages;
+
+  static void Callback(void* userData, const vtkLogger::Message& message)
+  {
+    static_cast<LogCapture*>(userData)->Messages.emplace_back(message.message);
+  }
+};
+
+struct SumFunctor
+{
+  vtkSMPThreadLocal<vtkIdType> Sum;
+
+  SumFunctor()
+    : Sum(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Sum.Local() += i;
+    }
+  }
+};
+}
+
+int TestSMPInstrumentation(int argc, char* argv[])
+{
+  const std::string traceFileName = argc > 1 ? argv[1] : "TestSMPInstrumentation.json";
+
+  LogCapture capture;
+  vtkLogger::AddCallback(
+    "TestSMPInstrumentation", LogCapture::Callback, &capture, vtkLogger::VERBOSITY_INFO);
+
+  // Nothing is reported until the instrumentation is enabled
+  SumFunctor functor;
+  vtkSMPTools::For(0, 1000, functor);
+  if (!capture.Messages.empty())
+  {
+    std::cerr << "Error: vtkSMPTools::For was instrumented while disabled." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkSMPTools::SetInstrumentation(true);
+  if (!vtkSMPTools::GetInstrumentation())
+  {
+    std::cerr << "Error: vtkSMPTools instrumentation could not be enabled." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Label taken from the functor type
+  vtkSMPTools::For(0, 1000, 10, functor);
+  vtkIdType sum = 0;
+  for (vtkIdType value : functor.Sum)
+  {
+    sum += value;
+  }
+  if (sum != 2 * 999 * 1000 / 2)
+  {
+    std::cerr << "Error: instrumented vtkSMPTools::For gave a wrong result." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Explicit label, nested loops are reported separately
+  {
+    vtkSMPTools::InstrumentationScope scope("OuterLoop");
+    vtkSMPTools::For(0, 4, 1, [](vtkIdType, vtkIdType) {
+      vtkSMPTools::InstrumentationScope innerScope("InnerLoop");
+      vtkSMPTools::For(0, 100, [](vtkIdType, vtkIdType) {});
+    });
+  }
+  vtkSMPTools::SetInstrumentation(false);
+  vtkLogger::RemoveCallback("TestSMPInstrumentation");
+
+  bool foundFunctor = false;
+  int nbOuter = 0;
+  int nbInner = 0;
+  for (const auto& message : capture.Messages)
+  {
+    foundFunctor |= message.find("SumFunctor") != std::string::npos &&
+      message.find("100 chunks") != std::string::npos;
+    nbOuter += message.find("'OuterLoop'") != std::string::npos;
+    nbInner += message.find("'InnerLoop'") != std::string::npos;
+  }
+  if (!foundFunctor || nbOuter != 1 || nbInner != 4)
+  {
+    std::cerr << "Error: unexpected instrumentation report:" << std::endl;
+    for (const auto& message : capture.Messages)
+    {
+      std::cerr << "  " << message << std::endl;
+    }
+    return EXIT_FAILURE;
+  }
+
+  if (!vtkSMPTools::WriteInstrumentationTrace(traceFileName.c_str()))
+  {
+    std::cerr << "Error: could not write " << traceFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::ifstream traceFile(traceFileName);
+  std::stringstream trace;
+  trace << traceFile.rdbuf();
+  if (trace.str().find("{\"traceEvents\":[") != 0 ||
+    trace.str().find("\"name\":\"OuterLoop\"") == std::string::npos)
+  {
+    std::cerr << "Error: invalid trace file:\n" << trace.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the thread pool of the STDThread backend: more threads than cores,
+// nested loops, loops called concurrently and restarting the pool.
+
+#include "vtkSMPTools.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Returns the number of threads executing the chunks of a loop at the same
+// time: each chunk waits for the threads of the other chunks.
+int CountConcurrentThreads(int numberOfThreads)
+{
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  vtkSMPTools::For(0, numberOfThreads, 1, [&](vtkIdType, vtkIdType) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    }
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (std::chrono::steady_clock::now() < timeout)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (static_cast<int>(threads.size()) == numberOfThreads)
+        {
+          return;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  return static_cast<int>(threads.size());
+}
+
+// Sums the integers in [begin, end) with a parallel loop.
+vtkIdType Sum(vtkIdType begin, vtkIdType end)
+{
+  std::atomic<vtkIdType> sum(0);
+  vtkSMPTools::For(begin, end, 10, [&](vtkIdType first, vtkIdType last) {
+    vtkIdType partialSum = 0;
+    for (vtkIdType i = first; i < last; ++i)
+    {
+      partialSum += i;
+    }
+    sum += partialSum;
+  });
+  return sum;
+}
+
+vtkIdType ExpectedSum(vtkIdType begin, vtkIdType end)
+{
+  return (end - begin) * (begin + end - 1) / 2;
+}
+
+int TestMoreThreadsThanCores()
+{
+  const int numberOfCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  const int numberOfThreads = 2 * numberOfCores + 2;
+  vtkSMPTools::Initialize(numberOfThreads);
+  VTK_TEST_CHECK(vtkSMPTools::GetEstimatedNumberOfThreads() == numberOfThreads);
+  VTK_TEST_CHECK(CountConcurrentThreads(numberOfThreads) == numberOfThreads);
+
+  // Fewer threads afterwards: the extra workers of the pool stay idle.
+  vtkSMPTools::Initialize(2);
+  VTK_TEST_CHECK(CountConcurrentThreads(2) == 2);
+  return EXIT_SUCCESS;
+}
+
+int TestNestedLoops()
+{
+  vtkSMPTools::Initialize(4);
+  vtkSMPTools::SetNestedParallelism(true);
+  std::vector<vtkIdType> sums(64, 0);
+  vtkSMPTools::For(0, 64, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      sums[i] = Sum(0, 1000 * i);
+    }
+  });
+  vtkSMPTools::SetNestedParallelism(false);
+  for (vtkIdType i = 0; i < 64; ++i)
+  {
+    VTK_TEST_CHECK(sums[i] == ExpectedSum(0, 1000 * i));
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestConcurrentLoops()
+{
+  vtkSMPTools::Initialize(4);
+  std::atomic<int> numberOfErrors(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&numberOfErrors, t]() {
+      for (vtkIdType i = 0; i < 100; ++i)
+      {
+        if (Sum(t, t + 1000 * i) != ExpectedSum(t, t + 1000 * i))
+        {
+          ++numberOfErrors;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  VTK_TEST_CHECK(numberOfErrors == 0);
+  return EXIT_SUCCESS;
+}
+
+int TestFinalize()
+{
+  vtkSMPTools::Initialize(4);
+  VTK_TEST_CHECK(Sum(0, 100000) == ExpectedSum(0, 100000));
+  vtkSMPTools::Finalize();
+  VTK_TEST_CHECK(CountConcurrentThreads(4) == 4);
+  vtkSMPTools::Finalize();
+  return EXIT_SUCCESS;
+}
+}
+
+int TestSMPThreadPool(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    // VTK_SKIP_RETURN_CODE
+    return 125;
+  }
+
+  int result = EXIT_SUCCESS;
+  for (auto test : { TestMoreThreadsThanCores, TestNestedLoops, TestConcurrentLoops, TestFinalize })
+  {
+    if (test() != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
@@ -37,6 +37,8 @@
 #include "vtkCompiler.h"         // for VTK_USE_EXTERN_TEMPLATE
 #include "vtkGenericDataArray.h"
 
+class vtkMemoryMappedFile;
+
 // The export macro below makes no sense, but is necessary for older compilers
 // when we export instantiations of this class from vtkCommonCore.
 template <class ValueTypeT>
@@ -190,6 +192,29 @@ public:
    **/
   void SetArrayFreeFunction(void (*callback)(void*)) override;
 
+  /**
+   * Use @a numberOfValues values stored at @a offset bytes in a mapped file
+   * as the values of this array, without reading them. The values must be
+   * stored in the native byte order, with the components interleaved. The
+   * array keeps the mapping alive as long as it uses it. The file must be
+   * mapped CopyOnWrite: the values can be modified like those of any array,
+   * the modified pages becoming private to the process. Returns false if the
+   * file is not mapped or is mapped ReadOnly, if the values are not entirely
+   * in the file or if they are not aligned for ValueType. See
+   * vtkMemoryMappedFile.
+   **/
+  bool SetMappedArray(vtkMemoryMappedFile* file, vtkTypeUInt64 offset, vtkIdType numberOfValues);
+
+  ///@{
+  /**
+   * Set the memory resource used by the next allocations of the values of
+   * this array, see vtkMemoryResource. By default, arrays use the resource
+   * returned by vtkMemoryResource::GetDefaultResource() when they are created.
+   **/
+  void SetMemoryResource(vtkMemoryResource* resource) { this->Buffer->SetMemoryResource(resource); }
+  vtkMemoryResource* GetMemoryResource() { return this->Buffer->GetMemoryResource(); }
+  ///@}
+
   // Overridden for optimized implementations:
   void SetTuple(vtkIdType tupleIdx, const float* tuple) override;
   void SetTuple(vtkIdType tupleIdx, const double* tuple) override;
@@ -317,7 +342,10 @@ vtkArrayDownCast_TemplateFastCastMacro(vtkAOSDataArrayTemplate);
   T* WritePointer(vtkIdType id, vtkIdType number);                                                 \
   T* GetPointer(vtkIdType id);                                                                     \
   void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save);                                  \
-  void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save, int deleteMethod)
+  void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save, int deleteMethod);                \
+  bool SetMappedArray(vtkMemoryMappedFile* file, vtkTypeUInt64 offset, vtkIdType numberOfValues);  \
+  void SetMemoryResource(vtkMemoryResource* resource);                                             \
+  vtkMemoryResource* GetMemoryResource()
 
 #endif // header guard
 
@@ -24,6 +24,9 @@
 #include "vtkAOSDataArrayTemplate.h"
 
 #include "vtkArrayIteratorTemplate.h"
+#include "vtkMemoryMappedFile.h"
+
+#include <cstdint> // For std::uintptr_t
 
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
@@ -125,6 +128,45 @@ void vtkAOSDataArrayTemplate<ValueType>::SetArrayFreeFunction(void (*callback)(v
   this->Buffer->SetFreeFunction(false, callback);
 }
 
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+bool vtkAOSDataArrayTemplate<ValueTypeT>::SetMappedArray(
+  vtkMemoryMappedFile* file, vtkTypeUInt64 offset, vtkIdType numberOfValues)
+{
+  if (!file || !file->IsMapped() || numberOfValues < 0)
+  {
+    vtkErrorMacro("A mapped file and a positive number of values are required.");
+    return false;
+  }
+  // The values of the array may be written through SetValue() or
+  // GetPointer(): read-only pages would fault.
+  if (file->GetMappingMode() != vtkMemoryMappedFile::CopyOnWrite)
+  {
+    vtkErrorMacro("Arrays can only use files mapped CopyOnWrite, " << file->GetFileName()
+                                                                  << " is mapped ReadOnly.");
+    return false;
+  }
+  void* block = file->GetBlock(offset, numberOfValues * sizeof(ValueType));
+  if (!block)
+  {
+    vtkErrorMacro("The " << numberOfValues << " values at offset " << offset
+                         << " are not entirely in " << file->GetFileName());
+    return false;
+  }
+  if (reinterpret_cast<std::uintptr_t>(block) % alignof(ValueType) != 0)
+  {
+    vtkErrorMacro("The values at offset " << offset << " of " << file->GetFileName()
+                                          << " are not aligned for their type.");
+    return false;
+  }
+
+  this->Buffer->SetBuffer(static_cast<ValueType*>(block), numberOfValues, file->GetMapping());
+  this->Size = numberOfValues;
+  this->MaxId = this->Size - 1;
+  this->DataChanged();
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
 void vtkAOSDataArrayTemplate<ValueTypeT>::SetTuple(vtkIdType tupleIdx, const float* tuple)
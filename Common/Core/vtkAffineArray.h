@@ -0,0 +1,38 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAffineArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkAffineArray.h
+ * vtkAffineArray is a vtkImplicitArray using a vtkAffineImplicitBackend: the
+ * value at index i is `slope * i + intercept`.
+ *
+ * ```
+ * vtkNew<vtkAffineArray<vtkIdType>> ids;
+ * ids->ConstructBackend(1, 0);
+ * ids->SetNumberOfTuples(numberOfPoints);
+ * ```
+ *
+ * Add it to the vtkArrayDispatch array list with VTK_DISPATCH_AFFINE_ARRAYS.
+ */
+
+#ifndef vtkAffineArray_h
+#define vtkAffineArray_h
+
+#include "vtkAffineImplicitBackend.h" // For the backend
+#include "vtkImplicitArray.h"
+
+template <typename ValueType>
+using vtkAffineArray = vtkImplicitArray<vtkAffineImplicitBackend<ValueType>>;
+
+#endif
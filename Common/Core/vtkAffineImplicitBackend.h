@@ -0,0 +1,58 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAffineImplicitBackend.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/**
+ * @struct  vtkAffineImplicitBackend
+ * @brief   backend of vtkAffineArray: values in arithmetic progression
+ *
+ * A backend for vtkImplicitArray returning `Slope * index + Intercept`, e.g.
+ * for identifiers (slope 1, intercept 0) or regular coordinates, without
+ * allocating them.
+ *
+ * @sa
+ * vtkImplicitArray vtkAffineArray
+ */
+
+#ifndef vtkAffineImplicitBackend_h
+#define vtkAffineImplicitBackend_h
+
+#include "vtkType.h"
+
+template <typename ValueType>
+struct vtkAffineImplicitBackend
+{
+  vtkAffineImplicitBackend() = default;
+
+  /**
+   * The value at index i is `slope * i + intercept`.
+   */
+  vtkAffineImplicitBackend(ValueType slope, ValueType intercept)
+    : Slope(slope)
+    , Intercept(intercept)
+  {
+  }
+
+  ValueType operator()(vtkIdType idx) const
+  {
+    return static_cast<ValueType>(this->Slope * idx + this->Intercept);
+  }
+
+  unsigned long getMemorySize() const { return 1; }
+
+  ValueType Slope = ValueType(1);
+  ValueType Intercept = ValueType(0);
+};
+
+#endif
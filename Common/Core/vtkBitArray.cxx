@@ -828,6 +828,7 @@ void vtkBitArray::DataChanged()
   {
     this->Lookup->Rebuild = true;
   }
+  this->ClearIncrementalRanges();
 }
 
 //------------------------------------------------------------------------------
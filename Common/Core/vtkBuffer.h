@@ -25,8 +25,10 @@
 #ifndef vtkBuffer_h
 #define vtkBuffer_h
 
+#include "vtkMemoryResource.h" // For vtkMemoryResource
 #include "vtkObject.h"
 #include "vtkObjectFactory.h" // New() implementation
+#include "vtkSmartPointer.h"  // For vtkSmartPointer
 
 #include <algorithm> // for std::min and std::copy
 
@@ -53,6 +55,13 @@ public:
    */
   void SetBuffer(ScalarType* array, vtkIdType size);
 
+  /**
+   * Use memory owned by @a owner, e.g. a vtkMemoryMappedFile mapping. A
+   * reference to @a owner is held as long as this object uses @a array,
+   * which is never freed: it is copied to new memory when reallocated.
+   */
+  void SetBuffer(ScalarType* array, vtkIdType size, vtkObjectBase* owner);
+
   /**
    * Set the malloc function to be used when allocating space inside this object.
    **/
@@ -71,6 +80,18 @@ public:
    **/
   void SetFreeFunction(bool noFreeFunction, vtkFreeingFunction deleteFunction = free);
 
+  ///@{
+  /**
+   * Set the memory resource used by the next allocations of this buffer. When
+   * set, it is used instead of the malloc and realloc functions. The memory
+   * currently held is still released the way it was allocated. New buffers
+   * use the vtkMemoryResource::GetDefaultResource() of the thread creating
+   * them, unless memkind is in use.
+   **/
+  void SetMemoryResource(vtkMemoryResource* resource) { this->MemoryResource = resource; }
+  vtkMemoryResource* GetMemoryResource() const { return this->MemoryResource; }
+  ///@}
+
   /**
    * Return the number of elements the current buffer can hold.
    */
@@ -95,6 +116,10 @@ protected:
     this->SetMallocFunction(vtkObjectBase::GetCurrentMallocFunction());
     this->SetReallocFunction(vtkObjectBase::GetCurrentReallocFunction());
     this->SetFreeFunction(false, vtkObjectBase::GetCurrentFreeFunction());
+    if (!vtkObjectBase::GetUsingMemkind())
+    {
+      this->MemoryResource = vtkMemoryResource::GetDefaultResource();
+    }
   }
 
   ~vtkBuffer() override { this->SetBuffer(nullptr, 0); }
@@ -104,6 +129,11 @@ protected:
   vtkMallocingFunction MallocFunction;
   vtkReallocingFunction ReallocFunction;
   vtkFreeingFunction DeleteFunction;
+  vtkSmartPointer<vtkMemoryResource> MemoryResource;
+  // Resource that allocated Pointer, if any. It takes precedence over DeleteFunction.
+  vtkSmartPointer<vtkMemoryResource> PointerResource;
+  // Object keeping Pointer alive when it is not owned by this buffer.
+  vtkSmartPointer<vtkObjectBase> PointerOwner;
 
 private:
   vtkBuffer(const vtkBuffer&) = delete;
@@ -129,14 +159,30 @@ void vtkBuffer<ScalarT>::SetBuffer(typename vtkBuffer<ScalarT>::ScalarType* arra
 {
   if (this->Pointer != array)
   {
-    if (this->DeleteFunction)
+    if (this->PointerResource)
+    {
+      this->PointerResource->Deallocate(this->Pointer, this->Size * sizeof(ScalarType));
+      this->PointerResource = nullptr;
+    }
+    else if (this->DeleteFunction)
     {
       this->DeleteFunction(this->Pointer);
     }
+    this->PointerOwner = nullptr;
     this->Pointer = array;
   }
   this->Size = size;
 }
+
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+void vtkBuffer<ScalarT>::SetBuffer(
+  typename vtkBuffer<ScalarT>::ScalarType* array, vtkIdType size, vtkObjectBase* owner)
+{
+  this->SetBuffer(array, size);
+  this->SetFreeFunction(true);
+  this->PointerOwner = owner;
+}
 //------------------------------------------------------------------------------
 template <typename ScalarT>
 void vtkBuffer<ScalarT>::SetMallocFunction(vtkMallocingFunction mallocFunction)
@@ -170,6 +216,18 @@ bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
 {
   // release old memory.
   this->SetBuffer(nullptr, 0);
+  if (size > 0 && this->MemoryResource)
+  {
+    ScalarType* newArray =
+      static_cast<ScalarType*>(this->MemoryResource->Allocate(size * sizeof(ScalarType)));
+    if (!newArray)
+    {
+      return false;
+    }
+    this->SetBuffer(newArray, size);
+    this->PointerResource = this->MemoryResource;
+    return true;
+  }
   if (size > 0)
   {
     ScalarType* newArray;
@@ -204,7 +262,39 @@ bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
     return this->Allocate(0);
   }
 
-  if (this->Pointer && this->DeleteFunction != free)
+  if (this->MemoryResource)
+  {
+    ScalarType* newArray;
+    if (this->PointerResource == this->MemoryResource)
+    {
+      newArray = static_cast<ScalarType*>(this->MemoryResource->Reallocate(
+        this->Pointer, this->Size * sizeof(ScalarType), newsize * sizeof(ScalarType)));
+      if (!newArray)
+      {
+        return false;
+      }
+      this->Pointer = newArray;
+      this->Size = newsize;
+      return true;
+    }
+
+    // The current memory comes from elsewhere: move it to the resource.
+    newArray =
+      static_cast<ScalarType*>(this->MemoryResource->Allocate(newsize * sizeof(ScalarType)));
+    if (!newArray)
+    {
+      return false;
+    }
+    if (this->Pointer)
+    {
+      std::copy(this->Pointer, this->Pointer + (std::min)(this->Size, newsize), newArray);
+    }
+    this->SetBuffer(newArray, newsize);
+    this->PointerResource = this->MemoryResource;
+    return true;
+  }
+
+  if (this->Pointer && (this->PointerResource || this->DeleteFunction != free))
   {
     ScalarType* newArray;
     bool forceFreeFunction = false;
@@ -0,0 +1,78 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompositeArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkCompositeArray.h
+ * vtkCompositeArray is a vtkImplicitArray using a vtkCompositeImplicitBackend:
+ * it exposes the values of several arrays one after the other without
+ * copying them. Use vtk::ConcatenateDataArrays() to create one:
+ *
+ * ```
+ * auto points = vtk::ConcatenateDataArrays<float>({ input0Points, input1Points });
+ * ```
+ *
+ * Add it to the vtkArrayDispatch array list with VTK_DISPATCH_COMPOSITE_ARRAYS.
+ */
+
+#ifndef vtkCompositeArray_h
+#define vtkCompositeArray_h
+
+#include "vtkCompositeImplicitBackend.h" // For the backend
+#include "vtkImplicitArray.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <vector> // For std::vector
+
+template <typename ValueType>
+using vtkCompositeArray = vtkImplicitArray<vtkCompositeImplicitBackend<ValueType>>;
+
+namespace vtk
+{
+/**
+ * Create a vtkCompositeArray concatenating @a arrays, which must have the
+ * same number of components. Returns nullptr if they do not.
+ */
+template <typename ValueType>
+vtkSmartPointer<vtkCompositeArray<ValueType>> ConcatenateDataArrays(
+  const std::vector<vtkDataArray*>& arrays)
+{
+  int numComps = -1;
+  for (vtkDataArray* array : arrays)
+  {
+    if (!array)
+    {
+      continue;
+    }
+    if (numComps >= 0 && array->GetNumberOfComponents() != numComps)
+    {
+      vtkGenericWarningMacro("Cannot concatenate arrays with different numbers of components.");
+      return nullptr;
+    }
+    numComps = array->GetNumberOfComponents();
+  }
+
+  auto composite = vtkSmartPointer<vtkCompositeArray<ValueType>>::New();
+  composite->ConstructBackend(arrays);
+  composite->SetNumberOfComponents(numComps > 0 ? numComps : 1);
+  composite->SetNumberOfTuples(
+    composite->GetBackend()->GetNumberOfValues() / composite->GetNumberOfComponents());
+  if (!arrays.empty() && arrays.front())
+  {
+    composite->SetName(arrays.front()->GetName());
+  }
+  return composite;
+}
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompositeImplicitBackend.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/**
+ * @class   vtkCompositeImplicitBackend
+ * @brief   backend of vtkCompositeArray: concatenation of arrays
+ *
+ * A backend for vtkImplicitArray exposing the values of several arrays, one
+ * after the other, without copying them. The arrays must have the same
+ * number of components, and must not be modified while they are used.
+ * Looking a value up costs a binary search in the list of arrays.
+ *
+ * @sa
+ * vtkImplicitArray vtkCompositeArray
+ */
+
+#ifndef vtkCompositeImplicitBackend_h
+#define vtkCompositeImplicitBackend_h
+
+#include "vtkAOSDataArrayTemplate.h" // For the fast path
+#include "vtkDataArray.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <vector> // For std::vector
+
+template <typename ValueType>
+class vtkCompositeImplicitBackend
+{
+public:
+  vtkCompositeImplicitBackend() = default;
+
+  /**
+   * Concatenate @a arrays, which are kept alive by the backend.
+   */
+  explicit vtkCompositeImplicitBackend(const std::vector<vtkDataArray*>& arrays);
+
+  ValueType operator()(vtkIdType idx) const;
+
+  unsigned long getMemorySize() const;
+
+  /**
+   * Number of values of the concatenated arrays.
+   */
+  vtkIdType GetNumberOfValues() const { return this->Offsets.back(); }
+
+private:
+  std::vector<vtkSmartPointer<vtkDataArray>> Arrays;
+  // Arrays of the value type of the backend, for direct access.
+  std::vector<vtkAOSDataArrayTemplate<ValueType>*> TypedArrays;
+  // Index of the first value of each array, followed by the number of values.
+  std::vector<vtkIdType> Offsets = std::vector<vtkIdType>(1, 0);
+};
+
+#include "vtkCompositeImplicitBackend.txx"
+
+#endif
@@ -0,0 +1,67 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompositeImplicitBackend.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+
+#ifndef vtkCompositeImplicitBackend_txx
+#define vtkCompositeImplicitBackend_txx
+
+#include "vtkCompositeImplicitBackend.h"
+
+#include <algorithm> // For std::upper_bound
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+vtkCompositeImplicitBackend<ValueType>::vtkCompositeImplicitBackend(
+  const std::vector<vtkDataArray*>& arrays)
+{
+  for (vtkDataArray* array : arrays)
+  {
+    if (!array || array->GetNumberOfValues() == 0)
+    {
+      continue;
+    }
+    this->Arrays.emplace_back(array);
+    this->TypedArrays.push_back(vtkArrayDownCast<vtkAOSDataArrayTemplate<ValueType>>(array));
+    this->Offsets.push_back(this->Offsets.back() + array->GetNumberOfValues());
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+ValueType vtkCompositeImplicitBackend<ValueType>::operator()(vtkIdType idx) const
+{
+  const auto next = std::upper_bound(this->Offsets.begin() + 1, this->Offsets.end(), idx);
+  const std::size_t arrayIdx = static_cast<std::size_t>(next - this->Offsets.begin()) - 1;
+  const vtkIdType localIdx = idx - this->Offsets[arrayIdx];
+  if (vtkAOSDataArrayTemplate<ValueType>* typed = this->TypedArrays[arrayIdx])
+  {
+    return typed->GetValue(localIdx);
+  }
+  vtkDataArray* array = this->Arrays[arrayIdx];
+  const int numComps = array->GetNumberOfComponents();
+  return static_cast<ValueType>(array->GetComponent(localIdx / numComps, localIdx % numComps));
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+unsigned long vtkCompositeImplicitBackend<ValueType>::getMemorySize() const
+{
+  // The arrays are shared with their other users and not accounted here.
+  const std::size_t bytes =
+    this->Arrays.size() * (sizeof(vtkDataArray*) * 2 + sizeof(vtkIdType)) + sizeof(*this);
+  return static_cast<unsigned long>(bytes / 1024 + 1);
+}
+
+#endif
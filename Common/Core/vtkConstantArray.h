@@ -0,0 +1,38 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConstantArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkConstantArray.h
+ * vtkConstantArray is a vtkImplicitArray using a vtkConstantImplicitBackend:
+ * every value of the array is the same.
+ *
+ * ```
+ * vtkNew<vtkConstantArray<unsigned char>> ghosts;
+ * ghosts->ConstructBackend(0);
+ * ghosts->SetNumberOfTuples(numberOfCells);
+ * ```
+ *
+ * Add it to the vtkArrayDispatch array list with VTK_DISPATCH_CONSTANT_ARRAYS.
+ */
+
+#ifndef vtkConstantArray_h
+#define vtkConstantArray_h
+
+#include "vtkConstantImplicitBackend.h" // For the backend
+#include "vtkImplicitArray.h"
+
+template <typename ValueType>
+using vtkConstantArray = vtkImplicitArray<vtkConstantImplicitBackend<ValueType>>;
+
+#endif
@@ -0,0 +1,52 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConstantImplicitBackend.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/**
+ * @struct  vtkConstantImplicitBackend
+ * @brief   backend of vtkConstantArray: the same value everywhere
+ *
+ * A backend for vtkImplicitArray returning the same value for every index,
+ * e.g. for ghost arrays or constant attributes, without allocating them.
+ *
+ * @sa
+ * vtkImplicitArray vtkConstantArray
+ */
+
+#ifndef vtkConstantImplicitBackend_h
+#define vtkConstantImplicitBackend_h
+
+#include "vtkType.h"
+
+template <typename ValueType>
+struct vtkConstantImplicitBackend
+{
+  vtkConstantImplicitBackend() = default;
+
+  /**
+   * Every value of the array is @a value.
+   */
+  explicit vtkConstantImplicitBackend(ValueType value)
+    : Value(value)
+  {
+  }
+
+  ValueType operator()(vtkIdType) const { return this->Value; }
+
+  unsigned long getMemorySize() const { return 1; }
+
+  ValueType Value = ValueType(0);
+};
+
+#endif
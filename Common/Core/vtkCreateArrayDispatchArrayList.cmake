@@ -15,6 +15,14 @@
 #   Include vtkTypedDataArray<ValueType> for the basic types supported
 #   by VTK. This enables the old-style in-situ vtkMappedDataArray subclasses
 #   to be used.
+# - VTK_DISPATCH_AFFINE_ARRAYS (default: OFF)
+#   Include vtkAffineArray<ValueType> for the basic types supported by VTK.
+# - VTK_DISPATCH_COMPOSITE_ARRAYS (default: OFF)
+#   Include vtkCompositeArray<ValueType> for the basic types supported by VTK.
+# - VTK_DISPATCH_CONSTANT_ARRAYS (default: OFF)
+#   Include vtkConstantArray<ValueType> for the basic types supported by VTK.
+# - VTK_DISPATCH_INDEXED_ARRAYS (default: OFF)
+#   Include vtkIndexedArray<ValueType> for the basic types supported by VTK.
 #
 # At a lower level, specific arrays can be added to the list individually in
 # two ways:
@@ -146,6 +154,38 @@ if (VTK_DISPATCH_TYPED_ARRAYS)
   )
 endif()
 
+if (VTK_DISPATCH_AFFINE_ARRAYS)
+  list(APPEND vtkArrayDispatch_containers vtkAffineArray)
+  set(vtkArrayDispatch_vtkAffineArray_header vtkAffineArray.h)
+  set(vtkArrayDispatch_vtkAffineArray_types
+    ${vtkArrayDispatch_all_types}
+  )
+endif()
+
+if (VTK_DISPATCH_COMPOSITE_ARRAYS)
+  list(APPEND vtkArrayDispatch_containers vtkCompositeArray)
+  set(vtkArrayDispatch_vtkCompositeArray_header vtkCompositeArray.h)
+  set(vtkArrayDispatch_vtkCompositeArray_types
+    ${vtkArrayDispatch_all_types}
+  )
+endif()
+
+if (VTK_DISPATCH_CONSTANT_ARRAYS)
+  list(APPEND vtkArrayDispatch_containers vtkConstantArray)
+  set(vtkArrayDispatch_vtkConstantArray_header vtkConstantArray.h)
+  set(vtkArrayDispatch_vtkConstantArray_types
+    ${vtkArrayDispatch_all_types}
+  )
+endif()
+
+if (VTK_DISPATCH_INDEXED_ARRAYS)
+  list(APPEND vtkArrayDispatch_containers vtkIndexedArray)
+  set(vtkArrayDispatch_vtkIndexedArray_header vtkIndexedArray.h)
+  set(vtkArrayDispatch_vtkIndexedArray_types
+    ${vtkArrayDispatch_all_types}
+  )
+endif()
+
 endmacro()
 
 # Concatenates a list of strings into a single string, since string(CONCAT ...)
@@ -48,6 +48,20 @@
 #include "vtkUnsignedShortArray.h"
 
 #include <algorithm> // for min(), max()
+#include <type_traits>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Ranges kept for vtkDataArray::ModifiedTuples(), the typed ranges derive
+// from it.
+class vtkDataArrayIncrementalRanges
+{
+public:
+  virtual ~vtkDataArrayIncrementalRanges() = default;
+
+  // Number of tuples covered by the ranges.
+  vtkIdType NumberOfTuples = 0;
+};
 
 namespace
 {
@@ -440,6 +454,104 @@ bool hasValidKey(InfoType info, KeyType key, ComponentKeyType ckey, double range
   return false;
 }
 
+//------------------------------------------------------------------------------
+// Component ranges of the first NumberOfTuples tuples of an array.
+template <typename ValueType>
+class TypedIncrementalRanges : public vtkDataArrayIncrementalRanges
+{
+public:
+  std::vector<ValueType> Ranges;
+};
+
+//------------------------------------------------------------------------------
+// The ranges of 64 bit integers are kept in their value type, which is exact.
+// The other value types are exact in double, for which the kernels of
+// vtkDataArrayPrivate are instantiated with every array type.
+template <typename APIType>
+using KeptRangeType =
+  typename std::conditional<std::is_integral<APIType>::value && (sizeof(APIType) > 4), APIType,
+    double>::type;
+
+//------------------------------------------------------------------------------
+// Merge the component ranges of the tuples [begin, end) into ranges.
+template <typename ArrayT, typename RangeType>
+void ExtendScalarRanges(
+  ArrayT* array, vtkIdType begin, vtkIdType end, bool finiteOnly, std::vector<RangeType>& ranges)
+{
+  if (finiteOnly)
+  {
+    vtkDataArrayPrivate::DoExtendScalarRange(
+      array, ranges.data(), vtkDataArrayPrivate::FiniteValues(), begin, end);
+  }
+  else
+  {
+    vtkDataArrayPrivate::DoExtendScalarRange(
+      array, ranges.data(), vtkDataArrayPrivate::AllValues(), begin, end);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Bring the kept ranges of an array up to its last tuple, scanning only the
+// tuples they do not cover yet, and copy them to Output.
+struct IncrementalScalarRangeWorker
+{
+  std::unique_ptr<vtkDataArrayIncrementalRanges>& Kept;
+  bool FiniteOnly;
+  double* Output;
+  bool Success = false;
+
+  IncrementalScalarRangeWorker(
+    std::unique_ptr<vtkDataArrayIncrementalRanges>& kept, bool finiteOnly, double* output)
+    : Kept(kept)
+    , FiniteOnly(finiteOnly)
+    , Output(output)
+  {
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    using RangeType = KeptRangeType<vtk::GetAPIType<ArrayT>>;
+    const size_t numRanges = static_cast<size_t>(2 * array->GetNumberOfComponents());
+    const vtkIdType numTuples = array->GetNumberOfTuples();
+    auto* kept = dynamic_cast<TypedIncrementalRanges<RangeType>*>(this->Kept.get());
+    if (!kept || kept->Ranges.size() != numRanges || kept->NumberOfTuples > numTuples)
+    {
+      this->Kept.reset();
+      if (numTuples == 0)
+      {
+        // Same output as vtkDataArray::ComputeScalarRange() for empty arrays.
+        for (size_t j = 0; j < numRanges; j += 2)
+        {
+          this->Output[j] = VTK_DOUBLE_MAX;
+          this->Output[j + 1] = VTK_DOUBLE_MIN;
+        }
+        this->Success = false;
+        return;
+      }
+      std::unique_ptr<TypedIncrementalRanges<RangeType>> ranges(
+        new TypedIncrementalRanges<RangeType>);
+      ranges->Ranges.resize(numRanges);
+      for (size_t j = 0; j < numRanges; j += 2)
+      {
+        ranges->Ranges[j] = vtkTypeTraits<RangeType>::Max();
+        ranges->Ranges[j + 1] = vtkTypeTraits<RangeType>::Min();
+      }
+      ExtendScalarRanges(array, 0, numTuples, this->FiniteOnly, ranges->Ranges);
+      ranges->NumberOfTuples = numTuples;
+      kept = ranges.get();
+      this->Kept = std::move(ranges);
+    }
+    else if (kept->NumberOfTuples < numTuples)
+    {
+      ExtendScalarRanges(array, kept->NumberOfTuples, numTuples, this->FiniteOnly, kept->Ranges);
+      kept->NumberOfTuples = numTuples;
+    }
+    std::copy(kept->Ranges.begin(), kept->Ranges.end(), this->Output);
+    this->Success = true;
+  }
+};
+
 } // end anon namespace
 
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
@@ -1551,6 +1663,26 @@ void vtkDataArray::CopyComponent(int dstComponent, vtkDataArray* src, int srcCom
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkDataArray::LookupValues(vtkDataArray* values, vtkIdList* valueIds)
+{
+  valueIds->Reset();
+  if (!values)
+  {
+    return;
+  }
+
+  const vtkIdType numValues = values->GetNumberOfValues();
+  const int numComps = values->GetNumberOfComponents();
+  valueIds->SetNumberOfIds(numValues);
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    const vtkIdType tupleIdx = i / numComps;
+    const int compIdx = static_cast<int>(i - tupleIdx * numComps);
+    valueIds->SetId(i, this->LookupValue(vtkVariant(values->GetComponent(tupleIdx, compIdx))));
+  }
+}
+
 //------------------------------------------------------------------------------
 double vtkDataArray::GetMaxNorm()
 {
@@ -1585,6 +1717,7 @@ int vtkDataArray::CopyInformation(vtkInformation* infoFrom, int deep)
   {
     myInfo->Remove(L2_NORM_RANGE());
   }
+  this->ClearIncrementalRanges();
 
   return 1;
 }
@@ -1645,7 +1778,7 @@ void vtkDataArray::ComputeFiniteRange(
     if (!hasValidKey(info, PER_FINITE_COMPONENT(), rkey, range, comp))
     {
       double* allCompRanges = new double[this->NumberOfComponents * 2];
-      const bool computed = this->ComputeFiniteScalarRange(allCompRanges);
+      const bool computed = this->ComputeIncrementalScalarRange(allCompRanges, true);
       if (computed)
       {
         // construct the keys and add them to the info object
@@ -1724,7 +1857,7 @@ void vtkDataArray::ComputeRange(
     if (!hasValidKey(info, PER_COMPONENT(), rkey, range, comp))
     {
       double* allCompRanges = new double[this->NumberOfComponents * 2];
-      const bool computed = this->ComputeScalarRange(allCompRanges);
+      const bool computed = this->ComputeIncrementalScalarRange(allCompRanges, false);
       if (computed)
       {
         // construct the keys and add them to the info object
@@ -1758,9 +1891,80 @@ void vtkDataArray::Modified()
     info->Remove(L2_NORM_RANGE());
     info->Remove(L2_NORM_FINITE_RANGE());
   }
+  if (!this->KeepIncrementalRanges)
+  {
+    this->ClearIncrementalRanges();
+  }
   this->Superclass::Modified();
 }
 
+//------------------------------------------------------------------------------
+void vtkDataArray::ModifiedTuples(vtkIdType beginTuple, vtkIdType endTuple)
+{
+  // The tuples past the kept ranges are scanned by the next range
+  // computation. The ones they cover may have held a bound.
+  for (auto& kept : this->IncrementalRanges)
+  {
+    if (kept && beginTuple < std::min(endTuple, kept->NumberOfTuples))
+    {
+      kept.reset();
+    }
+  }
+
+  // Modified() drops the cached ranges, and the kept ones unless told not
+  // to. It is virtual, so that the subclasses still see the change.
+  this->KeepIncrementalRanges = true;
+  this->Modified();
+  this->KeepIncrementalRanges = false;
+}
+
+//------------------------------------------------------------------------------
+void vtkDataArray::ClearIncrementalRanges()
+{
+  this->IncrementalRanges[0].reset();
+  this->IncrementalRanges[1].reset();
+}
+
+//------------------------------------------------------------------------------
+bool vtkDataArray::ComputeIncrementalScalarRange(double* ranges, bool finiteOnly)
+{
+  std::unique_ptr<vtkDataArrayIncrementalRanges>& kept = this->IncrementalRanges[finiteOnly];
+  IncrementalScalarRangeWorker worker(kept, finiteOnly, ranges);
+  if (vtkArrayDispatch::Dispatch::Execute(this, worker))
+  {
+    return worker.Success;
+  }
+
+  // Other arrays may override the range computation, e.g.
+  // vtkPeriodicDataArray: use it for the full scans, and keep double ranges.
+  const size_t numRanges = static_cast<size_t>(2 * this->NumberOfComponents);
+  const vtkIdType numTuples = this->GetNumberOfTuples();
+  auto* typedKept = dynamic_cast<TypedIncrementalRanges<double>*>(kept.get());
+  if (!typedKept || typedKept->Ranges.size() != numRanges || typedKept->NumberOfTuples > numTuples)
+  {
+    kept.reset();
+    const bool computed =
+      finiteOnly ? this->ComputeFiniteScalarRange(ranges) : this->ComputeScalarRange(ranges);
+    if (computed)
+    {
+      std::unique_ptr<TypedIncrementalRanges<double>> newRanges(new TypedIncrementalRanges<double>);
+      newRanges->Ranges.assign(ranges, ranges + numRanges);
+      newRanges->NumberOfTuples = numTuples;
+      kept = std::move(newRanges);
+    }
+    return computed;
+  }
+
+  if (typedKept->NumberOfTuples < numTuples)
+  {
+    ExtendScalarRanges(
+      this, typedKept->NumberOfTuples, numTuples, finiteOnly, typedKept->Ranges);
+    typedKept->NumberOfTuples = numTuples;
+  }
+  std::copy(typedKept->Ranges.begin(), typedKept->Ranges.end(), ranges);
+  return true;
+}
+
 namespace
 {
 
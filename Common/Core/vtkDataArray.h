@@ -39,6 +39,9 @@
 #include "vtkCommonCoreModule.h"          // For export macro
 #include "vtkVTK_USE_SCALED_SOA_ARRAYS.h" // For #define of VTK_USE_SCALED_SOA_ARRAYS
 
+#include <memory> // For std::unique_ptr
+
+class vtkDataArrayIncrementalRanges;
 class vtkDoubleArray;
 class vtkIdList;
 class vtkInformationStringKey;
@@ -311,6 +314,14 @@ public:
    */
   virtual void CopyComponent(int dstComponent, vtkDataArray* src, int srcComponent);
 
+  /**
+   * Batched version of LookupValue(): set the i-th id of @a valueIds to the
+   * index of the first value of this array equal to the i-th value of
+   * @a values, or to -1 if there is none. Subclasses built on
+   * vtkGenericDataArray look the values up in parallel.
+   */
+  virtual void LookupValues(vtkDataArray* values, vtkIdList* valueIds);
+
   /**
    * Get the address of a particular data index. Make sure data is allocated
    * for the number of items requested. If needed, increase MaxId to mark any
@@ -527,6 +538,25 @@ public:
    */
   void Modified() override;
 
+  /**
+   * Mark the array as modified after the tuples in [beginTuple, endTuple)
+   * were changed, typically appended. Unlike Modified(), the component
+   * ranges computed so far are kept when the changed tuples all follow the
+   * tuples they cover, and the next GetRange() or GetFiniteRange() of a
+   * component only scans the new tuples instead of the whole array. This
+   * makes the range of a growing array, e.g. for color mapping, cost the
+   * size of the appended tuples.
+   *
+   * Changing tuples covered by the ranges drops them, and the next range is
+   * a full scan. The magnitude ranges are always recomputed. Only this
+   * method keeps the ranges: any other write, e.g. with SetTuple(),
+   * InsertTuple() or SetValue(), is followed by Modified(), which drops them
+   * and makes the next range a full recompute.
+   *
+   * THIS METHOD IS NOT THREAD SAFE.
+   */
+  void ModifiedTuples(vtkIdType beginTuple, vtkIdType endTuple);
+
   /**
    * A human-readable string indicating the units for the array data.
    */
@@ -675,6 +705,13 @@ protected:
   vtkDataArray();
   ~vtkDataArray() override;
 
+  /**
+   * Drop the ranges kept for ModifiedTuples(). Subclasses call it when the
+   * values change in a way ModifiedTuples() cannot follow, e.g. in
+   * DataChanged().
+   */
+  void ClearIncrementalRanges();
+
   vtkLookupTable* LookupTable;
   double Range[2];
   double FiniteRange[2];
@@ -682,6 +719,15 @@ protected:
 private:
   double* GetTupleN(vtkIdType i, int n);
 
+  bool ComputeIncrementalScalarRange(double* ranges, bool finiteOnly);
+
+  // Component ranges of all the values ([0]) and of the finite values ([1])
+  // of the tuples scanned so far, in the value type of the array.
+  std::unique_ptr<vtkDataArrayIncrementalRanges> IncrementalRanges[2];
+  // Set by ModifiedTuples() while it calls Modified(), so that the ranges it
+  // kept are not dropped.
+  bool KeepIncrementalRanges = false;
+
 private:
   vtkDataArray(const vtkDataArray&) = delete;
   void operator=(const vtkDataArray&) = delete;
@@ -101,6 +101,75 @@ bool isinf(T x)
   // Select the correct partially specialized type.
   return has_infinity<T, std::numeric_limits<T>::has_infinity>::isinf(x);
 }
+
+// Branch free finiteness test: the difference is NaN for infinite and NaN
+// values, and always 0 for finite values and integers.
+template <typename T>
+bool is_finite(T x)
+{
+  return x - x == 0;
+}
+
+//----------------------------------------------------------------------------
+// Kernel of the ranges of AOS arrays, which are contiguous. The values are
+// accumulated in independent lanes covering TuplesPerBlock tuples: there is
+// no dependency between consecutive values and no branch, so the compiler
+// turns the inner loop into packed min/max instructions for all the value
+// types. NaN never compares, so it is skipped as by
+// vtkMathUtilities::UpdateRange. The other iterators cannot be vectorized,
+// and return false to use the tuple loop.
+template <int NumComps, bool FiniteOnly, typename ValueType, typename APIType>
+bool ContiguousMinAndMax(
+  const ValueType* values, vtkIdType numTuples, std::array<APIType, 2 * NumComps>& range)
+{
+  constexpr int TuplesPerBlock = NumComps >= 16 ? 1 : 16 / NumComps;
+  constexpr int BlockSize = NumComps * TuplesPerBlock;
+  APIType mins[BlockSize];
+  APIType maxs[BlockSize];
+  for (int lane = 0; lane < BlockSize; ++lane)
+  {
+    mins[lane] = range[2 * (lane % NumComps)];
+    maxs[lane] = range[2 * (lane % NumComps) + 1];
+  }
+
+  const vtkIdType numBlocks = numTuples / TuplesPerBlock;
+  for (vtkIdType block = 0; block < numBlocks; ++block, values += BlockSize)
+  {
+    for (int lane = 0; lane < BlockSize; ++lane)
+    {
+      const APIType value = static_cast<APIType>(values[lane]);
+      const APIType low = (!FiniteOnly || is_finite(value)) ? value : mins[lane];
+      const APIType high = (!FiniteOnly || is_finite(value)) ? value : maxs[lane];
+      mins[lane] = low < mins[lane] ? low : mins[lane];
+      maxs[lane] = high > maxs[lane] ? high : maxs[lane];
+    }
+  }
+
+  for (int lane = 0; lane < BlockSize; ++lane)
+  {
+    const int comp = lane % NumComps;
+    range[2 * comp] = min(range[2 * comp], mins[lane]);
+    range[2 * comp + 1] = max(range[2 * comp + 1], maxs[lane]);
+  }
+  for (vtkIdType tuple = numBlocks * TuplesPerBlock; tuple < numTuples; ++tuple)
+  {
+    for (int comp = 0; comp < NumComps; ++comp, ++values)
+    {
+      const APIType value = static_cast<APIType>(*values);
+      if (!FiniteOnly || is_finite(value))
+      {
+        vtkMathUtilities::UpdateRange(range[2 * comp], range[2 * comp + 1], value);
+      }
+    }
+  }
+  return true;
+}
+
+template <int NumComps, bool FiniteOnly, typename IteratorType, typename RangeType>
+bool ContiguousMinAndMax(IteratorType, vtkIdType, RangeType&)
+{
+  return false;
+}
 }
 
 template <typename APIType, int NumComps>
@@ -173,8 +242,17 @@ public:
   void Reduce() { MinAndMaxT::Reduce(); }
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
     auto& range = MinAndMaxT::TLRange.Local();
+    if (!this->Ghosts)
+    {
+      const auto values =
+        vtk::DataArrayValueRange<NumComps>(this->Array, begin * NumComps, end * NumComps);
+      if (detail::ContiguousMinAndMax<NumComps, false>(values.begin(), end - begin, range))
+      {
+        return;
+      }
+    }
+    const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -214,8 +292,17 @@ public:
   void Reduce() { MinAndMaxT::Reduce(); }
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
     auto& range = MinAndMaxT::TLRange.Local();
+    if (!this->Ghosts)
+    {
+      const auto values =
+        vtk::DataArrayValueRange<NumComps>(this->Array, begin * NumComps, end * NumComps);
+      if (detail::ContiguousMinAndMax<NumComps, true>(values.begin(), end - begin, range))
+      {
+        return;
+      }
+    }
+    const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -349,19 +436,19 @@ struct ComputeScalarRange
 {
   template <class ArrayT, typename RangeValueType>
   bool operator()(ArrayT* array, RangeValueType* ranges, AllValues, const unsigned char* ghosts,
-    unsigned char ghostsToSkip)
+    unsigned char ghostsToSkip, vtkIdType begin, vtkIdType end)
   {
     AllValuesMinAndMax<NumComps, ArrayT> minmax(array, ghosts, ghostsToSkip);
-    vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+    vtkSMPTools::For(begin, end, minmax);
     minmax.CopyRanges(ranges);
     return true;
   }
   template <class ArrayT, typename RangeValueType>
   bool operator()(ArrayT* array, RangeValueType* ranges, FiniteValues, const unsigned char* ghosts,
-    unsigned char ghostsToSkip)
+    unsigned char ghostsToSkip, vtkIdType begin, vtkIdType end)
   {
     FiniteMinAndMax<NumComps, ArrayT> minmax(array, ghosts, ghostsToSkip);
-    vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+    vtkSMPTools::For(begin, end, minmax);
     minmax.CopyRanges(ranges);
     return true;
   }
@@ -502,86 +589,120 @@ public:
 
 template <class ArrayT, typename RangeValueType>
 bool GenericComputeScalarRange(ArrayT* array, RangeValueType* ranges, AllValues,
-  const unsigned char* ghosts, unsigned char ghostsToSkip)
+  const unsigned char* ghosts, unsigned char ghostsToSkip, vtkIdType begin, vtkIdType end)
 {
   AllValuesGenericMinAndMax<ArrayT> minmax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+  vtkSMPTools::For(begin, end, minmax);
   minmax.CopyRanges(ranges);
   return true;
 }
 
 template <class ArrayT, typename RangeValueType>
 bool GenericComputeScalarRange(ArrayT* array, RangeValueType* ranges, FiniteValues,
-  const unsigned char* ghosts, unsigned char ghostsToSkip)
+  const unsigned char* ghosts, unsigned char ghostsToSkip, vtkIdType begin, vtkIdType end)
 {
   FiniteGenericMinAndMax<ArrayT> minmax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+  vtkSMPTools::For(begin, end, minmax);
   minmax.CopyRanges(ranges);
   return true;
 }
 
 //----------------------------------------------------------------------------
+// Ranges of the tuples [begin, end), dispatched on the number of components.
 template <typename ArrayT, typename RangeValueType, typename ValueType>
-bool DoComputeScalarRange(ArrayT* array, RangeValueType* ranges, ValueType tag,
-  const unsigned char* ghosts, unsigned char ghostsToSkip)
+bool ComputeTuplesScalarRange(ArrayT* array, RangeValueType* ranges, ValueType tag,
+  const unsigned char* ghosts, unsigned char ghostsToSkip, vtkIdType begin, vtkIdType end)
 {
   const int numComp = array->GetNumberOfComponents();
 
-  // setup the initial ranges to be the max,min for double
-  for (int i = 0, j = 0; i < numComp; ++i, j += 2)
-  {
-    ranges[j] = vtkTypeTraits<RangeValueType>::Max();
-    ranges[j + 1] = vtkTypeTraits<RangeValueType>::Min();
-  }
-
-  // do this after we make sure range is max to min
-  if (array->GetNumberOfTuples() == 0)
-  {
-    return false;
-  }
-
   // Special case for single value scalar range. This is done to help the
   // compiler detect it can perform loop optimizations.
   if (numComp == 1)
   {
-    return ComputeScalarRange<1>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<1>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 2)
   {
-    return ComputeScalarRange<2>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<2>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 3)
   {
-    return ComputeScalarRange<3>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<3>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 4)
   {
-    return ComputeScalarRange<4>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<4>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 5)
   {
-    return ComputeScalarRange<5>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<5>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 6)
   {
-    return ComputeScalarRange<6>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<6>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 7)
   {
-    return ComputeScalarRange<7>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<7>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 8)
   {
-    return ComputeScalarRange<8>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<8>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else if (numComp == 9)
   {
-    return ComputeScalarRange<9>()(array, ranges, tag, ghosts, ghostsToSkip);
+    return ComputeScalarRange<9>()(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
   }
   else
   {
-    return GenericComputeScalarRange(array, ranges, tag, ghosts, ghostsToSkip);
+    return GenericComputeScalarRange(array, ranges, tag, ghosts, ghostsToSkip, begin, end);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT, typename RangeValueType, typename ValueType>
+bool DoComputeScalarRange(ArrayT* array, RangeValueType* ranges, ValueType tag,
+  const unsigned char* ghosts, unsigned char ghostsToSkip)
+{
+  const int numComp = array->GetNumberOfComponents();
+
+  // setup the initial ranges to be the max,min for double
+  for (int i = 0, j = 0; i < numComp; ++i, j += 2)
+  {
+    ranges[j] = vtkTypeTraits<RangeValueType>::Max();
+    ranges[j + 1] = vtkTypeTraits<RangeValueType>::Min();
+  }
+
+  // do this after we make sure range is max to min
+  if (array->GetNumberOfTuples() == 0)
+  {
+    return false;
   }
+
+  return ComputeTuplesScalarRange(
+    array, ranges, tag, ghosts, ghostsToSkip, 0, array->GetNumberOfTuples());
+}
+
+//----------------------------------------------------------------------------
+// Merges the component ranges of the tuples [begin, end) into ranges, which
+// must hold valid bounds, e.g. the ones computed for the previous tuples.
+template <typename ArrayT, typename RangeValueType, typename ValueType>
+bool DoExtendScalarRange(
+  ArrayT* array, RangeValueType* ranges, ValueType tag, vtkIdType begin, vtkIdType end)
+{
+  if (begin >= end)
+  {
+    return true;
+  }
+  const int numComp = array->GetNumberOfComponents();
+  std::vector<RangeValueType> extent(2 * numComp);
+  ComputeTuplesScalarRange(array, extent.data(), tag, nullptr, 0, begin, end);
+  for (int i = 0, j = 0; i < numComp; ++i, j += 2)
+  {
+    ranges[j] = detail::min(ranges[j], extent[j]);
+    ranges[j + 1] = detail::max(ranges[j + 1], extent[j + 1]);
+  }
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -27,3 +27,35 @@ namespace vtkDataArrayPrivate
 {
 VTK_INSTANTIATE_VALUERANGE_ARRAYTYPE(vtkDataArray, double)
 } // namespace vtkDataArrayPrivate
+
+#include "vtkSMPTools.h"
+
+namespace vtkGenericDataArrayLookupHelper_detail
+{
+//------------------------------------------------------------------------------
+void For(vtkIdType size, RangeFunctorType execute, void* functor)
+{
+  vtkSMPTools::For(0, size,
+    [execute, functor](vtkIdType begin, vtkIdType end) { execute(functor, begin, end); });
+}
+
+#define VTK_INSTANTIATE_LOOKUP_SORT(ValueType)                                                     \
+  void Sort(IndexEntry<ValueType>* begin, IndexEntry<ValueType>* end)                              \
+  {                                                                                                \
+    vtkSMPTools::Sort(begin, end, EntryLess<ValueType>);                                           \
+  }
+VTK_INSTANTIATE_LOOKUP_SORT(char)
+VTK_INSTANTIATE_LOOKUP_SORT(signed char)
+VTK_INSTANTIATE_LOOKUP_SORT(unsigned char)
+VTK_INSTANTIATE_LOOKUP_SORT(short)
+VTK_INSTANTIATE_LOOKUP_SORT(unsigned short)
+VTK_INSTANTIATE_LOOKUP_SORT(int)
+VTK_INSTANTIATE_LOOKUP_SORT(unsigned int)
+VTK_INSTANTIATE_LOOKUP_SORT(long)
+VTK_INSTANTIATE_LOOKUP_SORT(unsigned long)
+VTK_INSTANTIATE_LOOKUP_SORT(long long)
+VTK_INSTANTIATE_LOOKUP_SORT(unsigned long long)
+VTK_INSTANTIATE_LOOKUP_SORT(float)
+VTK_INSTANTIATE_LOOKUP_SORT(double)
+#undef VTK_INSTANTIATE_LOOKUP_SORT
+} // namespace vtkGenericDataArrayLookupHelper_detail
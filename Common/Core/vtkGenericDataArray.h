@@ -331,7 +331,20 @@ public:
   virtual vtkIdType LookupTypedValue(ValueType value);
   void LookupValue(vtkVariant value, vtkIdList* valueIds) override;
   virtual void LookupTypedValue(ValueType value, vtkIdList* valueIds);
+  void LookupValues(vtkDataArray* values, vtkIdList* valueIds) override;
   void ClearLookup() override;
+
+  ///@{
+  /**
+   * The lookup methods search a sorted copy of the values of the array, built
+   * in parallel on the first lookup. For categorical data (few distinct
+   * values), UseHashLookup adds a hash table on top of it so that each lookup
+   * is constant time. Changing this clears the lookup structure.
+   * Default is false.
+   */
+  void SetUseHashLookup(bool useHashLookup) { this->Lookup.SetUseHashTable(useHashLookup); }
+  bool GetUseHashLookup() const { return this->Lookup.GetUseHashTable(); }
+  ///@}
   void DataChanged() override;
   void FillComponent(int compIdx, double value) override;
   VTK_NEWINSTANCE vtkArrayIterator* NewIterator() override;
@@ -438,6 +451,8 @@ bool DoComputeVectorRange(
 template <typename A, typename R>
 bool DoComputeVectorRange(
   A*, R[2], FiniteValues, const unsigned char* ghosts, unsigned char ghostsToSkip);
+template <typename A, typename R, typename T>
+bool DoExtendScalarRange(A*, R*, T, vtkIdType begin, vtkIdType end);
 } // namespace vtkDataArrayPrivate
 
 #include "vtkGenericDataArray.txx"
@@ -493,7 +508,11 @@ class vtkScaledSOADataArrayTemplate;
   template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],                \
     vtkDataArrayPrivate::AllValues, const unsigned char*, unsigned char);                          \
   template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],                \
-    vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);
+    vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);                       \
+  template VTKCOMMONCORE_EXPORT bool DoExtendScalarRange(                                          \
+    ArrayType*, ValueType*, vtkDataArrayPrivate::AllValues, vtkIdType, vtkIdType);                 \
+  template VTKCOMMONCORE_EXPORT bool DoExtendScalarRange(                                          \
+    ArrayType*, ValueType*, vtkDataArrayPrivate::FiniteValues, vtkIdType, vtkIdType);
 
 #ifdef VTK_USE_SCALED_SOA_ARRAYS
 
@@ -542,6 +561,8 @@ bool DoComputeVectorRange(
 template <typename A, typename R>
 bool DoComputeVectorRange(
   A*, R[2], FiniteValues, const unsigned char* ghosts, unsigned char ghostsToSkip);
+template <typename A, typename R, typename T>
+bool DoExtendScalarRange(A*, R*, T, vtkIdType begin, vtkIdType end);
 } // namespace vtkDataArrayPrivate
 
 #define VTK_DECLARE_VALUERANGE_ARRAYTYPE(ArrayType, ValueType)                                     \
@@ -552,7 +573,11 @@ bool DoComputeVectorRange(
   extern template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],         \
     vtkDataArrayPrivate::AllValues, const unsigned char*, unsigned char);                          \
   extern template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],         \
-    vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);
+    vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);                       \
+  extern template VTKCOMMONCORE_EXPORT bool DoExtendScalarRange(                                   \
+    ArrayType*, ValueType*, vtkDataArrayPrivate::AllValues, vtkIdType, vtkIdType);                 \
+  extern template VTKCOMMONCORE_EXPORT bool DoExtendScalarRange(                                   \
+    ArrayType*, ValueType*, vtkDataArrayPrivate::FiniteValues, vtkIdType, vtkIdType);
 
 #ifdef VTK_USE_SCALED_SOA_ARRAYS
 
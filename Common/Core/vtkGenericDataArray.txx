@@ -318,6 +318,62 @@ void vtkGenericDataArray<DerivedT, ValueTypeT>::LookupTypedValue(ValueType value
   this->Lookup.LookupValue(value, ids);
 }
 
+//-----------------------------------------------------------------------------
+template <class DerivedT, class ValueTypeT>
+void vtkGenericDataArray<DerivedT, ValueTypeT>::LookupValues(vtkDataArray* values, vtkIdList* ids)
+{
+  ids->Reset();
+  if (!values)
+  {
+    return;
+  }
+  const vtkIdType numValues = values->GetNumberOfValues();
+  ids->SetNumberOfIds(numValues);
+
+  if (DerivedT* typedValues = vtkArrayDownCast<DerivedT>(values))
+  {
+    auto getValue = [typedValues](vtkIdType i, ValueType& value) {
+      value = typedValues->GetValue(i);
+      return true;
+    };
+    this->Lookup.LookupValues(numValues, getValue, ids->GetPointer(0));
+  }
+  else if (values->HasStandardMemoryLayout())
+  {
+    // Read the values in their own type, so that the 64 bit integers are
+    // compared exactly instead of being rounded through double.
+    switch (values->GetDataType())
+    {
+      vtkTemplateMacro(this->Lookup.LookupConvertedValues(
+        static_cast<const VTK_TT*>(values->GetVoidPointer(0)), numValues, ids->GetPointer(0)));
+      default:
+        std::fill(ids->GetPointer(0), ids->GetPointer(0) + numValues, -1);
+    }
+  }
+  else
+  {
+    // The variants hold the values in their own type too.
+    auto getValue = [values](vtkIdType i, ValueType& value) {
+      using Helper = vtkGenericDataArrayLookupHelper<SelfType>;
+      const vtkVariant variant = values->GetVariantValue(i);
+      if (!variant.IsValid())
+      {
+        return false;
+      }
+      if (variant.IsFloat() || variant.IsDouble())
+      {
+        return Helper::ConvertValue(variant.ToDouble(), value);
+      }
+      if (variant.IsUnsignedLong() || variant.IsUnsignedLongLong())
+      {
+        return Helper::ConvertValue(variant.ToTypeUInt64(), value);
+      }
+      return Helper::ConvertValue(variant.ToTypeInt64(), value);
+    };
+    this->Lookup.LookupValues(numValues, getValue, ids->GetPointer(0));
+  }
+}
+
 //-----------------------------------------------------------------------------
 template <class DerivedT, class ValueTypeT>
 void vtkGenericDataArray<DerivedT, ValueTypeT>::ClearLookup()
@@ -330,6 +386,7 @@ template <class DerivedT, class ValueTypeT>
 void vtkGenericDataArray<DerivedT, ValueTypeT>::DataChanged()
 {
   this->Lookup.ClearLookup();
+  this->ClearIncrementalRanges();
 }
 
 //-----------------------------------------------------------------------------
@@ -17,16 +17,22 @@
  * @brief   internal class used by
  * vtkGenericDataArray to support LookupValue.
  *
+ * The index is built on the first lookup: the (value, index) pairs of the
+ * array are gathered and sorted in parallel, and an optional hash table maps
+ * each distinct value to its range of sorted pairs.
  */
 
 #ifndef vtkGenericDataArrayLookupHelper_h
 #define vtkGenericDataArrayLookupHelper_h
 
+#include "vtkCommonCoreModule.h" // For export macro
 #include "vtkIdList.h"
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace detail
@@ -54,6 +60,77 @@ bool isnan(T x)
 }
 } // namespace detail
 
+// The parallel parts of the index are compiled in vtkGenericDataArray.cxx so
+// that this header does not depend on vtkSMPTools.
+namespace vtkGenericDataArrayLookupHelper_detail
+{
+template <typename ValueType>
+struct IndexEntry
+{
+  ValueType Value;
+  vtkIdType Index;
+};
+
+// NaN values are sorted last, then entries are sorted by value and index,
+// so the first entry of a range of equal values is the first occurrence.
+template <typename ValueType>
+bool EntryLess(const IndexEntry<ValueType>& a, const IndexEntry<ValueType>& b)
+{
+  const bool aIsNaN = ::detail::isnan(a.Value);
+  const bool bIsNaN = ::detail::isnan(b.Value);
+  if (aIsNaN != bIsNaN)
+  {
+    return bIsNaN;
+  }
+  if (!aIsNaN && a.Value != b.Value)
+  {
+    return a.Value < b.Value;
+  }
+  return a.Index < b.Index;
+}
+
+// Call execute(functor, begin, end) concurrently on ranges of [0, size).
+using RangeFunctorType = void (*)(void* functor, vtkIdType begin, vtkIdType end);
+VTKCOMMONCORE_EXPORT void For(vtkIdType size, RangeFunctorType execute, void* functor);
+
+template <typename Functor>
+void ExecuteRange(void* functor, vtkIdType begin, vtkIdType end)
+{
+  (*static_cast<Functor*>(functor))(begin, end);
+}
+
+template <typename Functor>
+void For(vtkIdType size, Functor& functor)
+{
+  For(size, ExecuteRange<Functor>, &functor);
+}
+
+// Sort the entries in parallel, with EntryLess, for the value types of VTK.
+#define VTK_DECLARE_LOOKUP_SORT(ValueType)                                                         \
+  VTKCOMMONCORE_EXPORT void Sort(IndexEntry<ValueType>* begin, IndexEntry<ValueType>* end);
+VTK_DECLARE_LOOKUP_SORT(char)
+VTK_DECLARE_LOOKUP_SORT(signed char)
+VTK_DECLARE_LOOKUP_SORT(unsigned char)
+VTK_DECLARE_LOOKUP_SORT(short)
+VTK_DECLARE_LOOKUP_SORT(unsigned short)
+VTK_DECLARE_LOOKUP_SORT(int)
+VTK_DECLARE_LOOKUP_SORT(unsigned int)
+VTK_DECLARE_LOOKUP_SORT(long)
+VTK_DECLARE_LOOKUP_SORT(unsigned long)
+VTK_DECLARE_LOOKUP_SORT(long long)
+VTK_DECLARE_LOOKUP_SORT(unsigned long long)
+VTK_DECLARE_LOOKUP_SORT(float)
+VTK_DECLARE_LOOKUP_SORT(double)
+#undef VTK_DECLARE_LOOKUP_SORT
+
+// Other value types are sorted serially.
+template <typename ValueType>
+void Sort(IndexEntry<ValueType>* begin, IndexEntry<ValueType>* end)
+{
+  std::sort(begin, end, EntryLess<ValueType>);
+}
+} // namespace vtkGenericDataArrayLookupHelper_detail
+
 template <class ArrayTypeT>
 class vtkGenericDataArrayLookupHelper
 {
@@ -74,40 +151,112 @@ public:
     }
   }
 
-  vtkIdType LookupValue(ValueType elem)
+  ///@{
+  /**
+   * By default, values are looked up with a binary search in the sorted
+   * values of the array. When the array holds few distinct values (material
+   * ids, categories...), a hash table from each distinct value to its indices
+   * can be built on top of it to make each lookup constant time.
+   */
+  void SetUseHashTable(bool useHashTable)
   {
-    this->UpdateLookup();
-    auto indices = FindIndexVec(elem);
-    if (indices == nullptr)
+    if (this->UseHashTable != useHashTable)
     {
-      return -1;
+      this->ClearLookup();
+      this->UseHashTable = useHashTable;
     }
-    return indices->front();
+  }
+  bool GetUseHashTable() const { return this->UseHashTable; }
+  ///@}
+
+  vtkIdType LookupValue(ValueType elem)
+  {
+    this->UpdateLookup();
+    return this->FindFirstIndex(elem);
   }
 
   void LookupValue(ValueType elem, vtkIdList* ids)
   {
     ids->Reset();
     this->UpdateLookup();
-    auto indices = FindIndexVec(elem);
-    if (indices)
+    const auto range = this->FindIndexRange(elem);
+    ids->SetNumberOfIds(static_cast<vtkIdType>(range.second - range.first));
+    vtkIdType* idPtr = ids->GetPointer(0);
+    for (auto it = range.first; it != range.second; ++it)
     {
-      ids->Allocate(static_cast<vtkIdType>(indices->size()));
-      for (auto index : *indices)
-      {
-        ids->InsertNextId(index);
-      }
+      *idPtr++ = it->Index;
     }
   }
 
+  /**
+   * Set ids[i] to the index of the first occurrence of the value given by
+   * `bool getValue(vtkIdType i, ValueType& value)` for each i in
+   * [0, numValues), or to -1 if getValue() returns false or if the value is
+   * not found. The values are looked up in parallel.
+   */
+  template <typename ValueFunctor>
+  void LookupValues(vtkIdType numValues, ValueFunctor& getValue, vtkIdType* ids)
+  {
+    this->UpdateLookup();
+    LookupValuesFunctor<ValueFunctor> lookup{ this, getValue, ids };
+    vtkGenericDataArrayLookupHelper_detail::For(numValues, lookup);
+  }
+
+  /**
+   * Look up the numValues values of a contiguous buffer of another type, as
+   * LookupValues() does. The values are converted with ConvertValue().
+   */
+  template <typename T>
+  void LookupConvertedValues(const T* values, vtkIdType numValues, vtkIdType* ids)
+  {
+    auto getValue = [values](vtkIdType i, ValueType& value) {
+      return ConvertValue(values[i], value);
+    };
+    this->LookupValues(numValues, getValue, ids);
+  }
+
+  ///@{
+  /**
+   * Convert a value queried from an array of another type, returns false if
+   * it cannot be represented exactly as a ValueType. Integers are converted
+   * directly, so that the 64 bit integers are not rounded through double.
+   */
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value, bool>::type ConvertValue(
+    T value, ValueType& result)
+  {
+    return ConvertInteger(value, result, std::is_floating_point<ValueType>{});
+  }
+  static bool ConvertValue(double value, ValueType& result)
+  {
+    if (::detail::isnan(value))
+    {
+      result = std::numeric_limits<ValueType>::quiet_NaN();
+      return std::numeric_limits<ValueType>::has_quiet_NaN;
+    }
+    const double lowest = static_cast<double>(std::numeric_limits<ValueType>::lowest());
+    const double highest = static_cast<double>(std::numeric_limits<ValueType>::max());
+    // The maximum of 64 bit integers is rounded up when converted to double.
+    const bool highestIsExact =
+      !std::numeric_limits<ValueType>::is_integer || sizeof(ValueType) < 8;
+    if (value < lowest || value > highest || (!highestIsExact && value == highest))
+    {
+      return false;
+    }
+    result = static_cast<ValueType>(value);
+    return static_cast<double>(result) == value;
+  }
+  ///@}
+
   ///@{
   /**
    * Release any allocated memory for internal data-structures.
    */
   void ClearLookup()
   {
+    std::vector<IndexEntry>().swap(this->Index);
+    this->NumberOfNonNaNEntries = 0;
     this->ValueMap.clear();
-    this->NanIndices.clear();
   }
   ///@}
 
@@ -115,47 +264,132 @@ private:
   vtkGenericDataArrayLookupHelper(const vtkGenericDataArrayLookupHelper&) = delete;
   void operator=(const vtkGenericDataArrayLookupHelper&) = delete;
 
+  // An integer converts exactly to a floating point value if it is below
+  // 2^digits, which is exactly representable and where the cast back is
+  // defined, and survives the round trip.
+  template <typename T>
+  static bool ConvertInteger(T value, ValueType& result, std::true_type)
+  {
+    result = static_cast<ValueType>(value);
+    const ValueType bound = std::ldexp(ValueType(1), std::numeric_limits<T>::digits);
+    return result < bound && static_cast<T>(result) == value;
+  }
+
+  // An integer converts exactly to another integer type if it survives the
+  // round trip with its sign.
+  template <typename T>
+  static bool ConvertInteger(T value, ValueType& result, std::false_type)
+  {
+    result = static_cast<ValueType>(value);
+    return static_cast<T>(result) == value &&
+      IsNegative(value, std::is_signed<T>{}) == IsNegative(result, std::is_signed<ValueType>{});
+  }
+
+  template <typename T>
+  static bool IsNegative(T value, std::true_type) { return value < 0; }
+  template <typename T>
+  static bool IsNegative(T, std::false_type) { return false; }
+
+  using IndexEntry = vtkGenericDataArrayLookupHelper_detail::IndexEntry<ValueType>;
+  using EntryIterator = typename std::vector<IndexEntry>::const_iterator;
+  using EntryRange = std::pair<EntryIterator, EntryIterator>;
+
+  struct FillIndexFunctor
+  {
+    ArrayTypeT* Array;
+    IndexEntry* Index;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        this->Index[i].Value = this->Array->GetValue(i);
+        this->Index[i].Index = i;
+      }
+    }
+  };
+
+  template <typename ValueFunctor>
+  struct LookupValuesFunctor
+  {
+    const vtkGenericDataArrayLookupHelper* Self;
+    ValueFunctor& GetValue;
+    vtkIdType* Ids;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        ValueType value;
+        this->Ids[i] = this->GetValue(i, value) ? this->Self->FindFirstIndex(value) : -1;
+      }
+    }
+  };
+
   void UpdateLookup()
   {
     if (!this->AssociatedArray || (this->AssociatedArray->GetNumberOfTuples() < 1) ||
-      (!this->ValueMap.empty() || !this->NanIndices.empty()))
+      !this->Index.empty())
     {
       return;
     }
 
-    vtkIdType num = this->AssociatedArray->GetNumberOfValues();
-    this->ValueMap.reserve(num);
-    for (vtkIdType i = 0; i < num; ++i)
+    const vtkIdType num = this->AssociatedArray->GetNumberOfValues();
+    this->Index.resize(static_cast<std::size_t>(num));
+    FillIndexFunctor fill{ this->AssociatedArray, this->Index.data() };
+    vtkGenericDataArrayLookupHelper_detail::For(num, fill);
+    vtkGenericDataArrayLookupHelper_detail::Sort(
+      this->Index.data(), this->Index.data() + this->Index.size());
+
+    const auto nanBegin = std::partition_point(this->Index.begin(), this->Index.end(),
+      [](const IndexEntry& entry) { return !::detail::isnan(entry.Value); });
+    this->NumberOfNonNaNEntries = static_cast<vtkIdType>(nanBegin - this->Index.begin());
+
+    if (this->UseHashTable)
     {
-      auto value = this->AssociatedArray->GetValue(i);
-      if (::detail::isnan(value))
+      vtkIdType runBegin = 0;
+      for (vtkIdType i = 1; i <= this->NumberOfNonNaNEntries; ++i)
       {
-        NanIndices.push_back(i);
+        if (i == this->NumberOfNonNaNEntries || this->Index[i].Value != this->Index[runBegin].Value)
+        {
+          this->ValueMap.emplace(this->Index[runBegin].Value, std::make_pair(runBegin, i));
+          runBegin = i;
+        }
       }
-      this->ValueMap[value].push_back(i);
     }
   }
 
-  // Return a pointer to the relevant vector of indices if specified value was
-  // found in the array.
-  std::vector<vtkIdType>* FindIndexVec(ValueType value)
+  // Return the range of the entries holding the specified value.
+  EntryRange FindIndexRange(ValueType value) const
   {
-    std::vector<vtkIdType>* indices{ nullptr };
-    if (::detail::isnan(value) && !this->NanIndices.empty())
+    const EntryIterator begin = this->Index.cbegin();
+    const EntryIterator nanBegin = begin + this->NumberOfNonNaNEntries;
+    if (::detail::isnan(value))
     {
-      indices = &this->NanIndices;
+      return EntryRange(nanBegin, this->Index.cend());
     }
-    const auto& pos = this->ValueMap.find(value);
-    if (pos != this->ValueMap.end())
+    if (this->UseHashTable)
     {
-      indices = &pos->second;
+      const auto pos = this->ValueMap.find(value);
+      return pos == this->ValueMap.end()
+        ? EntryRange(nanBegin, nanBegin)
+        : EntryRange(begin + pos->second.first, begin + pos->second.second);
     }
-    return indices;
+    return std::equal_range(begin, nanBegin, IndexEntry{ value, 0 },
+      [](const IndexEntry& a, const IndexEntry& b) { return a.Value < b.Value; });
+  }
+
+  vtkIdType FindFirstIndex(ValueType value) const
+  {
+    const auto range = this->FindIndexRange(value);
+    return range.first == range.second ? -1 : range.first->Index;
   }
 
   ArrayTypeT* AssociatedArray{ nullptr };
-  std::unordered_map<ValueType, std::vector<vtkIdType>> ValueMap;
-  std::vector<vtkIdType> NanIndices;
+  bool UseHashTable{ false };
+  std::vector<IndexEntry> Index;
+  vtkIdType NumberOfNonNaNEntries{ 0 };
+  std::unordered_map<ValueType, std::pair<vtkIdType, vtkIdType>> ValueMap;
 };
 
 #endif
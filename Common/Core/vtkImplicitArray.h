@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImplicitArray
+ * @brief   read-only array whose values are computed by a functor
+ *
+ * vtkImplicitArray is a vtkGenericDataArray whose values are not stored but
+ * computed on the fly by a backend: any copyable type with a const call
+ * operator returning the value at a given index (see
+ * vtkImplicitArrayTraits.h). The memory used by the array is the memory of
+ * its backend, and creating it has no fill cost.
+ *
+ * ```
+ * struct Squares
+ * {
+ *   double operator()(vtkIdType idx) const { return idx * idx; }
+ * };
+ * vtkNew<vtkImplicitArray<Squares>> squares;
+ * squares->SetNumberOfTuples(100);
+ * squares->GetValue(9); // 81
+ * ```
+ *
+ * The built-in backends are available through the vtkConstantArray,
+ * vtkAffineArray, vtkCompositeArray and vtkIndexedArray aliases, which can
+ * be added to the vtkArrayDispatch array list with the
+ * VTK_DISPATCH_{CONSTANT,AFFINE,COMPOSITE,INDEXED}_ARRAYS options.
+ *
+ * The array is read-only: setting values reports an error. NewInstance()
+ * returns an AOS array of the same value type, so that the pipeline can
+ * copy implicit arrays into modifiable ones. GetVoidPointer() materializes
+ * the values in a cache, which is released by Squeeze().
+ *
+ * @sa
+ * vtkGenericDataArray vtkConstantArray vtkAffineArray vtkCompositeArray
+ * vtkIndexedArray
+ */
+
+#ifndef vtkImplicitArray_h
+#define vtkImplicitArray_h
+
+#include "vtkAOSDataArrayTemplate.h" // For NewInstance and the cache
+#include "vtkGenericDataArray.h"
+#include "vtkImplicitArrayTraits.h" // For the backend traits
+#include "vtkSmartPointer.h"        // For vtkSmartPointer
+
+#include <memory>  // For std::shared_ptr
+#include <utility> // For std::forward
+
+template <class BackendT>
+class vtkImplicitArray
+  : public vtkGenericDataArray<vtkImplicitArray<BackendT>,
+      typename vtk::detail::implicit_array_traits<BackendT>::rtype>
+{
+  using Traits = vtk::detail::implicit_array_traits<BackendT>;
+  static_assert(Traits::can_read,
+    "The backend of vtkImplicitArray must have a const operator()(vtkIdType) returning a value.");
+
+public:
+  using SelfType = vtkImplicitArray<BackendT>;
+  using GenericDataArrayType = vtkGenericDataArray<SelfType, typename Traits::rtype>;
+  // NewInstance() returns the AOS array used to copy the values.
+  vtkAbstractTypeMacroWithNewInstanceType(SelfType, GenericDataArrayType,
+    vtkAOSDataArrayTemplate<typename Traits::rtype>, typeid(SelfType).name());
+  vtkAOSArrayNewInstanceMacro(SelfType);
+  using ValueType = typename GenericDataArrayType::ValueType;
+  using BackendType = BackendT;
+
+  static vtkImplicitArray* New();
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Value at index @a valueIdx, computed by the backend.
+   */
+  ValueType GetValue(vtkIdType valueIdx) const { return (*this->Backend)(valueIdx); }
+
+  /**
+   * Implicit arrays are read-only: report an error.
+   */
+  void SetValue(vtkIdType valueIdx, ValueType value);
+
+  /**
+   * Copy the tuple at @a tupleIdx into @a tuple.
+   */
+  void GetTypedTuple(vtkIdType tupleIdx, ValueType* tuple) const
+  {
+    const vtkIdType offset = tupleIdx * this->NumberOfComponents;
+    for (int comp = 0; comp < this->NumberOfComponents; ++comp)
+    {
+      tuple[comp] = this->GetValue(offset + comp);
+    }
+  }
+
+  /**
+   * Implicit arrays are read-only: report an error.
+   */
+  void SetTypedTuple(vtkIdType tupleIdx, const ValueType* tuple);
+
+  /**
+   * Component @a comp of the tuple at @a tupleIdx.
+   */
+  ValueType GetTypedComponent(vtkIdType tupleIdx, int comp) const
+  {
+    return this->GetValue(tupleIdx * this->NumberOfComponents + comp);
+  }
+
+  /**
+   * Implicit arrays are read-only: report an error.
+   */
+  void SetTypedComponent(vtkIdType tupleIdx, int comp, ValueType value);
+
+  ///@{
+  /**
+   * The backend computing the values. Backends are shared, and must not be
+   * modified once given to an array. New arrays use a default constructed
+   * backend when BackendT is default constructible, nullptr otherwise.
+   */
+  void SetBackend(std::shared_ptr<BackendT> backend);
+  std::shared_ptr<BackendT> GetBackend() const { return this->Backend; }
+  ///@}
+
+  /**
+   * Construct a new backend from @a params and use it.
+   */
+  template <typename... Params>
+  void ConstructBackend(Params&&... params)
+  {
+    this->SetBackend(std::make_shared<BackendT>(std::forward<Params>(params)...));
+  }
+
+  /**
+   * Materialize the values in a cache and return a pointer to it. The cache
+   * is read-only, and is kept until Squeeze() or a change of the array.
+   */
+  void* GetVoidPointer(vtkIdType valueIdx) override;
+
+  /**
+   * Release the cache of GetVoidPointer().
+   */
+  void Squeeze() override;
+
+  /**
+   * Release the cache of GetVoidPointer() and reset the size of the array.
+   * The backend is kept.
+   */
+  void Initialize() override;
+
+  /**
+   * Memory used by the backend, or 1 KiB if it does not report its memory,
+   * plus the memory of the cache of GetVoidPointer().
+   */
+  unsigned long GetActualMemorySize() const override;
+
+  ///@{
+  /**
+   * Copy @a other if it is an implicit array of the same type, sharing its
+   * backend. Other arrays cannot be copied into an implicit array.
+   */
+  void DeepCopy(vtkAbstractArray* other) override;
+  void DeepCopy(vtkDataArray* other) override;
+  void ShallowCopy(vtkDataArray* other) override;
+  ///@}
+
+  int GetArrayType() const override { return vtkAbstractArray::ImplicitArray; }
+
+  /**
+   * Perform a fast, safe cast from a vtkAbstractArray to a vtkImplicitArray.
+   */
+  static vtkImplicitArray<BackendT>* FastDownCast(vtkAbstractArray* source)
+  {
+    if (source && source->GetArrayType() == vtkAbstractArray::ImplicitArray)
+    {
+      return dynamic_cast<vtkImplicitArray<BackendT>*>(source);
+    }
+    return nullptr;
+  }
+
+protected:
+  vtkImplicitArray();
+  ~vtkImplicitArray() override;
+
+  // Nothing to allocate: the size of the array is managed by the superclass.
+  bool AllocateTuples(vtkIdType) { return true; }
+  bool ReallocateTuples(vtkIdType) { return true; }
+
+  std::shared_ptr<BackendT> Backend;
+
+private:
+  vtkImplicitArray(const vtkImplicitArray&) = delete;
+  void operator=(const vtkImplicitArray&) = delete;
+
+  friend class vtkGenericDataArray<SelfType, ValueType>;
+
+  void ReportReadOnly();
+
+  vtkSmartPointer<vtkAOSDataArrayTemplate<ValueType>> Cache;
+};
+
+// Declare vtkArrayDownCast implementations for implicit containers:
+vtkArrayDownCast_TemplateFastCastMacro(vtkImplicitArray);
+
+#include "vtkImplicitArray.txx"
+
+#endif
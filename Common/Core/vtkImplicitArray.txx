@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef vtkImplicitArray_txx
+#define vtkImplicitArray_txx
+
+#include "vtkImplicitArray.h"
+
+#include "vtkLookupTable.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include <type_traits> // For std::integral_constant
+
+namespace vtkImplicitArrayDetail
+{
+template <typename BackendT>
+std::shared_ptr<BackendT> MakeDefaultBackend(std::true_type)
+{
+  return std::make_shared<BackendT>();
+}
+
+template <typename BackendT>
+std::shared_ptr<BackendT> MakeDefaultBackend(std::false_type)
+{
+  return nullptr;
+}
+
+template <typename BackendT>
+unsigned long GetBackendMemorySize(const BackendT& backend, std::true_type)
+{
+  return backend.getMemorySize();
+}
+
+template <typename BackendT>
+unsigned long GetBackendMemorySize(const BackendT&, std::false_type)
+{
+  return 1;
+}
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>* vtkImplicitArray<BackendT>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkImplicitArray<BackendT>);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::vtkImplicitArray()
+  : Backend(vtkImplicitArrayDetail::MakeDefaultBackend<BackendT>(
+      std::integral_constant<bool, Traits::default_constructible>{}))
+{
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::~vtkImplicitArray() = default;
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Backend: " << this->Backend.get() << "\n";
+  os << indent << "Cache: " << this->Cache.Get() << "\n";
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::ReportReadOnly()
+{
+  vtkErrorMacro("Read only container.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetValue(vtkIdType, ValueType)
+{
+  this->ReportReadOnly();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedTuple(vtkIdType, const ValueType*)
+{
+  this->ReportReadOnly();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedComponent(vtkIdType, int, ValueType)
+{
+  this->ReportReadOnly();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetBackend(std::shared_ptr<BackendT> backend)
+{
+  if (this->Backend != backend)
+  {
+    this->Backend = backend;
+    this->Cache = nullptr;
+    this->DataChanged();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void* vtkImplicitArray<BackendT>::GetVoidPointer(vtkIdType valueIdx)
+{
+  if (!this->Backend)
+  {
+    vtkErrorMacro("No backend to compute the values.");
+    return nullptr;
+  }
+  if (!this->Cache || this->Cache->GetMTime() < this->GetMTime() ||
+    this->Cache->GetNumberOfValues() != this->GetNumberOfValues())
+  {
+    this->Cache = vtkSmartPointer<vtkAOSDataArrayTemplate<ValueType>>::New();
+    this->Cache->SetNumberOfValues(this->GetNumberOfValues());
+    ValueType* values = this->Cache->GetPointer(0);
+    const BackendT& backend = *this->Backend;
+    vtkSMPTools::For(
+      0, this->GetNumberOfValues(), [values, &backend](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType idx = begin; idx < end; ++idx)
+        {
+          values[idx] = backend(idx);
+        }
+      });
+  }
+  return this->Cache->GetVoidPointer(valueIdx);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::Squeeze()
+{
+  this->Superclass::Squeeze();
+  this->Cache = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::Initialize()
+{
+  this->Superclass::Initialize();
+  this->Cache = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+unsigned long vtkImplicitArray<BackendT>::GetActualMemorySize() const
+{
+  unsigned long size = 1;
+  if (this->Backend)
+  {
+    size = vtkImplicitArrayDetail::GetBackendMemorySize(
+      *this->Backend, std::integral_constant<bool, Traits::has_memory_size>{});
+  }
+  if (this->Cache)
+  {
+    size += this->Cache->GetActualMemorySize();
+  }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::DeepCopy(vtkAbstractArray* other)
+{
+  if (!other)
+  {
+    return;
+  }
+  vtkDataArray* array = vtkDataArray::FastDownCast(other);
+  if (!array)
+  {
+    vtkErrorMacro("Cannot copy a " << other->GetClassName() << " into an implicit array.");
+    return;
+  }
+  this->DeepCopy(array);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::DeepCopy(vtkDataArray* other)
+{
+  if (!other || other == this)
+  {
+    return;
+  }
+  SelfType* source = SelfType::FastDownCast(other);
+  if (!source)
+  {
+    vtkErrorMacro("Cannot copy a " << other->GetClassName()
+                                   << " into an implicit array of a different type.");
+    return;
+  }
+
+  // Backends are immutable, the copy shares the one of the source.
+  this->vtkAbstractArray::DeepCopy(source);
+  this->SetNumberOfComponents(source->GetNumberOfComponents());
+  this->SetNumberOfTuples(source->GetNumberOfTuples());
+  this->Backend = source->Backend;
+  this->Cache = nullptr;
+
+  this->SetLookupTable(nullptr);
+  if (source->LookupTable)
+  {
+    this->LookupTable = source->LookupTable->NewInstance();
+    this->LookupTable->DeepCopy(source->LookupTable);
+  }
+  this->DataChanged();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::ShallowCopy(vtkDataArray* other)
+{
+  this->DeepCopy(other);
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArrayTraits.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkImplicitArrayTraits.h
+ * Compile time inspection of the backends of vtkImplicitArray.
+ *
+ * A backend is any copyable type with a const call operator taking the index
+ * of a value and returning this value:
+ *
+ * ```
+ * struct Backend
+ * {
+ *   double operator()(vtkIdType idx) const;
+ * };
+ * ```
+ *
+ * The value type of the implicit array is the decayed return type of this
+ * operator. Backends can optionally provide `unsigned long getMemorySize()
+ * const`, returning the memory they use in KiB, which is reported by
+ * vtkImplicitArray::GetActualMemorySize().
+ */
+
+#ifndef vtkImplicitArrayTraits_h
+#define vtkImplicitArrayTraits_h
+
+#include "vtkType.h"
+
+#include <type_traits> // For std::false_type
+#include <utility>     // For std::declval
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+
+template <typename BackendT, typename = void>
+struct implicit_array_has_map : std::false_type
+{
+  using rtype = void;
+};
+
+template <typename BackendT>
+struct implicit_array_has_map<BackendT,
+  decltype((void)std::declval<const BackendT&>()(std::declval<vtkIdType>()))> : std::true_type
+{
+  using rtype = typename std::decay<decltype(
+    std::declval<const BackendT&>()(std::declval<vtkIdType>()))>::type;
+};
+
+template <typename BackendT, typename = void>
+struct implicit_array_has_memory_size : std::false_type
+{
+};
+
+template <typename BackendT>
+struct implicit_array_has_memory_size<BackendT,
+  decltype((void)std::declval<const BackendT&>().getMemorySize())> : std::true_type
+{
+};
+
+template <typename BackendT>
+struct implicit_array_traits
+{
+  using rtype = typename implicit_array_has_map<BackendT>::rtype;
+  static constexpr bool can_read = implicit_array_has_map<BackendT>::value;
+  static constexpr bool has_memory_size = implicit_array_has_memory_size<BackendT>::value;
+  static constexpr bool default_constructible = std::is_default_constructible<BackendT>::value;
+};
+
+} // namespace detail
+} // namespace vtk
+#endif // __VTK_WRAP__
+
+#endif
@@ -0,0 +1,39 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkIndexedArray.h
+ * vtkIndexedArray is a vtkImplicitArray using a vtkIndexedImplicitBackend:
+ * its tuple i is the tuple indexes[i] of a base array.
+ *
+ * ```
+ * vtkNew<vtkIndexedArray<double>> extracted;
+ * extracted->ConstructBackend(tupleIds, baseArray);
+ * extracted->SetNumberOfComponents(baseArray->GetNumberOfComponents());
+ * extracted->SetNumberOfTuples(tupleIds->GetNumberOfIds());
+ * ```
+ *
+ * Add it to the vtkArrayDispatch array list with VTK_DISPATCH_INDEXED_ARRAYS.
+ */
+
+#ifndef vtkIndexedArray_h
+#define vtkIndexedArray_h
+
+#include "vtkImplicitArray.h"
+#include "vtkIndexedImplicitBackend.h" // For the backend
+
+template <typename ValueType>
+using vtkIndexedArray = vtkImplicitArray<vtkIndexedImplicitBackend<ValueType>>;
+
+#endif
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedImplicitBackend.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/**
+ * @class   vtkIndexedImplicitBackend
+ * @brief   backend of vtkIndexedArray: indirection into another array
+ *
+ * A backend for vtkImplicitArray whose tuple i is the tuple Indexes[i] of
+ * another array, e.g. to extract or reorder tuples without copying them.
+ * The indexed array must have the number of components of the base array.
+ * The indexes and the base array must not be modified while they are used.
+ *
+ * @sa
+ * vtkImplicitArray vtkIndexedArray
+ */
+
+#ifndef vtkIndexedImplicitBackend_h
+#define vtkIndexedImplicitBackend_h
+
+#include "vtkAOSDataArrayTemplate.h" // For the fast path
+#include "vtkDataArray.h"
+#include "vtkIdList.h"       // For vtkIdList
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+template <typename ValueType>
+class vtkIndexedImplicitBackend
+{
+public:
+  vtkIndexedImplicitBackend() = default;
+
+  ///@{
+  /**
+   * Tuple i of the array is the tuple @a indexes[i] of @a array. Both are
+   * kept alive by the backend. Indexes stored in a vtkDataArray other than a
+   * vtkIdTypeArray are converted to a vtkIdList.
+   */
+  vtkIndexedImplicitBackend(vtkIdList* indexes, vtkDataArray* array);
+  vtkIndexedImplicitBackend(vtkDataArray* indexes, vtkDataArray* array);
+  ///@}
+
+  ValueType operator()(vtkIdType idx) const;
+
+  unsigned long getMemorySize() const;
+
+  /**
+   * Number of tuples of the indexed array.
+   */
+  vtkIdType GetNumberOfTuples() const { return this->NumberOfIndexes; }
+
+private:
+  void SetBaseArray(vtkDataArray* array);
+
+  vtkSmartPointer<vtkObject> IndexesOwner;
+  const vtkIdType* Indexes = nullptr;
+  vtkIdType NumberOfIndexes = 0;
+  bool OwnsIndexes = false;
+
+  vtkSmartPointer<vtkDataArray> Array;
+  vtkAOSDataArrayTemplate<ValueType>* TypedArray = nullptr;
+  int NumberOfComponents = 1;
+};
+
+#include "vtkIndexedImplicitBackend.txx"
+
+#endif
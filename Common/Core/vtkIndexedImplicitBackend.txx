@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedImplicitBackend.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+
+#ifndef vtkIndexedImplicitBackend_txx
+#define vtkIndexedImplicitBackend_txx
+
+#include "vtkIndexedImplicitBackend.h"
+
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+vtkIndexedImplicitBackend<ValueType>::vtkIndexedImplicitBackend(
+  vtkIdList* indexes, vtkDataArray* array)
+{
+  if (indexes)
+  {
+    this->IndexesOwner = indexes;
+    this->Indexes = indexes->GetPointer(0);
+    this->NumberOfIndexes = indexes->GetNumberOfIds();
+  }
+  this->SetBaseArray(array);
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+vtkIndexedImplicitBackend<ValueType>::vtkIndexedImplicitBackend(
+  vtkDataArray* indexes, vtkDataArray* array)
+{
+  if (vtkIdTypeArray* ids = vtkArrayDownCast<vtkIdTypeArray>(indexes))
+  {
+    this->IndexesOwner = ids;
+    this->Indexes = ids->GetPointer(0);
+    this->NumberOfIndexes = ids->GetNumberOfValues();
+  }
+  else if (indexes)
+  {
+    vtkNew<vtkIdList> ids;
+    ids->SetNumberOfIds(indexes->GetNumberOfValues());
+    for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+    {
+      ids->SetId(i, static_cast<vtkIdType>(indexes->GetComponent(i, 0)));
+    }
+    this->IndexesOwner = ids;
+    this->Indexes = ids->GetPointer(0);
+    this->NumberOfIndexes = ids->GetNumberOfIds();
+    this->OwnsIndexes = true;
+  }
+  this->SetBaseArray(array);
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+void vtkIndexedImplicitBackend<ValueType>::SetBaseArray(vtkDataArray* array)
+{
+  this->Array = array;
+  this->TypedArray = vtkArrayDownCast<vtkAOSDataArrayTemplate<ValueType>>(array);
+  this->NumberOfComponents = array ? array->GetNumberOfComponents() : 1;
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+ValueType vtkIndexedImplicitBackend<ValueType>::operator()(vtkIdType idx) const
+{
+  const vtkIdType tupleIdx = idx / this->NumberOfComponents;
+  const int comp = static_cast<int>(idx - tupleIdx * this->NumberOfComponents);
+  const vtkIdType sourceIdx = this->Indexes[tupleIdx];
+  if (this->TypedArray)
+  {
+    return this->TypedArray->GetTypedComponent(sourceIdx, comp);
+  }
+  return static_cast<ValueType>(this->Array->GetComponent(sourceIdx, comp));
+}
+
+//-----------------------------------------------------------------------------
+template <typename ValueType>
+unsigned long vtkIndexedImplicitBackend<ValueType>::getMemorySize() const
+{
+  // Only the indexes converted by this backend are accounted here, the
+  // other ones and the base array are shared with their other users.
+  const std::size_t bytes = this->OwnsIndexes ? this->NumberOfIndexes * sizeof(vtkIdType) : 0;
+  return static_cast<unsigned long>(bytes / 1024 + 1);
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMallocMemoryResource.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMallocMemoryResource.h"
+
+#include "vtkObjectFactory.h"
+
+#include <cstdlib> // For malloc, realloc, free
+
+vtkStandardNewMacro(vtkMallocMemoryResource);
+
+//------------------------------------------------------------------------------
+void* vtkMallocMemoryResource::DoAllocate(std::size_t bytes)
+{
+  return malloc(bytes);
+}
+
+//------------------------------------------------------------------------------
+void vtkMallocMemoryResource::DoDeallocate(void* pointer, std::size_t)
+{
+  free(pointer);
+}
+
+//------------------------------------------------------------------------------
+void* vtkMallocMemoryResource::DoReallocate(void* pointer, std::size_t, std::size_t newBytes)
+{
+  return realloc(pointer, newBytes);
+}
+
+//------------------------------------------------------------------------------
+void vtkMallocMemoryResource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
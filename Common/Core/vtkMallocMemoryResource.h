@@ -0,0 +1,53 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMallocMemoryResource.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMallocMemoryResource
+ * @brief   memory resource using malloc, realloc and free
+ *
+ * vtkMallocMemoryResource allocates memory like data arrays do when no
+ * resource is set, while counting the bytes in use and the high-water mark.
+ * It is also the default upstream resource of vtkPoolMemoryResource.
+ *
+ * @sa
+ * vtkMemoryResource vtkPoolMemoryResource
+ */
+
+#ifndef vtkMallocMemoryResource_h
+#define vtkMallocMemoryResource_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkMemoryResource.h"
+
+class VTKCOMMONCORE_EXPORT vtkMallocMemoryResource : public vtkMemoryResource
+{
+public:
+  static vtkMallocMemoryResource* New();
+  vtkTypeMacro(vtkMallocMemoryResource, vtkMemoryResource);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+protected:
+  vtkMallocMemoryResource() = default;
+  ~vtkMallocMemoryResource() override = default;
+
+  void* DoAllocate(std::size_t bytes) override;
+  void DoDeallocate(void* pointer, std::size_t bytes) override;
+  void* DoReallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes) override;
+
+private:
+  vtkMallocMemoryResource(const vtkMallocMemoryResource&) = delete;
+  void operator=(const vtkMallocMemoryResource&) = delete;
+};
+
+#endif
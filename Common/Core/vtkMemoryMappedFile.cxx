@@ -0,0 +1,234 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryMappedFile.h"
+
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include "vtksys/Encoding.hxx"
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Owns the mapped memory, which is released when the last array using it and
+// the vtkMemoryMappedFile release their reference.
+class vtkMemoryMappedFileMapping : public vtkObject
+{
+public:
+  static vtkMemoryMappedFileMapping* New();
+  vtkTypeMacro(vtkMemoryMappedFileMapping, vtkObject);
+
+  void* Data = nullptr;
+  vtkTypeUInt64 Length = 0;
+#ifdef _WIN32
+  HANDLE Handle = nullptr;
+#endif
+
+protected:
+  vtkMemoryMappedFileMapping() = default;
+  ~vtkMemoryMappedFileMapping() override
+  {
+    if (this->Data)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(this->Data);
+      CloseHandle(this->Handle);
+#else
+      munmap(this->Data, static_cast<size_t>(this->Length));
+#endif
+    }
+  }
+
+private:
+  vtkMemoryMappedFileMapping(const vtkMemoryMappedFileMapping&) = delete;
+  void operator=(const vtkMemoryMappedFileMapping&) = delete;
+};
+vtkStandardNewMacro(vtkMemoryMappedFileMapping);
+}
+
+vtkStandardNewMacro(vtkMemoryMappedFile);
+
+//------------------------------------------------------------------------------
+vtkMemoryMappedFile::vtkMemoryMappedFile() = default;
+
+//------------------------------------------------------------------------------
+vtkMemoryMappedFile::~vtkMemoryMappedFile()
+{
+  delete[] this->FileName;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryMappedFile::SetFileName(const char* fileName)
+{
+  if (this->FileName && fileName && strcmp(this->FileName, fileName) == 0)
+  {
+    return;
+  }
+  if (!this->FileName && !fileName)
+  {
+    return;
+  }
+  this->Unmap();
+  delete[] this->FileName;
+  this->FileName = nullptr;
+  if (fileName)
+  {
+    this->FileName = new char[strlen(fileName) + 1];
+    strcpy(this->FileName, fileName);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryMappedFile::SetMappingMode(int mode)
+{
+  mode = mode == ReadOnly ? ReadOnly : CopyOnWrite;
+  if (this->MappingMode != mode)
+  {
+    this->Unmap();
+    this->MappingMode = mode;
+    this->Modified();
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkMemoryMappedFile::Map()
+{
+  if (this->Mapping)
+  {
+    return true;
+  }
+  if (!this->FileName || !*this->FileName)
+  {
+    vtkErrorMacro("No file name specified.");
+    return false;
+  }
+
+  vtkNew<vtkMemoryMappedFileMapping> mapping;
+#ifdef _WIN32
+  HANDLE file = CreateFileW(vtksys::Encoding::ToWindowsExtendedPath(this->FileName).c_str(),
+    GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    vtkErrorMacro("Cannot open " << this->FileName);
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    vtkErrorMacro("Cannot get the size of " << this->FileName);
+    CloseHandle(file);
+    return false;
+  }
+  if (size.QuadPart > 0)
+  {
+    // A copy-on-write mapping also allows read-only views.
+    mapping->Handle = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping->Handle)
+    {
+      mapping->Data = MapViewOfFile(
+        mapping->Handle, this->MappingMode == ReadOnly ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+      if (!mapping->Data)
+      {
+        CloseHandle(mapping->Handle);
+      }
+    }
+    if (!mapping->Data)
+    {
+      vtkErrorMacro("Cannot map " << this->FileName);
+      CloseHandle(file);
+      return false;
+    }
+    mapping->Length = static_cast<vtkTypeUInt64>(size.QuadPart);
+  }
+  // The mapping keeps the file open.
+  CloseHandle(file);
+#else
+  const int file = open(this->FileName, O_RDONLY);
+  if (file < 0)
+  {
+    vtkErrorMacro("Cannot open " << this->FileName << ": " << strerror(errno));
+    return false;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0)
+  {
+    vtkErrorMacro("Cannot get the size of " << this->FileName << ": " << strerror(errno));
+    close(file);
+    return false;
+  }
+  if (status.st_size > 0)
+  {
+    // A shared read-only mapping lets the processes share the page cache.
+    const int protection = this->MappingMode == ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    const int flags = this->MappingMode == ReadOnly ? MAP_SHARED : MAP_PRIVATE;
+    void* data = mmap(nullptr, static_cast<size_t>(status.st_size), protection, flags, file, 0);
+    if (data == MAP_FAILED)
+    {
+      vtkErrorMacro("Cannot map " << this->FileName << ": " << strerror(errno));
+      close(file);
+      return false;
+    }
+    mapping->Data = data;
+    mapping->Length = static_cast<vtkTypeUInt64>(status.st_size);
+  }
+  // The mapping keeps the file open.
+  close(file);
+#endif
+
+  this->Mapping = mapping;
+  this->Data = mapping->Data;
+  this->Length = mapping->Length;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryMappedFile::Unmap()
+{
+  this->Mapping = nullptr;
+  this->Data = nullptr;
+  this->Length = 0;
+}
+
+//------------------------------------------------------------------------------
+void* vtkMemoryMappedFile::GetBlock(vtkTypeUInt64 offset, vtkTypeUInt64 length) const
+{
+  if (!this->Data || offset > this->Length || length > this->Length - offset)
+  {
+    return nullptr;
+  }
+  return static_cast<char*>(this->Data) + offset;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryMappedFile::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "MappingMode: " << (this->MappingMode == ReadOnly ? "ReadOnly" : "CopyOnWrite")
+     << "\n";
+  os << indent << "Mapped: " << this->IsMapped() << "\n";
+  os << indent << "Length: " << this->Length << "\n";
+}
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMemoryMappedFile
+ * @brief   map a file in memory to back data arrays
+ *
+ * vtkMemoryMappedFile maps a whole file in the address space of the process.
+ * Blocks of the mapped file can then be used as the storage of data arrays
+ * with vtkAOSDataArrayTemplate::SetMappedArray(), without reading them:
+ * the operating system loads the pages on demand and shares them between
+ * the processes mapping the same file.
+ *
+ * The values must be stored in the native byte order and layout of the
+ * array (interleaved components). The arrays keep a reference to the mapping
+ * (see GetMapping()), so the file is only unmapped when neither this object
+ * nor any array use it.
+ *
+ * ```
+ * vtkNew<vtkMemoryMappedFile> file;
+ * file->SetFileName("points.raw");
+ * if (file->Map())
+ * {
+ *   vtkNew<vtkFloatArray> points;
+ *   points->SetNumberOfComponents(3);
+ *   points->SetMappedArray(file, headerSize, 3 * numberOfPoints);
+ * }
+ * ```
+ *
+ * @warning
+ * In ReadOnly mode, the pages are mapped without write permission: only
+ * GetData() and GetBlock() give access to them. Since data arrays can always
+ * be modified, SetMappedArray() requires a CopyOnWrite mapping, whose
+ * modified pages are private copies.
+ *
+ * @sa
+ * vtkAOSDataArrayTemplate vtkBuffer
+ */
+
+#ifndef vtkMemoryMappedFile_h
+#define vtkMemoryMappedFile_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+class VTKCOMMONCORE_EXPORT vtkMemoryMappedFile : public vtkObject
+{
+public:
+  static vtkMemoryMappedFile* New();
+  vtkTypeMacro(vtkMemoryMappedFile, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum MappingModes
+  {
+    // Pages are shared with other processes and cannot be modified. Data
+    // arrays cannot use them.
+    ReadOnly = 0,
+    // Pages are shared until they are modified, modifications are private to
+    // the process and are not written to the file.
+    CopyOnWrite = 1
+  };
+
+  ///@{
+  /**
+   * Name of the file to map. Changing it unmaps the current file.
+   */
+  virtual void SetFileName(VTK_FILEPATH const char* fileName);
+  vtkGetFilePathMacro(FileName);
+  ///@}
+
+  ///@{
+  /**
+   * How the file is mapped, CopyOnWrite by default. Changing it unmaps the
+   * current file.
+   */
+  virtual void SetMappingMode(int mode);
+  vtkGetMacro(MappingMode, int);
+  void SetMappingModeToReadOnly() { this->SetMappingMode(ReadOnly); }
+  void SetMappingModeToCopyOnWrite() { this->SetMappingMode(CopyOnWrite); }
+  ///@}
+
+  /**
+   * Map the file. Returns false on failure. Mapping an empty file succeeds
+   * but GetData() is then nullptr.
+   */
+  bool Map();
+
+  /**
+   * Release the mapping. The memory remains valid for the arrays still using
+   * it, and is unmapped when the last of them releases it.
+   */
+  void Unmap();
+
+  /**
+   * Return true if the file is mapped.
+   */
+  bool IsMapped() const { return this->Mapping != nullptr; }
+
+  /**
+   * Reference counted object owning the current mapping, nullptr if the file
+   * is not mapped. The memory returned by GetData() and GetBlock() remains
+   * valid as long as a reference to this object is held.
+   */
+  vtkObject* GetMapping() const { return this->Mapping; }
+
+  ///@{
+  /**
+   * Address and size in bytes of the mapped file.
+   */
+  void* GetData() const { return this->Data; }
+  vtkTypeUInt64 GetLength() const { return this->Length; }
+  ///@}
+
+  /**
+   * Return the address of the @a length bytes starting at @a offset in the
+   * mapped file, or nullptr if the file is not mapped or if the block is not
+   * entirely in the file.
+   */
+  void* GetBlock(vtkTypeUInt64 offset, vtkTypeUInt64 length) const;
+
+protected:
+  vtkMemoryMappedFile();
+  ~vtkMemoryMappedFile() override;
+
+  char* FileName = nullptr;
+  int MappingMode = CopyOnWrite;
+
+private:
+  vtkMemoryMappedFile(const vtkMemoryMappedFile&) = delete;
+  void operator=(const vtkMemoryMappedFile&) = delete;
+
+  vtkSmartPointer<vtkObject> Mapping;
+  void* Data = nullptr;
+  vtkTypeUInt64 Length = 0;
+};
+
+#endif
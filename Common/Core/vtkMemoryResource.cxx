@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryResource.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryResource.h"
+
+#include <algorithm> // For std::min
+#include <cstring>   // For std::memcpy
+
+namespace
+{
+// Resource of the innermost DefaultScope of each thread. The scope holds the
+// reference, so that reading it when an array is created is a plain load.
+thread_local vtkMemoryResource* DefaultResource = nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryResource::vtkMemoryResource()
+  : BytesInUse(0)
+  , HighWaterMark(0)
+  , NumberOfAllocations(0)
+  , NumberOfDeallocations(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryResource::~vtkMemoryResource() = default;
+
+//------------------------------------------------------------------------------
+void* vtkMemoryResource::Allocate(std::size_t bytes)
+{
+  if (bytes == 0)
+  {
+    return nullptr;
+  }
+  void* pointer = this->DoAllocate(bytes);
+  if (pointer)
+  {
+    ++this->NumberOfAllocations;
+    this->AddBytesInUse(bytes);
+  }
+  return pointer;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryResource::Deallocate(void* pointer, std::size_t bytes)
+{
+  if (!pointer)
+  {
+    return;
+  }
+  this->DoDeallocate(pointer, bytes);
+  ++this->NumberOfDeallocations;
+  this->BytesInUse -= bytes;
+}
+
+//------------------------------------------------------------------------------
+void* vtkMemoryResource::Reallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes)
+{
+  if (!pointer)
+  {
+    return this->Allocate(newBytes);
+  }
+  if (newBytes == 0)
+  {
+    this->Deallocate(pointer, oldBytes);
+    return nullptr;
+  }
+
+  void* newPointer = this->DoReallocate(pointer, oldBytes, newBytes);
+  if (newPointer)
+  {
+    if (newBytes > oldBytes)
+    {
+      this->AddBytesInUse(newBytes - oldBytes);
+    }
+    else
+    {
+      this->BytesInUse -= oldBytes - newBytes;
+    }
+  }
+  return newPointer;
+}
+
+//------------------------------------------------------------------------------
+void* vtkMemoryResource::DoReallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes)
+{
+  void* newPointer = this->DoAllocate(newBytes);
+  if (newPointer)
+  {
+    std::memcpy(newPointer, pointer, std::min(oldBytes, newBytes));
+    this->DoDeallocate(pointer, oldBytes);
+  }
+  return newPointer;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryResource::AddBytesInUse(vtkTypeUInt64 bytes)
+{
+  const vtkTypeUInt64 inUse = (this->BytesInUse += bytes);
+  vtkTypeUInt64 highWaterMark = this->HighWaterMark;
+  while (inUse > highWaterMark && !this->HighWaterMark.compare_exchange_weak(highWaterMark, inUse))
+  {
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMemoryResource> vtkMemoryResource::GetDefaultResource()
+{
+  return DefaultResource;
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryResource::DefaultScope::DefaultScope(vtkMemoryResource* resource)
+  : Resource(resource)
+  , Previous(DefaultResource)
+{
+  DefaultResource = resource;
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryResource::DefaultScope::~DefaultScope()
+{
+  DefaultResource = this->Previous;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryResource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BytesInUse: " << this->BytesInUse.load() << "\n";
+  os << indent << "HighWaterMark: " << this->HighWaterMark.load() << "\n";
+  os << indent << "NumberOfAllocations: " << this->NumberOfAllocations.load() << "\n";
+  os << indent << "NumberOfDeallocations: " << this->NumberOfDeallocations.load() << "\n";
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryResource.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMemoryResource
+ * @brief   abstract interface of the allocators used by data arrays
+ *
+ * vtkMemoryResource is the equivalent of std::pmr::memory_resource for the
+ * storage of data arrays (see vtkBuffer): subclasses implement DoAllocate(),
+ * DoDeallocate() and optionally DoReallocate(), while this class keeps track
+ * of the number of bytes currently allocated through the resource and of its
+ * high-water mark.
+ *
+ * A resource can be given to a single array with
+ * vtkAOSDataArrayTemplate::SetMemoryResource(), or used by every array
+ * created by a thread while a vtkMemoryResource::DefaultScope of this thread
+ * is alive, e.g. around the Update() of a pipeline:
+ *
+ * ```
+ * vtkNew<vtkPoolMemoryResource> pool;
+ * for (double time : timeSteps)
+ * {
+ *   vtkMemoryResource::DefaultScope scope(pool);
+ *   filter->UpdateTimeStep(time);
+ * }
+ * ```
+ *
+ * The scope only applies to the thread that created it, so that pipelines
+ * updated concurrently by different threads can use different resources.
+ * Arrays created by other threads, such as the threads of vtkSMPTools, do
+ * not use it unless these threads open a scope themselves.
+ *
+ * Arrays keep a reference to the resource that allocated their memory, so a
+ * resource lives at least as long as the arrays using it.
+ *
+ * All methods of this class are thread safe.
+ *
+ * @sa
+ * vtkMallocMemoryResource vtkPoolMemoryResource vtkBuffer
+ */
+
+#ifndef vtkMemoryResource_h
+#define vtkMemoryResource_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <atomic>  // For std::atomic
+#include <cstddef> // For std::size_t
+
+class VTKCOMMONCORE_EXPORT vtkMemoryResource : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMemoryResource, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Allocate @a bytes bytes. Returns nullptr if the allocation fails or if
+   * @a bytes is 0.
+   */
+  void* Allocate(std::size_t bytes);
+
+  /**
+   * Release memory obtained from this resource. @a bytes must be the size
+   * that was requested when the memory was allocated.
+   */
+  void Deallocate(void* pointer, std::size_t bytes);
+
+  /**
+   * Resize memory obtained from this resource, preserving its content up to
+   * the smallest of the two sizes. On failure, nullptr is returned and the
+   * original memory is left untouched.
+   */
+  void* Reallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes);
+
+  ///@{
+  /**
+   * Statistics of the memory handed out by this resource: the number of
+   * bytes currently allocated, the largest value it reached and the number of
+   * calls to Allocate() and Deallocate().
+   */
+  vtkTypeUInt64 GetBytesInUse() const { return this->BytesInUse; }
+  vtkTypeUInt64 GetHighWaterMark() const { return this->HighWaterMark; }
+  vtkTypeUInt64 GetNumberOfAllocations() const { return this->NumberOfAllocations; }
+  vtkTypeUInt64 GetNumberOfDeallocations() const { return this->NumberOfDeallocations; }
+  ///@}
+
+  /**
+   * Reset the high-water mark to the number of bytes currently in use.
+   */
+  void ResetHighWaterMark() { this->HighWaterMark = this->BytesInUse.load(); }
+
+  /**
+   * Resource used by the data arrays created by the calling thread without an
+   * explicit resource, i.e. the resource of its innermost DefaultScope.
+   * nullptr, the default, makes the arrays use the malloc/realloc/free
+   * functions of vtkObjectBase, which also support memkind.
+   */
+  static vtkSmartPointer<vtkMemoryResource> GetDefaultResource();
+
+#ifndef __VTK_WRAP__
+  /**
+   * Set the default resource of the calling thread for the lifetime of the
+   * object and restore the previous one when it is destroyed. Scopes must be
+   * destroyed in the reverse order of their creation, by the thread that
+   * created them.
+   */
+  class VTKCOMMONCORE_EXPORT DefaultScope
+  {
+  public:
+    DefaultScope(vtkMemoryResource* resource);
+    ~DefaultScope();
+
+  private:
+    DefaultScope(const DefaultScope&) = delete;
+    void operator=(const DefaultScope&) = delete;
+
+    vtkSmartPointer<vtkMemoryResource> Resource;
+    vtkMemoryResource* Previous;
+  };
+#endif
+
+protected:
+  vtkMemoryResource();
+  ~vtkMemoryResource() override;
+
+  ///@{
+  /**
+   * Implementation of the allocation. DoReallocate() defaults to allocating a
+   * new block, copying the content and deallocating the old block.
+   */
+  virtual void* DoAllocate(std::size_t bytes) = 0;
+  virtual void DoDeallocate(void* pointer, std::size_t bytes) = 0;
+  virtual void* DoReallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes);
+  ///@}
+
+private:
+  vtkMemoryResource(const vtkMemoryResource&) = delete;
+  void operator=(const vtkMemoryResource&) = delete;
+
+  void AddBytesInUse(vtkTypeUInt64 bytes);
+
+  std::atomic<vtkTypeUInt64> BytesInUse;
+  std::atomic<vtkTypeUInt64> HighWaterMark;
+  std::atomic<vtkTypeUInt64> NumberOfAllocations;
+  std::atomic<vtkTypeUInt64> NumberOfDeallocations;
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPoolMemoryResource.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPoolMemoryResource.h"
+
+#include "vtkMallocMemoryResource.h"
+#include "vtkObjectFactory.h"
+
+#include <map>    // For std::map
+#include <mutex>  // For std::mutex
+#include <vector> // For std::vector
+
+vtkStandardNewMacro(vtkPoolMemoryResource);
+
+//------------------------------------------------------------------------------
+struct vtkPoolMemoryResource::vtkInternals
+{
+  std::mutex Mutex;
+  // Free blocks for each block size.
+  std::map<std::size_t, std::vector<void*>> FreeBlocks;
+  vtkTypeUInt64 CachedBytes = 0;
+  vtkTypeUInt64 NumberOfHits = 0;
+  vtkTypeUInt64 NumberOfMisses = 0;
+};
+
+//------------------------------------------------------------------------------
+vtkPoolMemoryResource::vtkPoolMemoryResource()
+  : UpstreamResource(vtkSmartPointer<vtkMallocMemoryResource>::New())
+  , MaximumCachedBytes(vtkTypeUInt64(1) << 30)
+  , Internals(new vtkInternals)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkPoolMemoryResource::~vtkPoolMemoryResource()
+{
+  this->ReleaseCachedMemory();
+}
+
+//------------------------------------------------------------------------------
+std::size_t vtkPoolMemoryResource::GetBlockSize(std::size_t bytes)
+{
+  const std::size_t minimumBlockSize = 64;
+  if (bytes <= minimumBlockSize)
+  {
+    return minimumBlockSize;
+  }
+
+  // Round up to a multiple of a quarter of the largest power of two below bytes.
+  std::size_t power = minimumBlockSize;
+  while (power < (bytes - 1) / 2 + 1)
+  {
+    power *= 2;
+  }
+  const std::size_t step = power / 4;
+  return (bytes + step - 1) / step * step;
+}
+
+//------------------------------------------------------------------------------
+void vtkPoolMemoryResource::SetUpstreamResource(vtkMemoryResource* resource)
+{
+  if (resource == this || resource == this->UpstreamResource)
+  {
+    return;
+  }
+  // The blocks handed out must go back to the resource they come from.
+  if (this->GetBytesInUse() > 0)
+  {
+    vtkErrorMacro("Cannot change the upstream resource while "
+      << this->GetBytesInUse() << " bytes allocated from the pool are in use.");
+    return;
+  }
+  this->ReleaseCachedMemory();
+  this->UpstreamResource = resource;
+  if (!resource)
+  {
+    this->UpstreamResource = vtkSmartPointer<vtkMallocMemoryResource>::New();
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void* vtkPoolMemoryResource::DoAllocate(std::size_t bytes)
+{
+  const std::size_t blockSize = vtkPoolMemoryResource::GetBlockSize(bytes);
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    auto it = this->Internals->FreeBlocks.find(blockSize);
+    if (it != this->Internals->FreeBlocks.end() && !it->second.empty())
+    {
+      void* pointer = it->second.back();
+      it->second.pop_back();
+      this->Internals->CachedBytes -= blockSize;
+      ++this->Internals->NumberOfHits;
+      return pointer;
+    }
+    ++this->Internals->NumberOfMisses;
+  }
+
+  void* pointer = this->UpstreamResource->Allocate(blockSize);
+  if (!pointer)
+  {
+    // Give the cached memory back and try again.
+    this->ReleaseCachedMemory();
+    pointer = this->UpstreamResource->Allocate(blockSize);
+  }
+  return pointer;
+}
+
+//------------------------------------------------------------------------------
+void vtkPoolMemoryResource::DoDeallocate(void* pointer, std::size_t bytes)
+{
+  const std::size_t blockSize = vtkPoolMemoryResource::GetBlockSize(bytes);
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    if (this->Internals->CachedBytes + blockSize <= this->MaximumCachedBytes)
+    {
+      this->Internals->FreeBlocks[blockSize].push_back(pointer);
+      this->Internals->CachedBytes += blockSize;
+      return;
+    }
+  }
+  this->UpstreamResource->Deallocate(pointer, blockSize);
+}
+
+//------------------------------------------------------------------------------
+void* vtkPoolMemoryResource::DoReallocate(
+  void* pointer, std::size_t oldBytes, std::size_t newBytes)
+{
+  if (vtkPoolMemoryResource::GetBlockSize(oldBytes) ==
+    vtkPoolMemoryResource::GetBlockSize(newBytes))
+  {
+    return pointer;
+  }
+  return this->Superclass::DoReallocate(pointer, oldBytes, newBytes);
+}
+
+//------------------------------------------------------------------------------
+void vtkPoolMemoryResource::ReleaseCachedMemory()
+{
+  std::map<std::size_t, std::vector<void*>> freeBlocks;
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    freeBlocks.swap(this->Internals->FreeBlocks);
+    this->Internals->CachedBytes = 0;
+  }
+  for (const auto& sizeBlocks : freeBlocks)
+  {
+    for (void* pointer : sizeBlocks.second)
+    {
+      this->UpstreamResource->Deallocate(pointer, sizeBlocks.first);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkPoolMemoryResource::GetCachedBytes()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->CachedBytes;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkPoolMemoryResource::GetNumberOfHits()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->NumberOfHits;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkPoolMemoryResource::GetNumberOfMisses()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->NumberOfMisses;
+}
+
+//------------------------------------------------------------------------------
+void vtkPoolMemoryResource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "UpstreamResource: " << this->UpstreamResource << "\n";
+  os << indent << "MaximumCachedBytes: " << this->MaximumCachedBytes << "\n";
+  os << indent << "CachedBytes: " << this->GetCachedBytes() << "\n";
+  os << indent << "NumberOfHits: " << this->GetNumberOfHits() << "\n";
+  os << indent << "NumberOfMisses: " << this->GetNumberOfMisses() << "\n";
+}
@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPoolMemoryResource.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPoolMemoryResource
+ * @brief   memory resource recycling the blocks released by data arrays
+ *
+ * vtkPoolMemoryResource rounds every allocation up to a size class and keeps
+ * the blocks that are deallocated in a free list per size class instead of
+ * returning them to its upstream resource. The next allocation of the same
+ * size class reuses one of them. Pipelines executed repeatedly, such as
+ * time-dependent ones, then allocate their arrays from the pool without
+ * calling the system allocator or touching new pages.
+ *
+ * The size classes are the multiples of a quarter of the previous power of
+ * two, so that at most 25% of a block is wasted. Reallocating a block within
+ * its size class does not move it.
+ *
+ * The memory kept in the free lists is bounded by MaximumCachedBytes. Blocks
+ * that would exceed it are released to the upstream resource. The high-water
+ * mark of the memory actually held by the pool, cached blocks included, is
+ * the high-water mark of the upstream resource.
+ *
+ * @sa
+ * vtkMemoryResource vtkMallocMemoryResource
+ */
+
+#ifndef vtkPoolMemoryResource_h
+#define vtkPoolMemoryResource_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkMemoryResource.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <memory> // For std::unique_ptr
+
+class VTKCOMMONCORE_EXPORT vtkPoolMemoryResource : public vtkMemoryResource
+{
+public:
+  static vtkPoolMemoryResource* New();
+  vtkTypeMacro(vtkPoolMemoryResource, vtkMemoryResource);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Resource the blocks of the pool are allocated from. Setting it releases
+   * the cached blocks. It cannot be changed while blocks allocated from the
+   * pool are in use, nor while the pool is used by other threads. Default is
+   * a vtkMallocMemoryResource.
+   */
+  void SetUpstreamResource(vtkMemoryResource* resource);
+  vtkMemoryResource* GetUpstreamResource() { return this->UpstreamResource; }
+  ///@}
+
+  ///@{
+  /**
+   * Maximum number of bytes kept in the free lists. Default is 1 GiB.
+   */
+  vtkSetMacro(MaximumCachedBytes, vtkTypeUInt64);
+  vtkGetMacro(MaximumCachedBytes, vtkTypeUInt64);
+  ///@}
+
+  /**
+   * Return all the cached blocks to the upstream resource.
+   */
+  void ReleaseCachedMemory();
+
+  ///@{
+  /**
+   * Number of bytes held in the free lists, and number of allocations that
+   * reused a cached block (hits) or had to call the upstream resource
+   * (misses).
+   */
+  vtkTypeUInt64 GetCachedBytes();
+  vtkTypeUInt64 GetNumberOfHits();
+  vtkTypeUInt64 GetNumberOfMisses();
+  ///@}
+
+  /**
+   * Size of the blocks used for allocations of @a bytes bytes.
+   */
+  static std::size_t GetBlockSize(std::size_t bytes);
+
+protected:
+  vtkPoolMemoryResource();
+  ~vtkPoolMemoryResource() override;
+
+  void* DoAllocate(std::size_t bytes) override;
+  void DoDeallocate(void* pointer, std::size_t bytes) override;
+  void* DoReallocate(void* pointer, std::size_t oldBytes, std::size_t newBytes) override;
+
+  vtkSmartPointer<vtkMemoryResource> UpstreamResource;
+  vtkTypeUInt64 MaximumCachedBytes;
+
+private:
+  vtkPoolMemoryResource(const vtkPoolMemoryResource&) = delete;
+  void operator=(const vtkPoolMemoryResource&) = delete;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+};
+
+#endif
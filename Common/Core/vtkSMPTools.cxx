@@ -38,6 +38,13 @@ void vtkSMPTools::Initialize(int numThreads)
   return SMPToolsAPI.Initialize(numThreads);
 }
 
+//------------------------------------------------------------------------------
+void vtkSMPTools::Finalize()
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  SMPToolsAPI.Finalize();
+}
+
 //------------------------------------------------------------------------------
 int vtkSMPTools::GetEstimatedNumberOfThreads()
 {
@@ -72,3 +79,31 @@ bool vtkSMPTools::GetSingleThread()
   auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
   return SMPToolsAPI.GetSingleThread();
 }
+
+//------------------------------------------------------------------------------
+void vtkSMPTools::SetInstrumentation(bool enable)
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  SMPToolsAPI.SetInstrumentation(enable);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPTools::GetInstrumentation()
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  return SMPToolsAPI.GetInstrumentation();
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPTools::SetInstrumentationVerbosity(int verbosity)
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  SMPToolsAPI.SetInstrumentationVerbosity(verbosity);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPTools::WriteInstrumentationTrace(const char* fileName)
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  return SMPToolsAPI.WriteInstrumentationTrace(fileName);
+}
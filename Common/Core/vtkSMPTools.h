@@ -36,7 +36,8 @@
 #include "SMP/Common/vtkSMPToolsAPI.h"
 #include "vtkSMPThreadLocal.h" // For Initialized
 
-#include <functional>  // For std::function
+#include <functional>  // For std::function, std::plus
+#include <iterator>    // For std::iterator_traits
 #include <type_traits> // For std:::enable_if
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -411,6 +412,15 @@ public:
    */
   static void Initialize(int numThreads = 0);
 
+  /**
+   * /!\ This method is not thread safe.
+   * Release the threads owned by the backend: the STDThread backend joins the
+   * threads of its pool, which are otherwise left running until the process
+   * exits. Parallel operations may still be used afterwards, the threads are
+   * started again when needed. Must not be called during a parallel operation.
+   */
+  static void Finalize();
+
   /**
    * Get the estimated number of threads being used by the backend.
    * This should be used as just an estimate since the number of threads may
@@ -425,7 +435,7 @@ public:
    * When enabled the comportement is different for each backend:
    *    - TBB support nested parallelism using a single thread pool
    *    - For OpenMP, set `omp_set_nested` to the value of `isNested`.
-   *    - For STDThread nested parallelism implies creating new threads pools.
+   *    - STDThread support nested parallelism using a single work-stealing thread pool.
    *    - For Sequential nothing changes.
    *
    * Default to false except for TBB.
@@ -449,6 +459,64 @@ public:
    */
   static bool GetSingleThread();
 
+  ///@{
+  /**
+   * /!\ This method is not thread safe.
+   * Enable the instrumentation of vtkSMPTools::For. When enabled, the wall time,
+   * number of chunks, busy time of each thread and imbalance ratio (busy time of
+   * the busiest thread over the average busy time) of each loop is logged with
+   * vtkLogger and recorded to be written with WriteInstrumentationTrace().
+   * Loops are labelled with the innermost InstrumentationScope of the calling
+   * thread or with the name of their functor.
+   *
+   * The VTK_SMP_INSTRUMENTATION env variable can also be used to enable the
+   * instrumentation. If the VTK_SMP_INSTRUMENTATION_TRACE env variable is set to
+   * a file name, the instrumentation is enabled and the trace is written to this
+   * file when the process exits.
+   *
+   * Default is false.
+   */
+  static void SetInstrumentation(bool enable);
+  static bool GetInstrumentation();
+  ///@}
+
+  /**
+   * Set the vtkLogger verbosity used to log the instrumented loops.
+   * Default is vtkLogger::VERBOSITY_INFO.
+   */
+  static void SetInstrumentationVerbosity(int verbosity);
+
+  /**
+   * Write the loops recorded by the instrumentation since the last call as a
+   * Chrome trace JSON file, which can be opened with chrome://tracing or
+   * Perfetto. Returns false if the file could not be written.
+   */
+  static bool WriteInstrumentationTrace(const char* fileName);
+
+  /**
+   * Label the instrumented loops started by the current thread while this
+   * object is alive, see SetInstrumentation().
+   *
+   * \code
+   * {
+   *   vtkSMPTools::InstrumentationScope scope("vtkThreshold: classify cells");
+   *   vtkSMPTools::For(0, numCells, classifier);
+   * }
+   * \endcode
+   */
+  class InstrumentationScope
+  {
+  public:
+    InstrumentationScope(const char* label)
+    {
+      vtk::detail::smp::vtkSMPToolsInstrumentation::PushLabel(label);
+    }
+    ~InstrumentationScope() { vtk::detail::smp::vtkSMPToolsInstrumentation::PopLabel(); }
+
+    InstrumentationScope(const InstrumentationScope&) = delete;
+    void operator=(const InstrumentationScope&) = delete;
+  };
+
   /**
    * Structure used to specify configuration for LocalScope() method.
    * Several parameters can be configured:
@@ -600,6 +668,118 @@ public:
     auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
     SMPToolsAPI.Sort(begin, end, comp);
   }
+
+  ///@{
+  /**
+   * A convenience method for reducing data. It is a drop in replacement for
+   * std::reduce() and returns init combined with all the values of [begin, end)
+   * using op (std::plus by default).
+   *
+   * The values are reduced by blocks which are combined in their original
+   * order, so op must be associative but does not need to be commutative.
+   * For a given number of threads the result does not depend on scheduling,
+   * which makes floating point reductions reproducible.
+   *
+   * Usage example with vtkDataArray:
+   * \code
+   * auto range = vtk::DataArrayValueRange<1>(array);
+   * double sum = vtkSMPTools::Reduce(range.cbegin(), range.cend(), 0.0);
+   * \endcode
+   */
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.TransformReduce(
+      begin, end, init, op, vtk::detail::smp::IdentityFunctor());
+  }
+
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+  ///@}
+
+  /**
+   * A convenience method for transforming and reducing data. It is a drop in
+   * replacement for std::transform_reduce() and returns init combined using
+   * reduce with transform applied to all the values of [begin, end).
+   * See Reduce() for the requirements on reduce.
+   *
+   * Usage example computing the number of cells of a given type:
+   * \code
+   * auto types = vtk::DataArrayValueRange<1>(cellTypes);
+   * vtkIdType nbOfTets = vtkSMPTools::TransformReduce(types.cbegin(), types.cend(),
+   *   vtkIdType(0), std::plus<vtkIdType>(),
+   *   [](unsigned char type) -> vtkIdType { return type == VTK_TETRA; });
+   * \endcode
+   */
+  template <typename Iterator, typename T, typename ReduceOp, typename TransformOp>
+  static T TransformReduce(
+    Iterator begin, Iterator end, T init, ReduceOp reduce, TransformOp transform)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.TransformReduce(begin, end, init, reduce, transform);
+  }
+
+  ///@{
+  /**
+   * A convenience method computing prefix sums. It is a drop in replacement
+   * for std::inclusive_scan(): the i-th output is the combination using op
+   * (std::plus by default) of the input values 0 to i included.
+   * The output range may be the input range. Returns the end of the output
+   * range. See Reduce() for the requirements on op.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.InclusiveScan(inBegin, inEnd, outBegin, op);
+    std::advance(outBegin, std::distance(inBegin, inEnd));
+    return outBegin;
+  }
+
+  template <typename InputIt, typename OutputIt>
+  static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin)
+  {
+    using ValueType = typename std::iterator_traits<InputIt>::value_type;
+    return vtkSMPTools::InclusiveScan(inBegin, inEnd, outBegin, std::plus<ValueType>());
+  }
+  ///@}
+
+  ///@{
+  /**
+   * A convenience method computing prefix sums. It is a drop in replacement
+   * for std::exclusive_scan(): the i-th output is init combined using op
+   * (std::plus by default) with the input values 0 to i excluded.
+   * The output range may be the input range. Returns the end of the output
+   * range. See Reduce() for the requirements on op.
+   *
+   * Usage example computing cell offsets from cell sizes:
+   * \code
+   * std::vector<vtkIdType> offsets(sizes.size() + 1);
+   * auto last = vtkSMPTools::ExclusiveScan(
+   *   sizes.begin(), sizes.end(), offsets.begin(), static_cast<vtkIdType>(0));
+   * *last = offsets[sizes.size() - 1] + sizes.back();
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt ExclusiveScan(
+    InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.ExclusiveScan(inBegin, inEnd, outBegin, init, op);
+    std::advance(outBegin, std::distance(inBegin, inEnd));
+    return outBegin;
+  }
+
+  template <typename InputIt, typename OutputIt, typename T>
+  static OutputIt ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(inBegin, inEnd, outBegin, init, std::plus<T>());
+  }
+  ///@}
 };
 
 #endif
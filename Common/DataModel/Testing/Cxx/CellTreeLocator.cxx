@@ -16,10 +16,18 @@
 #include "vtkGenericCell.h"
 #include "vtkPointData.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellTreeLocator.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
 #include "vtkNew.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkSphereSource.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
 
 #include "vtkDebugLeaks.h"
 
@@ -98,9 +106,135 @@ int TestWithCachedCellBoundsParameter(int cachedCellBounds)
   return EXIT_SUCCESS;
 }
 
+// A block of hexahedra, large enough for the tree to be built concurrently.
+vtkSmartPointer<vtkUnstructuredGrid> MakeHexahedra(int resolution)
+{
+  const int n = resolution + 1;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        points->InsertNextPoint(i, j + 0.1 * i, k);
+      }
+    }
+  }
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate(resolution * resolution * resolution);
+  for (int k = 0; k < resolution; ++k)
+  {
+    for (int j = 0; j < resolution; ++j)
+    {
+      for (int i = 0; i < resolution; ++i)
+      {
+        const vtkIdType p = i + n * (j + n * k);
+        const vtkIdType hex[8] = { p, p + 1, p + n + 1, p + n, p + n * n, p + n * n + 1,
+          p + n * n + n + 1, p + n * n + n };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+  return grid;
+}
+
+// Checks that the batched FindCells() matches FindCell(), and that the tree
+// built concurrently is the same as the sequential one.
+int TestFindCells()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeHexahedra(45);
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+
+  vtkNew<vtkCellTreeLocator> sequentialLocator, locator;
+  vtkNew<vtkPolyData> sequentialTree, tree;
+  auto build = [&](vtkCellTreeLocator* cellTree, vtkPolyData* representation) {
+    cellTree->SetDataSet(grid);
+    cellTree->BuildLocator();
+    // The boxes are appended to the points and lines of the representation.
+    vtkNew<vtkPoints> boxPoints;
+    vtkNew<vtkCellArray> boxLines;
+    representation->SetPoints(boxPoints);
+    representation->SetLines(boxLines);
+    cellTree->GenerateRepresentation(-1, representation);
+    return representation->GetNumberOfPoints();
+  };
+  vtkTestDataSetUtilities::RunSequentially(
+    [&]() { return build(sequentialLocator, sequentialTree); });
+  build(locator, tree);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkPoints> queries;
+  queries->SetDataTypeToDouble();
+  for (int i = 0; i < 20000; ++i)
+  {
+    double x[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      x[c] = random->GetNextRangeValue(-1.0, 50.0);
+    }
+    queries->InsertNextPoint(x);
+  }
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> pcoords;
+  locator->FindCells(queries, cellIds, pcoords);
+
+  int status = EXIT_SUCCESS;
+  if (tree->GetNumberOfPoints() == 0 ||
+    !vtkTestDataSetUtilities::SameDataSets(sequentialTree, tree))
+  {
+    std::cerr << "ERROR: the concurrent build gives a different tree." << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  if (cellIds->GetNumberOfIds() != queries->GetNumberOfPoints() ||
+    pcoords->GetNumberOfTuples() != queries->GetNumberOfPoints())
+  {
+    std::cerr << "ERROR: FindCells gives the wrong number of results." << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkGenericCell> cell;
+  double weights[8];
+  int numFound = 0;
+  for (vtkIdType i = 0; i < queries->GetNumberOfPoints(); ++i)
+  {
+    double x[3], pc[3];
+    int subId;
+    queries->GetPoint(i, x);
+    const vtkIdType cellId = sequentialLocator->FindCell(x, 0.0, cell, subId, pc, weights);
+    if (cellId != cellIds->GetId(i))
+    {
+      std::cerr << "ERROR: FindCells gives cell " << cellIds->GetId(i) << " instead of " << cellId
+                << " for point " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (cellId >= 0)
+    {
+      ++numFound;
+      for (int c = 0; c < 3; ++c)
+      {
+        if (pc[c] != pcoords->GetComponent(i, c))
+        {
+          std::cerr << "ERROR: FindCells gives wrong parametric coordinates for point " << i
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  if (numFound == 0)
+  {
+    std::cerr << "ERROR: FindCells finds no cell." << std::endl;
+    status = EXIT_FAILURE;
+  }
+  return status;
+}
+
 int CellTreeLocator(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
   int retVal = TestWithCachedCellBoundsParameter(0);
   retVal += TestWithCachedCellBoundsParameter(1);
+  retVal += TestFindCells();
   return retVal;
 }
@@ -0,0 +1,375 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the queries of vtkBVHCellLocator against brute force searches, the
+// packets of lines against single lines, and the concurrent build of the tree
+// against the sequential one.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+void RandomPoint(vtkMinimalStandardRandomSequence* random, double min, double max, double x[3])
+{
+  for (int c = 0; c < 3; ++c)
+  {
+    x[c] = random->GetNextRangeValue(min, max);
+  }
+}
+
+// A triangulated sphere of radius 0.4 centered at (0.5, 0.5, 0.5), and
+// random triangles of very different sizes around it.
+vtkSmartPointer<vtkPolyData> MakeSurface(int numRandomTriangles)
+{
+  const int numLat = 24, numLon = 48;
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  auto polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i <= numLat; ++i)
+  {
+    const double theta = vtkMath::Pi() * i / numLat;
+    for (int j = 0; j < numLon; ++j)
+    {
+      const double phi = 2.0 * vtkMath::Pi() * j / numLon;
+      points->InsertNextPoint(0.5 + 0.4 * std::sin(theta) * std::cos(phi),
+        0.5 + 0.4 * std::sin(theta) * std::sin(phi), 0.5 + 0.4 * std::cos(theta));
+    }
+  }
+  for (int i = 0; i < numLat; ++i)
+  {
+    for (int j = 0; j < numLon; ++j)
+    {
+      const vtkIdType a = i * numLon + j, b = i * numLon + (j + 1) % numLon;
+      const vtkIdType tri1[3] = { a, b, b + numLon };
+      const vtkIdType tri2[3] = { a, b + numLon, a + numLon };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+    }
+  }
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(3);
+  for (int i = 0; i < numRandomTriangles; ++i)
+  {
+    double center[3];
+    RandomPoint(random, -0.2, 1.2, center);
+    const double size = std::pow(10.0, random->GetNextRangeValue(-3.0, -0.5));
+    vtkIdType tri[3];
+    for (vtkIdType& id : tri)
+    {
+      double x[3];
+      RandomPoint(random, -size, size, x);
+      id = points->InsertNextPoint(center[0] + x[0], center[1] + x[1], center[2] + x[2]);
+    }
+    polys->InsertNextCell(3, tri);
+  }
+
+  auto surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->SetPoints(points);
+  surface->SetPolys(polys);
+  return surface;
+}
+
+// Random segments crossing the unit cube, and a bundle of parallel segments.
+void MakeLines(int numRandomLines, vtkPoints* p1, vtkPoints* p2)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(11);
+  for (int i = 0; i < numRandomLines; ++i)
+  {
+    double a[3], b[3];
+    RandomPoint(random, -0.3, 1.3, a);
+    RandomPoint(random, -0.3, 1.3, b);
+    p1->InsertNextPoint(a);
+    p2->InsertNextPoint(b);
+  }
+  for (int i = 0; i < 20; ++i)
+  {
+    for (int j = 0; j < 20; ++j)
+    {
+      p1->InsertNextPoint(0.05 * i, 0.05 * j, -0.5);
+      p2->InsertNextPoint(0.05 * i + 0.1, 0.05 * j + 0.2, 1.5);
+    }
+  }
+}
+
+bool SameIds(vtkIdList* a, const std::vector<vtkIdType>& b)
+{
+  return a->GetNumberOfIds() == static_cast<vtkIdType>(b.size()) &&
+    std::equal(b.begin(), b.end(), a->begin());
+}
+
+std::vector<vtkIdType> SortedIds(vtkIdList* ids)
+{
+  std::vector<vtkIdType> sorted(ids->begin(), ids->end());
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+// Compares the line, closest point and bounds queries with brute force.
+int TestQueries(vtkDataSet* surface, vtkBVHCellLocator* locator, vtkPoints* p1, vtkPoints* p2)
+{
+  const double tol = 1e-10;
+  const vtkIdType numCells = surface->GetNumberOfCells();
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkPoints> points;
+  double t, x[3], pcoords[3], dist2, cellBounds[6];
+  int subId;
+  vtkIdType cellId;
+  std::vector<double> weights(surface->GetMaxCellSize());
+
+  for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+  {
+    double a[3], b[3];
+    p1->GetPoint(i, a);
+    p2->GetPoint(i, b);
+
+    // Closest and all intersections.
+    double tBest = VTK_DOUBLE_MAX;
+    vtkIdType idBest = -1;
+    std::vector<vtkIdType> hits;
+    for (vtkIdType cId = 0; cId < numCells; ++cId)
+    {
+      surface->GetCell(cId, cell);
+      if (cell->IntersectWithLine(a, b, tol, t, x, pcoords, subId))
+      {
+        hits.push_back(cId);
+        if (t < tBest)
+        {
+          tBest = t;
+          idBest = cId;
+        }
+      }
+    }
+    const int found = locator->IntersectWithLine(a, b, tol, t, x, pcoords, subId, cellId, cell);
+    VTK_TEST_CHECK(found == (idBest >= 0 ? 1 : 0));
+    VTK_TEST_CHECK(cellId == idBest);
+    VTK_TEST_CHECK(!found || t == tBest);
+    VTK_TEST_CHECK(!found || cell->GetCellType() == VTK_TRIANGLE);
+
+    locator->IntersectWithLine(a, b, tol, points, cellIds, cell);
+    VTK_TEST_CHECK(SortedIds(cellIds) == hits);
+    VTK_TEST_CHECK(points->GetNumberOfPoints() == cellIds->GetNumberOfIds());
+    VTK_TEST_CHECK(hits.empty() || cellIds->GetId(0) == idBest);
+
+    // Closest point to the first end point.
+    double d2Best = VTK_DOUBLE_MAX;
+    idBest = -1;
+    for (vtkIdType cId = 0; cId < numCells; ++cId)
+    {
+      surface->GetCell(cId, cell);
+      double d2;
+      if (cell->EvaluatePosition(a, x, subId, pcoords, d2, weights.data()) != -1 && d2 < d2Best)
+      {
+        d2Best = d2;
+        idBest = cId;
+      }
+    }
+    locator->FindClosestPoint(a, x, cell, cellId, subId, dist2);
+    VTK_TEST_CHECK(cellId == idBest);
+    VTK_TEST_CHECK(dist2 == d2Best);
+
+    // Cells within the bounds of the segment.
+    double bbox[6];
+    for (int c = 0; c < 3; ++c)
+    {
+      bbox[2 * c] = std::min(a[c], b[c]);
+      bbox[2 * c + 1] = std::max(a[c], b[c]);
+    }
+    std::vector<vtkIdType> within;
+    for (vtkIdType cId = 0; cId < numCells; ++cId)
+    {
+      surface->GetCellBounds(cId, cellBounds);
+      if (cellBounds[0] <= bbox[1] && bbox[0] <= cellBounds[1] && cellBounds[2] <= bbox[3] &&
+        bbox[2] <= cellBounds[3] && cellBounds[4] <= bbox[5] && bbox[4] <= cellBounds[5])
+      {
+        within.push_back(cId);
+      }
+    }
+    locator->FindCellsWithinBounds(bbox, cellIds);
+    VTK_TEST_CHECK(SortedIds(cellIds) == within);
+
+    // The cells crossed by the plane through the segment must be found once.
+    double n[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    vtkMath::Normalize(n);
+    locator->FindCellsAlongPlane(a, n, tol, cellIds);
+    std::vector<vtkIdType> alongPlane = SortedIds(cellIds);
+    VTK_TEST_CHECK(std::adjacent_find(alongPlane.begin(), alongPlane.end()) == alongPlane.end());
+    for (vtkIdType cId = 0; cId < numCells; ++cId)
+    {
+      surface->GetCell(cId, cell);
+      double dMin = VTK_DOUBLE_MAX, dMax = -VTK_DOUBLE_MAX;
+      for (vtkIdType p = 0; p < cell->GetNumberOfPoints(); ++p)
+      {
+        double q[3];
+        cell->GetPoints()->GetPoint(p, q);
+        const double d = vtkMath::Dot(n, q) - vtkMath::Dot(n, a);
+        dMin = std::min(dMin, d);
+        dMax = std::max(dMax, d);
+      }
+      VTK_TEST_CHECK(dMin > 0.0 || dMax < 0.0 ||
+        std::binary_search(alongPlane.begin(), alongPlane.end(), cId));
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// Compares the packets of lines with single lines.
+int TestLines(vtkAbstractCellLocator* locator, vtkPoints* p1, vtkPoints* p2)
+{
+  const double tol = 1e-10;
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> ts;
+  vtkNew<vtkPoints> xs;
+  locator->IntersectWithLines(p1, p2, tol, cellIds, ts, xs);
+  VTK_TEST_CHECK(cellIds->GetNumberOfIds() == p1->GetNumberOfPoints());
+  VTK_TEST_CHECK(ts->GetNumberOfValues() == p1->GetNumberOfPoints());
+  VTK_TEST_CHECK(xs->GetNumberOfPoints() == p1->GetNumberOfPoints());
+
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numHits = 0;
+  for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+  {
+    double a[3], b[3], t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    p1->GetPoint(i, a);
+    p2->GetPoint(i, b);
+    if (locator->IntersectWithLine(a, b, tol, t, x, pcoords, subId, cellId, cell))
+    {
+      ++numHits;
+      VTK_TEST_CHECK(cellIds->GetId(i) == cellId);
+      VTK_TEST_CHECK(ts->GetValue(i) == t);
+      double y[3];
+      xs->GetPoint(i, y);
+      VTK_TEST_CHECK(y[0] == x[0] && y[1] == x[1] && y[2] == x[2]);
+    }
+    else
+    {
+      VTK_TEST_CHECK(cellIds->GetId(i) == -1);
+      VTK_TEST_CHECK(ts->GetValue(i) == 0.0);
+    }
+  }
+  VTK_TEST_CHECK(numHits > 0);
+
+  // Only the cell ids.
+  vtkNew<vtkIdList> idsOnly;
+  locator->IntersectWithLines(p1, p2, tol, idsOnly);
+  VTK_TEST_CHECK(SameIds(idsOnly, std::vector<vtkIdType>(cellIds->begin(), cellIds->end())));
+  return EXIT_SUCCESS;
+}
+
+int TestLocator()
+{
+  vtkNew<vtkPoints> p1, p2;
+  MakeLines(100, p1, p2);
+
+  // A small surface, with and without cached cell bounds.
+  vtkSmartPointer<vtkPolyData> surface = MakeSurface(2000);
+  for (bool cache : { true, false })
+  {
+    vtkNew<vtkBVHCellLocator> locator;
+    locator->SetDataSet(surface);
+    locator->SetCacheCellBounds(cache);
+    locator->BuildLocator();
+    VTK_TEST_CHECK(TestQueries(surface, locator, p1, p2) == EXIT_SUCCESS);
+    VTK_TEST_CHECK(TestLines(locator, p1, p2) == EXIT_SUCCESS);
+  }
+
+  // The default implementation of the packets of lines.
+  vtkNew<vtkStaticCellLocator> staticLocator;
+  staticLocator->SetDataSet(surface);
+  staticLocator->BuildLocator();
+  VTK_TEST_CHECK(TestLines(staticLocator, p1, p2) == EXIT_SUCCESS);
+
+  // A shallow copy shares the tree.
+  vtkNew<vtkBVHCellLocator> locator, copy;
+  locator->SetDataSet(surface);
+  locator->SetNumberOfCellsPerNode(2);
+  locator->SetNumberOfBins(4);
+  locator->BuildLocator();
+  copy->ShallowCopy(locator);
+  VTK_TEST_CHECK(TestQueries(surface, copy, p1, p2) == EXIT_SUCCESS);
+
+  // Points in a grid of voxels.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(12, 10, 8);
+  image->SetSpacing(0.1, 0.11, 0.14);
+  vtkNew<vtkBVHCellLocator> imageLocator;
+  imageLocator->SetDataSet(image);
+  imageLocator->BuildLocator();
+  vtkNew<vtkStaticCellLocator> imageStaticLocator;
+  imageStaticLocator->SetDataSet(image);
+  imageStaticLocator->BuildLocator();
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  for (int i = 0; i < 1000; ++i)
+  {
+    double x[3];
+    RandomPoint(random, -0.1, 1.2, x);
+    VTK_TEST_CHECK(imageLocator->FindCell(x) == imageStaticLocator->FindCell(x));
+  }
+
+  // A surface large enough for the concurrent build, which builds the same
+  // tree as the sequential one.
+  vtkSmartPointer<vtkPolyData> large = MakeSurface(150000);
+  vtkNew<vtkBVHCellLocator> sequentialLocator, largeLocator;
+  vtkNew<vtkPolyData> sequentialTree, tree;
+  auto build = [&](vtkBVHCellLocator* bvh, vtkPolyData* representation) {
+    bvh->SetDataSet(large);
+    bvh->BuildLocator();
+    bvh->GenerateRepresentation(-1, representation);
+    vtkNew<vtkIdList> hits;
+    bvh->IntersectWithLines(p1, p2, 1e-10, hits);
+    return std::vector<vtkIdType>(hits->begin(), hits->end());
+  };
+  const std::vector<vtkIdType> sequentialIds = vtkTestDataSetUtilities::RunSequentially(
+    [&]() { return build(sequentialLocator, sequentialTree); });
+  VTK_TEST_CHECK(build(largeLocator, tree) == sequentialIds);
+  VTK_TEST_CHECK(tree->GetNumberOfPoints() > 0);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameDataSets(sequentialTree, tree));
+  VTK_TEST_CHECK(TestLines(largeLocator, p1, p2) == EXIT_SUCCESS);
+
+  vtkNew<vtkPoints> fewP1, fewP2;
+  for (vtkIdType i = 0; i < 20; ++i)
+  {
+    fewP1->InsertNextPoint(p1->GetPoint(i));
+    fewP2->InsertNextPoint(p2->GetPoint(i));
+  }
+  VTK_TEST_CHECK(TestQueries(large, largeLocator, fewP1, fewP2) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestBVHCellLocator(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  return TestLocator();
+}
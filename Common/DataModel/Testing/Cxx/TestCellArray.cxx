@@ -26,12 +26,14 @@
 #include "vtkNew.h"
 #include "vtkPolyData.h"
 #include "vtkQuad.h"
+#include "vtkSMPTools.h"
 #include "vtkSetGet.h"
 #include "vtkSmartPointer.h"
 #include "vtkTypeInt32Array.h"
 #include "vtkTypeInt64Array.h"
 
 #include <algorithm>
+#include <atomic>
 #include <initializer_list>
 #include <stdexcept>
 #include <type_traits>
@@ -895,6 +897,79 @@ void TestReplaceCellAtId(vtkSmartPointer<vtkCellArray> cellArray)
   validate(3, { 5, 3, 4 });
 }
 
+void TestBuildCells(vtkSmartPointer<vtkCellArray> cellArray)
+{
+  vtkLogScopeFunction(INFO);
+
+  // Cell i has (i % 7) + 1 points: i, i + 1, ...
+  const vtkIdType numCells = 100000;
+  auto cellSize = [](vtkIdType cellId) -> vtkIdType { return (cellId % 7) + 1; };
+  auto cellPoints = [&](vtkIdType cellId, vtkIdType* pts) {
+    for (vtkIdType i = 0; i < cellSize(cellId); ++i)
+    {
+      pts[i] = cellId + i;
+    }
+  };
+
+  auto validate = [&]() {
+    TEST_ASSERT(cellArray->GetNumberOfCells() == numCells);
+    vtkIdType connectivitySize = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      cellArray->GetCellAtId(cellId, npts, pts);
+      TEST_ASSERT(npts == cellSize(cellId));
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        TEST_ASSERT(pts[i] == cellId + i);
+      }
+      connectivitySize += npts;
+    }
+    TEST_ASSERT(cellArray->GetNumberOfConnectivityIds() == connectivitySize);
+  };
+
+  const bool is64Bit = cellArray->IsStorage64Bit();
+  FillCellArray(cellArray);
+  TEST_ASSERT(cellArray->BuildCells(numCells, cellSize, cellPoints));
+  TEST_ASSERT(cellArray->IsStorage64Bit() == is64Bit);
+  validate();
+
+  // Two-pass construction, with threads writing the cells themselves.
+  TEST_ASSERT(cellArray->AllocateFromCellSizes(numCells, cellSize));
+  TEST_ASSERT(cellArray->IsStorage64Bit() == is64Bit);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    std::vector<vtkIdType> pts;
+    for (; cellId < endCellId; ++cellId)
+    {
+      pts.resize(static_cast<std::size_t>(cellSize(cellId)));
+      cellPoints(cellId, pts.data());
+      cellArray->ReplaceCellAtId(cellId, static_cast<vtkIdType>(pts.size()), pts.data());
+    }
+  });
+  validate();
+
+  TEST_ASSERT(cellArray->BuildCells(0, cellSize, cellPoints));
+  TEST_ASSERT(cellArray->GetNumberOfCells() == 0);
+  TEST_ASSERT(cellArray->GetNumberOfConnectivityIds() == 0);
+
+  // Negative sizes are rejected before any point is requested, in a single
+  // pass over the sizes and without switching to the 64 bit storage. (Sizes
+  // that do not fit in the 32 bit storage switch to the 64 bit storage, which
+  // would allocate more than 8 GiB here.)
+  bool pointsRequested = false;
+  std::atomic<int> numSizesRequested(0);
+  auto noPoints = [&](vtkIdType, vtkIdType*) { pointsRequested = true; };
+  auto negativeSize = [&](vtkIdType cellId) -> vtkIdType {
+    ++numSizesRequested;
+    return cellId == 5 ? -1 : 3;
+  };
+  TEST_ASSERT(!cellArray->BuildCells(10, negativeSize, noPoints));
+  TEST_ASSERT(!pointsRequested);
+  TEST_ASSERT(numSizesRequested == 10);
+  TEST_ASSERT(cellArray->IsStorage64Bit() == is64Bit);
+}
+
 void TestGetMaxCellSize(vtkSmartPointer<vtkCellArray> cellArray)
 {
   vtkLogScopeFunction(INFO);
@@ -1395,6 +1470,7 @@ void RunTests(bool use64BitStorage)
   TestIncrementalCellInsertion(NewCellArray(use64BitStorage));
   TestReverseCellAtId(NewCellArray(use64BitStorage));
   TestReplaceCellAtId(NewCellArray(use64BitStorage));
+  TestBuildCells(NewCellArray(use64BitStorage));
   TestGetMaxCellSize(NewCellArray(use64BitStorage));
   TestDeepCopy(NewCellArray(use64BitStorage));
   TestShallowCopy(NewCellArray(use64BitStorage));
@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentMergePoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the points inserted concurrently in vtkConcurrentMergePoints
+// are merged as vtkMergePoints merges them.
+
+#include "vtkConcurrentMergePoints.h"
+#include "vtkMath.h"
+#include "vtkMergePoints.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+const double Bounds[6] = { 0.0, 2.9, 0.0, 2.9, 0.0, 2.9 };
+
+// Points of a 30x30x30 lattice inserted many times each. The float version
+// of each point is also inserted slightly moved, so that it is merged only
+// with float points.
+std::vector<double> MakePoints(vtkIdType n)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+  std::vector<double> points(3 * n);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      points[3 * i + c] = 0.1 * static_cast<int>(random->GetNextRangeValue(0.0, 30.0));
+    }
+    if (i % 5 == 0)
+    {
+      points[3 * i] += 1e-12;
+    }
+  }
+  return points;
+}
+
+// Inserts the points concurrently, and checks that the ids are the ones of
+// the reference up to a permutation, or exactly if sameIds is set.
+int TestMerging(const std::vector<double>& x, int dataType, vtkIdType estNumPts,
+  vtkPoints* referencePoints, const std::vector<vtkIdType>& referenceIds, bool sameIds)
+{
+  const vtkIdType n = static_cast<vtkIdType>(referenceIds.size());
+  const vtkIdType numPoints = referencePoints->GetNumberOfPoints();
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  vtkNew<vtkConcurrentMergePoints> locator;
+  VTK_TEST_CHECK(locator->InitPointInsertion(points, Bounds, estNumPts));
+
+  std::vector<vtkIdType> ids(n);
+  std::vector<int> inserted(n);
+  vtkSMPTools::For(0, n, 1000, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      inserted[i] = locator->InsertUniquePoint(&x[3 * i], ids[i]);
+    }
+  });
+
+  VTK_TEST_CHECK(points->GetNumberOfPoints() == numPoints);
+  vtkIdType numInserted = 0;
+  std::vector<vtkIdType> toReference(numPoints, -1);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    numInserted += inserted[i];
+    VTK_TEST_CHECK(ids[i] >= 0 && ids[i] < numPoints);
+    // The same points get the same ids.
+    VTK_TEST_CHECK(toReference[ids[i]] < 0 || toReference[ids[i]] == referenceIds[i]);
+    toReference[ids[i]] = referenceIds[i];
+    double p[3], q[3];
+    points->GetPoint(ids[i], p);
+    referencePoints->GetPoint(referenceIds[i], q);
+    VTK_TEST_CHECK(p[0] == q[0] && p[1] == q[1] && p[2] == q[2]);
+    VTK_TEST_CHECK(locator->IsInsertedPoint(&x[3 * i]) == ids[i]);
+  }
+  VTK_TEST_CHECK(numInserted == numPoints);
+  VTK_TEST_CHECK(!sameIds || ids == referenceIds);
+  VTK_TEST_CHECK(locator->IsInsertedPoint(0.05, 0.05, 0.05) == -1);
+
+  // The closest inserted points.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  for (int i = 0; i < 200; ++i)
+  {
+    double q[3], p[3], closest[3];
+    for (double& c : q)
+    {
+      c = random->GetNextRangeValue(0.0, 2.9);
+    }
+    double minDist2 = VTK_DOUBLE_MAX;
+    for (vtkIdType j = 0; j < numPoints; ++j)
+    {
+      points->GetPoint(j, p);
+      minDist2 = std::min(minDist2, vtkMath::Distance2BetweenPoints(p, q));
+    }
+    const vtkIdType closestId = locator->FindClosestInsertedPoint(q);
+    VTK_TEST_CHECK(closestId >= 0);
+    points->GetPoint(closestId, closest);
+    VTK_TEST_CHECK(vtkMath::Distance2BetweenPoints(closest, q) == minDist2);
+  }
+
+  // Points inserted without merging.
+  const vtkIdType numNext = 10000;
+  std::vector<vtkIdType> nextIds(numNext);
+  vtkSMPTools::For(0, numNext, 100, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      nextIds[i] = locator->InsertNextPoint(&x[3 * i]);
+    }
+  });
+  VTK_TEST_CHECK(points->GetNumberOfPoints() == numPoints + numNext);
+  std::vector<bool> used(numNext, false);
+  for (vtkIdType i = 0; i < numNext; ++i)
+  {
+    VTK_TEST_CHECK(nextIds[i] >= numPoints && nextIds[i] < numPoints + numNext);
+    VTK_TEST_CHECK(!used[nextIds[i] - numPoints]);
+    used[nextIds[i] - numPoints] = true;
+    // The points inserted first are still found.
+    VTK_TEST_CHECK(locator->IsInsertedPoint(&x[3 * i]) == ids[i]);
+  }
+  return EXIT_SUCCESS;
+}
+
+// Merges the points with vtkMergePoints, then with vtkConcurrentMergePoints
+// with the sequential and the threaded backends.
+int TestInsertion(int dataType, vtkIdType estNumPts)
+{
+  const vtkIdType n = 50000;
+  std::vector<double> x = MakePoints(n);
+
+  vtkNew<vtkPoints> referencePoints;
+  referencePoints->SetDataType(dataType);
+  vtkNew<vtkMergePoints> reference;
+  reference->InitPointInsertion(referencePoints, Bounds, estNumPts);
+  std::vector<vtkIdType> referenceIds(n);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    // vtkMergePoints finds the bucket of the point before converting it.
+    double y[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      y[c] = dataType == VTK_FLOAT ? static_cast<float>(x[3 * i + c]) : x[3 * i + c];
+    }
+    reference->InsertUniquePoint(y, referenceIds[i]);
+  }
+  const vtkIdType numPoints = referencePoints->GetNumberOfPoints();
+  VTK_TEST_CHECK(numPoints < n);
+
+  // Sequentially, the points are inserted in the order of the reference.
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::RunSequentially([&]() {
+    return TestMerging(x, dataType, estNumPts, referencePoints, referenceIds, true);
+  }) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(
+    TestMerging(x, dataType, estNumPts, referencePoints, referenceIds, false) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestConcurrentMergePoints(int, char*[])
+{
+  // Several threads, even on a single core, so that the insertions race.
+  vtkTestDataSetUtilities::ThreadedBackend backend(8);
+  int result = EXIT_SUCCESS;
+  for (int dataType : { VTK_FLOAT, VTK_DOUBLE })
+  {
+    // Many points per bucket, then the default size.
+    for (vtkIdType estNumPts : { 100, 30000 })
+    {
+      if (TestInsertion(dataType, estNumPts) != EXIT_SUCCESS)
+      {
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  return result;
+}
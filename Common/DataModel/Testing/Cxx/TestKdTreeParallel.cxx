@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestKdTreeParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkKdTree builds the same regions and cell lists with the
+// sequential and the threaded backends, and that the regions built from the
+// cell centers are the ones built from the same points.
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkKdTree.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfPoints = 300000;
+
+// Vertices at random points with repeated coordinates, so that many cell
+// centers have the same coordinates as the medians.
+vtkSmartPointer<vtkPolyData> MakeInput()
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(4242);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(NumberOfPoints);
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType i = 0; i < NumberOfPoints; ++i)
+  {
+    double x[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      x[c] = static_cast<int>(random->GetNextRangeValue(0, 500)) / 250.0;
+    }
+    points->SetPoint(i, x);
+    verts->InsertNextCell(1, &i);
+  }
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->SetVerts(verts);
+  return input;
+}
+
+struct Regions
+{
+  std::vector<double> Bounds;
+  std::vector<std::vector<vtkIdType>> Ids;
+};
+
+// The bounds of the regions with either their cells or their points.
+Regions GetRegions(vtkKdTree* tree, bool cells)
+{
+  Regions regions;
+  if (cells)
+  {
+    tree->CreateCellLists();
+  }
+  for (int r = 0; r < tree->GetNumberOfRegions(); ++r)
+  {
+    double bounds[6], dataBounds[6];
+    tree->GetRegionBounds(r, bounds);
+    tree->GetRegionDataBounds(r, dataBounds);
+    regions.Bounds.insert(regions.Bounds.end(), bounds, bounds + 6);
+    regions.Bounds.insert(regions.Bounds.end(), dataBounds, dataBounds + 6);
+
+    std::vector<vtkIdType> ids;
+    if (cells)
+    {
+      vtkIdList* list = tree->GetCellList(r);
+      ids.assign(list->GetPointer(0), list->GetPointer(0) + list->GetNumberOfIds());
+    }
+    else
+    {
+      vtkIdTypeArray* list = tree->GetPointsInRegion(r);
+      ids.assign(list->GetPointer(0), list->GetPointer(0) + list->GetNumberOfValues());
+      list->Delete();
+    }
+    regions.Ids.push_back(ids);
+  }
+  return regions;
+}
+
+int TestBuilds(vtkPolyData* input)
+{
+  vtkNew<vtkKdTree> tree;
+  tree->AddDataSet(input);
+
+  // Cell centers.
+  auto buildFromCells = [&]() {
+    tree->ForceBuildLocator();
+    return GetRegions(tree, true);
+  };
+  const Regions sequentialCells = vtkTestDataSetUtilities::RunSequentially(buildFromCells);
+  VTK_TEST_CHECK(sequentialCells.Ids.size() > 1000);
+  const Regions concurrentCells = buildFromCells();
+  VTK_TEST_CHECK(concurrentCells.Bounds == sequentialCells.Bounds);
+  VTK_TEST_CHECK(concurrentCells.Ids == sequentialCells.Ids);
+
+  // The cell lists are in increasing cell id order, each cell in the region
+  // its center lies in.
+  int* cellRegions = tree->AllGetRegionContainingCell();
+  vtkIdType total = 0;
+  for (size_t r = 0; r < concurrentCells.Ids.size(); ++r)
+  {
+    const std::vector<vtkIdType>& ids = concurrentCells.Ids[r];
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      VTK_TEST_CHECK(cellRegions[ids[i]] == static_cast<int>(r));
+      VTK_TEST_CHECK(i == 0 || ids[i - 1] < ids[i]);
+    }
+    total += static_cast<vtkIdType>(ids.size());
+  }
+  VTK_TEST_CHECK(total == NumberOfPoints);
+
+  // Points, whose regions are the ones of the cell centers.
+  auto buildFromPoints = [&]() {
+    tree->BuildLocatorFromPoints(input->GetPoints());
+    return GetRegions(tree, false);
+  };
+  const Regions sequentialPoints = vtkTestDataSetUtilities::RunSequentially(buildFromPoints);
+  VTK_TEST_CHECK(sequentialPoints.Bounds == sequentialCells.Bounds);
+  const Regions concurrentPoints = buildFromPoints();
+  VTK_TEST_CHECK(concurrentPoints.Bounds == sequentialPoints.Bounds);
+  VTK_TEST_CHECK(concurrentPoints.Ids == sequentialPoints.Ids);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestKdTreeParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+  return TestBuilds(input);
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPointLocatorsBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the batched closest N points and radius queries of the point
+// locators give the neighbors of the single queries, with the sequential and
+// the threaded backends.
+
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIncrementalOctreePointLocator.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkOctreePointLocator.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace
+{
+vtkSmartPointer<vtkPoints> RandomPoints(vtkIdType n, int dataType, double min, double max, int seed)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(dataType);
+  points->SetNumberOfPoints(n);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    double x[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      x[c] = random->GetNextRangeValue(min, max);
+    }
+    points->SetPoint(i, x);
+  }
+  return points;
+}
+
+std::vector<vtkIdType> Neighbors(vtkIdTypeArray* offsets, vtkIdTypeArray* ids, vtkIdType i)
+{
+  return std::vector<vtkIdType>(
+    ids->GetPointer(offsets->GetValue(i)), ids->GetPointer(offsets->GetValue(i + 1)));
+}
+
+// The offsets and ids filled by a batched query.
+std::pair<std::vector<vtkIdType>, std::vector<vtkIdType>> BatchValues(
+  vtkIdTypeArray* offsets, vtkIdTypeArray* ids)
+{
+  return { std::vector<vtkIdType>(offsets->GetPointer(0),
+             offsets->GetPointer(0) + offsets->GetNumberOfValues()),
+    std::vector<vtkIdType>(ids->GetPointer(0), ids->GetPointer(0) + ids->GetNumberOfValues()) };
+}
+
+// Compares the batched queries of the locator with its single queries.
+int TestLocator(vtkAbstractPointLocator* locator, vtkPoints* queries, int N, double R)
+{
+  const vtkIdType numQueries = queries->GetNumberOfPoints();
+
+  vtkNew<vtkIdTypeArray> offsets, ids;
+  vtkNew<vtkIdList> result;
+
+  // Closest N points.
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequentialBackend([&]() {
+    locator->FindClosestNPointsBatch(N, queries, offsets, ids);
+    return BatchValues(offsets, ids);
+  }));
+  VTK_TEST_CHECK(offsets->GetNumberOfValues() == numQueries + 1);
+
+  vtkDataSet* dataSet = locator->GetDataSet();
+  for (vtkIdType i = 0; i < numQueries; ++i)
+  {
+    double x[3];
+    queries->GetPoint(i, x);
+    locator->FindClosestNPoints(N, x, result);
+    std::vector<vtkIdType> neighbors = Neighbors(offsets, ids, i);
+    VTK_TEST_CHECK(static_cast<vtkIdType>(neighbors.size()) == result->GetNumberOfIds());
+    for (vtkIdType j = 0; j < result->GetNumberOfIds(); ++j)
+    {
+      // Points at the same distance may be in any order.
+      double p[3], q[3];
+      dataSet->GetPoint(neighbors[j], p);
+      dataSet->GetPoint(result->GetId(j), q);
+      VTK_TEST_CHECK(
+        vtkMath::Distance2BetweenPoints(x, p) == vtkMath::Distance2BetweenPoints(x, q));
+    }
+  }
+
+  // Points within a radius.
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequentialBackend([&]() {
+    locator->FindPointsWithinRadiusBatch(R, queries, offsets, ids);
+    return BatchValues(offsets, ids);
+  }));
+  VTK_TEST_CHECK(offsets->GetNumberOfValues() == numQueries + 1);
+  VTK_TEST_CHECK(ids->GetNumberOfValues() > numQueries);
+
+  for (vtkIdType i = 0; i < numQueries; ++i)
+  {
+    double x[3];
+    queries->GetPoint(i, x);
+    locator->FindPointsWithinRadius(R, x, result);
+    std::vector<vtkIdType> neighbors = Neighbors(offsets, ids, i);
+    std::vector<vtkIdType> expected(result->begin(), result->end());
+    std::sort(neighbors.begin(), neighbors.end());
+    std::sort(expected.begin(), expected.end());
+    VTK_TEST_CHECK(neighbors == expected);
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestLocators()
+{
+  vtkSmartPointer<vtkPoints> queries = RandomPoints(2000, VTK_DOUBLE, -0.1, 1.1, 17);
+
+  // Float and double points are read directly by the static locator.
+  for (int dataType : { VTK_FLOAT, VTK_DOUBLE })
+  {
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(RandomPoints(20000, dataType, 0.0, 1.0, 5));
+
+    vtkNew<vtkStaticPointLocator> staticLocator;
+    staticLocator->SetDataSet(cloud);
+    VTK_TEST_CHECK(TestLocator(staticLocator, queries, 12, 0.08) == EXIT_SUCCESS);
+
+    // These locators run their batched queries serially.
+    vtkNew<vtkPointLocator> pointLocator;
+    pointLocator->SetDataSet(cloud);
+    VTK_TEST_CHECK(TestLocator(pointLocator, queries, 12, 0.08) == EXIT_SUCCESS);
+
+    vtkNew<vtkOctreePointLocator> octreeLocator;
+    octreeLocator->SetDataSet(cloud);
+    VTK_TEST_CHECK(TestLocator(octreeLocator, queries, 12, 0.08) == EXIT_SUCCESS);
+
+    vtkNew<vtkIncrementalOctreePointLocator> incrementalLocator;
+    incrementalLocator->SetDataSet(cloud);
+    VTK_TEST_CHECK(TestLocator(incrementalLocator, queries, 12, 0.08) == EXIT_SUCCESS);
+  }
+
+  // Implicit points, with more neighbors asked for than there are points.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(4, 3, 2);
+  image->SetSpacing(0.3, 0.45, 0.9);
+  vtkNew<vtkStaticPointLocator> imageLocator;
+  imageLocator->SetDataSet(image);
+  VTK_TEST_CHECK(TestLocator(imageLocator, queries, 30, 0.5) == EXIT_SUCCESS);
+
+  // No neighbors.
+  vtkNew<vtkIdTypeArray> offsets, ids;
+  imageLocator->FindClosestNPointsBatch(0, queries, offsets, ids);
+  VTK_TEST_CHECK(offsets->GetNumberOfValues() == queries->GetNumberOfPoints() + 1);
+  VTK_TEST_CHECK(offsets->GetValue(queries->GetNumberOfPoints()) == 0);
+  VTK_TEST_CHECK(ids->GetNumberOfValues() == 0);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestPointLocatorsBatch(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  return TestLocators();
+}
@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -25,9 +26,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+
 //------------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
 {
@@ -254,12 +260,11 @@ vtkIdType vtkAbstractCellLocator::FindCell(
 {
   vtkIdType returnVal = -1;
   //
-  static bool warning_shown = false;
-  if (!warning_shown)
+  static std::atomic<bool> warning_shown(false);
+  if (!warning_shown.exchange(true))
   {
     vtkWarningMacro(<< this->GetClassName() << " Does not implement FindCell"
                     << " Reverting to slow DataSet implementation");
-    warning_shown = true;
   }
   //
   if (this->DataSet)
@@ -269,6 +274,141 @@ vtkIdType vtkAbstractCellLocator::FindCell(
   return returnVal;
 }
 
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(
+  vtkPoints* points, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points ? points->GetNumberOfPoints() : 0;
+  cellIds->SetNumberOfIds(numPts);
+  if (pcoords)
+  {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numPts);
+  }
+  if (numPts < 1)
+  {
+    return;
+  }
+
+  this->BuildLocator();
+  if (!this->DataSet || this->DataSet->GetNumberOfCells() < 1)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    if (pcoords)
+    {
+      pcoords->Fill(0.0);
+    }
+    return;
+  }
+
+  // Cause non-thread safe initialization to occur before the concurrent
+  // queries.
+  const int maxCellSize = this->DataSet->GetMaxCellSize();
+  this->DataSet->GetCell(0, this->GenericCell);
+
+  vtkSMPThreadLocalObject<vtkGenericCell> localCell;
+  vtkSMPThreadLocal<std::vector<double>> localWeights;
+  auto findCells = [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = localCell.Local();
+    std::vector<double>& weights = localWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pc[3];
+    int subId;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      const vtkIdType cellId = this->FindCell(x, 0.0, cell, subId, pc, weights.data());
+      cellIds->SetId(ptId, cellId);
+      if (pcoords)
+      {
+        if (cellId < 0)
+        {
+          pc[0] = pc[1] = pc[2] = 0.0;
+        }
+        pcoords->SetTypedTuple(ptId, pc);
+      }
+    }
+  };
+  if (this->CanQueryConcurrently())
+  {
+    vtkSMPTools::For(0, numPts, findCells);
+  }
+  else
+  {
+    findCells(0, numPts);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines =
+    p1 && p2 ? std::min(p1->GetNumberOfPoints(), p2->GetNumberOfPoints()) : 0;
+  cellIds->SetNumberOfIds(numLines);
+  if (t)
+  {
+    t->SetNumberOfComponents(1);
+    t->SetNumberOfTuples(numLines);
+  }
+  if (x)
+  {
+    x->SetDataTypeToDouble();
+    x->SetNumberOfPoints(numLines);
+  }
+  if (numLines < 1)
+  {
+    return;
+  }
+
+  this->BuildLocator();
+  const bool hasCells = this->DataSet && this->DataSet->GetNumberOfCells() > 0;
+  if (hasCells)
+  {
+    // Cause non-thread safe initialization to occur before the concurrent
+    // queries.
+    this->DataSet->GetCell(0, this->GenericCell);
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> localCell;
+  auto intersectLines = [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = localCell.Local();
+    double a[3], b[3], tHit, xHit[3], pc[3];
+    int subId;
+    for (vtkIdType lineId = begin; lineId < end; ++lineId)
+    {
+      p1->GetPoint(lineId, a);
+      p2->GetPoint(lineId, b);
+      vtkIdType cellId = -1;
+      if (!hasCells || !this->IntersectWithLine(a, b, tol, tHit, xHit, pc, subId, cellId, cell))
+      {
+        cellId = -1;
+        tHit = 0.0;
+        xHit[0] = a[0];
+        xHit[1] = a[1];
+        xHit[2] = a[2];
+      }
+      cellIds->SetId(lineId, cellId);
+      if (t)
+      {
+        t->SetValue(lineId, tHit);
+      }
+      if (x)
+      {
+        x->SetPoint(lineId, xHit);
+      }
+    }
+  };
+  if (this->CanQueryConcurrently())
+  {
+    vtkSMPTools::For(0, numLines, intersectLines);
+  }
+  else
+  {
+    intersectLines(0, numLines);
+  }
+}
+
 //------------------------------------------------------------------------------
 bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
 {
@@ -46,6 +46,7 @@
 #include <vector> // For Weights
 
 class vtkCellArray;
+class vtkDoubleArray;
 class vtkGenericCell;
 class vtkIdList;
 class vtkPoints;
@@ -316,6 +317,42 @@ public:
     double pcoords[3], double* weights);
   ///@}
 
+  /**
+   * Find the cells containing the given points. cellIds is resized to the
+   * number of points, and receives the id of the cell containing each point
+   * (-1 if no cell is found). If pcoords is provided, it receives the
+   * parametric coordinates of each point in its cell, as 3 components per
+   * point. The locator is built if needed, then the points are located
+   * concurrently with FindCell(), using a zero tolerance, unless
+   * CanQueryConcurrently() is false.
+   */
+  virtual void FindCells(vtkPoints* points, vtkIdList* cellIds, vtkDoubleArray* pcoords = nullptr);
+
+  /**
+   * Intersect the lines going from the points of p1 to the points of p2
+   * with the cells. cellIds is resized to the number of lines, and receives
+   * the id of the cell intersected by each line (-1 if none), as returned by
+   * IntersectWithLine(). If provided, t receives the parametric coordinate
+   * of each intersection along its line, and x its position (0 and the
+   * first point of the line if no cell is intersected). The locator is built
+   * if needed, then the lines are intersected concurrently with
+   * IntersectWithLine(), unless CanQueryConcurrently() is false. Subclasses
+   * overriding FindCell() or IntersectWithLine() must keep them thread safe
+   * once the locator is built, or override CanQueryConcurrently().
+   */
+  virtual void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr);
+
+  /**
+   * Whether the thread safe queries of the locator, such as FindCell(),
+   * IntersectWithLine() and FindCellsAlongLine(), may be called from several
+   * threads at once after it is built. By default true; the locators whose
+   * queries are not safe to run from several threads return false. The
+   * batched queries, and the filters querying a locator given by the user,
+   * then run them in a serial loop.
+   */
+  virtual bool CanQueryConcurrently() { return true; }
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * Some locators cache cell bounds and this function can make use
@@ -16,6 +16,12 @@
 
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 //------------------------------------------------------------------------------
 vtkAbstractPointLocator::vtkAbstractPointLocator()
@@ -64,6 +70,115 @@ void vtkAbstractPointLocator::FindPointsWithinRadius(
   this->FindPointsWithinRadius(R, p, result);
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// The arguments of the single queries run by the batched queries, with a
+// result list per thread.
+struct SingleQueryData
+{
+  vtkAbstractPointLocator* Locator;
+  int N;
+  double R;
+  vtkSMPThreadLocalObject<vtkIdList> Result;
+};
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindClosestNPointsBatch(
+  int N, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids)
+{
+  SingleQueryData queryData{ this, N, 0.0, {} };
+  this->FindNeighborsBatch(
+    queries, offsets, ids,
+    [](void* data, const double x[3], std::vector<vtkIdType>& neighbors) {
+      SingleQueryData* query = static_cast<SingleQueryData*>(data);
+      vtkIdList* result = query->Result.Local();
+      query->Locator->FindClosestNPoints(query->N, x, result);
+      neighbors.insert(neighbors.end(), result->begin(), result->end());
+    },
+    &queryData);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindPointsWithinRadiusBatch(
+  double R, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids)
+{
+  SingleQueryData queryData{ this, 0, R, {} };
+  this->FindNeighborsBatch(
+    queries, offsets, ids,
+    [](void* data, const double x[3], std::vector<vtkIdType>& neighbors) {
+      SingleQueryData* query = static_cast<SingleQueryData*>(data);
+      vtkIdList* result = query->Result.Local();
+      query->Locator->FindPointsWithinRadius(query->R, x, result);
+      neighbors.insert(neighbors.end(), result->begin(), result->end());
+    },
+    &queryData);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindNeighborsBatch(vtkPoints* queries, vtkIdTypeArray* offsets,
+  vtkIdTypeArray* ids, NeighborQuery query, void* data)
+{
+  const vtkIdType numQueries = queries ? queries->GetNumberOfPoints() : 0;
+  offsets->SetNumberOfComponents(1);
+  offsets->SetNumberOfValues(numQueries + 1);
+  offsets->SetValue(0, 0);
+  ids->SetNumberOfComponents(1);
+  if (numQueries < 1)
+  {
+    ids->SetNumberOfValues(0);
+    return;
+  }
+
+  this->BuildLocator();
+
+  // The queries are processed by chunks, each gathering the neighbors of its
+  // points in its own list. The number of neighbors of each point are
+  // gathered in the offsets, then the lists are copied in query order.
+  const vtkIdType chunkSize = 1024;
+  const vtkIdType numChunks = (numQueries + chunkSize - 1) / chunkSize;
+  std::vector<std::vector<vtkIdType>> chunkIds(numChunks);
+  vtkIdType* counts = offsets->GetPointer(1);
+
+  auto gatherNeighbors = [&](vtkIdType beginChunk, vtkIdType endChunk) {
+    double x[3];
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      std::vector<vtkIdType>& neighbors = chunkIds[chunk];
+      const vtkIdType end = std::min(numQueries, (chunk + 1) * chunkSize);
+      for (vtkIdType queryId = chunk * chunkSize; queryId < end; ++queryId)
+      {
+        const size_t numNeighbors = neighbors.size();
+        queries->GetPoint(queryId, x);
+        query(data, x, neighbors);
+        counts[queryId] = static_cast<vtkIdType>(neighbors.size() - numNeighbors);
+      }
+    }
+  };
+  if (this->CanQueryConcurrently())
+  {
+    vtkSMPTools::For(0, numChunks, gatherNeighbors);
+  }
+  else
+  {
+    gatherNeighbors(0, numChunks);
+  }
+
+  vtkSMPTools::InclusiveScan(counts, counts + numQueries, counts);
+  ids->SetNumberOfValues(counts[numQueries - 1]);
+
+  const vtkIdType* chunkOffsets = offsets->GetPointer(0);
+  vtkIdType* neighborIds = ids->GetPointer(0);
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType beginChunk, vtkIdType endChunk) {
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      std::copy(chunkIds[chunk].begin(), chunkIds[chunk].end(),
+        neighborIds + chunkOffsets[chunk * chunkSize]);
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 void vtkAbstractPointLocator::GetBounds(double* bnds)
 {
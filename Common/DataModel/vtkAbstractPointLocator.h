@@ -33,7 +33,11 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkLocator.h"
 
+#include <vector> // For FindNeighborsBatch
+
 class vtkIdList;
+class vtkIdTypeArray;
+class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractPointLocator : public vtkLocator
 {
@@ -89,6 +93,34 @@ public:
   void FindPointsWithinRadius(double R, double x, double y, double z, vtkIdList* result);
   ///@}
 
+  ///@{
+  /**
+   * Batched versions of FindClosestNPoints() and FindPointsWithinRadius(),
+   * querying all the given points at once. The neighbors of the i-th query
+   * point are ids[offsets[i]] to ids[offsets[i + 1] - 1]: offsets is resized
+   * to the number of query points plus one, and ids to the total number of
+   * neighbors. The neighbors of each point are ordered as the single queries
+   * return them. The locator is built if needed, then the points are queried
+   * concurrently with vtkSMPTools, unless CanQueryConcurrently() is false.
+   * The single queries are therefore called from several threads: subclasses
+   * overriding them must keep them thread safe once the locator is built, or
+   * override CanQueryConcurrently(). The locator must not be modified during
+   * the batched queries.
+   */
+  virtual void FindClosestNPointsBatch(
+    int N, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids);
+  virtual void FindPointsWithinRadiusBatch(
+    double R, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids);
+  ///@}
+
+  /**
+   * Whether the single queries may be called from several threads at once
+   * after the locator is built. By default true; the locators whose single
+   * queries are not safe to run from several threads return false, their
+   * batched queries then running in a serial loop.
+   */
+  virtual bool CanQueryConcurrently() { return true; }
+
   ///@{
   /**
    * Provide an accessor to the bounds. Valid after the locator is built.
@@ -109,6 +141,20 @@ protected:
   vtkAbstractPointLocator();
   ~vtkAbstractPointLocator() override;
 
+  /**
+   * A query run by FindNeighborsBatch(): append the neighbors of x to
+   * neighbors. data is the pointer given to FindNeighborsBatch().
+   */
+  using NeighborQuery = void (*)(void* data, const double x[3], std::vector<vtkIdType>& neighbors);
+
+  /**
+   * Build the locator, then call query on each of the query points,
+   * concurrently if CanQueryConcurrently() is true, and gather the neighbors
+   * it appends in the offsets and ids of the batched methods, in query order.
+   */
+  void FindNeighborsBatch(vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids,
+    NeighborQuery query, void* data);
+
   double Bounds[6];          // bounds of points
   vtkIdType NumberOfBuckets; // total size of locator
 
@@ -422,6 +422,19 @@ struct ArrayList
 
   // Return the number of arrays
   vtkIdType GetNumberOfArrays() { return static_cast<vtkIdType>(Arrays.size()); }
+
+  // Whether all the arrays of the attributes can be processed by an ArrayList
+  // within threads, i.e. are data arrays other than vtkBitArray with the
+  // standard memory layout.
+  static bool CanProcessInParallel(vtkDataSetAttributes* attr);
+
+  // Copy the tuples ids[i] of the input attributes to the tuples i of the
+  // output attributes, which must have been allocated with
+  // vtkDataSetAttributes::CopyAllocate(). The tuples are copied concurrently
+  // with vtkSMPTools if CanProcessInParallel(inPD), with
+  // vtkDataSetAttributes::CopyData() otherwise.
+  static void CopyAttributes(
+    vtkDataSetAttributes* inPD, vtkDataSetAttributes* outPD, const std::vector<vtkIdType>& ids);
 };
 
 #include "vtkArrayListTemplate.txx"
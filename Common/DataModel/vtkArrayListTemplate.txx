@@ -13,7 +13,11 @@
 
 =========================================================================*/
 #include "vtkArrayListTemplate.h"
+#include "vtkDataArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
 
 #include <cassert>
 
@@ -197,4 +201,43 @@ inline void ArrayList::AddSelfInterpolatingArrays(
   }     // for each candidate array
 }
 
+//----------------------------------------------------------------------------
+inline bool ArrayList::CanProcessInParallel(vtkDataSetAttributes* attr)
+{
+  for (int i = 0; i < attr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = attr->GetArray(i);
+    if (!array || array->GetDataType() == VTK_BIT || !array->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+inline void ArrayList::CopyAttributes(
+  vtkDataSetAttributes* inPD, vtkDataSetAttributes* outPD, const std::vector<vtkIdType>& ids)
+{
+  const vtkIdType numIds = static_cast<vtkIdType>(ids.size());
+  if (ArrayList::CanProcessInParallel(inPD))
+  {
+    ArrayList arrays;
+    arrays.AddArrays(numIds, inPD, outPD, 0.0, false);
+    vtkSMPTools::For(0, numIds, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType id = begin; id < end; ++id)
+      {
+        arrays.Copy(ids[id], id);
+      }
+    });
+  }
+  else
+  {
+    vtkNew<vtkIdList> fromIds;
+    fromIds->SetNumberOfIds(numIds);
+    std::copy(ids.begin(), ids.end(), fromIds->GetPointer(0));
+    outPD->CopyData(inPD, fromIds);
+  }
+}
+
 #endif
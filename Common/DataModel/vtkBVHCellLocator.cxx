@@ -0,0 +1,1303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBVHCellLocator.h"
+
+#include "vtkBox.h"
+#include "vtkCellArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkBVHCellLocator);
+
+// Nodes of more cells are split one after the other, their cells being
+// binned and partitioned concurrently. The subtrees of the smaller nodes are
+// then built concurrently.
+#define VTK_BVH_PARALLEL_SIZE 65536
+
+// Number of lines intersected together by IntersectWithLines().
+#define VTK_BVH_PACKET_SIZE 8
+
+namespace
+{
+//------------------------------------------------------------------------------
+// A node of the tree. The children of an interior node are the nodes Index
+// and Index + 1, and the cells of a leaf are the NumberOfCells cell ids
+// starting at Index in the array of cell ids.
+struct BVHNode
+{
+  double Bounds[6];
+  vtkIdType Index;
+  int NumberOfCells; // 0 for interior nodes
+  int Axis;          // axis of the split of interior nodes
+  bool IsLeaf() const { return this->NumberOfCells > 0; }
+};
+
+//------------------------------------------------------------------------------
+// An axis-aligned box, empty until a point or a box is added.
+struct BVHBox
+{
+  double Bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+
+  void AddBounds(const double b[6])
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      this->Bounds[2 * i] = std::min(this->Bounds[2 * i], b[2 * i]);
+      this->Bounds[2 * i + 1] = std::max(this->Bounds[2 * i + 1], b[2 * i + 1]);
+    }
+  }
+  void AddPoint(const double x[3])
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      this->Bounds[2 * i] = std::min(this->Bounds[2 * i], x[i]);
+      this->Bounds[2 * i + 1] = std::max(this->Bounds[2 * i + 1], x[i]);
+    }
+  }
+  // Half the area of the box, 0 if empty.
+  double HalfArea() const
+  {
+    const double dx = this->Bounds[1] - this->Bounds[0];
+    const double dy = this->Bounds[3] - this->Bounds[2];
+    const double dz = this->Bounds[5] - this->Bounds[4];
+    return dx < 0.0 ? 0.0 : dx * dy + dy * dz + dz * dx;
+  }
+};
+
+//------------------------------------------------------------------------------
+// The cells whose centers fall in a bin along an axis.
+struct BVHBin
+{
+  BVHBox Box;
+  vtkIdType NumberOfCells = 0;
+};
+
+//------------------------------------------------------------------------------
+// Whether the line o + t / invDir, for t in [0, tMax], crosses the box
+// inflated by tol. The components of invDir are the inverses of the ones of
+// the line direction, or VTK_DOUBLE_MAX for null ones. tNear receives the
+// parameter at which the line enters the box.
+inline bool IntersectBox(const double b[6], const double o[3], const double invDir[3],
+  double tol, double tMax, double& tNear)
+{
+  double t0 = 0.0, t1 = tMax;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double tA = (b[2 * i] - tol - o[i]) * invDir[i];
+    const double tB = (b[2 * i + 1] + tol - o[i]) * invDir[i];
+    t0 = std::max(t0, std::min(tA, tB));
+    t1 = std::min(t1, std::max(tA, tB));
+  }
+  tNear = t0;
+  return t0 <= t1;
+}
+
+//------------------------------------------------------------------------------
+inline void InverseDirection(const double p1[3], const double p2[3], double invDir[3])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    const double d = p2[i] - p1[i];
+    invDir[i] = d != 0.0 ? 1.0 / d : VTK_DOUBLE_MAX;
+  }
+}
+
+//------------------------------------------------------------------------------
+inline double Distance2ToBounds(const double x[3], const double b[6])
+{
+  double d2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double d = std::max(std::max(b[2 * i] - x[i], x[i] - b[2 * i + 1]), 0.0);
+    d2 += d * d;
+  }
+  return d2;
+}
+
+//------------------------------------------------------------------------------
+inline bool OverlapBounds(const double a[6], const double b[6])
+{
+  return a[0] <= b[1] && b[0] <= a[1] && a[2] <= b[3] && b[2] <= a[3] && a[4] <= b[5] &&
+    b[4] <= a[5];
+}
+
+//------------------------------------------------------------------------------
+// Whether the plane of origin o and normal n crosses the bounds.
+inline bool IntersectPlane(const double b[6], const double o[3], const double n[3])
+{
+  double center = 0.0, radius = 0.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    center += n[i] * (0.5 * (b[2 * i] + b[2 * i + 1]) - o[i]);
+    radius += std::abs(n[i]) * 0.5 * (b[2 * i + 1] - b[2 * i]);
+  }
+  return std::abs(center) <= radius;
+}
+
+//------------------------------------------------------------------------------
+// Builds the tree top-down. At each node, the cell centers are binned along
+// the three axes, and the node is split between the two bins minimizing the
+// surface area heuristic. The cell ids of a node are partitioned in place,
+// so that the cells of each leaf are contiguous.
+struct BVHBuilder
+{
+  const double* CellBounds; // 6 per cell
+  std::vector<double> Centers;
+  vtkIdType* CellIds;
+  int NumberOfBins;
+  int LeafSize;
+
+  // A node to split, with its range of cell ids.
+  struct Range
+  {
+    vtkIdType Node;
+    vtkIdType Begin;
+    vtkIdType End;
+  };
+
+  BVHBuilder(const double* cellBounds, vtkIdType numCells, vtkIdType* cellIds, int numberOfBins,
+    int leafSize)
+    : CellBounds(cellBounds)
+    , Centers(3 * numCells)
+    , CellIds(cellIds)
+    , NumberOfBins(numberOfBins)
+    , LeafSize(leafSize)
+  {
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const double* b = this->CellBounds + 6 * cellId;
+        double* c = this->Centers.data() + 3 * cellId;
+        c[0] = 0.5 * (b[0] + b[1]);
+        c[1] = 0.5 * (b[2] + b[3]);
+        c[2] = 0.5 * (b[4] + b[5]);
+        this->CellIds[cellId] = cellId;
+      }
+    });
+  }
+
+  int GetBin(double c, double min, double scale) const
+  {
+    return std::min(static_cast<int>((c - min) * scale), this->NumberOfBins - 1);
+  }
+
+  // The bounds of the cells of the range and of their centers.
+  void ComputeBounds(const Range& range, bool parallel, BVHBox& bounds, BVHBox& centers) const
+  {
+    auto add = [this](vtkIdType begin, vtkIdType end, BVHBox& b, BVHBox& c) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const vtkIdType cellId = this->CellIds[i];
+        b.AddBounds(this->CellBounds + 6 * cellId);
+        c.AddPoint(this->Centers.data() + 3 * cellId);
+      }
+    };
+    if (!parallel)
+    {
+      add(range.Begin, range.End, bounds, centers);
+      return;
+    }
+    vtkSMPThreadLocal<std::array<BVHBox, 2>> localBoxes;
+    vtkSMPTools::For(range.Begin, range.End, [&](vtkIdType begin, vtkIdType end) {
+      std::array<BVHBox, 2>& boxes = localBoxes.Local();
+      add(begin, end, boxes[0], boxes[1]);
+    });
+    for (const auto& boxes : localBoxes)
+    {
+      bounds.AddBounds(boxes[0].Bounds);
+      centers.AddBounds(boxes[1].Bounds);
+    }
+  }
+
+  // Sorts the cells of the range into the bins of the three axes. The bins
+  // of axis i are bins[i * NumberOfBins, (i + 1) * NumberOfBins).
+  void FillBins(const Range& range, bool parallel, const double min[3], const double scale[3],
+    std::vector<BVHBin>& bins) const
+  {
+    const int nb = this->NumberOfBins;
+    auto fill = [&](vtkIdType begin, vtkIdType end, std::vector<BVHBin>& b) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const vtkIdType cellId = this->CellIds[i];
+        const double* c = this->Centers.data() + 3 * cellId;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          BVHBin& bin = b[axis * nb + this->GetBin(c[axis], min[axis], scale[axis])];
+          bin.Box.AddBounds(this->CellBounds + 6 * cellId);
+          ++bin.NumberOfCells;
+        }
+      }
+    };
+    bins.assign(3 * nb, BVHBin());
+    if (!parallel)
+    {
+      fill(range.Begin, range.End, bins);
+      return;
+    }
+    // Counts and bounds are combined exactly, whatever the number of threads.
+    vtkSMPThreadLocal<std::vector<BVHBin>> localBins;
+    vtkSMPTools::For(range.Begin, range.End, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<BVHBin>& b = localBins.Local();
+      b.resize(3 * nb);
+      fill(begin, end, b);
+    });
+    for (const auto& b : localBins)
+    {
+      for (size_t i = 0; i < b.size(); ++i)
+      {
+        bins[i].Box.AddBounds(b[i].Box.Bounds);
+        bins[i].NumberOfCells += b[i].NumberOfCells;
+      }
+    }
+  }
+
+  // Moves the cells of the range for which pred holds before the others,
+  // and returns the first of the others. Large ranges are partitioned by
+  // chunks, concurrently, keeping the order of the cells.
+  template <typename TPredicate>
+  vtkIdType Partition(const Range& range, bool parallel, TPredicate pred) const
+  {
+    vtkIdType* ids = this->CellIds + range.Begin;
+    const vtkIdType n = range.End - range.Begin;
+    if (!parallel)
+    {
+      return range.Begin + (std::partition(ids, ids + n, pred) - ids);
+    }
+
+    const vtkIdType chunkSize = 8192;
+    const vtkIdType numChunks = (n + chunkSize - 1) / chunkSize;
+    std::vector<vtkIdType> leftOffsets(numChunks + 1, 0);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+        const vtkIdType* first = ids + chunk * chunkSize;
+        const vtkIdType* last = ids + std::min(n, (chunk + 1) * chunkSize);
+        leftOffsets[chunk + 1] = std::count_if(first, last, pred);
+      }
+    });
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+      leftOffsets[chunk + 1] += leftOffsets[chunk];
+    }
+    const vtkIdType numLeft = leftOffsets[numChunks];
+
+    std::vector<vtkIdType> partitioned(n);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType chunk = begin; chunk < end; ++chunk)
+      {
+        vtkIdType left = leftOffsets[chunk];
+        vtkIdType right = numLeft + chunk * chunkSize - leftOffsets[chunk];
+        const vtkIdType last = std::min(n, (chunk + 1) * chunkSize);
+        for (vtkIdType i = chunk * chunkSize; i < last; ++i)
+        {
+          partitioned[pred(ids[i]) ? left++ : right++] = ids[i];
+        }
+      }
+    });
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+      std::copy(partitioned.begin() + begin, partitioned.begin() + end, ids + begin);
+    });
+    return range.Begin + numLeft;
+  }
+
+  // Sets the bounds of the node of the range, and makes it a leaf or splits
+  // it. The ranges of the children of a split node are pushed on the stack.
+  void SplitNode(
+    const Range& range, bool parallel, std::vector<BVHNode>& nodes, std::vector<Range>& stack) const
+  {
+    BVHBox bounds, centers;
+    this->ComputeBounds(range, parallel, bounds, centers);
+    std::copy_n(bounds.Bounds, 6, nodes[range.Node].Bounds);
+
+    const vtkIdType numCells = range.End - range.Begin;
+    if (numCells <= this->LeafSize)
+    {
+      nodes[range.Node].Index = range.Begin;
+      nodes[range.Node].NumberOfCells = static_cast<int>(numCells);
+      nodes[range.Node].Axis = 0;
+      return;
+    }
+
+    // Evaluate the cost of the splits between the bins of each axis: the
+    // areas of the children boxes weighted by their numbers of cells.
+    const int nb = this->NumberOfBins;
+    double min[3], scale[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      min[axis] = centers.Bounds[2 * axis];
+      const double extent = centers.Bounds[2 * axis + 1] - centers.Bounds[2 * axis];
+      scale[axis] = extent > 0.0 ? nb / extent : 0.0;
+    }
+    std::vector<BVHBin> bins;
+    this->FillBins(range, parallel, min, scale, bins);
+
+    int bestAxis = -1, bestBin = 0;
+    double bestCost = VTK_DOUBLE_MAX;
+    std::vector<double> rightCosts(nb);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (scale[axis] == 0.0)
+      {
+        continue;
+      }
+      const BVHBin* axisBins = bins.data() + axis * nb;
+      BVHBox right;
+      vtkIdType numRight = 0;
+      for (int i = nb - 1; i > 0; --i)
+      {
+        right.AddBounds(axisBins[i].Box.Bounds);
+        numRight += axisBins[i].NumberOfCells;
+        rightCosts[i] = numRight > 0 ? numRight * right.HalfArea() : -1.0;
+      }
+      BVHBox left;
+      vtkIdType numLeft = 0;
+      for (int i = 0; i < nb - 1; ++i)
+      {
+        left.AddBounds(axisBins[i].Box.Bounds);
+        numLeft += axisBins[i].NumberOfCells;
+        if (numLeft < 1 || rightCosts[i + 1] < 0.0)
+        {
+          continue;
+        }
+        const double cost = numLeft * left.HalfArea() + rightCosts[i + 1];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = axis;
+          bestBin = i;
+        }
+      }
+    }
+
+    vtkIdType middle;
+    if (bestAxis >= 0)
+    {
+      const double axisMin = min[bestAxis];
+      const double axisScale = scale[bestAxis];
+      middle = this->Partition(range, parallel, [&](vtkIdType cellId) {
+        return this->GetBin(this->Centers[3 * cellId + bestAxis], axisMin, axisScale) <= bestBin;
+      });
+    }
+    else
+    {
+      // All the cell centers are the same: split the cells in two halves.
+      middle = range.Begin + numCells / 2;
+      bestAxis = 0;
+    }
+
+    const auto children = static_cast<vtkIdType>(nodes.size());
+    nodes.resize(nodes.size() + 2);
+    nodes[range.Node].Index = children;
+    nodes[range.Node].NumberOfCells = 0;
+    nodes[range.Node].Axis = bestAxis;
+    stack.push_back({ children + 1, middle, range.End });
+    stack.push_back({ children, range.Begin, middle });
+  }
+
+  // Builds the tree of the given number of cells, the large nodes one after
+  // the other, then the subtrees of the smaller ones concurrently.
+  void Build(vtkIdType numCells, std::vector<BVHNode>& nodes) const
+  {
+    nodes.assign(1, BVHNode());
+    std::vector<Range> stack{ { 0, 0, numCells } };
+    std::vector<Range> subtrees;
+    while (!stack.empty())
+    {
+      const Range range = stack.back();
+      stack.pop_back();
+      if (range.End - range.Begin <= VTK_BVH_PARALLEL_SIZE)
+      {
+        subtrees.push_back(range);
+      }
+      else
+      {
+        this->SplitNode(range, true, nodes, stack);
+      }
+    }
+
+    // Each subtree is built in its own array, its root being its first node.
+    const auto numSubtrees = static_cast<vtkIdType>(subtrees.size());
+    std::vector<std::vector<BVHNode>> subtreeNodes(numSubtrees);
+    vtkSMPTools::For(0, numSubtrees, 1, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<Range> subtreeStack;
+      for (vtkIdType subtree = begin; subtree < end; ++subtree)
+      {
+        std::vector<BVHNode>& local = subtreeNodes[subtree];
+        local.resize(1);
+        subtreeStack.push_back({ 0, subtrees[subtree].Begin, subtrees[subtree].End });
+        while (!subtreeStack.empty())
+        {
+          const Range range = subtreeStack.back();
+          subtreeStack.pop_back();
+          this->SplitNode(range, false, local, subtreeStack);
+        }
+      }
+    });
+
+    // Append the subtrees to the nodes, their roots replacing the nodes they
+    // were built for.
+    std::vector<vtkIdType> offsets(numSubtrees + 1);
+    offsets[0] = static_cast<vtkIdType>(nodes.size());
+    for (vtkIdType subtree = 0; subtree < numSubtrees; ++subtree)
+    {
+      offsets[subtree + 1] =
+        offsets[subtree] + static_cast<vtkIdType>(subtreeNodes[subtree].size()) - 1;
+    }
+    nodes.resize(offsets[numSubtrees]);
+    vtkSMPTools::For(0, numSubtrees, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType subtree = begin; subtree < end; ++subtree)
+      {
+        std::vector<BVHNode>& local = subtreeNodes[subtree];
+        const vtkIdType shift = offsets[subtree] - 1;
+        for (size_t i = 0; i < local.size(); ++i)
+        {
+          BVHNode node = local[i];
+          if (!node.IsLeaf())
+          {
+            node.Index += shift;
+          }
+          nodes[i == 0 ? subtrees[subtree].Node : shift + static_cast<vtkIdType>(i)] = node;
+        }
+        std::vector<BVHNode>().swap(local);
+      }
+    });
+  }
+};
+
+//------------------------------------------------------------------------------
+// A packet of lines traversing the tree together. The lines are stored
+// component by component, so that a box is tested against all of them in
+// loops the compiler can vectorize. TMax is the parameter beyond which the
+// intersections of each line are not searched anymore, negative for the
+// unused lines of the last packet.
+struct BVHLinePacket
+{
+  static constexpr int Size = VTK_BVH_PACKET_SIZE;
+  double Origin[3][Size];
+  double InvDir[3][Size];
+  double TMax[Size];
+
+  // Whether any line crosses the box inflated by tol, hit receiving the
+  // result for each line.
+  bool IntersectBox(const double b[6], double tol, unsigned char hit[Size]) const
+  {
+    double t0[Size], t1[Size];
+    for (int l = 0; l < Size; ++l)
+    {
+      t0[l] = 0.0;
+      t1[l] = this->TMax[l];
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      const double lo = b[2 * i] - tol;
+      const double hi = b[2 * i + 1] + tol;
+      for (int l = 0; l < Size; ++l)
+      {
+        const double tA = (lo - this->Origin[i][l]) * this->InvDir[i][l];
+        const double tB = (hi - this->Origin[i][l]) * this->InvDir[i][l];
+        t0[l] = std::max(t0[l], std::min(tA, tB));
+        t1[l] = std::min(t1[l], std::max(tA, tB));
+      }
+    }
+    unsigned char any = 0;
+    for (int l = 0; l < Size; ++l)
+    {
+      hit[l] = t0[l] <= t1[l];
+      any |= hit[l];
+    }
+    return any != 0;
+  }
+};
+
+//------------------------------------------------------------------------------
+struct BVHIntersection
+{
+  vtkIdType CellId;
+  double T;
+  double X[3];
+};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+struct vtkBVHCellLocator::vtkBVH
+{
+  vtkDataSet* DataSet = nullptr;
+  // The cached cell bounds, shared with the locator, if any.
+  std::shared_ptr<std::vector<double>> CellBoundsSharedPtr;
+  const double* CellBounds = nullptr;
+  int MaxCellSize = 0;
+  std::vector<BVHNode> Nodes;
+  std::vector<vtkIdType> CellIds;
+
+  const double* GetCellBounds(vtkIdType cellId, double bounds[6]) const
+  {
+    if (this->CellBounds)
+    {
+      return this->CellBounds + 6 * cellId;
+    }
+    this->DataSet->GetCellBounds(cellId, bounds);
+    return bounds;
+  }
+
+  // Children of an interior node in the order they are crossed by a line of
+  // direction dir.
+  void GetOrderedChildren(const BVHNode& node, double dir, vtkIdType& nearChild,
+    vtkIdType& farChild) const
+  {
+    nearChild = dir >= 0.0 ? node.Index : node.Index + 1;
+    farChild = dir >= 0.0 ? node.Index + 1 : node.Index;
+  }
+
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) const;
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, vtkPoints* points,
+    vtkIdList* cellIds, vtkGenericCell* cell) const;
+  void IntersectPacket(const double* p1, const double* p2, int numLines, double tol,
+    vtkIdType* cellIds, double* t, double* x, vtkGenericCell* cell,
+    std::vector<vtkIdType>& stack) const;
+  vtkIdType FindClosestPointWithinRadius(const double x[3], double radius, double closestPoint[3],
+    vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2, int& inside) const;
+  void FindCellsWithinBounds(const double bbox[6], vtkIdList* cells) const;
+  void FindCellsAlongPlane(const double o[3], const double n[3], vtkIdList* cells) const;
+  vtkIdType FindCell(const double pos[3], vtkGenericCell* cell, int& subId, double pcoords[3],
+    double* weights) const;
+};
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::vtkBVH::IntersectWithLine(const double p1[3], const double p2[3],
+  double tol, double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId,
+  vtkGenericCell* cell) const
+{
+  double invDir[3], tNear, cellBounds[6], tHit, xHit[3], pcoordsHit[3];
+  double tBest = VTK_DOUBLE_MAX;
+  int subIdHit;
+  vtkIdType cellIdBest = -1;
+  InverseDirection(p1, p2, invDir);
+
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!::IntersectBox(node.Bounds, p1, invDir, tol, std::min(1.0, tBest), tNear))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      vtkIdType nearChild, farChild;
+      this->GetOrderedChildren(node, p2[node.Axis] - p1[node.Axis], nearChild, farChild);
+      stack.push_back(farChild);
+      stack.push_back(nearChild);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (!::IntersectBox(this->GetCellBounds(cId, cellBounds), p1, invDir, tol,
+            std::min(1.0, tBest), tNear))
+      {
+        continue;
+      }
+      this->DataSet->GetCell(cId, cell);
+      if (cell->IntersectWithLine(p1, p2, tol, tHit, xHit, pcoordsHit, subIdHit) &&
+        (tHit < tBest || (tHit == tBest && cId < cellIdBest)))
+      {
+        tBest = tHit;
+        cellIdBest = cId;
+        std::copy_n(xHit, 3, x);
+        std::copy_n(pcoordsHit, 3, pcoords);
+        subId = subIdHit;
+      }
+    }
+  }
+
+  cellId = cellIdBest;
+  if (cellIdBest < 0)
+  {
+    return 0;
+  }
+  this->DataSet->GetCell(cellIdBest, cell);
+  t = tBest;
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::vtkBVH::IntersectWithLine(const double p1[3], const double p2[3],
+  double tol, vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell) const
+{
+  if (points)
+  {
+    points->Reset();
+  }
+  if (cellIds)
+  {
+    cellIds->Reset();
+  }
+  double invDir[3], dir[3], tNear, cellBounds[6], pcoords[3];
+  int subId;
+  InverseDirection(p1, p2, invDir);
+  dir[0] = p2[0] - p1[0];
+  dir[1] = p2[1] - p1[1];
+  dir[2] = p2[2] - p1[2];
+
+  std::vector<BVHIntersection> intersections;
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!::IntersectBox(node.Bounds, p1, invDir, tol, 1.0, tNear))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      stack.push_back(node.Index + 1);
+      stack.push_back(node.Index);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      const double* bounds = this->GetCellBounds(cId, cellBounds);
+      if (!::IntersectBox(bounds, p1, invDir, tol, 1.0, tNear))
+      {
+        continue;
+      }
+      BVHIntersection intersection;
+      intersection.CellId = cId;
+      if (cell)
+      {
+        this->DataSet->GetCell(cId, cell);
+        if (cell->IntersectWithLine(
+              p1, p2, tol, intersection.T, intersection.X, pcoords, subId))
+        {
+          intersections.push_back(intersection);
+        }
+      }
+      else if (vtkBox::IntersectBox(bounds, p1, dir, intersection.X, intersection.T, tol))
+      {
+        intersections.push_back(intersection);
+      }
+    }
+  }
+  if (intersections.empty())
+  {
+    return 0;
+  }
+
+  std::sort(intersections.begin(), intersections.end(),
+    [](const BVHIntersection& a, const BVHIntersection& b) {
+      return a.T < b.T || (a.T == b.T && a.CellId < b.CellId);
+    });
+  const auto numIntersections = static_cast<vtkIdType>(intersections.size());
+  if (points)
+  {
+    points->SetNumberOfPoints(numIntersections);
+    for (vtkIdType i = 0; i < numIntersections; ++i)
+    {
+      points->SetPoint(i, intersections[i].X);
+    }
+  }
+  if (cellIds)
+  {
+    cellIds->SetNumberOfIds(numIntersections);
+    for (vtkIdType i = 0; i < numIntersections; ++i)
+    {
+      cellIds->SetId(i, intersections[i].CellId);
+    }
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// Intersects up to VTK_BVH_PACKET_SIZE lines, whose end points are stored
+// one after the other in p1 and p2, the results being stored the same way.
+// A node is visited if any line of the packet crosses it, and its cells are
+// intersected with the lines crossing their bounds. The selection of the
+// closest cells is the one of IntersectWithLine(), so that each line gets
+// the same cell.
+void vtkBVHCellLocator::vtkBVH::IntersectPacket(const double* p1, const double* p2,
+  int numLines, double tol, vtkIdType* cellIds, double* t, double* x, vtkGenericCell* cell,
+  std::vector<vtkIdType>& stack) const
+{
+  constexpr int size = BVHLinePacket::Size;
+  BVHLinePacket packet;
+  double dir[3][size];
+  for (int l = 0; l < size; ++l)
+  {
+    // The unused lines are copies of the first one that never hit anything.
+    const int line = l < numLines ? l : 0;
+    double invDir[3];
+    InverseDirection(p1 + 3 * line, p2 + 3 * line, invDir);
+    for (int i = 0; i < 3; ++i)
+    {
+      packet.Origin[i][l] = p1[3 * line + i];
+      packet.InvDir[i][l] = invDir[i];
+      dir[i][l] = p2[3 * line + i] - p1[3 * line + i];
+    }
+    packet.TMax[l] = l < numLines ? 1.0 : -1.0;
+  }
+
+  double tBest[size], cellBounds[6], tHit, xHit[3], pcoords[3];
+  int subId;
+  unsigned char hit[size];
+  for (int l = 0; l < numLines; ++l)
+  {
+    tBest[l] = VTK_DOUBLE_MAX;
+    cellIds[l] = -1;
+  }
+
+  stack.assign(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!packet.IntersectBox(node.Bounds, tol, hit))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      // The children are ordered along the first line crossing the node.
+      int first = 0;
+      while (!hit[first])
+      {
+        ++first;
+      }
+      vtkIdType nearChild, farChild;
+      this->GetOrderedChildren(node, dir[node.Axis][first], nearChild, farChild);
+      stack.push_back(farChild);
+      stack.push_back(nearChild);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (!packet.IntersectBox(this->GetCellBounds(cId, cellBounds), tol, hit))
+      {
+        continue;
+      }
+      this->DataSet->GetCell(cId, cell);
+      for (int l = 0; l < numLines; ++l)
+      {
+        if (hit[l] &&
+          cell->IntersectWithLine(p1 + 3 * l, p2 + 3 * l, tol, tHit, xHit, pcoords, subId) &&
+          (tHit < tBest[l] || (tHit == tBest[l] && cId < cellIds[l])))
+        {
+          tBest[l] = tHit;
+          packet.TMax[l] = std::min(1.0, tHit);
+          cellIds[l] = cId;
+          std::copy_n(xHit, 3, x + 3 * l);
+        }
+      }
+    }
+  }
+
+  for (int l = 0; l < numLines; ++l)
+  {
+    if (cellIds[l] < 0)
+    {
+      t[l] = 0.0;
+      std::copy_n(p1 + 3 * l, 3, x + 3 * l);
+    }
+    else
+    {
+      t[l] = tBest[l];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::vtkBVH::FindClosestPointWithinRadius(const double x[3],
+  double radius, double closestPoint[3], vtkGenericCell* cell, vtkIdType& cellId, int& subId,
+  double& dist2, int& inside) const
+{
+  std::vector<double> weights(this->MaxCellSize);
+  double cellBounds[6], point[3], pcoords[3], d2;
+  int stat, pointSubId;
+  vtkIdType found = 0;
+  dist2 = radius * radius;
+
+  // The nearest child is visited first, so that the farthest nodes are
+  // rejected once a close point is found.
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (Distance2ToBounds(x, node.Bounds) > dist2)
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      const double d0 = Distance2ToBounds(x, this->Nodes[node.Index].Bounds);
+      const double d1 = Distance2ToBounds(x, this->Nodes[node.Index + 1].Bounds);
+      stack.push_back(d0 <= d1 ? node.Index + 1 : node.Index);
+      stack.push_back(d0 <= d1 ? node.Index : node.Index + 1);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (Distance2ToBounds(x, this->GetCellBounds(cId, cellBounds)) > dist2)
+      {
+        continue;
+      }
+      this->DataSet->GetCell(cId, cell);
+      // stat == -1 is a numerical error, 0 means outside and 1 inside.
+      stat = cell->EvaluatePosition(x, point, pointSubId, pcoords, d2, weights.data());
+      if (stat != -1 && (d2 < dist2 || (found && d2 == dist2 && cId < cellId)))
+      {
+        found = 1;
+        inside = stat;
+        dist2 = d2;
+        cellId = cId;
+        subId = pointSubId;
+        std::copy_n(point, 3, closestPoint);
+      }
+    }
+  }
+  if (found)
+  {
+    this->DataSet->GetCell(cellId, cell);
+  }
+  return found;
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::vtkBVH::FindCellsWithinBounds(const double bbox[6], vtkIdList* cells) const
+{
+  double cellBounds[6];
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!OverlapBounds(node.Bounds, bbox))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      stack.push_back(node.Index + 1);
+      stack.push_back(node.Index);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (OverlapBounds(this->GetCellBounds(cId, cellBounds), bbox))
+      {
+        cells->InsertNextId(cId);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::vtkBVH::FindCellsAlongPlane(
+  const double o[3], const double n[3], vtkIdList* cells) const
+{
+  double cellBounds[6];
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!IntersectPlane(node.Bounds, o, n))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      stack.push_back(node.Index + 1);
+      stack.push_back(node.Index);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (IntersectPlane(this->GetCellBounds(cId, cellBounds), o, n))
+      {
+        cells->InsertNextId(cId);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::vtkBVH::FindCell(const double pos[3], vtkGenericCell* cell,
+  int& subId, double pcoords[3], double* weights) const
+{
+  double cellBounds[6], dist2;
+  std::vector<vtkIdType> stack(1, 0);
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!vtkAbstractCellLocator::IsInBounds(node.Bounds, pos))
+    {
+      continue;
+    }
+    if (!node.IsLeaf())
+    {
+      stack.push_back(node.Index + 1);
+      stack.push_back(node.Index);
+      continue;
+    }
+    for (int i = 0; i < node.NumberOfCells; ++i)
+    {
+      const vtkIdType cId = this->CellIds[node.Index + i];
+      if (vtkAbstractCellLocator::IsInBounds(this->GetCellBounds(cId, cellBounds), pos))
+      {
+        this->DataSet->GetCell(cId, cell);
+        if (cell->EvaluatePosition(pos, nullptr, subId, pcoords, dist2, weights) == 1)
+        {
+          return cId;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+vtkBVHCellLocator::vtkBVHCellLocator()
+{
+  this->NumberOfCellsPerNode = 8;
+  this->NumberOfBins = 16;
+}
+
+//------------------------------------------------------------------------------
+vtkBVHCellLocator::~vtkBVHCellLocator()
+{
+  this->FreeSearchStructure();
+  this->FreeCellBounds();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::FreeSearchStructure()
+{
+  this->Tree.reset();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocator()
+{
+  // don't rebuild if build time is newer than modified and dataset modified time
+  if (this->Tree && this->BuildTime > this->MTime && this->BuildTime > this->DataSet->GetMTime())
+  {
+    return;
+  }
+  // don't rebuild if UseExistingSearchStructure is ON and a search structure already exists
+  if (this->Tree && this->UseExistingSearchStructure)
+  {
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
+    return;
+  }
+  this->BuildLocatorInternal();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::ForceBuildLocator()
+{
+  this->BuildLocatorInternal();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocatorInternal()
+{
+  vtkIdType numCells;
+  if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1)
+  {
+    vtkErrorMacro(<< " No Cells in the data set\n");
+    return;
+  }
+  this->FreeSearchStructure();
+  this->ComputeCellBounds();
+
+  auto tree = std::make_shared<vtkBVH>();
+  tree->DataSet = this->DataSet;
+  tree->CellBoundsSharedPtr = this->CellBoundsSharedPtr;
+  tree->CellBounds = this->CellBounds;
+  tree->MaxCellSize = this->DataSet->GetMaxCellSize();
+
+  // The builder needs the bounds of all the cells. They are gathered
+  // concurrently if not cached, the first call to GetCellBounds() causing
+  // the non-thread safe initialization to occur.
+  std::vector<double> cellBounds;
+  if (!this->CellBounds)
+  {
+    cellBounds.resize(6 * numCells);
+    this->DataSet->GetCellBounds(0, cellBounds.data());
+    vtkSMPTools::For(1, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->DataSet->GetCellBounds(cellId, cellBounds.data() + 6 * cellId);
+      }
+    });
+  }
+
+  tree->CellIds.resize(numCells);
+  BVHBuilder builder(this->CellBounds ? this->CellBounds : cellBounds.data(), numCells,
+    tree->CellIds.data(), this->NumberOfBins, this->NumberOfCellsPerNode);
+  builder.Build(numCells, tree->Nodes);
+
+  this->Tree = tree;
+  this->BuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    cellId = -1;
+    return 0;
+  }
+  return this->Tree->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, cell);
+}
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return 0;
+  }
+  return this->Tree->IntersectWithLine(p1, p2, tol, points, cellIds, cell);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines =
+    p1 && p2 ? std::min(p1->GetNumberOfPoints(), p2->GetNumberOfPoints()) : 0;
+  if (numLines > 0)
+  {
+    this->BuildLocator();
+  }
+  if (!this->Tree)
+  {
+    this->Superclass::IntersectWithLines(p1, p2, tol, cellIds, t, x);
+    return;
+  }
+  cellIds->SetNumberOfIds(numLines);
+  if (t)
+  {
+    t->SetNumberOfComponents(1);
+    t->SetNumberOfTuples(numLines);
+  }
+  if (x)
+  {
+    x->SetDataTypeToDouble();
+    x->SetNumberOfPoints(numLines);
+  }
+
+  // Cause non-thread safe initialization to occur before the concurrent
+  // queries.
+  this->DataSet->GetCell(0, this->GenericCell);
+
+  const vtkBVH* tree = this->Tree.get();
+  constexpr int size = VTK_BVH_PACKET_SIZE;
+  const vtkIdType numPackets = (numLines + size - 1) / size;
+  vtkSMPThreadLocalObject<vtkGenericCell> localCell;
+  vtkSMPTools::For(0, numPackets, [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = localCell.Local();
+    std::vector<vtkIdType> stack;
+    double a[3 * size], b[3 * size], tHit[size], xHit[3 * size];
+    vtkIdType cellIdHit[size];
+    for (vtkIdType packet = begin; packet < end; ++packet)
+    {
+      const vtkIdType first = packet * size;
+      const int numPacketLines = static_cast<int>(std::min<vtkIdType>(size, numLines - first));
+      for (int l = 0; l < numPacketLines; ++l)
+      {
+        p1->GetPoint(first + l, a + 3 * l);
+        p2->GetPoint(first + l, b + 3 * l);
+      }
+      tree->IntersectPacket(a, b, numPacketLines, tol, cellIdHit, tHit, xHit, cell, stack);
+      for (int l = 0; l < numPacketLines; ++l)
+      {
+        cellIds->SetId(first + l, cellIdHit[l]);
+        if (t)
+        {
+          t->SetValue(first + l, tHit[l]);
+        }
+        if (x)
+        {
+          x->SetPoint(first + l, xHit + 3 * l);
+        }
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindClosestPointWithinRadius(double x[3], double radius,
+  double closestPoint[3], vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2,
+  int& inside)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return 0;
+  }
+  return this->Tree->FindClosestPointWithinRadius(
+    x, radius, closestPoint, cell, cellId, subId, dist2, inside);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::FindCellsWithinBounds(double* bbox, vtkIdList* cells)
+{
+  cells->Reset();
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return;
+  }
+  this->Tree->FindCellsWithinBounds(bbox, cells);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::FindCellsAlongPlane(
+  const double o[3], const double n[3], double vtkNotUsed(tolerance), vtkIdList* cells)
+{
+  if (!cells)
+  {
+    return;
+  }
+  cells->Reset();
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return;
+  }
+  this->Tree->FindCellsAlongPlane(o, n, cells);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindCell(
+  double x[3], double, vtkGenericCell* cell, int& subId, double pcoords[3], double* weights)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return -1;
+  }
+  return this->Tree->FindCell(x, cell, subId, pcoords, weights);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::GenerateRepresentation(int level, vtkPolyData* pd)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return;
+  }
+
+  vtkNew<vtkPoints> pts;
+  vtkNew<vtkCellArray> lines;
+  pd->SetPoints(pts);
+  pd->SetLines(lines);
+
+  static const int edges[12][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, { 0, 2 }, { 1, 3 },
+    { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+  std::vector<std::pair<vtkIdType, int>> stack(1, std::make_pair(0, 0));
+  while (!stack.empty())
+  {
+    const BVHNode& node = this->Tree->Nodes[stack.back().first];
+    const int depth = stack.back().second;
+    stack.pop_back();
+    if (depth == level || (level < 0 && node.IsLeaf()))
+    {
+      vtkIdType ids[8];
+      for (int i = 0; i < 8; ++i)
+      {
+        ids[i] = pts->InsertNextPoint(
+          node.Bounds[i & 1], node.Bounds[2 + ((i >> 1) & 1)], node.Bounds[4 + ((i >> 2) & 1)]);
+      }
+      for (const auto& edge : edges)
+      {
+        const vtkIdType line[2] = { ids[edge[0]], ids[edge[1]] };
+        lines->InsertNextCell(2, line);
+      }
+    }
+    else if (!node.IsLeaf())
+    {
+      stack.emplace_back(node.Index + 1, depth + 1);
+      stack.emplace_back(node.Index, depth + 1);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::ShallowCopy(vtkAbstractCellLocator* locator)
+{
+  vtkBVHCellLocator* cellLocator = vtkBVHCellLocator::SafeDownCast(locator);
+  if (!cellLocator)
+  {
+    vtkErrorMacro("Cannot cast " << locator->GetClassName() << " to vtkBVHCellLocator.");
+    return;
+  }
+  // we only copy what's actually used by vtkBVHCellLocator
+
+  // vtkLocator parameters
+  this->SetDataSet(cellLocator->GetDataSet());
+  this->SetUseExistingSearchStructure(cellLocator->GetUseExistingSearchStructure());
+
+  // vtkAbstractCellLocator parameters
+  this->SetNumberOfCellsPerNode(cellLocator->GetNumberOfCellsPerNode());
+  this->CacheCellBounds = cellLocator->CacheCellBounds;
+  this->CellBoundsSharedPtr = cellLocator->CellBoundsSharedPtr; // This is important
+  this->CellBounds = this->CellBoundsSharedPtr.get() ? this->CellBoundsSharedPtr->data() : nullptr;
+
+  // vtkBVHCellLocator parameters
+  this->NumberOfBins = cellLocator->NumberOfBins;
+  this->Tree = cellLocator->Tree;
+  this->BuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfBins: " << this->NumberOfBins << "\n";
+  os << indent << "NumberOfNodes: " << (this->Tree ? this->Tree->Nodes.size() : 0) << "\n";
+}
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <array>
 #include <iterator>
+#include <limits>
 
 namespace
 {
@@ -1231,3 +1232,51 @@ vtkIdType vtkCellArray::IsHomogeneous()
 {
   return this->Visit(IsHomogeneousImpl{});
 }
+
+namespace vtkCellArray_detail
+{
+namespace
+{
+template <typename ValueType>
+vtkIdType ScanCellSizesImpl(ValueType* offsets, vtkIdType numCells)
+{
+  // Sum the sizes in vtkIdType first, so that the offsets are computed only
+  // if they fit in the storage.
+  const vtkIdType connectivitySize = vtkSMPTools::TransformReduce(offsets + 1,
+    offsets + numCells + 1, vtkIdType(0),
+    [](vtkIdType a, vtkIdType b) {
+      return a < 0 || b < 0 || a > std::numeric_limits<vtkIdType>::max() - b ? vtkIdType(-1)
+                                                                              : a + b;
+    },
+    [](ValueType size) { return static_cast<vtkIdType>(size); });
+  if (connectivitySize < 0 ||
+    (sizeof(ValueType) < sizeof(vtkIdType) &&
+      connectivitySize > static_cast<vtkIdType>(std::numeric_limits<ValueType>::max())))
+  {
+    return -1;
+  }
+  vtkSMPTools::InclusiveScan(offsets + 1, offsets + numCells + 1, offsets + 1);
+  return connectivitySize;
+}
+}
+
+//------------------------------------------------------------------------------
+void ForEachCellRange(vtkIdType numCells, CellRangeFunctorType execute, void* functor)
+{
+  vtkSMPTools::For(0, numCells, [execute, functor](vtkIdType beginCellId, vtkIdType endCellId) {
+    execute(functor, beginCellId, endCellId);
+  });
+}
+
+//------------------------------------------------------------------------------
+vtkIdType ScanCellSizes(vtkTypeInt32* offsets, vtkIdType numCells)
+{
+  return ScanCellSizesImpl(offsets, numCells);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType ScanCellSizes(vtkTypeInt64* offsets, vtkIdType numCells)
+{
+  return ScanCellSizesImpl(offsets, numCells);
+}
+} // end namespace vtkCellArray_detail
@@ -147,10 +147,13 @@
 #include "vtkTypeInt64Array.h"       // Needed for inline methods
 #include "vtkTypeList.h"             // Needed for ArrayList definition
 
+#include <atomic>           // for std::atomic
 #include <cassert>          // for assert
 #include <initializer_list> // for API
+#include <limits>           // for std::numeric_limits
 #include <type_traits>      // for std::is_same
 #include <utility>          // for std::forward
+#include <vector>           // for std::vector
 
 /**
  * @def VTK_CELL_ARRAY_V2
@@ -1051,6 +1054,44 @@ public:
 
   /** @} */
 
+  /**
+   * @brief Parallel bulk construction of the cell array.
+   *
+   * Rather than having each thread fill its own cell array and concatenating
+   * them afterwards, these methods let the threads write the cells directly in
+   * the final offsets and connectivity arrays. The current storage (32 or 64
+   * bit) is kept, unless the connectivity does not fit in the 32 bit storage:
+   * the cell array then switches to the 64 bit storage. Any existing cell is
+   * discarded.
+   *
+   * AllocateFromCellSizes() evaluates `vtkIdType cellSize(vtkIdType cellId)`
+   * for every cell in parallel, computes the offsets with a parallel prefix
+   * sum and resizes the connectivity array to fit. The point ids of distinct
+   * cells can then be set concurrently with ReplaceCellAtId() or through
+   * Visit(), as neither reallocates the arrays.
+   *
+   * BuildCells() does both passes at once: after the offsets are computed,
+   * `void cellPoints(vtkIdType cellId, vtkIdType* pts)` is called in parallel
+   * for every cell and must write the cellSize(cellId) point ids of the cell
+   * in pts. When the storage value type matches vtkIdType, pts points directly
+   * into the connectivity array.
+   *
+   * ```
+   * cellArray->BuildCells(numCells,
+   *   [&](vtkIdType cellId) -> vtkIdType { return sizes[cellId]; },
+   *   [&](vtkIdType cellId, vtkIdType* pts) { ... });
+   * ```
+   *
+   * @return False if the arrays cannot be allocated, or if a cell size is
+   * negative. The cell array is empty in that case.
+   * @{
+   */
+  template <typename CellSizeFunctor>
+  bool AllocateFromCellSizes(vtkIdType numCells, CellSizeFunctor&& cellSize);
+  template <typename CellSizeFunctor, typename CellPointsFunctor>
+  bool BuildCells(vtkIdType numCells, CellSizeFunctor&& cellSize, CellPointsFunctor&& cellPoints);
+  /** @} */
+
 #endif // __VTK_WRAP__
 
   //=================== Begin Legacy Methods ===================================
@@ -1419,6 +1460,152 @@ struct InsertNextCellImpl
   }
 };
 
+#ifndef __VTK_WRAP__
+// Parallel bulk construction (see AllocateFromCellSizes). The parallel loops
+// are type erased so that vtkSMPTools is only used in vtkCellArray.cxx.
+using CellRangeFunctorType = void (*)(void* functor, vtkIdType beginCellId, vtkIdType endCellId);
+
+// Call execute(functor, beginCellId, endCellId) concurrently on ranges of
+// [0, numCells).
+VTKCOMMONDATAMODEL_EXPORT void ForEachCellRange(
+  vtkIdType numCells, CellRangeFunctorType execute, void* functor);
+
+template <typename Functor>
+void ExecuteCellRange(void* functor, vtkIdType beginCellId, vtkIdType endCellId)
+{
+  (*static_cast<Functor*>(functor))(beginCellId, endCellId);
+}
+
+template <typename Functor>
+void ForEachCellRange(vtkIdType numCells, Functor& functor)
+{
+  ForEachCellRange(numCells, ExecuteCellRange<Functor>, &functor);
+}
+
+// Turn the cell sizes stored in offsets[1, numCells] into offsets with a
+// parallel prefix sum. A negative size marks a cell whose size does not fit
+// in the storage. Return the connectivity size, or -1 if a size does not fit
+// or if the offsets overflow.
+VTKCOMMONDATAMODEL_EXPORT vtkIdType ScanCellSizes(vtkTypeInt32* offsets, vtkIdType numCells);
+VTKCOMMONDATAMODEL_EXPORT vtkIdType ScanCellSizes(vtkTypeInt64* offsets, vtkIdType numCells);
+
+template <typename ValueType, typename CellSizeFunctor>
+struct StoreCellSizesFunctor
+{
+  ValueType* Sizes;
+  CellSizeFunctor& CellSize;
+  std::atomic<bool>& InvalidSize;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for (; cellId < endCellId; ++cellId)
+    {
+      // Check the size before it is converted to the storage type.
+      const vtkIdType size = this->CellSize(cellId);
+      if (size < 0)
+      {
+        this->InvalidSize.store(true, std::memory_order_relaxed);
+      }
+      const bool fits = size >= 0 &&
+        (sizeof(ValueType) >= sizeof(vtkIdType) ||
+          size <= static_cast<vtkIdType>(std::numeric_limits<ValueType>::max()));
+      this->Sizes[cellId] = fits ? static_cast<ValueType>(size) : static_cast<ValueType>(-1);
+    }
+  }
+};
+
+struct AllocateFromCellSizesImpl
+{
+  // Set when the connectivity does not fit in the storage.
+  bool Overflow = false;
+  // Set when a cell size is negative, which no storage can fix.
+  bool InvalidSize = false;
+
+  template <typename CellStateT, typename CellSizeFunctor>
+  bool operator()(CellStateT& state, vtkIdType numCells, CellSizeFunctor& cellSize)
+  {
+    using ValueType = typename CellStateT::ValueType;
+    auto* offsets = state.GetOffsets();
+    auto* conn = state.GetConnectivity();
+
+    if (numCells < 0 || !offsets->SetNumberOfValues(numCells + 1))
+    {
+      return false;
+    }
+
+    // Store the size of each cell after its begin offset, then turn the sizes
+    // into offsets with a prefix sum.
+    ValueType* offsetPtr = offsets->GetPointer(0);
+    offsetPtr[0] = 0;
+    std::atomic<bool> invalidSize(false);
+    StoreCellSizesFunctor<ValueType, CellSizeFunctor> storeSizes{ offsetPtr + 1, cellSize,
+      invalidSize };
+    ForEachCellRange(numCells, storeSizes);
+    this->InvalidSize = invalidSize.load();
+    this->Overflow = false;
+    if (this->InvalidSize)
+    {
+      return false;
+    }
+
+    const vtkIdType connectivitySize = ScanCellSizes(offsetPtr, numCells);
+    this->Overflow = connectivitySize < 0;
+    return connectivitySize >= 0 && conn->SetNumberOfValues(connectivitySize);
+  }
+};
+
+template <typename ValueType, typename CellPointsFunctor, bool CanShareIds>
+struct FillCellsFunctor
+{
+  const ValueType* Offsets;
+  ValueType* Connectivity;
+  CellPointsFunctor& CellPoints;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    std::vector<vtkIdType> buffer;
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->FillCell(cellId, this->Connectivity + this->Offsets[cellId],
+        static_cast<vtkIdType>(this->Offsets[cellId + 1] - this->Offsets[cellId]), buffer,
+        std::integral_constant<bool, CanShareIds>{});
+    }
+  }
+
+  // The connectivity memory can be used as a vtkIdType*:
+  void FillCell(
+    vtkIdType cellId, ValueType* pts, vtkIdType, std::vector<vtkIdType>&, std::true_type)
+  {
+    this->CellPoints(cellId, reinterpret_cast<vtkIdType*>(pts));
+  }
+
+  // Otherwise the point ids are written to a buffer and converted.
+  void FillCell(vtkIdType cellId, ValueType* pts, vtkIdType npts, std::vector<vtkIdType>& buffer,
+    std::false_type)
+  {
+    buffer.resize(static_cast<std::size_t>(npts));
+    this->CellPoints(cellId, buffer.data());
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      pts[i] = static_cast<ValueType>(buffer[i]);
+    }
+  }
+};
+
+struct BuildCellsImpl
+{
+  template <typename CellStateT, typename CellPointsFunctor>
+  void operator()(CellStateT& state, vtkIdType numCells, CellPointsFunctor& cellPoints)
+  {
+    using ValueType = typename CellStateT::ValueType;
+    FillCellsFunctor<ValueType, CellPointsFunctor, CellStateT::ValueTypeIsSameAsIdType> fillCells{
+      state.GetOffsets()->GetPointer(0), state.GetConnectivity()->GetPointer(0), cellPoints
+    };
+    ForEachCellRange(numCells, fillCells);
+  }
+};
+#endif // __VTK_WRAP__
+
 // for incremental API:
 struct UpdateCellCountImpl
 {
@@ -1639,4 +1826,39 @@ inline void vtkCellArray::Reset()
   this->Visit(vtkCellArray_detail::ResetImpl{});
 }
 
+#ifndef __VTK_WRAP__
+//----------------------------------------------------------------------------
+template <typename CellSizeFunctor>
+bool vtkCellArray::AllocateFromCellSizes(vtkIdType numCells, CellSizeFunctor&& cellSize)
+{
+  vtkCellArray_detail::AllocateFromCellSizesImpl allocate;
+  bool result = this->Visit(allocate, numCells, cellSize);
+  if (!result && allocate.Overflow && !this->Storage.Is64Bit())
+  {
+    // The offsets overflow the 32 bit storage. Invalid sizes fail at once.
+    this->Use64BitStorage();
+    result = this->Visit(allocate, numCells, cellSize);
+  }
+  if (!result)
+  {
+    this->Initialize();
+  }
+  this->Modified();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+template <typename CellSizeFunctor, typename CellPointsFunctor>
+bool vtkCellArray::BuildCells(
+  vtkIdType numCells, CellSizeFunctor&& cellSize, CellPointsFunctor&& cellPoints)
+{
+  if (!this->AllocateFromCellSizes(numCells, std::forward<CellSizeFunctor>(cellSize)))
+  {
+    return false;
+  }
+  this->Visit(vtkCellArray_detail::BuildCellsImpl{}, numCells, cellPoints);
+  return true;
+}
+#endif // __VTK_WRAP__
+
 #endif // vtkCellArray.h
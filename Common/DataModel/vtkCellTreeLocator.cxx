@@ -20,10 +20,14 @@
 #include "vtkBoundingBox.h"
 #include "vtkBox.h"
 #include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
 #include <array>
@@ -46,6 +50,9 @@ enum
   NEG_Z
 };
 #define CELLTREE_MAX_DEPTH 32
+// Number of cells from which a leaf is split concurrently rather than being
+// the root of a subtree built by a single thread.
+#define VTK_CELLTREE_PARALLEL_SIZE 65536
 
 //------------------------------------------------------------------------------
 // Perform locator operations like FindCell. Uses templated subclasses
@@ -318,6 +325,19 @@ private:
     {
     }
 
+    inline void Merge(const Bucket& other)
+    {
+      this->Cnt += other.Cnt;
+      if (other.Min < this->Min)
+      {
+        this->Min = other.Min;
+      }
+      if (other.Max > this->Max)
+      {
+        this->Max = other.Max;
+      }
+    }
+
     inline void Add(const double& min, const double& max)
     {
       ++this->Cnt;
@@ -418,6 +438,9 @@ private:
   BucketsType Buckets;
 
   // -------------------------------------------------------------------------
+  // The bounds of the cells of the range, computed concurrently for large
+  // ranges. Min and max are exact, so the result does not depend on the
+  // number of threads.
   void FindMinMax(const CellInfo* begin, const CellInfo* end, double* min, double* max)
   {
     if (begin == end)
@@ -425,33 +448,93 @@ private:
       return;
     }
 
-    for (uint8_t d = 0; d < 3; ++d)
+    if (end - begin < VTK_CELLTREE_PARALLEL_SIZE)
     {
-      min[d] = begin->Min[d];
-      max[d] = begin->Max[d];
+      for (uint8_t d = 0; d < 3; ++d)
+      {
+        min[d] = begin->Min[d];
+        max[d] = begin->Max[d];
+      }
+
+      while (++begin != end)
+      {
+        for (uint8_t d = 0; d < 3; ++d)
+        {
+          if (begin->Min[d] < min[d])
+          {
+            min[d] = begin->Min[d];
+          }
+          if (begin->Max[d] > max[d])
+          {
+            max[d] = begin->Max[d];
+          }
+        }
+      }
+      return;
+    }
+
+    vtkSMPThreadLocal<std::array<double, 6>> localBounds(std::array<double, 6>{ VTK_DOUBLE_MAX,
+      VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX });
+    vtkSMPTools::For(0, end - begin, [&](vtkIdType first, vtkIdType last) {
+      std::array<double, 6>& bounds = localBounds.Local();
+      for (const CellInfo* pc = begin + first; pc != begin + last; ++pc)
+      {
+        for (uint8_t d = 0; d < 3; ++d)
+        {
+          bounds[d] = std::min(bounds[d], pc->Min[d]);
+          bounds[3 + d] = std::max(bounds[3 + d], pc->Max[d]);
+        }
+      }
+    });
+    std::fill_n(min, 3, VTK_DOUBLE_MAX);
+    std::fill_n(max, 3, -VTK_DOUBLE_MAX);
+    for (const std::array<double, 6>& bounds : localBounds)
+    {
+      for (uint8_t d = 0; d < 3; ++d)
+      {
+        min[d] = std::min(min[d], bounds[d]);
+        max[d] = std::max(max[d], bounds[3 + d]);
+      }
     }
+  }
+
+  // -------------------------------------------------------------------------
+  void FillBuckets(const CellInfo* begin, const CellInfo* end, const double min[3],
+    const double iext[3], BucketsType& buckets)
+  {
+    double cen;
+    int ind;
 
-    while (++begin != end)
+    for (const CellInfo* pc = begin; pc != end; ++pc)
     {
       for (uint8_t d = 0; d < 3; ++d)
       {
-        if (begin->Min[d] < min[d])
+        cen = (pc->Min[d] + pc->Max[d]) / 2.0;
+        ind = (int)((cen - min[d]) * iext[d]);
+
+        if (ind < 0)
         {
-          min[d] = begin->Min[d];
+          ind = 0;
         }
-        if (begin->Max[d] > max[d])
+
+        if (ind >= this->NumberOfBuckets)
         {
-          max[d] = begin->Max[d];
+          ind = this->NumberOfBuckets - 1;
         }
+
+        buckets[d][ind].Add(pc->Min[d], pc->Max[d]);
       }
     }
   }
 
   // -------------------------------------------------------------------------
-  void Split(T index, double min[3], double max[3], BucketsType& buckets)
+  // Splits the leaf index of nodes in two leaves, which are pushed on
+  // splitStack. The cells of large leaves are bucketed concurrently.
+  void Split(T index, double min[3], double max[3], BucketsType& buckets,
+    std::vector<TCellTreeNode>& nodes, std::stack<SplitInfo>& splitStack)
   {
-    const T& start = this->Nodes[index].Start();
-    const T& size = this->Nodes[index].Size();
+    const T start = nodes[index].Start();
+    const T size = nodes[index].Size();
 
     if (size < this->NumberOfNodesPerLeaf)
     {
@@ -468,27 +551,25 @@ private:
 
     buckets.Reset();
 
-    double cen;
-    int ind;
-
-    for (const CellInfo* pc = begin; pc != end; ++pc)
+    if (size < VTK_CELLTREE_PARALLEL_SIZE)
     {
-      for (uint8_t d = 0; d < 3; ++d)
+      this->FillBuckets(begin, end, min, iext, buckets);
+    }
+    else
+    {
+      vtkSMPThreadLocal<BucketsType> localBuckets(BucketsType(this->NumberOfBuckets));
+      vtkSMPTools::For(0, size, [&](vtkIdType first, vtkIdType last) {
+        this->FillBuckets(begin + first, begin + last, min, iext, localBuckets.Local());
+      });
+      for (const BucketsType& local : localBuckets)
       {
-        cen = (pc->Min[d] + pc->Max[d]) / 2.0;
-        ind = (int)((cen - min[d]) * iext[d]);
-
-        if (ind < 0)
-        {
-          ind = 0;
-        }
-
-        if (ind >= this->NumberOfBuckets)
+        for (uint8_t d = 0; d < 3; ++d)
         {
-          ind = this->NumberOfBuckets - 1;
+          for (int b = 0; b < this->NumberOfBuckets; ++b)
+          {
+            buckets[d][b].Merge(local[d][b]);
+          }
         }
-
-        buckets[d][ind].Add(pc->Min[d], pc->Max[d]);
       }
     }
 
@@ -570,11 +651,11 @@ private:
     child[0].MakeLeaf(begin - this->CellsInfo.data(), mid - begin);
     child[1].MakeLeaf(mid - this->CellsInfo.data(), end - mid);
 
-    this->Nodes[index].MakeNode(static_cast<T>(this->Nodes.size()), dim, clip);
-    this->Nodes.insert(this->Nodes.end(), child, child + 2);
+    nodes[index].MakeNode(static_cast<T>(nodes.size()), dim, clip);
+    nodes.insert(nodes.end(), child, child + 2);
 
-    this->SplitStack.emplace(this->Nodes[index].GetRightChildIndex(), rMin, rMax);
-    this->SplitStack.emplace(this->Nodes[index].GetLeftChildIndex(), lMin, lMax);
+    splitStack.emplace(nodes[index].GetRightChildIndex(), rMin, rMax);
+    splitStack.emplace(nodes[index].GetLeftChildIndex(), lMin, lMax);
   }
 
 public:
@@ -589,35 +670,32 @@ public:
     const auto numberOfCells = static_cast<T>(this->DataSet->GetNumberOfCells());
     this->CellsInfo.resize(static_cast<size_t>(numberOfCells));
 
+    // The cell bounds are cached, or the first call to GetCellBounds() has
+    // been made by ComputeCellBounds(), so they can be gathered concurrently.
+    vtkSMPTools::For(0, numberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      double cellBounds[6], *cellBoundsPtr;
+      for (T i = static_cast<T>(begin); i < static_cast<T>(end); ++i)
+      {
+        cellBoundsPtr = cellBounds;
+        this->CellsInfo[i].Ind = i;
+        this->Locator->GetCellBounds(i, cellBoundsPtr);
+
+        for (uint8_t d = 0; d < 3; ++d)
+        {
+          this->CellsInfo[i].Min[d] = cellBoundsPtr[2 * d + 0];
+          this->CellsInfo[i].Max[d] = cellBoundsPtr[2 * d + 1];
+        }
+      }
+    });
+
     double min[3] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
     double max[3] = {
       -VTK_DOUBLE_MAX,
       -VTK_DOUBLE_MAX,
       -VTK_DOUBLE_MAX,
     };
-
-    double cellBounds[6], *cellBoundsPtr;
-    cellBoundsPtr = cellBounds;
-    for (T i = 0; i < numberOfCells; ++i)
-    {
-      this->CellsInfo[i].Ind = i;
-      this->Locator->GetCellBounds(i, cellBoundsPtr);
-
-      for (uint8_t d = 0; d < 3; ++d)
-      {
-        this->CellsInfo[i].Min[d] = cellBoundsPtr[2 * d + 0];
-        this->CellsInfo[i].Max[d] = cellBoundsPtr[2 * d + 1];
-
-        if (this->CellsInfo[i].Min[d] < min[d])
-        {
-          min[d] = this->CellsInfo[i].Min[d];
-        }
-        if (this->CellsInfo[i].Max[d] > max[d])
-        {
-          max[d] = this->CellsInfo[i].Max[d];
-        }
-      }
-    }
+    this->FindMinMax(
+      this->CellsInfo.data(), this->CellsInfo.data() + this->CellsInfo.size(), min, max);
 
     this->Tree.DataBBox[0] = min[0];
     this->Tree.DataBBox[1] = max[0];
@@ -639,14 +717,65 @@ public:
     buckets = BucketsType(this->NumberOfBuckets);
   }
 
+  // The leaves with at least VTK_CELLTREE_PARALLEL_SIZE cells are split one
+  // after the other, each split being processed concurrently. The subtrees of
+  // the smaller leaves are then built concurrently, and appended to the tree.
+  // As each split only depends on the cells of its leaf, the tree is the same
+  // as if it was built sequentially.
   void operator()()
   {
     auto& buckets = this->Buckets;
+    std::vector<SplitInfo> subtrees;
     while (!this->SplitStack.empty())
     {
       auto splitInfo = std::move(this->SplitStack.top());
       this->SplitStack.pop();
-      this->Split(splitInfo.Index, splitInfo.Min, splitInfo.Max, buckets);
+      if (this->Nodes[splitInfo.Index].Size() < VTK_CELLTREE_PARALLEL_SIZE)
+      {
+        subtrees.push_back(splitInfo);
+        continue;
+      }
+      this->Split(
+        splitInfo.Index, splitInfo.Min, splitInfo.Max, buckets, this->Nodes, this->SplitStack);
+    }
+
+    const auto numberOfSubtrees = static_cast<vtkIdType>(subtrees.size());
+    std::vector<std::vector<TCellTreeNode>> subtreeNodes(subtrees.size());
+    vtkSMPThreadLocal<BucketsType> localBuckets(BucketsType(this->NumberOfBuckets));
+    vtkSMPTools::For(0, numberOfSubtrees, 1, [&](vtkIdType begin, vtkIdType end) {
+      BucketsType& threadBuckets = localBuckets.Local();
+      std::stack<SplitInfo> splitStack;
+      for (vtkIdType subtree = begin; subtree < end; ++subtree)
+      {
+        // The root of the subtree is the node 0 of its nodes.
+        std::vector<TCellTreeNode>& nodes = subtreeNodes[subtree];
+        nodes.push_back(this->Nodes[subtrees[subtree].Index]);
+        splitStack.emplace(0, subtrees[subtree].Min, subtrees[subtree].Max);
+        while (!splitStack.empty())
+        {
+          auto splitInfo = std::move(splitStack.top());
+          splitStack.pop();
+          this->Split(
+            splitInfo.Index, splitInfo.Min, splitInfo.Max, threadBuckets, nodes, splitStack);
+        }
+      }
+    });
+
+    for (vtkIdType subtree = 0; subtree < numberOfSubtrees; ++subtree)
+    {
+      std::vector<TCellTreeNode>& nodes = subtreeNodes[subtree];
+      // The node i > 0 of the subtree becomes the node offset + i of the tree.
+      const T offset = static_cast<T>(this->Nodes.size()) - 1;
+      for (TCellTreeNode& node : nodes)
+      {
+        if (node.IsNode())
+        {
+          node.SetChildren(node.GetLeftChildIndex() + offset);
+        }
+      }
+      this->Nodes[subtrees[subtree].Index] = nodes[0];
+      this->Nodes.insert(this->Nodes.end(), nodes.begin() + 1, nodes.end());
+      std::vector<TCellTreeNode>().swap(nodes);
     }
   }
 
@@ -668,12 +797,14 @@ public:
       ni->SetChildren(nn - this->Tree.Nodes.begin() - 2);
     }
 
-    const auto numberOfCells = static_cast<size_t>(this->DataSet->GetNumberOfCells());
-    this->Tree.Leaves.resize(numberOfCells);
-    for (size_t i = 0; i < numberOfCells; ++i)
-    {
-      this->Tree.Leaves[i] = this->CellsInfo[i].Ind;
-    }
+    const auto numberOfCells = static_cast<vtkIdType>(this->DataSet->GetNumberOfCells());
+    this->Tree.Leaves.resize(static_cast<size_t>(numberOfCells));
+    vtkSMPTools::For(0, numberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        this->Tree.Leaves[i] = this->CellsInfo[i].Ind;
+      }
+    });
     this->CellsInfo.clear();
   }
 };
@@ -1340,7 +1471,7 @@ void vtkCellTreeLocator::BuildLocatorInternal()
 {
   using namespace detail;
   vtkIdType numCells;
-  if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells() < 1))
+  if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1)
   {
     vtkErrorMacro(<< " No Cells in the data set\n");
     return;
@@ -1386,6 +1517,63 @@ vtkIdType vtkCellTreeLocator::FindCell(
   return this->Tree->FindCell(pos, cell, subId, pcoords, weights);
 }
 
+//------------------------------------------------------------------------------
+void vtkCellTreeLocator::FindCells(vtkPoints* points, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points ? points->GetNumberOfPoints() : 0;
+  cellIds->SetNumberOfIds(numPts);
+  if (pcoords)
+  {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numPts);
+  }
+  if (numPts < 1)
+  {
+    return;
+  }
+
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    if (pcoords)
+    {
+      pcoords->Fill(0.0);
+    }
+    return;
+  }
+
+  // Cause non-thread safe initialization to occur before the concurrent
+  // traversals.
+  const int maxCellSize = this->DataSet->GetMaxCellSize();
+  this->DataSet->GetCell(0, this->GenericCell);
+
+  detail::vtkCellTree* tree = this->Tree;
+  vtkSMPThreadLocalObject<vtkGenericCell> localCell;
+  vtkSMPThreadLocal<std::vector<double>> localWeights;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = localCell.Local();
+    std::vector<double>& weights = localWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pc[3];
+    int subId;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      const vtkIdType cellId = tree->FindCell(x, cell, subId, pc, weights.data());
+      cellIds->SetId(ptId, cellId);
+      if (pcoords)
+      {
+        if (cellId < 0)
+        {
+          pc[0] = pc[1] = pc[2] = 0.0;
+        }
+        pcoords->SetTypedTuple(ptId, pc);
+      }
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 void vtkCellTreeLocator::FindCellsWithinBounds(double* bbox, vtkIdList* cells)
 {
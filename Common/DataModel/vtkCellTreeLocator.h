@@ -30,6 +30,10 @@
  * - CacheCellBounds             (default true)
  * - UseExistingSearchStructure  (default false)
  *
+ * The tree is built concurrently: the large nodes are split one after the
+ * other with vtkSMPTools, then the subtrees of the smaller nodes are built
+ * in parallel. The resulting tree does not depend on the number of threads.
+ *
  * vtkCellTreeLocator does NOT utilize the following parameters:
  * - Automatic
  * - Level
@@ -157,6 +161,13 @@ public:
   vtkIdType FindCell(double pos[3], double vtkNotUsed(tol2), vtkGenericCell* cell, int& subId,
     double pcoords[3], double* weights) override;
 
+  /**
+   * Find the cells containing the given points. The tree is built once, then
+   * traversed concurrently for blocks of points, each thread using its own
+   * vtkGenericCell. See vtkAbstractCellLocator::FindCells().
+   */
+  void FindCells(vtkPoints* points, vtkIdList* cellIds, vtkDoubleArray* pcoords = nullptr) override;
+
   ///@{
   /**
    * Satisfy vtkLocator abstract interface.
@@ -0,0 +1,349 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentMergePoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConcurrentMergePoints.h"
+
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+vtkStandardNewMacro(vtkConcurrentMergePoints);
+
+namespace
+{
+//------------------------------------------------------------------------------
+// A point of a bucket. Its coordinates are the ones of the inserted point
+// converted to the data type of the points, and its id is -1 until the point
+// is copied into the vtkPoints.
+struct MergeNode
+{
+  double X[3];
+  MergeNode* Next;
+  std::atomic<vtkIdType> PointId;
+};
+
+//------------------------------------------------------------------------------
+// Return the last node of the list from first to last (excluded) whose
+// coordinates are x, if any. The nodes are pushed at the front of the lists,
+// so this is the first inserted point, as returned by vtkMergePoints when
+// InsertNextPoint() inserted the point again.
+MergeNode* FindNode(MergeNode* first, const MergeNode* last, const double x[3])
+{
+  MergeNode* found = nullptr;
+  for (MergeNode* node = first; node != last; node = node->Next)
+  {
+    if (node->X[0] == x[0] && node->X[1] == x[1] && node->X[2] == x[2])
+    {
+      found = node;
+    }
+  }
+  return found;
+}
+
+//------------------------------------------------------------------------------
+// Return the id of a node found in a list, waiting for the thread which
+// inserted the node to copy the point into the vtkPoints.
+vtkIdType GetPointId(const MergeNode* node)
+{
+  vtkIdType ptId;
+  while ((ptId = node->PointId.load(std::memory_order_acquire)) < 0)
+  {
+    std::this_thread::yield();
+  }
+  return ptId;
+}
+}
+
+//------------------------------------------------------------------------------
+struct vtkConcurrentMergePoints::vtkInternals
+{
+  // The nodes are allocated in blocks of doubling sizes, block b holding
+  // (1 << (FirstBlockShift + b)) nodes, so that they never move and the
+  // blocks can be allocated concurrently.
+  static constexpr int FirstBlockShift = 10;
+  static constexpr int NumberOfBlocks = 8 * sizeof(vtkIdType) - FirstBlockShift;
+
+  std::atomic<MergeNode*> Blocks[NumberOfBlocks];
+  std::atomic<vtkIdType> NumberOfNodes;
+  std::unique_ptr<std::atomic<MergeNode*>[]> Heads;
+  vtkIdType NumberOfHashedNodes = 0;
+  bool FloatPoints = false;
+  std::mutex PointsMutex;
+
+  vtkInternals()
+  {
+    for (auto& block : this->Blocks)
+    {
+      block.store(nullptr);
+    }
+    this->NumberOfNodes.store(0);
+  }
+
+  ~vtkInternals() { this->Free(); }
+
+  void Free()
+  {
+    for (auto& block : this->Blocks)
+    {
+      delete[] block.exchange(nullptr);
+    }
+    this->NumberOfNodes.store(0);
+    this->NumberOfHashedNodes = 0;
+    this->Heads.reset();
+  }
+
+  void Initialize(vtkIdType numBuckets, bool floatPoints)
+  {
+    this->Free();
+    this->Heads.reset(new std::atomic<MergeNode*>[numBuckets]);
+    for (vtkIdType i = 0; i < numBuckets; ++i)
+    {
+      this->Heads[i].store(nullptr, std::memory_order_relaxed);
+    }
+    this->FloatPoints = floatPoints;
+  }
+
+  // Convert the coordinates to the data type of the points, as in
+  // vtkMergePoints.
+  void GetKey(const double x[3], double key[3]) const
+  {
+    if (this->FloatPoints)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        key[i] = static_cast<float>(x[i]);
+      }
+    }
+    else
+    {
+      std::copy_n(x, 3, key);
+    }
+  }
+
+  MergeNode* NewNode(const double key[3])
+  {
+    // Block b holds the nodes from ((1 << b) - 1) << FirstBlockShift.
+    const vtkIdType index = this->NumberOfNodes.fetch_add(1);
+    const vtkIdType j = (index >> FirstBlockShift) + 1;
+    int b = 0;
+    while (j >> (b + 1))
+    {
+      ++b;
+    }
+    MergeNode* block = this->Blocks[b].load(std::memory_order_acquire);
+    if (!block)
+    {
+      MergeNode* newBlock = new MergeNode[static_cast<vtkIdType>(1) << (FirstBlockShift + b)];
+      if (this->Blocks[b].compare_exchange_strong(block, newBlock, std::memory_order_acq_rel))
+      {
+        block = newBlock;
+      }
+      else
+      {
+        delete[] newBlock;
+      }
+    }
+    MergeNode* node =
+      block + (index - ((((static_cast<vtkIdType>(1)) << b) - 1) << FirstBlockShift));
+    std::copy_n(key, 3, node->X);
+    node->PointId.store(-1, std::memory_order_relaxed);
+    return node;
+  }
+
+  // Push a new node of coordinates key on the list starting at head, whose
+  // first node was seen to be first, and return true. If unique, the push is
+  // abandoned if a node of same coordinates is pushed meanwhile by another
+  // thread: false is returned, and node is the node of the other thread.
+  bool Push(std::atomic<MergeNode*>& head, MergeNode* first, const double key[3], bool unique,
+    MergeNode*& node)
+  {
+    node = this->NewNode(key);
+    node->Next = first;
+    while (!head.compare_exchange_weak(
+      node->Next, node, std::memory_order_release, std::memory_order_acquire))
+    {
+      // On failure, node->Next is the new first node of the list.
+      MergeNode* found = unique ? FindNode(node->Next, first, key) : nullptr;
+      if (found)
+      {
+        // The new node is not used, it is freed with its block.
+        node = found;
+        return false;
+      }
+      first = node->Next;
+    }
+    return true;
+  }
+
+  // Copy the point of a pushed node into the points, which may have to be
+  // reallocated, and publish its id to the threads looking it up.
+  vtkIdType AddNextPoint(
+    MergeNode* node, const double x[3], vtkPoints* points, vtkIdType& insertionPointId)
+  {
+    vtkIdType ptId;
+    {
+      std::lock_guard<std::mutex> lock(this->PointsMutex);
+      ptId = insertionPointId++;
+      points->InsertPoint(ptId, x);
+    }
+    node->PointId.store(ptId, std::memory_order_release);
+    return ptId;
+  }
+};
+
+//------------------------------------------------------------------------------
+vtkConcurrentMergePoints::vtkConcurrentMergePoints()
+  : Internals(new vtkInternals)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkConcurrentMergePoints::~vtkConcurrentMergePoints() = default;
+
+//------------------------------------------------------------------------------
+int vtkConcurrentMergePoints::InitPointInsertion(
+  vtkPoints* newPts, const double bounds[6], vtkIdType estNumPts)
+{
+  if (!this->Superclass::InitPointInsertion(newPts, bounds, estNumPts))
+  {
+    return 0;
+  }
+  this->Internals->Initialize(this->NumberOfBuckets, newPts->GetDataType() == VTK_FLOAT);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::IsInsertedPoint(const double x[3])
+{
+  double key[3];
+  this->Internals->GetKey(x, key);
+  std::atomic<MergeNode*>& head = this->Internals->Heads[this->GetBucketIndex(key)];
+  const MergeNode* node = FindNode(head.load(std::memory_order_acquire), nullptr, key);
+  return node ? GetPointId(node) : -1;
+}
+
+//------------------------------------------------------------------------------
+int vtkConcurrentMergePoints::InsertUniquePoint(const double x[3], vtkIdType& ptId)
+{
+  double key[3];
+  this->Internals->GetKey(x, key);
+  std::atomic<MergeNode*>& head = this->Internals->Heads[this->GetBucketIndex(key)];
+  MergeNode* first = head.load(std::memory_order_acquire);
+  MergeNode* node = FindNode(first, nullptr, key);
+  if (node)
+  {
+    ptId = GetPointId(node);
+    return 0;
+  }
+
+  if (!this->Internals->Push(head, first, key, true, node))
+  {
+    ptId = GetPointId(node);
+    return 0;
+  }
+  ptId = this->Internals->AddNextPoint(node, x, this->Points, this->InsertionPointId);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::InsertNextPoint(const double x[3])
+{
+  double key[3];
+  this->Internals->GetKey(x, key);
+  std::atomic<MergeNode*>& head = this->Internals->Heads[this->GetBucketIndex(key)];
+  MergeNode* node;
+  this->Internals->Push(head, head.load(std::memory_order_acquire), key, false, node);
+  return this->Internals->AddNextPoint(node, x, this->Points, this->InsertionPointId);
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentMergePoints::InsertPoint(vtkIdType ptId, const double x[3])
+{
+  double key[3];
+  this->Internals->GetKey(x, key);
+  std::atomic<MergeNode*>& head = this->Internals->Heads[this->GetBucketIndex(key)];
+  MergeNode* node;
+  this->Internals->Push(head, head.load(std::memory_order_acquire), key, false, node);
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->PointsMutex);
+    this->Points->InsertPoint(ptId, x);
+  }
+  node->PointId.store(ptId, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::FindClosestInsertedPoint(const double x[3])
+{
+  this->UpdateHashTable();
+  return this->Superclass::FindClosestInsertedPoint(x);
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentMergePoints::UpdateHashTable()
+{
+  vtkInternals& internals = *this->Internals;
+  const vtkIdType numNodes = internals.NumberOfNodes.load();
+  if (!internals.Heads || !this->HashTable || numNodes == internals.NumberOfHashedNodes)
+  {
+    return;
+  }
+  for (vtkIdType i = 0; i < this->NumberOfBuckets; ++i)
+  {
+    vtkIdList*& bucket = this->HashTable[i];
+    if (bucket)
+    {
+      bucket->Reset();
+    }
+    for (const MergeNode* node = internals.Heads[i].load(); node; node = node->Next)
+    {
+      if (!bucket)
+      {
+        bucket = vtkIdList::New();
+        bucket->Allocate(this->NumberOfPointsPerBucket / 2, this->NumberOfPointsPerBucket / 3);
+      }
+      bucket->InsertNextId(node->PointId.load());
+    }
+    // The lists start with the last inserted points.
+    if (bucket)
+    {
+      std::reverse(bucket->begin(), bucket->end());
+    }
+  }
+  internals.NumberOfHashedNodes = numNodes;
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentMergePoints::FreeSearchStructure()
+{
+  this->Superclass::FreeSearchStructure();
+  this->Internals->Free();
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentMergePoints::GenerateRepresentation(int level, vtkPolyData* pd)
+{
+  this->UpdateHashTable();
+  this->Superclass::GenerateRepresentation(level, pd);
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentMergePoints::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
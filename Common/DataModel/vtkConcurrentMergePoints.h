@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentMergePoints.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConcurrentMergePoints
+ * @brief   merge exactly coincident points inserted from many threads
+ *
+ * vtkConcurrentMergePoints is a vtkMergePoints whose point insertion methods
+ * (InsertUniquePoint(), IsInsertedPoint(), InsertNextPoint() and
+ * InsertPoint()) may be called concurrently, for instance from the functor
+ * of a vtkSMPTools::For(), so that point merging filters do not need a
+ * serial merge phase. Like vtkMergePoints, it merges precisely coincident
+ * points: two points are merged if their coordinates are equal once
+ * converted to the data type of the points.
+ *
+ * Each bucket of the locator is a linked list on which new points are pushed
+ * with an atomic compare-and-swap, so that looking up a point never blocks.
+ * Only the copy of the new points into the vtkPoints, which may have to grow,
+ * is serialized. The ids are given to the points in the order in which they
+ * are first inserted: they depend on the scheduling of the threads, unless a
+ * single thread inserts the points, in which case they are the ids given by
+ * vtkMergePoints.
+ *
+ * InitPointInsertion() and the other methods, such as
+ * FindClosestInsertedPoint(), must not be called while points are inserted,
+ * and the vtkPoints must not be read while points are inserted.
+ *
+ * @sa
+ * vtkMergePoints vtkPointLocator vtkSMPTools
+ */
+
+#ifndef vtkConcurrentMergePoints_h
+#define vtkConcurrentMergePoints_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkMergePoints.h"
+
+#include <memory> // For unique_ptr
+
+class VTKCOMMONDATAMODEL_EXPORT vtkConcurrentMergePoints : public vtkMergePoints
+{
+public:
+  static vtkConcurrentMergePoints* New();
+  vtkTypeMacro(vtkConcurrentMergePoints, vtkMergePoints);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Initialize the point insertion process. See
+   * vtkPointLocator::InitPointInsertion().
+   */
+  int InitPointInsertion(vtkPoints* newPts, const double bounds[6]) override
+  {
+    return this->InitPointInsertion(newPts, bounds, 0);
+  }
+  int InitPointInsertion(vtkPoints* newPts, const double bounds[6], vtkIdType estNumPts) override;
+  ///@}
+
+  ///@{
+  /**
+   * Determine whether point given by x[3] has been inserted into points list.
+   * Return id of previously inserted point if this is true, otherwise return
+   * -1. May be called concurrently with the insertion methods.
+   */
+  vtkIdType IsInsertedPoint(const double x[3]) override;
+  vtkIdType IsInsertedPoint(double x, double y, double z) override
+  {
+    double xyz[3] = { x, y, z };
+    return this->IsInsertedPoint(xyz);
+  }
+  ///@}
+
+  /**
+   * Determine whether point given by x[3] has been inserted into points list.
+   * Return 0 if point was already in the list, otherwise return 1. If the
+   * point was not in the list, it will be ADDED. In either case, the id of
+   * the point (newly inserted or not) is returned in the ptId argument.
+   * May be called concurrently: a point inserted by several threads at the
+   * same time is added once, and all of them get its id.
+   */
+  int InsertUniquePoint(const double x[3], vtkIdType& ptId) override;
+
+  /**
+   * Insert a point without checking whether it was already inserted, and
+   * return its id. May be called concurrently.
+   */
+  vtkIdType InsertNextPoint(const double x[3]) override;
+
+  /**
+   * Insert a point with the given id, without checking whether it was
+   * already inserted. May be called concurrently with different ids.
+   */
+  void InsertPoint(vtkIdType ptId, const double x[3]) override;
+
+  /**
+   * Find the closest inserted point to the given position. Must not be
+   * called while points are inserted. See
+   * vtkPointLocator::FindClosestInsertedPoint().
+   */
+  vtkIdType FindClosestInsertedPoint(const double x[3]) override;
+
+  ///@{
+  /**
+   * See vtkLocator interface documentation.
+   */
+  void FreeSearchStructure() override;
+  void GenerateRepresentation(int level, vtkPolyData* pd) override;
+  ///@}
+
+protected:
+  vtkConcurrentMergePoints();
+  ~vtkConcurrentMergePoints() override;
+
+  /**
+   * Fill the buckets of vtkPointLocator with the points inserted since the
+   * last call, so that its searches can be used.
+   */
+  void UpdateHashTable();
+
+  // The concurrent buckets, defined in the implementation file.
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+
+private:
+  vtkConcurrentMergePoints(const vtkConcurrentMergePoints&) = delete;
+  void operator=(const vtkConcurrentMergePoints&) = delete;
+};
+
+#endif
@@ -339,6 +339,12 @@ public:
    */
   int GetNumberOfLevels();
 
+  /**
+   * The octree may grow as points are inserted: the batched queries run
+   * serially.
+   */
+  bool CanQueryConcurrently() override { return false; }
+
 protected:
   vtkIncrementalOctreePointLocator();
   ~vtkIncrementalOctreePointLocator() override;
@@ -29,26 +29,36 @@
 #include "vtkDataSetCollection.h"
 #include "vtkFloatArray.h"
 #include "vtkGarbageCollector.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkIntArray.h"
 #include "vtkKdNode.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointSet.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <list>
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 namespace
 {
@@ -105,6 +115,10 @@ private:
 #define TIMER(msg) TimeLog::StartEvent("KdTree: " msg, this->Timing)
 #define TIMERDONE(msg) TimeLog::EndEvent("KdTree: " msg, this->Timing)
 
+// Regions with at least that many points are divided with a concurrent
+// median search, the smaller ones are the roots of subtrees built concurrently.
+#define VTK_KDTREE_PARALLEL_SIZE 65536
+
 //------------------------------------------------------------------------------
 static void LastInputDeletedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
   void* _self, void* vtkNotUsed(calldata))
@@ -655,52 +669,62 @@ float* vtkKdTree::ComputeCellCenters(vtkDataSet* set)
     }
   }
 
-  double* weights = new double[maxCellSize];
-
-  float* cptr = center;
-  double dcenter[3];
+  // The centers are computed concurrently with a generic cell per thread. The
+  // first cell is requested beforehand so that the data sets build their cell
+  // structures, if any, before being shared by the threads.
+  vtkSMPThreadLocalObject<vtkGenericCell> threadCell;
+  std::vector<double> cellWeights(maxCellSize);
+  vtkSMPThreadLocal<std::vector<double>> threadWeights(cellWeights);
 
-  if (set)
-  {
-    for (int j = 0; j < totalCells; j++)
+  auto computeCenters = [&](vtkDataSet* dataSet, float* centers) {
+    vtkIdType nCells = dataSet->GetNumberOfCells();
+    if (nCells == 0)
     {
-      this->ComputeCellCenter(set->GetCell(j), dcenter, weights);
-      cptr[0] = static_cast<float>(dcenter[0]);
-      cptr[1] = static_cast<float>(dcenter[1]);
-      cptr[2] = static_cast<float>(dcenter[2]);
-      cptr += 3;
-      if (j % 1000 == 0)
-      {
-        this->UpdateSubOperationProgress(static_cast<double>(j) / totalCells);
-      }
+      return;
     }
-  }
-  else
-  {
-    vtkCollectionSimpleIterator cookie;
-    this->DataSets->InitTraversal(cookie);
-    for (vtkDataSet* iset = this->DataSets->GetNextDataSet(cookie); iset != nullptr;
-         iset = this->DataSets->GetNextDataSet(cookie))
-    {
-      int nCells = iset->GetNumberOfCells();
+    vtkNew<vtkGenericCell> cell;
+    dataSet->GetCell(0, cell);
+
+    vtkSMPTools::For(0, nCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkGenericCell* gcell = threadCell.Local();
+      double* weights = threadWeights.Local().data();
+      bool isSingleThread = vtkSMPTools::GetSingleThread();
+      double dcenter[3];
+      float* cptr = centers + 3 * begin;
 
-      for (int j = 0; j < nCells; j++)
+      for (vtkIdType j = begin; j < end; j++)
       {
-        this->ComputeCellCenter(iset->GetCell(j), dcenter, weights);
+        dataSet->GetCell(j, gcell);
+        this->ComputeCellCenter(gcell, dcenter, weights);
         cptr[0] = static_cast<float>(dcenter[0]);
         cptr[1] = static_cast<float>(dcenter[1]);
         cptr[2] = static_cast<float>(dcenter[2]);
         cptr += 3;
-        if (j % 1000 == 0)
+        if (isSingleThread && j % 1000 == 0)
         {
           this->UpdateSubOperationProgress(static_cast<double>(j) / totalCells);
         }
       }
+    });
+  };
+
+  if (set)
+  {
+    computeCenters(set, center);
+  }
+  else
+  {
+    float* cptr = center;
+    vtkCollectionSimpleIterator cookie;
+    this->DataSets->InitTraversal(cookie);
+    for (vtkDataSet* iset = this->DataSets->GetNextDataSet(cookie); iset != nullptr;
+         iset = this->DataSets->GetNextDataSet(cookie))
+    {
+      computeCenters(iset, cptr);
+      cptr += 3 * iset->GetNumberOfCells();
     }
   }
 
-  delete[] weights;
-
   this->UpdateSubOperationProgress(1.0);
   return center;
 }
@@ -795,11 +819,6 @@ void vtkKdTree::BuildLocatorInternal()
   int nCells = 0;
   int i;
 
-  if (this->NewGeometry())
-  {
-    return;
-  }
-
   nCells = this->GetNumberOfCells();
 
   if (nCells == 0)
@@ -930,7 +949,7 @@ void vtkKdTree::BuildLocatorInternal()
 
     this->ProgressOffset += this->ProgressScale;
     this->ProgressScale = 0.7;
-    this->DivideRegion(kd, ptarray, nullptr, 0);
+    this->DivideRegionConcurrently(kd, ptarray, nullptr, 0);
 
     TIMERDONE("Build tree");
 
@@ -1273,15 +1292,8 @@ int vtkKdTree::DivideTest(int size, int level)
 }
 
 //------------------------------------------------------------------------------
-int vtkKdTree::DivideRegion(vtkKdNode* kd, float* c1, int* ids, int level)
+void vtkKdTree::SelectCutDirections(vtkKdNode* kd, int dims[3])
 {
-  int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
-
-  if (!ok)
-  {
-    return 0;
-  }
-
   int maxdim = this->SelectCutDirection(kd);
 
   kd->SetDim(maxdim);
@@ -1326,7 +1338,25 @@ int vtkKdTree::DivideRegion(vtkKdNode* kd, float* c1, int* ids, int level)
     }
   }
 
-  this->DoMedianFind(kd, c1, ids, dim1, dim2, dim3);
+  dims[0] = dim1;
+  dims[1] = dim2;
+  dims[2] = dim3;
+}
+
+//------------------------------------------------------------------------------
+int vtkKdTree::DivideRegion(vtkKdNode* kd, float* c1, int* ids, int level)
+{
+  int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
+
+  if (!ok)
+  {
+    return 0;
+  }
+
+  int dims[3];
+  this->SelectCutDirections(kd, dims);
+
+  this->DoMedianFind(kd, c1, ids, dims[0], dims[1], dims[2]);
 
   if (kd->GetLeft() == nullptr)
   {
@@ -1345,6 +1375,82 @@ int vtkKdTree::DivideRegion(vtkKdNode* kd, float* c1, int* ids, int level)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// The regions of at least VTK_KDTREE_PARALLEL_SIZE points are divided one
+// after the other, then the subtrees of the smaller regions are built
+// concurrently with DivideRegion.  Each cut only depends on the points of the
+// region, not on their order, so the regions are the same as the ones
+// DivideRegion builds alone.
+//
+void vtkKdTree::DivideRegionConcurrently(vtkKdNode* kd, float* c1, int* ids, int level)
+{
+  struct Region
+  {
+    vtkKdNode* Node;
+    float* Points;
+    int* Ids;
+    int Level;
+  };
+
+  std::vector<Region> subtrees;
+  std::vector<Region> regions(1, Region{ kd, c1, ids, level });
+
+  while (!regions.empty())
+  {
+    Region region = regions.back();
+    regions.pop_back();
+
+    vtkKdNode* node = region.Node;
+    int npoints = node->GetNumberOfPoints();
+
+    if (npoints < VTK_KDTREE_PARALLEL_SIZE)
+    {
+      subtrees.push_back(region);
+      continue;
+    }
+
+    if (!this->DivideTest(npoints, region.Level))
+    {
+      continue;
+    }
+
+    int dims[3];
+    this->SelectCutDirections(node, dims);
+
+    // With point ids, the order of the points in the regions is kept as the
+    // one DivideRegion gives, since the locator returns the points in that
+    // order.
+    if (region.Ids)
+    {
+      this->DoMedianFind(node, region.Points, region.Ids, dims[0], dims[1], dims[2]);
+    }
+    else
+    {
+      vtkKdTree::DoMedianFindConcurrently(node, region.Points, dims[0], dims[1], dims[2]);
+    }
+
+    if (node->GetLeft() == nullptr)
+    {
+      continue; // unable to divide region further
+    }
+
+    int nleft = node->GetLeft()->GetNumberOfPoints();
+
+    regions.push_back(Region{ node->GetRight(), region.Points + nleft * 3,
+      region.Ids ? region.Ids + nleft : nullptr, region.Level + 1 });
+    regions.push_back(Region{ node->GetLeft(), region.Points, region.Ids, region.Level + 1 });
+  }
+
+  vtkSMPTools::For(0, static_cast<vtkIdType>(subtrees.size()), 1,
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const Region& region = subtrees[i];
+        this->DivideRegion(region.Node, region.Points, region.Ids, region.Level);
+      }
+    });
+}
+
 //------------------------------------------------------------------------------
 // Rearrange the point array.  Try dim1 first.  If there's a problem
 // go to dim2, then dim3.
@@ -1381,8 +1487,234 @@ void vtkKdTree::DoMedianFind(vtkKdNode* kd, float* c1, int* ids, int dim1, int d
   }
 }
 
+namespace
+{
+// Maps a float to an unsigned integer, the integers being ordered as the
+// floats are.
+inline uint32_t OrderedKey(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline float OrderedValue(uint32_t key)
+{
+  uint32_t bits = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Returns the value of rank k along dim of the n points of c1.  The keys of
+// the values are selected one byte at a time, the histograms of each byte
+// being computed concurrently.
+float SelectRank(const float* c1, vtkIdType n, int dim, vtkIdType k)
+{
+  using Histogram = std::array<vtkIdType, 256>;
+  Histogram empty;
+  empty.fill(0);
+
+  uint32_t prefix = 0;
+  uint32_t prefixMask = 0;
+
+  for (int shift = 24; shift >= 0; shift -= 8)
+  {
+    vtkSMPThreadLocal<Histogram> threadHistogram(empty);
+
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+      Histogram& histogram = threadHistogram.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        uint32_t key = OrderedKey(c1[3 * i + dim]);
+        if ((key & prefixMask) == prefix)
+        {
+          ++histogram[(key >> shift) & 0xffu];
+        }
+      }
+    });
+
+    Histogram histogram = empty;
+    for (const Histogram& local : threadHistogram)
+    {
+      for (int b = 0; b < 256; ++b)
+      {
+        histogram[b] += local[b];
+      }
+    }
+
+    uint32_t digit = 0;
+    while (k >= histogram[digit])
+    {
+      k -= histogram[digit];
+      ++digit;
+    }
+
+    prefix |= digit << shift;
+    prefixMask |= 0xffu << shift;
+  }
+
+  return OrderedValue(prefix);
+}
+
+struct PartitionResult
+{
+  vtkIdType NumberLeft; // number of points below the value
+  float LeftMax;        // largest coordinate below the value
+  float Min;            // range of the coordinates
+  float Max;
+};
+
+// Moves the n points of c1 whose coordinate along dim is below value before
+// the other ones, keeping their order.  The points are counted per chunk,
+// then moved concurrently through a copy.
+PartitionResult PartitionBelow(float* c1, vtkIdType n, int dim, float value)
+{
+  const vtkIdType chunkSize = VTK_KDTREE_PARALLEL_SIZE / 4;
+  const vtkIdType numChunks = (n + chunkSize - 1) / chunkSize;
+  const float infinity = std::numeric_limits<float>::infinity();
+
+  std::vector<PartitionResult> chunks(numChunks);
+
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      PartitionResult& result = chunks[chunk];
+      result = PartitionResult{ 0, -infinity, infinity, -infinity };
+      vtkIdType last = std::min(n, (chunk + 1) * chunkSize);
+      for (vtkIdType i = chunk * chunkSize; i < last; ++i)
+      {
+        float v = c1[3 * i + dim];
+        if (v < value)
+        {
+          ++result.NumberLeft;
+          result.LeftMax = std::max(result.LeftMax, v);
+        }
+        result.Min = std::min(result.Min, v);
+        result.Max = std::max(result.Max, v);
+      }
+    }
+  });
+
+  PartitionResult total{ 0, -infinity, infinity, -infinity };
+  for (const PartitionResult& result : chunks)
+  {
+    total.NumberLeft += result.NumberLeft;
+    total.LeftMax = std::max(total.LeftMax, result.LeftMax);
+    total.Min = std::min(total.Min, result.Min);
+    total.Max = std::max(total.Max, result.Max);
+  }
+
+  if (total.NumberLeft == 0 || total.NumberLeft == n)
+  {
+    return total;
+  }
+
+  // Where each chunk writes its points on both sides.
+  std::vector<vtkIdType> leftOffsets(numChunks);
+  std::vector<vtkIdType> rightOffsets(numChunks);
+  vtkIdType nextLeft = 0;
+  vtkIdType nextRight = total.NumberLeft;
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    leftOffsets[chunk] = nextLeft;
+    rightOffsets[chunk] = nextRight;
+    vtkIdType chunkPoints = std::min(n, (chunk + 1) * chunkSize) - chunk * chunkSize;
+    nextLeft += chunks[chunk].NumberLeft;
+    nextRight += chunkPoints - chunks[chunk].NumberLeft;
+  }
+
+  std::vector<float> partitioned(3 * n);
+
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      float* left = partitioned.data() + 3 * leftOffsets[chunk];
+      float* right = partitioned.data() + 3 * rightOffsets[chunk];
+      vtkIdType last = std::min(n, (chunk + 1) * chunkSize);
+      for (vtkIdType i = chunk * chunkSize; i < last; ++i)
+      {
+        const float* point = c1 + 3 * i;
+        float*& to = (point[dim] < value) ? left : right;
+        to[0] = point[0];
+        to[1] = point[1];
+        to[2] = point[2];
+        to += 3;
+      }
+    }
+  });
+
+  vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+    std::copy(partitioned.data() + 3 * begin, partitioned.data() + 3 * end, c1 + 3 * begin);
+  });
+
+  return total;
+}
+}
+
+//------------------------------------------------------------------------------
+// Divide the region like DoMedianFind does, without its ids.  The median is
+// found with a radix selection on the coordinates and the points are
+// partitioned about it concurrently.
+//
+void vtkKdTree::DoMedianFindConcurrently(vtkKdNode* kd, float* c1, int dim1, int dim2, int dim3)
+{
+  vtkIdType npoints = kd->GetNumberOfPoints();
+
+  int dims[3] = { dim1, dim2, dim3 };
+
+  for (int dim = 0; dim < 3; dim++)
+  {
+    if (dims[dim] < 0)
+    {
+      break;
+    }
+
+    // As in Select, the points on the left are the ones strictly below the
+    // value of rank npoints / 2.
+    float midValue = ::SelectRank(c1, npoints, dims[dim], npoints / 2);
+
+    ::PartitionResult partition = ::PartitionBelow(c1, npoints, dims[dim], midValue);
+
+    if (partition.NumberLeft == 0)
+    {
+      continue; // fatal
+    }
+
+    kd->SetDim(dims[dim]);
+
+    double coord =
+      (static_cast<double>(midValue) + static_cast<double>(partition.LeftMax)) / 2.0;
+
+    vtkKdTree::AddNewRegions(kd, static_cast<int>(partition.NumberLeft), dims[dim], coord);
+
+    // The data bounds SetDataBounds would compute from the points.
+    double bounds[6];
+    kd->GetDataBounds(bounds);
+
+    bounds[2 * dims[dim]] = partition.Min;
+    bounds[2 * dims[dim] + 1] = partition.LeftMax;
+    kd->GetLeft()->SetDataBounds(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+
+    bounds[2 * dims[dim]] = midValue;
+    bounds[2 * dims[dim] + 1] = partition.Max;
+    kd->GetRight()->SetDataBounds(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+
+    break; // division is fine
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkKdTree::AddNewRegions(vtkKdNode* kd, float* c1, int midpt, int dim, double coord)
+{
+  vtkKdTree::AddNewRegions(kd, midpt, dim, coord);
+
+  kd->GetLeft()->SetDataBounds(c1);
+  kd->GetRight()->SetDataBounds(c1 + midpt * 3);
+}
+
+//------------------------------------------------------------------------------
+void vtkKdTree::AddNewRegions(vtkKdNode* kd, int midpt, int dim, double coord)
 {
   vtkKdNode* left = vtkKdNode::New();
   vtkKdNode* right = vtkKdNode::New();
@@ -1408,9 +1740,6 @@ void vtkKdTree::AddNewRegions(vtkKdNode* kd, float* c1, int midpt, int dim, doub
     ((dim == vtkKdTree::ZDIM) ? coord : bounds[4]), bounds[5]);
 
   right->SetNumberOfPoints(nright);
-
-  left->SetDataBounds(c1);
-  right->SetDataBounds(c1 + nleft * 3);
 }
 // Use Floyd & Rivest (1975) to find the median:
 // Given an array X with element indices ranging from L to R, and
@@ -1891,7 +2220,7 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints** ptArrays, int numPtArrays)
 
   TIMER("Build tree");
 
-  this->DivideRegion(kd, points, ptIds, 0);
+  this->DivideRegionConcurrently(kd, points, ptIds, 0);
 
   this->SetActualLevel();
   this->BuildRegionList();
@@ -3825,9 +4154,9 @@ void vtkKdTree::CreateCellLists(vtkDataSet* set, int* regionList, int listSize)
 
   int nCells = set->GetNumberOfCells();
 
-  for (int cellId = 0; cellId < nCells; cellId++)
+  if (this->IncludeRegionBoundaryCells)
   {
-    if (this->IncludeRegionBoundaryCells)
+    for (int cellId = 0; cellId < nCells; cellId++)
     {
       // Find all regions the cell intersects, including
       // the region the cell centroid lies in.
@@ -3870,23 +4199,94 @@ void vtkKdTree::CreateCellLists(vtkDataSet* set, int* regionList, int listSize)
         }
       }
     }
-    else
+  }
+  else
+  {
+    // just find the region the cell centroid lies in - easy
+
+    this->FillCellLists(regList, nCells, listptr);
+  }
+
+  delete[] listptr;
+  delete[] idlist;
+}
+
+//------------------------------------------------------------------------------
+// Put each cell in the list of the region its centroid lies in.  The cells of
+// each region are counted per chunk of cells, so that the lists are sized once
+// and filled concurrently in increasing cell id order.
+void vtkKdTree::FillCellLists(const int* regList, int nCells, const int* listptr)
+{
+  vtkKdTree::cellList_* list = &this->CellList;
+  int nRegions = list->nRegions;
+
+  if (nCells == 0 || nRegions == 0)
+  {
+    return;
+  }
+
+  // No more counts than cells, for many regions.
+  const vtkIdType maxChunkSize = VTK_KDTREE_PARALLEL_SIZE / 4;
+  vtkIdType numChunks = (nCells + maxChunkSize - 1) / maxChunkSize;
+  numChunks = std::max<vtkIdType>(1, std::min<vtkIdType>(numChunks, nCells / nRegions));
+  vtkIdType chunkSize = (nCells + numChunks - 1) / numChunks;
+
+  auto listIndex = [&](vtkIdType cellId) {
+    int regionId = regList[cellId];
+    if (regionId < 0)
     {
-      // just find the region the cell centroid lies in - easy
+      return -1;
+    }
+    return listptr ? listptr[regionId] : regionId;
+  };
 
-      int regionId = regList[cellId];
+  std::vector<vtkIdType> offsets(numChunks * nRegions, 0);
 
-      int idx = (listptr) ? listptr[regionId] : regionId;
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      vtkIdType* counts = offsets.data() + chunk * nRegions;
+      vtkIdType last = std::min<vtkIdType>(nCells, (chunk + 1) * chunkSize);
+      for (vtkIdType cellId = chunk * chunkSize; cellId < last; ++cellId)
+      {
+        int idx = listIndex(cellId);
+        if (idx >= 0)
+        {
+          ++counts[idx];
+        }
+      }
+    }
+  });
 
-      if (idx >= 0)
+  vtkSMPTools::For(0, nRegions, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkIdType offset = 0;
+      for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
       {
-        list->cells[idx]->InsertNextId(cellId);
+        vtkIdType count = offsets[chunk * nRegions + idx];
+        offsets[chunk * nRegions + idx] = offset;
+        offset += count;
       }
+      list->cells[idx]->SetNumberOfIds(offset);
     }
-  }
+  });
 
-  delete[] listptr;
-  delete[] idlist;
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      vtkIdType* next = offsets.data() + chunk * nRegions;
+      vtkIdType last = std::min<vtkIdType>(nCells, (chunk + 1) * chunkSize);
+      for (vtkIdType cellId = chunk * chunkSize; cellId < last; ++cellId)
+      {
+        int idx = listIndex(cellId);
+        if (idx >= 0)
+        {
+          list->cells[idx]->SetId(next[idx]++, cellId);
+        }
+      }
+    }
+  });
 }
 
 //------------------------------------------------------------------------------
@@ -4212,14 +4612,13 @@ int* vtkKdTree::AllGetRegionContainingCell()
 
     float* centers = this->ComputeCellCenters(iset);
 
-    float* pt = centers;
-
-    for (int cellId = 0; cellId < setCells; cellId++)
-    {
-      listPtr[cellId] = this->GetRegionContainingPoint(pt[0], pt[1], pt[2]);
-
-      pt += 3;
-    }
+    vtkSMPTools::For(0, setCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+        const float* pt = centers + 3 * cellId;
+        listPtr[cellId] = vtkKdTree::findRegion(this->Top, pt[0], pt[1], pt[2]);
+      }
+    });
 
     listPtr += setCells;
 
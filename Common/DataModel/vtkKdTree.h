@@ -783,7 +783,15 @@ protected:
 
   int DivideRegion(vtkKdNode* kd, float* c1, int* ids, int nlevels);
 
+  // Same as DivideRegion, building the tree with vtkSMPTools.
+  void DivideRegionConcurrently(vtkKdNode* kd, float* c1, int* ids, int level);
+
+  // Set the best cut direction of kd, and return it in dims followed by the
+  // other valid ones, -1 filling the rest.
+  void SelectCutDirections(vtkKdNode* kd, int dims[3]);
+
   void DoMedianFind(vtkKdNode* kd, float* c1, int* ids, int d1, int d2, int d3);
+  static void DoMedianFindConcurrently(vtkKdNode* kd, float* c1, int d1, int d2, int d3);
 
   void SelfRegister(vtkKdNode* kd);
 
@@ -800,6 +808,10 @@ protected:
   void InitializeCellLists();
   vtkIdList* GetList(int regionId, vtkIdList** which);
 
+  // Fill the cell lists from the region of each cell, without the boundary
+  // cells.
+  void FillCellLists(const int* regList, int nCells, const int* listptr);
+
   void ComputeCellCenter(vtkCell* cell, double* center, double* weights);
 
   void GenerateRepresentationDataBounds(int level, vtkPolyData* pd);
@@ -859,6 +871,7 @@ protected:
   static vtkKdNode** GetRegionsAtLevel_(int level, vtkKdNode** nodes, vtkKdNode* kd);
 
   static void AddNewRegions(vtkKdNode* kd, float* c1, int midpt, int dim, double coord);
+  static void AddNewRegions(vtkKdNode* kd, int midpt, int dim, double coord);
 
   void NewPartitioningRequest(int req);
 
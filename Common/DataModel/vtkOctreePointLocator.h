@@ -192,6 +192,11 @@ public:
    */
   void FindPointsInArea(double* area, vtkIdTypeArray* ids, bool clearArray = true);
 
+  /**
+   * The batched queries walk the octree serially.
+   */
+  bool CanQueryConcurrently() override { return false; }
+
 protected:
   vtkOctreePointLocator();
   ~vtkOctreePointLocator() override;
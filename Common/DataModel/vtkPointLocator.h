@@ -244,6 +244,11 @@ public:
   void GenerateRepresentation(int level, vtkPolyData* pd) override;
   ///@}
 
+  /**
+   * The batched queries of this locator, and of its subclasses, run serially.
+   */
+  bool CanQueryConcurrently() override { return false; }
+
 protected:
   vtkPointLocator();
   ~vtkPointLocator() override;
@@ -19,6 +19,7 @@
 #include "vtkCellArray.h"
 #include "vtkDataArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
 #include "vtkLine.h"
 #include "vtkMath.h"
@@ -30,6 +31,8 @@
 #include "vtkSMPTools.h"
 #include "vtkStructuredData.h"
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 vtkStandardNewMacro(vtkStaticPointLocator);
@@ -57,6 +60,25 @@ vtkStandardNewMacro(vtkStaticPointLocator);
 // in vtkPointLocator and vtkStaticPointLocator and causing weird faults.
 struct NeighborBuckets;
 
+//------------------------------------------------------------------------------
+// Neighbor queries of the batched methods. They are implemented for each type
+// of bucket list and of point coordinates.
+struct NeighborQueries
+{
+  virtual ~NeighborQueries() = default;
+  virtual void FindClosestNPoints(int N, const double x[3], std::vector<vtkIdType>& result) = 0;
+  virtual void FindPointsWithinRadius(
+    double R, const double x[3], std::vector<vtkIdType>& result) = 0;
+};
+
+// The arguments of the neighbor queries run by FindNeighborsBatch().
+struct NeighborQueriesArgs
+{
+  NeighborQueries* Queries;
+  int N;
+  double R;
+};
+
 //------------------------------------------------------------------------------
 // The bucketed points, including the sorted map. This is just a PIMPLd
 // wrapper around the classes that do the real work.
@@ -112,6 +134,7 @@ struct vtkBucketList
   // Virtuals for templated subclasses
   virtual ~vtkBucketList() = default;
   virtual void BuildLocator() = 0;
+  virtual NeighborQueries* NewNeighborQueries() = 0;
 
   // place points in appropriate buckets
   void GetBucketNeighbors(
@@ -496,6 +519,7 @@ struct BucketList : public vtkBucketList
   void MergePoints(double tol, vtkIdType* pointMap, int orderingMode);
   void MergePointsWithData(vtkDataArray* data, vtkIdType* pointMap);
   void GenerateRepresentation(int vtkNotUsed(level), vtkPolyData* pd);
+  NeighborQueries* NewNeighborQueries() override;
 
   // Internal methods
   void GetOverlappingBuckets(
@@ -1463,6 +1487,249 @@ void BucketList<TIds>::FindPointsWithinRadius(double R, const double x[3], vtkId
   }         // k-footprint
 }
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Access to the coordinates of the points of the batched queries: directly in
+// float or double points arrays, through the data set otherwise.
+template <typename TPts>
+struct PointsArrayAccess
+{
+  const TPts* Points;
+
+  void GetPoint(vtkIdType ptId, double x[3]) const
+  {
+    const TPts* p = this->Points + 3 * ptId;
+    x[0] = static_cast<double>(p[0]);
+    x[1] = static_cast<double>(p[1]);
+    x[2] = static_cast<double>(p[2]);
+  }
+};
+
+struct DataSetPointsAccess
+{
+  vtkDataSet* DataSet;
+
+  void GetPoint(vtkIdType ptId, double x[3]) const { this->DataSet->GetPoint(ptId, x); }
+};
+
+//------------------------------------------------------------------------------
+// Per thread work space of the batched queries.
+struct NeighborQueriesData
+{
+  // The copies made for each thread start empty, the buckets pointing to
+  // their own buffer.
+  NeighborQueriesData() = default;
+  NeighborQueriesData(const NeighborQueriesData&) {}
+  NeighborQueriesData& operator=(const NeighborQueriesData&) { return *this; }
+
+  NeighborBuckets Buckets;
+  std::vector<double> X, Y, Z, Distance2;
+  std::vector<IdTuple> Closest; // heap of the closest points found so far
+};
+
+// Orders the closest points by distance, then by id so that the N closest
+// points do not depend on the order the points are visited in.
+inline bool CloserThan(const IdTuple& a, const IdTuple& b)
+{
+  return a.Dist2 < b.Dist2 || (a.Dist2 == b.Dist2 && a.PtId < b.PtId);
+}
+}
+
+//------------------------------------------------------------------------------
+// The batched queries follow the single queries above, with the coordinates
+// of the points of each bucket gathered in arrays so that their distances to
+// the query point are computed in a loop the compiler can vectorize. The N
+// closest points are kept in a heap.
+template <typename TIds, typename TPointsAccess>
+struct BucketNeighborQueries : public NeighborQueries
+{
+  BucketList<TIds>* BList;
+  TPointsAccess Points;
+  vtkSMPThreadLocal<NeighborQueriesData> Data;
+
+  BucketNeighborQueries(BucketList<TIds>* blist, TPointsAccess points)
+    : BList(blist)
+    , Points(points)
+  {
+  }
+
+  // Compute the squared distances from x to the points of a bucket.
+  const LocatorTuple<TIds>* ComputeDistances(
+    vtkIdType cno, vtkIdType numIds, const double x[3], NeighborQueriesData& data)
+  {
+    const LocatorTuple<TIds>* ids = this->BList->GetIds(cno);
+    if (static_cast<vtkIdType>(data.Distance2.size()) < numIds)
+    {
+      data.X.resize(numIds);
+      data.Y.resize(numIds);
+      data.Z.resize(numIds);
+      data.Distance2.resize(numIds);
+    }
+    double* px = data.X.data();
+    double* py = data.Y.data();
+    double* pz = data.Z.data();
+    double* d2 = data.Distance2.data();
+
+    double pt[3];
+    for (vtkIdType i = 0; i < numIds; ++i)
+    {
+      this->Points.GetPoint(ids[i].PtId, pt);
+      px[i] = pt[0];
+      py[i] = pt[1];
+      pz[i] = pt[2];
+    }
+
+    const double x0 = x[0], x1 = x[1], x2 = x[2];
+    for (vtkIdType i = 0; i < numIds; ++i)
+    {
+      const double dx = px[i] - x0;
+      const double dy = py[i] - x1;
+      const double dz = pz[i] - x2;
+      d2[i] = dx * dx + dy * dy + dz * dz;
+    }
+    return ids;
+  }
+
+  // Add the points of the bucket to the N closest points if they are closer.
+  void AddClosestPoints(int N, const int nei[3], const double x[3], NeighborQueriesData& data)
+  {
+    vtkIdType cno = nei[0] + nei[1] * this->BList->xD + nei[2] * this->BList->xyD;
+    vtkIdType numIds = this->BList->GetNumberOfIds(cno);
+    if (numIds <= 0)
+    {
+      return;
+    }
+
+    const LocatorTuple<TIds>* ids = this->ComputeDistances(cno, numIds, x, data);
+    std::vector<IdTuple>& closest = data.Closest;
+    for (vtkIdType i = 0; i < numIds; ++i)
+    {
+      IdTuple tuple{ ids[i].PtId, data.Distance2[i] };
+      if (static_cast<int>(closest.size()) < N)
+      {
+        closest.push_back(tuple);
+        std::push_heap(closest.begin(), closest.end(), CloserThan);
+      }
+      else if (CloserThan(tuple, closest.front()))
+      {
+        std::pop_heap(closest.begin(), closest.end(), CloserThan);
+        closest.back() = tuple;
+        std::push_heap(closest.begin(), closest.end(), CloserThan);
+      }
+    }
+  }
+
+  void FindClosestNPoints(int N, const double x[3], std::vector<vtkIdType>& result) override
+  {
+    if (N < 1)
+    {
+      return;
+    }
+
+    NeighborQueriesData& data = this->Data.Local();
+    NeighborBuckets* buckets = &data.Buckets;
+    std::vector<IdTuple>& closest = data.Closest;
+    closest.clear();
+
+    // First an expanding wave of buckets until there are enough points, then
+    // the buckets within the distance to the farthest of them.
+    int ijk[3];
+    this->BList->GetBucketIndices(x, ijk);
+
+    int level = 0;
+    this->BList->GetBucketNeighbors(buckets, ijk, this->BList->Divisions, level);
+    while (buckets->GetNumberOfNeighbors() && static_cast<int>(closest.size()) < N)
+    {
+      for (int i = 0; i < buckets->GetNumberOfNeighbors(); i++)
+      {
+        this->AddClosestPoints(N, buckets->GetPoint(i), x, data);
+      }
+      level++;
+      this->BList->GetBucketNeighbors(buckets, ijk, this->BList->Divisions, level);
+    }
+
+    if (static_cast<int>(closest.size()) == N)
+    {
+      this->BList->GetOverlappingBuckets(
+        buckets, x, ijk, sqrt(closest.front().Dist2), level - 1);
+      for (int i = 0; i < buckets->GetNumberOfNeighbors(); i++)
+      {
+        this->AddClosestPoints(N, buckets->GetPoint(i), x, data);
+      }
+    }
+
+    std::sort_heap(closest.begin(), closest.end(), CloserThan);
+    for (const IdTuple& tuple : closest)
+    {
+      result.push_back(tuple.PtId);
+    }
+  }
+
+  void FindPointsWithinRadius(double R, const double x[3], std::vector<vtkIdType>& result) override
+  {
+    NeighborQueriesData& data = this->Data.Local();
+    const double R2 = R * R;
+
+    // Determine the range of indices in each direction based on radius R
+    double xMin[3] = { x[0] - R, x[1] - R, x[2] - R };
+    double xMax[3] = { x[0] + R, x[1] + R, x[2] + R };
+    int ijkMin[3], ijkMax[3];
+    this->BList->GetBucketIndices(xMin, ijkMin);
+    this->BList->GetBucketIndices(xMax, ijkMax);
+
+    for (int k = ijkMin[2]; k <= ijkMax[2]; ++k)
+    {
+      vtkIdType kOffset = k * this->BList->xyD;
+      for (int j = ijkMin[1]; j <= ijkMax[1]; ++j)
+      {
+        vtkIdType jOffset = j * this->BList->xD;
+        for (int i = ijkMin[0]; i <= ijkMax[0]; ++i)
+        {
+          vtkIdType cno = i + jOffset + kOffset;
+          vtkIdType numIds = this->BList->GetNumberOfIds(cno);
+          if (numIds > 0)
+          {
+            const LocatorTuple<TIds>* ids = this->ComputeDistances(cno, numIds, x, data);
+            const double* d2 = data.Distance2.data();
+            for (vtkIdType ii = 0; ii < numIds; ii++)
+            {
+              if (d2[ii] <= R2)
+              {
+                result.push_back(ids[ii].PtId);
+              }
+            }
+          } // if points in bucket
+        }   // i-footprint
+      }     // j-footprint
+    }       // k-footprint
+  }
+};
+
+//------------------------------------------------------------------------------
+template <typename TIds>
+NeighborQueries* BucketList<TIds>::NewNeighborQueries()
+{
+  vtkPointSet* ps = vtkPointSet::SafeDownCast(this->DataSet);
+  if (ps && ps->GetPoints())
+  {
+    int dataType = ps->GetPoints()->GetDataType();
+    void* pts = ps->GetPoints()->GetVoidPointer(0);
+    if (dataType == VTK_FLOAT)
+    {
+      return new BucketNeighborQueries<TIds, PointsArrayAccess<float>>(
+        this, PointsArrayAccess<float>{ static_cast<float*>(pts) });
+    }
+    else if (dataType == VTK_DOUBLE)
+    {
+      return new BucketNeighborQueries<TIds, PointsArrayAccess<double>>(
+        this, PointsArrayAccess<double>{ static_cast<double*>(pts) });
+    }
+  }
+  return new BucketNeighborQueries<TIds, DataSetPointsAccess>(
+    this, DataSetPointsAccess{ this->DataSet });
+}
+
 //------------------------------------------------------------------------------
 // Find the point within tol of the finite line, and closest to the starting
 // point of the line (i.e., min parametric coordinate t).
@@ -2248,6 +2515,48 @@ void vtkStaticPointLocator::FindPointsWithinRadius(double R, const double x[3],
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkStaticPointLocator::FindClosestNPointsBatch(
+  int N, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  std::unique_ptr<NeighborQueries> neighbors(
+    this->Buckets ? this->Buckets->NewNeighborQueries() : nullptr);
+
+  NeighborQueriesArgs args{ neighbors.get(), N, 0.0 };
+  this->FindNeighborsBatch(
+    queries, offsets, ids,
+    [](void* data, const double x[3], std::vector<vtkIdType>& result) {
+      NeighborQueriesArgs* query = static_cast<NeighborQueriesArgs*>(data);
+      if (query->Queries)
+      {
+        query->Queries->FindClosestNPoints(query->N, x, result);
+      }
+    },
+    &args);
+}
+
+//------------------------------------------------------------------------------
+void vtkStaticPointLocator::FindPointsWithinRadiusBatch(
+  double R, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  std::unique_ptr<NeighborQueries> neighbors(
+    this->Buckets ? this->Buckets->NewNeighborQueries() : nullptr);
+
+  NeighborQueriesArgs args{ neighbors.get(), 0, R };
+  this->FindNeighborsBatch(
+    queries, offsets, ids,
+    [](void* data, const double x[3], std::vector<vtkIdType>& result) {
+      NeighborQueriesArgs* query = static_cast<NeighborQueriesArgs*>(data);
+      if (query->Queries)
+      {
+        query->Queries->FindPointsWithinRadius(query->R, x, result);
+      }
+    },
+    &args);
+}
+
 //------------------------------------------------------------------------------
 // This method traverses the locator along the defined ray, finding the
 // closest point to a0 when projected onto the line (a0,a1) (i.e., min
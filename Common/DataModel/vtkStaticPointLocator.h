@@ -150,6 +150,22 @@ public:
    */
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList* result) override;
 
+  ///@{
+  /**
+   * Batched versions of FindClosestNPoints() and FindPointsWithinRadius(),
+   * see vtkAbstractPointLocator. The buckets are traversed concurrently for
+   * each query point, the coordinates of float and double points being read
+   * directly, and the distances to the points of a bucket computed in one
+   * loop. The closest N points of a query point are sorted by distance, then
+   * by id for points at the same distance. The points within a radius are
+   * listed as FindPointsWithinRadius() does.
+   */
+  void FindClosestNPointsBatch(
+    int N, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids) override;
+  void FindPointsWithinRadiusBatch(
+    double R, vtkPoints* queries, vtkIdTypeArray* offsets, vtkIdTypeArray* ids) override;
+  ///@}
+
   /**
    * Intersect the points contained in the locator with the line defined by
    * (a0,a1). Return the point within the tolerance tol that is closest to a0
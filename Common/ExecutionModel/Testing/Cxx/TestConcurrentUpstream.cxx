@@ -0,0 +1,295 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentUpstream.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the concurrent update of the independent input branches of a filter.
+
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+std::atomic<int> NumberOfExecutions(0);
+
+// Key set on the request by the sources, as streaming executives set keys
+// such as CONTINUE_EXECUTING, and read by the consumer.
+vtkInformationIntegerKey* SOURCE_EXECUTED()
+{
+  static vtkInformationIntegerKey* key =
+    vtkInformationIntegerKey::MakeKey("SOURCE_EXECUTED", "TestConcurrentUpstream");
+  return key;
+}
+
+// Number of filters reading the shared input at the same time.
+std::atomic<int> NumberOfReaders(0);
+std::atomic<bool> ConcurrentReads(false);
+
+// Produces NumberOfPoints points, or passes its input with one more point.
+class vtkTestPointsAlgorithm : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestPointsAlgorithm* New();
+  vtkTypeMacro(vtkTestPointsAlgorithm, vtkPolyDataAlgorithm);
+
+  vtkSetMacro(NumberOfPoints, int);
+
+  void SetIsSource() { this->SetNumberOfInputPorts(0); }
+
+protected:
+  vtkTestPointsAlgorithm() = default;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    ++NumberOfExecutions;
+    vtkNew<vtkPoints> points;
+    if (this->GetNumberOfInputPorts() > 0)
+    {
+      // Reading the shared input while another filter reads it would race
+      // with the caches of the data object.
+      if (++NumberOfReaders > 1)
+      {
+        ConcurrentReads = true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      points->DeepCopy(vtkPolyData::GetData(inputVector[0])->GetPoints());
+      points->InsertNextPoint(0, 0, 0);
+      --NumberOfReaders;
+    }
+    else
+    {
+      request->Set(SOURCE_EXECUTED(), 1);
+      for (int i = 0; i < this->NumberOfPoints; ++i)
+      {
+        points->InsertNextPoint(i, 0, 0);
+      }
+    }
+    vtkPolyData::GetData(outputVector)->SetPoints(points);
+    return 1;
+  }
+
+  int NumberOfPoints = 0;
+
+private:
+  vtkTestPointsAlgorithm(const vtkTestPointsAlgorithm&) = delete;
+  void operator=(const vtkTestPointsAlgorithm&) = delete;
+};
+vtkStandardNewMacro(vtkTestPointsAlgorithm);
+
+// Counts the points of all its input connections, and produces as many points.
+class vtkTestCountAlgorithm : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestCountAlgorithm* New();
+  vtkTypeMacro(vtkTestCountAlgorithm, vtkPolyDataAlgorithm);
+
+  vtkIdType Count = 0;
+  bool SourceExecuted = false;
+
+protected:
+  vtkTestCountAlgorithm() = default;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override
+  {
+    info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
+    return this->Superclass::FillInputPortInformation(port, info);
+  }
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    ++NumberOfExecutions;
+    this->SourceExecuted = request->Has(SOURCE_EXECUTED());
+    this->Count = 0;
+    for (int i = 0; i < inputVector[0]->GetNumberOfInformationObjects(); ++i)
+    {
+      this->Count += vtkPolyData::GetData(inputVector[0], i)->GetNumberOfPoints();
+    }
+    vtkNew<vtkPoints> points;
+    points->SetNumberOfPoints(this->Count);
+    for (vtkIdType i = 0; i < this->Count; ++i)
+    {
+      points->SetPoint(i, static_cast<double>(i), 0, 0);
+    }
+    vtkPolyData::GetData(outputVector)->SetPoints(points);
+    return 1;
+  }
+
+private:
+  vtkTestCountAlgorithm(const vtkTestCountAlgorithm&) = delete;
+  void operator=(const vtkTestCountAlgorithm&) = delete;
+};
+vtkStandardNewMacro(vtkTestCountAlgorithm);
+}
+
+int TestBranches()
+{
+  // Four independent branches of a source and two filters, and two branches
+  // sharing a source.
+  vtkNew<vtkTestCountAlgorithm> count;
+  vtkNew<vtkTestPointsAlgorithm> sources[5];
+  vtkNew<vtkTestPointsAlgorithm> filters[12];
+  for (int i = 0; i < 5; ++i)
+  {
+    sources[i]->SetIsSource();
+    sources[i]->SetNumberOfPoints(10 * (i + 1));
+  }
+  for (int i = 0; i < 6; ++i)
+  {
+    filters[2 * i]->SetInputConnection(sources[i < 5 ? i : 4]->GetOutputPort());
+    filters[2 * i + 1]->SetInputConnection(filters[2 * i]->GetOutputPort());
+    count->AddInputConnection(filters[2 * i + 1]->GetOutputPort());
+  }
+  vtkDemandDrivenPipeline* executive =
+    vtkDemandDrivenPipeline::SafeDownCast(count->GetExecutive());
+  VTK_TEST_CHECK(executive && !executive->GetConcurrentUpstream());
+
+  // Sequential reference.
+  count->Update();
+  const vtkIdType expected = 10 + 20 + 30 + 40 + 50 + 50 + 6 * 2;
+  VTK_TEST_CHECK(count->Count == expected);
+  VTK_TEST_CHECK(NumberOfExecutions == 5 + 12 + 1);
+  VTK_TEST_CHECK(count->SourceExecuted);
+
+  // Concurrent updates give the same result, and only execute what changed.
+  executive->ConcurrentUpstreamOn();
+  const int numberOfThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  NumberOfExecutions = 0;
+  count->Update();
+  VTK_TEST_CHECK(NumberOfExecutions == 0);
+  for (auto& source : sources)
+  {
+    source->Modified();
+  }
+  count->Update();
+  VTK_TEST_CHECK(count->Count == expected);
+  VTK_TEST_CHECK(NumberOfExecutions == 5 + 12 + 1);
+  // The keys set by the sources on the copies of the request are merged back.
+  VTK_TEST_CHECK(count->SourceExecuted);
+  // The configuration of vtkSMPTools is restored.
+  VTK_TEST_CHECK(!vtkSMPTools::GetNestedParallelism());
+  VTK_TEST_CHECK(vtkSMPTools::GetEstimatedNumberOfThreads() == numberOfThreads);
+
+  NumberOfExecutions = 0;
+  sources[2]->SetNumberOfPoints(100);
+  count->Update();
+  VTK_TEST_CHECK(count->Count == expected + 70);
+  VTK_TEST_CHECK(NumberOfExecutions == 1 + 2 + 1);
+
+  // Only the shared branches are updated.
+  NumberOfExecutions = 0;
+  sources[4]->SetNumberOfPoints(1);
+  count->Update();
+  VTK_TEST_CHECK(count->Count == expected + 70 - 2 * 49);
+  VTK_TEST_CHECK(NumberOfExecutions == 1 + 4 + 1);
+  return EXIT_SUCCESS;
+}
+
+int TestSharedInput()
+{
+  // Filters reading the same data object through their own trivial
+  // producers are not executed concurrently.
+  vtkNew<vtkPolyData> input;
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 10; ++i)
+  {
+    points->InsertNextPoint(i, 1, 0);
+  }
+  input->SetPoints(points);
+  vtkNew<vtkTestCountAlgorithm> count;
+  vtkNew<vtkTestPointsAlgorithm> filters[4];
+  for (auto& filter : filters)
+  {
+    filter->SetInputData(input);
+    count->AddInputConnection(filter->GetOutputPort());
+  }
+  vtkDemandDrivenPipeline::SafeDownCast(count->GetExecutive())->ConcurrentUpstreamOn();
+  NumberOfExecutions = 0;
+  ConcurrentReads = false;
+  count->Update();
+  VTK_TEST_CHECK(count->Count == 4 * 11);
+  VTK_TEST_CHECK(NumberOfExecutions == 4 + 1);
+  VTK_TEST_CHECK(!ConcurrentReads);
+  return EXIT_SUCCESS;
+}
+
+int TestNestedFanIn()
+{
+  // Consumers updating their branches concurrently, themselves updated
+  // concurrently by another consumer: the inner branches are forwarded from
+  // the worker threads.
+  vtkNew<vtkTestCountAlgorithm> count;
+  vtkNew<vtkTestCountAlgorithm> inner[3];
+  vtkNew<vtkTestPointsAlgorithm> sources[6];
+  vtkNew<vtkTestPointsAlgorithm> filters[6];
+  for (int i = 0; i < 6; ++i)
+  {
+    sources[i]->SetIsSource();
+    sources[i]->SetNumberOfPoints(i + 1);
+    filters[i]->SetInputConnection(sources[i]->GetOutputPort());
+    inner[i / 2]->AddInputConnection(filters[i]->GetOutputPort());
+  }
+  for (auto& consumer : inner)
+  {
+    vtkDemandDrivenPipeline::SafeDownCast(consumer->GetExecutive())->ConcurrentUpstreamOn();
+    count->AddInputConnection(consumer->GetOutputPort());
+  }
+  vtkDemandDrivenPipeline::SafeDownCast(count->GetExecutive())->ConcurrentUpstreamOn();
+
+  NumberOfExecutions = 0;
+  count->Update();
+  VTK_TEST_CHECK(count->Count == 1 + 2 + 3 + 4 + 5 + 6 + 6);
+  VTK_TEST_CHECK(inner[0]->Count == 1 + 2 + 2);
+  VTK_TEST_CHECK(inner[1]->Count == 3 + 4 + 2);
+  VTK_TEST_CHECK(inner[2]->Count == 5 + 6 + 2);
+  VTK_TEST_CHECK(NumberOfExecutions == 6 + 6 + 3 + 1);
+  VTK_TEST_CHECK(count->SourceExecuted);
+
+  NumberOfExecutions = 0;
+  sources[3]->SetNumberOfPoints(10);
+  count->Update();
+  VTK_TEST_CHECK(count->Count == 1 + 2 + 3 + 10 + 5 + 6 + 6);
+  VTK_TEST_CHECK(NumberOfExecutions == 1 + 1 + 1 + 1);
+  return EXIT_SUCCESS;
+}
+
+int TestConcurrentUpstream(int, char*[])
+{
+  // Several threads, even on a single core, so that the branches overlap.
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+
+  int result = EXIT_SUCCESS;
+  for (auto test : { TestBranches, TestSharedInput, TestNestedFanIn })
+  {
+    NumberOfExecutions = 0;
+    if (test() != EXIT_SUCCESS)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
@@ -53,6 +53,7 @@ vtkDemandDrivenPipeline::vtkDemandDrivenPipeline()
   this->DataObjectRequest = nullptr;
   this->DataRequest = nullptr;
   this->PipelineMTime = 0;
+  this->ConcurrentUpstream = false;
 }
 
 //------------------------------------------------------------------------------
@@ -77,6 +78,13 @@ void vtkDemandDrivenPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "PipelineMTime: " << this->PipelineMTime << "\n";
+  os << indent << "ConcurrentUpstream: " << (this->ConcurrentUpstream ? "On" : "Off") << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkDemandDrivenPipeline::CanForwardConcurrently(vtkInformation* request)
+{
+  return this->ConcurrentUpstream && request->Has(REQUEST_DATA());
 }
 
 //------------------------------------------------------------------------------
@@ -92,6 +92,27 @@ public:
    */
   virtual int GetReleaseDataFlag(int port);
 
+  ///@{
+  /**
+   * When on, the REQUEST_DATA pass is forwarded concurrently to the input
+   * connections of the algorithm whose upstream pipelines are independent,
+   * i.e. share no algorithm nor data object, using vtkSMPTools. A fan-in
+   * filter such as vtkAppendPolyData then executes its input branches in
+   * parallel instead of one after the other. Connections sharing an upstream
+   * algorithm or data object are still updated sequentially. The other passes
+   * are never concurrent. The vtkSMPTools loops of the branches run in
+   * parallel too, and their arrays use the vtkMemoryResource::DefaultScope of
+   * the thread updating the pipeline.
+   *
+   * The algorithms of the branches, and the observers of their events such as
+   * progress, must tolerate being executed from different threads. Off by
+   * default.
+   */
+  vtkSetMacro(ConcurrentUpstream, vtkTypeBool);
+  vtkGetMacro(ConcurrentUpstream, vtkTypeBool);
+  vtkBooleanMacro(ConcurrentUpstream, vtkTypeBool);
+  ///@}
+
   /**
    * Bring the PipelineMTime up to date.
    */
@@ -213,6 +234,9 @@ protected:
   virtual void MarkOutputsGenerated(
     vtkInformation* request, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec);
 
+  // Forward REQUEST_DATA concurrently when ConcurrentUpstream is on.
+  bool CanForwardConcurrently(vtkInformation* request) override;
+
   // Largest MTime of any algorithm on this executive or preceding
   // executives.
   vtkMTimeType PipelineMTime;
@@ -222,6 +246,8 @@ protected:
   vtkTimeStamp InformationTime;
   vtkTimeStamp DataTime;
 
+  vtkTypeBool ConcurrentUpstream;
+
   friend class vtkCompositeDataPipeline;
 
   vtkInformation* InfoRequest;
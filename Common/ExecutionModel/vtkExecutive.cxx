@@ -25,10 +25,17 @@
 #include "vtkInformationIterator.h"
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationVector.h"
+#include "vtkMemoryResource.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "vtkCompositeDataPipeline.h"
@@ -55,6 +62,175 @@ public:
 //------------------------------------------------------------------------------
 vtkExecutiveInternals::vtkExecutiveInternals() = default;
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Groups the producers whose upstream pipelines share an executive or a data
+// object, such as a data object given as input to several filters. Distinct
+// groups can process a request concurrently, the producers of a group cannot.
+std::vector<std::vector<std::size_t>> GroupProducers(
+  const std::vector<std::pair<vtkExecutive*, int>>& producers)
+{
+  // The group owning each executive and data object visited so far.
+  std::map<vtkObjectBase*, std::size_t> owners;
+  std::vector<std::size_t> groupOf(producers.size());
+  for (std::size_t p = 0; p < producers.size(); ++p)
+  {
+    groupOf[p] = p;
+    std::set<vtkObjectBase*> branch;
+    std::vector<vtkExecutive*> stack{ producers[p].first };
+    while (!stack.empty())
+    {
+      vtkExecutive* e = stack.back();
+      stack.pop_back();
+      if (!branch.insert(e).second)
+      {
+        continue;
+      }
+      for (int i = 0; i < e->GetNumberOfOutputPorts(); ++i)
+      {
+        vtkDataObject* output = e->GetOutputInformation(i)->Get(vtkDataObject::DATA_OBJECT());
+        if (output)
+        {
+          branch.insert(output);
+        }
+      }
+      for (int i = 0; i < e->GetNumberOfInputPorts(); ++i)
+      {
+        vtkInformationVector* inVector = e->GetInputInformation()[i];
+        for (int j = 0; j < inVector->GetNumberOfInformationObjects(); ++j)
+        {
+          vtkExecutive* upstream;
+          int port;
+          vtkExecutive::PRODUCER()->Get(inVector->GetInformationObject(j), upstream, port);
+          if (upstream)
+          {
+            stack.push_back(upstream);
+          }
+        }
+      }
+    }
+    // Merge the groups of the previous producers sharing an object.
+    for (vtkObjectBase* object : branch)
+    {
+      auto owner = owners.find(object);
+      if (owner != owners.end() && groupOf[owner->second] != p)
+      {
+        const std::size_t merged = groupOf[owner->second];
+        std::replace(groupOf.begin(), groupOf.begin() + p, merged, p);
+      }
+      owners[object] = p;
+    }
+  }
+
+  std::map<std::size_t, std::size_t> groupIds;
+  std::vector<std::vector<std::size_t>> groups;
+  for (std::size_t p = 0; p < producers.size(); ++p)
+  {
+    auto inserted = groupIds.emplace(groupOf[p], groups.size());
+    if (inserted.second)
+    {
+      groups.emplace_back();
+    }
+    groups[inserted.first->second].push_back(p);
+  }
+  return groups;
+}
+
+//------------------------------------------------------------------------------
+// Sends a request to the groups of producers concurrently, the producers of
+// each group being updated sequentially.
+int ForwardToGroups(vtkInformation* request,
+  const std::vector<std::pair<vtkExecutive*, int>>& producers,
+  const std::vector<std::vector<std::size_t>>& groups)
+{
+  // Each group updates its own copy of the request, as the producers set
+  // keys such as FROM_OUTPUT_PORT on it. The copies are created and released
+  // here rather than in the worker threads.
+  std::vector<vtkSmartPointer<vtkInformation>> groupRequests(groups.size());
+  for (auto& groupRequest : groupRequests)
+  {
+    groupRequest = vtkSmartPointer<vtkInformation>::New();
+    groupRequest->Copy(request);
+    // The request key itself is not one of the copied entries.
+    groupRequest->SetRequest(request->GetRequest());
+  }
+  std::vector<vtkInformationKey*> keys;
+  vtkNew<vtkInformationIterator> iterator;
+  iterator->SetInformationWeak(request);
+  for (iterator->InitTraversal(); !iterator->IsDoneWithTraversal(); iterator->GoToNextItem())
+  {
+    keys.push_back(iterator->GetCurrentKey());
+  }
+
+  // The arrays created in the branches use the memory resource of the
+  // calling thread, as they would in a sequential update.
+  vtkSmartPointer<vtkMemoryResource> resource = vtkMemoryResource::GetDefaultResource();
+
+  std::vector<int> results(groups.size(), 1);
+  auto forwardGroups = [&]() {
+    vtkSMPTools::For(
+      0, static_cast<vtkIdType>(groups.size()), 1, [&](vtkIdType begin, vtkIdType end) {
+        vtkMemoryResource::DefaultScope scope(resource);
+        for (vtkIdType g = begin; g < end; ++g)
+        {
+          vtkInformation* groupRequest = groupRequests[g];
+          for (std::size_t p : groups[g])
+          {
+            vtkExecutive* e = producers[p].first;
+            groupRequest->Set(vtkExecutive::FROM_OUTPUT_PORT(), producers[p].second);
+            if (!e->ProcessRequest(
+                  groupRequest, e->GetInputInformation(), e->GetOutputInformation()))
+            {
+              results[g] = 0;
+            }
+          }
+        }
+      });
+  };
+
+  // The filters of the branches may use vtkSMPTools themselves: let their
+  // loops run in parallel within the loop over the groups. The scope restores
+  // the configuration of vtkSMPTools on exit, exceptions included.
+  if (!vtkSMPTools::IsParallelScope())
+  {
+    const vtkSMPTools::Config nested{ vtkSMPTools::GetEstimatedNumberOfThreads(),
+      vtkSMPTools::GetBackend(), true };
+    vtkSMPTools::LocalScope(nested, forwardGroups);
+  }
+  else
+  {
+    forwardGroups();
+  }
+
+  // Merge the keys set or removed by the producers back into the request, in
+  // the order of the connections, as if it had been forwarded sequentially.
+  const int port = request->Get(vtkExecutive::FROM_OUTPUT_PORT());
+  for (vtkInformation* groupRequest : groupRequests)
+  {
+    iterator->SetInformationWeak(groupRequest);
+    for (iterator->InitTraversal(); !iterator->IsDoneWithTraversal(); iterator->GoToNextItem())
+    {
+      request->CopyEntry(groupRequest, iterator->GetCurrentKey());
+    }
+  }
+  for (vtkInformationKey* key : keys)
+  {
+    for (vtkInformation* groupRequest : groupRequests)
+    {
+      if (!groupRequest->Has(key))
+      {
+        request->Remove(key);
+        break;
+      }
+    }
+  }
+  request->Set(vtkExecutive::FROM_OUTPUT_PORT(), port);
+
+  return std::find(results.begin(), results.end(), 0) == results.end() ? 1 : 0;
+}
+}
+
 //------------------------------------------------------------------------------
 vtkExecutiveInternals::~vtkExecutiveInternals()
 {
@@ -590,7 +766,22 @@ int vtkExecutive::ForwardUpstream(vtkInformation* request)
   }
 
   // Forward the request upstream through all input connections.
-  int result = 1;
+  int result = this->ForwardToProducers(request);
+
+  if (!this->Algorithm->ModifyRequest(request, AfterForward))
+  {
+    return 0;
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkExecutive::ForwardToProducers(vtkInformation* request)
+{
+  // Get the executives producing the inputs.  Connections without one are
+  // nullptr inputs.
+  std::vector<std::pair<vtkExecutive*, int>> producers;
   for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
   {
     int nic = this->Algorithm->GetNumberOfInputConnections(i);
@@ -598,32 +789,46 @@ int vtkExecutive::ForwardUpstream(vtkInformation* request)
     for (int j = 0; j < nic; ++j)
     {
       vtkInformation* info = inVector->GetInformationObject(j);
-      // Get the executive producing this input.  If there is none, then
-      // it is a nullptr input.
       vtkExecutive* e;
       int producerPort;
       vtkExecutive::PRODUCER()->Get(info, e, producerPort);
       if (e)
       {
-        int port = request->Get(FROM_OUTPUT_PORT());
-        request->Set(FROM_OUTPUT_PORT(), producerPort);
-        if (!e->ProcessRequest(request, e->GetInputInformation(), e->GetOutputInformation()))
-        {
-          result = 0;
-        }
-        request->Set(FROM_OUTPUT_PORT(), port);
+        producers.emplace_back(e, producerPort);
       }
     }
   }
 
-  if (!this->Algorithm->ModifyRequest(request, AfterForward))
+  if (producers.size() > 1 && this->CanForwardConcurrently(request))
   {
-    return 0;
+    auto groups = GroupProducers(producers);
+    if (groups.size() > 1)
+    {
+      return ForwardToGroups(request, producers, groups);
+    }
   }
 
+  int result = 1;
+  for (const auto& producer : producers)
+  {
+    vtkExecutive* e = producer.first;
+    int port = request->Get(FROM_OUTPUT_PORT());
+    request->Set(FROM_OUTPUT_PORT(), producer.second);
+    if (!e->ProcessRequest(request, e->GetInputInformation(), e->GetOutputInformation()))
+    {
+      result = 0;
+    }
+    request->Set(FROM_OUTPUT_PORT(), port);
+  }
   return result;
 }
 
+//------------------------------------------------------------------------------
+bool vtkExecutive::CanForwardConcurrently(vtkInformation*)
+{
+  return false;
+}
+
 //------------------------------------------------------------------------------
 void vtkExecutive::CopyDefaultInformation(vtkInformation* request, int direction,
   vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
@@ -253,6 +253,24 @@ protected:
 
   virtual int ForwardDownstream(vtkInformation* request);
   virtual int ForwardUpstream(vtkInformation* request);
+
+  /**
+   * Send @a request to the producers of all the input connections, as done by
+   * ForwardUpstream(). When CanForwardConcurrently() accepts the request,
+   * the connections whose upstream pipelines share an executive or a data
+   * object are grouped, and the groups process their own copy of the request
+   * concurrently through vtkSMPTools, with nested parallelism enabled. The
+   * keys set on the copies are then merged back into @a request.
+   * Returns 0 if a producer failed.
+   */
+  int ForwardToProducers(vtkInformation* request);
+
+  /**
+   * Whether ForwardToProducers() may process @a request concurrently in
+   * independent input pipelines. Returns false by default.
+   */
+  virtual bool CanForwardConcurrently(vtkInformation* request);
+
   virtual void CopyDefaultInformation(vtkInformation* request, int direction,
     vtkInformationVector** inInfo, vtkInformationVector* outInfo);
 
@@ -442,7 +442,7 @@ int AppendDatasetsAndPrint(const std::vector<vtkPolyData*>& inputs)
   return AppendDatasetsAndCheckMergedArrayLengths(append);
 }
 
-bool TestToleranceModes()
+bool TestToleranceModes(bool useStaticPointLocator)
 {
   vtkNew<vtkPoints> points1;
   points1->InsertNextPoint(0.0, 0.0, 0.0);
@@ -473,6 +473,7 @@ bool TestToleranceModes()
   double tolerance = 0.25;
   vtkNew<vtkAppendFilter> append;
   append->MergePointsOn();
+  append->SetUseStaticPointLocator(useStaticPointLocator);
   append->SetTolerance(tolerance);
   append->ToleranceIsAbsoluteOff();
   append->AddInputData(polydata1);
@@ -809,11 +810,19 @@ int TestAppendFilter(int, char*[])
 
   std::cout << "===========================================================\n";
   std::cout << "Testing tolerance modes.\n";
-  if (!TestToleranceModes())
+  if (!TestToleranceModes(false))
   {
     std::cerr << "vtkAppendFilter failed testing tolerances.\n";
     return EXIT_FAILURE;
   }
 
+  std::cout << "===========================================================\n";
+  std::cout << "Testing tolerance modes with a static point locator.\n";
+  if (!TestToleranceModes(true))
+  {
+    std::cerr << "vtkAppendFilter failed testing tolerances with a static point locator.\n";
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
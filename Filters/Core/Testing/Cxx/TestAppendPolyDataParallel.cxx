@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAppendPolyDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the concurrent copy of the inputs of vtkAppendPolyData and
+// vtkAppendFilter to their place in the output, and the pass-through of a
+// single non-empty input.
+
+#include "vtkAppendFilter.h"
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkStringArray.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+// The input i has 10 + 3 * i points, and cells of every type. The values of
+// its attributes are unique among all inputs.
+vtkSmartPointer<vtkPolyData> MakeInput(int i)
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  const vtkIdType numPts = 10 + 3 * i;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> pointValues;
+  pointValues->SetName("PointValues");
+  vtkNew<vtkStringArray> pointNames;
+  pointNames->SetName("PointNames");
+  for (vtkIdType k = 0; k < numPts; ++k)
+  {
+    points->InsertNextPoint(k, i, 0.5 * k);
+    pointValues->InsertNextValue(1000 * i + k);
+    pointNames->InsertNextValue(std::to_string(i) + "_" + std::to_string(k));
+  }
+  input->SetPoints(points);
+  input->GetPointData()->AddArray(pointValues);
+  input->GetPointData()->AddArray(pointNames);
+
+  vtkNew<vtkCellArray> verts, lines, polys, strips;
+  for (vtkIdType k = 0; k < numPts; k += 3)
+  {
+    verts->InsertNextCell(1, &k);
+  }
+  for (vtkIdType k = 0; k + 1 < numPts && k < 2 + i; ++k)
+  {
+    const vtkIdType line[2] = { k, k + 1 };
+    lines->InsertNextCell(2, line);
+  }
+  for (vtkIdType k = 1; k + 3 < numPts; k += 2)
+  {
+    const vtkIdType quad[4] = { k, k + 1, k + 3, k + 2 };
+    polys->InsertNextCell(k % 4 == 1 ? 3 : 4, quad);
+  }
+  if (i % 2 == 1)
+  {
+    const vtkIdType strip[5] = { 0, 1, 2, 3, 4 };
+    strips->InsertNextCell(5, strip);
+  }
+  input->SetVerts(verts);
+  input->SetLines(lines);
+  input->SetPolys(polys);
+  input->SetStrips(strips);
+
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->SetNumberOfComponents(2);
+  vtkNew<vtkStringArray> cellNames;
+  cellNames->SetName("CellNames");
+  for (vtkIdType c = 0; c < input->GetNumberOfCells(); ++c)
+  {
+    cellValues->InsertNextTuple2(1000 * i + c, -c);
+    cellNames->InsertNextValue(std::to_string(i) + "_" + std::to_string(c));
+  }
+  input->GetCellData()->AddArray(cellValues);
+  input->GetCellData()->AddArray(cellNames);
+  return input;
+}
+
+bool SameCell(vtkCellArray* expected, vtkIdType expectedId, vtkIdType ptOffset,
+  vtkCellArray* actual, vtkIdType actualId)
+{
+  vtkNew<vtkIdList> e, a;
+  expected->GetCellAtId(expectedId, e);
+  actual->GetCellAtId(actualId, a);
+  if (e->GetNumberOfIds() != a->GetNumberOfIds())
+  {
+    return false;
+  }
+  for (vtkIdType j = 0; j < e->GetNumberOfIds(); ++j)
+  {
+    if (e->GetId(j) + ptOffset != a->GetId(j))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameTuple(vtkAbstractArray* expected, vtkIdType expectedId, vtkAbstractArray* actual,
+  vtkIdType actualId)
+{
+  for (int c = 0; c < expected->GetNumberOfComponents(); ++c)
+  {
+    const vtkIdType e = expectedId * expected->GetNumberOfComponents() + c;
+    const vtkIdType a = actualId * actual->GetNumberOfComponents() + c;
+    if (expected->GetVariantValue(e) != actual->GetVariantValue(a))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameTuples(vtkDataSetAttributes* expected, vtkIdType expectedId,
+  vtkDataSetAttributes* actual, vtkIdType actualId)
+{
+  for (int i = 0; i < expected->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray* e = expected->GetAbstractArray(i);
+    vtkAbstractArray* a = actual->GetAbstractArray(e->GetName());
+    if (!a || !SameTuple(e, expectedId, a, actualId))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int TestAppendPolyData(const std::vector<vtkSmartPointer<vtkPolyData>>& inputs)
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (const auto& input : inputs)
+  {
+    append->AddInputData(input);
+  }
+  append->Update();
+  vtkPolyData* output = append->GetOutput();
+
+  // The cells of each type of all inputs, then the ones of the next type.
+  vtkIdType numTypeCells[4] = { 0, 0, 0, 0 };
+  for (const auto& input : inputs)
+  {
+    numTypeCells[0] += input->GetNumberOfVerts();
+    numTypeCells[1] += input->GetNumberOfLines();
+    numTypeCells[2] += input->GetNumberOfPolys();
+    numTypeCells[3] += input->GetNumberOfStrips();
+  }
+  const vtkIdType typeStarts[4] = { 0, numTypeCells[0], numTypeCells[0] + numTypeCells[1],
+    numTypeCells[0] + numTypeCells[1] + numTypeCells[2] };
+  vtkIdType typeOffsets[4] = { 0, 0, 0, 0 };
+  vtkIdType ptOffset = 0;
+  for (const auto& input : inputs)
+  {
+    for (vtkIdType k = 0; k < input->GetNumberOfPoints(); ++k)
+    {
+      double e[3], a[3];
+      input->GetPoint(k, e);
+      output->GetPoint(ptOffset + k, a);
+      VTK_TEST_CHECK(e[0] == a[0] && e[1] == a[1] && e[2] == a[2]);
+      VTK_TEST_CHECK(SameTuples(input->GetPointData(), k, output->GetPointData(), ptOffset + k));
+    }
+
+    vtkCellArray* inCells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(),
+      input->GetStrips() };
+    vtkCellArray* outCells[4] = { output->GetVerts(), output->GetLines(), output->GetPolys(),
+      output->GetStrips() };
+    vtkIdType inCellId = 0;
+    for (int type = 0; type < 4; ++type)
+    {
+      for (vtkIdType c = 0; c < inCells[type]->GetNumberOfCells(); ++c, ++inCellId)
+      {
+        VTK_TEST_CHECK(SameCell(inCells[type], c, ptOffset, outCells[type], typeOffsets[type] + c));
+        VTK_TEST_CHECK(SameTuples(input->GetCellData(), inCellId, output->GetCellData(),
+          typeStarts[type] + typeOffsets[type] + c));
+      }
+      typeOffsets[type] += inCells[type]->GetNumberOfCells();
+    }
+    ptOffset += input->GetNumberOfPoints();
+  }
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == ptOffset);
+  VTK_TEST_CHECK(output->GetNumberOfCells() == typeStarts[3] + numTypeCells[3]);
+  return EXIT_SUCCESS;
+}
+
+int TestAppendFilter(const std::vector<vtkSmartPointer<vtkPolyData>>& inputs)
+{
+  vtkNew<vtkAppendFilter> append;
+  for (const auto& input : inputs)
+  {
+    append->AddInputData(input);
+  }
+  append->Update();
+  vtkUnstructuredGrid* output = append->GetOutput();
+
+  vtkIdType ptOffset = 0;
+  vtkIdType cellOffset = 0;
+  vtkNew<vtkIdList> e, a;
+  for (const auto& input : inputs)
+  {
+    for (vtkIdType k = 0; k < input->GetNumberOfPoints(); ++k)
+    {
+      VTK_TEST_CHECK(SameTuples(input->GetPointData(), k, output->GetPointData(), ptOffset + k));
+    }
+    for (vtkIdType c = 0; c < input->GetNumberOfCells(); ++c)
+    {
+      VTK_TEST_CHECK(input->GetCellType(c) == output->GetCellType(cellOffset + c));
+      input->GetCellPoints(c, e);
+      output->GetCellPoints(cellOffset + c, a);
+      VTK_TEST_CHECK(e->GetNumberOfIds() == a->GetNumberOfIds());
+      for (vtkIdType j = 0; j < e->GetNumberOfIds(); ++j)
+      {
+        VTK_TEST_CHECK(e->GetId(j) + ptOffset == a->GetId(j));
+      }
+      VTK_TEST_CHECK(SameTuples(input->GetCellData(), c, output->GetCellData(), cellOffset + c));
+    }
+    ptOffset += input->GetNumberOfPoints();
+    cellOffset += input->GetNumberOfCells();
+  }
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == ptOffset);
+  VTK_TEST_CHECK(output->GetNumberOfCells() == cellOffset);
+
+  // Merging with a static point locator: the points are all distinct, until
+  // the first point of the second input is moved onto the first point of the
+  // first input.
+  append->MergePointsOn();
+  append->UseStaticPointLocatorOn();
+  append->Update();
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == ptOffset);
+  inputs[1]->GetPoints()->SetPoint(0, 0, 0, 0);
+  inputs[1]->Modified();
+  append->Update();
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == ptOffset - 1);
+  VTK_TEST_CHECK(output->GetNumberOfCells() == cellOffset);
+  const vtkIdType numFirstPts = inputs[0]->GetNumberOfPoints();
+  for (vtkIdType c = 0; c < inputs[1]->GetNumberOfCells(); ++c)
+  {
+    output->GetCellPoints(inputs[0]->GetNumberOfCells() + c, a);
+    inputs[1]->GetCellPoints(c, e);
+    for (vtkIdType j = 0; j < e->GetNumberOfIds(); ++j)
+    {
+      const vtkIdType expected = e->GetId(j) == 0 ? 0 : e->GetId(j) + numFirstPts - 1;
+      VTK_TEST_CHECK(a->GetId(j) == expected);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestAppendPolyDataParallel(int, char*[])
+{
+  std::vector<vtkSmartPointer<vtkPolyData>> inputs;
+  for (int i = 0; i < 6; ++i)
+  {
+    inputs.push_back(MakeInput(i));
+  }
+  // An empty input is skipped.
+  inputs.insert(inputs.begin() + 2, vtkSmartPointer<vtkPolyData>::New());
+
+  VTK_TEST_CHECK(TestAppendPolyData(inputs) == EXIT_SUCCESS);
+
+  // Without the string arrays, all the arrays are copied concurrently.
+  for (const auto& input : inputs)
+  {
+    input->GetPointData()->RemoveArray("PointNames");
+    input->GetCellData()->RemoveArray("CellNames");
+  }
+  VTK_TEST_CHECK(TestAppendPolyData(inputs) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestAppendFilter(inputs) == EXIT_SUCCESS);
+
+  // A single non-empty input is passed through, unless its points must be
+  // converted.
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputData(vtkNew<vtkPolyData>());
+  append->AddInputData(inputs[0]);
+  append->Update();
+  VTK_TEST_CHECK(append->GetOutput()->GetPoints() == inputs[0]->GetPoints());
+  append->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  append->Update();
+  VTK_TEST_CHECK(append->GetOutput()->GetPoints()->GetDataType() == VTK_DOUBLE);
+  VTK_TEST_CHECK(append->GetOutput()->GetNumberOfCells() == inputs[0]->GetNumberOfCells());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the parallel point merging of vtkCleanPolyData with the serial one,
+// on exact duplicates, clusters of close points and degenerate cells.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+// A grid of quads which do not share their points, each point being moved by
+// less than jitter. Lines and strips are added along the borders.
+vtkSmartPointer<vtkPolyData> MakeInput(int dim, double jitter)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines, polys, strips;
+  vtkNew<vtkDoubleArray> pointValues;
+  pointValues->SetName("PointValues");
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  auto addPoint = [&](int i, int j) {
+    const vtkIdType id = points->GetNumberOfPoints();
+    const double dx = jitter * std::sin(0.7 * id);
+    const double dy = jitter * std::cos(1.3 * id);
+    pointValues->InsertNextValue(static_cast<double>(id));
+    return points->InsertNextPoint(i + dx, j + dy, 0.0);
+  };
+  for (int j = 0; j < dim; ++j)
+  {
+    for (int i = 0; i < dim; ++i)
+    {
+      const vtkIdType quad[4] = { addPoint(i, j), addPoint(i + 1, j), addPoint(i + 1, j + 1),
+        addPoint(i, j + 1) };
+      polys->InsertNextCell(4, quad);
+    }
+    const vtkIdType line[2] = { addPoint(0, j), addPoint(0, j + 1) };
+    lines->InsertNextCell(2, line);
+    const vtkIdType strip[4] = { addPoint(dim, j), addPoint(dim + 1, j), addPoint(dim, j + 1),
+      addPoint(dim + 1, j + 1) };
+    strips->InsertNextCell(4, strip);
+  }
+  // Cells which degenerate once their points are merged.
+  const vtkIdType collapsedPoly[4] = { addPoint(0, 0), addPoint(0, 0), addPoint(1, 0),
+    addPoint(1, 0) };
+  polys->InsertNextCell(4, collapsedPoly);
+  const vtkIdType pointPoly[3] = { addPoint(2, 0), addPoint(2, 0), addPoint(2, 0) };
+  polys->InsertNextCell(3, pointPoly);
+  const vtkIdType closedLine[3] = { addPoint(0, 0), addPoint(0, 1), addPoint(0, 0) };
+  lines->InsertNextCell(3, closedLine);
+  const vtkIdType pointLine[2] = { addPoint(3, 3), addPoint(3, 3) };
+  lines->InsertNextCell(2, pointLine);
+  const vtkIdType triangleStrip[4] = { addPoint(0, 0), addPoint(1, 0), addPoint(1, 0),
+    addPoint(0, 1) };
+  strips->InsertNextCell(4, triangleStrip);
+  // Unused points are dropped.
+  addPoint(-5, -5);
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->SetLines(lines);
+  input->SetPolys(polys);
+  input->SetStrips(strips);
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+  {
+    cellIds->InsertNextValue(i);
+  }
+  input->GetPointData()->SetScalars(pointValues);
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+int SameCells(vtkPolyData* expected, vtkPolyData* actual, double tol)
+{
+  VTK_TEST_CHECK(expected->GetNumberOfPoints() == actual->GetNumberOfPoints());
+  VTK_TEST_CHECK(expected->GetNumberOfVerts() == actual->GetNumberOfVerts());
+  VTK_TEST_CHECK(expected->GetNumberOfLines() == actual->GetNumberOfLines());
+  VTK_TEST_CHECK(expected->GetNumberOfPolys() == actual->GetNumberOfPolys());
+  VTK_TEST_CHECK(expected->GetNumberOfStrips() == actual->GetNumberOfStrips());
+  VTK_TEST_CHECK(actual->GetPointData()->GetScalars() &&
+    actual->GetPointData()->GetScalars()->GetNumberOfTuples() == actual->GetNumberOfPoints());
+
+  // The points may be numbered differently, but the cells are the same.
+  vtkIdTypeArray* expectedIds =
+    vtkIdTypeArray::SafeDownCast(expected->GetCellData()->GetArray("CellIds"));
+  vtkIdTypeArray* actualIds =
+    vtkIdTypeArray::SafeDownCast(actual->GetCellData()->GetArray("CellIds"));
+  VTK_TEST_CHECK(actualIds && actualIds->GetNumberOfValues() == actual->GetNumberOfCells());
+  vtkNew<vtkIdList> e, a;
+  for (vtkIdType i = 0; i < expected->GetNumberOfCells(); ++i)
+  {
+    VTK_TEST_CHECK(expectedIds->GetValue(i) == actualIds->GetValue(i));
+    VTK_TEST_CHECK(expected->GetCellType(i) == actual->GetCellType(i));
+    expected->GetCellPoints(i, e);
+    actual->GetCellPoints(i, a);
+    VTK_TEST_CHECK(e->GetNumberOfIds() == a->GetNumberOfIds());
+    for (vtkIdType j = 0; j < e->GetNumberOfIds(); ++j)
+    {
+      double ex[3], ax[3];
+      expected->GetPoint(e->GetId(j), ex);
+      actual->GetPoint(a->GetId(j), ax);
+      VTK_TEST_CHECK(std::abs(ex[0] - ax[0]) <= tol && std::abs(ex[1] - ax[1]) <= tol);
+      VTK_TEST_CHECK(ex[2] == ax[2]);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// Points along a line, closer than the tolerance to their neighbors. They are
+// merged into points within tolerance of them, not all into one point.
+int TestChain(vtkCleanPolyData* clean, double tol)
+{
+  const vtkIdType numPts = 100;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    points->InsertNextPoint(0.3 * tol * i, 0.0, 0.0);
+    verts->InsertCellPoint(i);
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+  input->SetVerts(verts);
+
+  clean->SetInputData(input);
+  clean->ToleranceIsAbsoluteOn();
+  clean->SetAbsoluteTolerance(tol);
+  clean->ParallelMergingOn();
+  clean->Update();
+  vtkPolyData* output = clean->GetOutput();
+  VTK_TEST_CHECK(output->GetNumberOfPoints() > 1);
+  VTK_TEST_CHECK(output->GetNumberOfVerts() == 1);
+  // Vertices keep their duplicate points.
+  vtkNew<vtkIdList> ids;
+  output->GetCellPoints(0, ids);
+  VTK_TEST_CHECK(ids->GetNumberOfIds() == numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3], y[3];
+    input->GetPoint(i, x);
+    output->GetPoint(ids->GetId(i), y);
+    VTK_TEST_CHECK(std::abs(x[0] - y[0]) <= tol);
+  }
+  return EXIT_SUCCESS;
+}
+
+int CompareMerging(vtkPolyData* input, vtkCleanPolyData* clean, double tol)
+{
+  clean->SetInputData(input);
+  clean->ParallelMergingOff();
+  clean->Update();
+  vtkNew<vtkPolyData> serial;
+  serial->ShallowCopy(clean->GetOutput());
+  clean->ParallelMergingOn();
+  clean->Update();
+  return SameCells(serial, clean->GetOutput(), tol);
+}
+}
+
+int TestCleanPolyDataParallel(int, char*[])
+{
+  vtkNew<vtkCleanPolyData> clean;
+  clean->ToleranceIsAbsoluteOn();
+
+  // Exact duplicates.
+  const int dim = 60;
+  vtkSmartPointer<vtkPolyData> input = MakeInput(dim, 0.0);
+  clean->SetAbsoluteTolerance(0.0);
+  VTK_TEST_CHECK(CompareMerging(input, clean, 0.0) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(clean->GetOutput()->GetNumberOfPoints() == (dim + 1) * (dim + 2));
+
+  // Clusters of points within tolerance, without degenerate cell conversion.
+  input = MakeInput(dim, 0.01);
+  clean->SetAbsoluteTolerance(0.05);
+  clean->ConvertLinesToPointsOff();
+  clean->ConvertPolysToLinesOff();
+  clean->ConvertStripsToPolysOff();
+  VTK_TEST_CHECK(CompareMerging(input, clean, 0.05) == EXIT_SUCCESS);
+
+  // With conversions, and a relative tolerance.
+  clean->ConvertLinesToPointsOn();
+  clean->ConvertPolysToLinesOn();
+  clean->ConvertStripsToPolysOn();
+  clean->ToleranceIsAbsoluteOff();
+  clean->SetTolerance(0.05 / input->GetLength());
+  VTK_TEST_CHECK(CompareMerging(input, clean, 0.05) == EXIT_SUCCESS);
+  // The degenerate cells are converted.
+  VTK_TEST_CHECK(clean->GetOutput()->GetNumberOfVerts() == 2);
+  VTK_TEST_CHECK(clean->GetOutput()->GetNumberOfLines() >= 2);
+
+  VTK_TEST_CHECK(TestChain(clean, 0.1) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the concurrent labeling of connected regions against the sequential
+// one: the regions are numbered in the order of their first cell, the points
+// as the serial traversal did, and the region sizes can be computed alone.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+using vtkTestDataSetUtilities::HasCellPoints;
+using vtkTestDataSetUtilities::HasTuple;
+
+const int NumberOfRibbons = 6;
+
+// The number of quads of the ribbon r.
+int RibbonSize(int r)
+{
+  return 10 * (r + 1);
+}
+
+// Separate ribbons of quads, whose cells are interleaved so that the first
+// cell of the ribbon r is the cell r. The scalars are 0, except on the two
+// middle points of each side of the last ribbon.
+vtkSmartPointer<vtkPolyData> MakeInput()
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  std::vector<vtkIdType> firstPoints;
+  for (int r = 0; r < NumberOfRibbons; ++r)
+  {
+    firstPoints.push_back(points->GetNumberOfPoints());
+    for (int i = 0; i <= RibbonSize(r); ++i)
+    {
+      const bool middle = r == NumberOfRibbons - 1 && (i == 30 || i == 31);
+      points->InsertNextPoint(i, 2 * r, 0);
+      points->InsertNextPoint(i, 2 * r + 1, 0);
+      scalars->InsertNextValue(middle ? 10 : 0);
+      scalars->InsertNextValue(middle ? 10 : 0);
+    }
+  }
+  vtkNew<vtkCellArray> quads;
+  vtkNew<vtkIdTypeArray> ribbonIds;
+  ribbonIds->SetName("RibbonIds");
+  for (int i = 0; i < RibbonSize(NumberOfRibbons - 1); ++i)
+  {
+    for (int r = 0; r < NumberOfRibbons; ++r)
+    {
+      if (i < RibbonSize(r))
+      {
+        const vtkIdType p = firstPoints[r] + 2 * i;
+        const vtkIdType quad[4] = { p, p + 2, p + 3, p + 1 };
+        quads->InsertNextCell(4, quad);
+        ribbonIds->InsertNextValue(r);
+      }
+    }
+  }
+  input->SetPoints(points);
+  input->SetPolys(quads);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetCellData()->AddArray(ribbonIds);
+  return input;
+}
+
+// Labels the input sequentially, then concurrently, and compares the region
+// sizes too.
+template <typename TFilter>
+bool CompareSequential(TFilter* filter)
+{
+  filter->SequentialProcessingOn();
+  filter->Update();
+  vtkNew<vtkIdTypeArray> sequentialSizes;
+  sequentialSizes->DeepCopy(filter->GetRegionSizes());
+  if (!vtkTestDataSetUtilities::SameAsSequential(filter))
+  {
+    return false;
+  }
+  vtkIdTypeArray* sizes = filter->GetRegionSizes();
+  if (sizes->GetNumberOfValues() != sequentialSizes->GetNumberOfValues())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < sizes->GetNumberOfValues(); ++i)
+  {
+    if (sizes->GetValue(i) != sequentialSizes->GetValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks the regions of both filters, which number the regions alike.
+template <typename TFilter>
+int TestFilter(vtkPolyData* input)
+{
+  vtkNew<TFilter> filter;
+  filter->SetInputData(input);
+  filter->SetExtractionModeToAllRegions();
+  filter->ColorRegionsOn();
+  VTK_TEST_CHECK(CompareSequential(filter.GetPointer()));
+
+  // Each ribbon is a region, numbered after its first cell.
+  VTK_TEST_CHECK(filter->GetNumberOfExtractedRegions() == NumberOfRibbons);
+  for (int r = 0; r < NumberOfRibbons; ++r)
+  {
+    VTK_TEST_CHECK(filter->GetRegionSizes()->GetValue(r) == RibbonSize(r));
+  }
+  vtkPolyData* output = vtkPolyData::SafeDownCast(filter->GetOutput());
+  VTK_TEST_CHECK(output->GetNumberOfCells() == input->GetNumberOfCells());
+
+  // The points are numbered as the wave propagation reaches them: along each
+  // ribbon, region by region.
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == input->GetNumberOfPoints());
+  VTK_TEST_CHECK(HasCellPoints(output, 0, { 0, 1, 2, 3 }));
+  VTK_TEST_CHECK(HasCellPoints(output, 1, { 22, 23, 24, 25 }));
+  const vtkIdType lastCellId = output->GetNumberOfCells() - 1;
+  VTK_TEST_CHECK(HasCellPoints(output, lastCellId, { 428, 430, 431, 429 }));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 1, 1, 0, 0));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 3, 0, 1, 0));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 4, 2, 0, 0));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 100, 18, 4, 0));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 431, 60, 11, 0));
+  vtkDataArray* ribbonIds = output->GetCellData()->GetArray("RibbonIds");
+  vtkDataArray* pointRegionIds = output->GetPointData()->GetArray("RegionId");
+  VTK_TEST_CHECK(ribbonIds && pointRegionIds);
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, cellPts);
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      VTK_TEST_CHECK(pointRegionIds->GetComponent(cellPts->GetId(i), 0) ==
+        ribbonIds->GetComponent(cellId, 0));
+    }
+  }
+
+  // The largest ribbon.
+  filter->SetExtractionModeToLargestRegion();
+  VTK_TEST_CHECK(CompareSequential(filter.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfCells() == RibbonSize(NumberOfRibbons - 1));
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == input->GetNumberOfPoints());
+  VTK_TEST_CHECK(HasCellPoints(output, 0, { 310, 311, 312, 313 }));
+
+  // The ribbons of the seed cells.
+  filter->SetExtractionModeToCellSeededRegions();
+  filter->AddSeed(1);
+  filter->AddSeed(3);
+  VTK_TEST_CHECK(CompareSequential(filter.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfCells() == RibbonSize(1) + RibbonSize(3));
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 2 * (RibbonSize(1) + RibbonSize(3) + 2));
+  VTK_TEST_CHECK(HasCellPoints(output, 0, { 0, 1, 2, 3 }));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 0, 0, 2, 0));
+  VTK_TEST_CHECK(HasTuple(output->GetPoints()->GetData(), 4, 0, 6, 0));
+
+  // The scalars split the last ribbon: the quad between the middle points
+  // starts a region holding the following quads.
+  filter->SetExtractionModeToAllRegions();
+  filter->ScalarConnectivityOn();
+  filter->SetScalarRange(-1, 1);
+  VTK_TEST_CHECK(CompareSequential(filter.GetPointer()));
+  VTK_TEST_CHECK(filter->GetNumberOfExtractedRegions() == NumberOfRibbons + 1);
+  vtkIdTypeArray* sizes = filter->GetRegionSizes();
+  VTK_TEST_CHECK(sizes->GetValue(NumberOfRibbons - 1) == 30);
+  VTK_TEST_CHECK(sizes->GetValue(NumberOfRibbons) == RibbonSize(NumberOfRibbons - 1) - 30);
+
+  // The region sizes alone.
+  filter->RegionSizesOnlyOn();
+  VTK_TEST_CHECK(CompareSequential(filter.GetPointer()));
+  VTK_TEST_CHECK(filter->GetNumberOfExtractedRegions() == NumberOfRibbons + 1);
+  VTK_TEST_CHECK(filter->GetRegionSizes()->GetValue(0) == RibbonSize(0));
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 0 && output->GetNumberOfCells() == 0);
+  return EXIT_SUCCESS;
+}
+
+// The region sizes alone are ordered as the sizes of the colored regions.
+int TestRegionIdAssignment(vtkPolyData* input)
+{
+  vtkNew<vtkConnectivityFilter> filter;
+  filter->SetInputData(input);
+  filter->SetExtractionModeToAllRegions();
+  filter->ColorRegionsOn();
+  filter->SetRegionIdAssignmentMode(vtkConnectivityFilter::CELL_COUNT_DESCENDING);
+  filter->RegionSizesOnlyOn();
+  filter->Update();
+  VTK_TEST_CHECK(filter->GetNumberOfExtractedRegions() == NumberOfRibbons);
+  for (int r = 0; r < NumberOfRibbons; ++r)
+  {
+    VTK_TEST_CHECK(filter->GetRegionSizes()->GetValue(r) == RibbonSize(NumberOfRibbons - 1 - r));
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestConnectivityFilterParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+  VTK_TEST_CHECK(TestFilter<vtkConnectivityFilter>(input) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestFilter<vtkPolyDataConnectivityFilter>(input) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestRegionIdAssignment(input) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestContourGridParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the concurrent contouring of vtkContourGrid and vtkCutter with the
+// sequential one on a grid of quadratic cells, with and without a scalar tree.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkContourGrid.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpanSpace.h"
+#include "vtkSphere.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+const int Resolution = 12;
+
+// Index of a node of the lattice holding the corners and edge middles of the
+// cells.
+vtkIdType NodeId(int i, int j, int k)
+{
+  const int n = 2 * Resolution + 1;
+  return i + n * (j + n * k);
+}
+
+// A block of quadratic hexahedra, with quadratic quads on its z=0 face. The
+// scalars are the distances to a corner of the block.
+vtkSmartPointer<vtkUnstructuredGrid> MakeInput()
+{
+  auto input = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  const int n = 2 * Resolution + 1;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Distance");
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        const double x[3] = { 0.5 * i, 0.5 * j, 0.5 * k };
+        points->InsertNextPoint(x);
+        scalars->InsertNextValue(std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]));
+      }
+    }
+  }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+
+  const int corners[8][3] = { { 0, 0, 0 }, { 2, 0, 0 }, { 2, 2, 0 }, { 0, 2, 0 }, { 0, 0, 2 },
+    { 2, 0, 2 }, { 2, 2, 2 }, { 0, 2, 2 } };
+  const int edges[12][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 },
+    { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  input->Allocate();
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        vtkIdType hex[20];
+        for (int c = 0; c < 8; ++c)
+        {
+          hex[c] = NodeId(2 * i + corners[c][0], 2 * j + corners[c][1], 2 * k + corners[c][2]);
+        }
+        for (int e = 0; e < 12; ++e)
+        {
+          const int* a = corners[edges[e][0]];
+          const int* b = corners[edges[e][1]];
+          hex[8 + e] = NodeId(
+            2 * i + (a[0] + b[0]) / 2, 2 * j + (a[1] + b[1]) / 2, 2 * k + (a[2] + b[2]) / 2);
+        }
+        cellIds->InsertNextValue(input->InsertNextCell(VTK_QUADRATIC_HEXAHEDRON, 20, hex));
+        if (k == 0)
+        {
+          const vtkIdType quad[8] = { hex[0], hex[1], hex[2], hex[3], hex[8], hex[9], hex[10],
+            hex[11] };
+          cellIds->InsertNextValue(input->InsertNextCell(VTK_QUADRATIC_QUAD, 8, quad));
+        }
+      }
+    }
+  }
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+// Whether the outputs have the same cells, made of the same points with the
+// same point data, and the same cell data if requested. The points may be
+// numbered differently.
+bool SameCells(vtkPolyData* expected, vtkPolyData* actual, bool compareCellData = true)
+{
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+    expected->GetNumberOfVerts() != actual->GetNumberOfVerts() ||
+    expected->GetNumberOfLines() != actual->GetNumberOfLines() ||
+    expected->GetNumberOfPolys() != actual->GetNumberOfPolys())
+  {
+    return false;
+  }
+  vtkPointData* expectedPd = expected->GetPointData();
+  vtkPointData* actualPd = actual->GetPointData();
+  if (expectedPd->GetNumberOfArrays() != actualPd->GetNumberOfArrays())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> e, a;
+  for (vtkIdType cellId = 0; cellId < expected->GetNumberOfCells(); ++cellId)
+  {
+    expected->GetCellPoints(cellId, e);
+    actual->GetCellPoints(cellId, a);
+    if (e->GetNumberOfIds() != a->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < e->GetNumberOfIds(); ++i)
+    {
+      double ex[3], ax[3];
+      expected->GetPoint(e->GetId(i), ex);
+      actual->GetPoint(a->GetId(i), ax);
+      if (ex[0] != ax[0] || ex[1] != ax[1] || ex[2] != ax[2])
+      {
+        return false;
+      }
+      for (int array = 0; array < expectedPd->GetNumberOfArrays(); ++array)
+      {
+        vtkDataArray* ea = expectedPd->GetArray(array);
+        // The cut scalars have no name.
+        vtkDataArray* aa =
+          ea->GetName() ? actualPd->GetArray(ea->GetName()) : actualPd->GetArray(array);
+        if (!aa || ea->GetComponent(e->GetId(i), 0) != aa->GetComponent(a->GetId(i), 0))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  if (!compareCellData)
+  {
+    return true;
+  }
+  vtkDataArray* expectedIds = expected->GetCellData()->GetArray("CellIds");
+  vtkDataArray* actualIds = actual->GetCellData()->GetArray("CellIds");
+  if (!expectedIds || !actualIds ||
+    expectedIds->GetNumberOfTuples() != actualIds->GetNumberOfTuples())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < expectedIds->GetNumberOfTuples(); ++i)
+  {
+    if (expectedIds->GetComponent(i, 0) != actualIds->GetComponent(i, 0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int TestContourGrid(vtkUnstructuredGrid* input)
+{
+  vtkNew<vtkContourGrid> contour;
+  contour->SetInputData(input);
+  contour->GenerateValues(3, 2.2, 6.1);
+  VTK_TEST_CHECK(contour->GetSequentialProcessing());
+
+  // The sequential traversal of a scalar tree mixes up the cell data of
+  // lines and polygons, so only the cells are compared then.
+  for (int useTree = 0; useTree < 2; ++useTree)
+  {
+    vtkNew<vtkSpanSpace> tree;
+    contour->SetUseScalarTree(useTree);
+    contour->SetScalarTree(useTree ? tree.GetPointer() : nullptr);
+
+    contour->SequentialProcessingOn();
+    contour->Update();
+    vtkNew<vtkPolyData> sequential;
+    sequential->DeepCopy(contour->GetOutput());
+    VTK_TEST_CHECK(sequential->GetNumberOfPolys() > 0 && sequential->GetNumberOfLines() > 0);
+
+    contour->SequentialProcessingOff();
+    contour->Update();
+    VTK_TEST_CHECK(SameCells(sequential, contour->GetOutput(), !useTree));
+
+    // A new contour value reuses the scalar tree.
+    contour->SetValue(1, 4.05);
+    contour->Update();
+    contour->SequentialProcessingOn();
+    contour->Update();
+    sequential->DeepCopy(contour->GetOutput());
+    contour->SequentialProcessingOff();
+    contour->Update();
+    VTK_TEST_CHECK(SameCells(sequential, contour->GetOutput(), !useTree));
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestCutter(vtkUnstructuredGrid* input)
+{
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(1.1, 2.3, 0.7);
+  sphere->SetRadius(0.0);
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputData(input);
+  cutter->SetCutFunction(sphere);
+  cutter->GenerateValues(2, 4.0, 9.5);
+  cutter->GenerateCutScalarsOn();
+
+  // The cutting is sequential by default.
+  VTK_TEST_CHECK(cutter->GetSequentialProcessing());
+  cutter->Update();
+  vtkNew<vtkPolyData> sequential;
+  sequential->DeepCopy(cutter->GetOutput());
+  VTK_TEST_CHECK(sequential->GetNumberOfPolys() > 0);
+
+  cutter->SequentialProcessingOff();
+  cutter->Update();
+  VTK_TEST_CHECK(SameCells(sequential, cutter->GetOutput()));
+
+  // A point locator merging exactly coincident points still selects the
+  // sequential path.
+  vtkNew<vtkPointLocator> locator;
+  locator->SetTolerance(0.0);
+  cutter->SetLocator(locator);
+  cutter->Update();
+  VTK_TEST_CHECK(SameCells(sequential, cutter->GetOutput()));
+  return EXIT_SUCCESS;
+}
+}
+
+int TestContourGridParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> input = MakeInput();
+  VTK_TEST_CHECK(TestContourGrid(input) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestCutter(input) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunay3DSpatialSorting.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the spatially sorted insertion of vtkDelaunay3D gives the same
+// triangulation as the insertion in input order for points in general
+// position, up to the choice of the point kept among duplicated points, and a
+// valid tetrahedralization for cospherical points.
+
+#include "vtkDelaunay3D.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTetra.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+
+namespace
+{
+using TetraSet = std::set<std::array<vtkIdType, 4>>;
+
+// The tetrahedra with their points replaced by the first point at the same
+// location and sorted, and whether they all have the same orientation.
+bool GetTetras(vtkUnstructuredGrid* grid, TetraSet& tetras)
+{
+  std::map<std::array<double, 3>, vtkIdType> firstIds;
+  for (vtkIdType ptId = grid->GetNumberOfPoints() - 1; ptId >= 0; --ptId)
+  {
+    std::array<double, 3> x;
+    grid->GetPoint(ptId, x.data());
+    firstIds[x] = ptId;
+  }
+  tetras.clear();
+  int sign = 0;
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    if (grid->GetCellType(cellId) != VTK_TETRA)
+    {
+      continue;
+    }
+    grid->GetCellPoints(cellId, ids);
+    std::array<vtkIdType, 4> tetra;
+    double x[4][3];
+    for (int j = 0; j < 4; ++j)
+    {
+      grid->GetPoint(ids->GetId(j), x[j]);
+      tetra[j] = firstIds[{ x[j][0], x[j][1], x[j][2] }];
+    }
+    const int tetraSign = vtkTetra::ComputeVolume(x[0], x[1], x[2], x[3]) > 0.0 ? 1 : -1;
+    if (sign != 0 && tetraSign != sign)
+    {
+      return false;
+    }
+    sign = tetraSign;
+    std::sort(tetra.begin(), tetra.end());
+    tetras.insert(tetra);
+  }
+  return true;
+}
+
+// Checks that the tetrahedra of the bounding triangulation have the same
+// orientation, share their faces by pairs except for the 8 faces of the
+// bounding octahedron, and fill the octahedron.
+int CheckTetrahedralization(vtkPolyData* input, vtkDelaunay3D* delaunay)
+{
+  delaunay->SetInputData(input);
+  delaunay->SpatialSortingOn();
+  delaunay->BoundingTriangulationOn();
+  delaunay->Update();
+  vtkUnstructuredGrid* output = delaunay->GetOutput();
+  VTK_TEST_CHECK(output->GetNumberOfCells() > 0);
+
+  std::map<std::array<vtkIdType, 3>, int> faces;
+  double volume = 0.0;
+  int sign = 0;
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    VTK_TEST_CHECK(output->GetCellType(cellId) == VTK_TETRA);
+    output->GetCellPoints(cellId, ids);
+    double x[4][3];
+    for (int j = 0; j < 4; ++j)
+    {
+      output->GetPoint(ids->GetId(j), x[j]);
+    }
+    const double tetraVolume = vtkTetra::ComputeVolume(x[0], x[1], x[2], x[3]);
+    const int tetraSign = tetraVolume > 0.0 ? 1 : -1;
+    VTK_TEST_CHECK(tetraVolume != 0.0 && (sign == 0 || tetraSign == sign));
+    sign = tetraSign;
+    volume += std::abs(tetraVolume);
+    for (int j = 0; j < 4; ++j)
+    {
+      std::array<vtkIdType, 3> face;
+      for (int i = 0, k = 0; i < 4; ++i)
+      {
+        if (i != j)
+        {
+          face[k++] = ids->GetId(i);
+        }
+      }
+      std::sort(face.begin(), face.end());
+      ++faces[face];
+    }
+  }
+  int numBoundaryFaces = 0;
+  for (const auto& face : faces)
+  {
+    VTK_TEST_CHECK(face.second <= 2);
+    numBoundaryFaces += face.second == 1;
+  }
+  VTK_TEST_CHECK(numBoundaryFaces == 8);
+
+  const double length = delaunay->GetOffset() * input->GetLength();
+  const double octahedronVolume = 4.0 / 3.0 * length * length * length;
+  VTK_TEST_CHECK(std::abs(volume - octahedronVolume) <= 1e-6 * octahedronVolume);
+  return EXIT_SUCCESS;
+}
+
+int CompareInsertions(vtkPolyData* input, vtkDelaunay3D* delaunay)
+{
+  delaunay->SetInputData(input);
+  delaunay->SpatialSortingOff();
+  delaunay->Update();
+  vtkNew<vtkUnstructuredGrid> expected;
+  expected->DeepCopy(delaunay->GetOutput());
+  delaunay->SpatialSortingOn();
+  delaunay->Update();
+  vtkUnstructuredGrid* actual = delaunay->GetOutput();
+
+  VTK_TEST_CHECK(actual->GetNumberOfPoints() == expected->GetNumberOfPoints());
+  // Only the tetrahedra are compared: the other cells of the alpha shapes
+  // depend on the order of the tetrahedra, which differs between the modes.
+  TetraSet expectedTetras, actualTetras;
+  VTK_TEST_CHECK(GetTetras(expected, expectedTetras));
+  VTK_TEST_CHECK(GetTetras(actual, actualTetras));
+  VTK_TEST_CHECK(!actualTetras.empty());
+  VTK_TEST_CHECK(actualTetras == expectedTetras);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestDelaunay3DSpatialSorting(int, char*[])
+{
+  // Random points in a cube, a dense cluster, and duplicated points.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(4242);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int i = 0; i < 3000; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetNextRangeValue(-1.0, 1.0) * (i < 2000 ? 1.0 : 0.3);
+    }
+    points->InsertNextPoint(x);
+  }
+  for (vtkIdType i = 0; i < 50; ++i)
+  {
+    double x[3];
+    points->GetPoint(37 * i, x);
+    points->InsertNextPoint(x);
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+
+  vtkNew<vtkDelaunay3D> delaunay;
+  VTK_TEST_CHECK(CompareInsertions(input, delaunay) == EXIT_SUCCESS);
+
+  delaunay->BoundingTriangulationOn();
+  VTK_TEST_CHECK(CompareInsertions(input, delaunay) == EXIT_SUCCESS);
+
+  delaunay->BoundingTriangulationOff();
+  delaunay->SetAlpha(0.08);
+  VTK_TEST_CHECK(CompareInsertions(input, delaunay) == EXIT_SUCCESS);
+
+  // Cospherical points: the points of a lattice, and points on a sphere with
+  // its center, many of them duplicated.
+  vtkNew<vtkPoints> lattice;
+  for (int k = 0; k < 8; ++k)
+  {
+    for (int j = 0; j < 8; ++j)
+    {
+      for (int i = 0; i < 8; ++i)
+      {
+        lattice->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  vtkNew<vtkPolyData> latticeInput;
+  latticeInput->SetPoints(lattice);
+  vtkNew<vtkDelaunay3D> latticeDelaunay;
+  VTK_TEST_CHECK(CheckTetrahedralization(latticeInput, latticeDelaunay) == EXIT_SUCCESS);
+
+  vtkNew<vtkPoints> sphere;
+  sphere->InsertNextPoint(0.0, 0.0, 0.0);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const double theta = vtkMath::Pi() * (i % 20) / 19.0;
+    const double phi = 2.0 * vtkMath::Pi() * (i / 20) / 50.0;
+    sphere->InsertNextPoint(
+      std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+  }
+  vtkNew<vtkPolyData> sphereInput;
+  sphereInput->SetPoints(sphere);
+  vtkNew<vtkDelaunay3D> sphereDelaunay;
+  VTK_TEST_CHECK(CheckTetrahedralization(sphereInput, sphereDelaunay) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
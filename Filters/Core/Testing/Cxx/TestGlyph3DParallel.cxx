@@ -0,0 +1,267 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the glyphs are the same with sequential and concurrent
+// processing and as the serial filter made them, and that the glyph
+// instances reproduce the glyph geometry.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const int GridSize = 12;
+
+// A grid of points with scalars, vectors and an extra array.
+vtkSmartPointer<vtkPolyData> MakeInput()
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("Labels");
+  for (int j = 0; j < GridSize; ++j)
+  {
+    for (int i = 0; i < GridSize; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.1 * i * j);
+      scalars->InsertNextValue(static_cast<double>(i + j) / (2 * GridSize));
+      vectors->InsertNextTuple3(std::cos(0.3 * i), std::sin(0.5 * j), 0.1 * (i - j));
+      labels->InsertNextValue(i * j);
+    }
+  }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->AddArray(labels);
+  return input;
+}
+
+// Checks that the transforms of the instances map the points of their
+// source to the points of the glyph geometry.
+bool SameGlyphs(vtkPolyData* geometry, vtkPolyData* instances, vtkPolyData** sources)
+{
+  vtkDataArray* transforms = instances->GetPointData()->GetArray("GlyphTransform");
+  vtkDataArray* sourceIndices = instances->GetPointData()->GetArray("GlyphSourceIndex");
+  if (!transforms || transforms->GetNumberOfComponents() != 16)
+  {
+    return false;
+  }
+  vtkIdType glyphPtId = 0;
+  for (vtkIdType i = 0; i < instances->GetNumberOfPoints(); ++i)
+  {
+    double matrix[16];
+    transforms->GetTuple(i, matrix);
+    const int index = sourceIndices ? static_cast<int>(sourceIndices->GetComponent(i, 0)) : 0;
+    vtkPolyData* source = sources[index];
+    for (vtkIdType j = 0; j < source->GetNumberOfPoints(); ++j, ++glyphPtId)
+    {
+      double x[3], y[3];
+      source->GetPoint(j, x);
+      geometry->GetPoint(glyphPtId, y);
+      for (int k = 0; k < 3; ++k)
+      {
+        const double xk = matrix[4 * k] * x[0] + matrix[4 * k + 1] * x[1] +
+          matrix[4 * k + 2] * x[2] + matrix[4 * k + 3];
+        if (std::abs(xk - y[k]) > 1e-5)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return glyphPtId == geometry->GetNumberOfPoints();
+}
+
+// Whether the cell has the given type and point ids.
+bool HasCell(vtkPolyData* output, vtkIdType cellId, int type, const std::vector<vtkIdType>& ids)
+{
+  return output->GetCellType(cellId) == type &&
+    vtkTestDataSetUtilities::HasCellPoints(output, cellId, ids);
+}
+
+// The cells of a source mixing cell types keep their order within each
+// glyph, the glyphs following each other.
+int TestMixedCellTypes(vtkPolyData* input)
+{
+  vtkNew<vtkPolyData> mixed;
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(0, 1, 0);
+  mixed->SetPoints(points);
+  mixed->AllocateEstimate(3, 3);
+  const vtkIdType line[2] = { 0, 1 };
+  const vtkIdType triangle[3] = { 0, 1, 2 };
+  const vtkIdType vertex[1] = { 2 };
+  mixed->InsertNextCell(VTK_LINE, 2, line);
+  mixed->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  mixed->InsertNextCell(VTK_VERTEX, 1, vertex);
+
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceData(mixed);
+  glyph->FillCellDataOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  vtkPolyData* output = glyph->GetOutput();
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 3 * input->GetNumberOfPoints());
+  VTK_TEST_CHECK(output->GetNumberOfCells() == 3 * input->GetNumberOfPoints());
+  VTK_TEST_CHECK(HasCell(output, 0, VTK_LINE, { 0, 1 }));
+  VTK_TEST_CHECK(HasCell(output, 1, VTK_TRIANGLE, { 0, 1, 2 }));
+  VTK_TEST_CHECK(HasCell(output, 2, VTK_VERTEX, { 2 }));
+  VTK_TEST_CHECK(HasCell(output, 3, VTK_LINE, { 3, 4 }));
+  VTK_TEST_CHECK(HasCell(output, 4, VTK_TRIANGLE, { 3, 4, 5 }));
+  vtkDataArray* inLabels = input->GetPointData()->GetArray("Labels");
+  vtkDataArray* cellLabels = output->GetCellData()->GetArray("Labels");
+  VTK_TEST_CHECK(cellLabels);
+  const vtkIdType ptId = GridSize + 1;
+  VTK_TEST_CHECK(cellLabels->GetComponent(3 * ptId + 1, 0) == inLabels->GetComponent(ptId, 0));
+  VTK_TEST_CHECK(cellLabels->GetComponent(3 * ptId + 2, 0) == inLabels->GetComponent(ptId, 0));
+  return EXIT_SUCCESS;
+}
+
+// When following the camera and orienting the glyphs, the vector of a glyph
+// is the camera direction of the previous glyph.
+int TestFollowCamera(vtkPolyData* input, vtkPolyData* source)
+{
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceData(source);
+  glyph->SetVectorModeToFollowCameraDirection();
+  double cameraPosition[3] = { 0, 0, 10 };
+  glyph->SetFollowedCameraPosition(cameraPosition);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  vtkDataArray* vectors = glyph->GetOutput()->GetPointData()->GetArray("GlyphVector");
+  VTK_TEST_CHECK(vectors);
+  const vtkIdType numSourcePts = source->GetNumberOfPoints();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(vectors, numSourcePts, 0, 0, 1));
+  const double norm = std::sqrt(101.0);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(
+    vectors, 3 * numSourcePts - 1, -1.0 / norm, 0, 10.0 / norm, 1e-6));
+  return EXIT_SUCCESS;
+}
+}
+
+int TestGlyph3DParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+  const vtkIdType numInputPts = input->GetNumberOfPoints();
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(6);
+  sphere->SetPhiResolution(5);
+  sphere->Update();
+  vtkPolyData* sphereData = sphere->GetOutput();
+
+  // Spheres scaled by the scalars and oriented along the vectors.
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceData(sphereData);
+  glyph->SetScaleFactor(0.5);
+  glyph->GeneratePointIdsOn();
+  glyph->FillCellDataOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  vtkNew<vtkPolyData> geometry;
+  geometry->DeepCopy(glyph->GetOutput());
+  VTK_TEST_CHECK(geometry->GetNumberOfPoints() == numInputPts * sphereData->GetNumberOfPoints());
+  VTK_TEST_CHECK(geometry->GetNumberOfCells() == numInputPts * sphereData->GetNumberOfCells());
+  VTK_TEST_CHECK(geometry->GetPointData()->GetNormals() != nullptr);
+  vtkDataArray* pointIds = geometry->GetPointData()->GetArray("InputPointIds");
+  vtkDataArray* cellLabels = geometry->GetCellData()->GetArray("Labels");
+  VTK_TEST_CHECK(pointIds && cellLabels);
+  const vtkIdType lastGlyph = numInputPts - 1;
+  VTK_TEST_CHECK(pointIds->GetComponent(geometry->GetNumberOfPoints() - 1, 0) == lastGlyph);
+  VTK_TEST_CHECK(cellLabels->GetComponent(geometry->GetNumberOfCells() - 1, 0) ==
+    input->GetPointData()->GetArray("Labels")->GetComponent(lastGlyph, 0));
+
+  // The cells of the glyphs follow each other, as the cells of the source.
+  const vtkIdType numSpherePts = sphereData->GetNumberOfPoints();
+  vtkNew<vtkIdList> spherePts;
+  sphereData->GetCellPoints(0, spherePts);
+  std::vector<vtkIdType> firstCell(
+    spherePts->GetPointer(0), spherePts->GetPointer(0) + spherePts->GetNumberOfIds());
+  VTK_TEST_CHECK(HasCell(geometry, 0, VTK_TRIANGLE, firstCell));
+  for (vtkIdType& id : firstCell)
+  {
+    id += numSpherePts;
+  }
+  VTK_TEST_CHECK(HasCell(geometry, sphereData->GetNumberOfCells(), VTK_TRIANGLE, firstCell));
+
+  // The same glyphs as instances.
+  glyph->OutputInstancesOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  vtkPolyData* instances = glyph->GetOutput();
+  VTK_TEST_CHECK(instances->GetNumberOfPoints() == numInputPts);
+  VTK_TEST_CHECK(instances->GetNumberOfVerts() == numInputPts);
+  VTK_TEST_CHECK(instances->GetPointData()->GetNormals() == nullptr);
+  VTK_TEST_CHECK(instances->GetPointData()->GetArray("Labels") != nullptr);
+  vtkPolyData* sources[2] = { sphereData, nullptr };
+  VTK_TEST_CHECK(SameGlyphs(geometry, instances, sources));
+
+  // A table of glyphs indexed by the scalars.
+  vtkNew<vtkSphereSource> smallSphere;
+  smallSphere->SetThetaResolution(3);
+  smallSphere->SetPhiResolution(3);
+  smallSphere->Update();
+  sources[1] = smallSphere->GetOutput();
+  glyph->SetSourceData(1, sources[1]);
+  glyph->SetIndexModeToScalar();
+  glyph->OutputInstancesOff();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  geometry->DeepCopy(glyph->GetOutput());
+  glyph->OutputInstancesOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(glyph.GetPointer()));
+  vtkDataArray* sourceIndices = instances->GetPointData()->GetArray("GlyphSourceIndex");
+  VTK_TEST_CHECK(sourceIndices);
+  vtkIdType numGlyphPts = 0;
+  for (vtkIdType i = 0; i < numInputPts; ++i)
+  {
+    const int index = static_cast<int>(sourceIndices->GetComponent(i, 0));
+    numGlyphPts += sources[index]->GetNumberOfPoints();
+  }
+  VTK_TEST_CHECK(geometry->GetNumberOfPoints() == numGlyphPts);
+  VTK_TEST_CHECK(SameGlyphs(geometry, instances, sources));
+
+  VTK_TEST_CHECK(TestMixedCellTypes(input) == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestFollowCamera(input, sphereData) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
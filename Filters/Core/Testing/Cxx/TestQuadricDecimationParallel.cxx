@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the partitioned decimation of vtkQuadricDecimation reaches the
+// target reduction with a mesh as good as the serial one, and stitches the
+// partitions without cracks.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkTestDataSetUtilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+namespace
+{
+double Height(double x, double y)
+{
+  return 0.5 * std::sin(x) * std::cos(0.5 * y);
+}
+
+// A triangulated height field of dim x dim quads, with point scalars.
+vtkSmartPointer<vtkPolyData> MakeSurface(int dim)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int j = 0; j <= dim; ++j)
+  {
+    for (int i = 0; i <= dim; ++i)
+    {
+      const double x = 10.0 * i / dim;
+      const double y = 10.0 * j / dim;
+      points->InsertNextPoint(x, y, Height(x, y));
+      scalars->InsertNextValue(x + y);
+    }
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < dim; ++j)
+  {
+    for (int i = 0; i < dim; ++i)
+    {
+      const vtkIdType p = j * (dim + 1) + i;
+      const vtkIdType t0[3] = { p, p + 1, p + dim + 2 };
+      const vtkIdType t1[3] = { p, p + dim + 2, p + dim + 1 };
+      polys->InsertNextCell(3, t0);
+      polys->InsertNextCell(3, t1);
+    }
+  }
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->SetPoints(points);
+  surface->SetPolys(polys);
+  surface->GetPointData()->SetScalars(scalars);
+  return surface;
+}
+
+// Largest distance of the points to the height field.
+double MaximumError(vtkPolyData* mesh)
+{
+  double error = 0.0;
+  for (vtkIdType i = 0; i < mesh->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    mesh->GetPoint(i, x);
+    error = std::max(error, std::abs(x[2] - Height(x[0], x[1])));
+  }
+  return error;
+}
+
+// Number of edges used by one triangle, or -1 if an edge is used by more
+// than two triangles.
+vtkIdType NumberOfBoundaryEdges(vtkPolyData* mesh)
+{
+  std::map<std::pair<vtkIdType, vtkIdType>, int> edges;
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkCellArray* polys = mesh->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const vtkIdType a = pts[i];
+      const vtkIdType b = pts[(i + 1) % npts];
+      ++edges[std::make_pair(std::min(a, b), std::max(a, b))];
+    }
+  }
+  vtkIdType numBoundaryEdges = 0;
+  for (const auto& edge : edges)
+  {
+    if (edge.second > 2)
+    {
+      return -1;
+    }
+    numBoundaryEdges += edge.second == 1;
+  }
+  return numBoundaryEdges;
+}
+
+// The largest difference between the point scalars and their value on the
+// input, or infinity if they are missing.
+double MaximumScalarError(vtkPolyData* output)
+{
+  vtkDataArray* scalars = output->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfTuples() != output->GetNumberOfPoints())
+  {
+    return VTK_DOUBLE_MAX;
+  }
+  double error = 0.0;
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    output->GetPoint(i, x);
+    error = std::max(error, std::abs(scalars->GetTuple1(i) - x[0] - x[1]));
+  }
+  return error;
+}
+}
+
+int TestQuadricDecimationParallel(int, char*[])
+{
+  const int dim = 120;
+  vtkSmartPointer<vtkPolyData> surface = MakeSurface(dim);
+  const vtkIdType numTris = surface->GetNumberOfPolys();
+
+  vtkNew<vtkQuadricDecimation> decimation;
+  decimation->SetInputData(surface);
+  decimation->SetTargetReduction(0.9);
+  decimation->Update();
+  const vtkIdType numSerialTris = decimation->GetOutput()->GetNumberOfPolys();
+  const double serialError = MaximumError(decimation->GetOutput());
+
+  decimation->ParallelDecimationOn();
+  decimation->SetNumberOfPartitions(6);
+  decimation->Update();
+  vtkPolyData* output = decimation->GetOutput();
+  std::cout << "Serial: " << numSerialTris << " triangles, error " << serialError
+            << ". Parallel: " << output->GetNumberOfPolys() << " triangles, error "
+            << MaximumError(output) << std::endl;
+  VTK_TEST_CHECK(decimation->GetActualReduction() >= 0.85);
+  VTK_TEST_CHECK(output->GetNumberOfPolys() <= numSerialTris + numTris / 20);
+  VTK_TEST_CHECK(MaximumError(output) <= std::max(4.0 * serialError, 0.01));
+  // A crack along the seams would add boundary edges.
+  const vtkIdType numBoundaryEdges = NumberOfBoundaryEdges(output);
+  VTK_TEST_CHECK(numBoundaryEdges >= 0 && numBoundaryEdges <= 4 * dim);
+  VTK_TEST_CHECK(output->GetPointData()->GetNumberOfArrays() == 0);
+
+  // Attributes are decimated too, as accurately as serially.
+  decimation->AttributeErrorMetricOn();
+  decimation->VolumePreservationOn();
+  decimation->ParallelDecimationOff();
+  decimation->Update();
+  const double serialScalarError = MaximumScalarError(output);
+  decimation->ParallelDecimationOn();
+  decimation->Update();
+  VTK_TEST_CHECK(decimation->GetActualReduction() >= 0.85);
+  VTK_TEST_CHECK(NumberOfBoundaryEdges(output) >= 0);
+  VTK_TEST_CHECK(MaximumScalarError(output) <= 2.0 * serialScalarError);
+
+  // Inputs too small to be partitioned are decimated serially.
+  decimation->SetNumberOfPartitions(1);
+  decimation->Update();
+  const vtkIdType numTrisOnePartition = output->GetNumberOfPolys();
+  decimation->ParallelDecimationOff();
+  decimation->Update();
+  VTK_TEST_CHECK(output->GetNumberOfPolys() == numTrisOnePartition);
+
+  return EXIT_SUCCESS;
+}
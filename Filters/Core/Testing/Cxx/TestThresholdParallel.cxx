@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the parallel evaluation and assembly of vtkThreshold with the
+// sequential processing, including on an input with a bit array, which forces
+// the serial assembly, and with the output of the previous serial filter on a
+// small image.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+#include "vtkThreshold.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+// Thresholds the input sequentially and concurrently.
+int CompareProcessings(vtkDataSet* input, vtkThreshold* threshold)
+{
+  threshold->SetInputData(input);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(threshold));
+  VTK_TEST_CHECK(threshold->GetOutput()->GetNumberOfCells() > 0);
+  return EXIT_SUCCESS;
+}
+
+// Thresholds the input with and without a bit array.
+int CompareAssemblies(vtkDataSet* input, vtkThreshold* threshold)
+{
+  VTK_TEST_CHECK(CompareProcessings(input, threshold) == EXIT_SUCCESS);
+  vtkSmartPointer<vtkDataSet> withBits = vtk::TakeSmartPointer(input->NewInstance());
+  withBits->ShallowCopy(input);
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("Bits");
+  bits->SetNumberOfValues(input->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    bits->SetValue(i, i % 3 == 0);
+  }
+  withBits->GetPointData()->AddArray(bits);
+  VTK_TEST_CHECK(CompareProcessings(withBits, threshold) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+
+// Thresholds the cells 0, 2, 4 and 5 of a 3x2 image: the output cells keep
+// their input order and the points are numbered as the cells first use them,
+// as in the previous serial filter.
+int TestFixedOutput()
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(4, 3, 1);
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("PointIds");
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    pointIds->InsertNextValue(i);
+  }
+  image->GetPointData()->AddArray(pointIds);
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  const double keep[6] = { 1, 0, 1, 0, 1, 1 };
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellScalars->InsertNextValue(keep[i]);
+    cellIds->InsertNextValue(i);
+  }
+  image->GetCellData()->SetScalars(cellScalars);
+  image->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellScalars");
+  threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_UPPER);
+  threshold->SetUpperThreshold(0.5);
+  VTK_TEST_CHECK(CompareProcessings(image, threshold) == EXIT_SUCCESS);
+  vtkUnstructuredGrid* output = threshold->GetOutput();
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 11 && output->GetNumberOfCells() == 4);
+  VTK_TEST_CHECK(output->GetCellType(0) == VTK_PIXEL);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 0, { 0, 1, 2, 3 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 1, { 4, 5, 6, 7 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 2, { 3, 6, 8, 9 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 3, { 6, 7, 9, 10 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(output->GetPoints()->GetData(), 8, 1, 2, 0));
+  vtkDataArray* outPointIds = output->GetPointData()->GetArray("PointIds");
+  VTK_TEST_CHECK(outPointIds && outPointIds->GetComponent(4, 0) == 2);
+  VTK_TEST_CHECK(outPointIds->GetComponent(10, 0) == 11);
+  vtkDataArray* outCellIds = output->GetCellData()->GetArray("CellIds");
+  VTK_TEST_CHECK(outCellIds && outCellIds->GetComponent(2, 0) == 4);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestThresholdParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  // A volume large enough to be split in several blocks, with point and cell
+  // scalars, and attributes of various types.
+  const int dim = 40;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dim, dim, dim);
+  image->SetSpacing(0.5, 0.25, 1.0);
+
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  vtkNew<vtkIntArray> pointVectors;
+  pointVectors->SetName("PointVectors");
+  pointVectors->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    pointScalars->InsertNextValue(std::sin(x[0]) * std::cos(x[1]) + 0.1 * x[2]);
+    pointVectors->InsertNextTuple3(i, -i, 2 * i);
+  }
+  image->GetPointData()->SetScalars(pointScalars);
+  image->GetPointData()->AddArray(pointVectors);
+
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellScalars->InsertNextValue(static_cast<double>((i * 7919) % 1000));
+    cellIds->InsertNextValue(i);
+  }
+  image->GetCellData()->SetScalars(cellScalars);
+  image->GetCellData()->AddArray(cellIds);
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfValues(image->GetNumberOfCells());
+  ghosts->Fill(0);
+  ghosts->SetValue(100, vtkDataSetAttributes::HIDDENCELL);
+  image->GetCellData()->AddArray(ghosts);
+
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_BETWEEN);
+  threshold->SetLowerThreshold(0.2);
+  threshold->SetUpperThreshold(2.0);
+  VTK_TEST_CHECK(CompareAssemblies(image, threshold) == EXIT_SUCCESS);
+
+  threshold->AllScalarsOff();
+  threshold->InvertOn();
+  VTK_TEST_CHECK(CompareAssemblies(image, threshold) == EXIT_SUCCESS);
+
+  // Cell scalars on an unstructured grid, with shared points numbered
+  // differently from the image.
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(threshold->GetOutput());
+  grid->GetPointData()->RemoveArray("Bits");
+  threshold->InvertOff();
+  threshold->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellScalars");
+  threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_UPPER);
+  threshold->SetUpperThreshold(300);
+  threshold->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  VTK_TEST_CHECK(CompareAssemblies(grid, threshold) == EXIT_SUCCESS);
+
+  VTK_TEST_CHECK(TestFixedOutput() == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
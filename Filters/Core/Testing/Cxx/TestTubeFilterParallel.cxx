@@ -0,0 +1,249 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTubeFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tubes helical polylines with several threads. The tube of each polyline
+// follows the tubes of the previous ones, the polylines without two distinct
+// points are skipped, straight polylines give the tubes of the former serial
+// filter, and both ends of a closed loop get the same normal.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyLine.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+#include "vtkTubeFilter.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+const int NumberOfLines = 500;
+const int NumberOfLinePoints = 12;
+
+// Helical polylines, every 7th of which shares its first points with the
+// previous one and every 11th of which has a duplicate point. The polyline
+// 13 has a single distinct point and is skipped.
+vtkSmartPointer<vtkPolyData> MakeInput()
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkCellArray> verts, lines;
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+
+  const vtkIdType vert = 0;
+  points->InsertNextPoint(0, 0, -1);
+  scalars->InsertNextValue(0);
+  verts->InsertNextCell(1, &vert);
+  cellIds->InsertNextValue(-1);
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    lines->InsertNextCell(NumberOfLinePoints);
+    for (int i = 0; i < NumberOfLinePoints; ++i)
+    {
+      const double t = 0.3 * i;
+      vtkIdType id = points->InsertNextPoint(
+        std::cos(t) + 3 * (l % 20), std::sin(t) + 3 * (l / 20), 0.2 * t + 0.01 * l);
+      scalars->InsertNextValue(1 + (l + i) % 5);
+      if (l == 13 && i > 0)
+      {
+        id -= i;
+      }
+      else if (l % 7 == 1 && i < 3)
+      {
+        id -= NumberOfLinePoints;
+      }
+      else if (l % 11 == 5 && i == 4)
+      {
+        --id;
+      }
+      lines->InsertCellPoint(id);
+    }
+    cellIds->InsertNextValue(l);
+  }
+  input->SetPoints(points);
+  input->SetVerts(verts);
+  input->SetLines(lines);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+// The number of distinct consecutive points of the polyline l.
+vtkIdType NumberOfTubedPoints(int l)
+{
+  if (l == 13)
+  {
+    return 0;
+  }
+  return l % 11 == 5 ? NumberOfLinePoints - 1 : NumberOfLinePoints;
+}
+
+// The capped tubes of two straight polylines along x, of 3 and 2 points, with
+// the default normal, have the points, normals and strips of the previous
+// serial filter.
+int TestStraightLines()
+{
+  vtkNew<vtkTubeFilter> tube;
+  tube->SetInputData(vtkTestDataSetUtilities::MakeStraightPolyLines());
+  tube->SetNumberOfSides(4);
+  tube->SetRadius(1);
+  tube->UseDefaultNormalOn();
+  tube->CappingOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(tube.GetPointer()));
+  vtkPolyData* output = tube->GetOutput();
+
+  // 4 points around each point, then the 4 points of each cap.
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == (4 * 3 + 8) + (4 * 2 + 8));
+  vtkDataArray* outPts = output->GetPoints()->GetData();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 0, 0, -1, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 1, 0, 0, 1));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 5, 1, 0, 1));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 11, 2, 0, -1));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 12, 0, -1, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 16, 2, -1, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 20, 0, 4, 0));
+  vtkDataArray* normals = output->GetPointData()->GetNormals();
+  VTK_TEST_CHECK(normals);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 0, 0, -1, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 7, 0, 0, -1));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 12, -1, 0, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 19, 1, 0, 0));
+
+  // 4 strips along the sides, then the start and end caps.
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == 2 * (4 + 2));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 0, { 1, 0, 5, 4, 9, 8 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 3, { 0, 3, 4, 7, 8, 11 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 4, { 12, 13, 15, 14 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 5, { 16, 19, 17, 18 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 6, { 21, 20, 25, 24 }));
+  vtkDataArray* outCellIds = output->GetCellData()->GetArray("CellIds");
+  VTK_TEST_CHECK(outCellIds);
+  VTK_TEST_CHECK(outCellIds->GetComponent(5, 0) == 10 && outCellIds->GetComponent(6, 0) == 11);
+  return EXIT_SUCCESS;
+}
+
+// The generated normals of a closed loop are the sliding normals stored per
+// input point, so that both ends of the tube take the normal computed last.
+int TestClosedLoop()
+{
+  vtkSmartPointer<vtkPolyData> loop = vtkTestDataSetUtilities::MakeClosedLoop(NumberOfLinePoints);
+  vtkNew<vtkTubeFilter> tube;
+  tube->SetInputData(loop);
+  tube->SetNumberOfSides(6);
+  tube->SetRadius(0.1);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(tube.GetPointer()));
+  vtkNew<vtkPolyData> generated;
+  generated->DeepCopy(tube->GetOutput());
+  VTK_TEST_CHECK(generated->GetNumberOfPoints() == 6 * (NumberOfLinePoints + 1));
+
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(loop->GetNumberOfPoints());
+  VTK_TEST_CHECK(vtkPolyLine::GenerateSlidingNormals(loop->GetPoints(), loop->GetLines(), normals));
+  loop->GetPointData()->SetNormals(normals);
+  loop->Modified();
+  tube->Update();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SamePoints(generated, tube->GetOutput()));
+  return EXIT_SUCCESS;
+}
+}
+
+int TestTubeFilterParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+  vtkNew<vtkTubeFilter> tube;
+  tube->SetInputData(input);
+  tube->SetNumberOfSides(6);
+  tube->SetRadius(0.1);
+  tube->GlobalWarningDisplayOff();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(tube.GetPointer()));
+
+  // The tube of each polyline has NumberOfSides points per distinct point,
+  // and NumberOfSides strips carrying the data of its polyline.
+  vtkPolyData* output = tube->GetOutput();
+  vtkIdType numPts = 0;
+  vtkIdType numStrips = 0;
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    numPts += 6 * NumberOfTubedPoints(l);
+    numStrips += NumberOfTubedPoints(l) > 0 ? 6 : 0;
+  }
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == numPts);
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == numStrips);
+  vtkDataArray* cellIds = output->GetCellData()->GetArray("CellIds");
+  VTK_TEST_CHECK(cellIds && cellIds->GetNumberOfTuples() == numStrips);
+  vtkIdType stripId = 0;
+  vtkIdType ptId = 0;
+  vtkNew<vtkIdList> stripPts;
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    if (NumberOfTubedPoints(l) > 0)
+    {
+      for (int side = 0; side < 6; ++side, ++stripId)
+      {
+        VTK_TEST_CHECK(cellIds->GetComponent(stripId, 0) == l);
+        output->GetCellPoints(stripId, stripPts);
+        VTK_TEST_CHECK(stripPts->GetId(1) == ptId + side);
+      }
+      ptId += 6 * NumberOfTubedPoints(l);
+    }
+  }
+  VTK_TEST_CHECK(output->GetPointData()->GetNormals() != nullptr);
+  VTK_TEST_CHECK(output->GetPointData()->GetScalars() != nullptr);
+
+  // Caps, separate side vertices, skipped sides, varying radius and texture
+  // coordinates.
+  tube->CappingOn();
+  tube->SidesShareVerticesOff();
+  tube->SetOnRatio(2);
+  tube->SetOffset(1);
+  tube->SetVaryRadius(VTK_VARY_RADIUS_BY_SCALAR);
+  tube->SetGenerateTCoords(VTK_TCOORDS_FROM_NORMALIZED_LENGTH);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(tube.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == (3 + 2) * numStrips / 6);
+  VTK_TEST_CHECK(output->GetPointData()->GetTCoords() != nullptr);
+
+  // A negative radius discards its polyline.
+  tube->SetVaryRadius(VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR);
+  vtkDataArray* scalars = input->GetPointData()->GetScalars();
+  scalars->SetComponent(1 + 2 * NumberOfLinePoints + 5, 0, -1.0);
+  scalars->Modified();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(tube.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == (3 + 2) * (numStrips / 6 - 1));
+  VTK_TEST_CHECK(tube->GetRadius() == 0.1);
+
+  VTK_TEST_CHECK(TestClosedLoop() == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestStraightLines() == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAppendDataInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file   vtkAppendDataInternal.h
+ * @brief  copy of the attributes of appended inputs within threads
+ *
+ * vtkAppendFilter and vtkAppendPolyData copy each input to its own range of
+ * output tuples, the inputs being processed concurrently. These helpers copy
+ * the tuples of the arrays that distinct threads can write, the other arrays
+ * being copied serially afterwards.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkAppendFilter vtkAppendPolyData
+ */
+
+#ifndef vtkAppendDataInternal_h
+#define vtkAppendDataInternal_h
+
+#include "vtkArrayDispatch.h"
+#include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDataSetAttributes.h"
+
+#include <algorithm>
+
+namespace
+{ // anonymous namespace
+
+// Copies numTuples tuples of an array from srcStart, to the tuples of another
+// array from dstStart.
+struct CopyTuplesWorker
+{
+  vtkIdType SrcStart;
+  vtkIdType DstStart;
+  vtkIdType NumberOfTuples;
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T* src, Array2T* dest) const
+  {
+    const auto srcTuples =
+      vtk::DataArrayTupleRange(src, this->SrcStart, this->SrcStart + this->NumberOfTuples);
+    auto dstTuples =
+      vtk::DataArrayTupleRange(dest, this->DstStart, this->DstStart + this->NumberOfTuples);
+    std::copy(srcTuples.cbegin(), srcTuples.cend(), dstTuples.begin());
+  }
+};
+
+inline void CopyTuples(
+  vtkDataArray* src, vtkDataArray* dst, vtkIdType srcStart, vtkIdType dstStart, vtkIdType numTuples)
+{
+  CopyTuplesWorker worker{ srcStart, dstStart, numTuples };
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(src, dst, worker))
+  {
+    worker(src, dst);
+  }
+}
+
+// Whether distinct tuples of the array can be written concurrently.
+inline bool CanCopyConcurrently(vtkAbstractArray* array)
+{
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  return dataArray && dataArray->GetDataType() != VTK_BIT &&
+    dataArray->HasStandardMemoryLayout();
+}
+
+inline bool CanCopyConcurrently(vtkDataSetAttributes* dsa)
+{
+  for (int i = 0; i < dsa->GetNumberOfArrays(); ++i)
+  {
+    if (!CanCopyConcurrently(dsa->GetAbstractArray(i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copies numTuples tuples of the arrays of an input from srcStart, to the
+// output arrays from dstStart. Only the arrays that can be written
+// concurrently are copied when concurrently is true, only the others when it
+// is false.
+inline void CopyTuples(const vtkDataSetAttributes::FieldList& list, int inputIndex,
+  vtkDataSetAttributes* inDSA, vtkDataSetAttributes* outDSA, vtkIdType dstStart,
+  vtkIdType numTuples, vtkIdType srcStart, bool concurrently)
+{
+  list.TransformData(
+    inputIndex, inDSA, outDSA, [&](vtkAbstractArray* src, vtkAbstractArray* dst) {
+      if (CanCopyConcurrently(dst) != concurrently)
+      {
+        return;
+      }
+      if (concurrently)
+      {
+        CopyTuples(vtkArrayDownCast<vtkDataArray>(src), vtkArrayDownCast<vtkDataArray>(dst),
+          srcStart, dstStart, numTuples);
+      }
+      else
+      {
+        dst->InsertTuples(dstStart, numTuples, srcStart, src);
+      }
+    });
+}
+
+} // anonymous namespace
+
+#endif // vtkAppendDataInternal_h
+// VTK-HeaderTest-Exclude: vtkAppendDataInternal.h
@@ -14,9 +14,13 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
+#include "vtkAppendDataInternal.h"
+#include "vtkArrayDispatch.h"
 #include "vtkBoundingBox.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataSetCollection.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIncrementalOctreePointLocator.h"
@@ -25,15 +29,53 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
+namespace
+{
+// Copies the points merged into to their place in the merged points, and
+// maps all the points to the merged ones.
+struct CopyMergedPointsWorker
+{
+  const vtkIdType* MergeMap;
+  const vtkIdType* PointMap;
+  vtkIdType* GlobalIndices;
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T* src, Array2T* dest) const
+  {
+    const auto srcTuples = vtk::DataArrayTupleRange<3>(src);
+    auto dstTuples = vtk::DataArrayTupleRange<3>(dest);
+    vtkSMPTools::For(0, srcTuples.size(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        const vtkIdType mergedId = this->MergeMap[ptId];
+        if (mergedId == ptId)
+        {
+          dstTuples[this->PointMap[ptId]] = srcTuples[ptId];
+        }
+        this->GlobalIndices[ptId] = this->PointMap[mergedId];
+      }
+    });
+  }
+};
+} // end anon namespace
+
 //------------------------------------------------------------------------------
 vtkAppendFilter::vtkAppendFilter()
 {
@@ -42,6 +84,7 @@ vtkAppendFilter::vtkAppendFilter()
   this->OutputPointsPrecision = DEFAULT_PRECISION;
   this->Tolerance = 0.0;
   this->ToleranceIsAbsolute = true;
+  this->UseStaticPointLocator = false;
 }
 
 //------------------------------------------------------------------------------
@@ -225,8 +268,21 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  // Without polyhedra, the inputs are appended concurrently. The points can
+  // then be merged at once with a static point locator, rather than inserted
+  // one by one.
+  bool hasPolyhedra = false;
+  inputs->InitTraversal(iter);
+  while ((dataSet = inputs->GetNextDataSet(iter)))
+  {
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+    hasPolyhedra |= ug && ug->GetFaces();
+  }
+  const bool appendConcurrently = !hasPolyhedra &&
+    (!reallyMergePoints || (!globalIdsArray && this->UseStaticPointLocator));
+
   // If we aren't merging points, we need to allocate the points here.
-  if (!reallyMergePoints)
+  if (!reallyMergePoints && !appendConcurrently)
   {
     newPts->SetNumberOfPoints(totalNumPts);
   }
@@ -242,7 +298,7 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType* globalIndices = new vtkIdType[totalNumPts];
 
   vtkSmartPointer<vtkIncrementalOctreePointLocator> ptInserter;
-  if (reallyMergePoints)
+  if (reallyMergePoints && !appendConcurrently)
   {
     vtkBoundingBox outputBB;
     inputs->InitTraversal(iter);
@@ -270,111 +326,123 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
     ptInserter->InitPointInsertion(newPts, outputBounds);
   }
 
-  // append the blocks / pieces in terms of the geometry and topology
-  std::unordered_map<vtkIdType, vtkIdType> addedPointsMap;
-  vtkIdType count = 0;
-  vtkIdType ptOffset = 0;
-  float decimal = 0.0;
-  inputs->InitTraversal(iter);
-  int abort = 0;
-  double p[3];
-  while (!abort && (dataSet = inputs->GetNextDataSet(iter)))
+  if (appendConcurrently)
+  {
+    this->AppendConcurrently(inputs, reallyMergePoints, newPts, globalIndices, output);
+    if (this->GetAbortOutput())
+    {
+      delete[] globalIndices;
+      return 1;
+    }
+  }
+  else
   {
-    vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
-    vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
-    vtkIdTypeArray* dataSetGlobalIdsArray = globalIdsArray
-      ? vtkIdTypeArray::SafeDownCast(dataSet->GetPointData()->GetGlobalIds())
-      : nullptr;
-
-    // copy points
-    for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
+    // append the blocks / pieces in terms of the geometry and topology
+    std::unordered_map<vtkIdType, vtkIdType> addedPointsMap;
+    vtkIdType count = 0;
+    vtkIdType ptOffset = 0;
+    float decimal = 0.0;
+    inputs->InitTraversal(iter);
+    int abort = 0;
+    double p[3];
+    while (!abort && (dataSet = inputs->GetNextDataSet(iter)))
     {
-      if (reallyMergePoints)
+      vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
+      vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
+      vtkIdTypeArray* dataSetGlobalIdsArray = globalIdsArray
+        ? vtkIdTypeArray::SafeDownCast(dataSet->GetPointData()->GetGlobalIds())
+        : nullptr;
+
+      // copy points
+      for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
       {
-        if (dataSetGlobalIdsArray)
+        if (reallyMergePoints)
         {
-          vtkIdType globalId = dataSetGlobalIdsArray->GetValue(ptId);
-          auto it = addedPointsMap.find(globalId);
-          if (it == addedPointsMap.end())
+          if (dataSetGlobalIdsArray)
           {
-            globalIndices[ptId + ptOffset] = newPts->GetNumberOfPoints();
-            dataSet->GetPoint(ptId, p);
-            vtkIdType newPtId = newPts->InsertNextPoint(p);
-            addedPointsMap.emplace(globalId, newPtId);
+            vtkIdType globalId = dataSetGlobalIdsArray->GetValue(ptId);
+            auto it = addedPointsMap.find(globalId);
+            if (it == addedPointsMap.end())
+            {
+              globalIndices[ptId + ptOffset] = newPts->GetNumberOfPoints();
+              dataSet->GetPoint(ptId, p);
+              vtkIdType newPtId = newPts->InsertNextPoint(p);
+              addedPointsMap.emplace(globalId, newPtId);
+            }
+            else
+            {
+              globalIndices[ptId + ptOffset] = it->second;
+            }
           }
           else
           {
-            globalIndices[ptId + ptOffset] = it->second;
+            vtkIdType globalPtId = 0;
+            dataSet->GetPoint(ptId, p);
+            ptInserter->InsertUniquePoint(p, globalPtId);
+            globalIndices[ptId + ptOffset] = globalPtId;
+            // The point inserter puts the point into newPts, so we don't have to do that here.
           }
         }
         else
         {
-          vtkIdType globalPtId = 0;
+          globalIndices[ptId + ptOffset] = ptId + ptOffset;
           dataSet->GetPoint(ptId, p);
-          ptInserter->InsertUniquePoint(p, globalPtId);
-          globalIndices[ptId + ptOffset] = globalPtId;
-          // The point inserter puts the point into newPts, so we don't have to do that here.
+          newPts->SetPoint(ptId + ptOffset, p);
         }
-      }
-      else
-      {
-        globalIndices[ptId + ptOffset] = ptId + ptOffset;
-        dataSet->GetPoint(ptId, p);
-        newPts->SetPoint(ptId + ptOffset, p);
-      }
 
-      // Update progress
-      count++;
-      if (!(count % twentieth))
-      {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        // Update progress
+        count++;
+        if (!(count % twentieth))
+        {
+          decimal += 0.05;
+          this->UpdateProgress(decimal);
+          abort = this->GetAbortExecute();
+        }
       }
-    }
 
-    // copy cell
-    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
-    for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
-    {
-      newPtIds->Reset();
-      if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON)
+      // copy cell
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
       {
-        vtkIdType nfaces;
-        const vtkIdType* facePtIds;
-        ug->GetFaceStream(cellId, nfaces, facePtIds);
-        for (vtkIdType id = 0; id < nfaces; ++id)
+        newPtIds->Reset();
+        if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON)
         {
-          vtkIdType nPoints = facePtIds[0];
-          newPtIds->InsertNextId(nPoints);
-          for (vtkIdType j = 1; j <= nPoints; ++j)
+          vtkIdType nfaces;
+          const vtkIdType* facePtIds;
+          ug->GetFaceStream(cellId, nfaces, facePtIds);
+          for (vtkIdType id = 0; id < nfaces; ++id)
           {
-            newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
+            vtkIdType nPoints = facePtIds[0];
+            newPtIds->InsertNextId(nPoints);
+            for (vtkIdType j = 1; j <= nPoints; ++j)
+            {
+              newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
+            }
+            facePtIds += nPoints + 1;
           }
-          facePtIds += nPoints + 1;
+          output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
         }
-        output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
-      }
-      else
-      {
-        dataSet->GetCellPoints(cellId, ptIds);
-        for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
+        else
         {
-          newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
+          dataSet->GetCellPoints(cellId, ptIds);
+          for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
+          {
+            newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
+          }
+          output->InsertNextCell(dataSet->GetCellType(cellId), newPtIds);
         }
-        output->InsertNextCell(dataSet->GetCellType(cellId), newPtIds);
-      }
 
-      // Update progress
-      count++;
-      if (!(count % twentieth))
-      {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        // Update progress
+        count++;
+        if (!(count % twentieth))
+        {
+          decimal += 0.05;
+          this->UpdateProgress(decimal);
+          abort = this->GetAbortExecute();
+        }
       }
+      ptOffset += dataSetNumPts;
     }
-    ptOffset += dataSetNumPts;
   }
 
   // this filter can copy global ids except for global point ids when merging
@@ -389,8 +457,9 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->GetCellData()->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
 
   // Now copy the array data
-  this->AppendArrays(
-    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
+  // Without merging, the point ids are not changed.
+  this->AppendArrays(vtkDataObject::POINT, inputVector,
+    reallyMergePoints ? globalIndices : nullptr, output, newPts->GetNumberOfPoints());
   this->UpdateProgress(0.75);
   this->AppendArrays(vtkDataObject::CELL, inputVector, nullptr, output, output->GetNumberOfCells());
   this->UpdateProgress(1.0);
@@ -457,6 +526,56 @@ void vtkAppendFilter::AppendArrays(int attributesType, vtkInformationVector** in
   vtkDataSetAttributes* outputData = output->GetAttributes(attributesType);
   outputData->CopyAllocate(fieldList, totalNumberOfElements);
 
+  // Without a point map, each input is copied concurrently to its own range of
+  // tuples. The arrays that cannot be written concurrently are copied after.
+  if (globalIds == nullptr)
+  {
+    std::vector<vtkDataSetAttributes*> inputsData;
+    std::vector<vtkIdType> offsets;
+    for (inputs->InitTraversal(iter); (dataSet = inputs->GetNextDataSet(iter));)
+    {
+      if (auto inputData = dataSet->GetAttributes(attributesType))
+      {
+        inputsData.push_back(inputData);
+        offsets.push_back(inputData->GetNumberOfTuples());
+      }
+    }
+    offsets.push_back(0);
+    vtkSMPTools::ExclusiveScan(
+      offsets.begin(), offsets.end(), offsets.begin(), static_cast<vtkIdType>(0));
+    outputData->SetNumberOfTuples(offsets.back());
+
+    const int numInputsData = static_cast<int>(inputsData.size());
+    vtkSMPTools::For(0, numInputsData, [&](int begin, int end) {
+      if (vtkSMPTools::GetSingleThread())
+      {
+        this->CheckAbort();
+      }
+      if (this->GetAbortOutput())
+      {
+        return;
+      }
+      for (int inputIndex = begin; inputIndex < end; ++inputIndex)
+      {
+        CopyTuples(fieldList, inputIndex, inputsData[inputIndex], outputData, offsets[inputIndex],
+          offsets[inputIndex + 1] - offsets[inputIndex], 0, true);
+      }
+    });
+    if (this->GetAbortOutput())
+    {
+      return;
+    }
+    if (!CanCopyConcurrently(outputData))
+    {
+      for (int inputIndex = 0; inputIndex < numInputsData; ++inputIndex)
+      {
+        CopyTuples(fieldList, inputIndex, inputsData[inputIndex], outputData, offsets[inputIndex],
+          offsets[inputIndex + 1] - offsets[inputIndex], 0, false);
+      }
+    }
+    return;
+  }
+
   // copy arrays.
   int inputIndex;
   vtkIdType offset = 0;
@@ -483,6 +602,163 @@ void vtkAppendFilter::AppendArrays(int attributesType, vtkInformationVector** in
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkAppendFilter::AppendConcurrently(vtkDataSetCollection* inputs, bool mergePoints,
+  vtkPoints* newPts, vtkIdType* globalIndices, vtkUnstructuredGrid* output)
+{
+  // Scan the sizes of the inputs into their offsets in the output.
+  std::vector<vtkDataSet*> dataSets;
+  vtkCollectionSimpleIterator iter;
+  vtkDataSet* dataSet;
+  for (inputs->InitTraversal(iter); (dataSet = inputs->GetNextDataSet(iter));)
+  {
+    dataSets.push_back(dataSet);
+  }
+  const vtkIdType numDataSets = static_cast<vtkIdType>(dataSets.size());
+  std::vector<vtkIdType> ptOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> cellOffsets(numDataSets + 1, 0);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < numDataSets; ++i)
+  {
+    ptOffsets[i] = dataSets[i]->GetNumberOfPoints();
+    cellOffsets[i] = dataSets[i]->GetNumberOfCells();
+    if (cellOffsets[i] > 0)
+    {
+      // The first calls of these methods build the cells, which is not
+      // thread safe.
+      vtkIdType npts;
+      const vtkIdType* pts;
+      dataSets[i]->GetCellType(0);
+      dataSets[i]->GetCellPoints(0, npts, pts, ptIds);
+    }
+  }
+  vtkSMPTools::ExclusiveScan(
+    ptOffsets.begin(), ptOffsets.end(), ptOffsets.begin(), static_cast<vtkIdType>(0));
+  vtkSMPTools::ExclusiveScan(
+    cellOffsets.begin(), cellOffsets.end(), cellOffsets.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numPts = ptOffsets.back();
+  const vtkIdType numCells = cellOffsets.back();
+
+  // Copy the points and cell types of each input.
+  newPts->SetNumberOfPoints(numPts);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numCells);
+  vtkSMPTools::For(0, numDataSets, [&](vtkIdType begin, vtkIdType end) {
+    if (vtkSMPTools::GetSingleThread())
+    {
+      this->CheckAbort();
+    }
+    if (this->GetAbortOutput())
+    {
+      return;
+    }
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkDataSet* input = dataSets[i];
+      const vtkIdType ptOffset = ptOffsets[i];
+      const vtkIdType numInputPts = ptOffsets[i + 1] - ptOffset;
+      vtkPointSet* pointSet = vtkPointSet::SafeDownCast(input);
+      if (pointSet && pointSet->GetPoints())
+      {
+        CopyTuples(pointSet->GetPoints()->GetData(), newPts->GetData(), 0, ptOffset, numInputPts);
+      }
+      else
+      {
+        double p[3];
+        for (vtkIdType ptId = 0; ptId < numInputPts; ++ptId)
+        {
+          input->GetPoint(ptId, p);
+          newPts->SetPoint(ptOffset + ptId, p);
+        }
+      }
+      std::iota(globalIndices + ptOffset, globalIndices + ptOffset + numInputPts, ptOffset);
+
+      const vtkIdType cellOffset = cellOffsets[i];
+      for (vtkIdType cellId = 0; cellId < cellOffsets[i + 1] - cellOffset; ++cellId)
+      {
+        types->SetValue(cellOffset + cellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+      }
+    }
+  });
+  if (this->GetAbortOutput())
+  {
+    return;
+  }
+  this->UpdateProgress(0.25);
+
+  if (mergePoints)
+  {
+    // Merge the points, then number the points merged into as the output
+    // points, in their input order.
+    vtkNew<vtkPolyData> appended;
+    appended->SetPoints(newPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(appended);
+    locator->BuildLocator();
+    double tolerance = this->Tolerance;
+    if (!this->ToleranceIsAbsolute)
+    {
+      tolerance *= vtkBoundingBox(newPts->GetBounds()).GetDiagonalLength();
+    }
+    std::vector<vtkIdType> mergeMap(numPts);
+    locator->MergePoints(tolerance, mergeMap.data());
+
+    std::vector<vtkIdType> pointMap(numPts + 1, 0);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        pointMap[ptId] = mergeMap[ptId] == ptId ? 1 : 0;
+      }
+    });
+    vtkSMPTools::ExclusiveScan(
+      pointMap.begin(), pointMap.end(), pointMap.begin(), static_cast<vtkIdType>(0));
+
+    vtkNew<vtkPoints> mergedPts;
+    mergedPts->SetDataType(newPts->GetDataType());
+    mergedPts->SetNumberOfPoints(pointMap.back());
+    vtkDataArray* inArray = newPts->GetData();
+    vtkDataArray* outArray = mergedPts->GetData();
+    CopyMergedPointsWorker worker{ mergeMap.data(), pointMap.data(), globalIndices };
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(inArray, outArray, worker))
+    {
+      worker(inArray, outArray);
+    }
+    newPts->SetData(outArray);
+  }
+  this->UpdateProgress(0.4);
+
+  // Build the cells, looking up the input of each output cell.
+  vtkSMPThreadLocalObject<vtkIdList> threadPtIds;
+  auto getCellPoints = [&](vtkIdType cellId, vtkIdType& npts, const vtkIdType*& pts) {
+    const vtkIdType i =
+      std::upper_bound(cellOffsets.begin(), cellOffsets.end(), cellId) - cellOffsets.begin() - 1;
+    dataSets[i]->GetCellPoints(cellId - cellOffsets[i], npts, pts, threadPtIds.Local());
+    return ptOffsets[i];
+  };
+  auto cellSize = [&](vtkIdType cellId) -> vtkIdType {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    getCellPoints(cellId, npts, pts);
+    return npts;
+  };
+  auto cellPoints = [&](vtkIdType cellId, vtkIdType* outPts) {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    const vtkIdType ptOffset = getCellPoints(cellId, npts, pts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      outPts[j] = globalIndices[pts[j] + ptOffset];
+    }
+  };
+  vtkNew<vtkCellArray> cells;
+  if (!cells->BuildCells(numCells, cellSize, cellPoints))
+  {
+    vtkErrorMacro(<< "Memory allocation failed in append filter");
+    return;
+  }
+  output->SetCells(types, cells);
+}
+
 //------------------------------------------------------------------------------
 int vtkAppendFilter::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
@@ -520,4 +796,7 @@ void vtkAppendFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MergePoints:" << (this->MergePoints ? "On" : "Off") << "\n";
   os << indent << "OutputPointsPrecision: " << this->OutputPointsPrecision << "\n";
   os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "ToleranceIsAbsolute: " << (this->ToleranceIsAbsolute ? "On" : "Off") << "\n";
+  os << indent << "UseStaticPointLocator: " << (this->UseStaticPointLocator ? "On" : "Off")
+     << "\n";
 }
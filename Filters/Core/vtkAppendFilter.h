@@ -29,6 +29,10 @@
  * "GlobalPointIds"), then two points are merged if they share the same point global id,
  * without checking for coincident point.
  *
+ * Unless points are merged with the incremental locator, or inputs have
+ * polyhedra, the points, cells and attributes of the inputs are copied in
+ * parallel, each input directly to its place in the output.
+ *
  * @sa
  * vtkAppendPolyData
  */
@@ -41,6 +45,7 @@
 
 class vtkDataSetAttributes;
 class vtkDataSetCollection;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkAppendFilter : public vtkUnstructuredGridAlgorithm
 {
@@ -91,6 +96,21 @@ public:
   vtkBooleanMacro(ToleranceIsAbsolute, bool);
   ///@}
 
+  ///@{
+  /**
+   * Get/Set whether coincident points are merged with a vtkStaticPointLocator
+   * rather than a vtkIncrementalOctreePointLocator, when `MergePoints` is on
+   * and no point global ids are available. All the points are then appended
+   * first and merged at once, in parallel, instead of being inserted one at a
+   * time. The result is deterministic, but the point kept among coincident
+   * points may differ from the incremental locator's. Inputs with polyhedra
+   * always use the incremental locator. Defaults to Off.
+   */
+  vtkSetMacro(UseStaticPointLocator, bool);
+  vtkGetMacro(UseStaticPointLocator, bool);
+  vtkBooleanMacro(UseStaticPointLocator, bool);
+  ///@}
+
   /**
    * Remove a dataset from the list of data to append.
    */
@@ -136,6 +156,10 @@ protected:
   // the diagonal of the bounding box of the input.
   bool ToleranceIsAbsolute;
 
+  // If true, points are merged with a static point locator after all the
+  // inputs are appended.
+  bool UseStaticPointLocator;
+
 private:
   vtkAppendFilter(const vtkAppendFilter&) = delete;
   void operator=(const vtkAppendFilter&) = delete;
@@ -144,6 +168,12 @@ private:
   // Caller must delete the returned vtkDataSetCollection.
   vtkDataSetCollection* GetNonEmptyInputs(vtkInformationVector** inputVector);
 
+  // Append the points and cells of inputs without polyhedra concurrently,
+  // merging the points with a static point locator if mergePoints is true.
+  // globalIndices is filled with the output id of each input point.
+  void AppendConcurrently(vtkDataSetCollection* inputs, bool mergePoints, vtkPoints* newPts,
+    vtkIdType* globalIndices, vtkUnstructuredGrid* output);
+
   void AppendArrays(int attributesType, vtkInformationVector** inputVector, vtkIdType* globalIds,
     vtkUnstructuredGrid* output, vtkIdType totalNumberOfElements);
 };
@@ -15,6 +15,7 @@
 #include "vtkAppendPolyData.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkAppendDataInternal.h"
 #include "vtkArrayDispatch.h"
 #include "vtkAssume.h"
 #include "vtkCellArray.h"
@@ -26,11 +27,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendPolyData);
 
@@ -119,18 +123,102 @@ void vtkAppendPolyData::SetInputConnectionByNumber(int num, vtkAlgorithmOutput*
   this->SetNthInputConnection(0, num, input);
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// The sizes of an input, scanned into the offsets of its points, cells and
+// connectivity in the output.
+struct AppendOffsets
+{
+  vtkIdType Points = 0;
+  // Verts, lines, polys and strips.
+  vtkIdType Cells[4] = { 0, 0, 0, 0 };
+  vtkIdType Connectivity[4] = { 0, 0, 0, 0 };
+  // Index of the input in the point and cell field lists.
+  int PointInput = 0;
+  int CellInput = 0;
+
+  AppendOffsets() = default;
+
+  explicit AppendOffsets(vtkPolyData* input)
+  {
+    this->Points = input->GetNumberOfPoints();
+    this->PointInput = this->Points > 0 ? 1 : 0;
+    if (input->GetNumberOfCells() > 0)
+    {
+      vtkCellArray* cells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(),
+        input->GetStrips() };
+      for (int type = 0; type < 4; ++type)
+      {
+        if (cells[type])
+        {
+          this->Cells[type] = cells[type]->GetNumberOfCells();
+          this->Connectivity[type] = cells[type]->GetNumberOfConnectivityIds();
+        }
+      }
+      this->CellInput = 1;
+    }
+  }
+
+  AppendOffsets operator+(const AppendOffsets& other) const
+  {
+    AppendOffsets sum;
+    sum.Points = this->Points + other.Points;
+    for (int type = 0; type < 4; ++type)
+    {
+      sum.Cells[type] = this->Cells[type] + other.Cells[type];
+      sum.Connectivity[type] = this->Connectivity[type] + other.Connectivity[type];
+    }
+    sum.PointInput = this->PointInput + other.PointInput;
+    sum.CellInput = this->CellInput + other.CellInput;
+    return sum;
+  }
+};
+
+// Copies the cells of an input to their place in an output cell array sized
+// beforehand, shifting their offsets and point ids.
+struct CopyCellsImpl
+{
+  template <typename DstCellStateT>
+  void operator()(DstCellStateT& dst, vtkCellArray* src, vtkIdType cellOffset,
+    vtkIdType connOffset, vtkIdType pointOffset) const
+  {
+    src->Visit(*this, dst, cellOffset, connOffset, pointOffset);
+  }
+
+  template <typename SrcCellStateT, typename DstCellStateT>
+  void operator()(SrcCellStateT& src, DstCellStateT& dst, vtkIdType cellOffset,
+    vtkIdType connOffset, vtkIdType pointOffset) const
+  {
+    using DstValueType = typename DstCellStateT::ValueType;
+
+    // The first offset of the input is the last one of the previous input.
+    const auto srcOffsets = vtk::DataArrayValueRange<1>(src.GetOffsets(), 1);
+    auto dstOffsets = vtk::DataArrayValueRange<1>(
+      dst.GetOffsets(), cellOffset + 1, cellOffset + 1 + srcOffsets.size());
+    std::transform(srcOffsets.cbegin(), srcOffsets.cend(), dstOffsets.begin(),
+      [connOffset](vtkIdType offset) { return static_cast<DstValueType>(offset + connOffset); });
+
+    const auto srcConn = vtk::DataArrayValueRange<1>(src.GetConnectivity());
+    auto dstConn = vtk::DataArrayValueRange<1>(
+      dst.GetConnectivity(), connOffset, connOffset + srcConn.size());
+    std::transform(srcConn.cbegin(), srcConn.cend(), dstConn.begin(),
+      [pointOffset](vtkIdType ptId) { return static_cast<DstValueType>(ptId + pointOffset); });
+  }
+};
+} // end anon namespace
+
 //------------------------------------------------------------------------------
 int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[], int numInputs)
 {
   int idx;
   vtkPolyData* ds;
-  vtkPoints* inPts;
   vtkPoints* newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
+  vtkCellArray* newVerts;
+  vtkCellArray* newLines;
+  vtkCellArray* newPolys;
   vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
+  vtkCellArray* newStrips;
   vtkIdType numPts, numCells;
   vtkPointData* inPD = nullptr;
   vtkCellData* inCD = nullptr;
@@ -287,41 +375,30 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
 
   newPts->SetNumberOfPoints(numPts);
 
-  newVerts = vtkCellArray::New();
-  bool allocated = newVerts->AllocateExact(numVerts, sizeVerts);
-
-  if (sizeVerts > 0 && !allocated)
+  // The output cells are sized up front so that each input can write its
+  // cells at its own offsets.
+  vtkCellArray* newCells[4];
+  const vtkIdType numTypeCells[4] = { numVerts, numLines, numPolys, numStrips };
+  const vtkIdType sizeTypeCells[4] = { sizeVerts, sizeLines, sizePolys, sizeStrips };
+  for (int type = 0; type < 4; ++type)
   {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newLines = vtkCellArray::New();
-  allocated = newLines->AllocateExact(numLines, sizeLines);
-
-  if (sizeLines > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newPolys = vtkCellArray::New();
-  allocated = newPolys->AllocateExact(numPolys, sizePolys);
-
-  if (sizePolys > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newStrips = vtkCellArray::New();
-  allocated = newStrips->AllocateExact(numStrips, sizeStrips);
-
-  if (sizeStrips > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
+    newCells[type] = vtkCellArray::New();
+    if (!newCells[type]->ResizeExact(numTypeCells[type], sizeTypeCells[type]))
+    {
+      vtkErrorMacro(<< "Memory allocation failed in append filter");
+      for (int i = 0; i <= type; ++i)
+      {
+        newCells[i]->Delete();
+      }
+      newPts->Delete();
+      return 0;
+    }
+    newCells[type]->GetOffsetsArray()->SetComponent(0, 0, 0);
   }
+  newVerts = newCells[0];
+  newLines = newCells[1];
+  newPolys = newCells[2];
+  newStrips = newCells[3];
 
   // Since points are cells are not merged,
   // this filter can easily pass all field arrays, including global ids.
@@ -331,76 +408,96 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
   // Allocate the point and cell data
   outputPD->CopyAllocate(ptList, numPts);
   outputCD->CopyAllocate(cellList, numCells);
+  outputPD->SetNumberOfTuples(numPts);
+  outputCD->SetNumberOfTuples(numCells);
 
-  // loop over all input sets
-  vtkIdType ptOffset = 0;
-  vtkIdType vertOffset = 0;
-  vtkIdType linesOffset = numVerts;
-  vtkIdType polysOffset = numVerts + numLines;
-  vtkIdType stripsOffset = numVerts + numLines + numPolys;
-  countPD = countCD = 0;
+  // Scan the sizes of the inputs into their offsets in the output.
+  std::vector<AppendOffsets> offsets(numInputs + 1);
   for (idx = 0; idx < numInputs; ++idx)
   {
-    this->UpdateProgress(0.2 + 0.8 * idx / numInputs);
     ds = inputs[idx];
-    // this check is not necessary, but I'll put it in anyway
     if (ds != nullptr)
     {
-      numPts = ds->GetNumberOfPoints();
-      numCells = ds->GetNumberOfCells();
-      if (numPts <= 0 && numCells <= 0)
-      {
-        continue; // no input, just skip
-      }
-
-      inPD = ds->GetPointData();
-      inCD = ds->GetCellData();
-
-      inPts = ds->GetPoints();
-      inVerts = ds->GetVerts();
-      inLines = ds->GetLines();
-      inPolys = ds->GetPolys();
-      inStrips = ds->GetStrips();
-
-      if (ds->GetNumberOfPoints() > 0)
+      offsets[idx] = AppendOffsets(ds);
+    }
+  }
+  vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(), offsets.begin(), AppendOffsets());
+  this->UpdateProgress(0.20);
+
+  // Each input is copied to its own part of the output, concurrently. The
+  // arrays that cannot be written concurrently are copied afterwards.
+  const vtkIdType typeOffsets[4] = { 0, numVerts, numVerts + numLines,
+    numVerts + numLines + numPolys };
+  auto copyInput = [&](vtkIdType inputIdx, bool concurrently) {
+    vtkPolyData* input = inputs[inputIdx];
+    const AppendOffsets& offset = offsets[inputIdx];
+    if (input == nullptr)
+    {
+      return;
+    }
+    if (input->GetNumberOfPoints() > 0)
+    {
+      if (concurrently)
       {
-        // copy points directly
-        this->AppendData(newPts->GetData(), inPts->GetData(), ptOffset);
-        outputPD->CopyData(ptList, inPD, countPD, ptOffset, numPts, 0);
-        ++countPD;
+        this->AppendData(newPts->GetData(), input->GetPoints()->GetData(), offset.Points);
       }
-
-      if (ds->GetNumberOfCells() > 0)
+      CopyTuples(ptList, offset.PointInput, input->GetPointData(), outputPD, offset.Points,
+        input->GetNumberOfPoints(), 0, concurrently);
+    }
+    if (input->GetNumberOfCells() > 0)
+    {
+      vtkCellArray* inCells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(),
+        input->GetStrips() };
+      vtkIdType srcStart = 0;
+      for (int type = 0; type < 4; ++type)
       {
-        // These are the cellIDs at which each of the cell types start.
-        vtkIdType vertsIndex = 0;
-        vtkIdType linesIndex = ds->GetNumberOfVerts();
-        vtkIdType polysIndex = linesIndex + ds->GetNumberOfLines();
-        vtkIdType stripsIndex = polysIndex + ds->GetNumberOfPolys();
-
-        // copy the cells
-        this->AppendCells(newVerts, inVerts, ptOffset);
-        this->AppendCells(newLines, inLines, ptOffset);
-        this->AppendCells(newPolys, inPolys, ptOffset);
-        this->AppendCells(newStrips, inStrips, ptOffset);
-
-        // copy cell data
-        outputCD->CopyData(cellList, inCD, countCD, vertOffset, ds->GetNumberOfVerts(), vertsIndex);
-        vertOffset += ds->GetNumberOfVerts();
-        outputCD->CopyData(
-          cellList, inCD, countCD, linesOffset, ds->GetNumberOfLines(), linesIndex);
-        linesOffset += ds->GetNumberOfLines();
-        outputCD->CopyData(
-          cellList, inCD, countCD, polysOffset, ds->GetNumberOfPolys(), polysIndex);
-        polysOffset += ds->GetNumberOfPolys();
-        outputCD->CopyData(
-          cellList, inCD, countCD, stripsOffset, ds->GetNumberOfStrips(), stripsIndex);
-        stripsOffset += ds->GetNumberOfStrips();
-        ++countCD;
+        const vtkIdType numInCells = inCells[type] ? inCells[type]->GetNumberOfCells() : 0;
+        if (numInCells == 0)
+        {
+          continue;
+        }
+        if (concurrently)
+        {
+          newCells[type]->Visit(CopyCellsImpl{}, inCells[type], offset.Cells[type],
+            offset.Connectivity[type], offset.Points);
+        }
+        CopyTuples(cellList, offset.CellInput, input->GetCellData(), outputCD,
+          typeOffsets[type] + offset.Cells[type], numInCells, srcStart, concurrently);
+        srcStart += numInCells;
       }
-      ptOffset += numPts;
     }
+  };
+  vtkSMPTools::For(0, numInputs, [&](vtkIdType begin, vtkIdType end) {
+    if (vtkSMPTools::GetSingleThread())
+    {
+      this->CheckAbort();
+    }
+    if (this->GetAbortOutput())
+    {
+      return;
+    }
+    for (vtkIdType inputIdx = begin; inputIdx < end; ++inputIdx)
+    {
+      copyInput(inputIdx, true);
+    }
+  });
+  if (this->GetAbortOutput())
+  {
+    newPts->Delete();
+    newVerts->Delete();
+    newLines->Delete();
+    newPolys->Delete();
+    newStrips->Delete();
+    return 1;
   }
+  if (!CanCopyConcurrently(outputPD) || !CanCopyConcurrently(outputCD))
+  {
+    for (idx = 0; idx < numInputs; ++idx)
+    {
+      copyInput(idx, false);
+    }
+  }
+  this->UpdateProgress(0.90);
 
   // Update ourselves and release memory
   //
@@ -456,10 +553,37 @@ int vtkAppendPolyData::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   vtkPolyData** inputs = new vtkPolyData*[numInputs];
+  vtkPolyData* nonEmptyInput = nullptr;
+  int numNonEmptyInputs = 0;
   for (int idx = 0; idx < numInputs; ++idx)
   {
     inputs[idx] = vtkPolyData::GetData(inputVector[0], idx);
+    if (inputs[idx] &&
+      (inputs[idx]->GetNumberOfPoints() > 0 || inputs[idx]->GetNumberOfCells() > 0))
+    {
+      nonEmptyInput = inputs[idx];
+      ++numNonEmptyInputs;
+    }
   }
+
+  // Appending a single non empty input gives the same geometry and
+  // attributes, so it is passed through unless its points must be converted.
+  if (numNonEmptyInputs == 1)
+  {
+    const int pointsType =
+      nonEmptyInput->GetPoints() ? nonEmptyInput->GetPoints()->GetDataType() : VTK_FLOAT;
+    if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION ||
+      (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION &&
+        pointsType == VTK_FLOAT) ||
+      (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION &&
+        pointsType == VTK_DOUBLE))
+    {
+      output->ShallowCopy(nonEmptyInput);
+      delete[] inputs;
+      return 1;
+    }
+  }
+
   int retVal = this->ExecuteAppend(output, inputs, numInputs);
   delete[] inputs;
   return retVal;
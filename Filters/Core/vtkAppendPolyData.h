@@ -24,6 +24,10 @@
  * attributes available.  (For example, if one dataset has point scalars but
  * another does not, point scalars will not be appended.)
  *
+ * The inputs are copied in parallel, each input directly to its place in the
+ * output. A single non-empty input is shallow copied to the output, unless
+ * OutputPointsPrecision requires its points to be converted.
+ *
  * @warning
  * The related filter vtkRemovePolyData enables the subtraction, or removal
  * of the cells of a vtkPolyData. Hence vtkRemovePolyData functions like the
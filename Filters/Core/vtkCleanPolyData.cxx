@@ -14,20 +14,32 @@
 =========================================================================*/
 #include "vtkCleanPolyData.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkCleanPolyData);
 
@@ -47,6 +59,64 @@ bool InsertPointUsingGlobalId(vtkIdType globalId, vtkPoints* newPts,
   ptId = it->second;
   return false;
 }
+
+// Number of input cells per block when assembling the output in parallel.
+// The cleaned cells of each output type are counted per block, so that each
+// block writes its cells after the ones of the previous blocks, in the order
+// of the serial algorithm.
+constexpr vtkIdType BlockSize = 4096;
+
+// Maps the points of a cell and removes the degeneracies the merging
+// introduced, with the same rules as the serial algorithm. Returns the type
+// of cell array (verts, lines, polys, strips) the cell goes to, or -1 if the
+// cell is removed.
+struct CellCleaner
+{
+  const vtkIdType* PointMap;
+  bool ConvertLinesToPoints;
+  bool ConvertPolysToLines;
+  bool ConvertStripsToPolys;
+
+  int operator()(int type, vtkIdType npts, const vtkIdType* pts, vtkIdType* newPts,
+    vtkIdType& numNewPts) const
+  {
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const vtkIdType ptId = this->PointMap[pts[i]];
+      // Vertices keep their duplicate points.
+      if (type == 0 || numNewPts == 0 || ptId != newPts[numNewPts - 1])
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+    if ((type == 2 && numNewPts > 2) || (type == 3 && numNewPts > 1))
+    {
+      if (newPts[0] == newPts[numNewPts - 1])
+      {
+        --numNewPts;
+      }
+    }
+
+    if (type == 3 && numNewPts > 3)
+    {
+      return 3;
+    }
+    if (type >= 2 && numNewPts > 2)
+    {
+      return numNewPts == 3 && type == 3 && npts != 3 && !this->ConvertStripsToPolys ? -1 : 2;
+    }
+    if (type >= 1 && numNewPts >= 2)
+    {
+      return (type == 1 || npts == 2 || this->ConvertPolysToLines) ? 1 : -1;
+    }
+    if (numNewPts >= 1)
+    {
+      return (type == 0 || npts == 1 || this->ConvertLinesToPoints) ? 0 : -1;
+    }
+    return -1;
+  }
+};
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -59,6 +129,7 @@ vtkCxxSetObjectMacro(vtkCleanPolyData, Locator, vtkIncrementalPointLocator);
 vtkCleanPolyData::vtkCleanPolyData()
 {
   this->PointMerging = 1;
+  this->ParallelMerging = 0;
   this->ToleranceIsAbsolute = 0;
   this->Tolerance = 0.0;
   this->AbsoluteTolerance = 1.0;
@@ -151,6 +222,11 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     vtkDebugMacro(<< "No data to Operate On!");
     return 1;
   }
+  if (this->PointMerging && this->ParallelMerging &&
+    !vtkIdTypeArray::SafeDownCast(input->GetPointData()->GetGlobalIds()))
+  {
+    return this->CleanInParallel(input, output);
+  }
   vtkIdType* updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -649,6 +725,285 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// Parallel version of the point merging. The points within tolerance of each
+// other are gathered by a concurrent union-find over the neighborhoods given
+// by a vtkStaticPointLocator, then the cells are remapped and cleaned in
+// blocks, and assembled at offsets given by prefix sums.
+int vtkCleanPolyData::CleanInParallel(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkPoints* inPts = input->GetPoints();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData* inputPD = input->GetPointData();
+  vtkCellData* inputCD = input->GetCellData();
+  vtkCellArray* inCells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(),
+    input->GetStrips() };
+  vtkIdType cellStarts[5] = { 0 };
+  for (int type = 0; type < 4; ++type)
+  {
+    cellStarts[type + 1] = cellStarts[type] + inCells[type]->GetNumberOfCells();
+  }
+  const vtkIdType numCells = cellStarts[4];
+  const int maxCellSize = input->GetMaxCellSize();
+
+  // Only the points used by the cells are merged and passed to the output.
+  std::unique_ptr<std::atomic<unsigned char>[]> used(new std::atomic<unsigned char>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      used[ptId].store(0, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPThreadLocalObject<vtkIdList> threadIds;
+  for (vtkCellArray* cells : inCells)
+  {
+    vtkSMPTools::For(0, cells->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = threadIds.Local();
+      vtkIdType npts;
+      const vtkIdType* pts;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        cells->GetCellAtId(cellId, npts, pts, ids);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          used[pts[i]].store(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  // Number the used points: only they are binned and merged.
+  std::vector<vtkIdType> usedIds(numPts + 1, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      usedIds[ptId] = used[ptId].load(std::memory_order_relaxed);
+    }
+  });
+  used.reset();
+  vtkSMPTools::ExclusiveScan(
+    usedIds.begin(), usedIds.end(), usedIds.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numUsedPts = usedIds[numPts];
+
+  // Set the desired precision for the points in the output.
+  vtkNew<vtkPoints> usedPts;
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    usedPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    usedPts->SetDataType(VTK_DOUBLE);
+  }
+  else
+  {
+    usedPts->SetDataType(inPts->GetDataType());
+  }
+  usedPts->SetNumberOfPoints(numUsedPts);
+  std::vector<vtkIdType> sourceUsedPts(numUsedPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3], newx[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType usedId = usedIds[ptId];
+      if (usedId < usedIds[ptId + 1])
+      {
+        inPts->GetPoint(ptId, x);
+        this->OperateOnPoint(x, newx);
+        usedPts->SetPoint(usedId, newx);
+        sourceUsedPts[usedId] = ptId;
+      }
+    }
+  });
+  this->UpdateProgress(0.2);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // Merge each used point into a point within tolerance of it, as the
+  // incremental insertion does. The threaded bin ordering of the locator
+  // does not depend on the number of threads.
+  const double tol =
+    this->ToleranceIsAbsolute ? this->AbsoluteTolerance : this->Tolerance * input->GetLength();
+  std::vector<vtkIdType> mergeMap(numUsedPts);
+  if (numUsedPts > 0)
+  {
+    vtkNew<vtkPolyData> usedInput;
+    usedInput->SetPoints(usedPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(usedInput);
+    locator->SetTraversalOrderToBinOrder();
+    locator->BuildLocator();
+    locator->MergePoints(tol, mergeMap.data());
+  }
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // The points merged into become the output points, in their input order.
+  std::vector<vtkIdType> newIds(numUsedPts + 1, 0);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType usedId = begin; usedId < end; ++usedId)
+    {
+      newIds[usedId] = mergeMap[usedId] == usedId ? 1 : 0;
+    }
+  });
+  vtkSMPTools::ExclusiveScan(
+    newIds.begin(), newIds.end(), newIds.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewPts = newIds[numUsedPts];
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  std::vector<vtkIdType> sourcePts(numNewPts);
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(usedPts->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType usedId = begin; usedId < end; ++usedId)
+    {
+      const vtkIdType newId = newIds[mergeMap[usedId]];
+      pointMap[sourceUsedPts[usedId]] = newId;
+      if (mergeMap[usedId] == usedId)
+      {
+        sourcePts[newId] = sourceUsedPts[usedId];
+        usedPts->GetPoint(usedId, x);
+        newPts->SetPoint(newId, x);
+      }
+    }
+  });
+  vtkPointData* outputPD = output->GetPointData();
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  ArrayList::CopyAttributes(inputPD, outputPD, sourcePts);
+  output->SetPoints(newPts);
+  this->UpdateProgress(0.7);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // Clean the cells, and count the output cells of each type in each block.
+  // The cells of an output type keep the order of the input cells, as in the
+  // serial algorithm.
+  const CellCleaner cleaner{ pointMap.data(), this->ConvertLinesToPoints != 0,
+    this->ConvertPolysToLines != 0, this->ConvertStripsToPolys != 0 };
+  std::vector<signed char> newTypes(numCells);
+  std::vector<vtkIdType> newSizes(numCells);
+  const vtkIdType numBlocks = (numCells + BlockSize - 1) / BlockSize;
+  std::vector<vtkIdType> counts(4 * (numBlocks + 1) + 1, 0);
+  vtkSMPThreadLocal<std::vector<vtkIdType>> threadPts;
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    vtkIdList* ids = threadIds.Local();
+    std::vector<vtkIdType>& newCellPts = threadPts.Local();
+    newCellPts.resize(maxCellSize);
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType end = std::min(numCells, (block + 1) * BlockSize);
+      for (vtkIdType cellId = block * BlockSize; cellId < end; ++cellId)
+      {
+        const int type = static_cast<int>(
+          std::upper_bound(cellStarts + 1, cellStarts + 4, cellId) - (cellStarts + 1));
+        inCells[type]->GetCellAtId(cellId - cellStarts[type], npts, pts, ids);
+        const int newType = cleaner(type, npts, pts, newCellPts.data(), newSizes[cellId]);
+        newTypes[cellId] = static_cast<signed char>(newType);
+        if (newType >= 0)
+        {
+          ++counts[newType * (numBlocks + 1) + block];
+        }
+      }
+    }
+  });
+
+  // The output cells are ordered by type, then by block. An extra zero count
+  // after the blocks of each type gives the start of the next type.
+  vtkSMPTools::ExclusiveScan(
+    counts.begin(), counts.end(), counts.begin(), static_cast<vtkIdType>(0));
+  vtkIdType newCellStarts[5];
+  for (int type = 0; type < 5; ++type)
+  {
+    newCellStarts[type] = counts[type * (numBlocks + 1)];
+  }
+  std::vector<vtkIdType> sourceCells(newCellStarts[4]);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType offsets[4];
+      for (int type = 0; type < 4; ++type)
+      {
+        offsets[type] = counts[type * (numBlocks + 1) + block];
+      }
+      const vtkIdType end = std::min(numCells, (block + 1) * BlockSize);
+      for (vtkIdType cellId = block * BlockSize; cellId < end; ++cellId)
+      {
+        if (newTypes[cellId] >= 0)
+        {
+          sourceCells[offsets[newTypes[cellId]]++] = cellId;
+        }
+      }
+    }
+  });
+  newTypes.clear();
+  newTypes.shrink_to_fit();
+
+  vtkSmartPointer<vtkCellArray> newCells[4];
+  for (int newType = 0; newType < 4; ++newType)
+  {
+    const vtkIdType start = newCellStarts[newType];
+    const vtkIdType numNewCells = newCellStarts[newType + 1] - start;
+    if (numNewCells == 0)
+    {
+      continue;
+    }
+    auto cellSize = [&](vtkIdType newCellId) { return newSizes[sourceCells[start + newCellId]]; };
+    auto cellPoints = [&](vtkIdType newCellId, vtkIdType* newCellPts) {
+      const vtkIdType cellId = sourceCells[start + newCellId];
+      const int type = static_cast<int>(
+        std::upper_bound(cellStarts + 1, cellStarts + 4, cellId) - (cellStarts + 1));
+      vtkIdType npts, numNewCellPts;
+      const vtkIdType* pts;
+      std::vector<vtkIdType>& buffer = threadPts.Local();
+      buffer.resize(maxCellSize);
+      inCells[type]->GetCellAtId(cellId - cellStarts[type], npts, pts, threadIds.Local());
+      cleaner(type, npts, pts, buffer.data(), numNewCellPts);
+      std::copy(buffer.begin(), buffer.begin() + numNewCellPts, newCellPts);
+    };
+    newCells[newType] = vtkSmartPointer<vtkCellArray>::New();
+    if (!newCells[newType]->BuildCells(numNewCells, cellSize, cellPoints))
+    {
+      vtkErrorMacro("Cannot allocate the output cells.");
+      return 0;
+    }
+  }
+  if (newCells[0])
+  {
+    output->SetVerts(newCells[0]);
+  }
+  if (newCells[1])
+  {
+    output->SetLines(newCells[1]);
+  }
+  if (newCells[2])
+  {
+    output->SetPolys(newCells[2]);
+  }
+  if (newCells[3])
+  {
+    output->SetStrips(newCells[3]);
+  }
+
+  vtkCellData* outputCD = output->GetCellData();
+  outputCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
+  outputCD->CopyAllocate(inputCD, static_cast<vtkIdType>(sourceCells.size()));
+  ArrayList::CopyAttributes(inputCD, outputCD, sourceCells);
+
+  vtkDebugMacro(<< "Removed " << numPts - numNewPts << " points and "
+                << numCells - newCellStarts[4] << " cells");
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -705,6 +1060,7 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Point Merging: " << (this->PointMerging ? "On\n" : "Off\n");
+  os << indent << "Parallel Merging: " << (this->ParallelMerging ? "On\n" : "Off\n");
   os << indent << "ToleranceIsAbsolute: " << (this->ToleranceIsAbsolute ? "On\n" : "Off\n");
   os << indent << "Tolerance: " << (this->Tolerance ? "On\n" : "Off\n");
   os << indent << "AbsoluteTolerance: " << (this->AbsoluteTolerance ? "On\n" : "Off\n");
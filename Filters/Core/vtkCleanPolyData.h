@@ -160,6 +160,25 @@ public:
   vtkBooleanMacro(PointMerging, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get a boolean value that controls whether points are merged in
+   * parallel. If on, and points are merged by tolerance (i.e., without point
+   * global ids), the Locator is not used: the points used by the cells are
+   * merged with vtkStaticPointLocator::MergePoints(), each point being merged
+   * into a point within the tolerance of it. The cells are then remapped, and
+   * degenerate cells converted or removed, in a threaded pass following the
+   * same rules as the serial path. The points merged into may differ from
+   * the ones the incremental insertion keeps, so the output points may differ
+   * by up to the tolerance; they are ordered by their input ids.
+   * OperateOnPoint() must be thread safe. By default, parallel merging is
+   * off.
+   */
+  vtkSetMacro(ParallelMerging, vtkTypeBool);
+  vtkGetMacro(ParallelMerging, vtkTypeBool);
+  vtkBooleanMacro(ParallelMerging, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
@@ -221,7 +240,12 @@ protected:
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  // Merge the points and clean the cells with the threaded algorithm, see
+  // ParallelMerging.
+  int CleanInParallel(vtkPolyData* input, vtkPolyData* output);
+
   vtkTypeBool PointMerging;
+  vtkTypeBool ParallelMerging;
   double Tolerance;
   double AbsoluteTolerance;
   vtkTypeBool ConvertLinesToPoints;
@@ -12,10 +12,14 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkConnectivityFilter.h"
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityFilterInternal.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -31,6 +35,7 @@
 #include "vtkUnstructuredGrid.h"
 
 #include <map>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkConnectivityFilter);
 
@@ -54,12 +59,23 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->NeighborCellPointIds = vtkIdList::New();
   this->NeighborCellPointIds->Allocate(8);
 
+  this->Visited = nullptr;
+  this->PointMap = nullptr;
+  this->RegionNumber = 0;
+  this->PointNumber = 0;
+  this->NumCellsInRegion = 0;
+  this->Wave = nullptr;
+  this->Wave2 = nullptr;
+
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
   this->NewScalars = nullptr;
   this->NewCellScalars = nullptr;
 
+  this->RegionSizesOnly = false;
+  this->SequentialProcessing = false;
+
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 }
 
@@ -131,7 +147,7 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType numPts, numCells, cellId, i, j, pt;
   vtkPoints* newPts;
   vtkIdType id;
-  vtkIdType maxCellsInRegion;
+  vtkIdType maxCellsInRegion = 0;
   vtkIdType largestRegionId = 0;
   vtkPointData *pd = input->GetPointData(), *outputPD = output->GetPointData();
   vtkCellData *cd = input->GetCellData(), *outputCD = output->GetCellData();
@@ -171,19 +187,9 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  // Initialize.  Keep track of points and cells visited.
+  // Initialize.
   //
   this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  for (i = 0; i < numCells; i++)
-  {
-    this->Visited[i] = -1;
-  }
-  this->PointMap = new vtkIdType[numPts];
-  for (i = 0; i < numPts; i++)
-  {
-    this->PointMap[i] = -1;
-  }
 
   this->NewScalars = vtkIdTypeArray::New();
   this->NewScalars->SetName("RegionId");
@@ -193,83 +199,36 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   this->NewCellScalars->SetName("RegionId");
   this->NewCellScalars->SetNumberOfTuples(numCells);
 
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
-    if (inputPointSet)
-    {
-      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPts->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
-
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
-  //
-  this->Wave = vtkIdList::New();
-  this->Wave->Allocate(numPts / 4 + 1, numPts);
-  this->Wave2 = vtkIdList::New();
-  this->Wave2->Allocate(numPts / 4 + 1, numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
   this->CellIds = vtkIdList::New();
   this->CellIds->Allocate(8, VTK_CELL_SIZE);
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
+  // The cells are labeled concurrently. GetCellPoints() is thread safe once
+  // it has been called from a single thread.
+  input->GetCellPoints(0, this->PointIds);
+  auto cellPoints = [input](
+                      vtkIdType cell, vtkIdType& npts, const vtkIdType*& pts, vtkIdList* ids) {
+    input->GetCellPoints(cell, ids);
+    npts = ids->GetNumberOfIds();
+    pts = ids->GetPointer(0);
+  };
+  ConnectedRegions regions(numPts, numCells, this->SequentialProcessing);
+  if (this->InScalars)
+  {
+    regions.SetScalarCriterion(cellPoints, this->InScalars, this->ScalarRange, false);
+  }
+  this->UpdateProgress(0.1);
+
   if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
-    {
-      if (cellId && !(cellId % 5000))
-      {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
-      }
-
-      if (this->Visited[cellId] < 0)
-      {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark(input);
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
-      }
-    }
+  { // label all cells with a region number
+    regions.LabelAllRegions(cellPoints);
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
-
+    std::vector<vtkIdType> seeds;
     if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS)
     {
       for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
@@ -280,7 +239,7 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
           input->GetPointCells(pt, this->CellIds);
           for (j = 0; j < this->CellIds->GetNumberOfIds(); j++)
           {
-            this->Wave->InsertNextId(this->CellIds->GetId(j));
+            seeds.push_back(this->CellIds->GetId(j));
           }
         }
       }
@@ -289,11 +248,7 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     {
       for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
       {
-        cellId = this->Seeds->GetId(i);
-        if (cellId >= 0)
-        {
-          this->Wave->InsertNextId(cellId);
-        }
+        seeds.push_back(this->Seeds->GetId(i));
       }
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
@@ -313,20 +268,91 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
       input->GetPointCells(minId, this->CellIds);
       for (j = 0; j < this->CellIds->GetNumberOfIds(); j++)
       {
-        this->Wave->InsertNextId(this->CellIds->GetId(j));
+        seeds.push_back(this->CellIds->GetId(j));
       }
     }
-    this->UpdateProgress(0.5);
 
     // mark all seeded regions
-    this->TraverseAndMark(input);
-    this->RegionSizes->InsertValue(this->RegionNumber, this->NumCellsInRegion);
-    this->UpdateProgress(0.9);
+    regions.LabelSeededRegion(cellPoints, seeds);
+  }
+  this->UpdateProgress(0.5);
+
+  const std::vector<vtkIdType>& visited = regions.CellRegions;
+  const vtkIdType numRegions = static_cast<vtkIdType>(regions.RegionSizes.size());
+  this->RegionSizes->SetNumberOfValues(numRegions);
+  for (vtkIdType regionId = 0; regionId < numRegions; regionId++)
+  {
+    const vtkIdType numCellsInRegion = regions.RegionSizes[regionId];
+    this->RegionSizes->SetValue(regionId, numCellsInRegion);
+    if (numCellsInRegion > maxCellsInRegion)
+    {
+      maxCellsInRegion = numCellsInRegion;
+      largestRegionId = regionId;
+    }
+  }
+  vtkDebugMacro(<< "Extracted " << numRegions << " region(s)");
+
+  if (this->RegionSizesOnly)
+  {
+    // Same order of the region sizes as when the output is built.
+    this->NewScalars->Reset();
+    this->NewCellScalars->Reset();
+    this->OrderRegionIds(this->NewScalars, this->NewCellScalars);
+    this->NewScalars->Delete();
+    this->NewCellScalars->Delete();
+    this->PointIds->Delete();
+    this->CellIds->Delete();
+    return 1;
+  }
+
+  // The points used by the labeled cells are numbered in the order the wave
+  // propagation reaches them, as the serial traversal did. GetPointCells() is
+  // thread safe once it has been called from a single thread.
+  input->GetPointCells(0, this->CellIds);
+  auto pointCells = [input](
+                      vtkIdType ptId, vtkIdType& ncells, const vtkIdType*& cells, vtkIdList* ids) {
+    input->GetPointCells(ptId, ids);
+    ncells = ids->GetNumberOfIds();
+    cells = ids->GetPointer(0);
+  };
+  std::vector<vtkIdType> pointMap = regions.NumberPoints(cellPoints, pointCells, true);
+  for (i = 0; i < numPts; i++)
+  {
+    if (pointMap[i] >= 0)
+    {
+      this->NewScalars->SetValue(pointMap[i], regions.PointRegions[i]);
+    }
+  }
+  for (cellId = 0; cellId < numCells; cellId++)
+  {
+    this->NewCellScalars->SetValue(cellId, visited[cellId]);
   }
 
-  vtkDebugMacro(<< "Extracted " << this->RegionNumber << " region(s)");
-  this->Wave->Delete();
-  this->Wave2->Delete();
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
+    if (inputPointSet)
+    {
+      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
+    }
+    else
+    {
+      newPts->SetDataType(VTK_FLOAT);
+    }
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  newPts->Allocate(numPts);
 
   // Now that points and cells have been marked, traverse these lists pulling
   // everything that has been visited.
@@ -337,10 +363,10 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
 
   for (i = 0; i < numPts; i++)
   {
-    if (this->PointMap[i] > -1)
+    if (pointMap[i] > -1)
     {
-      newPts->InsertPoint(this->PointMap[i], input->GetPoint(i));
-      outputPD->CopyData(pd, i, this->PointMap[i]);
+      newPts->InsertPoint(pointMap[i], input->GetPoint(i));
+      outputPD->CopyData(pd, i, pointMap[i]);
     }
   }
 
@@ -369,21 +395,21 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   { // extract any cell that's been visited
     for (cellId = 0; cellId < numCells; cellId++)
     {
-      if (this->Visited[cellId] >= 0)
+      if (visited[cellId] >= 0)
       {
         // special handling for polyhedron cells
         if (vtkUnstructuredGrid::SafeDownCast(input) &&
           input->GetCellType(cellId) == VTK_POLYHEDRON)
         {
           vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
+          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, pointMap.data());
         }
         else
         {
           input->GetCellPoints(cellId, this->PointIds);
           for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
           {
-            id = this->PointMap[this->PointIds->GetId(i)];
+            id = pointMap[this->PointIds->GetId(i)];
             this->PointIds->InsertId(i, id);
           }
         }
@@ -408,7 +434,7 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     for (cellId = 0; cellId < numCells; cellId++)
     {
       int inReg, regionId;
-      if ((regionId = this->Visited[cellId]) >= 0)
+      if ((regionId = visited[cellId]) >= 0)
       {
         for (inReg = 0, i = 0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
         {
@@ -425,14 +451,14 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
             input->GetCellType(cellId) == VTK_POLYHEDRON)
           {
             vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-            vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
+            vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, pointMap.data());
           }
           else
           {
             input->GetCellPoints(cellId, this->PointIds);
             for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
             {
-              id = this->PointMap[this->PointIds->GetId(i)];
+              id = pointMap[this->PointIds->GetId(i)];
               this->PointIds->InsertId(i, id);
             }
           }
@@ -457,21 +483,21 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   {
     for (cellId = 0; cellId < numCells; cellId++)
     {
-      if (this->Visited[cellId] == largestRegionId)
+      if (visited[cellId] == largestRegionId)
       {
         // special handling for polyhedron cells
         if (vtkUnstructuredGrid::SafeDownCast(input) &&
           input->GetCellType(cellId) == VTK_POLYHEDRON)
         {
           vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
+          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, pointMap.data());
         }
         else
         {
           input->GetCellPoints(cellId, this->PointIds);
           for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
           {
-            id = this->PointMap[this->PointIds->GetId(i)];
+            id = pointMap[this->PointIds->GetId(i)];
             this->PointIds->InsertId(i, id);
           }
         }
@@ -492,8 +518,6 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  delete[] this->Visited;
-  delete[] this->PointMap;
   this->PointIds->Delete();
   this->CellIds->Delete();
   output->Squeeze();
@@ -755,4 +779,6 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   double* range = this->GetScalarRange();
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Region Sizes Only: " << (this->RegionSizesOnly ? "On\n" : "Off\n");
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 }
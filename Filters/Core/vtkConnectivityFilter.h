@@ -45,6 +45,12 @@
  * structure. These voxels can then be contoured or processed by other
  * visualization filters.
  *
+ * The regions are labeled concurrently with a union-find over the shared
+ * points, which numbers them as the serial traversal did: in the order of
+ * their first cell. The points of the output are numbered as the wave
+ * propagation from the first cell of each region reaches them, as the serial
+ * traversal did.
+ *
  * If the extraction mode is set to all regions and ColorRegions is enabled,
  * The RegionIds are assigned to each region by the order in which the region
  * was processed and has no other significance with respect to the size of
@@ -57,6 +63,7 @@
 #ifndef vtkConnectivityFilter_h
 #define vtkConnectivityFilter_h
 
+#include "vtkDeprecation.h"       // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPointSetAlgorithm.h"
 
@@ -215,6 +222,36 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the computation of the region sizes only. When on, the
+   * regions are labeled and their sizes made available through
+   * GetRegionSizes() and GetNumberOfExtractedRegions(), in the order set by
+   * RegionIdAssignmentMode when ColorRegions is on, but the output is left
+   * empty. Off by default.
+   */
+  vtkSetMacro(RegionSizesOnly, bool);
+  vtkGetMacro(RegionSizesOnly, bool);
+  vtkBooleanMacro(RegionSizesOnly, bool);
+  ///@}
+
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the labeling. By
+   * default, sequential processing is off: the regions are labeled
+   * concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
+  /**
+   * Obtain the number of cells in each region found during the last
+   * execution.
+   */
+  vtkGetObjectMacro(RegionSizes, vtkIdTypeArray);
+
 protected:
   vtkConnectivityFilter();
   ~vtkConnectivityFilter() override;
@@ -243,26 +280,32 @@ protected:
 
   int RegionIdAssignmentMode;
 
+  bool RegionSizesOnly;
+  vtkTypeBool SequentialProcessing;
+
+  VTK_DEPRECATED_IN_9_3_0("The regions are labeled concurrently, without this traversal.")
   void TraverseAndMark(vtkDataSet* input);
 
   void OrderRegionIds(vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds);
 
 private:
   // used to support algorithm execution
+  vtkIdTypeArray* NewScalars;
+  vtkIdTypeArray* NewCellScalars;
+  vtkDataArray* InScalars;
+  vtkIdList* PointIds;
+  vtkIdList* CellIds;
+
+  // used by the deprecated TraverseAndMark() only
   vtkFloatArray* CellScalars;
   vtkIdList* NeighborCellPointIds;
   vtkIdType* Visited;
   vtkIdType* PointMap;
-  vtkIdTypeArray* NewScalars;
-  vtkIdTypeArray* NewCellScalars;
   vtkIdType RegionNumber;
   vtkIdType PointNumber;
   vtkIdType NumCellsInRegion;
-  vtkDataArray* InScalars;
   vtkIdList* Wave;
   vtkIdList* Wave2;
-  vtkIdList* PointIds;
-  vtkIdList* CellIds;
 
 private:
   vtkConnectivityFilter(const vtkConnectivityFilter&) = delete;
@@ -0,0 +1,518 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityFilterInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectivityFilterInternal
+ * @brief   concurrent labeling of the connected regions of cells
+ *
+ * vtkConnectivityFilterInternal labels the regions of cells sharing points
+ * with a lock-free union-find over the point ids, and gives the same labels
+ * as a wave propagation from the cells in increasing order: each region is
+ * numbered in the order of its first cell. Cells may be excluded from the
+ * propagation by a scalar criterion; such cells are still labeled when they
+ * seed a region, but are not reached from their neighbors. The points are
+ * then numbered in the order the wave propagation reaches them.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication
+ * between vtkConnectivityFilter and vtkPolyDataConnectivityFilter. It does
+ * not define a public API.
+ *
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ */
+
+#ifndef vtkConnectivityFilterInternal_h
+#define vtkConnectivityFilterInternal_h
+
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+// Lowers an atomic value to the given one, if it is smaller.
+inline void AtomicMin(std::atomic<vtkIdType>& atomic, vtkIdType value)
+{
+  vtkIdType current = atomic.load();
+  while (value < current && !atomic.compare_exchange_weak(current, value))
+  {
+  }
+}
+
+// The cells are accessed through a functor with the signature
+//   void(vtkIdType cellId, vtkIdType& npts, const vtkIdType*& pts, vtkIdList* ids)
+// which must be thread safe, ids being a list owned by the calling thread.
+// The cells using a point are accessed the same way, through a functor with
+// the signature
+//   void(vtkIdType ptId, vtkIdType& ncells, const vtkIdType*& cells, vtkIdList* ids)
+class ConnectedRegions
+{
+public:
+  // The labeling runs in the calling thread when sequential is true.
+  ConnectedRegions(vtkIdType numPts, vtkIdType numCells, bool sequential = false)
+    : NumberOfPoints(numPts)
+    , NumberOfCells(numCells)
+    , Sequential(sequential)
+    , Parents(new std::atomic<vtkIdType>[numPts])
+    , Owners(new std::atomic<vtkIdType>[numPts])
+  {
+  }
+
+  // Region of each cell, -1 for the cells not labeled.
+  std::vector<vtkIdType> CellRegions;
+  // Lowest region of the cells using each point, -1 for unused points.
+  std::vector<vtkIdType> PointRegions;
+  // Number of cells of each region.
+  std::vector<vtkIdType> RegionSizes;
+
+  // Excludes from the propagation the cells whose scalars do not intersect
+  // the given range, or do not lie in it when full is true. Only the first
+  // component of the scalars is considered, in single precision.
+  template <typename CellPoints>
+  void SetScalarCriterion(
+    CellPoints& cellPoints, vtkDataArray* scalars, const double range[2], bool full)
+  {
+    this->Connected.resize(this->NumberOfCells);
+    this->For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        cellPoints(cellId, npts, pts, ids);
+        double cellRange[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          const double s = static_cast<float>(scalars->GetComponent(pts[i], 0));
+          cellRange[0] = std::min(cellRange[0], s);
+          cellRange[1] = std::max(cellRange[1], s);
+        }
+        this->Connected[cellId] = full
+          ? cellRange[0] >= range[0] && cellRange[1] <= range[1]
+          : cellRange[1] >= range[0] && cellRange[0] <= range[1];
+      }
+    });
+  }
+
+  // Labels all the regions, numbered in the order of their first cell.
+  template <typename CellPoints>
+  void LabelAllRegions(CellPoints& cellPoints)
+  {
+    this->BuildSets(cellPoints);
+
+    // A region starts at its first cell, which is either excluded from the
+    // propagation or the owner of its set.
+    const vtkIdType numCells = this->NumberOfCells;
+    this->CellRegions.resize(numCells);
+    std::vector<vtkIdType> isFirst(numCells);
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType owner = this->GetOwner(cellPoints, cellId, ids);
+        this->CellRegions[cellId] = owner;
+        isFirst[cellId] = owner == cellId;
+      }
+    });
+    std::vector<vtkIdType> regionOfFirst(numCells);
+    if (this->Sequential)
+    {
+      vtkIdType numFirst = 0;
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        regionOfFirst[cellId] = numFirst;
+        numFirst += isFirst[cellId];
+      }
+    }
+    else
+    {
+      vtkSMPTools::ExclusiveScan(
+        isFirst.begin(), isFirst.end(), regionOfFirst.begin(), static_cast<vtkIdType>(0));
+    }
+    const vtkIdType numRegions = regionOfFirst[numCells - 1] + isFirst[numCells - 1];
+    this->Seeded = false;
+    this->FirstCells.resize(numRegions);
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->CellRegions[cellId] = regionOfFirst[this->CellRegions[cellId]];
+        if (isFirst[cellId])
+        {
+          this->FirstCells[regionOfFirst[cellId]] = cellId;
+        }
+      }
+    });
+    this->FinishLabeling(cellPoints, numRegions);
+  }
+
+  // Labels as region 0 the seed cells and all the cells reached from them.
+  template <typename CellPoints>
+  void LabelSeededRegion(CellPoints& cellPoints, const std::vector<vtkIdType>& seeds)
+  {
+    this->BuildSets(cellPoints);
+
+    // Mark the sets reached from the seeds.
+    const vtkIdType numCells = this->NumberOfCells;
+    std::vector<unsigned char> isSeed(numCells, 0);
+    std::vector<unsigned char> isReached(this->NumberOfPoints, 0);
+    vtkIdList* ids = this->Ids.Local();
+    this->Seeded = true;
+    this->FirstCells.clear();
+    for (vtkIdType seed : seeds)
+    {
+      if (seed < 0 || seed >= numCells)
+      {
+        continue;
+      }
+      isSeed[seed] = 1;
+      this->FirstCells.push_back(seed);
+      vtkIdType npts;
+      const vtkIdType* pts;
+      cellPoints(seed, npts, pts, ids);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const vtkIdType root = this->Find(pts[i]);
+        if (this->Owners[root].load() != numCells)
+        {
+          isReached[root] = 1;
+        }
+      }
+    }
+
+    this->CellRegions.resize(numCells);
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* localIds = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        bool reached = isSeed[cellId] != 0;
+        if (!reached && this->IsConnected(cellId))
+        {
+          vtkIdType npts;
+          const vtkIdType* pts;
+          cellPoints(cellId, npts, pts, localIds);
+          reached = npts > 0 && isReached[this->Find(pts[0])];
+        }
+        this->CellRegions[cellId] = reached ? 0 : -1;
+      }
+    });
+    this->FinishLabeling(cellPoints, 1);
+  }
+
+  // Numbers the points of the labeled cells as the serial wave propagation
+  // did, the regions being propagated concurrently: region by region, each
+  // point in the order it is reached from the first cell of its region (or
+  // from the seeds). The propagation continues through every point of the
+  // cells when fromAllPoints is true, as in vtkConnectivityFilter, and only
+  // through the points just numbered otherwise, as in
+  // vtkPolyDataConnectivityFilter; this changes the order of the waves.
+  // Returns the new id of each point, -1 for the points not used.
+  template <typename CellPoints, typename PointCells>
+  std::vector<vtkIdType> NumberPoints(
+    CellPoints& cellPoints, PointCells& pointCells, bool fromAllPoints)
+  {
+    const vtkIdType numRegions = static_cast<vtkIdType>(this->RegionSizes.size());
+    std::vector<vtkIdType> regionOffsets(numRegions + 1, 0);
+    for (vtkIdType region : this->PointRegions)
+    {
+      if (region >= 0)
+      {
+        regionOffsets[region + 1]++;
+      }
+    }
+    for (vtkIdType region = 0; region < numRegions; ++region)
+    {
+      regionOffsets[region + 1] += regionOffsets[region];
+    }
+
+    // A cell is only reached from the cells of its own region or of an
+    // earlier one, and a point is numbered by the lowest region using it, so
+    // each region writes its own cells and points only.
+    std::vector<vtkIdType> pointMap(this->NumberOfPoints, -1);
+    std::vector<unsigned char> isVisited(this->NumberOfCells, 0);
+    this->For(0, numRegions, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      vtkIdList* cellIds = this->CellIds.Local();
+      std::vector<vtkIdType> wave;
+      std::vector<vtkIdType> wave2;
+      for (vtkIdType region = begin; region < end; ++region)
+      {
+        vtkIdType pointNumber = regionOffsets[region];
+        if (this->Seeded)
+        {
+          wave = this->FirstCells;
+        }
+        else
+        {
+          wave.assign(1, this->FirstCells[region]);
+        }
+        while (!wave.empty())
+        {
+          for (vtkIdType cellId : wave)
+          {
+            if (this->CellRegions[cellId] != region || isVisited[cellId])
+            {
+              continue;
+            }
+            isVisited[cellId] = 1;
+            vtkIdType npts;
+            const vtkIdType* pts;
+            cellPoints(cellId, npts, pts, ids);
+            for (vtkIdType i = 0; i < npts; ++i)
+            {
+              const vtkIdType ptId = pts[i];
+              const bool isNew = this->PointRegions[ptId] == region && pointMap[ptId] < 0;
+              if (isNew)
+              {
+                pointMap[ptId] = pointNumber++;
+              }
+              if (isNew || fromAllPoints)
+              {
+                vtkIdType ncells;
+                const vtkIdType* cells;
+                pointCells(ptId, ncells, cells, cellIds);
+                for (vtkIdType j = 0; j < ncells; ++j)
+                {
+                  if (this->IsConnected(cells[j]))
+                  {
+                    wave2.push_back(cells[j]);
+                  }
+                }
+              }
+            }
+          }
+          wave.swap(wave2);
+          wave2.clear();
+        }
+      }
+    });
+    return pointMap;
+  }
+
+private:
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  bool Sequential;
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+  // The lowest cell reaching each set, or NumberOfCells.
+  std::unique_ptr<std::atomic<vtkIdType>[]> Owners;
+  std::vector<unsigned char> Connected;
+  // The first cell of each region, or the seeds of the seeded region.
+  std::vector<vtkIdType> FirstCells;
+  bool Seeded = false;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  // Runs the functor over [begin, end), concurrently unless sequential.
+  template <typename Functor>
+  void For(vtkIdType begin, vtkIdType end, Functor&& functor)
+  {
+    if (this->Sequential)
+    {
+      functor(begin, end);
+    }
+    else
+    {
+      vtkSMPTools::For(begin, end, functor);
+    }
+  }
+
+  bool IsConnected(vtkIdType cellId) const
+  {
+    return this->Connected.empty() || this->Connected[cellId];
+  }
+
+  vtkIdType Find(vtkIdType id)
+  {
+    while (true)
+    {
+      vtkIdType parent = this->Parents[id].load();
+      const vtkIdType grandParent = this->Parents[parent].load();
+      if (parent == grandParent)
+      {
+        return parent;
+      }
+      // Path halving. Parents only move toward the root, so a failure means
+      // another thread already shortened the path.
+      this->Parents[id].compare_exchange_weak(parent, grandParent);
+      id = grandParent;
+    }
+  }
+
+  void Unite(vtkIdType a, vtkIdType b)
+  {
+    while (true)
+    {
+      a = this->Find(a);
+      b = this->Find(b);
+      if (a == b)
+      {
+        return;
+      }
+      if (a < b)
+      {
+        std::swap(a, b);
+      }
+      // Link the highest root, unless another thread linked it meanwhile.
+      vtkIdType root = a;
+      if (this->Parents[a].compare_exchange_weak(root, b))
+      {
+        return;
+      }
+    }
+  }
+
+  // Unites the points of the cells taking part in the propagation, then
+  // finds the lowest cell reaching each set: one of its cells, or a cell
+  // excluded from the propagation but using one of its points.
+  template <typename CellPoints>
+  void BuildSets(CellPoints& cellPoints)
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+    this->For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Parents[ptId].store(ptId);
+        this->Owners[ptId].store(numCells);
+      }
+    });
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (this->IsConnected(cellId))
+        {
+          vtkIdType npts;
+          const vtkIdType* pts;
+          cellPoints(cellId, npts, pts, ids);
+          for (vtkIdType i = 1; i < npts; ++i)
+          {
+            this->Unite(pts[0], pts[i]);
+          }
+        }
+      }
+    });
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        cellPoints(cellId, npts, pts, ids);
+        if (npts > 0 && this->IsConnected(cellId))
+        {
+          AtomicMin(this->Owners[this->Find(pts[0])], cellId);
+        }
+      }
+    });
+    if (this->Connected.empty())
+    {
+      return;
+    }
+    // The sets without any cell taking part in the propagation keep no owner.
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (!this->Connected[cellId])
+        {
+          vtkIdType npts;
+          const vtkIdType* pts;
+          cellPoints(cellId, npts, pts, ids);
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            std::atomic<vtkIdType>& owner = this->Owners[this->Find(pts[i])];
+            if (owner.load() != numCells)
+            {
+              AtomicMin(owner, cellId);
+            }
+          }
+        }
+      }
+    });
+  }
+
+  // The first cell of the region of a cell.
+  template <typename CellPoints>
+  vtkIdType GetOwner(CellPoints& cellPoints, vtkIdType cellId, vtkIdList* ids)
+  {
+    if (!this->IsConnected(cellId))
+    {
+      return cellId;
+    }
+    vtkIdType npts;
+    const vtkIdType* pts;
+    cellPoints(cellId, npts, pts, ids);
+    return npts > 0 ? this->Owners[this->Find(pts[0])].load() : cellId;
+  }
+
+  // Computes the region of the points and the size of the regions.
+  template <typename CellPoints>
+  void FinishLabeling(CellPoints& cellPoints, vtkIdType numRegions)
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+    this->For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Owners[ptId].store(numCells);
+      }
+    });
+    this->For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ids = this->Ids.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType region = this->CellRegions[cellId];
+        if (region >= 0)
+        {
+          vtkIdType npts;
+          const vtkIdType* pts;
+          cellPoints(cellId, npts, pts, ids);
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            AtomicMin(this->Owners[pts[i]], region);
+          }
+        }
+      }
+    });
+    this->PointRegions.resize(this->NumberOfPoints);
+    this->For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        const vtkIdType region = this->Owners[ptId].load();
+        this->PointRegions[ptId] = region == numCells ? -1 : region;
+      }
+    });
+
+    this->RegionSizes.assign(numRegions, 0);
+    for (vtkIdType region : this->CellRegions)
+    {
+      if (region >= 0)
+      {
+        this->RegionSizes[region]++;
+      }
+    }
+  }
+};
+
+} // anonymous namespace
+
+#endif // vtkConnectivityFilterInternal_h
+// VTK-HeaderTest-Exclude: vtkConnectivityFilterInternal.h
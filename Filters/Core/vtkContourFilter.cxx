@@ -72,6 +72,7 @@ vtkContourFilter::vtkContourFilter()
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
   this->GenerateTriangles = 1;
+  this->SequentialProcessing = 1;
 
   this->SynchronizedTemplates2D = vtkSynchronizedTemplates2D::New();
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
@@ -419,6 +420,7 @@ int vtkContourFilter::RequestData(
     cgrid->SetComputeScalars(this->ComputeScalars);
     cgrid->SetOutputPointsPrecision(this->OutputPointsPrecision);
     cgrid->SetGenerateTriangles(this->GenerateTriangles);
+    cgrid->SetSequentialProcessing(this->SequentialProcessing);
     cgrid->SetUseScalarTree(this->UseScalarTree);
     if (this->UseScalarTree) // special treatment to reuse it
     {
@@ -760,6 +762,7 @@ void vtkContourFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 }
 
 //------------------------------------------------------------------------------
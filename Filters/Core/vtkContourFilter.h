@@ -192,6 +192,17 @@ public:
   vtkBooleanMacro(GenerateTriangles, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the contouring of
+   * unstructured grids. On by default. This is passed to the internal
+   * vtkContourGrid; see vtkContourGrid::SetSequentialProcessing().
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -222,6 +233,7 @@ protected:
   vtkScalarTree* ScalarTree;
   int OutputPointsPrecision;
   vtkTypeBool GenerateTriangles;
+  vtkTypeBool SequentialProcessing;
 
   vtkSynchronizedTemplates2D* SynchronizedTemplates2D;
   vtkSynchronizedTemplates3D* SynchronizedTemplates3D;
@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkContourGridInternal.h"
 #include "vtkContourHelper.h"
 #include "vtkContourValues.h"
 #include "vtkCutter.h"
@@ -62,6 +63,8 @@ vtkContourGrid::vtkContourGrid()
   this->UseScalarTree = 0;
   this->ScalarTree = nullptr;
 
+  this->SequentialProcessing = 1;
+
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
   // by default process active point scalars
@@ -111,7 +114,7 @@ vtkMTimeType vtkContourGrid::GetMTime()
 //------------------------------------------------------------------------------
 void vtkContourGridExecute(vtkContourGrid* self, vtkDataSet* input, vtkPolyData* output,
   vtkDataArray* inScalars, vtkIdType numContours, double* values, int computeScalars,
-  int useScalarTree, vtkScalarTree* scalarTree, bool generateTriangles)
+  int useScalarTree, vtkScalarTree* scalarTree, bool generateTriangles, bool concurrent)
 {
   vtkIdType i;
   bool abortExecute = false;
@@ -148,6 +151,24 @@ void vtkContourGridExecute(vtkContourGrid* self, vtkDataSet* input, vtkPolyData*
 
   // In this case, we know that the input is an unstructured grid.
   vtkUnstructuredGridBase* grid = static_cast<vtkUnstructuredGridBase*>(input);
+
+  int pointsType = grid->GetPoints()->GetDataType();
+  if (self->GetOutputPointsPrecision() == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    pointsType = VTK_FLOAT;
+  }
+  else if (self->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  if (concurrent)
+  {
+    ContourGridConcurrently(self, input, inScalars, inPd, inCd, values, numContours,
+      useScalarTree ? scalarTree : nullptr, computeScalars != 0, pointsType, output);
+    return;
+  }
+
   int needCell = 0;
   vtkSmartPointer<vtkCellIterator> cellIter =
     vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
@@ -167,20 +188,7 @@ void vtkContourGridExecute(vtkContourGrid* self, vtkDataSet* input, vtkPolyData*
   }
 
   newPts = vtkPoints::New();
-
-  // set precision for the points in the output
-  if (self->GetOutputPointsPrecision() == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(grid->GetPoints()->GetDataType());
-  }
-  else if (self->GetOutputPointsPrecision() == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if (self->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
+  newPts->SetDataType(pointsType);
 
   newPts->Allocate(estimatedSize, estimatedSize);
   newVerts = vtkCellArray::New();
@@ -422,8 +430,12 @@ int vtkContourGrid::RequestData(vtkInformation* vtkNotUsed(request),
     scalarTree->SetScalars(inScalars);
   }
 
+  // The threaded path merges the coincident points, as vtkMergePoints does,
+  // and produces triangles only.
+  const bool concurrent = !this->SequentialProcessing && this->GenerateTriangles &&
+    vtkMergePoints::SafeDownCast(this->Locator) != nullptr;
   vtkContourGridExecute(this, input, output, inScalars, numContours, values, computeScalars,
-    useScalarTree, scalarTree, this->GenerateTriangles != 0);
+    useScalarTree, scalarTree, this->GenerateTriangles != 0, concurrent);
 
   if (this->ComputeNormals)
   {
@@ -526,6 +538,7 @@ void vtkContourGrid::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Normals: " << (this->ComputeNormals ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "Use Scalar Tree: " << (this->UseScalarTree ? "On\n" : "Off\n");
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 
   this->ContourValues->PrintSelf(os, indent.GetNextIndent());
 
@@ -34,6 +34,13 @@
  * contours are being extracted. If you want to use a scalar tree,
  * invoke the method UseScalarTreeOn().
  *
+ * The cells, whatever their type (linear, quadratic, Lagrange, Bezier,
+ * polyhedral...), can be contoured concurrently with vtkSMPTools by turning
+ * SequentialProcessing off. With a scalar tree such as vtkSpanSpace, the
+ * tree is built once and reused while only the contour values change, which
+ * makes interactive sweeps of the contour values practical on large or high
+ * order grids.
+ *
  * @warning
  * If the input vtkUnstructuredGrid contains 3D linear cells, the class
  * vtkContour3DLinearGrid is much faster and may be preferred in certain
@@ -123,6 +130,20 @@ public:
   vtkBooleanMacro(UseScalarTree, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the contouring
+   * process. On by default. When off, the cells are contoured concurrently
+   * with vtkSMPTools as long as the locator merges exactly coincident points
+   * (i.e. is a vtkMergePoints, the default) and GenerateTriangles is on. The
+   * output then has the same cells, in the same order, as the sequential one,
+   * but its points are numbered differently.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Specify the instance of vtkScalarTree to use. If not specified
@@ -187,6 +208,8 @@ protected:
   vtkTypeBool UseScalarTree;
   vtkScalarTree* ScalarTree;
 
+  vtkTypeBool SequentialProcessing;
+
   int OutputPointsPrecision;
   vtkEdgeTable* EdgeTable;
 
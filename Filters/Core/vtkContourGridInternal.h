@@ -0,0 +1,551 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkContourGridInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkContourGridInternal
+ * @brief   concurrent contouring of the cells of an unstructured grid
+ *
+ * vtkContourGridInternal contours the cells of an unstructured grid with
+ * vtkCell::Contour() in several threads, so that any cell type is handled:
+ * linear, quadratic, Lagrange, Bezier and polyhedral cells alike. The cells
+ * to contour are split in pieces of consecutive cells, each piece being
+ * contoured by a thread in its own points and cells with a thread-local
+ * vtkGenericCell. The points of the pieces are then merged when they are
+ * exactly coincident, like vtkMergePoints would, and the cells of the
+ * pieces are concatenated in order.
+ *
+ * When a scalar tree is given, the candidate cells of each contour value
+ * are obtained from it in batches, so that a tree built once (e.g. a
+ * vtkSpanSpace) is reused as the contour values change.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication
+ * between vtkContourGrid and vtkCutter. It does not define a public API.
+ *
+ * @sa
+ * vtkContourGrid vtkCutter vtkContour3DLinearGrid
+ */
+
+#ifndef vtkContourGridInternal_h
+#define vtkContourGridInternal_h
+
+#include "vtkAlgorithm.h"
+#include "vtkArrayDispatch.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkCutter.h"
+#include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkNonMergingPointLocator.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkScalarTree.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+// Number of candidate cells contoured by a thread at once.
+constexpr vtkIdType VTK_CONTOUR_GRID_PIECE_SIZE = 1024;
+
+// The points and cells generated by the contouring of a piece of the
+// candidate cells. The cells are the verts, lines and polys, with the input
+// cell each of them was generated from.
+struct ContourPiece
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellArray> Cells[3];
+  std::vector<vtkIdType> CellSources[3];
+  // Cells of each type kept after merging the points.
+  std::vector<vtkIdType> KeptCells[3];
+};
+
+// Objects used by a thread to contour its cells.
+struct ContourThreadData
+{
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkIdList> PointIds;
+  vtkSmartPointer<vtkDoubleArray> CellScalars;
+  vtkSmartPointer<vtkNonMergingPointLocator> Locator;
+  // The cell data are copied at the end from the input cell of each output
+  // cell: vtkCell::Contour() is given empty cell data.
+  vtkSmartPointer<vtkCellData> InCellData;
+  vtkSmartPointer<vtkCellData> OutCellData;
+};
+
+// Whether a cell generated by vtkCell::Contour() with a merging locator
+// would have been discarded, two of its points being coincident.
+inline bool IsDegenerateContourCell(int type, vtkIdType npts, const vtkIdType* pts)
+{
+  if (type == 1 && npts == 2)
+  {
+    return pts[0] == pts[1];
+  }
+  if (type == 2 && npts == 3)
+  {
+    return pts[0] == pts[1] || pts[0] == pts[2] || pts[1] == pts[2];
+  }
+  return false;
+}
+
+// Copies all the points of a piece to the points of all the pieces, from the
+// given point. The points of all the pieces are sized beforehand: the pieces
+// are copied concurrently to distinct ranges of points.
+struct CopyPiecePointsWorker
+{
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT* src, DstArrayT* dst, vtkIdType dstStart) const
+  {
+    const auto srcPts = vtk::DataArrayTupleRange<3>(src);
+    auto dstPts = vtk::DataArrayTupleRange<3>(dst, dstStart, dstStart + srcPts.size());
+    std::copy(srcPts.cbegin(), srcPts.cend(), dstPts.begin());
+  }
+};
+
+inline void CopyPiecePoints(vtkDataArray* src, vtkDataArray* dst, vtkIdType dstStart)
+{
+  CopyPiecePointsWorker worker;
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(src, dst, worker, dstStart))
+  {
+    worker(src, dst, dstStart);
+  }
+}
+
+// Copies the tuples sourceIds[i] of the input cell data to the tuples i of
+// the output cell data, concurrently when the arrays allow it.
+void CopyContourCellData(vtkCellData* in, vtkCellData* out, const std::vector<vtkIdType>& sourceIds)
+{
+  out->CopyAllocate(in, static_cast<vtkIdType>(sourceIds.size()));
+  ArrayList::CopyAttributes(in, out, sourceIds);
+}
+
+// Contours the cells of input, whose point scalars are inScalars, with the
+// given values. inPd holds the point data to interpolate, with inScalars as
+// active scalars; the generated points have the given data type. When a
+// scalar tree is given, the cells are taken from it value after value;
+// otherwise every 1D, 2D and 3D cell is contoured with all the values its
+// scalars span. The verts, lines and polys of the output are ordered as the
+// candidate cells they come from, and the output points by first use.
+// Returns false when the execution is aborted or the output cells cannot be
+// allocated, the output being left empty.
+bool ContourGridConcurrently(vtkAlgorithm* self, vtkDataSet* input, vtkDataArray* inScalars,
+  vtkPointData* inPd, vtkCellData* inCd, const double* values, vtkIdType numContours,
+  vtkScalarTree* scalarTree, bool computeScalars, int pointsType, vtkPolyData* output)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells < 1 || numContours < 1)
+  {
+    return true;
+  }
+
+  // Candidate cells. Without scalar tree, all the cells are candidates for
+  // all the contour values; with it, each candidate is given its value.
+  std::vector<vtkIdType> candidateCells;
+  std::vector<vtkIdType> candidateValues;
+  vtkIdType numCandidates = numCells;
+  if (scalarTree)
+  {
+    for (vtkIdType i = 0; i < numContours; ++i)
+    {
+      const vtkIdType numBatches = scalarTree->GetNumberOfCellBatches(values[i]);
+      for (vtkIdType batch = 0; batch < numBatches; ++batch)
+      {
+        vtkIdType numBatchCells;
+        const vtkIdType* batchCells = scalarTree->GetCellBatch(batch, numBatchCells);
+        candidateCells.insert(candidateCells.end(), batchCells, batchCells + numBatchCells);
+      }
+      candidateValues.resize(candidateCells.size(), i);
+    }
+    numCandidates = static_cast<vtkIdType>(candidateCells.size());
+  }
+
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+
+  // The dataset is accessed by several threads: the first calls must be made
+  // from a single thread.
+  double bounds[6];
+  input->GetBounds(bounds);
+  {
+    vtkNew<vtkGenericCell> cell;
+    vtkNew<vtkIdList> ptIds;
+    input->GetCellType(0);
+    input->GetCellPoints(0, ptIds);
+    input->GetCell(0, cell);
+  }
+
+  const vtkIdType numPieces =
+    (numCandidates + VTK_CONTOUR_GRID_PIECE_SIZE - 1) / VTK_CONTOUR_GRID_PIECE_SIZE;
+  std::vector<ContourPiece> pieces(numPieces);
+  vtkSMPThreadLocal<ContourThreadData> threadData;
+  std::atomic<vtkIdType> numUnknownCells(0);
+
+  vtkSMPTools::For(0, numPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    ContourThreadData& data = threadData.Local();
+    if (!data.Cell)
+    {
+      data.Cell = vtkSmartPointer<vtkGenericCell>::New();
+      data.PointIds = vtkSmartPointer<vtkIdList>::New();
+      data.CellScalars = vtkSmartPointer<vtkDoubleArray>::New();
+      data.CellScalars->SetNumberOfComponents(inScalars->GetNumberOfComponents());
+      data.Locator = vtkSmartPointer<vtkNonMergingPointLocator>::New();
+      data.InCellData = vtkSmartPointer<vtkCellData>::New();
+      data.OutCellData = vtkSmartPointer<vtkCellData>::New();
+      data.OutCellData->CopyAllocate(data.InCellData);
+    }
+    vtkGenericCell* cell = data.Cell;
+    vtkDoubleArray* cellScalars = data.CellScalars;
+
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      if (vtkSMPTools::GetSingleThread())
+      {
+        self->CheckAbort();
+      }
+      if (self->GetAbortOutput())
+      {
+        return;
+      }
+
+      const vtkIdType begin = pieceId * VTK_CONTOUR_GRID_PIECE_SIZE;
+      const vtkIdType end = std::min(begin + VTK_CONTOUR_GRID_PIECE_SIZE, numCandidates);
+      const vtkIdType estimatedSize = end - begin;
+
+      ContourPiece& piece = pieces[pieceId];
+      piece.Points = vtkSmartPointer<vtkPoints>::New();
+      piece.Points->SetDataType(pointsType);
+      piece.Points->Allocate(estimatedSize);
+      piece.PointData = vtkSmartPointer<vtkPointData>::New();
+      if (!computeScalars)
+      {
+        piece.PointData->CopyScalarsOff();
+      }
+      piece.PointData->InterpolateAllocate(inPd, estimatedSize, estimatedSize);
+      for (int type = 0; type < 3; ++type)
+      {
+        piece.Cells[type] = vtkSmartPointer<vtkCellArray>::New();
+        piece.Cells[type]->AllocateEstimate(estimatedSize, type + 1);
+      }
+      vtkCellArray* verts = piece.Cells[0];
+      vtkCellArray* lines = piece.Cells[1];
+      vtkCellArray* polys = piece.Cells[2];
+
+      // The points are merged once all the pieces are contoured.
+      data.Locator->InitPointInsertion(piece.Points, bounds, 1);
+
+      // The cells generated by a cell are given it as source.
+      auto contour = [&](vtkIdType cellId, double value) {
+        cell->Contour(value, cellScalars, data.Locator, verts, lines, polys, inPd,
+          piece.PointData, data.InCellData, cellId, data.OutCellData);
+        for (int type = 0; type < 3; ++type)
+        {
+          piece.CellSources[type].resize(piece.Cells[type]->GetNumberOfCells(), cellId);
+        }
+      };
+
+      for (vtkIdType candidate = begin; candidate < end; ++candidate)
+      {
+        if (scalarTree)
+        {
+          const vtkIdType cellId = candidateCells[candidate];
+          input->GetCell(cellId, cell);
+          input->SetCellOrderAndRationalWeights(cellId, cell);
+          cellScalars->SetNumberOfTuples(cell->GetNumberOfPoints());
+          inScalars->GetTuples(cell->GetPointIds(), cellScalars);
+          contour(cellId, values[candidateValues[candidate]]);
+          continue;
+        }
+
+        const vtkIdType cellId = candidate;
+        const int cellType = input->GetCellType(cellId);
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES)
+        { // Protect against new cell types added.
+          ++numUnknownCells;
+          continue;
+        }
+        // 0D cells cannot be cut.
+        if (cellTypeDimensions[cellType] == 0)
+        {
+          continue;
+        }
+
+        input->GetCellPoints(cellId, data.PointIds);
+        cellScalars->SetNumberOfTuples(data.PointIds->GetNumberOfIds());
+        inScalars->GetTuples(data.PointIds, cellScalars);
+        // vtkCell::Contour() contours the first component of the scalars.
+        double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+        for (const auto tuple : vtk::DataArrayTupleRange(cellScalars))
+        {
+          range[0] = std::min(range[0], tuple[0]);
+          range[1] = std::max(range[1], tuple[0]);
+        }
+
+        bool needCell = false;
+        for (vtkIdType i = 0; i < numContours && !needCell; ++i)
+        {
+          needCell = values[i] >= range[0] && values[i] <= range[1];
+        }
+        if (!needCell)
+        {
+          continue;
+        }
+
+        input->GetCell(cellId, cell);
+        input->SetCellOrderAndRationalWeights(cellId, cell);
+        for (vtkIdType i = 0; i < numContours; ++i)
+        {
+          if (values[i] >= range[0] && values[i] <= range[1])
+          {
+            contour(cellId, values[i]);
+          }
+        }
+      }
+      data.Locator->Initialize();
+    }
+  });
+
+  if (self->GetAbortOutput())
+  {
+    return false;
+  }
+  if (numUnknownCells > 0)
+  {
+    vtkWarningWithObjectMacro(
+      self, << "Skipped " << numUnknownCells.load() << " cells of unknown type");
+  }
+  self->UpdateProgress(0.6);
+
+  // Gather the points of all the pieces to merge the coincident ones.
+  std::vector<vtkIdType> pointOffsets(numPieces + 1, 0);
+  for (vtkIdType pieceId = 0; pieceId < numPieces; ++pieceId)
+  {
+    pointOffsets[pieceId + 1] =
+      pointOffsets[pieceId] + pieces[pieceId].Points->GetNumberOfPoints();
+  }
+  const vtkIdType numPiecePts = pointOffsets[numPieces];
+  if (numPiecePts == 0)
+  {
+    return true;
+  }
+  vtkNew<vtkPoints> piecePts;
+  piecePts->SetDataType(pointsType);
+  piecePts->SetNumberOfPoints(numPiecePts);
+  vtkSMPTools::For(0, numPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      CopyPiecePoints(
+        pieces[pieceId].Points->GetData(), piecePts->GetData(), pointOffsets[pieceId]);
+    }
+  });
+
+  // Each point is merged to the first point at the same location, which
+  // keeps the order of the pieces.
+  std::vector<vtkIdType> mergeMap(numPiecePts);
+  {
+    vtkNew<vtkPolyData> pointSet;
+    pointSet->SetPoints(piecePts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(pointSet);
+    locator->BuildLocator();
+    locator->MergePoints(0.0, mergeMap.data());
+  }
+  std::vector<vtkIdType> isKept(numPiecePts);
+  vtkSMPTools::For(0, numPiecePts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      isKept[ptId] = mergeMap[ptId] == ptId;
+    }
+  });
+  std::vector<vtkIdType> newPtIds(numPiecePts);
+  vtkSMPTools::ExclusiveScan(
+    isKept.begin(), isKept.end(), newPtIds.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewPts = newPtIds[numPiecePts - 1] + isKept[numPiecePts - 1];
+  vtkSMPTools::For(0, numPiecePts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      mergeMap[ptId] = newPtIds[mergeMap[ptId]];
+    }
+  });
+
+  // Output points and point data, from the kept points. The point data of
+  // all the pieces have the arrays of the output, in the same order.
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(pointsType);
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkPointData* outPd = output->GetPointData();
+  if (!computeScalars)
+  {
+    outPd->CopyScalarsOff();
+  }
+  outPd->InterpolateAllocate(inPd, numNewPts);
+  const int numArrays = outPd->GetNumberOfArrays();
+  bool parallelPointData = true;
+  for (int i = 0; i < numArrays; ++i)
+  {
+    vtkAbstractArray* array = outPd->GetAbstractArray(i);
+    array->SetNumberOfTuples(numNewPts);
+    parallelPointData &= array->GetDataType() != VTK_BIT;
+  }
+  auto copyPoints = [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      const ContourPiece& piece = pieces[pieceId];
+      const vtkIdType offset = pointOffsets[pieceId];
+      const vtkIdType numPts = piece.Points->GetNumberOfPoints();
+      for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+      {
+        if (!isKept[offset + ptId])
+        {
+          continue;
+        }
+        const vtkIdType newPtId = mergeMap[offset + ptId];
+        newPts->GetData()->SetTuple(newPtId, ptId, piece.Points->GetData());
+        for (int i = 0; i < numArrays; ++i)
+        {
+          outPd->GetAbstractArray(i)->SetTuple(
+            newPtId, ptId, piece.PointData->GetAbstractArray(i));
+        }
+      }
+    }
+  };
+  if (parallelPointData)
+  {
+    vtkSMPTools::For(0, numPieces, 1, copyPoints);
+  }
+  else
+  {
+    copyPoints(0, numPieces);
+  }
+  output->SetPoints(newPts);
+  self->UpdateProgress(0.8);
+
+  // Output cells, concatenated piece after piece, without the cells which
+  // collapse once their points are merged.
+  vtkSMPThreadLocalObject<vtkIdList> threadIds;
+  std::vector<vtkIdType> cellSources;
+  vtkSmartPointer<vtkCellArray> outCells[3];
+  for (int type = 0; type < 3; ++type)
+  {
+    vtkSMPTools::For(0, numPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+      vtkIdList* ids = threadIds.Local();
+      for (; pieceId < endPieceId; ++pieceId)
+      {
+        ContourPiece& piece = pieces[pieceId];
+        const vtkIdType offset = pointOffsets[pieceId];
+        vtkCellArray* cells = piece.Cells[type];
+        const vtkIdType numPieceCells = cells->GetNumberOfCells();
+        for (vtkIdType cellId = 0; cellId < numPieceCells; ++cellId)
+        {
+          vtkIdType npts;
+          const vtkIdType* pts;
+          cells->GetCellAtId(cellId, npts, pts, ids);
+          vtkIdType merged[3];
+          for (vtkIdType i = 0; i < npts && i < 3; ++i)
+          {
+            merged[i] = mergeMap[offset + pts[i]];
+          }
+          if (!IsDegenerateContourCell(type, npts, merged))
+          {
+            piece.KeptCells[type].push_back(cellId);
+          }
+        }
+      }
+    });
+
+    std::vector<vtkIdType> cellOffsets(numPieces + 1, 0);
+    for (vtkIdType pieceId = 0; pieceId < numPieces; ++pieceId)
+    {
+      cellOffsets[pieceId + 1] =
+        cellOffsets[pieceId] + static_cast<vtkIdType>(pieces[pieceId].KeptCells[type].size());
+    }
+    const vtkIdType numTypeCells = cellOffsets[numPieces];
+    if (numTypeCells == 0)
+    {
+      continue;
+    }
+
+    const vtkIdType sourceOffset = static_cast<vtkIdType>(cellSources.size());
+    cellSources.resize(sourceOffset + numTypeCells);
+    auto locate = [&](vtkIdType cellId, vtkIdType& pieceId) {
+      pieceId = std::upper_bound(cellOffsets.begin(), cellOffsets.end(), cellId) -
+        cellOffsets.begin() - 1;
+      return pieces[pieceId].KeptCells[type][cellId - cellOffsets[pieceId]];
+    };
+    outCells[type] = vtkSmartPointer<vtkCellArray>::New();
+    const bool built = outCells[type]->BuildCells(
+      numTypeCells,
+      [&](vtkIdType cellId) -> vtkIdType {
+        vtkIdType pieceId;
+        const vtkIdType pieceCellId = locate(cellId, pieceId);
+        return pieces[pieceId].Cells[type]->GetCellSize(pieceCellId);
+      },
+      [&](vtkIdType cellId, vtkIdType* newCellPts) {
+        vtkIdType pieceId;
+        const vtkIdType pieceCellId = locate(cellId, pieceId);
+        const ContourPiece& piece = pieces[pieceId];
+        vtkIdType npts;
+        const vtkIdType* pts;
+        piece.Cells[type]->GetCellAtId(pieceCellId, npts, pts, threadIds.Local());
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          newCellPts[i] = mergeMap[pointOffsets[pieceId] + pts[i]];
+        }
+        cellSources[sourceOffset + cellId] = piece.CellSources[type][pieceCellId];
+      });
+    if (!built)
+    {
+      vtkErrorWithObjectMacro(self, << "Unable to allocate the output cells.");
+      output->Initialize();
+      return false;
+    }
+  }
+
+  if (outCells[0])
+  {
+    output->SetVerts(outCells[0]);
+  }
+  if (outCells[1])
+  {
+    output->SetLines(outCells[1]);
+  }
+  if (outCells[2])
+  {
+    output->SetPolys(outCells[2]);
+  }
+
+  CopyContourCellData(inCd, output->GetCellData(), cellSources);
+  return true;
+}
+} // anonymous namespace
+
+#endif
+// VTK-HeaderTest-Exclude: vtkContourGridInternal.h
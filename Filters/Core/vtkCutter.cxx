@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkContourGridInternal.h"
 #include "vtkContourHelper.h"
 #include "vtkContourValues.h"
 #include "vtkDataSet.h"
@@ -65,6 +66,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction* cf)
   this->GenerateCutScalars = 0;
   this->Locator = nullptr;
   this->GenerateTriangles = 1;
+  this->SequentialProcessing = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
@@ -801,15 +803,12 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
     inPD = input->GetPointData();
   }
   outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inPD, estimatedSize, estimatedSize / 2);
-  outCD->CopyAllocate(inCD, estimatedSize, estimatedSize / 2);
 
   // locator used to merge potentially duplicate points
   if (this->Locator == nullptr)
   {
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
 
   // Loop over all points evaluating scalar function at each point
   if (inputPointSet)
@@ -818,6 +817,32 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
     this->CutFunction->FunctionValue(dataArrayInput, cutScalars);
   }
 
+  // Unless sequential processing is forced, the cells sorted by value are cut
+  // concurrently as long as the locator merges exactly coincident points and
+  // triangles are generated.
+  if (!this->SequentialProcessing && inputPointSet && this->SortBy == VTK_SORT_BY_VALUE &&
+    this->GenerateTriangles && vtkMergePoints::SafeDownCast(this->Locator))
+  {
+    ContourGridConcurrently(this, input, cutScalars, inPD, inCD, contourValues, numContours,
+      nullptr, true, newPoints->GetDataType(), output);
+    cutScalars->Delete();
+    if (this->GenerateCutScalars)
+    {
+      inPD->Delete();
+    }
+    newPoints->Delete();
+    newVerts->Delete();
+    newLines->Delete();
+    newPolys->Delete();
+    this->Locator->Initialize();
+    return;
+  }
+
+  // The concurrent path allocates the output attributes itself.
+  outPD->InterpolateAllocate(inPD, estimatedSize, estimatedSize / 2);
+  outCD->CopyAllocate(inCD, estimatedSize, estimatedSize / 2);
+  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
+
   vtkSmartPointer<vtkCellIterator> cellIter =
     vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
   vtkNew<vtkGenericCell> cell;
@@ -1081,6 +1106,7 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
   this->ContourValues->PrintSelf(os, indent.GetNextIndent());
 
   os << indent << "Generate Cut Scalars: " << (this->GenerateCutScalars ? "On\n" : "Off\n");
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
 }
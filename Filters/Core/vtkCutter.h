@@ -169,6 +169,20 @@ public:
   vtkBooleanMacro(GenerateTriangles, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the cutting of
+   * unstructured grids. On by default. When off, the cells of unstructured
+   * grids sorted by value are cut concurrently with vtkSMPTools as long as the
+   * locator is a vtkMergePoints (the default) and GenerateTriangles is on. The
+   * output then has the same cells, in the same order, as the sequential one,
+   * but its points are numbered differently.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Specify a spatial locator for merging points. By default,
@@ -239,6 +253,7 @@ protected:
   void RectilinearGridCutter(vtkDataSet*, vtkPolyData*);
   vtkImplicitFunction* CutFunction;
   vtkTypeBool GenerateTriangles;
+  vtkTypeBool SequentialProcessing;
 
   vtkSynchronizedTemplates3D* SynchronizedTemplates3D;
   vtkSynchronizedTemplatesCutter3D* SynchronizedTemplatesCutter3D;
@@ -25,10 +25,16 @@
 #include "vtkPointData.h"
 #include "vtkPointLocator.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkTetra.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkDelaunay3D);
 
 //------------------------------------------------------------------------------
@@ -124,6 +130,471 @@ vtkDelaunayTetra* vtkTetraArray::Resize(vtkIdType sz)
 // vtkDelaunay3D methods
 //
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Index of a point along a 3D Hilbert curve, from its coordinates quantized
+// on the given number of bits (Skilling, "Programming the Hilbert curve").
+uint64_t HilbertIndex(unsigned int x[3], int bits)
+{
+  const unsigned int m = 1U << (bits - 1);
+  for (unsigned int q = m; q > 1; q >>= 1)
+  {
+    const unsigned int p = q - 1;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (x[i] & q)
+      {
+        x[0] ^= p;
+      }
+      else
+      {
+        const unsigned int t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  x[1] ^= x[0];
+  x[2] ^= x[1];
+  unsigned int t = 0;
+  for (unsigned int q = m; q > 1; q >>= 1)
+  {
+    if (x[2] & q)
+    {
+      t ^= q - 1;
+    }
+  }
+  uint64_t index = 0;
+  for (int b = bits - 1; b >= 0; --b)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      index = (index << 1) | (((x[i] ^ t) >> b) & 1U);
+    }
+  }
+  return index;
+}
+
+//------------------------------------------------------------------------------
+// Biased randomized insertion order: each point goes to the last round with
+// probability 1/2, to the round before with probability 1/4 and so on, and
+// the points of a round are sorted along a Hilbert curve. The "random"
+// rounds are derived from the point ids, so the order is reproducible.
+std::vector<vtkIdType> SpatialOrder(const double* coords, vtkIdType numPts)
+{
+  constexpr int bits = 19;
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      bounds[2 * i] = std::min(bounds[2 * i], coords[3 * ptId + i]);
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], coords[3 * ptId + i]);
+    }
+  }
+  const double length =
+    std::max({ bounds[1] - bounds[0], bounds[3] - bounds[2], bounds[5] - bounds[4] });
+  const double scale = length > 0.0 ? ((1U << bits) - 1) / length : 0.0;
+
+  // The first round has about 64 points.
+  int numRounds = 1;
+  while (numRounds < 32 && (numPts >> (numRounds + 6)) > 0)
+  {
+    ++numRounds;
+  }
+
+  std::vector<std::pair<uint64_t, vtkIdType>> keys(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      // splitmix64 hash of the point id.
+      uint64_t hash = static_cast<uint64_t>(ptId) + 0x9e3779b97f4a7c15ULL;
+      hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+      hash ^= hash >> 31;
+      int round = numRounds - 1;
+      while (round > 0 && (hash & 1U))
+      {
+        --round;
+        hash >>= 1;
+      }
+
+      unsigned int x[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        x[i] = static_cast<unsigned int>((coords[3 * ptId + i] - bounds[2 * i]) * scale);
+      }
+      keys[ptId] = std::make_pair(
+        (static_cast<uint64_t>(round) << (3 * bits)) | HilbertIndex(x, bits), ptId);
+    }
+  });
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+
+  std::vector<vtkIdType> order(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      order[i] = keys[i].second;
+    }
+  });
+  return order;
+}
+
+//------------------------------------------------------------------------------
+// Tetrahedralization stored as arrays of point ids and face neighbors, the
+// face j of a tetrahedron being opposite to its point j. Points are inserted
+// with the Bowyer-Watson algorithm: the tetrahedra whose circumsphere
+// contains the point are replaced by tetrahedra joining the point to the
+// faces of the cavity. New tetrahedra copy the point order of the tetrahedra
+// they replace, so that they all keep the orientation of the initial ones.
+class TetraMesh
+{
+public:
+  enum InsertionStatus
+  {
+    Inserted,
+    Duplicate,
+    Degenerate
+  };
+
+  TetraMesh(std::vector<double>& coords, double tolerance)
+    : Coords(coords)
+    , Tolerance2(tolerance * tolerance)
+  {
+  }
+
+  vtkIdType GetNumberOfTetras() const
+  {
+    return static_cast<vtkIdType>(this->Points.size() / 4);
+  }
+  bool IsDeleted(vtkIdType tetra) const { return this->Points[4 * tetra] < 0; }
+  const vtkIdType* GetPoints(vtkIdType tetra) const { return &this->Points[4 * tetra]; }
+  double* GetSphere(vtkIdType tetra) { return &this->Spheres[4 * tetra]; }
+
+  // Set the initial tetrahedra, which must enclose all the points.
+  void Initialize(const vtkIdType (*tetras)[4], int numTetras)
+  {
+    for (int t = 0; t < numTetras; ++t)
+    {
+      std::copy(tetras[t], tetras[t] + 4, &this->Points[4 * this->NewTetra()]);
+      this->ComputeSphere(t);
+    }
+    // Match the faces, which share their three points.
+    for (int t = 0; t < numTetras; ++t)
+    {
+      for (int j = 0; j < 4; ++j)
+      {
+        for (int u = 0; u < numTetras; ++u)
+        {
+          int numShared = 0;
+          for (int i = 0; i < 4; ++i)
+          {
+            numShared += i != j && std::count(tetras[u], tetras[u] + 4, tetras[t][i]) > 0;
+          }
+          if (u != t && numShared == 3)
+          {
+            this->Neighbors[4 * t + j] = u;
+          }
+        }
+      }
+    }
+    this->LastTetra = 0;
+    this->Orientation = this->SignedVolume(tetras[0]) > 0.0 ? 1.0 : -1.0;
+  }
+
+  InsertionStatus InsertPoint(vtkIdType ptId)
+  {
+    double x[3] = { this->Coords[3 * ptId], this->Coords[3 * ptId + 1],
+      this->Coords[3 * ptId + 2] };
+    const vtkIdType start = this->Locate(x);
+    if (start < 0)
+    {
+      return Degenerate;
+    }
+
+    // Gather the cavity, and its faces with the tetrahedra beyond them.
+    this->Stamp += 2;
+    const vtkIdType outside = this->Stamp;
+    const vtkIdType inside = this->Stamp + 1;
+    this->Cavity.clear();
+    this->Faces.clear();
+    this->Cavity.push_back(start);
+    this->Marks[start] = inside;
+    for (size_t c = 0; c < this->Cavity.size(); ++c)
+    {
+      const vtkIdType tetra = this->Cavity[c];
+      for (int j = 0; j < 4; ++j)
+      {
+        const vtkIdType nei = this->Neighbors[4 * tetra + j];
+        if (nei >= 0 && this->Marks[nei] == inside)
+        {
+          continue;
+        }
+        if (nei >= 0 && this->Marks[nei] != outside)
+        {
+          if (this->InSphere(nei, x))
+          {
+            this->Marks[nei] = inside;
+            this->Cavity.push_back(nei);
+            continue;
+          }
+          this->Marks[nei] = outside;
+        }
+        CavityFace face;
+        face.Index = j;
+        face.Neighbor = nei;
+        face.NeighborIndex = -1;
+        std::copy(this->GetPoints(tetra), this->GetPoints(tetra) + 4, face.Points);
+        if (nei >= 0)
+        {
+          const vtkIdType* neighbors = &this->Neighbors[4 * nei];
+          face.NeighborIndex =
+            static_cast<int>(std::find(neighbors, neighbors + 4, tetra) - neighbors);
+        }
+        this->Faces.push_back(face);
+      }
+    }
+
+    // The closest point is a point of the cavity.
+    for (vtkIdType tetra : this->Cavity)
+    {
+      for (int j = 0; j < 4; ++j)
+      {
+        const double* y = &this->Coords[3 * this->Points[4 * tetra + j]];
+        if (vtkMath::Distance2BetweenPoints(x, y) <= this->Tolerance2)
+        {
+          return Duplicate;
+        }
+      }
+    }
+
+    // Check that the point sees each face of the cavity from its inner side,
+    // and that the faces form a closed surface, each edge being shared by
+    // exactly two faces. Rounding errors of the circumsphere tests may break
+    // both in degenerate cases, where the point is skipped, the mesh being
+    // left untouched.
+    this->Edges.clear();
+    for (size_t f = 0; f < this->Faces.size(); ++f)
+    {
+      CavityFace& face = this->Faces[f];
+      vtkIdType* pts = face.Points;
+      const vtkIdType facePtId = pts[face.Index];
+      pts[face.Index] = ptId;
+      const bool oriented = this->Orientation * this->SignedVolume(pts) > 0.0;
+      pts[face.Index] = facePtId;
+      if (!oriented)
+      {
+        return Degenerate;
+      }
+
+      // The face j of the new tetrahedron is shared with the new tetrahedron
+      // of the cavity face around the edge (a, b) of the face.
+      for (int j = 0; j < 4; ++j)
+      {
+        if (j != face.Index)
+        {
+          const int a = (j + 1) % 4 == face.Index ? (j + 2) % 4 : (j + 1) % 4;
+          const int b = 6 - j - face.Index - a;
+          this->Edges.push_back(CavityEdge{ std::min(pts[a], pts[b]), std::max(pts[a], pts[b]),
+            static_cast<vtkIdType>(f), j });
+        }
+      }
+    }
+    std::sort(this->Edges.begin(), this->Edges.end());
+    for (size_t e = 0; e < this->Edges.size(); e += 2)
+    {
+      if (e + 1 == this->Edges.size() || this->Edges[e] < this->Edges[e + 1] ||
+        (e + 2 < this->Edges.size() && !(this->Edges[e + 1] < this->Edges[e + 2])))
+      {
+        return Degenerate;
+      }
+    }
+
+    // Join the point to the faces, reusing the ids of the cavity tetrahedra.
+    this->NewTetras.resize(this->Faces.size());
+    for (size_t f = 0; f < this->Faces.size(); ++f)
+    {
+      const CavityFace& face = this->Faces[f];
+      vtkIdType tetra;
+      if (f < this->Cavity.size())
+      {
+        tetra = this->Cavity[f];
+      }
+      else if (!this->FreeTetras.empty())
+      {
+        tetra = this->FreeTetras.back();
+        this->FreeTetras.pop_back();
+      }
+      else
+      {
+        tetra = this->NewTetra();
+      }
+      this->NewTetras[f] = tetra;
+      vtkIdType* pts = &this->Points[4 * tetra];
+      std::copy(face.Points, face.Points + 4, pts);
+      pts[face.Index] = ptId;
+      this->Neighbors[4 * tetra + face.Index] = face.Neighbor;
+      if (face.Neighbor >= 0)
+      {
+        this->Neighbors[4 * face.Neighbor + face.NeighborIndex] = tetra;
+      }
+      this->ComputeSphere(tetra);
+    }
+    for (size_t c = this->Faces.size(); c < this->Cavity.size(); ++c)
+    {
+      this->Points[4 * this->Cavity[c]] = -1;
+      this->FreeTetras.push_back(this->Cavity[c]);
+    }
+    for (size_t e = 0; e < this->Edges.size(); e += 2)
+    {
+      const CavityEdge& e0 = this->Edges[e];
+      const CavityEdge& e1 = this->Edges[e + 1];
+      const vtkIdType tetra0 = this->NewTetras[e0.Face];
+      const vtkIdType tetra1 = this->NewTetras[e1.Face];
+      this->Neighbors[4 * tetra0 + e0.Index] = tetra1;
+      this->Neighbors[4 * tetra1 + e1.Index] = tetra0;
+    }
+    this->LastTetra = this->Cavity[0];
+    return Inserted;
+  }
+
+private:
+  struct CavityFace
+  {
+    int Index;
+    vtkIdType Neighbor;
+    int NeighborIndex;
+    vtkIdType Points[4];
+  };
+
+  struct CavityEdge
+  {
+    vtkIdType A;
+    vtkIdType B;
+    // The cavity face, and the face of its new tetrahedron sharing the edge.
+    vtkIdType Face;
+    int Index;
+
+    bool operator<(const CavityEdge& other) const
+    {
+      return this->A < other.A || (this->A == other.A && this->B < other.B);
+    }
+  };
+
+  vtkIdType NewTetra()
+  {
+    const vtkIdType tetra = this->GetNumberOfTetras();
+    this->Points.resize(this->Points.size() + 4, -1);
+    this->Neighbors.resize(this->Neighbors.size() + 4, -1);
+    this->Spheres.resize(this->Spheres.size() + 4, 0.0);
+    this->Marks.push_back(0);
+    return tetra;
+  }
+
+  void ComputeSphere(vtkIdType tetra)
+  {
+    const vtkIdType* pts = this->GetPoints(tetra);
+    double* sphere = this->GetSphere(tetra);
+    sphere[3] = vtkTetra::Circumsphere(&this->Coords[3 * pts[0]], &this->Coords[3 * pts[1]],
+      &this->Coords[3 * pts[2]], &this->Coords[3 * pts[3]], sphere);
+  }
+
+  // Six times the signed volume of a tetrahedron.
+  double SignedVolume(const vtkIdType pts[4]) const
+  {
+    const double* x0 = &this->Coords[3 * pts[0]];
+    double v[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+      vtkMath::Subtract(&this->Coords[3 * pts[i + 1]], x0, v[i]);
+    }
+    return vtkMath::Determinant3x3(v[0], v[1], v[2]);
+  }
+
+  // Same criterion as vtkDelaunay3D::InSphere().
+  bool InSphere(vtkIdType tetra, const double x[3]) const
+  {
+    const double* sphere = &this->Spheres[4 * tetra];
+    return vtkMath::Distance2BetweenPoints(x, sphere) < 0.9999999999L * sphere[3];
+  }
+
+  // Walk toward the point from the last tetrahedra created. Tetrahedra the
+  // point is in up to rounding errors are accepted, the cavity search
+  // handles them.
+  vtkIdType Locate(double x[3])
+  {
+    const vtkIdType maxSteps = 10000;
+    double p[4][3], b[4];
+    vtkIdType tetra = this->LastTetra;
+    for (vtkIdType step = 0; step < maxSteps && tetra >= 0; ++step)
+    {
+      const vtkIdType* pts = this->GetPoints(tetra);
+      for (int j = 0; j < 4; ++j)
+      {
+        std::copy_n(&this->Coords[3 * pts[j]], 3, p[j]);
+      }
+      vtkTetra::BarycentricCoords(x, p[0], p[1], p[2], p[3], b);
+      int neg = -1;
+      double negValue = -1.0e-12;
+      for (int j = 0; j < 4; ++j)
+      {
+        if (b[j] < negValue)
+        {
+          negValue = b[j];
+          neg = j;
+        }
+      }
+      if (neg < 0)
+      {
+        return tetra;
+      }
+      tetra = this->Neighbors[4 * tetra + neg];
+    }
+
+    // The walk did not end, which may only happen in degenerate cases.
+    for (tetra = 0; tetra < this->GetNumberOfTetras(); ++tetra)
+    {
+      if (!this->IsDeleted(tetra))
+      {
+        const vtkIdType* pts = this->GetPoints(tetra);
+        for (int j = 0; j < 4; ++j)
+        {
+          std::copy_n(&this->Coords[3 * pts[j]], 3, p[j]);
+        }
+        vtkTetra::BarycentricCoords(x, p[0], p[1], p[2], p[3], b);
+        if (b[0] >= 0.0 && b[1] >= 0.0 && b[2] >= 0.0 && b[3] >= 0.0)
+        {
+          return tetra;
+        }
+      }
+    }
+    return -1;
+  }
+
+  std::vector<double>& Coords;
+  double Tolerance2;
+  std::vector<vtkIdType> Points;
+  std::vector<vtkIdType> Neighbors;
+  // Circumcenter and squared circumradius.
+  std::vector<double> Spheres;
+  // Search marks of the tetrahedra, compared to Stamp.
+  std::vector<vtkIdType> Marks;
+  std::vector<vtkIdType> FreeTetras;
+  vtkIdType LastTetra = 0;
+  vtkIdType Stamp = 0;
+  // The sign of the volume of all the tetrahedra.
+  double Orientation = 1.0;
+
+  // Work arrays of InsertPoint().
+  std::vector<vtkIdType> Cavity;
+  std::vector<CavityFace> Faces;
+  std::vector<CavityEdge> Edges;
+  std::vector<vtkIdType> NewTetras;
+};
+}
+
 //------------------------------------------------------------------------------
 // Construct object with Alpha = 0.0; Tolerance = 0.001; Offset = 2.5;
 // BoundingTriangulation turned off.
@@ -138,6 +609,7 @@ vtkDelaunay3D::vtkDelaunay3D()
   this->BoundingTriangulation = 0;
   this->Offset = 2.5;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->SpatialSorting = 0;
   this->Locator = nullptr;
   this->TetraArray = nullptr;
 
@@ -484,31 +956,38 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   points->Allocate(numPoints + 6);
 
-  Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
-
-  // Insert each point into triangulation. Points laying "inside"
-  // of tetra cause tetra to be deleted, leaving a void with bounding
-  // faces. Combination of point and each face is used to form new
-  // tetrahedra.
-  for (ptId = 0; ptId < numPoints; ptId++)
+  if (this->SpatialSorting)
   {
-    inPoints->GetPoint(ptId, x);
-
-    this->InsertPoint(Mesh, points, ptId, x, holeTetras);
+    Mesh = this->InsertPointsSpatiallySorted(inPoints, center, this->Offset * tol, points);
+  }
+  else
+  {
+    Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
 
-    if (!(ptId % 250))
+    // Insert each point into triangulation. Points laying "inside"
+    // of tetra cause tetra to be deleted, leaving a void with bounding
+    // faces. Combination of point and each face is used to form new
+    // tetrahedra.
+    for (ptId = 0; ptId < numPoints; ptId++)
     {
-      vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
-      if (this->GetAbortExecute())
+      inPoints->GetPoint(ptId, x);
+
+      this->InsertPoint(Mesh, points, ptId, x, holeTetras);
+
+      if (!(ptId % 250))
       {
-        break;
+        vtkDebugMacro(<< "point #" << ptId);
+        this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
       }
-    }
 
-  } // for all points
+    } // for all points
 
-  this->EndPointInsertion();
+    this->EndPointInsertion();
+  }
 
   vtkDebugMacro(<< "Triangulated " << numPoints << " points, " << this->NumberOfDuplicatePoints
                 << " of which were duplicates");
@@ -1038,6 +1517,96 @@ void vtkDelaunay3D::InsertTetra(vtkUnstructuredGrid* Mesh, vtkPoints* points, vt
   this->TetraArray->InsertTetra(tetraId, radius2, center);
 }
 
+//------------------------------------------------------------------------------
+vtkUnstructuredGrid* vtkDelaunay3D::InsertPointsSpatiallySorted(
+  vtkPoints* inPoints, double center[3], double length, vtkPoints* points)
+{
+  this->NumberOfDuplicatePoints = 0;
+  this->NumberOfDegeneracies = 0;
+  if (length <= 0.0)
+  {
+    length = 1.0;
+  }
+  if (this->Locator == nullptr)
+  {
+    this->CreateDefaultLocator();
+  }
+
+  // The points to insert, followed by the points of the bounding octahedron.
+  const vtkIdType numPts = inPoints->GetNumberOfPoints();
+  std::vector<double> coords(3 * (numPts + 6));
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      inPoints->GetPoint(ptId, &coords[3 * ptId]);
+    }
+  });
+  for (int i = 0; i < 6; ++i)
+  {
+    double* x = &coords[3 * (numPts + i)];
+    std::copy_n(center, 3, x);
+    x[i / 2] += i % 2 ? length : -length;
+  }
+
+  TetraMesh mesh(coords, this->Locator->GetTolerance());
+  const vtkIdType n = numPts;
+  const vtkIdType initialTetras[4][4] = { { n + 4, n + 5, n, n + 2 },
+    { n + 4, n + 5, n + 2, n + 1 }, { n + 4, n + 5, n + 1, n + 3 },
+    { n + 4, n + 5, n + 3, n } };
+  mesh.Initialize(initialTetras, 4);
+
+  const std::vector<vtkIdType> order = SpatialOrder(coords.data(), numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    switch (mesh.InsertPoint(order[i]))
+    {
+      case TetraMesh::Duplicate:
+        this->NumberOfDuplicatePoints++;
+        break;
+      case TetraMesh::Degenerate:
+        this->NumberOfDegeneracies++;
+        break;
+      default:
+        break;
+    }
+    if (!(i % 10000))
+    {
+      vtkDebugMacro(<< "point #" << i);
+      this->UpdateProgress(static_cast<double>(i) / numPts);
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+    }
+  }
+
+  // The mesh as InitPointInsertion() and InsertPoint() build it.
+  points->SetNumberOfPoints(numPts + 6);
+  for (vtkIdType ptId = 0; ptId < numPts + 6; ++ptId)
+  {
+    points->SetPoint(ptId, &coords[3 * ptId]);
+  }
+  vtkUnstructuredGrid* Mesh = vtkUnstructuredGrid::New();
+  Mesh->EditableOn();
+  Mesh->Allocate(mesh.GetNumberOfTetras());
+  delete this->TetraArray;
+  this->TetraArray = new vtkTetraArray(mesh.GetNumberOfTetras(), numPts);
+  for (vtkIdType tetra = 0; tetra < mesh.GetNumberOfTetras(); ++tetra)
+  {
+    if (!mesh.IsDeleted(tetra))
+    {
+      const vtkIdType tetraId = Mesh->InsertNextCell(VTK_TETRA, 4, mesh.GetPoints(tetra));
+      double* sphere = mesh.GetSphere(tetra);
+      this->TetraArray->InsertTetra(tetraId, sphere[3], sphere);
+    }
+  }
+  Mesh->SetPoints(points);
+  points->Delete();
+  Mesh->BuildLinks();
+
+  return Mesh;
+}
+
 //------------------------------------------------------------------------------
 void vtkDelaunay3D::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -1062,6 +1631,7 @@ void vtkDelaunay3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Spatial Sorting: " << (this->SpatialSorting ? "On\n" : "Off\n");
 }
 
 //------------------------------------------------------------------------------
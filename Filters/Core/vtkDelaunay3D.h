@@ -87,6 +87,11 @@
  * will be found. However, in degenerate cases an enclosing tetrahedron may
  * not be found and the point will be rejected.
  *
+ * @warning
+ * With SpatialSorting on, the points are instead inserted in a spatially
+ * coherent order, each enclosing tetrahedron being found by a walk from the
+ * last tetrahedra created. See SpatialSorting.
+ *
  * @sa
  * vtkDelaunay2D vtkGaussianSplatter vtkUnstructuredGrid
  */
@@ -197,6 +202,29 @@ public:
   vtkBooleanMacro(BoundingTriangulation, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Boolean controls whether the points are inserted in a spatially sorted
+   * order. If on, the insertion order is a biased randomized insertion order
+   * (BRIO): the points are split in rounds of doubling size, and sorted along
+   * a Hilbert curve within each round. The tetrahedra are kept in a compact
+   * structure storing their face neighbors, and each point is located by a
+   * walk from the tetrahedra created last, which is short thanks to the
+   * sorting. This is much faster on large or clustered point sets. Points
+   * closer than the tolerance of the Locator to a point already inserted are
+   * discarded, as in the default mode. Points whose cavity is not a closed
+   * surface seen from the point, because of rounding errors in degenerate
+   * cases, are rejected and leave the mesh unchanged. The order only depends
+   * on the points, so the output is deterministic, but it is a different
+   * insertion order: the triangulation may differ from the one of the points
+   * in input order wherever the Delaunay triangulation is not unique, e.g.
+   * for cospherical points. By default, SpatialSorting is off.
+   */
+  vtkSetMacro(SpatialSorting, vtkTypeBool);
+  vtkGetMacro(SpatialSorting, vtkTypeBool);
+  vtkBooleanMacro(SpatialSorting, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set / get a spatial locator for merging points. By default,
@@ -278,6 +306,7 @@ protected:
   vtkTypeBool BoundingTriangulation;
   double Offset;
   int OutputPointsPrecision;
+  vtkTypeBool SpatialSorting;
 
   vtkIncrementalPointLocator* Locator; // help locate points faster
 
@@ -295,6 +324,14 @@ protected:
   vtkIdType FindEnclosingFaces(double x[3], vtkUnstructuredGrid* Mesh, vtkIdList* tetras,
     vtkIdList* faces, vtkIncrementalPointLocator* Locator);
 
+  /**
+   * Triangulate the points in a spatially sorted order (see SpatialSorting),
+   * and return the mesh as InitPointInsertion() and InsertPoint() would.
+   * The mesh has no deleted tetrahedra and must be deleted by the caller.
+   */
+  vtkUnstructuredGrid* InsertPointsSpatiallySorted(
+    vtkPoints* inPoints, double center[3], double length, vtkPoints* points);
+
   int FillInputPortInformation(int, vtkInformation*) override;
 
 private:                    // members added for performance
@@ -14,18 +14,25 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +40,9 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -63,6 +73,8 @@ vtkGlyph3D::vtkGlyph3D()
   this->SetPointIdsName("InputPointIds");
   this->SetNumberOfInputPorts(2);
   this->FillCellData = 0;
+  this->OutputInstances = 0;
+  this->SequentialProcessing = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 
@@ -119,6 +131,178 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   return this->Execute(input, sourceVector, output, inSScalars, inVectors);
 }
 
+namespace
+{
+
+// Copies the tuples sourceIds[i] of the input attributes to the tuples i of
+// the output attributes, which must have been allocated with CopyAllocate().
+void CopyAttributes(vtkDataSetAttributes* in, vtkDataSetAttributes* out,
+  const std::vector<vtkIdType>& sourceIds, bool sequential)
+{
+  if (!sequential)
+  {
+    ArrayList::CopyAttributes(in, out, sourceIds);
+    return;
+  }
+  for (vtkIdType id = 0; id < static_cast<vtkIdType>(sourceIds.size()); ++id)
+  {
+    out->CopyData(in, sourceIds[id], id);
+  }
+}
+
+// Copies the tuples sourceIds[i] of the input array to the tuples i of the
+// output array, an instance of the same class.
+void CopyTuples(
+  vtkDataArray* in, vtkDataArray* out, const std::vector<vtkIdType>& sourceIds, bool sequential)
+{
+  const vtkIdType numIds = static_cast<vtkIdType>(sourceIds.size());
+  out->SetNumberOfTuples(numIds);
+  auto copyTuples = [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType id = begin; id < end; ++id)
+    {
+      out->SetTuple(id, sourceIds[id], in);
+    }
+  };
+  // Neighboring bits cannot be written concurrently.
+  if (sequential || in->GetDataType() == VTK_BIT)
+  {
+    copyTuples(0, numIds);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numIds, copyTuples);
+  }
+}
+
+// Builds the cells from their sizes and point ids, concurrently unless
+// sequential. Returns false if the cells cannot be allocated.
+template <typename SizeFunctor, typename PointsFunctor>
+bool BuildCells(vtkCellArray* cells, vtkIdType numCells, SizeFunctor&& cellSize,
+  PointsFunctor&& cellPoints, bool sequential)
+{
+  if (sequential)
+  {
+    std::vector<vtkIdType> pts;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      pts.resize(cellSize(cellId));
+      cellPoints(cellId, pts.data());
+      cells->InsertNextCell(static_cast<vtkIdType>(pts.size()), pts.data());
+    }
+    return true;
+  }
+  return cells->BuildCells(numCells, cellSize, cellPoints);
+}
+
+// An entry of the table of glyphs, prepared before the glyphs are copied.
+struct GlyphSource
+{
+  vtkPolyData* Source = nullptr;
+  vtkSmartPointer<vtkPoints> Points;
+  vtkDataArray* Normals = nullptr;
+  vtkCellArray* Cells[4] = { nullptr, nullptr, nullptr, nullptr };
+
+  // The points are transformed by the source transform once for all glyphs.
+  void Initialize(vtkPolyData* source, vtkTransform* sourceTransform)
+  {
+    this->Source = source;
+    this->Points = source->GetPoints();
+    if (this->Points && sourceTransform)
+    {
+      this->Points = vtkSmartPointer<vtkPoints>::New();
+      this->Points->SetDataTypeToDouble();
+      this->Points->Allocate(source->GetNumberOfPoints());
+      sourceTransform->TransformPoints(source->GetPoints(), this->Points);
+    }
+    this->Normals = source->GetPointData()->GetNormals();
+    this->Cells[0] = source->GetVerts();
+    this->Cells[1] = source->GetLines();
+    this->Cells[2] = source->GetPolys();
+    this->Cells[3] = source->GetStrips();
+  }
+
+  vtkIdType GetNumberOfPoints() const
+  {
+    return this->Points ? this->Points->GetNumberOfPoints() : 0;
+  }
+
+  vtkIdType GetNumberOfCells(int type) const
+  {
+    return this->Points ? this->Cells[type]->GetNumberOfCells() : 0;
+  }
+};
+
+// The orientation, scale and source of the glyph of an input point.
+struct GlyphParameters
+{
+  double Vector[3];
+  double Magnitude;
+  double Scale[3];
+  int SourceIndex;
+};
+
+// Applies the matrix to a point the way vtkLinearTransform::TransformPoints()
+// does, so that the glyphs do not depend on the number of threads.
+template <typename T>
+void TransformPoint(const double matrix[4][4], const double in[3], T* out)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    out[i] = static_cast<T>(
+      matrix[i][0] * in[0] + matrix[i][1] * in[1] + matrix[i][2] * in[2] + matrix[i][3]);
+  }
+}
+
+// Applies the matrix to the points of a glyph, written from outId onwards.
+void TransformPoints(const double matrix[4][4], vtkPoints* in, vtkPoints* out, vtkIdType outId)
+{
+  const vtkIdType numPts = in->GetNumberOfPoints();
+  float* outFloat = out->GetDataType() == VTK_FLOAT
+    ? static_cast<float*>(out->GetVoidPointer(3 * outId))
+    : nullptr;
+  double* outDouble =
+    outFloat ? nullptr : static_cast<double*>(out->GetVoidPointer(3 * outId));
+  double x[3];
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    in->GetPoint(i, x);
+    if (outFloat)
+    {
+      TransformPoint(matrix, x, outFloat + 3 * i);
+    }
+    else
+    {
+      TransformPoint(matrix, x, outDouble + 3 * i);
+    }
+  }
+}
+
+// Applies the transposed inverse of the matrix to the normals of a glyph,
+// as vtkLinearTransform::TransformNormals() does.
+void TransformNormals(const double matrix[4][4], vtkDataArray* in, vtkFloatArray* out,
+  vtkIdType outId, vtkIdType numPts)
+{
+  double normalMatrix[4][4];
+  vtkMatrix4x4::DeepCopy(*normalMatrix, *matrix);
+  vtkMatrix4x4::Invert(*normalMatrix, *normalMatrix);
+  vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+  const vtkIdType numNormals = std::min(in->GetNumberOfTuples(), numPts);
+  float* normal = out->GetPointer(3 * outId);
+  double n[3];
+  for (vtkIdType i = 0; i < numNormals; ++i, normal += 3)
+  {
+    in->GetTuple(i, n);
+    for (int j = 0; j < 3; ++j)
+    {
+      normal[j] = static_cast<float>(
+        normalMatrix[j][0] * n[0] + normalMatrix[j][1] * n[1] + normalMatrix[j][2] * n[2]);
+    }
+    vtkMath::Normalize(normal);
+  }
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector, vtkPolyData* output,
   vtkDataArray* inSScalars, vtkDataArray* inVectors)
@@ -136,40 +320,28 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   vtkPointData* pd;
   vtkDataArray* inCScalars; // Scalars for Coloring
   unsigned char* inGhostLevels = nullptr;
-  vtkDataArray *inNormals, *sourceNormals = nullptr;
+  vtkDataArray* inNormals;
   vtkDataArray* sourceTCoords = nullptr;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  vtkPoints* sourcePts = nullptr;
-  vtkSmartPointer<vtkPoints> transformedSourcePts = vtkSmartPointer<vtkPoints>::New();
+  vtkDataArray* array3D = nullptr;
+  vtkIdType numPts, inPtId;
   vtkPoints* newPts;
   vtkDataArray* newScalars = nullptr;
-  vtkDataArray* newVectors = nullptr;
-  vtkDataArray* newNormals = nullptr;
-  vtkDataArray* newTCoords = nullptr;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
-  vtkTransform* trans = vtkTransform::New();
-  vtkNew<vtkIdList> pointIdList;
-  vtkIdList* cellPts;
-  int npts;
-  vtkIdList* pts;
-  vtkIdType ptIncr, cellIncr, cellId;
+  vtkFloatArray* newVectors = nullptr;
+  vtkFloatArray* newNormals = nullptr;
+  vtkFloatArray* newTCoords = nullptr;
+  vtkDoubleArray* newTransforms = nullptr;
+  vtkIntArray* newSourceIndices = nullptr;
   int haveVectors, haveNormals, haveTCoords = 0;
-  double scalex, scaley, scalez, den;
+  double den;
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   int numberOfSources = this->GetNumberOfInputConnections(1);
   vtkIdTypeArray* pointIds = nullptr;
   vtkSmartPointer<vtkPolyData> source = this->GetSource(0, sourceVector);
-  vtkNew<vtkIdList> srcPointIdList;
-  vtkNew<vtkIdList> dstPointIdList;
-  vtkNew<vtkIdList> srcCellIdList;
-  vtkNew<vtkIdList> dstCellIdList;
+  const bool outputInstances = this->OutputInstances != 0;
 
   vtkDebugMacro(<< "Generating glyphs");
 
-  pts = vtkIdList::New();
-  pts->Allocate(VTK_CELL_SIZE);
-
   pd = input->GetPointData();
   inNormals = this->GetInputArrayToProcess(2, input);
   inCScalars = this->GetInputArrayToProcess(3, input);
@@ -196,8 +368,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   if (numPts < 1)
   {
     vtkDebugMacro(<< "No points to glyph!");
-    pts->Delete();
-    trans->Delete();
     return true;
   }
 
@@ -219,6 +389,16 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     haveVectors = 0;
   }
 
+  if (haveVectors && this->VectorMode != VTK_FOLLOW_CAMERA_DIRECTION)
+  {
+    array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+    if (array3D->GetNumberOfComponents() > 3)
+    {
+      vtkErrorMacro(<< "vtkDataArray " << array3D->GetName() << " has more than 3 components.\n");
+      return false;
+    }
+  }
+
   if ((this->IndexMode == VTK_INDEXING_BY_SCALAR && !inSScalars) ||
     (this->IndexMode == VTK_INDEXING_BY_VECTOR &&
       ((!inVectors && this->VectorMode == VTK_USE_VECTOR) ||
@@ -227,8 +407,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     if (source == nullptr)
     {
       vtkErrorMacro(<< "Indexing on but don't have data to index with");
-      pts->Delete();
-      trans->Delete();
       return true;
     }
     else
@@ -260,71 +438,279 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     source = defaultSource;
   }
 
+  // Prepare the table of glyphs.
+  std::vector<GlyphSource> sources;
   if (this->IndexMode != VTK_INDEXING_OFF)
   {
     pd = nullptr;
     haveNormals = 1;
-    for (numSourcePts = numSourceCells = i = 0; i < numberOfSources; i++)
+    sources.resize(numberOfSources);
+    for (int i = 0; i < numberOfSources; i++)
     {
       source = this->GetSource(i, sourceVector);
       if (source != nullptr)
       {
-        if (source->GetNumberOfPoints() > numSourcePts)
+        sources[i].Initialize(source, this->SourceTransform);
+        if (!sources[i].Normals)
+        {
+          haveNormals = 0;
+        }
+      }
+    }
+  }
+  else
+  {
+    sources.resize(1);
+    sources[0].Initialize(source, this->SourceTransform);
+    haveNormals = sources[0].Normals ? 1 : 0;
+    sourceTCoords = source->GetPointData()->GetTCoords();
+    haveTCoords = sourceTCoords ? 1 : 0;
+    pd = input->GetPointData();
+  }
+  if (outputInstances)
+  {
+    // The instances refer to the normals and texture coordinates of the
+    // sources, which are left untouched.
+    haveNormals = haveTCoords = 0;
+  }
+
+  // Computes the orientation, the scale and the source of the glyph of an
+  // input point.
+  auto computeGlyph = [&](vtkIdType ptId, GlyphParameters& glyph) {
+    double s = 0.0;
+    glyph.Vector[0] = glyph.Vector[1] = glyph.Vector[2] = 0.0;
+    glyph.Magnitude = 0.0;
+    double* scale = glyph.Scale;
+    scale[0] = scale[1] = scale[2] = 1.0;
+
+    // Get the scalar and vector data
+    if (inSScalars)
+    {
+      s = inSScalars->GetComponent(ptId, 0);
+      if (this->ScaleMode == VTK_SCALE_BY_SCALAR || this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scale[0] = scale[1] = scale[2] = s;
+      }
+    }
+
+    if (haveVectors)
+    {
+      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+      {
+        glyph.Magnitude = 1.0; // the vector is set with the transform
+      }
+      else
+      {
+        array3D->GetTuple(ptId, glyph.Vector);
+        glyph.Magnitude = vtkMath::Norm(glyph.Vector);
+        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
         {
-          numSourcePts = source->GetNumberOfPoints();
+          scale[0] = glyph.Vector[0];
+          scale[1] = glyph.Vector[1];
+          scale[2] = glyph.Vector[2];
         }
-        if (source->GetNumberOfCells() > numSourceCells)
+        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+        {
+          scale[0] = scale[1] = scale[2] = glyph.Magnitude;
+        }
+      }
+    }
+
+    // Clamp data scale if enabled
+    if (this->Clamping)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        scale[i] = (scale[i] < this->Range[0]
+            ? this->Range[0]
+            : (scale[i] > this->Range[1] ? this->Range[1] : scale[i]));
+        scale[i] = (scale[i] - this->Range[0]) / den;
+      }
+    }
+
+    // Compute index into table of glyphs
+    glyph.SourceIndex = 0;
+    if (this->IndexMode != VTK_INDEXING_OFF)
+    {
+      const double value = this->IndexMode == VTK_INDEXING_BY_SCALAR ? s : glyph.Magnitude;
+      int index = static_cast<int>((value - this->Range[0]) * numberOfSources / den);
+      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
+      glyph.SourceIndex = index;
+    }
+  };
+
+  // The direction from the point x to the followed camera.
+  auto cameraDirection = [&](const double x[3], double v[3]) {
+    v[0] = this->FollowedCameraPosition[0] - x[0];
+    v[1] = this->FollowedCameraPosition[1] - x[1];
+    v[2] = this->FollowedCameraPosition[2] - x[2];
+    vtkMath::Normalize(v);
+  };
+
+  // Builds the transform of the glyph located at x.
+  auto buildTransform = [&](vtkTransform* trans, const double x[3], const GlyphParameters& glyph) {
+    const double* v = glyph.Vector;
+    trans->Identity();
+
+    // translate Source to Input point
+    trans->Translate(x[0], x[1], x[2]);
+
+    if (haveVectors && this->Orient)
+    {
+      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+      {
+        // glyphNormal_World (glyph normal direction in World coordinate system)
+        double glyphNormal_World[3];
+        cameraDirection(x, glyphNormal_World);
+        double glyphRight_World[3]; // glyph right direction in World coordinate system
+        vtkMath::Cross(this->FollowedCameraViewUp, glyphNormal_World, glyphRight_World);
+        // glyph up direction in World coordinate system
+        // (approximately the same as this->FollowedCameraViewUp, but slightly adjusted to be
+        // orthogonal to the normal direction)
+        double glyphUp_World[3];
+        vtkMath::Cross(glyphNormal_World, glyphRight_World, glyphUp_World);
+        double glyphToWorld[16] = { glyphRight_World[0], glyphUp_World[0], glyphNormal_World[0],
+          0.0, glyphRight_World[1], glyphUp_World[1], glyphNormal_World[1], 0.0,
+          glyphRight_World[2], glyphUp_World[2], glyphNormal_World[2], 0.0, 0.0, 0.0, 0.0, 1.0 };
+        trans->Concatenate(glyphToWorld);
+      }
+      else if (glyph.Magnitude > 0.0)
+      {
+        // if there is no y or z component
+        if (v[1] == 0.0 && v[2] == 0.0)
         {
-          numSourceCells = source->GetNumberOfCells();
+          if (v[0] < 0) // just flip x if we need to
+          {
+            trans->RotateWXYZ(180.0, 0, 1, 0);
+          }
         }
-        if (!(sourceNormals = source->GetPointData()->GetNormals()))
+        else
         {
-          haveNormals = 0;
+          trans->RotateWXYZ(180.0, (v[0] + glyph.Magnitude) / 2.0, v[1] / 2.0, v[2] / 2.0);
         }
       }
     }
-  }
-  else
+
+    // scale data if appropriate
+    if (this->Scaling)
+    {
+      double scale[3];
+      for (int i = 0; i < 3; i++)
+      {
+        scale[i] = this->ScaleMode == VTK_DATA_SCALING_OFF ? this->ScaleFactor
+                                                           : glyph.Scale[i] * this->ScaleFactor;
+        if (scale[i] == 0.0)
+        {
+          scale[i] = 1.0e-10;
+        }
+      }
+      trans->Scale(scale);
+    }
+  };
+
+  // Select the glyphed points and their sources first: this gives the range
+  // of output points and cells of every glyph, so that the glyphs can then
+  // be copied concurrently. IsPointVisible() is only called from here.
+  std::vector<vtkIdType> glyphPointIds;
+  std::vector<int> glyphSources;
+  for (inPtId = 0; inPtId < numPts; inPtId++)
   {
-    sourcePts = source->GetPoints();
-    numSourcePts = sourcePts->GetNumberOfPoints();
-    numSourceCells = source->GetNumberOfCells();
+    if (!(inPtId % 10000))
+    {
+      this->UpdateProgress(0.5 * inPtId / numPts);
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+    }
 
-    sourceNormals = source->GetPointData()->GetNormals();
-    if (sourceNormals)
+    int index = 0;
+    if (this->IndexMode != VTK_INDEXING_OFF)
     {
-      haveNormals = 1;
+      GlyphParameters glyph;
+      computeGlyph(inPtId, glyph);
+      index = glyph.SourceIndex;
     }
-    else
+
+    // Make sure we're not indexing into empty glyph
+    if (index < 0 || sources[index].Source == nullptr)
     {
-      haveNormals = 0;
+      continue;
     }
 
-    sourceTCoords = source->GetPointData()->GetTCoords();
-    if (sourceTCoords)
+    // Check ghost points.
+    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
+    if (inGhostLevels &&
+      inGhostLevels[inPtId] &
+        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
     {
-      haveTCoords = 1;
+      continue;
     }
-    else
+
+    if (inputUG && !inputUG->IsPointVisible(inPtId))
     {
-      haveTCoords = 0;
+      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
+      // it.
+      continue;
     }
 
-    // Prepare to copy output.
-    pd = input->GetPointData();
-    outputPD->CopyAllocate(pd, numPts * numSourcePts);
+    if (!this->IsPointVisible(input, inPtId))
+    {
+      continue;
+    }
+
+    glyphPointIds.push_back(inPtId);
+    glyphSources.push_back(index);
+  }
+  const vtkIdType numGlyphs = static_cast<vtkIdType>(glyphPointIds.size());
+
+  // The offsets of the output points and cells of every glyph. The cells of
+  // each type are also numbered separately, as they go to separate cell
+  // arrays.
+  std::vector<vtkIdType> pointOffsets(numGlyphs + 1, 0);
+  std::vector<vtkIdType> glyphCellOffsets(numGlyphs + 1, 0);
+  std::vector<vtkIdType> cellOffsets[4];
+  for (int type = 0; type < 4; type++)
+  {
+    cellOffsets[type].resize(numGlyphs + 1, 0);
+  }
+  for (vtkIdType glyphId = 0; glyphId < numGlyphs; glyphId++)
+  {
+    const GlyphSource& glyphSource = sources[glyphSources[glyphId]];
+    pointOffsets[glyphId + 1] =
+      pointOffsets[glyphId] + (outputInstances ? 1 : glyphSource.GetNumberOfPoints());
+    glyphCellOffsets[glyphId + 1] = glyphCellOffsets[glyphId] + (outputInstances ? 1 : 0);
+    for (int type = 0; type < 4; type++)
+    {
+      const vtkIdType numTypeCells = outputInstances ? 0 : glyphSource.GetNumberOfCells(type);
+      cellOffsets[type][glyphId + 1] = cellOffsets[type][glyphId] + numTypeCells;
+      glyphCellOffsets[glyphId + 1] += numTypeCells;
+    }
+  }
+  const vtkIdType numNewPts = pointOffsets[numGlyphs];
+  const vtkIdType numNewCells = glyphCellOffsets[numGlyphs];
+
+  // The output cells are numbered in the order they are inserted, glyph by
+  // glyph. When the glyphs mix cell types, this order interleaves the types,
+  // so the cells are then inserted one by one instead of built per type.
+  int numCellTypes = 0;
+  for (int type = 0; type < 4; type++)
+  {
+    numCellTypes += cellOffsets[type][numGlyphs] > 0 ? 1 : 0;
+  }
+  const bool mixedCellTypes = numCellTypes > 1;
+
+  // Prepare to copy output.
+  if (pd)
+  {
+    outputPD->CopyAllocate(pd, numNewPts);
     if (this->FillCellData)
     {
       outputCD->CopyGlobalIdsOn();
-      outputCD->CopyAllocate(pd, numPts * numSourceCells);
+      outputCD->CopyAllocate(pd, numNewCells);
     }
   }
 
-  srcPointIdList->SetNumberOfIds(numSourcePts);
-  dstPointIdList->SetNumberOfIds(numSourcePts);
-  srcCellIdList->SetNumberOfIds(numSourceCells);
-  dstCellIdList->SetNumberOfIds(numSourceCells);
-
   newPts = vtkPoints::New();
 
   // Set the desired precision for the points in the output.
@@ -341,12 +727,12 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numPts * numSourcePts);
+  newPts->SetNumberOfPoints(numNewPts);
   if (this->GeneratePointIds)
   {
     pointIds = vtkIdTypeArray::New();
     pointIds->SetName(this->PointIdsName);
-    pointIds->Allocate(numPts * numSourcePts);
+    pointIds->SetNumberOfValues(numNewPts);
     outputPD->AddArray(pointIds);
     pointIds->Delete();
   }
@@ -354,13 +740,12 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   {
     newScalars = inCScalars->NewInstance();
     newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
-    newScalars->Allocate(inCScalars->GetNumberOfComponents() * numPts * numSourcePts);
     newScalars->SetName(inCScalars->GetName());
   }
   else if ((this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
   {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts * numSourcePts);
+    newScalars->SetNumberOfTuples(numNewPts);
     newScalars->SetName("GlyphScale");
     if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
     {
@@ -370,354 +755,272 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   else if ((this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
   {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts * numSourcePts);
+    newScalars->SetNumberOfTuples(numNewPts);
     newScalars->SetName("VectorMagnitude");
   }
+  vtkFloatArray* newFloatScalars = vtkFloatArray::SafeDownCast(newScalars);
+  if (this->ColorMode == VTK_COLOR_BY_SCALAR)
+  {
+    newFloatScalars = nullptr;
+  }
   if (haveVectors)
   {
     newVectors = vtkFloatArray::New();
     newVectors->SetNumberOfComponents(3);
-    newVectors->Allocate(3 * numPts * numSourcePts);
+    newVectors->SetNumberOfTuples(numNewPts);
     newVectors->SetName("GlyphVector");
   }
   if (haveNormals)
   {
     newNormals = vtkFloatArray::New();
     newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(3 * numPts * numSourcePts);
+    newNormals->SetNumberOfTuples(numNewPts);
     newNormals->SetName("Normals");
   }
   if (haveTCoords)
   {
     newTCoords = vtkFloatArray::New();
-    int numComps = sourceTCoords->GetNumberOfComponents();
-    newTCoords->SetNumberOfComponents(numComps);
-    newTCoords->Allocate(numComps * numPts * numSourcePts);
+    newTCoords->SetNumberOfComponents(sourceTCoords->GetNumberOfComponents());
+    newTCoords->SetNumberOfTuples(numNewPts);
     newTCoords->SetName("TCoords");
   }
-
-  // Setting up for calls to PolyData::InsertNextCell()
-  output->AllocateEstimate(numPts * numSourceCells, 3);
-
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
-
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
-  //
-  ptIncr = 0;
-  cellIncr = 0;
-  for (inPtId = 0; inPtId < numPts; inPtId++)
+  if (outputInstances)
   {
-    scalex = scaley = scalez = 1.0;
-    if (!(inPtId % 10000))
+    newTransforms = vtkDoubleArray::New();
+    newTransforms->SetNumberOfComponents(16);
+    newTransforms->SetNumberOfTuples(numGlyphs);
+    newTransforms->SetName("GlyphTransform");
+    if (this->IndexMode != VTK_INDEXING_OFF)
     {
-      this->UpdateProgress(static_cast<double>(inPtId) / numPts);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      newSourceIndices = vtkIntArray::New();
+      newSourceIndices->SetNumberOfValues(numGlyphs);
+      newSourceIndices->SetName("GlyphSourceIndex");
     }
+  }
 
-    // Get the scalar and vector data
-    if (inSScalars)
-    {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if (this->ScaleMode == VTK_SCALE_BY_SCALAR || this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = s;
-      }
-    }
+  // The input point of every output point, and of every output cell when
+  // filling the cell data.
+  std::vector<vtkIdType> sourcePointIds;
+  std::vector<vtkIdType> sourceCellIds;
+  if (pd || (newScalars && !newFloatScalars))
+  {
+    sourcePointIds.resize(numNewPts);
+  }
+  if (pd && this->FillCellData)
+  {
+    sourceCellIds.resize(numNewCells);
+  }
+  double sourceMatrix[4][4];
+  if (this->SourceTransform)
+  {
+    vtkMatrix4x4::DeepCopy(*sourceMatrix, this->SourceTransform->GetMatrix());
+  }
 
-    if (haveVectors)
+  // Transform and copy the glyphs concurrently, each one to its own range of
+  // output points. GetPoint() is thread safe once called from a single thread.
+  double firstPoint[3];
+  input->GetPoint(0, firstPoint);
+  vtkSMPThreadLocalObject<vtkTransform> localTransforms;
+  auto copyGlyphs = [&](vtkIdType glyphId, vtkIdType endGlyphId) {
+    vtkTransform* trans = localTransforms.Local();
+    for (; glyphId < endGlyphId; glyphId++)
     {
-      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+      const vtkIdType ptId = glyphPointIds[glyphId];
+      const GlyphSource& glyphSource = sources[glyphSources[glyphId]];
+      const vtkIdType firstPtId = pointOffsets[glyphId];
+      const vtkIdType numGlyphPts = pointOffsets[glyphId + 1] - firstPtId;
+      GlyphParameters glyph;
+      computeGlyph(ptId, glyph);
+      double x[3];
+      input->GetPoint(ptId, x);
+      buildTransform(trans, x, glyph);
+      if (haveVectors && this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
       {
-        vMag = 1.0; // v will be set later
+        // As the serial filter did, the vector of a glyph following the
+        // camera is the camera direction of the previous glyph when
+        // orienting, and is not set otherwise.
+        glyph.Vector[0] = glyph.Vector[1] = glyph.Vector[2] = 0.0;
+        if (this->Orient && glyphId > 0)
+        {
+          double previousX[3];
+          input->GetPoint(glyphPointIds[glyphId - 1], previousX);
+          cameraDirection(previousX, glyph.Vector);
+        }
       }
-      else
+      double matrix[4][4];
+      vtkMatrix4x4::DeepCopy(*matrix, trans->GetMatrix());
+
+      if (outputInstances)
       {
-        vtkDataArray* array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
-        if (array3D->GetNumberOfComponents() > 3)
+        newPts->SetPoint(glyphId, x);
+        double* instanceMatrix = newTransforms->GetPointer(16 * glyphId);
+        if (this->SourceTransform)
         {
-          vtkErrorMacro(<< "vtkDataArray " << array3D->GetName()
-                        << " has more than 3 components.\n");
-          pts->Delete();
-          trans->Delete();
-          if (newPts)
-          {
-            newPts->Delete();
-          }
-          if (newVectors)
-          {
-            newVectors->Delete();
-          }
-          return false;
+          vtkMatrix4x4::Multiply4x4(*matrix, *sourceMatrix, instanceMatrix);
         }
-
-        v[0] = 0;
-        v[1] = 0;
-        v[2] = 0;
-        array3D->GetTuple(inPtId, v);
-        vMag = vtkMath::Norm(v);
-        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        else
         {
-          scalex = v[0];
-          scaley = v[1];
-          scalez = v[2];
+          std::copy(*matrix, *matrix + 16, instanceMatrix);
         }
-        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+        if (newSourceIndices)
         {
-          scalex = scaley = scalez = vMag;
+          newSourceIndices->SetValue(glyphId, glyphSources[glyphId]);
         }
       }
-    }
-
-    // Clamp data scale if enabled
-    if (this->Clamping)
-    {
-      scalex = (scalex < this->Range[0] ? this->Range[0]
-                                        : (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0]
-                                        : (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0]
-                                        : (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
-    }
-
-    // Compute index into table of glyphs
-    if (this->IndexMode != VTK_INDEXING_OFF)
-    {
-      if (this->IndexMode == VTK_INDEXING_BY_SCALAR)
-      {
-        value = s;
-      }
       else
       {
-        value = vMag;
-      }
-
-      int index = static_cast<int>((value - this->Range[0]) * numberOfSources / den);
-      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if (source != nullptr)
-      {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-      }
-    }
-
-    // Make sure we're not indexing into empty glyph
-    if (source == nullptr)
-    {
-      continue;
-    }
-
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
-    if (inGhostLevels &&
-      inGhostLevels[inPtId] &
-        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
-    {
-      continue;
-    }
-
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
-    {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
-      continue;
-    }
-
-    if (!this->IsPointVisible(input, inPtId))
-    {
-      continue;
-    }
-
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
-    // Copy all topology (transformation independent)
-    for (cellId = 0; cellId < numSourceCells; cellId++)
-    {
-      source->GetCellPoints(cellId, pointIdList);
-      cellPts = pointIdList;
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i = 0; i < npts; i++)
-      {
-        pts->InsertId(i, cellPts->GetId(i) + ptIncr);
-      }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
-    }
-
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-
-    if (haveVectors)
-    {
-      // Copy Input vector
-      for (i = 0; i < numSourcePts; i++)
-      {
-        newVectors->InsertTuple(i + ptIncr, v);
-      }
-      if (this->Orient)
-      {
-        if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+        // multiply points and normals by resulting matrix
+        TransformPoints(matrix, glyphSource.Points, newPts, firstPtId);
+        if (haveNormals)
         {
-          // v = glyphNormal_World (glyph normal direction in World coordinate system)
-          v[0] = this->FollowedCameraPosition[0] - x[0];
-          v[1] = this->FollowedCameraPosition[1] - x[1];
-          v[2] = this->FollowedCameraPosition[2] - x[2];
-          vtkMath::Normalize(v);
-          double glyphRight_World[3]; // glyph right direction in World coordinate system
-          vtkMath::Cross(this->FollowedCameraViewUp, v, glyphRight_World);
-          // glyph up direction in World coordinate system
-          // (approximately the same as this->FollowedCameraViewUp, but slightly adjusted to be
-          // orthogonal to the normal direction)
-          double glyphUp_World[3];
-          vtkMath::Cross(v, glyphRight_World, glyphUp_World);
-          double glyphToWorld[16] = { glyphRight_World[0], glyphUp_World[0], v[0], 0.0,
-            glyphRight_World[1], glyphUp_World[1], v[1], 0.0, glyphRight_World[2], glyphUp_World[2],
-            v[2], 0.0, 0.0, 0.0, 0.0, 1.0 };
-          trans->Concatenate(glyphToWorld);
+          TransformNormals(matrix, glyphSource.Normals, newNormals, firstPtId, numGlyphPts);
         }
-        else if (vMag > 0.0)
+        if (haveTCoords)
         {
-          // if there is no y or z component
-          if (v[1] == 0.0 && v[2] == 0.0)
-          {
-            if (v[0] < 0) // just flip x if we need to
-            {
-              trans->RotateWXYZ(180.0, 0, 1, 0);
-            }
-          }
-          else
+          double tc[3];
+          for (vtkIdType i = 0; i < numGlyphPts; i++)
           {
-            vNew[0] = (v[0] + vMag) / 2.0;
-            vNew[1] = v[1] / 2.0;
-            vNew[2] = v[2] / 2.0;
-            trans->RotateWXYZ(180.0, vNew[0], vNew[1], vNew[2]);
+            sourceTCoords->GetTuple(i, tc);
+            newTCoords->SetTuple(firstPtId + i, tc);
           }
         }
       }
-    }
-
-    if (haveTCoords)
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i + ptIncr, tc);
-      }
-    }
 
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-    {
-      for (i = 0; i < numSourcePts; i++)
+      for (vtkIdType i = 0; i < numGlyphPts; i++)
       {
-        newScalars->InsertTuple(i + ptIncr, &scalex); // = scaley = scalez
+        if (newVectors)
+        {
+          newVectors->SetTuple(firstPtId + i, glyph.Vector);
+        }
+        // Copy scalar value
+        if (newFloatScalars)
+        {
+          newFloatScalars->SetValue(firstPtId + i,
+            static_cast<float>(
+              this->ColorMode == VTK_COLOR_BY_VECTOR ? glyph.Magnitude : glyph.Scale[0]));
+        }
+        if (pointIds)
+        {
+          pointIds->SetValue(firstPtId + i, ptId);
+        }
       }
-    }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-    {
-      for (i = 0; i < numSourcePts; i++)
+      if (!sourcePointIds.empty())
       {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr + i);
+        std::fill_n(sourcePointIds.begin() + firstPtId, numGlyphPts, ptId);
       }
-    }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-    {
-      for (i = 0; i < numSourcePts; i++)
+      if (!sourceCellIds.empty())
       {
-        newScalars->InsertTuple(i + ptIncr, &vMag);
+        std::fill(sourceCellIds.begin() + glyphCellOffsets[glyphId],
+          sourceCellIds.begin() + glyphCellOffsets[glyphId + 1], ptId);
       }
     }
+  };
+  if (this->SequentialProcessing)
+  {
+    copyGlyphs(0, numGlyphs);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numGlyphs, copyGlyphs);
+  }
+  this->UpdateProgress(0.75);
 
-    // scale data if appropriate
-    if (this->Scaling)
+  // Copy the topology of the glyphs, shifted to their output points.
+  vtkSMPThreadLocalObject<vtkIdList> localCellPts;
+  bool builtCells = true;
+  if (outputInstances)
+  {
+    vtkNew<vtkCellArray> verts;
+    auto vertSize = [](vtkIdType) -> vtkIdType { return 1; };
+    auto vertPoints = [](vtkIdType vertId, vtkIdType* pts) { pts[0] = vertId; };
+    builtCells = BuildCells(verts, numGlyphs, vertSize, vertPoints, this->SequentialProcessing);
+    output->SetVerts(verts);
+  }
+  else if (mixedCellTypes)
+  {
+    output->AllocateEstimate(numNewCells, 3);
+    vtkNew<vtkIdList> cellPts;
+    for (vtkIdType glyphId = 0; glyphId < numGlyphs; glyphId++)
     {
-      if (this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = this->ScaleFactor;
-      }
-      else
-      {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
-      }
-
-      if (scalex == 0.0)
-      {
-        scalex = 1.0e-10;
-      }
-      if (scaley == 0.0)
+      const GlyphSource& glyphSource = sources[glyphSources[glyphId]];
+      if (!glyphSource.Points)
       {
-        scaley = 1.0e-10;
+        continue;
       }
-      if (scalez == 0.0)
+      vtkPolyData* glyphPolyData = glyphSource.Source;
+      for (vtkIdType cellId = 0; cellId < glyphPolyData->GetNumberOfCells(); cellId++)
       {
-        scalez = 1.0e-10;
+        glyphPolyData->GetCellPoints(cellId, cellPts);
+        for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); i++)
+        {
+          cellPts->SetId(i, cellPts->GetId(i) + pointOffsets[glyphId]);
+        }
+        output->InsertNextCell(glyphPolyData->GetCellType(cellId), cellPts);
       }
-      trans->Scale(scalex, scaley, scalez);
-    }
-
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-    {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-    }
-    else
-    {
-      trans->TransformPoints(sourcePts, newPts);
-    }
-
-    if (haveNormals)
-    {
-      trans->TransformNormals(sourceNormals, newNormals);
     }
-
-    // Copy point data from source (if possible)
-    if (pd)
+  }
+  else
+  {
+    for (int type = 0; type < 4 && builtCells; type++)
     {
-      for (i = 0; i < numSourcePts; ++i)
+      const std::vector<vtkIdType>& offsets = cellOffsets[type];
+      const vtkIdType numTypeCells = offsets[numGlyphs];
+      if (numTypeCells == 0)
       {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
+        continue;
       }
-      outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
-      if (this->FillCellData)
-      {
-        for (i = 0; i < numSourceCells; ++i)
+      auto glyphOfCell = [&](vtkIdType cellId) {
+        return static_cast<vtkIdType>(
+          std::upper_bound(offsets.begin(), offsets.end(), cellId) - offsets.begin() - 1);
+      };
+      auto cellSize = [&](vtkIdType cellId) {
+        const vtkIdType glyphId = glyphOfCell(cellId);
+        return sources[glyphSources[glyphId]].Cells[type]->GetCellSize(cellId - offsets[glyphId]);
+      };
+      auto cellPoints = [&](vtkIdType cellId, vtkIdType* pts) {
+        const vtkIdType glyphId = glyphOfCell(cellId);
+        vtkIdType npts;
+        const vtkIdType* sourcePts;
+        sources[glyphSources[glyphId]].Cells[type]->GetCellAtId(
+          cellId - offsets[glyphId], npts, sourcePts, localCellPts.Local());
+        for (vtkIdType i = 0; i < npts; i++)
         {
-          srcCellIdList->SetId(i, inPtId);
-          dstCellIdList->SetId(i, cellIncr + i);
+          pts[i] = sourcePts[i] + pointOffsets[glyphId];
         }
-        outputCD->CopyData(pd, srcCellIdList, dstCellIdList);
+      };
+      vtkNew<vtkCellArray> cells;
+      builtCells =
+        BuildCells(cells, numTypeCells, cellSize, cellPoints, this->SequentialProcessing);
+      switch (type)
+      {
+        case 0:
+          output->SetVerts(cells);
+          break;
+        case 1:
+          output->SetLines(cells);
+          break;
+        case 2:
+          output->SetPolys(cells);
+          break;
+        default:
+          output->SetStrips(cells);
+          break;
       }
     }
+  }
 
-    // If point ids are to be generated, do it here
-    if (this->GeneratePointIds)
+  // Copy point data from source (if possible)
+  if (pd && builtCells)
+  {
+    ::CopyAttributes(pd, outputPD, sourcePointIds, this->SequentialProcessing);
+    if (this->FillCellData)
     {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        pointIds->InsertNextValue(inPtId);
-      }
+      ::CopyAttributes(pd, outputCD, sourceCellIds, this->SequentialProcessing);
     }
-
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
+  }
+  if (newScalars && !newFloatScalars && builtCells)
+  {
+    CopyTuples(inCScalars, newScalars, sourcePointIds, this->SequentialProcessing);
   }
 
   // Update ourselves and release memory
@@ -750,9 +1053,26 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     newTCoords->Delete();
   }
 
+  if (newTransforms)
+  {
+    outputPD->AddArray(newTransforms);
+    newTransforms->Delete();
+  }
+
+  if (newSourceIndices)
+  {
+    outputPD->AddArray(newSourceIndices);
+    newSourceIndices->Delete();
+  }
+
+  if (!builtCells)
+  {
+    vtkErrorMacro(<< "Cannot allocate the output cells.");
+    output->Initialize();
+    return false;
+  }
+
   output->Squeeze();
-  trans->Delete();
-  pts->Delete();
 
   return true;
 }
@@ -904,6 +1224,8 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Output Instances: " << (this->OutputInstances ? "On\n" : "Off\n");
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -73,6 +73,19 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * The glyphed points and their sources are selected first, which gives the
+ * range of output points and cells of every glyph. The glyphs are then
+ * transformed and copied concurrently with vtkSMPTools, unless
+ * SequentialProcessing is on. The output cells are ordered by glyph, then
+ * as the cells of the source. When the glyphs mix cell types, the cells are
+ * inserted one by one, in that order.
+ *
+ * @warning
+ * Large numbers of glyphs may be kept instanced with OutputInstances: the
+ * output then holds a single point per glyph along with the transform of
+ * the glyph, rather than a copy of the glyph geometry.
+ *
  * @sa
  * vtkTensorGlyph
  */
@@ -301,6 +314,36 @@ public:
   vtkBooleanMacro(FillCellData, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Enable/disable the output of glyph instances instead of glyph geometry.
+   * When on, the output has one point and one vertex per glyph, located at
+   * the glyphed input point. The point data holds the attributes which the
+   * glyph points would have had, except for normals and texture coordinates,
+   * as well as a "GlyphTransform" array of 16 components: the row-major 4x4
+   * matrix mapping the source points to the glyph, SourceTransform
+   * included. When indexing is on, a "GlyphSourceIndex" array gives the index
+   * of the source of each glyph. The sources are not copied: downstream
+   * filters, mappers or writers look them up with GetSource(). This keeps the
+   * output size proportional to the number of glyphs, whatever the size of
+   * the sources. Off by default.
+   */
+  vtkSetMacro(OutputInstances, vtkTypeBool);
+  vtkGetMacro(OutputInstances, vtkTypeBool);
+  vtkBooleanMacro(OutputInstances, vtkTypeBool);
+  ///@}
+
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the glyphs. By
+   * default, sequential processing is off: the glyphs are transformed and
+   * copied concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   /**
    * This can be overwritten by subclass to return 0 when a point is
    * blanked. Default implementation is to always return 1;
@@ -368,6 +411,8 @@ protected:
   int IndexMode;                  // what to use to index into glyph table
   vtkTypeBool GeneratePointIds;   // produce input points ids for each output point
   vtkTypeBool FillCellData;       // whether to fill output cell data
+  vtkTypeBool OutputInstances;    // output glyph transforms instead of glyph geometry
+  vtkTypeBool SequentialProcessing;
   char* PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
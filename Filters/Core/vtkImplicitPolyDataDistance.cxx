@@ -67,13 +67,40 @@ void vtkImplicitPolyDataDistance::SetInput(vtkPolyData* input)
     this->CreateDefaultLocator();
     this->Locator->SetDataSet(this->Input);
     this->Locator->SetTolerance(this->Tolerance);
-    this->Locator->SetNumberOfCellsPerBucket(10);
-    this->Locator->CacheCellBoundsOn();
-    this->Locator->AutomaticOn();
     this->Locator->BuildLocator();
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkImplicitPolyDataDistance::SetLocator(vtkAbstractCellLocator* locator)
+{
+  if (this->Locator == locator)
+  {
+    return;
+  }
+  vtkAbstractCellLocator* previous = this->Locator;
+  this->Locator = locator;
+  if (this->Locator)
+  {
+    this->Locator->Register(this);
+  }
+  if (this->Input)
+  {
+    // Evaluations need a locator built on the input.
+    this->CreateDefaultLocator();
+    this->Locator->SetDataSet(this->Input);
+    this->Locator->SetTolerance(this->Tolerance);
+    this->Locator->BuildLocator();
+  }
+  // The input is only referenced by the locators, so the previous one is
+  // released once the new one holds the input.
+  if (previous)
+  {
+    previous->UnRegister(this);
+  }
+  this->Modified();
+}
+
 //------------------------------------------------------------------------------
 vtkMTimeType vtkImplicitPolyDataDistance::GetMTime()
 {
@@ -104,7 +131,11 @@ void vtkImplicitPolyDataDistance::CreateDefaultLocator()
 {
   if (this->Locator == nullptr)
   {
-    this->Locator = vtkCellLocator::New();
+    vtkCellLocator* locator = vtkCellLocator::New();
+    locator->SetNumberOfCellsPerBucket(10);
+    locator->CacheCellBoundsOn();
+    locator->AutomaticOn();
+    this->Locator = locator;
   }
 }
 
@@ -344,6 +375,7 @@ void vtkImplicitPolyDataDistance::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NoGradient: (" << this->NoGradient[0] << ", " << this->NoGradient[1] << ", "
      << this->NoGradient[2] << ")\n";
   os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Locator: " << this->Locator << "\n";
 
   if (this->Input)
   {
@@ -43,7 +43,7 @@
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkImplicitFunction.h"
 
-class vtkCellLocator;
+class vtkAbstractCellLocator;
 class vtkPolyData;
 
 class VTKFILTERSCORE_EXPORT vtkImplicitPolyDataDistance : public vtkImplicitFunction
@@ -118,6 +118,17 @@ public:
   vtkSetMacro(Tolerance, double);
   ///@}
 
+  ///@{
+  /**
+   * Set/get the locator used to find the closest cell of the input. By
+   * default a vtkCellLocator is created. Another locator, such as a
+   * vtkBVHCellLocator or a vtkStaticCellLocator, may be faster on large
+   * inputs. The locator is built on the input when both are set.
+   */
+  void SetLocator(vtkAbstractCellLocator* locator);
+  vtkGetObjectMacro(Locator, vtkAbstractCellLocator);
+  ///@}
+
 protected:
   vtkImplicitPolyDataDistance();
   ~vtkImplicitPolyDataDistance() override;
@@ -135,7 +146,7 @@ protected:
   double Tolerance;
 
   vtkPolyData* Input;
-  vtkCellLocator* Locator;
+  vtkAbstractCellLocator* Locator;
 
 private:
   vtkImplicitPolyDataDistance(const vtkImplicitPolyDataDistance&) = delete;
@@ -12,11 +12,15 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkPolyDataConnectivityFilter.h"
 
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityFilterInternal.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -27,7 +31,7 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 
-#include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
@@ -51,6 +55,13 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->NeighborCellPointIds = vtkIdList::New();
   this->NeighborCellPointIds->Allocate(8);
 
+  this->Visited = nullptr;
+  this->PointMap = nullptr;
+  this->RegionNumber = 0;
+  this->PointNumber = 0;
+  this->NumCellsInRegion = 0;
+  this->CellIds = nullptr;
+
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
@@ -58,6 +69,9 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->RegionSizesOnly = false;
+  this->SequentialProcessing = false;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -88,7 +102,7 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   vtkIdType npts;
   const vtkIdType* pts;
   vtkIdType ncells;
-  vtkIdType maxCellsInRegion;
+  vtkIdType maxCellsInRegion = 0;
   vtkIdType largestRegionId = 0;
   vtkPointData *pd = input->GetPointData(), *outputPD = output->GetPointData();
   vtkCellData *cd = input->GetCellData(), *outputCD = output->GetCellData();
@@ -139,84 +153,32 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   // Remove all visited point ids
   this->VisitedPointIds->Reset();
 
-  // Initialize.  Keep track of points and cells visited.
+  // Label the regions, concurrently unless SequentialProcessing is on. The
+  // cells have been built with the links, so that GetCellPoints() is thread
+  // safe.
   //
   this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  std::fill_n(this->Visited, numCells, -1);
-  this->PointMap = new vtkIdType[numPts];
-  std::fill_n(this->PointMap, numPts, -1);
-
-  this->NewScalars = vtkIdTypeArray::New();
-  this->NewScalars->SetName("RegionId");
-  this->NewScalars->SetNumberOfTuples(numPts);
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  vtkPolyData* mesh = this->Mesh;
+  auto cellPoints = [mesh](
+                      vtkIdType cell, vtkIdType& cnpts, const vtkIdType*& cpts, vtkIdList* ids) {
+    mesh->GetCellPoints(cell, cnpts, cpts, ids);
+  };
+  ConnectedRegions regions(numPts, numCells, this->SequentialProcessing);
+  if (this->InScalars)
   {
-    newPts->SetDataType(inPts->GetDataType());
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
+    regions.SetScalarCriterion(
+      cellPoints, this->InScalars, this->ScalarRange, this->FullScalarConnectivity != 0);
   }
 
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
-  //
-  this->Wave.reserve(numPts);
-  this->Wave2.reserve(numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
-  this->PointIds = vtkIdList::New();
-  this->PointIds->Allocate(8, VTK_CELL_SIZE);
-
   if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
-    {
-      if (cellId && !(cellId % 5000))
-      {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
-      }
-
-      if (this->Visited[cellId] < 0)
-      {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark();
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
-      }
-    }
+  { // label all cells with a region number
+    regions.LabelAllRegions(cellPoints);
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
-
+    std::vector<vtkIdType> seeds;
     if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS)
     {
       for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
@@ -225,10 +187,7 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
         if (pt >= 0)
         {
           this->Mesh->GetPointCells(pt, ncells, cells);
-          for (vtkIdType j = 0; j < ncells; ++j)
-          {
-            this->Wave.push_back(cells[j]);
-          }
+          seeds.insert(seeds.end(), cells, cells + ncells);
         }
       }
     }
@@ -236,11 +195,7 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     {
       for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
       {
-        cellId = this->Seeds->GetId(i);
-        if (cellId >= 0)
-        {
-          this->Wave.push_back(cellId);
-        }
+        seeds.push_back(this->Seeds->GetId(i));
       }
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
@@ -258,20 +213,78 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
         }
       }
       this->Mesh->GetPointCells(minId, ncells, cells);
-      for (vtkIdType j = 0; j < ncells; ++j)
-      {
-        this->Wave.push_back(cells[j]);
-      }
+      seeds.insert(seeds.end(), cells, cells + ncells);
     }
     this->UpdateProgress(0.5);
 
     // mark all seeded regions
-    this->TraverseAndMark();
-    this->RegionSizes->InsertValue(this->RegionNumber, this->NumCellsInRegion);
-    this->UpdateProgress(0.9);
+    regions.LabelSeededRegion(cellPoints, seeds);
   } // else extracted seeded cells
+  this->UpdateProgress(0.9);
+
+  const std::vector<vtkIdType>& visited = regions.CellRegions;
+  const vtkIdType numRegions = static_cast<vtkIdType>(regions.RegionSizes.size());
+  this->RegionSizes->SetNumberOfValues(numRegions);
+  for (vtkIdType regionId = 0; regionId < numRegions; regionId++)
+  {
+    const vtkIdType numCellsInRegion = regions.RegionSizes[regionId];
+    this->RegionSizes->SetValue(regionId, numCellsInRegion);
+    if (numCellsInRegion > maxCellsInRegion)
+    {
+      maxCellsInRegion = numCellsInRegion;
+      largestRegionId = regionId;
+    }
+  }
+  vtkDebugMacro(<< "Extracted " << numRegions << " region(s)");
+
+  if (this->RegionSizesOnly)
+  {
+    this->Mesh->Delete();
+    return 1;
+  }
+
+  // The points used by the labeled cells are numbered in the order the wave
+  // propagation reaches them, as the serial traversal did.
+  auto pointCells = [mesh](
+                      vtkIdType ptId, vtkIdType& cncells, const vtkIdType*& ccells, vtkIdList*) {
+    vtkIdType* linkCells;
+    mesh->GetPointCells(ptId, cncells, linkCells);
+    ccells = linkCells;
+  };
+  const std::vector<vtkIdType> pointMap = regions.NumberPoints(cellPoints, pointCells, false);
+  vtkIdType numNewPts = 0;
+  for (i = 0; i < numPts; i++)
+  {
+    numNewPts += pointMap[i] >= 0;
+  }
+  this->NewScalars = vtkIdTypeArray::New();
+  this->NewScalars->SetName("RegionId");
+  this->NewScalars->SetNumberOfTuples(numNewPts);
+  for (i = 0; i < numPts; i++)
+  {
+    if (pointMap[i] >= 0)
+    {
+      this->NewScalars->SetTuple1(pointMap[i], regions.PointRegions[i]);
+    }
+  }
+
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
 
-  vtkDebugMacro(<< "Extracted " << this->RegionNumber << " region(s)");
+  newPts->Allocate(numPts);
 
   // Now that points and cells have been marked, traverse these lists pulling
   // everything that has been visited.
@@ -282,10 +295,10 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
 
   for (i = 0; i < numPts; i++)
   {
-    if (this->PointMap[i] > -1)
+    if (pointMap[i] > -1)
     {
-      newPts->InsertPoint(this->PointMap[i], inPts->GetPoint(i));
-      outputPD->CopyData(pd, i, this->PointMap[i]);
+      newPts->InsertPoint(pointMap[i], inPts->GetPoint(i));
+      outputPD->CopyData(pd, i, pointMap[i]);
     }
   }
 
@@ -300,8 +313,12 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   output->SetPoints(newPts);
   newPts->Delete();
 
-  // Create output cells. Have to allocate storage first.
+  // Create output cells. Have to allocate storage first. The visited point
+  // ids are listed in their order of appearance in the output cells.
   //
+  this->PointIds = vtkIdList::New();
+  this->PointIds->Allocate(8, VTK_CELL_SIZE);
+  std::vector<bool> isMarked(this->MarkVisitedPointIds ? numPts : 0, false);
   if ((n = input->GetVerts()->GetNumberOfCells()) > 0)
   {
     vtkCellArray* newVerts = vtkCellArray::New();
@@ -338,19 +355,23 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   { // extract any cell that's been visited
     for (cellId = 0; cellId < numCells; cellId++)
     {
-      if (this->Visited[cellId] >= 0)
+      if (visited[cellId] >= 0)
       {
         this->Mesh->GetCellPoints(cellId, npts, pts);
         this->PointIds->Reset();
         for (i = 0; i < npts; i++)
         {
-          id = this->PointMap[pts[i]];
+          id = pointMap[pts[i]];
           this->PointIds->InsertId(i, id);
 
           // If we asked to mark the visited point ids, mark them.
           if (this->MarkVisitedPointIds)
           {
-            this->VisitedPointIds->InsertUniqueId(pts[i]);
+            if (!isMarked[pts[i]])
+            {
+              isMarked[pts[i]] = true;
+              this->VisitedPointIds->InsertNextId(pts[i]);
+            }
           }
         }
         newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
@@ -363,7 +384,7 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     for (cellId = 0; cellId < numCells; cellId++)
     {
       int inReg, regionId;
-      if ((regionId = this->Visited[cellId]) >= 0)
+      if ((regionId = visited[cellId]) >= 0)
       {
         for (inReg = 0, i = 0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
         {
@@ -379,13 +400,17 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
           this->PointIds->Reset();
           for (i = 0; i < npts; i++)
           {
-            id = this->PointMap[pts[i]];
+            id = pointMap[pts[i]];
             this->PointIds->InsertId(i, id);
 
             // If we asked to mark the visited point ids, mark them.
             if (this->MarkVisitedPointIds)
             {
-              this->VisitedPointIds->InsertUniqueId(pts[i]);
+              if (!isMarked[pts[i]])
+              {
+                isMarked[pts[i]] = true;
+                this->VisitedPointIds->InsertNextId(pts[i]);
+              }
             }
           }
           newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
@@ -398,19 +423,23 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   {
     for (cellId = 0; cellId < numCells; cellId++)
     {
-      if (this->Visited[cellId] == largestRegionId)
+      if (visited[cellId] == largestRegionId)
       {
         this->Mesh->GetCellPoints(cellId, npts, pts);
         this->PointIds->Reset();
         for (i = 0; i < npts; i++)
         {
-          id = this->PointMap[pts[i]];
+          id = pointMap[pts[i]];
           this->PointIds->InsertId(i, id);
 
           // If we asked to mark the visited point ids, mark them.
           if (this->MarkVisitedPointIds)
           {
-            this->VisitedPointIds->InsertUniqueId(pts[i]);
+            if (!isMarked[pts[i]])
+            {
+              isMarked[pts[i]] = true;
+              this->VisitedPointIds->InsertNextId(pts[i]);
+            }
           }
         }
         newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
@@ -419,11 +448,8 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     }
   }
 
-  delete[] this->Visited;
-  delete[] this->PointMap;
   this->Mesh->Delete();
   output->Squeeze();
-  this->CellIds->Delete();
   this->PointIds->Delete();
 
   int num = this->GetNumberOfExtractedRegions();
@@ -645,4 +671,6 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Region Sizes Only: " << (this->RegionSizesOnly ? "On\n" : "Off\n");
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On\n" : "Off\n");
 }
@@ -43,6 +43,11 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * The regions are labeled concurrently with a union-find over the shared
+ * points, and numbered in the order of their first cell. The points of the
+ * output are numbered as the wave propagation from the first cell of each
+ * region reaches them, as the serial traversal did.
+ *
  * @sa
  * vtkConnectivityFilter
  */
@@ -50,9 +55,12 @@
 #ifndef vtkPolyDataConnectivityFilter_h
 #define vtkPolyDataConnectivityFilter_h
 
+#include "vtkDeprecation.h"       // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
+#include <vector> // For the waves of the deprecated traversal
+
 #define VTK_EXTRACT_POINT_SEEDED_REGIONS 1
 #define VTK_EXTRACT_CELL_SEEDED_REGIONS 2
 #define VTK_EXTRACT_SPECIFIED_REGIONS 3
@@ -227,6 +235,29 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the computation of the region sizes only. When on, the
+   * regions are labeled and their sizes made available through
+   * GetRegionSizes() and GetNumberOfExtractedRegions(), but the output is
+   * left empty. Off by default.
+   */
+  vtkSetMacro(RegionSizesOnly, bool);
+  vtkGetMacro(RegionSizesOnly, bool);
+  vtkBooleanMacro(RegionSizesOnly, bool);
+  ///@}
+
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the labeling. By
+   * default, sequential processing is off: the regions are labeled
+   * concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter() override;
@@ -246,31 +277,37 @@ protected:
   vtkTypeBool FullScalarConnectivity;
 
   // Does this cell qualify as being scalar connected ?
+  VTK_DEPRECATED_IN_9_3_0("The regions are labeled concurrently, without this test.")
   int IsScalarConnected(vtkIdType cellId);
 
   double ScalarRange[2];
 
+  VTK_DEPRECATED_IN_9_3_0("The regions are labeled concurrently, without this traversal.")
   void TraverseAndMark();
 
   // used to support algorithm execution
+  vtkDataArray* NewScalars;
+  vtkDataArray* InScalars;
+  vtkPolyData* Mesh;
+  vtkIdList* PointIds;
+  vtkIdList* VisitedPointIds;
+
+  // used by the deprecated TraverseAndMark() and IsScalarConnected() only
   vtkDataArray* CellScalars;
   vtkIdList* NeighborCellPointIds;
   vtkIdType* Visited;
   vtkIdType* PointMap;
-  vtkDataArray* NewScalars;
   vtkIdType RegionNumber;
   vtkIdType PointNumber;
   vtkIdType NumCellsInRegion;
-  vtkDataArray* InScalars;
-  vtkPolyData* Mesh;
   std::vector<vtkIdType> Wave;
   std::vector<vtkIdType> Wave2;
-  vtkIdList* PointIds;
   vtkIdList* CellIds;
-  vtkIdList* VisitedPointIds;
 
   vtkTypeBool MarkVisitedPointIds;
   int OutputPointsPrecision;
+  bool RegionSizesOnly;
+  vtkTypeBool SequentialProcessing;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) = delete;
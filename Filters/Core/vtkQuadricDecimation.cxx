@@ -41,11 +41,13 @@
 
 #include "vtkQuadricDecimation.h"
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkEdgeTable.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -53,10 +55,29 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+// Partitions smaller than this are not worth decimating concurrently.
+constexpr vtkIdType MinimumPartitionSize = 1000;
+
+// Name of the array holding the input point ids of a partition.
+const char* const OriginalIdsName = "vtkQuadricDecimationOriginalIds";
+}
+
 //------------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
 {
@@ -74,6 +95,9 @@ vtkQuadricDecimation::vtkQuadricDecimation()
 
   this->AttributeErrorMetric = 0;
   this->VolumePreservation = 0;
+  this->ParallelDecimation = 0;
+  this->NumberOfPartitions = 8;
+  this->LockedPoints = nullptr;
   this->ScalarsAttribute = 1;
   this->VectorsAttribute = 1;
   this->NormalsAttribute = 1;
@@ -215,6 +239,11 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
+  if (this->ParallelDecimation && !this->LockedPoints && this->DecimateInParallel(input, output))
+  {
+    return 1;
+  }
+
   polys = vtkCellArray::New();
   points = vtkPoints::New();
   pointData = vtkPointData::New();
@@ -228,7 +257,8 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   polys->DeepCopy(input->GetPolys());
   this->Mesh->SetPolys(polys);
   polys->Delete();
-  if (this->AttributeErrorMetric)
+  // The points of a partition keep their input ids, to be stitched.
+  if (this->AttributeErrorMetric || this->LockedPoints)
   {
     this->Mesh->GetPointData()->DeepCopy(input->GetPointData());
   }
@@ -419,6 +449,279 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// The triangles are split in slabs, decimated concurrently by independent
+// instances of this filter with the points shared between slabs locked.
+// The decimated slabs are stitched back through their input point ids, then
+// a last serial pass collapses the seams toward the target reduction.
+bool vtkQuadricDecimation::DecimateInParallel(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkPoints* inPts = input->GetPoints();
+  vtkCellArray* inPolys = input->GetPolys();
+  vtkPointData* inPD = input->GetPointData();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numTris = inPolys->GetNumberOfCells();
+  const int numPartitions = static_cast<int>(
+    std::min<vtkIdType>(this->NumberOfPartitions, numTris / MinimumPartitionSize));
+  if (numPartitions < 2)
+  {
+    return false;
+  }
+
+  auto configure = [this](vtkQuadricDecimation* decimation, double targetReduction) {
+    decimation->SetTargetReduction(targetReduction);
+    decimation->SetAttributeErrorMetric(this->AttributeErrorMetric);
+    decimation->SetVolumePreservation(this->VolumePreservation);
+    decimation->SetScalarsAttribute(this->ScalarsAttribute);
+    decimation->SetVectorsAttribute(this->VectorsAttribute);
+    decimation->SetNormalsAttribute(this->NormalsAttribute);
+    decimation->SetTCoordsAttribute(this->TCoordsAttribute);
+    decimation->SetTensorsAttribute(this->TensorsAttribute);
+    decimation->SetScalarsWeight(this->ScalarsWeight);
+    decimation->SetVectorsWeight(this->VectorsWeight);
+    decimation->SetNormalsWeight(this->NormalsWeight);
+    decimation->SetTCoordsWeight(this->TCoordsWeight);
+    decimation->SetTensorsWeight(this->TensorsWeight);
+  };
+
+  // Order the triangles along the longest axis of the bounds. Ties are
+  // broken by the cell ids so that the slabs do not depend on the sort.
+  double bounds[6];
+  input->GetBounds(bounds);
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+  {
+    if (bounds[2 * i + 1] - bounds[2 * i] > bounds[2 * axis + 1] - bounds[2 * axis])
+    {
+      axis = i;
+    }
+  }
+  std::vector<std::pair<double, vtkIdType>> order(numTris);
+  vtkSMPThreadLocalObject<vtkIdList> threadIds;
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = threadIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      inPolys->GetCellAtId(cellId, npts, pts, ids);
+      double center = 0.0;
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        inPts->GetPoint(pts[i], x);
+        center += x[axis];
+      }
+      order[cellId] = std::make_pair(npts > 0 ? center / npts : 0.0, cellId);
+    }
+  });
+  vtkSMPTools::Sort(order.begin(), order.end());
+  std::vector<vtkIdType> starts(numPartitions + 1);
+  for (int p = 0; p <= numPartitions; ++p)
+  {
+    starts[p] = p * numTris / numPartitions;
+  }
+  this->UpdateProgress(0.1);
+
+  // Flag with -2 the points used by several slabs.
+  std::unique_ptr<std::atomic<int>[]> owners(new std::atomic<int>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      owners[ptId].store(-1, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = threadIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType k = begin; k < end; ++k)
+    {
+      const int p =
+        static_cast<int>(std::upper_bound(starts.begin(), starts.end(), k) - starts.begin()) - 1;
+      inPolys->GetCellAtId(order[k].second, npts, pts, ids);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        int owner = -1;
+        if (!owners[pts[i]].compare_exchange_strong(owner, p) && owner != p)
+        {
+          owners[pts[i]].store(-2);
+        }
+      }
+    }
+  });
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
+
+  // Decimate the slabs.
+  std::vector<vtkSmartPointer<vtkPolyData>> pieces(numPartitions);
+  vtkSMPTools::For(0, numPartitions, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> ids;
+    for (vtkIdType p = begin; p < end; ++p)
+    {
+      const vtkIdType first = starts[p];
+      const vtkIdType last = starts[p + 1];
+      std::unordered_map<vtkIdType, vtkIdType> localIds;
+      localIds.reserve(last - first);
+      vtkNew<vtkIdTypeArray> originalIds;
+      originalIds->SetName(OriginalIdsName);
+      std::vector<unsigned char> locked;
+      vtkNew<vtkCellArray> polys;
+      polys->AllocateExact(last - first, 3 * (last - first));
+      vtkIdType npts;
+      const vtkIdType* pts;
+      vtkIdType localPts[3];
+      for (vtkIdType k = first; k < last; ++k)
+      {
+        inPolys->GetCellAtId(order[k].second, npts, pts, ids);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          auto inserted = localIds.emplace(pts[i], originalIds->GetNumberOfValues());
+          if (inserted.second)
+          {
+            originalIds->InsertNextValue(pts[i]);
+            locked.push_back(owners[pts[i]].load(std::memory_order_relaxed) == -2);
+          }
+          localPts[i] = inserted.first->second;
+        }
+        polys->InsertNextCell(npts, localPts);
+      }
+
+      const vtkIdType numLocalPts = originalIds->GetNumberOfValues();
+      vtkNew<vtkPoints> points;
+      points->SetDataType(inPts->GetDataType());
+      points->SetNumberOfPoints(numLocalPts);
+      double x[3];
+      for (vtkIdType i = 0; i < numLocalPts; ++i)
+      {
+        inPts->GetPoint(originalIds->GetValue(i), x);
+        points->SetPoint(i, x);
+      }
+      vtkNew<vtkPolyData> mesh;
+      mesh->SetPoints(points);
+      mesh->SetPolys(polys);
+      if (this->AttributeErrorMetric)
+      {
+        ids->SetNumberOfIds(numLocalPts);
+        std::copy(originalIds->GetPointer(0), originalIds->GetPointer(0) + numLocalPts,
+          ids->GetPointer(0));
+        mesh->GetPointData()->CopyAllocate(inPD, numLocalPts);
+        mesh->GetPointData()->CopyData(inPD, ids);
+      }
+      mesh->GetPointData()->AddArray(originalIds);
+
+      vtkNew<vtkQuadricDecimation> decimation;
+      configure(decimation, this->TargetReduction);
+      decimation->LockedPoints = locked.data();
+      decimation->SetInputData(mesh);
+      decimation->Update();
+      pieces[p] = vtkSmartPointer<vtkPolyData>::New();
+      pieces[p]->ShallowCopy(decimation->GetOutput());
+    }
+  });
+  this->UpdateProgress(0.7);
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
+
+  // Stitch the slabs. The locked points are the only points shared between
+  // slabs, and the decimation of a slab leaves them in place: they map to a
+  // single output point through their input ids. Every other point of a slab
+  // gets its own output point.
+  vtkNew<vtkPolyData> seams;
+  vtkIdType numSeamsPts = 0;
+  vtkIdType numSeamsPolys = 0;
+  vtkIdType seamsConnSize = 0;
+  std::vector<vtkIdType> lockedIds(numPts, -1);
+  std::vector<std::vector<vtkIdType>> pointMaps(numPartitions);
+  for (int p = 0; p < numPartitions; ++p)
+  {
+    vtkPolyData* piece = pieces[p];
+    vtkIdTypeArray* originalIds =
+      vtkArrayDownCast<vtkIdTypeArray>(piece->GetPointData()->GetArray(OriginalIdsName));
+    const vtkIdType numPiecePts = piece->GetNumberOfPoints();
+    std::vector<vtkIdType>& pointMap = pointMaps[p];
+    pointMap.resize(numPiecePts);
+    for (vtkIdType i = 0; i < numPiecePts; ++i)
+    {
+      vtkIdType& id = pointMap[i];
+      if (owners[originalIds->GetValue(i)].load(std::memory_order_relaxed) == -2)
+      {
+        vtkIdType& lockedId = lockedIds[originalIds->GetValue(i)];
+        if (lockedId < 0)
+        {
+          lockedId = numSeamsPts++;
+        }
+        id = lockedId;
+      }
+      else
+      {
+        id = numSeamsPts++;
+      }
+    }
+    piece->GetPointData()->RemoveArray(OriginalIdsName);
+    numSeamsPolys += piece->GetPolys()->GetNumberOfCells();
+    seamsConnSize += piece->GetPolys()->GetNumberOfConnectivityIds();
+  }
+  lockedIds.clear();
+  lockedIds.shrink_to_fit();
+  owners.reset();
+
+  vtkNew<vtkPoints> seamsPts;
+  seamsPts->SetDataType(inPts->GetDataType());
+  seamsPts->SetNumberOfPoints(numSeamsPts);
+  vtkNew<vtkCellArray> seamsPolys;
+  seamsPolys->AllocateExact(numSeamsPolys, seamsConnSize);
+  vtkPointData* seamsPD = seams->GetPointData();
+  seamsPD->CopyAllocate(pieces[0]->GetPointData(), numSeamsPts);
+  std::vector<vtkIdType> cellPts;
+  for (int p = 0; p < numPartitions; ++p)
+  {
+    vtkPolyData* piece = pieces[p];
+    vtkPointData* piecePD = piece->GetPointData();
+    const std::vector<vtkIdType>& pointMap = pointMaps[p];
+    double x[3];
+    for (vtkIdType i = 0; i < static_cast<vtkIdType>(pointMap.size()); ++i)
+    {
+      piece->GetPoint(i, x);
+      seamsPts->SetPoint(pointMap[i], x);
+      seamsPD->CopyData(piecePD, i, pointMap[i]);
+    }
+    vtkIdType npts;
+    const vtkIdType* pts;
+    auto iter = vtk::TakeSmartPointer(piece->GetPolys()->NewIterator());
+    for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+    {
+      iter->GetCurrentCell(npts, pts);
+      cellPts.resize(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        cellPts[i] = pointMap[pts[i]];
+      }
+      seamsPolys->InsertNextCell(npts, cellPts.data());
+    }
+  }
+  seams->SetPoints(seamsPts);
+  seams->SetPolys(seamsPolys);
+  seams->GetFieldData()->PassData(input->GetFieldData());
+  pieces.clear();
+  this->UpdateProgress(0.8);
+
+  // Collapse the seams, and whatever the locking kept from the target.
+  const double numSeamsTris = static_cast<double>(seams->GetNumberOfPolys());
+  const double numTargetTris = (1.0 - this->TargetReduction) * numTris;
+  vtkNew<vtkQuadricDecimation> decimation;
+  configure(decimation, numSeamsTris > numTargetTris ? 1.0 - numTargetTris / numSeamsTris : 0.0);
+  decimation->SetInputData(seams);
+  decimation->Update();
+  output->ShallowCopy(decimation->GetOutput());
+  this->ActualReduction = 1.0 - static_cast<double>(output->GetNumberOfPolys()) / numTris;
+  return true;
+}
+
 //------------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
 {
@@ -951,6 +1254,12 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
     }
   }
 
+  if (this->LockedPoints &&
+    (this->LockedPoints[pointIds[0]] || this->LockedPoints[pointIds[1]]))
+  {
+    cost = VTK_DOUBLE_MAX;
+  }
+
   return cost;
 }
 
@@ -1197,6 +1506,12 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
 
   cost += this->TempQuad[9];
 
+  if (this->LockedPoints &&
+    (this->LockedPoints[pointIds[0]] || this->LockedPoints[pointIds[1]]))
+  {
+    cost = VTK_DOUBLE_MAX;
+  }
+
   return cost;
 }
 
@@ -1465,6 +1780,8 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Attribute Error Metric: " << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: " << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Parallel Decimation: " << (this->ParallelDecimation ? "On\n" : "Off\n");
+  os << indent << "Number Of Partitions: " << this->NumberOfPartitions << "\n";
   os << indent << "Scalars Attribute: " << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: " << (this->VectorsAttribute ? "On\n" : "Off\n");
   os << indent << "Normals Attribute: " << (this->NormalsAttribute ? "On\n" : "Off\n");
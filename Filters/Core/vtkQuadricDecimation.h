@@ -156,12 +156,46 @@ public:
   vtkGetMacro(ActualReduction, double);
   ///@}
 
+  ///@{
+  /**
+   * Decide whether to decimate partitions of the mesh concurrently. If on,
+   * the triangles are split in NumberOfPartitions slabs along the longest
+   * axis of the bounds. Each slab is decimated independently toward the
+   * TargetReduction, its points shared with other slabs being locked. The
+   * slabs are then stitched together, and a final pass over the whole mesh
+   * collapses the seams until the TargetReduction is reached. The error
+   * quadrics are not kept between the passes, so the result is close to,
+   * but not the same as, the serial decimation. Meshes with too few
+   * triangles per partition are decimated serially. By default
+   * ParallelDecimation is off.
+   */
+  vtkSetMacro(ParallelDecimation, vtkTypeBool);
+  vtkGetMacro(ParallelDecimation, vtkTypeBool);
+  vtkBooleanMacro(ParallelDecimation, vtkTypeBool);
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the number of partitions decimated concurrently when
+   * ParallelDecimation is on. The output does not depend on the number of
+   * threads, only on this number. By default 8 partitions are used.
+   */
+  vtkSetClampMacro(NumberOfPartitions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPartitions, int);
+  ///@}
+
 protected:
   vtkQuadricDecimation();
   ~vtkQuadricDecimation() override;
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Decimate the partitions of the input concurrently, then the seams.
+   * Return false if the input is too small to be partitioned.
+   */
+  bool DecimateInParallel(vtkPolyData* input, vtkPolyData* output);
+
   /**
    * Do the dirty work of eliminating the edge; return the number of
    * triangles deleted.
@@ -234,6 +268,8 @@ protected:
   double ActualReduction;
   vtkTypeBool AttributeErrorMetric;
   vtkTypeBool VolumePreservation;
+  vtkTypeBool ParallelDecimation;
+  int NumberOfPartitions;
 
   vtkTypeBool ScalarsAttribute;
   vtkTypeBool VectorsAttribute;
@@ -266,6 +302,10 @@ protected:
 
   // Contains 4 doubles per point. Length = nPoints * 4
   double* VolumeConstraints;
+
+  // When decimating a partition, flags the points shared with the other
+  // partitions. The edges using them are never collapsed.
+  const unsigned char* LockedPoints;
   int AttributeComponents[6];
   double AttributeScale[6];
 
@@ -15,7 +15,9 @@
 
 #include "vtkThreshold.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
 #include "vtkDataSetAttributes.h"
@@ -23,17 +25,181 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+// Number of input cells per block when assembling the output. The kept cells
+// and their new points are counted per block, so that the output ids, which
+// follow the input cell order, are known before the points are copied.
+constexpr vtkIdType BlockSize = 4096;
+
+//------------------------------------------------------------------------------
+// Builds the output from the kept cells, identical to the serial assembly:
+// the points are numbered in the order the kept cells first use them.
+// Returns false if the cells cannot be allocated.
+bool AssembleInParallel(vtkDataSet* input, const std::vector<unsigned char>& keepCells,
+  vtkSMPThreadLocalObject<vtkIdList>& threadCellPts, vtkPoints* newPoints,
+  vtkUnstructuredGrid* output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+
+  // The first kept cell using each point.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstCells(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      firstCells[ptId].store(numCells, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = threadCellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (!keepCells[cellId])
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        std::atomic<vtkIdType>& firstCell = firstCells[cellPts->GetId(i)];
+        vtkIdType current = firstCell.load(std::memory_order_relaxed);
+        while (cellId < current &&
+          !firstCell.compare_exchange_weak(current, cellId, std::memory_order_relaxed))
+        {
+        }
+      }
+    }
+  });
+
+  // Count the cells and the new points of each block. A point is new in the
+  // block of its first cell, where it is marked with -2.
+  const vtkIdType numBlocks = (numCells + BlockSize - 1) / BlockSize;
+  std::vector<vtkIdType> blockCells(numBlocks + 1, 0);
+  std::vector<vtkIdType> blockPoints(numBlocks + 1, 0);
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    vtkIdList* cellPts = threadCellPts.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType end = std::min((block + 1) * BlockSize, numCells);
+      for (vtkIdType cellId = block * BlockSize; cellId < end; ++cellId)
+      {
+        if (!keepCells[cellId])
+        {
+          continue;
+        }
+        ++blockCells[block];
+        input->GetCellPoints(cellId, cellPts);
+        for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+          const vtkIdType ptId = cellPts->GetId(i);
+          if (firstCells[ptId].load(std::memory_order_relaxed) == cellId && pointMap[ptId] == -1)
+          {
+            pointMap[ptId] = -2;
+            ++blockPoints[block];
+          }
+        }
+      }
+    }
+  });
+  // The extra last entries receive the totals.
+  vtkSMPTools::ExclusiveScan(
+    blockCells.begin(), blockCells.end(), blockCells.begin(), static_cast<vtkIdType>(0));
+  vtkSMPTools::ExclusiveScan(
+    blockPoints.begin(), blockPoints.end(), blockPoints.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewCells = blockCells[numBlocks];
+  const vtkIdType numNewPts = blockPoints[numBlocks];
+
+  vtkPointData *pd = input->GetPointData(), *outPD = output->GetPointData();
+  vtkCellData *cd = input->GetCellData(), *outCD = output->GetCellData();
+  outPD->CopyAllocate(pd, numNewPts);
+  outCD->CopyAllocate(cd, numNewCells);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, pd, outPD, 0.0, false);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numNewCells, cd, outCD, 0.0, false);
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfValues(numNewCells);
+
+  // Scatter the points, the cell types and the attributes at the offsets of
+  // the blocks. Only the first cell of a point reads and writes its entry of
+  // the point map.
+  std::vector<vtkIdType> cellIds(numNewCells);
+  std::vector<vtkIdType> cellSizes(numNewCells);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    vtkIdList* cellPts = threadCellPts.Local();
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType newCellId = blockCells[block];
+      vtkIdType newPtId = blockPoints[block];
+      const vtkIdType end = std::min((block + 1) * BlockSize, numCells);
+      for (vtkIdType cellId = block * BlockSize; cellId < end; ++cellId)
+      {
+        if (!keepCells[cellId])
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, cellPts);
+        for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+          const vtkIdType ptId = cellPts->GetId(i);
+          if (firstCells[ptId].load(std::memory_order_relaxed) == cellId && pointMap[ptId] == -2)
+          {
+            double x[3];
+            input->GetPoint(ptId, x);
+            newPoints->SetPoint(newPtId, x);
+            pointArrays.Copy(ptId, newPtId);
+            pointMap[ptId] = newPtId++;
+          }
+        }
+        cellTypes->SetValue(newCellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+        cellArrays.Copy(cellId, newCellId);
+        cellIds[newCellId] = cellId;
+        cellSizes[newCellId++] = cellPts->GetNumberOfIds();
+      }
+    }
+  });
+  firstCells.reset();
+
+  auto cellSize = [&](vtkIdType newCellId) { return cellSizes[newCellId]; };
+  auto cellPoints = [&](vtkIdType newCellId, vtkIdType* pts) {
+    vtkIdList* cellPts = threadCellPts.Local();
+    input->GetCellPoints(cellIds[newCellId], cellPts);
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      pts[i] = pointMap[cellPts->GetId(i)];
+    }
+  };
+  vtkNew<vtkCellArray> cells;
+  if (!cells->BuildCells(numNewCells, cellSize, cellPoints))
+  {
+    return false;
+  }
+  output->SetCells(cellTypes, cells);
+  output->SetPoints(newPoints);
+  return true;
+}
+}
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -141,12 +307,10 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
   outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
 
   vtkIdType numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  vtkIdType numCells = input->GetNumberOfCells();
 
   vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::Take(vtkPoints::New());
 
@@ -172,69 +336,58 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
-  newPoints->Allocate(numPts);
-
-  vtkSmartPointer<vtkIdList> pointMap =
-    vtkSmartPointer<vtkIdList>::Take(vtkIdList::New()); // maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (vtkIdType i = 0; i < numPts; i++)
-  {
-    pointMap->SetId(i, -1);
-  }
-
-  vtkSmartPointer<vtkIdList> newCellPts = vtkSmartPointer<vtkIdList>::Take(vtkIdList::New());
-
   // are we using pointScalars?
   int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
   bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
 
   vtkUnsignedCharArray* ghosts = input->GetCellData()->GetGhostArray();
 
-  // Check that the scalars of each cell satisfy the threshold criterion
-  vtkSmartPointer<vtkCellIterator> it =
-    vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
-  vtkIdType numberOfCells = input->GetNumberOfCells();
-  vtkIdType index = 0;
-  const vtkIdType tenth = numberOfCells / 10 + 1;
-  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextCell())
+  // The cells are accessed by several threads: the first calls must be made
+  // from a single thread.
+  vtkSMPThreadLocalObject<vtkIdList> threadCellPts;
+  if (numCells > 0)
   {
-    if (index % tenth == 0)
+    input->GetCellType(0);
+    input->GetCellPoints(0, threadCellPts.Local());
+  }
+
+  // Check in parallel that the scalars of each cell satisfy the threshold
+  // criterion.
+  std::vector<unsigned char> keepCells(numCells, 0);
+  std::atomic<bool> keepsPolyhedra(false);
+  auto classifyCells = [&](vtkIdType begin, vtkIdType end) {
+    if (this->SequentialProcessing || vtkSMPTools::GetSingleThread())
     {
-      this->UpdateProgress(index * 1.0 / numberOfCells);
+      this->CheckAbort();
     }
-    if (ghosts && ghosts->GetValue(index++) & vtkDataSetAttributes::HIDDENCELL)
+    if (this->GetAbortOutput())
     {
-      continue;
+      return;
     }
-
-    int cellType = it->GetCellType();
-    if (cellType == VTK_EMPTY_CELL)
+    vtkIdList* cellPts = threadCellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
     {
-      continue;
-    }
-
-    vtkIdType cellId = it->GetCellId();
-    vtkIdList* cellPts = it->GetPointIds();
-    int numCellPts = it->GetNumberOfPoints();
+      if (ghosts && ghosts->GetValue(cellId) & vtkDataSetAttributes::HIDDENCELL)
+      {
+        continue;
+      }
 
-    int keepCell(0);
-    if (usePointScalars)
-    {
-      if (this->AllScalars)
+      int cellType = input->GetCellType(cellId);
+      if (cellType == VTK_EMPTY_CELL)
       {
-        keepCell = 1;
-        for (int i = 0; keepCell && (i < numCellPts); i++)
-        {
-          vtkIdType ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents(inScalars, ptId);
-        }
+        continue;
       }
-      else
+
+      input->GetCellPoints(cellId, cellPts);
+      int numCellPts = cellPts->GetNumberOfIds();
+
+      int keepCell(0);
+      if (usePointScalars)
       {
-        if (!this->UseContinuousCellRange)
+        if (this->AllScalars)
         {
-          keepCell = 0;
-          for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+          keepCell = 1;
+          for (int i = 0; keepCell && (i < numCellPts); i++)
           {
             vtkIdType ptId = cellPts->GetId(i);
             keepCell = this->EvaluateComponents(inScalars, ptId);
@@ -242,51 +395,128 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
         }
         else
         {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          if (!this->UseContinuousCellRange)
+          {
+            keepCell = 0;
+            for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+            {
+              vtkIdType ptId = cellPts->GetId(i);
+              keepCell = this->EvaluateComponents(inScalars, ptId);
+            }
+          }
+          else
+          {
+            keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          }
         }
       }
-    }
-    else // use cell scalars
-    {
-      keepCell = this->EvaluateComponents(inScalars, cellId);
-    }
+      else // use cell scalars
+      {
+        keepCell = this->EvaluateComponents(inScalars, cellId);
+      }
 
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
+      // Invert the keep flag if the Invert option is enabled.
+      keepCell = this->Invert ? (1 - keepCell) : keepCell;
 
-    if (numCellPts > 0 && keepCell)
-    {
       // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (vtkIdType i = 0; i < numCellPts; i++)
+      if (numCellPts > 0 && keepCell)
       {
-        vtkIdType ptId = cellPts->GetId(i);
-        vtkIdType newId = pointMap->GetId(ptId);
-        if (newId < 0)
+        keepCells[cellId] = 1;
+        if (cellType == VTK_POLYHEDRON)
         {
-          double x[3];
-          input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId, newId);
-          outPD->CopyData(pd, ptId, newId);
+          keepsPolyhedra = true;
         }
-        newCellPts->InsertId(i, newId);
       }
-      // special handling for polyhedron cells
-      if (cellType == VTK_POLYHEDRON)
+    }
+  };
+  if (this->SequentialProcessing)
+  {
+    classifyCells(0, numCells);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numCells, classifyCells);
+  }
+  if (this->GetAbortOutput())
+  {
+    return 1;
+  }
+  this->UpdateProgress(0.5);
+
+  // Assemble the output in parallel, unless it has polyhedra, whose faces are
+  // inserted one cell at a time, or arrays that threads cannot write.
+  if (!this->SequentialProcessing && !keepsPolyhedra && ArrayList::CanProcessInParallel(pd) &&
+    ArrayList::CanProcessInParallel(cd))
+  {
+    if (!::AssembleInParallel(input, keepCells, threadCellPts, newPoints, output))
+    {
+      vtkErrorMacro(<< "Unable to allocate the output cells.");
+      output->Initialize();
+      return 0;
+    }
+    vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " number of cells.");
+    return 1;
+  }
+
+  outPD->CopyAllocate(pd);
+  outCD->CopyAllocate(cd);
+  output->Allocate(numCells);
+  newPoints->Allocate(numPts);
+
+  vtkSmartPointer<vtkIdList> pointMap =
+    vtkSmartPointer<vtkIdList>::Take(vtkIdList::New()); // maps old point ids into new
+  pointMap->SetNumberOfIds(numPts);
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    pointMap->SetId(i, -1);
+  }
+
+  vtkSmartPointer<vtkIdList> newCellPts = vtkSmartPointer<vtkIdList>::Take(vtkIdList::New());
+
+  // Copy the cells satisfying the threshold criterion
+  vtkSmartPointer<vtkCellIterator> it =
+    vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextCell())
+  {
+    vtkIdType cellId = it->GetCellId();
+    if (!keepCells[cellId])
+    {
+      continue;
+    }
+
+    int cellType = it->GetCellType();
+    vtkIdList* cellPts = it->GetPointIds();
+    int numCellPts = it->GetNumberOfPoints();
+
+    for (vtkIdType i = 0; i < numCellPts; i++)
+    {
+      vtkIdType ptId = cellPts->GetId(i);
+      vtkIdType newId = pointMap->GetId(ptId);
+      if (newId < 0)
       {
-        newCellPts->Reset();
-        vtkIdList* faces = it->GetFaces();
-        for (vtkIdType j = 0; j < faces->GetNumberOfIds(); ++j)
-        {
-          newCellPts->InsertNextId(faces->GetId(j));
-        }
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(newCellPts, pointMap->GetPointer(0));
+        double x[3];
+        input->GetPoint(ptId, x);
+        newId = newPoints->InsertNextPoint(x);
+        pointMap->SetId(ptId, newId);
+        outPD->CopyData(pd, ptId, newId);
       }
-      vtkIdType newCellId = output->InsertNextCell(it->GetCellType(), newCellPts);
-      outCD->CopyData(cd, cellId, newCellId);
+      newCellPts->InsertId(i, newId);
+    }
+    // special handling for polyhedron cells
+    if (cellType == VTK_POLYHEDRON)
+    {
       newCellPts->Reset();
-    } // satisfied thresholding
-  }   // for all cells
+      vtkIdList* faces = it->GetFaces();
+      for (vtkIdType j = 0; j < faces->GetNumberOfIds(); ++j)
+      {
+        newCellPts->InsertNextId(faces->GetId(j));
+      }
+      vtkUnstructuredGrid::ConvertFaceStreamPointIds(newCellPts, pointMap->GetPointer(0));
+    }
+    vtkIdType newCellId = output->InsertNextCell(cellType, newCellPts);
+    outCD->CopyData(cd, cellId, newCellId);
+    newCellPts->Reset();
+  } // for all cells
 
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " number of cells.");
 
@@ -479,4 +709,6 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Upper Threshold: " << this->UpperThreshold << "\n";
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: " << this->UseContinuousCellRange << endl;
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On" : "Off")
+     << endl;
 }
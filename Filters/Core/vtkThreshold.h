@@ -30,6 +30,12 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The cells are evaluated, and the output assembled, in parallel using
+ * vtkSMPTools unless SequentialProcessing is on. The output does not depend
+ * on the number of threads and is the same as a sequential execution. Inputs
+ * with polyhedra, or with bit, string or non-contiguous attribute arrays, are
+ * assembled sequentially.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
  */
@@ -188,6 +194,17 @@ public:
   vtkBooleanMacro(Invert, bool);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the cells. By default,
+   * sequential processing is off: the cells are evaluated and the output is
+   * assembled concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -234,6 +251,7 @@ protected:
   int ComponentMode = VTK_COMPONENT_MODE_USE_SELECTED;
   int SelectedComponent = 0;
   int OutputPointsPrecision = DEFAULT_PRECISION;
+  vtkTypeBool SequentialProcessing = false;
 
   int (vtkThreshold::*ThresholdFunction)(double s) const = &vtkThreshold::Between;
 
@@ -12,20 +12,32 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkTubeFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkTubeFilter);
 
@@ -82,6 +94,68 @@ struct IdPointsEqual
   vtkPoints* Points;
 };
 
+// Copies the tuples sourceIds[i] of the input attributes to the tuples i of
+// the output attributes, which must have been allocated with CopyAllocate().
+void CopyAttributes(vtkDataSetAttributes* in, vtkDataSetAttributes* out,
+  const std::vector<vtkIdType>& sourceIds, bool sequential)
+{
+  if (!sequential)
+  {
+    ArrayList::CopyAttributes(in, out, sourceIds);
+    return;
+  }
+  for (vtkIdType id = 0; id < static_cast<vtkIdType>(sourceIds.size()); ++id)
+  {
+    out->CopyData(in, sourceIds[id], id);
+  }
+}
+
+// Computes the sliding normals of a single polyline, independently of the
+// other polylines sharing its points.
+struct LineNormalsGenerator
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Line;
+  vtkSmartPointer<vtkFloatArray> Normals;
+  std::unordered_map<vtkIdType, vtkIdType> LastOccurrence;
+
+  void Generate(vtkPoints* inPts, vtkIdType npts, const vtkIdType* pts, double* normals)
+  {
+    if (!this->Points)
+    {
+      this->Points = vtkSmartPointer<vtkPoints>::New();
+      this->Points->SetDataTypeToDouble();
+      this->Line = vtkSmartPointer<vtkCellArray>::New();
+      this->Normals = vtkSmartPointer<vtkFloatArray>::New();
+      this->Normals->SetNumberOfComponents(3);
+    }
+    this->Points->SetNumberOfPoints(npts);
+    this->Normals->SetNumberOfTuples(npts);
+    this->Line->Reset();
+    this->Line->InsertNextCell(static_cast<int>(npts));
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      double x[3];
+      inPts->GetPoint(pts[j], x);
+      this->Points->SetPoint(j, x);
+      this->Line->InsertCellPoint(j);
+    }
+    vtkPolyLine::GenerateSlidingNormals(this->Points, this->Line, this->Normals);
+    // The normals used to be stored per input point, so a point repeated in
+    // the polyline, such as the closing point of a loop, takes the normal of
+    // its last occurrence.
+    this->LastOccurrence.clear();
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      this->LastOccurrence[pts[j]] = j;
+    }
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      this->Normals->GetTuple(this->LastOccurrence[pts[j]], normals + 3 * j);
+    }
+  }
+};
+
 }
 
 int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
@@ -109,17 +183,10 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType numLines;
   vtkIdType numNewPts, numNewCells;
   vtkPoints* newPts;
-  int deleteNormals = 0;
   vtkFloatArray* newNormals;
-  vtkIdType i;
   double range[2], maxSpeed = 0;
   vtkCellArray* newStrips;
-  vtkIdType npts = 0;
-  const vtkIdType* ptsOrig = nullptr;
-  vtkIdType offset = 0;
   vtkFloatArray* newTCoords = nullptr;
-  int abort = 0;
-  vtkIdType inCellId;
   double oldRadius = 1.0;
 
   // Check input and initialize
@@ -132,66 +199,25 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
-  // Create the geometry and topology
-  numNewPts = numPts * this->NumberOfSides;
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(inPts->GetDataType());
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
-
-  newPts->Allocate(numNewPts);
-  newNormals = vtkFloatArray::New();
-  newNormals->SetName("TubeNormals");
-  newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3 * numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->AllocateEstimate(1, numNewPts);
-  vtkCellArray* singlePolyline = vtkCellArray::New();
-
-  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
-  outPD->CopyNormalsOff();
-  if ((this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
-    this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
-    this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
-  {
-    newTCoords = vtkFloatArray::New();
-    newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
-    outPD->CopyTCoordsOff();
-  }
-  outPD->CopyAllocate(pd, numNewPts);
-
+  // Normals are either given, or computed for each polyline independently,
+  // which allows different polylines to share vertices.
   int generateNormals = 0;
+  vtkSmartPointer<vtkDataArray> normalsHolder;
   if (!(inNormals = pd->GetNormals()) || this->UseDefaultNormal)
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
     if (this->UseDefaultNormal)
     {
-      for (i = 0; i < numPts; i++)
+      normalsHolder = vtkSmartPointer<vtkFloatArray>::New();
+      normalsHolder->SetNumberOfComponents(3);
+      normalsHolder->SetNumberOfTuples(numPts);
+      for (vtkIdType i = 0; i < numPts; i++)
       {
-        inNormals->SetTuple(i, this->DefaultNormal);
+        normalsHolder->SetTuple(i, this->DefaultNormal);
       }
+      inNormals = normalsHolder;
     }
     else
     {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their tubes) calculated independently
       generateNormals = 1;
     }
   }
@@ -224,77 +250,224 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   {
     maxSpeed = inVectors->GetMaxNorm();
   }
+  this->Theta = 2.0 * vtkMath::Pi() / this->NumberOfSides;
+
+  // First pass: remove the degenerate segments of each polyline, compute its
+  // normals and check that it can be tubed. The polylines are copied in
+  // place of their connectivity, with their normals alongside.
+  std::vector<vtkIdType> linePts(inLines->GetNumberOfConnectivityIds());
+  std::vector<double> lineNormals(3 * linePts.size());
+  std::vector<vtkIdType> lineSizes(numLines);
+  vtkSMPThreadLocalObject<vtkIdList> threadIds;
+  vtkSMPThreadLocal<LineNormalsGenerator> threadGenerators;
+  auto checkLines = [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = threadIds.Local();
+    LineNormalsGenerator& generator = threadGenerators.Local();
+    for (vtkIdType lineId = begin; lineId < end; lineId++)
+    {
+      vtkIdType npts;
+      const vtkIdType* ptsOrig;
+      inLines->GetCellAtId(lineId, npts, ptsOrig, ids);
+      const vtkIdType lineOffset = inLines->GetOffset(lineId);
+      vtkIdType* pts = linePts.data() + lineOffset;
+      double* normals = lineNormals.data() + 3 * lineOffset;
+
+      // remove degenerate lines to avoid warnings
+      std::copy(ptsOrig, ptsOrig + npts, pts);
+      npts = static_cast<vtkIdType>(std::unique(pts, pts + npts, IdPointsEqual(inPts)) - pts);
+      lineSizes[lineId] = 0;
+      if (npts < 2)
+      {
+        continue; // skip tubing this polyline
+      }
+
+      if (generateNormals)
+      {
+        generator.Generate(inPts, npts, pts, normals);
+      }
+      else
+      {
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          inNormals->GetTuple(pts[j], normals + 3 * j);
+        }
+      }
+
+      // The tube is not generated if the polyline is bad.
+      lineSizes[lineId] = this->GeneratePolyLinePoints(0, npts, pts, inPts, nullptr, nullptr,
+                            nullptr, inScalars, range, inVectors, maxSpeed, normals)
+        ? npts
+        : -1;
+    }
+  };
+  if (this->SequentialProcessing)
+  {
+    checkLines(0, numLines);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numLines, checkLines);
+  }
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
+  {
+    if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
+    {
+      this->Radius = oldRadius;
+    }
+    return 1;
+  }
+
+  // Offsets of the points and strips of each polyline.
+  const vtkIdType numLineStrips = this->GetNumberOfStrips();
+  std::vector<vtkIdType> pointOffsets(numLines + 1);
+  std::vector<vtkIdType> stripOffsets(numLines + 1);
+  vtkIdType numBadLines = 0;
+  for (vtkIdType lineId = 0; lineId < numLines; lineId++)
+  {
+    const vtkIdType npts = lineSizes[lineId];
+    pointOffsets[lineId + 1] = npts > 0 ? this->ComputeOffset(pointOffsets[lineId], npts)
+                                        : pointOffsets[lineId];
+    stripOffsets[lineId + 1] = stripOffsets[lineId] + (npts > 0 ? numLineStrips : 0);
+    numBadLines += npts < 0;
+  }
+  if (numBadLines > 0)
+  {
+    vtkWarningMacro(<< "Could not generate points for " << numBadLines
+                    << " polylines with coincident points, bad normals or negative radii!");
+  }
+  numNewPts = pointOffsets[numLines];
+  numNewCells = stripOffsets[numLines];
+
+  // Create the geometry and topology
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  newPts->SetNumberOfPoints(numNewPts);
+  newNormals = vtkFloatArray::New();
+  newNormals->SetName("TubeNormals");
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(numNewPts);
+  newStrips = vtkCellArray::New();
+
+  // Point data: copy scalars, vectors, tcoords. Normals are computed here.
+  outPD->CopyNormalsOff();
+  if ((this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
+    this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
+    this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
+  {
+    newTCoords = vtkFloatArray::New();
+    newTCoords->SetNumberOfComponents(2);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    outPD->CopyTCoordsOff();
+  }
+  outPD->CopyAllocate(pd, numNewPts);
 
   // Copy selected parts of cell data; certainly don't want normals
   //
-  numNewCells = inLines->GetNumberOfCells() * this->NumberOfSides + 2;
   outCD->CopyNormalsOff();
   outCD->CopyAllocate(cd, numNewCells);
 
-  //  Create points along each polyline that are connected into NumberOfSides
-  //  triangle strips. Texture coordinates are optionally generated.
+  // Second pass: create points along each polyline that are connected into
+  // NumberOfSides triangle strips. Texture coordinates are optionally
+  // generated.
   //
-  this->Theta = 2.0 * vtkMath::Pi() / this->NumberOfSides;
-  vtkPolyLine* lineNormalGenerator = vtkPolyLine::New();
+  std::vector<vtkIdType> sourcePts(numNewPts);
+  std::vector<vtkIdType> sourceCells(numNewCells);
   // the line cellIds start after the last vert cellId
-  inCellId = input->GetNumberOfVerts();
-  for (inLines->InitTraversal(); inLines->GetNextCell(npts, ptsOrig) && !abort; inCellId++)
-  {
-    this->UpdateProgress((double)inCellId / numLines);
-    abort = this->GetAbortExecute();
-
-    // Make a copy of point indices to avoid modifying input polydata cells
-    // while removing degenerate lines.
-    if (npts < 2)
-    {
-      continue; // skip tubing this polyline
-    }
-    std::vector<vtkIdType> ptsCopy(ptsOrig, ptsOrig + npts);
-    vtkIdType* pts = ptsCopy.data();
-
-    // remove degenerate lines to avoid warnings
-    npts = static_cast<vtkIdType>(std::unique(pts, pts + npts, IdPointsEqual(inPts)) - pts);
-    if (npts < 2)
+  const vtkIdType firstLineCellId = input->GetNumberOfVerts();
+  auto tubeLines = [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType lineId = begin; lineId < end; lineId++)
     {
-      continue; // skip tubing this polyline
+      const vtkIdType npts = lineSizes[lineId];
+      if (npts <= 0)
+      {
+        continue;
+      }
+      const vtkIdType lineOffset = inLines->GetOffset(lineId);
+      const vtkIdType* pts = linePts.data() + lineOffset;
+      const vtkIdType offset = pointOffsets[lineId];
+      this->GeneratePolyLinePoints(offset, npts, pts, inPts, newPts, sourcePts.data(),
+        newNormals, inScalars, range, inVectors, maxSpeed, lineNormals.data() + 3 * lineOffset);
+      if (newTCoords)
+      {
+        this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
+      }
+      std::fill(sourceCells.begin() + stripOffsets[lineId],
+        sourceCells.begin() + stripOffsets[lineId + 1], firstLineCellId + lineId);
     }
+  };
+  if (this->SequentialProcessing)
+  {
+    tubeLines(0, numLines);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numLines, tubeLines);
+  }
 
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+  // The strips of each polyline, including caps.
+  auto lineOfStrip = [&](vtkIdType stripId) {
+    return static_cast<vtkIdType>(
+      std::upper_bound(stripOffsets.begin(), stripOffsets.end(), stripId) -
+      stripOffsets.begin() - 1);
+  };
+  auto stripSize = [&](vtkIdType stripId) {
+    const vtkIdType lineId = lineOfStrip(stripId);
+    return this->GetStripSize(lineSizes[lineId], stripId - stripOffsets[lineId]);
+  };
+  auto stripPoints = [&](vtkIdType stripId, vtkIdType* stripPts) {
+    const vtkIdType lineId = lineOfStrip(stripId);
+    this->GenerateStripIds(
+      pointOffsets[lineId], lineSizes[lineId], stripId - stripOffsets[lineId], stripPts);
+  };
+  bool builtStrips = true;
+  if (this->SequentialProcessing)
+  {
+    newStrips->AllocateEstimate(numNewCells, 2 * (this->NumberOfSides + 1));
+    std::vector<vtkIdType> buffer;
+    for (vtkIdType stripId = 0; stripId < numNewCells; stripId++)
     {
-      singlePolyline->Reset(); // avoid instantiation
-      singlePolyline->InsertNextCell(npts, pts);
-      vtkPolyLine::GenerateSlidingNormals(inPts, singlePolyline, inNormals);
+      buffer.resize(stripSize(stripId));
+      stripPoints(stripId, buffer.data());
+      newStrips->InsertNextCell(static_cast<vtkIdType>(buffer.size()), buffer.data());
     }
-
-    // Generate the points around the polyline. The tube is not stripped
-    // if the polyline is bad.
-    //
-    if (!this->GeneratePoints(offset, npts, pts, inPts, newPts, pd, outPD, newNormals, inScalars,
-          range, inVectors, maxSpeed, inNormals))
+  }
+  else
+  {
+    builtStrips = newStrips->BuildCells(numNewCells, stripSize, stripPoints);
+  }
+  if (!builtStrips)
+  {
+    vtkErrorMacro(<< "Cannot allocate the output strips.");
+    if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
     {
-      vtkWarningMacro(<< "Could not generate points!");
-      continue; // skip tubing this polyline
+      this->Radius = oldRadius;
     }
-
-    // Generate the strips for this polyline (including caps)
-    //
-    this->GenerateStrips(offset, npts, pts, inCellId, cd, outCD, newStrips);
-
-    // Generate the texture coordinates for this polyline
-    //
     if (newTCoords)
     {
-      this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
+      newTCoords->Delete();
     }
-
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset, npts);
-
-  } // for all polylines
-
-  singlePolyline->Delete();
+    newPts->Delete();
+    newStrips->Delete();
+    newNormals->Delete();
+    return 0;
+  }
+  ::CopyAttributes(pd, outPD, sourcePts, this->SequentialProcessing);
+  ::CopyAttributes(cd, outCD, sourceCells, this->SequentialProcessing);
 
   // reset the radius to ite original value if necessary
   if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
@@ -304,11 +477,6 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
 
   // Update ourselves
   //
-  if (deleteNormals)
-  {
-    inNormals->Delete();
-  }
-
   if (newTCoords)
   {
     outPD->SetTCoords(newTCoords);
@@ -323,17 +491,19 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
   return 1;
 }
 
-int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
-  vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
+// Generate the points around the polyline, their normals and the ids of the
+// input points they come from. When newPts is nullptr, only check that the
+// points can be generated.
+int vtkTubeFilter::GeneratePolyLinePoints(vtkIdType offset, vtkIdType npts,
+  const vtkIdType* pts, vtkPoints* inPts, vtkPoints* newPts, vtkIdType* sourceIds,
   vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors,
-  double maxSpeed, vtkDataArray* inNormals)
+  double maxSpeed, const double* normals)
 {
   vtkIdType j;
   int i, k;
@@ -392,12 +562,13 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
       }
     }
 
-    inNormals->GetTuple(pts[j], n);
+    n[0] = normals[3 * j];
+    n[1] = normals[3 * j + 1];
+    n[2] = normals[3 * j + 2];
 
     if (vtkMath::Normalize(sNext) == 0.0)
     {
-      vtkWarningMacro(<< "Coincident points!");
-      return 0;
+      return 0; // coincident points
     }
 
     for (i = 0; i < 3; i++)
@@ -434,9 +605,7 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
     vtkMath::Cross(s, n, w);
     if (vtkMath::Normalize(w) == 0.0)
     {
-      vtkWarningMacro(<< "Bad normal s = " << s[0] << " " << s[1] << " " << s[2] << " n = " << n[0]
-                      << " " << n[1] << " " << n[2]);
-      return 0;
+      return 0; // bad normal
     }
 
     vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
@@ -467,10 +636,13 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
       sFactor = inScalars->GetComponent(pts[j], 0);
       if (sFactor < 0.0)
       {
-        vtkWarningMacro(<< "Scalar value less than zero, skipping line");
-        return 0;
+        return 0; // negative radius
       }
     }
+    if (!newPts)
+    {
+      continue;
+    }
 
     // create points around line
     if (this->SidesShareVertices)
@@ -482,9 +654,9 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
           normal[i] = w[i] * cos((double)k * this->Theta) + nP[i] * sin((double)k * this->Theta);
           s[i] = p[i] + this->Radius * sFactor * normal[i];
         }
-        newPts->InsertPoint(ptId, s);
-        newNormals->InsertTuple(ptId, normal);
-        outPD->CopyData(pd, pts[j], ptId);
+        newPts->SetPoint(ptId, s);
+        newNormals->SetTuple(ptId, normal);
+        sourceIds[ptId] = pts[j];
         ptId++;
       } // for each side
     }
@@ -509,19 +681,19 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
             nP[i] * sin((double)(k + 0.5) * this->Theta);
           s[i] = p[i] + this->Radius * sFactor * normal[i];
         }
-        newPts->InsertPoint(ptId, s);
-        newNormals->InsertTuple(ptId, n_right);
-        outPD->CopyData(pd, pts[j], ptId);
-        newPts->InsertPoint(ptId + 1, s);
-        newNormals->InsertTuple(ptId + 1, n_left);
-        outPD->CopyData(pd, pts[j], ptId + 1);
+        newPts->SetPoint(ptId, s);
+        newNormals->SetTuple(ptId, n_right);
+        sourceIds[ptId] = pts[j];
+        newPts->SetPoint(ptId + 1, s);
+        newNormals->SetTuple(ptId + 1, n_left);
+        sourceIds[ptId + 1] = pts[j];
         ptId += 2;
       } // for each side
     }   // else separate vertices
   }     // for all points in polyline
 
   // Produce end points for cap. They are placed at tail end of points.
-  if (this->Capping)
+  if (this->Capping && newPts)
   {
     int numCapSides = this->NumberOfSides;
     int capIncr = 1;
@@ -535,9 +707,9 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
     for (k = 0; k < numCapSides; k += capIncr)
     {
       newPts->GetPoint(offset + k, s);
-      newPts->InsertPoint(ptId, s);
-      newNormals->InsertTuple(ptId, startCapNorm);
-      outPD->CopyData(pd, pts[0], ptId);
+      newPts->SetPoint(ptId, s);
+      newNormals->SetTuple(ptId, startCapNorm);
+      sourceIds[ptId] = pts[0];
       ptId++;
     }
     // the end cap
@@ -549,9 +721,9 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
     for (k = 0; k < numCapSides; k += capIncr)
     {
       newPts->GetPoint(endOffset + k, s);
-      newPts->InsertPoint(ptId, s);
-      newNormals->InsertTuple(ptId, endCapNorm);
-      outPD->CopyData(pd, pts[npts - 1], ptId);
+      newPts->SetPoint(ptId, s);
+      newNormals->SetTuple(ptId, endCapNorm);
+      sourceIds[ptId] = pts[npts - 1];
       ptId++;
     }
   } // if capping
@@ -559,104 +731,157 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdT
   return 1;
 }
 
-void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
-  const vtkIdType* vtkNotUsed(pts), vtkIdType inCellId, vtkCellData* cd, vtkCellData* outCD,
-  vtkCellArray* newStrips)
+// The number of strips of each tube, including caps.
+vtkIdType vtkTubeFilter::GetNumberOfStrips()
 {
-  vtkIdType i, outCellId;
+  const vtkIdType numSideStrips = (this->NumberOfSides + this->OnRatio - 1) / this->OnRatio;
+  return this->Capping ? numSideStrips + 2 : numSideStrips;
+}
+
+// The number of points of a strip of a tube around npts points.
+vtkIdType vtkTubeFilter::GetStripSize(vtkIdType npts, vtkIdType strip)
+{
+  const vtkIdType numSideStrips = (this->NumberOfSides + this->OnRatio - 1) / this->OnRatio;
+  return strip < numSideStrips ? 2 * npts : this->NumberOfSides;
+}
+
+// Generate the point ids of a strip. The strips along the sides come first,
+// then the caps.
+void vtkTubeFilter::GenerateStripIds(
+  vtkIdType offset, vtkIdType npts, vtkIdType strip, vtkIdType* stripPts)
+{
+  vtkIdType i;
   int k;
-  int i1, i2, i3;
+  vtkIdType i1, i2, i3;
 
-  if (this->SidesShareVertices)
+  const vtkIdType numSideStrips = (this->NumberOfSides + this->OnRatio - 1) / this->OnRatio;
+  if (strip < numSideStrips)
   {
-    for (k = this->Offset; k < (this->NumberOfSides + this->Offset); k += this->OnRatio)
+    k = this->Offset + static_cast<int>(strip) * this->OnRatio;
+    if (this->SidesShareVertices)
     {
       i1 = k % this->NumberOfSides;
       i2 = (k + 1) % this->NumberOfSides;
-      outCellId = newStrips->InsertNextCell(npts * 2);
-      outCD->CopyData(cd, inCellId, outCellId);
       for (i = 0; i < npts; i++)
       {
         i3 = i * this->NumberOfSides;
-        newStrips->InsertCellPoint(offset + i2 + i3);
-        newStrips->InsertCellPoint(offset + i1 + i3);
+        *stripPts++ = offset + i2 + i3;
+        *stripPts++ = offset + i1 + i3;
       }
-    } // for each side of the tube
-  }
-  else
-  {
-    for (k = this->Offset; k < (this->NumberOfSides + this->Offset); k += this->OnRatio)
+    }
+    else
     {
       i1 = 2 * (k % this->NumberOfSides) + 1;
       i2 = 2 * ((k + 1) % this->NumberOfSides);
-      outCellId = newStrips->InsertNextCell(npts * 2);
-      outCD->CopyData(cd, inCellId, outCellId);
       for (i = 0; i < npts; i++)
       {
         i3 = i * 2 * this->NumberOfSides;
-        newStrips->InsertCellPoint(offset + i2 + i3);
-        newStrips->InsertCellPoint(offset + i1 + i3);
+        *stripPts++ = offset + i2 + i3;
+        *stripPts++ = offset + i1 + i3;
       }
-    } // for each side of the tube
+    }
+    return;
   }
 
   // Take care of capping. The caps are n-sided polygons that can be
   // easily triangle stripped.
-  if (this->Capping)
+  vtkIdType startIdx = offset + npts * this->NumberOfSides;
+  if (!this->SidesShareVertices)
   {
-    vtkIdType startIdx = offset + npts * this->NumberOfSides;
-    vtkIdType idx;
-
-    if (!this->SidesShareVertices)
-    {
-      startIdx = offset + 2 * npts * this->NumberOfSides;
-    }
+    startIdx = offset + 2 * npts * this->NumberOfSides;
+  }
 
+  if (strip == numSideStrips)
+  {
     // The start cap
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
-    outCD->CopyData(cd, inCellId, outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx + 1);
+    *stripPts++ = startIdx;
+    *stripPts++ = startIdx + 1;
     for (i1 = this->NumberOfSides - 1, i2 = 2, k = 0; k < (this->NumberOfSides - 2); k++)
     {
       if ((k % 2))
       {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
+        *stripPts++ = startIdx + i2;
         i2++;
       }
       else
       {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
+        *stripPts++ = startIdx + i1;
         i1--;
       }
     }
-
+  }
+  else
+  {
     // The end cap - reversed order to be consistent with normal
     startIdx += this->NumberOfSides;
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
-    outCD->CopyData(cd, inCellId, outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx + this->NumberOfSides - 1);
+    *stripPts++ = startIdx;
+    *stripPts++ = startIdx + this->NumberOfSides - 1;
     for (i1 = this->NumberOfSides - 2, i2 = 1, k = 0; k < (this->NumberOfSides - 2); k++)
     {
       if ((k % 2))
       {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
+        *stripPts++ = startIdx + i1;
         i1--;
       }
       else
       {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
+        *stripPts++ = startIdx + i2;
         i2++;
       }
     }
   }
 }
 
+// Deprecated: tube a single polyline with the normals of inNormals, inserting
+// the points and copying the point data one polyline at a time.
+int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
+  vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
+  vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors,
+  double maxSpeed, vtkDataArray* inNormals)
+{
+  std::vector<double> normals(3 * npts);
+  for (vtkIdType j = 0; j < npts; j++)
+  {
+    inNormals->GetTuple(pts[j], normals.data() + 3 * j);
+  }
+  const vtkIdType numNewPts = this->ComputeOffset(offset, npts);
+  if (newPts->GetNumberOfPoints() < numNewPts)
+  {
+    newPts->SetNumberOfPoints(numNewPts);
+  }
+  if (newNormals->GetNumberOfTuples() < numNewPts)
+  {
+    newNormals->SetNumberOfTuples(numNewPts);
+  }
+  std::vector<vtkIdType> sourceIds(numNewPts);
+  if (!this->GeneratePolyLinePoints(offset, npts, pts, inPts, newPts, sourceIds.data(),
+        newNormals, inScalars, range, inVectors, maxSpeed, normals.data()))
+  {
+    return 0;
+  }
+  for (vtkIdType ptId = offset; ptId < numNewPts; ptId++)
+  {
+    outPD->CopyData(pd, sourceIds[ptId], ptId);
+  }
+  return 1;
+}
+
+// Deprecated: insert the strips of a single polyline and copy its cell data.
+void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
+  const vtkIdType* vtkNotUsed(pts), vtkIdType inCellId, vtkCellData* cd, vtkCellData* outCD,
+  vtkCellArray* newStrips)
+{
+  std::vector<vtkIdType> stripPts;
+  for (vtkIdType strip = 0; strip < this->GetNumberOfStrips(); strip++)
+  {
+    stripPts.resize(this->GetStripSize(npts, strip));
+    this->GenerateStripIds(offset, npts, strip, stripPts.data());
+    const vtkIdType outCellId =
+      newStrips->InsertNextCell(static_cast<vtkIdType>(stripPts.size()), stripPts.data());
+    outCD->CopyData(cd, inCellId, outCellId);
+  }
+}
+
 void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
   vtkPoints* inPts, vtkDataArray* inScalars, vtkFloatArray* newTCoords)
 {
@@ -681,7 +906,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, cons
       for (k = 0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
     }
   }
@@ -697,7 +922,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, cons
       for (k = 0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
 
       xPrev[0] = x[0];
@@ -727,7 +952,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, cons
       for (k = 0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
       xPrev[0] = x[0];
       xPrev[1] = x[1];
@@ -744,13 +969,13 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, cons
     // start cap
     for (ik = 0; ik < this->NumberOfSides; ik++)
     {
-      newTCoords->InsertTuple2(startIdx + ik, 0.0, 0.0);
+      newTCoords->SetTuple2(startIdx + ik, 0.0, 0.0);
     }
 
     // end cap
     for (ik = 0; ik < this->NumberOfSides; ik++)
     {
-      newTCoords->InsertTuple2(startIdx + this->NumberOfSides + ik, tc, 0.0);
+      newTCoords->SetTuple2(startIdx + this->NumberOfSides + ik, tc, 0.0);
     }
   }
 }
@@ -843,4 +1068,6 @@ void vtkTubeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Generate TCoords: " << this->GetGenerateTCoordsAsString() << endl;
   os << indent << "Texture Length: " << this->TextureLength << endl;
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << endl;
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On" : "Off")
+     << endl;
 }
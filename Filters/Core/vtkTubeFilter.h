@@ -35,6 +35,12 @@
  * common use is to combine this filter with vtkStreamTracer to generate
  * streamtubes.
  *
+ * The polylines are tubed concurrently with vtkSMPTools, unless
+ * SequentialProcessing is on. A first pass computes the normals of each
+ * polyline, checks it and counts the points of its tube; a second pass then
+ * generates the points, normals, texture coordinates and strips of all the
+ * tubes in place.
+ *
  * @warning
  * The number of tube sides must be greater than 3. If you wish to use fewer
  * sides (i.e., a ribbon), use vtkRibbonFilter.
@@ -55,6 +61,7 @@
 #ifndef vtkTubeFilter_h
 #define vtkTubeFilter_h
 
+#include "vtkDeprecation.h"      // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
@@ -231,6 +238,17 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the polylines. By
+   * default, sequential processing is off: the polylines are tubed
+   * concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkTubeFilter();
   ~vtkTubeFilter() override = default;
@@ -251,12 +269,24 @@ protected:
   int GenerateTCoords; // control texture coordinate generation
   int OutputPointsPrecision;
   double TextureLength; // this length is mapped to [0,1) texture space
+  vtkTypeBool SequentialProcessing = false;
 
-  // Helper methods
+  // Helper methods. The output of each polyline is written at offsets
+  // computed beforehand, so they are called concurrently for different
+  // polylines.
+  int GeneratePolyLinePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
+    vtkPoints* inPts, vtkPoints* newPts, vtkIdType* sourceIds, vtkFloatArray* newNormals,
+    vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors, double maxSpeed,
+    const double* normals);
+  vtkIdType GetNumberOfStrips();
+  vtkIdType GetStripSize(vtkIdType npts, vtkIdType strip);
+  void GenerateStripIds(vtkIdType offset, vtkIdType npts, vtkIdType strip, vtkIdType* stripPts);
+  VTK_DEPRECATED_IN_9_3_0("Use GeneratePolyLinePoints() instead.")
   int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkPoints* inPts,
     vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD, vtkFloatArray* newNormals,
     vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors, double maxSpeed,
     vtkDataArray* inNormals);
+  VTK_DEPRECATED_IN_9_3_0("Use GenerateStripIds() instead.")
   void GenerateStrips(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkIdType inCellId,
     vtkCellData* cd, vtkCellData* outCD, vtkCellArray* newStrips);
   void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
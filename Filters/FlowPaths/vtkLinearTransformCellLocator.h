@@ -198,6 +198,14 @@ public:
    */
   void ShallowCopy(vtkAbstractCellLocator* locator) override;
 
+  /**
+   * The queries are delegated to the wrapped locator.
+   */
+  bool CanQueryConcurrently() override
+  {
+    return !this->CellLocator || this->CellLocator->CanQueryConcurrently();
+  }
+
 protected:
   vtkLinearTransformCellLocator();
   ~vtkLinearTransformCellLocator() override;
@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBBTreeBatchedQueries.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the batched FindCells() and IntersectWithLines() of vtkOBBTree,
+// whose FindCell() falls back to the dataset and therefore runs serially.
+
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkOBBTree.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+// A block of dim^3 unit hexahedra.
+vtkSmartPointer<vtkUnstructuredGrid> MakeHexahedra(int dim)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= dim; ++k)
+  {
+    for (int j = 0; j <= dim; ++j)
+    {
+      for (int i = 0; i <= dim; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->AllocateExact(dim * dim * dim, 8);
+  const vtkIdType n = dim + 1;
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        const vtkIdType p = i + n * (j + n * k);
+        const vtkIdType hex[8] = { p, p + 1, p + 1 + n, p + n, p + n * n, p + 1 + n * n,
+          p + 1 + n + n * n, p + n + n * n };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+  return grid;
+}
+}
+
+int TestOBBTreeBatchedQueries(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeHexahedra(12);
+  vtkNew<vtkOBBTree> locator;
+  locator->SetDataSet(grid);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkPoints> queries;
+  vtkNew<vtkPoints> ends;
+  queries->SetDataTypeToDouble();
+  ends->SetDataTypeToDouble();
+  for (int i = 0; i < 2000; ++i)
+  {
+    double x[3], y[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      x[c] = random->GetNextRangeValue(-1.0, 13.0);
+      y[c] = random->GetNextRangeValue(-1.0, 13.0);
+    }
+    queries->InsertNextPoint(x);
+    ends->InsertNextPoint(y);
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> pcoords;
+  locator->FindCells(queries, cellIds, pcoords);
+  VTK_TEST_CHECK(cellIds->GetNumberOfIds() == queries->GetNumberOfPoints());
+  vtkNew<vtkGenericCell> cell;
+  double weights[8];
+  int numFound = 0;
+  for (vtkIdType i = 0; i < queries->GetNumberOfPoints(); ++i)
+  {
+    double x[3], pc[3];
+    int subId;
+    queries->GetPoint(i, x);
+    const vtkIdType cellId = locator->FindCell(x, 0.0, cell, subId, pc, weights);
+    VTK_TEST_CHECK(cellIds->GetId(i) == cellId);
+    numFound += cellId >= 0 ? 1 : 0;
+  }
+  VTK_TEST_CHECK(numFound > 0);
+
+  vtkNew<vtkDoubleArray> t;
+  locator->IntersectWithLines(queries, ends, 0.0, cellIds, t);
+  VTK_TEST_CHECK(cellIds->GetNumberOfIds() == queries->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < queries->GetNumberOfPoints(); ++i)
+  {
+    double a[3], b[3], tHit, xHit[3], pc[3];
+    int subId;
+    vtkIdType cellId = -1;
+    queries->GetPoint(i, a);
+    ends->GetPoint(i, b);
+    if (!locator->IntersectWithLine(a, b, 0.0, tHit, xHit, pc, subId, cellId, cell))
+    {
+      cellId = -1;
+      tHit = 0.0;
+    }
+    VTK_TEST_CHECK(cellIds->GetId(i) == cellId);
+    VTK_TEST_CHECK(t->GetValue(i) == tHit);
+  }
+  return EXIT_SUCCESS;
+}
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkDistancePolyDataFilter.h"
 
+#include "vtkAbstractCellLocator.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkImplicitPolyDataDistance.h"
@@ -21,6 +22,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangle.h"
 
@@ -29,6 +31,7 @@
 #define VTK_MAXIMUM_NUMBER_OF_POINTS 216
 
 vtkStandardNewMacro(vtkDistancePolyDataFilter);
+vtkCxxSetObjectMacro(vtkDistancePolyDataFilter, CellLocatorPrototype, vtkAbstractCellLocator);
 
 //------------------------------------------------------------------------------
 vtkDistancePolyDataFilter::vtkDistancePolyDataFilter()
@@ -37,13 +40,17 @@ vtkDistancePolyDataFilter::vtkDistancePolyDataFilter()
   this->NegateDistance = 0;
   this->ComputeSecondDistance = 1;
   this->ComputeCellCenterDistance = 1;
+  this->CellLocatorPrototype = nullptr;
 
   this->SetNumberOfInputPorts(2);
   this->SetNumberOfOutputPorts(2);
 }
 
 //------------------------------------------------------------------------------
-vtkDistancePolyDataFilter::~vtkDistancePolyDataFilter() = default;
+vtkDistancePolyDataFilter::~vtkDistancePolyDataFilter()
+{
+  this->SetCellLocatorPrototype(nullptr);
+}
 
 //------------------------------------------------------------------------------
 int vtkDistancePolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
@@ -89,6 +96,11 @@ void vtkDistancePolyDataFilter::GetPolyDataDistance(vtkPolyData* mesh, vtkPolyDa
   }
 
   vtkImplicitPolyDataDistance* imp = vtkImplicitPolyDataDistance::New();
+  if (this->CellLocatorPrototype)
+  {
+    auto locator = vtk::TakeSmartPointer(this->CellLocatorPrototype->NewInstance());
+    imp->SetLocator(locator);
+  }
   imp->SetInput(src);
 
   // Calculate distance from points.
@@ -164,4 +176,6 @@ void vtkDistancePolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NegateDistance: " << this->NegateDistance << "\n";
   os << indent << "ComputeSecondDistance: " << this->ComputeSecondDistance << "\n";
   os << indent << "ComputeCellCenterDistance: " << this->ComputeCellCenterDistance << "\n";
+  os << indent << "CellLocatorPrototype: "
+     << (this->CellLocatorPrototype ? this->CellLocatorPrototype->GetClassName() : "NULL") << "\n";
 }
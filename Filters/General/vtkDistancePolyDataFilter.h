@@ -40,6 +40,8 @@
 #include "vtkFiltersGeneralModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
+class vtkAbstractCellLocator;
+
 class VTKFILTERSGENERAL_EXPORT vtkDistancePolyDataFilter : public vtkPolyDataAlgorithm
 {
 public:
@@ -98,6 +100,18 @@ public:
   vtkBooleanMacro(ComputeCellCenterDistance, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get the prototype cell locator used to find the closest cells of
+   * each input. (A prototype is used as an object factory to instantiate a
+   * locator for each input.) If no prototype is defined, the default locator
+   * of vtkImplicitPolyDataDistance is used. A vtkBVHCellLocator may be faster
+   * on large inputs.
+   */
+  virtual void SetCellLocatorPrototype(vtkAbstractCellLocator*);
+  vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
+  ///@}
+
 protected:
   vtkDistancePolyDataFilter();
   ~vtkDistancePolyDataFilter() override;
@@ -113,6 +127,7 @@ private:
   vtkTypeBool NegateDistance;
   vtkTypeBool ComputeSecondDistance;
   vtkTypeBool ComputeCellCenterDistance;
+  vtkAbstractCellLocator* CellLocatorPrototype;
 };
 
 #endif
@@ -202,6 +202,12 @@ public:
    */
   void GenerateRepresentation(int level, vtkPolyData* pd) override;
 
+  /**
+   * FindCell() falls back to vtkDataSet::FindCell(), which may build the
+   * search structures of the dataset: the queries run serially.
+   */
+  bool CanQueryConcurrently() override { return false; }
+
 protected:
   vtkOBBTree();
   ~vtkOBBTree() override;
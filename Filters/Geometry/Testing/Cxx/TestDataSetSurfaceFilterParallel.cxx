@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the concurrent extraction of the surface of unstructured grids by
+// vtkDataSetSurfaceFilter with the sequential one: the whole output on a grid
+// of mixed linear cells, the cells on a grid of quadratic cells subdivided at
+// several levels.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Index of a node of a lattice of n^3 points.
+vtkIdType NodeId(int n, int i, int j, int k)
+{
+  return i + n * (j + n * k);
+}
+
+// Adds a lattice of n^3 points with unit spacing, and their distances to the
+// origin as point data.
+void AddLattice(vtkUnstructuredGrid* input, int n)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Distance");
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        const double x[3] = { static_cast<double>(i), static_cast<double>(j),
+          static_cast<double>(k) };
+        points->InsertNextPoint(x);
+        scalars->InsertNextValue(std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]));
+      }
+    }
+  }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+}
+
+// A block of cubes filled with hexahedra, voxels, wedges, pyramids and
+// tetrahedra, one of them hidden, with 0D, 1D and 2D cells on its sides.
+vtkSmartPointer<vtkUnstructuredGrid> MakeLinearInput()
+{
+  const int n = 5;
+  auto input = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  AddLattice(input, n);
+  input->Allocate();
+  for (int k = 0; k < n - 1; ++k)
+  {
+    for (int j = 0; j < n - 1; ++j)
+    {
+      for (int i = 0; i < n - 1; ++i)
+      {
+        vtkIdType c[8];
+        for (int corner = 0; corner < 8; ++corner)
+        {
+          c[corner] = NodeId(n, i + (corner & 1), j + ((corner >> 1) & 1), k + (corner >> 2));
+        }
+        switch ((i + 2 * j + 3 * k) % 5)
+        {
+          case 0:
+          {
+            const vtkIdType hex[8] = { c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] };
+            input->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+            break;
+          }
+          case 1:
+            input->InsertNextCell(VTK_VOXEL, 8, c);
+            break;
+          case 2:
+          {
+            const vtkIdType wedge1[6] = { c[0], c[1], c[2], c[4], c[5], c[6] };
+            const vtkIdType wedge2[6] = { c[1], c[3], c[2], c[5], c[7], c[6] };
+            input->InsertNextCell(VTK_WEDGE, 6, wedge1);
+            input->InsertNextCell(VTK_WEDGE, 6, wedge2);
+            break;
+          }
+          case 3:
+          {
+            const vtkIdType pyramid[5] = { c[0], c[1], c[3], c[2], c[4] };
+            input->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+            break;
+          }
+          default:
+          {
+            const vtkIdType tetra[4] = { c[0], c[1], c[2], c[4] };
+            input->InsertNextCell(VTK_TETRA, 4, tetra);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // Cells on the z=0 side of the block.
+  const vtkIdType triangle[3] = { NodeId(n, 0, 0, 0), NodeId(n, 1, 0, 0), NodeId(n, 0, 1, 0) };
+  input->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  const vtkIdType quad[4] = { NodeId(n, 1, 1, 0), NodeId(n, 2, 1, 0), NodeId(n, 2, 2, 0),
+    NodeId(n, 1, 2, 0) };
+  input->InsertNextCell(VTK_QUAD, 4, quad);
+  const vtkIdType pixel[4] = { NodeId(n, 2, 2, 0), NodeId(n, 3, 2, 0), NodeId(n, 2, 3, 0),
+    NodeId(n, 3, 3, 0) };
+  input->InsertNextCell(VTK_PIXEL, 4, pixel);
+  const vtkIdType strip[5] = { NodeId(n, 0, 3, 0), NodeId(n, 0, 4, 0), NodeId(n, 1, 3, 0),
+    NodeId(n, 1, 4, 0), NodeId(n, 2, 3, 0) };
+  input->InsertNextCell(VTK_TRIANGLE_STRIP, 5, strip);
+  const vtkIdType polygon[5] = { NodeId(n, 3, 0, 0), NodeId(n, 4, 0, 0), NodeId(n, 4, 1, 0),
+    NodeId(n, 4, 2, 0), NodeId(n, 3, 1, 0) };
+  input->InsertNextCell(VTK_POLYGON, 5, polygon);
+  const vtkIdType line[2] = { NodeId(n, 0, 0, 4), NodeId(n, 4, 4, 4) };
+  input->InsertNextCell(VTK_LINE, 2, line);
+  const vtkIdType polyLine[3] = { NodeId(n, 0, 4, 4), NodeId(n, 2, 2, 4), NodeId(n, 4, 0, 4) };
+  input->InsertNextCell(VTK_POLY_LINE, 3, polyLine);
+  const vtkIdType vertex = NodeId(n, 2, 2, 2);
+  input->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  const vtkIdType polyVertex[2] = { NodeId(n, 1, 1, 1), NodeId(n, 3, 3, 3) };
+  input->InsertNextCell(VTK_POLY_VERTEX, 2, polyVertex);
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+    ghosts->InsertNextValue(cellId == 7 ? vtkDataSetAttributes::HIDDENCELL : 0);
+  }
+  input->GetCellData()->AddArray(cellIds);
+  input->GetCellData()->AddArray(ghosts);
+  return input;
+}
+
+// A block of quadratic hexahedra, with quadratic quads on its z=0 face.
+vtkSmartPointer<vtkUnstructuredGrid> MakeQuadraticInput()
+{
+  const int resolution = 4;
+  const int n = 2 * resolution + 1;
+  auto input = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  AddLattice(input, n);
+
+  const int corners[8][3] = { { 0, 0, 0 }, { 2, 0, 0 }, { 2, 2, 0 }, { 0, 2, 0 }, { 0, 0, 2 },
+    { 2, 0, 2 }, { 2, 2, 2 }, { 0, 2, 2 } };
+  const int edges[12][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 },
+    { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  input->Allocate();
+  for (int k = 0; k < resolution; ++k)
+  {
+    for (int j = 0; j < resolution; ++j)
+    {
+      for (int i = 0; i < resolution; ++i)
+      {
+        vtkIdType hex[20];
+        for (int c = 0; c < 8; ++c)
+        {
+          hex[c] =
+            NodeId(n, 2 * i + corners[c][0], 2 * j + corners[c][1], 2 * k + corners[c][2]);
+        }
+        for (int e = 0; e < 12; ++e)
+        {
+          const int* a = corners[edges[e][0]];
+          const int* b = corners[edges[e][1]];
+          hex[8 + e] = NodeId(n, 2 * i + (a[0] + b[0]) / 2, 2 * j + (a[1] + b[1]) / 2,
+            2 * k + (a[2] + b[2]) / 2);
+        }
+        cellIds->InsertNextValue(input->InsertNextCell(VTK_QUADRATIC_HEXAHEDRON, 20, hex));
+        if (k == 0)
+        {
+          const vtkIdType quad[8] = { hex[0], hex[1], hex[2], hex[3], hex[8], hex[9], hex[10],
+            hex[11] };
+          cellIds->InsertNextValue(input->InsertNextCell(VTK_QUADRATIC_QUAD, 8, quad));
+        }
+      }
+    }
+  }
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+// The cells of the output, as their input cell id followed by the sorted
+// coordinates of their points, rounded to 1e-6.
+std::vector<std::vector<long long>> GetCellKeys(vtkPolyData* output)
+{
+  std::vector<std::vector<long long>> keys;
+  vtkDataArray* cellIds = output->GetCellData()->GetArray("CellIds");
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ids);
+    std::vector<std::array<long long, 3>> points;
+    for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+    {
+      double x[3];
+      output->GetPoint(ids->GetId(i), x);
+      points.push_back({ std::llround(x[0] * 1e6), std::llround(x[1] * 1e6),
+        std::llround(x[2] * 1e6) });
+    }
+    std::sort(points.begin(), points.end());
+    std::vector<long long> key(1, static_cast<long long>(cellIds->GetComponent(cellId, 0)));
+    for (const auto& x : points)
+    {
+      key.insert(key.end(), x.begin(), x.end());
+    }
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+int TestLinearCells()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> input = MakeLinearInput();
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->DelegationOff();
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+
+  // The sequential processing is the default.
+  VTK_TEST_CHECK(surface->GetSequentialProcessing());
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(surface.GetPointer()));
+  vtkPolyData* output = surface->GetOutput();
+  VTK_TEST_CHECK(output->GetNumberOfPolys() > 0 && output->GetNumberOfLines() > 0 &&
+    output->GetNumberOfVerts() > 0);
+  return EXIT_SUCCESS;
+}
+
+int TestQuadraticCells()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> input = MakeQuadraticInput();
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  for (int level = 0; level < 4; ++level)
+  {
+    surface->SetNonlinearSubdivisionLevel(level);
+    surface->SequentialProcessingOn();
+    surface->Update();
+    vtkNew<vtkPolyData> sequential;
+    sequential->DeepCopy(surface->GetOutput());
+    VTK_TEST_CHECK(sequential->GetNumberOfPolys() > 0);
+
+    surface->SequentialProcessingOff();
+    surface->Update();
+    vtkPolyData* output = surface->GetOutput();
+    VTK_TEST_CHECK(output->GetNumberOfPoints() == sequential->GetNumberOfPoints());
+    VTK_TEST_CHECK(output->GetNumberOfPolys() == sequential->GetNumberOfPolys());
+    VTK_TEST_CHECK(GetCellKeys(output) == GetCellKeys(sequential));
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestDataSetSurfaceFilterParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  VTK_TEST_CHECK(TestLinearCells() == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestQuadraticCells() == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
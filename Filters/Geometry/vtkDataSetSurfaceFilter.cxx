@@ -15,6 +15,7 @@
 
 #include "vtkDataSetSurfaceFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkBezierCurve.h"
 #include "vtkBezierQuadrilateral.h"
 #include "vtkBezierTriangle.h"
@@ -41,6 +42,8 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredData.h"
@@ -58,10 +61,14 @@
 #include "vtkWedge.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -295,6 +302,22 @@ bool StructuredExecuteWithBlanking(
   return true;
 }
 
+// Whether the grid has Bezier cells, whose rational weights make their
+// points depend on the cell they are taken from.
+bool HasBezierCells(vtkUnstructuredGrid* input)
+{
+  vtkUnsignedCharArray* types = input->GetDistinctCellTypesArray();
+  for (vtkIdType i = 0; i < types->GetNumberOfValues(); ++i)
+  {
+    const unsigned char type = types->GetValue(i);
+    if (type >= VTK_BEZIER_CURVE && type <= VTK_BEZIER_PYRAMID)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 }
 
 class vtkDataSetSurfaceFilter::vtkEdgeInterpolationMap
@@ -364,6 +387,7 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->NonlinearSubdivisionLevel = 1;
 
   this->Delegation = false;
+  this->SequentialProcessing = true;
 }
 
 //------------------------------------------------------------------------------
@@ -1285,6 +1309,7 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NonlinearSubdivisionLevel: " << this->GetNonlinearSubdivisionLevel() << endl;
   os << indent << "FastMode: " << this->GetFastMode() << endl;
   os << indent << "Delegation: " << this->GetDelegation() << endl;
+  os << indent << "SequentialProcessing: " << this->GetSequentialProcessing() << endl;
 }
 
 //========================================================================
@@ -1340,6 +1365,10 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(
   }
 
   // If here, the data is gnarly and this filter will process it.
+  if (!this->SequentialProcessing && !HasBezierCells(input))
+  {
+    return this->UnstructuredGridExecuteConcurrently(input, output, !handleSubdivision);
+  }
   vtkSmartPointer<vtkCellIterator> cellIter =
     vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
 
@@ -2244,6 +2273,1088 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
   return 1;
 }
 
+//------------------------------------------------------------------------------
+namespace
+{ // anonymous namespace
+
+// Number of cells, or boundary faces, processed by a thread at once when an
+// unstructured grid is processed concurrently.
+constexpr vtkIdType VTK_SURFACE_PIECE_SIZE = 1024;
+
+// A point generated by the subdivision of a nonlinear cell, or of the face
+// FaceId of a nonlinear 3D cell, at the given parametric coordinates. The
+// points generated by the subdivision of the triangles are shared by the
+// cells generating them from the same corners, as the sequential execution
+// shares them along the edges, and inside the triangles of a 2D cell and of
+// the coincident face of a 3D cell: Key[0..2] are then these corners, sorted
+// and padded with -1, and Key[3..5] the barycentric coordinates of the point,
+// in units of the finest subdivision. Key[0] is -1 for the other points.
+struct SurfaceNewPoint
+{
+  vtkIdType CellId;
+  int FaceId;
+  double PCoords[3];
+  std::array<vtkIdType, 6> Key;
+};
+
+// A face of a 3D cell. Its points start with the smallest id, as in the quad
+// hash. The faces of the nonlinear cells are given by their corners and by
+// their index FaceId in the cell; FaceId is -1 for linear faces. Hidden
+// faces are matched with the others but not extracted.
+struct SurfaceFace
+{
+  vtkIdType CellId;
+  vtkIdType Offset;
+  int NumberOfPoints;
+  int FaceId;
+  bool Hidden;
+};
+
+// The verts (0), lines (1) and polys (2) generated by a piece of cells or of
+// boundary faces, with the cell each of them comes from. A point reference
+// is either an input point id, or -(i + 1) for the point i of NewPoints.
+struct SurfacePiece
+{
+  std::vector<vtkIdType> Sizes[3];
+  std::vector<vtkIdType> Refs[3];
+  std::vector<vtkIdType> Sources[3];
+  std::vector<SurfaceNewPoint> NewPoints;
+  std::vector<SurfaceFace> Faces;
+  std::vector<vtkIdType> FacePoints;
+
+  void AddCell(int type, vtkIdType npts, const vtkIdType* refs, vtkIdType cellId)
+  {
+    this->Sizes[type].push_back(npts);
+    this->Refs[type].insert(this->Refs[type].end(), refs, refs + npts);
+    this->Sources[type].push_back(cellId);
+  }
+
+  vtkIdType AddNewPoint(vtkIdType cellId, int faceId, const double pcoords[3],
+    const std::array<vtkIdType, 6>& key = { { -1, -1, -1, 0, 0, 0 } })
+  {
+    this->NewPoints.push_back({ cellId, faceId, { pcoords[0], pcoords[1], pcoords[2] }, key });
+    return -static_cast<vtkIdType>(this->NewPoints.size());
+  }
+
+  void AddFace(vtkIdType cellId, int faceId, bool hidden, vtkIdType npts, const vtkIdType* ids)
+  {
+    vtkIdType first = 0;
+    for (vtkIdType i = 1; i < npts; ++i)
+    {
+      if (ids[i] < ids[first])
+      {
+        first = i;
+      }
+    }
+    this->Faces.push_back({ cellId, static_cast<vtkIdType>(this->FacePoints.size()),
+      static_cast<int>(npts), faceId, hidden });
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      this->FacePoints.push_back(ids[(first + i) % npts]);
+    }
+  }
+};
+
+// A vertex of the subdivision of a triangle of a nonlinear cell, with its
+// barycentric coordinates in the triangle (in units of the finest
+// subdivision) and its parametric coordinates in the cell.
+struct SubdivisionVertex
+{
+  vtkIdType Ref;
+  vtkIdType Bary[3];
+  double PCoords[3];
+};
+
+// Objects used by a thread to process its pieces.
+struct SurfaceThreadData
+{
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkIdList> PointIds;
+  vtkSmartPointer<vtkIdList> TriangleIds;
+  vtkSmartPointer<vtkPoints> TriangleCoords;
+  std::vector<vtkIdType> Refs;
+  std::vector<double> Weights;
+  std::vector<SubdivisionVertex> Triangles;
+  std::vector<SubdivisionVertex> SubTriangles;
+  // The subdivision points of the cells of the current piece, by key.
+  std::map<std::array<vtkIdType, 6>, vtkIdType> SubdivisionPoints;
+  // The cell, or face, whose points are being evaluated.
+  vtkCell* CurrentCell = nullptr;
+  vtkIdType CurrentCellId = -1;
+  int CurrentFaceId = -1;
+
+  void Initialize()
+  {
+    if (!this->Cell)
+    {
+      this->Cell = vtkSmartPointer<vtkGenericCell>::New();
+      this->PointIds = vtkSmartPointer<vtkIdList>::New();
+      this->TriangleIds = vtkSmartPointer<vtkIdList>::New();
+      this->TriangleCoords = vtkSmartPointer<vtkPoints>::New();
+    }
+    this->CurrentCellId = -1;
+  }
+
+  vtkCell* GetCell(vtkUnstructuredGrid* input, vtkIdType cellId, int faceId)
+  {
+    if (cellId != this->CurrentCellId || faceId != this->CurrentFaceId)
+    {
+      input->GetCell(cellId, this->Cell);
+      input->SetCellOrderAndRationalWeights(cellId, this->Cell);
+      this->CurrentCell = faceId < 0 ? this->Cell->GetRepresentativeCell()
+                                     : this->Cell->GetFace(faceId);
+      this->CurrentCellId = cellId;
+      this->CurrentFaceId = faceId;
+    }
+    return this->CurrentCell;
+  }
+};
+
+// Whether one of the points is hidden (meaning invalid).
+bool HasHiddenPoint(vtkUnsignedCharArray* ghosts, vtkIdType npts, const vtkIdType* ids)
+{
+  if (ghosts)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      if (ghosts->GetValue(ids[i]) & vtkDataSetAttributes::HIDDENPOINT)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Number of points of the linear cell a nonlinear 2D cell is extracted as
+// when it is not subdivided, or 0 if it is triangulated anyway.
+int GetLinearizedSize(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_QUADRATIC_TRIANGLE:
+    case VTK_LAGRANGE_TRIANGLE:
+    case VTK_BEZIER_TRIANGLE:
+      return 3;
+    case VTK_QUADRATIC_QUAD:
+    case VTK_BIQUADRATIC_QUAD:
+    case VTK_QUADRATIC_LINEAR_QUAD:
+    case VTK_LAGRANGE_QUADRILATERAL:
+    case VTK_BEZIER_QUADRILATERAL:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// Adds the faces of the common linear 3D cells, as the quad hash does.
+// Returns false for the other cell types.
+bool AddLinearCellFaces(
+  int cellType, const vtkIdType* ids, vtkIdType cellId, bool hidden, SurfacePiece& piece)
+{
+  static const int hexFaces[6][4] = { { 0, 1, 5, 4 }, { 0, 3, 2, 1 }, { 0, 4, 7, 3 },
+    { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 4, 5, 6, 7 } };
+  static const int voxelFaces[6][4] = { { 0, 1, 5, 4 }, { 0, 2, 3, 1 }, { 0, 4, 6, 2 },
+    { 1, 3, 7, 5 }, { 2, 6, 7, 3 }, { 4, 5, 7, 6 } };
+  static const int tetraFaces[4][3] = { { 0, 1, 3 }, { 0, 2, 1 }, { 0, 3, 2 }, { 1, 2, 3 } };
+  static const int pyramidFaces[5][4] = { { 3, 2, 1, 0 }, { 0, 1, 4, -1 }, { 1, 2, 4, -1 },
+    { 2, 3, 4, -1 }, { 3, 0, 4, -1 } };
+  static const int wedgeFaces[5][4] = { { 0, 2, 5, 3 }, { 1, 0, 3, 4 }, { 2, 1, 4, 5 },
+    { 0, 1, 2, -1 }, { 3, 5, 4, -1 } };
+
+  auto addFaces = [&](const int* faces, int numFaces, int maxFacePts) {
+    for (int face = 0; face < numFaces; ++face)
+    {
+      const int* facePts = faces + face * maxFacePts;
+      vtkIdType faceIds[4];
+      int npts = 0;
+      for (; npts < maxFacePts && facePts[npts] >= 0; ++npts)
+      {
+        faceIds[npts] = ids[facePts[npts]];
+      }
+      piece.AddFace(cellId, -1, hidden, npts, faceIds);
+    }
+  };
+  // The side quads of the prisms, then their bases.
+  auto addPrismFaces = [&](int numSides) {
+    for (int side = 0; side < numSides; ++side)
+    {
+      const int next = (side + 1) % numSides;
+      const vtkIdType faceIds[4] = { ids[side], ids[next], ids[next + numSides],
+        ids[side + numSides] };
+      piece.AddFace(cellId, -1, hidden, 4, faceIds);
+    }
+    piece.AddFace(cellId, -1, hidden, numSides, ids);
+    piece.AddFace(cellId, -1, hidden, numSides, ids + numSides);
+  };
+
+  switch (cellType)
+  {
+    case VTK_HEXAHEDRON:
+      addFaces(hexFaces[0], 6, 4);
+      return true;
+    case VTK_VOXEL:
+      addFaces(voxelFaces[0], 6, 4);
+      return true;
+    case VTK_TETRA:
+      addFaces(tetraFaces[0], 4, 3);
+      return true;
+    case VTK_PYRAMID:
+      addFaces(pyramidFaces[0], 5, 4);
+      return true;
+    case VTK_WEDGE:
+      addFaces(wedgeFaces[0], 5, 4);
+      return true;
+    case VTK_PENTAGONAL_PRISM:
+      addPrismFaces(5);
+      return true;
+    case VTK_HEXAGONAL_PRISM:
+      addPrismFaces(6);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Adds a curve of the given subdivision level, as a polyline going through
+// the points of the curve.
+void AddNonlinearCurve(
+  vtkIdType cellId, vtkIdType npts, const vtkIdType* ids, int level, SurfacePiece& piece,
+  SurfaceThreadData& data)
+{
+  std::vector<vtkIdType>& refs = data.Refs;
+  refs.clear();
+  refs.push_back(ids[0]);
+  if (level == 1)
+  {
+    refs.insert(refs.end(), ids + 2, ids + npts);
+  }
+  else if (level > 1)
+  {
+    const vtkIdType numDeltaPts = static_cast<vtkIdType>(1) << (level - 1);
+    const double paramCoordDelta = 1. / (numDeltaPts * (npts - 1));
+    for (vtkIdType i = 0; i < npts - 1; ++i)
+    {
+      for (vtkIdType j = 0; j < numDeltaPts - 1; ++j)
+      {
+        const double pcoords[3] = { paramCoordDelta * (numDeltaPts * i + j + 1), 0., 0. };
+        refs.push_back(piece.AddNewPoint(cellId, -1, pcoords));
+      }
+      if (i < npts - 2)
+      {
+        refs.push_back(ids[2 + i]);
+      }
+    }
+  }
+  refs.push_back(ids[1]);
+  piece.AddCell(1, static_cast<vtkIdType>(refs.size()), refs.data(), cellId);
+}
+
+// Returns the reference of the point of the subdivision of the triangle
+// whose corners are given, creating it on first use.
+vtkIdType GetSubdivisionPointRef(const SubdivisionVertex& vertex, const vtkIdType* corners,
+  vtkIdType cellId, int faceId, SurfacePiece& piece, SurfaceThreadData& data)
+{
+  // The corners the point depends on, sorted, and its coordinates for them.
+  std::array<vtkIdType, 6> key = { { -1, -1, -1, 0, 0, 0 } };
+  int numCorners = 0;
+  for (int c = 0; c < 3; ++c)
+  {
+    if (vertex.Bary[c] != 0)
+    {
+      int i = numCorners++;
+      for (; i > 0 && corners[c] < key[i - 1]; --i)
+      {
+        key[i] = key[i - 1];
+        key[i + 3] = key[i + 2];
+      }
+      key[i] = corners[c];
+      key[i + 3] = vertex.Bary[c];
+    }
+  }
+  auto found = data.SubdivisionPoints.find(key);
+  if (found != data.SubdivisionPoints.end())
+  {
+    return found->second;
+  }
+  const vtkIdType ref = piece.AddNewPoint(cellId, faceId, vertex.PCoords, key);
+  data.SubdivisionPoints.emplace(key, ref);
+  return ref;
+}
+
+// Adds the triangles of a nonlinear 2D cell, or face, subdivided at the given
+// level (at least 1) in the same way as the sequential execution.
+void AddNonlinearPolygon(vtkCell* cell, vtkIdType cellId, int faceId, int level,
+  SurfacePiece& piece, SurfaceThreadData& data)
+{
+  vtkIdList* pts = data.TriangleIds;
+  cell->Triangulate(0, pts, data.TriangleCoords);
+  const vtkIdType numIds = pts->GetNumberOfIds() / 3 * 3;
+  const double* pc = cell->GetParametricCoords();
+  if (level < 2 || !pc)
+  {
+    for (vtkIdType i = 0; i < numIds; i += 3)
+    {
+      piece.AddCell(2, 3, pts->GetPointer(i), cellId);
+    }
+    return;
+  }
+
+  //       * 0
+  //      / \        Each triangle is split in the 4
+  //     /   \       triangles shown here, 3, 4 and 5
+  //  3 *-----* 5    being the middles of the edges
+  //   / \   / \     (0,1), (1,2) and (2,0).
+  //  /   \ /   \    .
+  // *-----*-----*
+  // 1     4     2
+  static const int subtriangles[12] = { 0, 3, 5, 3, 1, 4, 3, 4, 5, 5, 4, 2 };
+  const vtkIdType numSubdivisions = static_cast<vtkIdType>(1) << (level - 1);
+  for (vtkIdType triangle = 0; triangle < numIds; triangle += 3)
+  {
+    const vtkIdType* corners = pts->GetPointer(triangle);
+    data.Triangles.resize(3);
+    for (int k = 0; k < 3; ++k)
+    {
+      SubdivisionVertex& vertex = data.Triangles[k];
+      vertex.Ref = corners[k];
+      vertex.Bary[0] = vertex.Bary[1] = vertex.Bary[2] = 0;
+      vertex.Bary[k] = numSubdivisions;
+      vtkIdType cellPtId = 0;
+      while (cell->GetPointId(cellPtId) != corners[k])
+      {
+        ++cellPtId;
+      }
+      std::copy(pc + 3 * cellPtId, pc + 3 * cellPtId + 3, vertex.PCoords);
+    }
+    for (int subdivision = 1; subdivision < level; ++subdivision)
+    {
+      data.SubTriangles.clear();
+      for (size_t i = 0; i < data.Triangles.size(); i += 3)
+      {
+        SubdivisionVertex v[6];
+        std::copy(data.Triangles.begin() + i, data.Triangles.begin() + i + 3, v);
+        for (int k = 3; k < 6; ++k)
+        {
+          const SubdivisionVertex& v1 = v[k - 3];
+          const SubdivisionVertex& v2 = v[k < 5 ? k - 2 : 0];
+          for (int c = 0; c < 3; ++c)
+          {
+            v[k].Bary[c] = (v1.Bary[c] + v2.Bary[c]) / 2;
+            v[k].PCoords[c] = 0.5 * (v1.PCoords[c] + v2.PCoords[c]);
+          }
+          v[k].Ref = GetSubdivisionPointRef(v[k], corners, cellId, faceId, piece, data);
+        }
+        for (int k : subtriangles)
+        {
+          data.SubTriangles.push_back(v[k]);
+        }
+      }
+      std::swap(data.Triangles, data.SubTriangles);
+    }
+    for (size_t i = 0; i < data.Triangles.size(); i += 3)
+    {
+      const vtkIdType refs[3] = { data.Triangles[i].Ref, data.Triangles[i + 1].Ref,
+        data.Triangles[i + 2].Ref };
+      piece.AddCell(2, 3, refs, cellId);
+    }
+  }
+}
+
+// Compares the faces as the quad hash matches them: same number of points,
+// and the same points in the same or in the opposite order.
+int CompareFaces(const SurfaceFace& face1, const SurfaceFace& face2, const vtkIdType* facePoints)
+{
+  const int npts = face1.NumberOfPoints;
+  if (npts != face2.NumberOfPoints)
+  {
+    return npts < face2.NumberOfPoints ? -1 : 1;
+  }
+  const vtkIdType* pts1 = facePoints + face1.Offset;
+  const vtkIdType* pts2 = facePoints + face2.Offset;
+  const bool reversed1 = npts > 2 && pts1[npts - 1] < pts1[1];
+  const bool reversed2 = npts > 2 && pts2[npts - 1] < pts2[1];
+  for (int i = 0; i < npts; ++i)
+  {
+    const vtkIdType id1 = pts1[reversed1 && i > 0 ? npts - i : i];
+    const vtkIdType id2 = pts2[reversed2 && i > 0 ? npts - i : i];
+    if (id1 != id2)
+    {
+      return id1 < id2 ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Concurrent version of UnstructuredGridExecuteInternal(). The cells are
+// processed in pieces: the verts, lines and 2D cells of each piece are
+// generated (subdividing the nonlinear ones), and the faces of its 3D cells
+// gathered. The faces used once are found by sorting all the faces; they are
+// then extracted in the order of the quad hash, in pieces again. Finally the
+// points are numbered by first use, the new points generated along the same
+// edge being merged.
+int vtkDataSetSurfaceFilter::UnstructuredGridExecuteConcurrently(
+  vtkUnstructuredGrid* input, vtkPolyData* output, bool isLinear)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const int level = this->NonlinearSubdivisionLevel;
+  vtkPointData* inputPD = input->GetPointData();
+  vtkCellData* inputCD = input->GetCellData();
+  vtkPointData* outputPD = output->GetPointData();
+  vtkCellData* outputCD = output->GetCellData();
+  vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
+  vtkUnsignedCharArray* ghostCells = input->GetCellGhostArray();
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(input->GetPoints() ? input->GetPoints()->GetDataType() : VTK_FLOAT);
+  if (numCells < 1)
+  {
+    output->SetPoints(newPts);
+    vtkNew<vtkCellArray> newPolys;
+    output->SetPolys(newPolys);
+    return 1;
+  }
+
+  // The grid is accessed by several threads: the first calls must be made
+  // from a single thread.
+  {
+    vtkNew<vtkGenericCell> cell;
+    vtkNew<vtkIdList> ptIds;
+    input->GetCellType(0);
+    input->GetCellPoints(0, ptIds);
+    input->GetCell(0, cell);
+  }
+
+  vtkSMPThreadLocal<SurfaceThreadData> threadData;
+  std::atomic<vtkIdType> numMisplacedCells(0);
+
+  // Generate the verts, lines and 2D cells, and gather the faces of the 3D
+  // cells. Without nonlinear cells, hidden cells are skipped; otherwise the
+  // faces of the hidden 3D cells are matched with the others, as the
+  // sequential execution extracts them with vtkUnstructuredGridGeometryFilter.
+  const vtkIdType numCellPieces = (numCells + VTK_SURFACE_PIECE_SIZE - 1) / VTK_SURFACE_PIECE_SIZE;
+  std::vector<SurfacePiece> pieces(numCellPieces);
+  vtkSMPTools::For(0, numCellPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    SurfaceThreadData& data = threadData.Local();
+    data.Initialize();
+    vtkGenericCell* cell = data.Cell;
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      if (vtkSMPTools::GetSingleThread())
+      {
+        this->CheckAbort();
+      }
+      if (this->GetAbortOutput())
+      {
+        return;
+      }
+
+      SurfacePiece& piece = pieces[pieceId];
+      data.SubdivisionPoints.clear();
+      const vtkIdType begin = pieceId * VTK_SURFACE_PIECE_SIZE;
+      const vtkIdType end = std::min(begin + VTK_SURFACE_PIECE_SIZE, numCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const int cellType = input->GetCellType(cellId);
+        vtkIdType npts;
+        const vtkIdType* ids;
+        input->GetCellPoints(cellId, npts, ids, data.PointIds);
+
+        if (cellType == VTK_VERTEX || cellType == VTK_POLY_VERTEX)
+        {
+          piece.AddCell(0, npts, ids, cellId);
+          continue;
+        }
+        const bool hidden = ghostCells &&
+          (ghostCells->GetValue(cellId) & vtkDataSetAttributes::CellGhostTypes::HIDDENCELL);
+        if (cellType == VTK_EMPTY_CELL ||
+          (hidden && (isLinear || vtkCellTypes::GetDimension(cellType) != 3)))
+        {
+          continue;
+        }
+
+        switch (cellType)
+        {
+          case VTK_LINE:
+          case VTK_POLY_LINE:
+            piece.AddCell(1, npts, ids, cellId);
+            break;
+
+          case VTK_LAGRANGE_CURVE:
+          case VTK_QUADRATIC_EDGE:
+          case VTK_CUBIC_LINE:
+            AddNonlinearCurve(cellId, npts, ids, level, piece, data);
+            break;
+
+          case VTK_PIXEL:
+          {
+            const vtkIdType quad[4] = { ids[0], ids[1], ids[3], ids[2] };
+            piece.AddCell(2, 4, quad, cellId);
+            break;
+          }
+
+          case VTK_TRIANGLE:
+          case VTK_QUAD:
+          case VTK_POLYGON:
+            piece.AddCell(2, npts, ids, cellId);
+            break;
+
+          case VTK_TRIANGLE_STRIP:
+          {
+            // Change strips to triangles so we do not have to worry about order.
+            vtkIdType triangle[3] = { ids[0], npts > 1 ? ids[1] : ids[0], 0 };
+            int toggle = 0;
+            for (vtkIdType i = 2; i < npts; ++i)
+            {
+              triangle[2] = ids[i];
+              piece.AddCell(2, 3, triangle, cellId);
+              triangle[toggle] = triangle[2];
+              toggle = !toggle;
+            }
+            break;
+          }
+
+          case VTK_QUADRATIC_TRIANGLE:
+          case VTK_BIQUADRATIC_TRIANGLE:
+          case VTK_QUADRATIC_QUAD:
+          case VTK_QUADRATIC_LINEAR_QUAD:
+          case VTK_BIQUADRATIC_QUAD:
+          case VTK_QUADRATIC_POLYGON:
+          case VTK_LAGRANGE_TRIANGLE:
+          case VTK_LAGRANGE_QUADRILATERAL:
+          {
+            const int linearSize = GetLinearizedSize(cellType);
+            if (level < 1 && linearSize > 0)
+            {
+              piece.AddCell(2, linearSize, ids, cellId);
+            }
+            else if (!HasHiddenPoint(ghosts, npts, ids))
+            {
+              input->GetCell(cellId, cell);
+              input->SetCellOrderAndRationalWeights(cellId, cell);
+              AddNonlinearPolygon(cell, cellId, -1, level, piece, data);
+            }
+            break;
+          }
+
+          default:
+          {
+            if (AddLinearCellFaces(cellType, ids, cellId, hidden, piece))
+            {
+              break;
+            }
+            input->GetCell(cellId, cell);
+            if (cell->IsLinear())
+            {
+              if (cell->GetCellDimension() == 3)
+              {
+                const int numFaces = cell->GetNumberOfFaces();
+                for (int j = 0; j < numFaces; ++j)
+                {
+                  vtkIdList* faceIds = cell->GetFace(j)->GetPointIds();
+                  piece.AddFace(
+                    cellId, -1, hidden, faceIds->GetNumberOfIds(), faceIds->GetPointer(0));
+                }
+              }
+              break;
+            }
+            input->SetCellOrderAndRationalWeights(cellId, cell);
+            switch (cell->GetCellDimension())
+            {
+              case 1:
+              {
+                vtkIdList* pts = data.TriangleIds;
+                cell->Triangulate(0, pts, data.TriangleCoords);
+                for (vtkIdType i = 0; i + 1 < pts->GetNumberOfIds(); i += 2)
+                {
+                  piece.AddCell(1, 2, pts->GetPointer(i), cellId);
+                }
+                break;
+              }
+              case 2:
+                ++numMisplacedCells;
+                break;
+              default:
+              {
+                // Nonlinear faces are matched by their corners.
+                const int numFaces = cell->GetNumberOfFaces();
+                for (int j = 0; j < numFaces; ++j)
+                {
+                  vtkCell* face = cell->GetFace(j);
+                  piece.AddFace(cellId, j, hidden, face->GetNumberOfEdges(),
+                    face->GetPointIds()->GetPointer(0));
+                }
+                break;
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+
+  if (this->GetAbortOutput())
+  {
+    return 1;
+  }
+  if (numMisplacedCells > 0)
+  {
+    vtkWarningMacro(<< numMisplacedCells.load()
+                    << " 2-D nonlinear cells must be processed with all other 2-D cells.");
+  }
+  this->UpdateProgress(0.3);
+
+  // Gather the faces of all the pieces.
+  std::vector<vtkIdType> faceOffsets(numCellPieces + 1, 0);
+  std::vector<vtkIdType> facePointOffsets(numCellPieces + 1, 0);
+  for (vtkIdType pieceId = 0; pieceId < numCellPieces; ++pieceId)
+  {
+    faceOffsets[pieceId + 1] =
+      faceOffsets[pieceId] + static_cast<vtkIdType>(pieces[pieceId].Faces.size());
+    facePointOffsets[pieceId + 1] =
+      facePointOffsets[pieceId] + static_cast<vtkIdType>(pieces[pieceId].FacePoints.size());
+  }
+  const vtkIdType numFaces = faceOffsets[numCellPieces];
+  std::vector<SurfaceFace> faces(numFaces);
+  std::vector<vtkIdType> facePoints(facePointOffsets[numCellPieces]);
+  vtkSMPTools::For(0, numCellPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      SurfacePiece& piece = pieces[pieceId];
+      SurfaceFace* pieceFaces = faces.data() + faceOffsets[pieceId];
+      for (const SurfaceFace& face : piece.Faces)
+      {
+        *pieceFaces = face;
+        pieceFaces->Offset += facePointOffsets[pieceId];
+        ++pieceFaces;
+      }
+      std::copy(piece.FacePoints.begin(), piece.FacePoints.end(),
+        facePoints.begin() + facePointOffsets[pieceId]);
+      std::vector<SurfaceFace>().swap(piece.Faces);
+      std::vector<vtkIdType>().swap(piece.FacePoints);
+    }
+  });
+
+  // The boundary faces are the ones which are not matched by another face.
+  // They are extracted in the order of the quad hash traversal: by smallest
+  // point id, then in the order the faces were inserted.
+  std::vector<vtkIdType> boundaryFaces;
+  if (numFaces > 0)
+  {
+    std::vector<vtkIdType> sortedFaces(numFaces);
+    std::iota(sortedFaces.begin(), sortedFaces.end(), 0);
+    vtkSMPTools::Sort(sortedFaces.begin(), sortedFaces.end(), [&](vtkIdType f1, vtkIdType f2) {
+      const int comparison = CompareFaces(faces[f1], faces[f2], facePoints.data());
+      return comparison != 0 ? comparison < 0 : f1 < f2;
+    });
+    std::vector<vtkIdType> isBoundary(numFaces);
+    vtkSMPTools::For(0, numFaces, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const SurfaceFace& face = faces[sortedFaces[i]];
+        const bool matched =
+          (i > 0 && CompareFaces(faces[sortedFaces[i - 1]], face, facePoints.data()) == 0) ||
+          (i + 1 < numFaces &&
+            CompareFaces(face, faces[sortedFaces[i + 1]], facePoints.data()) == 0);
+        isBoundary[sortedFaces[i]] = !matched && !face.Hidden;
+      }
+    });
+    std::vector<vtkIdType>& boundaryIds = sortedFaces;
+    vtkSMPTools::ExclusiveScan(
+      isBoundary.begin(), isBoundary.end(), boundaryIds.begin(), static_cast<vtkIdType>(0));
+    boundaryFaces.resize(boundaryIds[numFaces - 1] + isBoundary[numFaces - 1]);
+    vtkSMPTools::For(0, numFaces, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType f = begin; f < end; ++f)
+      {
+        if (isBoundary[f])
+        {
+          boundaryFaces[boundaryIds[f]] = f;
+        }
+      }
+    });
+    vtkSMPTools::Sort(boundaryFaces.begin(), boundaryFaces.end(), [&](vtkIdType f1, vtkIdType f2) {
+      const vtkIdType a1 = facePoints[faces[f1].Offset];
+      const vtkIdType a2 = facePoints[faces[f2].Offset];
+      return a1 != a2 ? a1 < a2 : f1 < f2;
+    });
+  }
+
+  // Extract the boundary faces, subdividing the nonlinear ones.
+  const vtkIdType numBoundaryFaces = static_cast<vtkIdType>(boundaryFaces.size());
+  const vtkIdType numFacePieces =
+    (numBoundaryFaces + VTK_SURFACE_PIECE_SIZE - 1) / VTK_SURFACE_PIECE_SIZE;
+  pieces.resize(numCellPieces + numFacePieces);
+  vtkSMPTools::For(0, numFacePieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    SurfaceThreadData& data = threadData.Local();
+    data.Initialize();
+    vtkGenericCell* cell = data.Cell;
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      if (vtkSMPTools::GetSingleThread())
+      {
+        this->CheckAbort();
+      }
+      if (this->GetAbortOutput())
+      {
+        return;
+      }
+
+      SurfacePiece& piece = pieces[numCellPieces + pieceId];
+      data.SubdivisionPoints.clear();
+      const vtkIdType begin = pieceId * VTK_SURFACE_PIECE_SIZE;
+      const vtkIdType end = std::min(begin + VTK_SURFACE_PIECE_SIZE, numBoundaryFaces);
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const SurfaceFace& face = faces[boundaryFaces[i]];
+        const vtkIdType* ids = facePoints.data() + face.Offset;
+        if (face.FaceId < 0)
+        {
+          if (!HasHiddenPoint(ghosts, face.NumberOfPoints, ids))
+          {
+            piece.AddCell(2, face.NumberOfPoints, ids, face.CellId);
+          }
+          continue;
+        }
+        input->GetCell(face.CellId, cell);
+        input->SetCellOrderAndRationalWeights(face.CellId, cell);
+        vtkCell* faceCell = cell->GetFace(face.FaceId);
+        vtkIdList* faceIds = faceCell->GetPointIds();
+        const int linearSize = GetLinearizedSize(faceCell->GetCellType());
+        if (level < 1 && linearSize > 0)
+        {
+          piece.AddCell(2, linearSize, faceIds->GetPointer(0), face.CellId);
+        }
+        else if (!HasHiddenPoint(ghosts, faceIds->GetNumberOfIds(), faceIds->GetPointer(0)))
+        {
+          AddNonlinearPolygon(faceCell, face.CellId, face.FaceId, level, piece, data);
+        }
+      }
+    }
+  });
+
+  if (this->GetAbortOutput())
+  {
+    return 1;
+  }
+  std::vector<SurfaceFace>().swap(faces);
+  std::vector<vtkIdType>().swap(facePoints);
+  std::vector<vtkIdType>().swap(boundaryFaces);
+  this->UpdateProgress(0.6);
+
+  // Gather the new points of all the pieces. Each shared point is represented
+  // by the first one generated, by the lowest piece.
+  const vtkIdType numPieces = static_cast<vtkIdType>(pieces.size());
+  std::vector<vtkIdType> newPointOffsets(numPieces + 1, 0);
+  std::vector<vtkIdType> sharedOffsets(numPieces + 1, 0);
+  for (vtkIdType pieceId = 0; pieceId < numPieces; ++pieceId)
+  {
+    const std::vector<SurfaceNewPoint>& piecePts = pieces[pieceId].NewPoints;
+    newPointOffsets[pieceId + 1] =
+      newPointOffsets[pieceId] + static_cast<vtkIdType>(piecePts.size());
+    sharedOffsets[pieceId + 1] = sharedOffsets[pieceId] +
+      std::count_if(piecePts.begin(), piecePts.end(),
+        [](const SurfaceNewPoint& pt) { return pt.Key[0] >= 0; });
+  }
+  const vtkIdType numNewPts = newPointOffsets[numPieces];
+  const vtkIdType numSharedPts = sharedOffsets[numPieces];
+  std::vector<SurfaceNewPoint> newPoints(numNewPts);
+  std::vector<vtkIdType> sharedPoints(numSharedPts);
+  vtkSMPTools::For(0, numPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      std::vector<SurfaceNewPoint>& piecePts = pieces[pieceId].NewPoints;
+      std::copy(piecePts.begin(), piecePts.end(), newPoints.begin() + newPointOffsets[pieceId]);
+      vtkIdType shared = sharedOffsets[pieceId];
+      for (size_t i = 0; i < piecePts.size(); ++i)
+      {
+        if (piecePts[i].Key[0] >= 0)
+        {
+          sharedPoints[shared++] = newPointOffsets[pieceId] + static_cast<vtkIdType>(i);
+        }
+      }
+      std::vector<SurfaceNewPoint>().swap(piecePts);
+    }
+  });
+  std::vector<vtkIdType> representatives(numNewPts);
+  std::iota(representatives.begin(), representatives.end(), 0);
+  if (numSharedPts > 0)
+  {
+    auto samePoint = [&](vtkIdType p1, vtkIdType p2) {
+      return newPoints[p1].Key == newPoints[p2].Key;
+    };
+    vtkSMPTools::Sort(sharedPoints.begin(), sharedPoints.end(), [&](vtkIdType p1, vtkIdType p2) {
+      const std::array<vtkIdType, 6>& k1 = newPoints[p1].Key;
+      const std::array<vtkIdType, 6>& k2 = newPoints[p2].Key;
+      return k1 < k2 || (k1 == k2 && p1 < p2);
+    });
+    std::vector<vtkIdType> firstShared(numSharedPts);
+    vtkSMPTools::For(0, numSharedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        firstShared[i] = i > 0 && samePoint(sharedPoints[i - 1], sharedPoints[i]) ? 0 : i;
+      }
+    });
+    vtkSMPTools::InclusiveScan(firstShared.begin(), firstShared.end(), firstShared.begin(),
+      [](vtkIdType a, vtkIdType b) { return std::max(a, b); });
+    vtkSMPTools::For(0, numSharedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        representatives[sharedPoints[i]] = sharedPoints[firstShared[i]];
+      }
+    });
+  }
+
+  // Concatenate the cells of the pieces, verts then lines then polys. The
+  // point references become input point ids, or numPts plus the index of a
+  // new point.
+  std::vector<vtkIdType> cellOffsets[3];
+  std::vector<vtkIdType> refOffsets[3];
+  vtkIdType numOutCells[3];
+  vtkIdType typeCellStart[3];
+  vtkIdType typeRefStart[3];
+  vtkIdType numOutRefs = 0;
+  vtkIdType numAllCells = 0;
+  for (int type = 0; type < 3; ++type)
+  {
+    cellOffsets[type].assign(numPieces + 1, 0);
+    refOffsets[type].assign(numPieces + 1, 0);
+    for (vtkIdType pieceId = 0; pieceId < numPieces; ++pieceId)
+    {
+      cellOffsets[type][pieceId + 1] = cellOffsets[type][pieceId] +
+        static_cast<vtkIdType>(pieces[pieceId].Sizes[type].size());
+      refOffsets[type][pieceId + 1] =
+        refOffsets[type][pieceId] + static_cast<vtkIdType>(pieces[pieceId].Refs[type].size());
+    }
+    numOutCells[type] = cellOffsets[type][numPieces];
+    typeCellStart[type] = numAllCells;
+    typeRefStart[type] = numOutRefs;
+    numAllCells += numOutCells[type];
+    numOutRefs += refOffsets[type][numPieces];
+  }
+  std::vector<vtkIdType> cellSizes(numAllCells);
+  std::vector<vtkIdType> cellSources(numAllCells);
+  std::vector<vtkIdType> refs(numOutRefs);
+  vtkSMPTools::For(0, numPieces, 1, [&](vtkIdType pieceId, vtkIdType endPieceId) {
+    for (; pieceId < endPieceId; ++pieceId)
+    {
+      SurfacePiece& piece = pieces[pieceId];
+      for (int type = 0; type < 3; ++type)
+      {
+        const vtkIdType cellStart = typeCellStart[type] + cellOffsets[type][pieceId];
+        std::copy(piece.Sizes[type].begin(), piece.Sizes[type].end(), cellSizes.begin() + cellStart);
+        std::copy(
+          piece.Sources[type].begin(), piece.Sources[type].end(), cellSources.begin() + cellStart);
+        vtkIdType* pieceRefs = refs.data() + typeRefStart[type] + refOffsets[type][pieceId];
+        for (vtkIdType ref : piece.Refs[type])
+        {
+          *pieceRefs++ =
+            ref >= 0 ? ref : numPts + representatives[newPointOffsets[pieceId] - ref - 1];
+        }
+      }
+      piece = SurfacePiece();
+    }
+  });
+  std::vector<SurfacePiece>().swap(pieces);
+
+  // Number the output points in the order of their first use.
+  std::vector<std::atomic<vtkIdType>> firstUses(numPts + numNewPts);
+  vtkSMPTools::For(0, numPts + numNewPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ref = begin; ref < end; ++ref)
+    {
+      firstUses[ref].store(numOutRefs, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numOutRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      std::atomic<vtkIdType>& firstUse = firstUses[refs[i]];
+      vtkIdType current = firstUse.load(std::memory_order_relaxed);
+      while (i < current && !firstUse.compare_exchange_weak(current, i))
+      {
+      }
+    }
+  });
+  std::vector<vtkIdType> outPtIds(numOutRefs);
+  vtkSMPTools::For(0, numOutRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      outPtIds[i] = firstUses[refs[i]].load(std::memory_order_relaxed) == i;
+    }
+  });
+  const vtkIdType lastIsFirst = numOutRefs > 0 ? outPtIds[numOutRefs - 1] : 0;
+  vtkSMPTools::ExclusiveScan(
+    outPtIds.begin(), outPtIds.end(), outPtIds.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numOutPts = numOutRefs > 0 ? outPtIds[numOutRefs - 1] + lastIsFirst : 0;
+  std::vector<vtkIdType> outPtRefs(numOutPts);
+  vtkSMPTools::For(0, numOutRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (firstUses[refs[i]].load(std::memory_order_relaxed) == i)
+      {
+        outPtRefs[outPtIds[i]] = refs[i];
+      }
+    }
+  });
+
+  // Output cells.
+  std::vector<vtkIdType> connOffsets(numAllCells);
+  vtkSMPTools::ExclusiveScan(
+    cellSizes.begin(), cellSizes.end(), connOffsets.begin(), static_cast<vtkIdType>(0));
+  vtkSmartPointer<vtkCellArray> outCells[3];
+  for (int type = 0; type < 3; ++type)
+  {
+    outCells[type] = vtkSmartPointer<vtkCellArray>::New();
+    const vtkIdType cellStart = typeCellStart[type];
+    outCells[type]->BuildCells(
+      numOutCells[type],
+      [&](vtkIdType cellId) -> vtkIdType { return cellSizes[cellStart + cellId]; },
+      [&](vtkIdType cellId, vtkIdType* pts) {
+        const vtkIdType offset = connOffsets[cellStart + cellId];
+        for (vtkIdType i = 0; i < cellSizes[cellStart + cellId]; ++i)
+        {
+          pts[i] = outPtIds[firstUses[refs[offset + i]].load(std::memory_order_relaxed)];
+        }
+      });
+  }
+  std::vector<vtkIdType>().swap(refs);
+  std::vector<vtkIdType>().swap(outPtIds);
+  std::vector<std::atomic<vtkIdType>>().swap(firstUses);
+  this->UpdateProgress(0.8);
+
+  // Output points and point data. The new points are evaluated in the cell,
+  // or face, they were generated in.
+  newPts->SetNumberOfPoints(numOutPts);
+  if (level < 2)
+  {
+    outputPD->CopyGlobalIdsOn();
+    outputPD->CopyAllocate(inputPD, numOutPts);
+  }
+  else
+  {
+    outputPD->InterpolateAllocate(inputPD, numOutPts);
+  }
+  vtkSmartPointer<vtkIdTypeArray> originalPointIds;
+  if (this->PassThroughPointIds)
+  {
+    originalPointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfValues(numOutPts);
+  }
+  const bool parallelPointData = ArrayList::CanProcessInParallel(inputPD);
+  ArrayList pointArrays;
+  if (parallelPointData)
+  {
+    pointArrays.AddArrays(numOutPts, inputPD, outputPD, 0.0, false);
+  }
+  auto generatePoints = [&](vtkIdType begin, vtkIdType end) {
+    SurfaceThreadData& data = threadData.Local();
+    data.Initialize();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType ref = outPtRefs[ptId];
+      double x[3];
+      if (ref < numPts)
+      {
+        input->GetPoint(ref, x);
+        if (parallelPointData)
+        {
+          pointArrays.Copy(ref, ptId);
+        }
+        else
+        {
+          outputPD->CopyData(inputPD, ref, ptId);
+        }
+      }
+      else
+      {
+        const SurfaceNewPoint& newPoint = newPoints[ref - numPts];
+        vtkCell* cell = data.GetCell(input, newPoint.CellId, newPoint.FaceId);
+        vtkIdList* cellPtIds = cell->GetPointIds();
+        data.Weights.resize(cellPtIds->GetNumberOfIds());
+        int subId = -1;
+        cell->EvaluateLocation(subId, newPoint.PCoords, x, data.Weights.data());
+        if (parallelPointData)
+        {
+          pointArrays.Interpolate(static_cast<int>(cellPtIds->GetNumberOfIds()),
+            cellPtIds->GetPointer(0), data.Weights.data(), ptId);
+        }
+        else
+        {
+          outputPD->InterpolatePoint(inputPD, ptId, cellPtIds, data.Weights.data());
+        }
+      }
+      newPts->SetPoint(ptId, x);
+      if (originalPointIds)
+      {
+        originalPointIds->SetValue(ptId, ref < numPts ? ref : -1);
+      }
+    }
+  };
+  if (parallelPointData)
+  {
+    vtkSMPTools::For(0, numOutPts, generatePoints);
+  }
+  else
+  {
+    generatePoints(0, numOutPts);
+  }
+
+  // Output cell data, copied from the cell each output cell comes from.
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numAllCells);
+  if (ArrayList::CanProcessInParallel(inputCD))
+  {
+    ArrayList cellArrays;
+    cellArrays.AddArrays(numAllCells, inputCD, outputCD, 0.0, false);
+    vtkSMPTools::For(0, numAllCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        cellArrays.Copy(cellSources[cellId], cellId);
+      }
+    });
+  }
+  else
+  {
+    vtkNew<vtkIdList> fromIds;
+    fromIds->SetNumberOfIds(numAllCells);
+    std::copy(cellSources.begin(), cellSources.end(), fromIds->GetPointer(0));
+    outputCD->CopyData(inputCD, fromIds);
+  }
+  if (this->PassThroughCellIds)
+  {
+    vtkNew<vtkIdTypeArray> originalCellIds;
+    originalCellIds->SetName(this->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfValues(numAllCells);
+    std::copy(cellSources.begin(), cellSources.end(), originalCellIds->GetPointer(0));
+    outputCD->AddArray(originalCellIds);
+  }
+  if (originalPointIds)
+  {
+    outputPD->AddArray(originalPointIds);
+  }
+
+  output->SetPoints(newPts);
+  if (numOutCells[0] > 0)
+  {
+    output->SetVerts(outCells[0]);
+  }
+  if (numOutCells[1] > 0)
+  {
+    output->SetLines(outCells[1]);
+  }
+  output->SetPolys(outCells[2]);
+  output->Squeeze();
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
@@ -77,6 +77,12 @@
  * significant bottleneck to threading.
  *
  * @warning
+ * Unstructured grids may be processed with vtkSMPTools by turning
+ * SequentialProcessing off: the cells are then split in pieces processed
+ * concurrently, and the boundary faces are found by sorting the faces of the
+ * 3D cells rather than through the hash table (see SetSequentialProcessing()).
+ *
+ * @warning
  * This filter may create duplicate points. Unlike vtkGeometryFilter, it does
  * not have the option to merge points. However it will eliminate points
  * not used by any output polygonal primitive (i.e., not on the boundary).
@@ -102,6 +108,7 @@ class vtkIdTypeArray;
 class vtkImageData;
 class vtkRectilinearGrid;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 class vtkUnstructuredGridBase;
 
 // Helper structure for hashing faces.
@@ -208,6 +215,25 @@ public:
   vtkBooleanMacro(Delegation, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing of unstructured grids. On by default. When
+   * off, the cells of an unstructured grid are processed concurrently: the
+   * faces of the 3D cells are gathered in pieces, the boundary faces are the
+   * ones left alone once the faces are sorted, and the nonlinear cells and
+   * faces are subdivided piece after piece. The output is then the same as
+   * the sequential one for linear grids, except that the points of the faces
+   * dropped because of a hidden point are not inserted. For grids with
+   * nonlinear cells, the same cells and points are generated, but ordered
+   * differently, and the original ids refer to the input grid rather than to
+   * the linear grid generated by vtkUnstructuredGridGeometryFilter. Grids
+   * with Bezier cells are always processed sequentially.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Direct access methods so that this class can be used as an
@@ -356,11 +382,14 @@ protected:
   int NonlinearSubdivisionLevel;
   vtkTypeBool Delegation;
   bool FastMode;
+  vtkTypeBool SequentialProcessing;
 
 private:
   int UnstructuredGridBaseExecute(vtkDataSet* input, vtkPolyData* output);
   int UnstructuredGridExecuteInternal(vtkUnstructuredGridBase* input, vtkPolyData* output,
     bool handleSubdivision, vtkSmartPointer<vtkCellIterator> cellIter);
+  int UnstructuredGridExecuteConcurrently(
+    vtkUnstructuredGrid* input, vtkPolyData* output, bool isLinear);
 
   int StructuredExecuteNoBlanking(
     vtkDataSet* input, vtkPolyData* output, vtkIdType* ext, vtkIdType* wholeExt);
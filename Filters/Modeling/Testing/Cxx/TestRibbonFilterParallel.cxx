@@ -0,0 +1,218 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestRibbonFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Ribbons helical polylines with several threads: each polyline gives a
+// single strip, the polylines with coincident points or a single point are
+// skipped, straight polylines give the ribbons of the former serial filter,
+// and the ends of a closed loop match.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyLine.h"
+#include "vtkRibbonFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTesting.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+const int NumberOfLines = 400;
+const int NumberOfLinePoints = 10;
+
+// Helical polylines, every 7th of which shares its first points with the
+// previous one. Every 11th polyline has coincident points, and the polyline
+// 13 a single point, so that they are skipped.
+vtkSmartPointer<vtkPolyData> MakeInput()
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    const int npts = l == 13 ? 1 : NumberOfLinePoints;
+    lines->InsertNextCell(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+      const double t = 0.4 * i;
+      vtkIdType id = points->InsertNextPoint(
+        std::cos(t) + 3 * (l % 20), std::sin(t) + 3 * (l / 20), 0.2 * t + 0.01 * l);
+      scalars->InsertNextValue(1 + (l + i) % 5);
+      if (l % 7 == 1 && i < 3)
+      {
+        id -= NumberOfLinePoints;
+      }
+      else if (l % 11 == 5 && i == 4)
+      {
+        --id;
+      }
+      lines->InsertCellPoint(id);
+    }
+    cellIds->InsertNextValue(l);
+  }
+  input->SetPoints(points);
+  input->SetLines(lines);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+bool IsRibboned(int l)
+{
+  return l != 13 && l % 11 != 5;
+}
+
+// The ribbons of two straight polylines along x, of 3 and 2 points, with the
+// default normal, have the points, normals and strips of the previous serial
+// filter.
+int TestStraightLines()
+{
+  vtkNew<vtkRibbonFilter> ribbon;
+  ribbon->SetInputData(vtkTestDataSetUtilities::MakeStraightPolyLines());
+  ribbon->SetWidth(0.5);
+  ribbon->UseDefaultNormalOn();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(ribbon.GetPointer()));
+  vtkPolyData* output = ribbon->GetOutput();
+
+  // Each point gives a point on each side of the ribbon.
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 2 * 3 + 2 * 2);
+  vtkDataArray* outPts = output->GetPoints()->GetData();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 0, 0, 0.5, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 1, 0, -0.5, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 4, 2, 0.5, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 7, 0, 4.5, 0));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(outPts, 9, 1, 4.5, 0));
+  vtkDataArray* normals = output->GetPointData()->GetNormals();
+  VTK_TEST_CHECK(normals);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 0, 0, 0, 1));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasTuple(normals, 9, 0, 0, 1));
+
+  // A single strip per polyline.
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == 2);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 0, { 0, 1, 2, 3, 4, 5 }));
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::HasCellPoints(output, 1, { 6, 7, 8, 9 }));
+  vtkDataArray* outCellIds = output->GetCellData()->GetArray("CellIds");
+  VTK_TEST_CHECK(outCellIds);
+  VTK_TEST_CHECK(outCellIds->GetComponent(0, 0) == 10 && outCellIds->GetComponent(1, 0) == 11);
+  return EXIT_SUCCESS;
+}
+
+// Ribboning a closed loop with its sliding normals given per input point
+// gives the same ribbon as generating them: the closing point, met twice,
+// keeps the normal computed at the end of the loop.
+int TestClosedLoop()
+{
+  vtkSmartPointer<vtkPolyData> loop = vtkTestDataSetUtilities::MakeClosedLoop(NumberOfLinePoints);
+  vtkNew<vtkRibbonFilter> ribbon;
+  ribbon->SetInputData(loop);
+  ribbon->SetWidth(0.1);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(ribbon.GetPointer()));
+  vtkNew<vtkPolyData> generated;
+  generated->DeepCopy(ribbon->GetOutput());
+  VTK_TEST_CHECK(generated->GetNumberOfPoints() == 2 * (NumberOfLinePoints + 1));
+
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(loop->GetNumberOfPoints());
+  VTK_TEST_CHECK(vtkPolyLine::GenerateSlidingNormals(loop->GetPoints(), loop->GetLines(), normals));
+  loop->GetPointData()->SetNormals(normals);
+  loop->Modified();
+  ribbon->Update();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SamePoints(generated, ribbon->GetOutput()));
+  return EXIT_SUCCESS;
+}
+}
+
+int TestRibbonFilterParallel(int, char*[])
+{
+  vtkTestDataSetUtilities::ThreadedBackend backend;
+  if (!backend.IsAvailable())
+  {
+    std::cout << "The STDThread backend is not available, skipping." << std::endl;
+    return VTK_SKIP_RETURN_CODE;
+  }
+
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+  vtkNew<vtkRibbonFilter> ribbon;
+  ribbon->SetInputData(input);
+  ribbon->SetWidth(0.1);
+  ribbon->GlobalWarningDisplayOff();
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(ribbon.GetPointer()));
+
+  // The ribbon of each polyline has two points per point, and a single strip
+  // carrying the data of its polyline.
+  vtkPolyData* output = ribbon->GetOutput();
+  vtkDataArray* cellIds = output->GetCellData()->GetArray("CellIds");
+  VTK_TEST_CHECK(cellIds != nullptr);
+  vtkIdType stripId = 0;
+  vtkNew<vtkIdList> stripPts;
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    if (IsRibboned(l))
+    {
+      VTK_TEST_CHECK(cellIds->GetComponent(stripId, 0) == l);
+      output->GetCellPoints(stripId, stripPts);
+      VTK_TEST_CHECK(stripPts->GetNumberOfIds() == 2 * NumberOfLinePoints);
+      VTK_TEST_CHECK(stripPts->GetId(0) == 2 * NumberOfLinePoints * stripId);
+      ++stripId;
+    }
+  }
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == stripId);
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 2 * NumberOfLinePoints * stripId);
+  VTK_TEST_CHECK(output->GetPointData()->GetNormals() != nullptr);
+
+  // Varying width, rotated ribbons and texture coordinates.
+  ribbon->VaryWidthOn();
+  ribbon->SetAngle(30);
+  ribbon->SetGenerateTCoords(VTK_TCOORDS_FROM_LENGTH);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(ribbon.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfStrips() == stripId);
+  VTK_TEST_CHECK(output->GetPointData()->GetTCoords() != nullptr);
+
+  // A polyline along the default normal is discarded.
+  ribbon->UseDefaultNormalOn();
+  ribbon->SetDefaultNormal(1, 0, 0);
+  vtkNew<vtkPolyData> straight;
+  vtkNew<vtkPoints> straightPts;
+  vtkNew<vtkCellArray> straightLines;
+  for (vtkIdType i = 0; i < 4; ++i)
+  {
+    straightPts->InsertNextPoint(i, 0, 0);
+  }
+  const vtkIdType line[4] = { 0, 1, 2, 3 };
+  straightLines->InsertNextCell(4, line);
+  straight->SetPoints(straightPts);
+  straight->SetLines(straightLines);
+  ribbon->SetInputData(straight);
+  VTK_TEST_CHECK(vtkTestDataSetUtilities::SameAsSequential(ribbon.GetPointer()));
+  VTK_TEST_CHECK(output->GetNumberOfPoints() == 0 && output->GetNumberOfStrips() == 0);
+
+  VTK_TEST_CHECK(TestClosedLoop() == EXIT_SUCCESS);
+  VTK_TEST_CHECK(TestStraightLines() == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
@@ -12,19 +12,33 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkRibbonFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkRibbonFilter);
 
@@ -56,6 +70,77 @@ vtkRibbonFilter::vtkRibbonFilter()
 
 vtkRibbonFilter::~vtkRibbonFilter() = default;
 
+namespace
+{
+
+// Copies the tuples sourceIds[i] of the input attributes to the tuples i of
+// the output attributes, which must have been allocated with CopyAllocate().
+void CopyAttributes(vtkDataSetAttributes* in, vtkDataSetAttributes* out,
+  const std::vector<vtkIdType>& sourceIds, bool sequential)
+{
+  if (!sequential)
+  {
+    ArrayList::CopyAttributes(in, out, sourceIds);
+    return;
+  }
+  for (vtkIdType id = 0; id < static_cast<vtkIdType>(sourceIds.size()); ++id)
+  {
+    out->CopyData(in, sourceIds[id], id);
+  }
+}
+
+// Computes the sliding normals of a single polyline, independently of the
+// other polylines sharing its points.
+struct LineNormalsGenerator
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Line;
+  vtkSmartPointer<vtkFloatArray> Normals;
+  std::unordered_map<vtkIdType, vtkIdType> LastOccurrence;
+
+  bool Generate(vtkPoints* inPts, vtkIdType npts, const vtkIdType* pts, double* normals)
+  {
+    if (!this->Points)
+    {
+      this->Points = vtkSmartPointer<vtkPoints>::New();
+      this->Points->SetDataTypeToDouble();
+      this->Line = vtkSmartPointer<vtkCellArray>::New();
+      this->Normals = vtkSmartPointer<vtkFloatArray>::New();
+      this->Normals->SetNumberOfComponents(3);
+    }
+    this->Points->SetNumberOfPoints(npts);
+    this->Normals->SetNumberOfTuples(npts);
+    this->Line->Reset();
+    this->Line->InsertNextCell(static_cast<int>(npts));
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      double x[3];
+      inPts->GetPoint(pts[j], x);
+      this->Points->SetPoint(j, x);
+      this->Line->InsertCellPoint(j);
+    }
+    if (!vtkPolyLine::GenerateSlidingNormals(this->Points, this->Line, this->Normals))
+    {
+      return false;
+    }
+    // A point met several times along the polyline (e.g. the last point of a
+    // closed loop) keeps the normal computed at its last occurrence, as when
+    // the normals were stored per input point.
+    this->LastOccurrence.clear();
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      this->LastOccurrence[pts[j]] = j;
+    }
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      this->Normals->GetTuple(this->LastOccurrence[pts[j]], normals + 3 * j);
+    }
+    return true;
+  }
+};
+
+}
+
 int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector, vtkInformationVector* outputVector)
 {
@@ -80,17 +165,10 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType numLines;
   vtkIdType numNewPts, numNewCells;
   vtkPoints* newPts;
-  int deleteNormals = 0;
   vtkFloatArray* newNormals;
-  vtkIdType i;
   double range[2];
   vtkCellArray* newStrips;
-  vtkIdType npts = 0;
-  const vtkIdType* pts = nullptr;
-  vtkIdType offset = 0;
   vtkFloatArray* newTCoords = nullptr;
-  int abort = 0;
-  vtkIdType inCellId;
 
   // Check input and initialize
   //
@@ -102,51 +180,26 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
-  // Create the geometry and topology
-  numNewPts = 2 * numPts;
-  newPts = vtkPoints::New();
-  newPts->Allocate(numNewPts);
-  newNormals = vtkFloatArray::New();
-  newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3 * numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->AllocateEstimate(1, numNewPts);
-  vtkCellArray* singlePolyline = vtkCellArray::New();
-
-  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
-  outPD->CopyNormalsOff();
-  if ((this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
-    this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
-    this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
-  {
-    newTCoords = vtkFloatArray::New();
-    newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
-    outPD->CopyTCoordsOff();
-  }
-  outPD->CopyAllocate(pd, numNewPts);
-
+  // Normals are either given, or computed for each polyline independently,
+  // which allows different polylines to share vertices.
   int generateNormals = 0;
+  vtkSmartPointer<vtkDataArray> normalsHolder;
   inNormals = this->GetInputArrayToProcess(1, inputVector);
   if (!inNormals || this->UseDefaultNormal)
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
     if (this->UseDefaultNormal)
     {
-      for (i = 0; i < numPts; i++)
+      normalsHolder = vtkSmartPointer<vtkFloatArray>::New();
+      normalsHolder->SetNumberOfComponents(3);
+      normalsHolder->SetNumberOfTuples(numPts);
+      for (vtkIdType i = 0; i < numPts; i++)
       {
-        inNormals->SetTuple(i, this->DefaultNormal);
+        normalsHolder->SetTuple(i, this->DefaultNormal);
       }
+      inNormals = normalsHolder;
     }
     else
     {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their ribbons) calculated independently
       generateNormals = 1;
     }
   }
@@ -162,78 +215,195 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
       range[1] = range[0] + 1.0;
     }
   }
+  this->Theta = vtkMath::RadiansFromDegrees(this->Angle);
 
-  // Copy selected parts of cell data; certainly don't want normals
-  //
-  numNewCells = inLines->GetNumberOfCells();
-  outCD->CopyNormalsOff();
-  outCD->CopyAllocate(cd, numNewCells);
+  // First pass: compute the normals of each polyline and check that it can
+  // be ribboned. The normals are stored in place of the connectivity.
+  std::vector<double> lineNormals(3 * inLines->GetNumberOfConnectivityIds());
+  std::vector<vtkIdType> lineSizes(numLines);
+  vtkSMPThreadLocalObject<vtkIdList> threadIds;
+  vtkSMPThreadLocal<LineNormalsGenerator> threadGenerators;
+  auto checkLines = [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = threadIds.Local();
+    LineNormalsGenerator& generator = threadGenerators.Local();
+    for (vtkIdType lineId = begin; lineId < end; lineId++)
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      inLines->GetCellAtId(lineId, npts, pts, ids);
+      double* normals = lineNormals.data() + 3 * inLines->GetOffset(lineId);
+      if (npts < 2)
+      {
+        lineSizes[lineId] = 0;
+        continue; // skip ribboning this polyline
+      }
 
-  //  Create points along each polyline that are connected into NumberOfSides
-  //  triangle strips. Texture coordinates are optionally generated.
-  //
-  this->Theta = vtkMath::RadiansFromDegrees(this->Angle);
-  vtkPolyLine* lineNormalGenerator = vtkPolyLine::New();
-  for (inCellId = 0, inLines->InitTraversal(); inLines->GetNextCell(npts, pts) && !abort;
-       inCellId++)
+      if (generateNormals)
+      {
+        if (!generator.Generate(inPts, npts, pts, normals))
+        {
+          lineSizes[lineId] = -1;
+          continue; // skip ribboning this polyline
+        }
+      }
+      else
+      {
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          inNormals->GetTuple(pts[j], normals + 3 * j);
+        }
+      }
+
+      // The strip is not created if the polyline is bad.
+      lineSizes[lineId] =
+        this->GeneratePolyLinePoints(
+          0, npts, pts, inPts, nullptr, nullptr, nullptr, inScalars, range, normals)
+        ? npts
+        : -1;
+    }
+  };
+  if (this->SequentialProcessing)
+  {
+    checkLines(0, numLines);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numLines, checkLines);
+  }
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
   {
-    this->UpdateProgress((double)inCellId / numLines);
-    abort = this->GetAbortExecute();
+    return 1;
+  }
 
-    if (npts < 2)
+  // Offsets of the points of each polyline, which has a single strip.
+  std::vector<vtkIdType> pointOffsets(numLines + 1);
+  std::vector<vtkIdType> sourceCells;
+  sourceCells.reserve(numLines);
+  vtkIdType numShortLines = 0;
+  vtkIdType numBadLines = 0;
+  for (vtkIdType lineId = 0; lineId < numLines; lineId++)
+  {
+    const vtkIdType npts = lineSizes[lineId];
+    pointOffsets[lineId + 1] = pointOffsets[lineId];
+    if (npts > 0)
     {
-      vtkWarningMacro(<< "Less than two points in line!");
-      continue; // skip tubing this polyline
+      pointOffsets[lineId + 1] = this->ComputeOffset(pointOffsets[lineId], npts);
+      sourceCells.push_back(lineId);
     }
+    numShortLines += npts == 0;
+    numBadLines += npts < 0;
+  }
+  if (numShortLines > 0)
+  {
+    vtkWarningMacro(<< numShortLines << " lines with less than two points!");
+  }
+  if (numBadLines > 0)
+  {
+    vtkWarningMacro(<< "Could not generate points for " << numBadLines
+                    << " lines with no normals, coincident points or bad normals!");
+  }
+  numNewPts = pointOffsets[numLines];
+  numNewCells = static_cast<vtkIdType>(sourceCells.size());
+
+  // Create the geometry and topology
+  newPts = vtkPoints::New();
+  newPts->SetNumberOfPoints(numNewPts);
+  newNormals = vtkFloatArray::New();
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(numNewPts);
+  newStrips = vtkCellArray::New();
+
+  // Point data: copy scalars, vectors, tcoords. Normals are computed here.
+  outPD->CopyNormalsOff();
+  if ((this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
+    this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
+    this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
+  {
+    newTCoords = vtkFloatArray::New();
+    newTCoords->SetNumberOfComponents(2);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    outPD->CopyTCoordsOff();
+  }
+  outPD->CopyAllocate(pd, numNewPts);
 
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+  // Copy selected parts of cell data; certainly don't want normals
+  //
+  outCD->CopyNormalsOff();
+  outCD->CopyAllocate(cd, numNewCells);
+
+  // Second pass: create points along each polyline that are connected into
+  // a triangle strip. Texture coordinates are optionally generated.
+  //
+  std::vector<vtkIdType> sourcePts(numNewPts);
+  auto ribbonLines = [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = threadIds.Local();
+    for (vtkIdType lineId = begin; lineId < end; lineId++)
     {
-      singlePolyline->Reset(); // avoid instantiation
-      singlePolyline->InsertNextCell(npts, pts);
-      if (!vtkPolyLine::GenerateSlidingNormals(inPts, singlePolyline, inNormals))
+      vtkIdType npts = lineSizes[lineId];
+      if (npts <= 0)
       {
-        vtkWarningMacro(<< "No normals for line!");
-        continue; // skip tubing this polyline
+        continue;
+      }
+      const vtkIdType* pts;
+      inLines->GetCellAtId(lineId, npts, pts, ids);
+      const vtkIdType offset = pointOffsets[lineId];
+      this->GeneratePolyLinePoints(offset, npts, pts, inPts, newPts, sourcePts.data(),
+        newNormals, inScalars, range, lineNormals.data() + 3 * inLines->GetOffset(lineId));
+      if (newTCoords)
+      {
+        this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
       }
     }
+  };
+  if (this->SequentialProcessing)
+  {
+    ribbonLines(0, numLines);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numLines, ribbonLines);
+  }
 
-    // Generate the points around the polyline. The strip is not created
-    // if the polyline is bad.
-    //
-    if (!this->GeneratePoints(
-          offset, npts, pts, inPts, newPts, pd, outPD, newNormals, inScalars, range, inNormals))
+  // The strip of each polyline.
+  auto stripSize = [&](vtkIdType stripId) { return 2 * lineSizes[sourceCells[stripId]]; };
+  auto stripPoints = [&](vtkIdType stripId, vtkIdType* stripPts) {
+    const vtkIdType lineId = sourceCells[stripId];
+    this->GenerateStripIds(pointOffsets[lineId], lineSizes[lineId], stripPts);
+  };
+  bool builtStrips = true;
+  if (this->SequentialProcessing)
+  {
+    newStrips->AllocateExact(numNewCells, numNewPts);
+    std::vector<vtkIdType> buffer;
+    for (vtkIdType stripId = 0; stripId < numNewCells; stripId++)
     {
-      vtkWarningMacro(<< "Could not generate points!");
-      continue; // skip ribboning this polyline
+      buffer.resize(stripSize(stripId));
+      stripPoints(stripId, buffer.data());
+      newStrips->InsertNextCell(static_cast<vtkIdType>(buffer.size()), buffer.data());
     }
-
-    // Generate the strip for this polyline
-    //
-    this->GenerateStrip(offset, npts, pts, inCellId, cd, outCD, newStrips);
-
-    // Generate the texture coordinates for this polyline
-    //
+  }
+  else
+  {
+    builtStrips = newStrips->BuildCells(numNewCells, stripSize, stripPoints);
+  }
+  if (!builtStrips)
+  {
+    vtkErrorMacro(<< "Cannot allocate the output strips.");
     if (newTCoords)
     {
-      this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
+      newTCoords->Delete();
     }
-
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset, npts);
-
-  } // for all polylines
-
-  singlePolyline->Delete();
+    newPts->Delete();
+    newStrips->Delete();
+    newNormals->Delete();
+    return 0;
+  }
+  ::CopyAttributes(pd, outPD, sourcePts, this->SequentialProcessing);
+  ::CopyAttributes(cd, outCD, sourceCells, this->SequentialProcessing);
 
   // Update ourselves
   //
-  if (deleteNormals)
-  {
-    inNormals->Delete();
-  }
-
   if (newTCoords)
   {
     outPD->SetTCoords(newTCoords);
@@ -248,16 +418,18 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
   return 1;
 }
 
-int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
-  vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
-  vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inNormals)
+// Generate the points on both sides of the polyline, their normals and the
+// ids of the input points they come from. When newPts is nullptr, only check
+// that the polyline can be ribboned.
+int vtkRibbonFilter::GeneratePolyLinePoints(vtkIdType offset, vtkIdType npts,
+  const vtkIdType* pts, vtkPoints* inPts, vtkPoints* newPts, vtkIdType* sourceIds,
+  vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], const double* normals)
 {
   vtkIdType j;
   int i;
@@ -310,12 +482,13 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkI
       }
     }
 
-    inNormals->GetTuple(pts[j], n);
+    n[0] = normals[3 * j];
+    n[1] = normals[3 * j + 1];
+    n[2] = normals[3 * j + 2];
 
     if (vtkMath::Normalize(sNext) == 0.0)
     {
-      vtkWarningMacro(<< "Coincident points!");
-      return 0;
+      return 0; // coincident points
     }
 
     for (i = 0; i < 3; i++)
@@ -325,12 +498,8 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkI
     // if s is zero then just use sPrev cross n
     if (vtkMath::Normalize(s) == 0.0)
     {
-      vtkWarningMacro(<< "Using alternate bevel vector");
       vtkMath::Cross(sPrev, n, s);
-      if (vtkMath::Normalize(s) == 0.0)
-      {
-        vtkWarningMacro(<< "Using alternate bevel vector");
-      }
+      vtkMath::Normalize(s);
     }
     /*
         if ( (bevelAngle = vtkMath::Dot(sNext,sPrev)) > 1.0 )
@@ -352,9 +521,12 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkI
     vtkMath::Cross(s, n, w);
     if (vtkMath::Normalize(w) == 0.0)
     {
-      vtkWarningMacro(<< "Bad normal s = " << s[0] << " " << s[1] << " " << s[2] << " n = " << n[0]
-                      << " " << n[1] << " " << n[2]);
-      return 0;
+      return 0; // bad normal
+    }
+
+    if (!newPts)
+    {
+      continue;
     }
 
     vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
@@ -374,33 +546,70 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkI
       sp[i] = p[i] + this->Width * sFactor * v[i];
       sm[i] = p[i] - this->Width * sFactor * v[i];
     }
-    newPts->InsertPoint(ptId, sm);
-    newNormals->InsertTuple(ptId, nP);
-    outPD->CopyData(pd, pts[j], ptId);
+    newPts->SetPoint(ptId, sm);
+    newNormals->SetTuple(ptId, nP);
+    sourceIds[ptId] = pts[j];
     ptId++;
-    newPts->InsertPoint(ptId, sp);
-    newNormals->InsertTuple(ptId, nP);
-    outPD->CopyData(pd, pts[j], ptId);
+    newPts->SetPoint(ptId, sp);
+    newNormals->SetTuple(ptId, nP);
+    sourceIds[ptId] = pts[j];
     ptId++;
   } // for all points in polyline
 
   return 1;
 }
 
+// Write the 2 * npts point ids of the strip of a polyline.
+void vtkRibbonFilter::GenerateStripIds(vtkIdType offset, vtkIdType npts, vtkIdType* stripPts)
+{
+  for (vtkIdType i = 0; i < 2 * npts; i++)
+  {
+    stripPts[i] = offset + i;
+  }
+}
+
+// Deprecated: ribbon a single polyline with the normals of inNormals,
+// inserting the points and copying the point data one polyline at a time.
+int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
+  vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
+  vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inNormals)
+{
+  std::vector<double> normals(3 * npts);
+  for (vtkIdType j = 0; j < npts; j++)
+  {
+    inNormals->GetTuple(pts[j], normals.data() + 3 * j);
+  }
+  const vtkIdType numNewPts = this->ComputeOffset(offset, npts);
+  if (newPts->GetNumberOfPoints() < numNewPts)
+  {
+    newPts->SetNumberOfPoints(numNewPts);
+  }
+  if (newNormals->GetNumberOfTuples() < numNewPts)
+  {
+    newNormals->SetNumberOfTuples(numNewPts);
+  }
+  std::vector<vtkIdType> sourceIds(numNewPts);
+  if (!this->GeneratePolyLinePoints(offset, npts, pts, inPts, newPts, sourceIds.data(),
+        newNormals, inScalars, range, normals.data()))
+  {
+    return 0;
+  }
+  for (vtkIdType ptId = offset; ptId < numNewPts; ptId++)
+  {
+    outPD->CopyData(pd, sourceIds[ptId], ptId);
+  }
+  return 1;
+}
+
+// Deprecated: insert the strip of a single polyline and copy its cell data.
 void vtkRibbonFilter::GenerateStrip(vtkIdType offset, vtkIdType npts,
   const vtkIdType* vtkNotUsed(pts), vtkIdType inCellId, vtkCellData* cd, vtkCellData* outCD,
   vtkCellArray* newStrips)
 {
-  vtkIdType i, idx, outCellId;
-
-  outCellId = newStrips->InsertNextCell(npts * 2);
+  std::vector<vtkIdType> stripPts(2 * npts);
+  this->GenerateStripIds(offset, npts, stripPts.data());
+  const vtkIdType outCellId = newStrips->InsertNextCell(2 * npts, stripPts.data());
   outCD->CopyData(cd, inCellId, outCellId);
-  for (i = 0; i < npts; i++)
-  {
-    idx = 2 * i;
-    newStrips->InsertCellPoint(offset + idx);
-    newStrips->InsertCellPoint(offset + idx + 1);
-  }
 }
 
 void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
@@ -414,7 +623,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, co
   // The first texture coordinate is always 0.
   for (k = 0; k < 2; k++)
   {
-    newTCoords->InsertTuple2(offset + k, 0.0, 0.0);
+    newTCoords->SetTuple2(offset + k, 0.0, 0.0);
   }
   if (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars)
   {
@@ -425,7 +634,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, co
       tc = (s - s0) / this->TextureLength;
       for (k = 0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
+        newTCoords->SetTuple2(offset + i * 2 + k, tc, 0.0);
       }
     }
   }
@@ -440,7 +649,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, co
       tc = len / this->TextureLength;
       for (k = 0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
+        newTCoords->SetTuple2(offset + i * 2 + k, tc, 0.0);
       }
       xPrev[0] = x[0];
       xPrev[1] = x[1];
@@ -468,7 +677,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, co
       tc = len / length;
       for (k = 0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
+        newTCoords->SetTuple2(offset + i * 2 + k, tc, 0.0);
       }
       xPrev[0] = x[0];
       xPrev[1] = x[1];
@@ -521,4 +730,6 @@ void vtkRibbonFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Generate TCoords: " << this->GetGenerateTCoordsAsString() << endl;
   os << indent << "Texture Length: " << this->TextureLength << endl;
+  os << indent << "Sequential Processing: " << (this->SequentialProcessing ? "On" : "Off")
+     << endl;
 }
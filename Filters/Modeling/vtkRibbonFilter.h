@@ -23,6 +23,10 @@
  * the local line segment. An offset angle can be specified to rotate the
  * ribbon with respect to the normal.
  *
+ * The polylines are ribboned concurrently with vtkSMPTools, unless
+ * SequentialProcessing is on: their normals are computed and checked first,
+ * then the strips are generated at offsets known in advance.
+ *
  * @warning
  * The input line must not have duplicate points, or normals at points that
  * are parallel to the incoming/outgoing line segments. (Duplicate points
@@ -36,6 +40,7 @@
 #ifndef vtkRibbonFilter_h
 #define vtkRibbonFilter_h
 
+#include "vtkDeprecation.h"          // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersModelingModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
@@ -147,6 +152,17 @@ public:
   vtkGetMacro(TextureLength, double);
   ///@}
 
+  ///@{
+  /**
+   * Force sequential processing (i.e. single thread) of the polylines. By
+   * default, sequential processing is off: the polylines are ribboned
+   * concurrently with vtkSMPTools. The output is the same either way.
+   */
+  vtkSetMacro(SequentialProcessing, vtkTypeBool);
+  vtkGetMacro(SequentialProcessing, vtkTypeBool);
+  vtkBooleanMacro(SequentialProcessing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkRibbonFilter();
   ~vtkRibbonFilter() override;
@@ -160,11 +176,20 @@ protected:
   vtkTypeBool UseDefaultNormal;
   int GenerateTCoords;  // control texture coordinate generation
   double TextureLength; // this length is mapped to [0,1) texture space
-
-  // Helper methods
+  vtkTypeBool SequentialProcessing = false;
+
+  // Helper methods. The output of each polyline is written at offsets
+  // computed beforehand, so they are called concurrently for different
+  // polylines.
+  int GeneratePolyLinePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
+    vtkPoints* inPts, vtkPoints* newPts, vtkIdType* sourceIds, vtkFloatArray* newNormals,
+    vtkDataArray* inScalars, double range[2], const double* normals);
+  void GenerateStripIds(vtkIdType offset, vtkIdType npts, vtkIdType* stripPts);
+  VTK_DEPRECATED_IN_9_3_0("Use GeneratePolyLinePoints() instead.")
   int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkPoints* inPts,
     vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD, vtkFloatArray* newNormals,
     vtkDataArray* inScalars, double range[2], vtkDataArray* inNormals);
+  VTK_DEPRECATED_IN_9_3_0("Use GenerateStripIds() instead.")
   void GenerateStrip(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkIdType inCellId,
     vtkCellData* cd, vtkCellData* outCD, vtkCellArray* newStrips);
   void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
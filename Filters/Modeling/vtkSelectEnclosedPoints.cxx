@@ -36,6 +36,7 @@
 #include "vtkUnsignedCharArray.h"
 
 vtkStandardNewMacro(vtkSelectEnclosedPoints);
+vtkCxxSetObjectMacro(vtkSelectEnclosedPoints, CellLocator, vtkAbstractCellLocator);
 
 //------------------------------------------------------------------------------
 // Classes support threading. Each point can be processed separately, so the
@@ -53,7 +54,7 @@ struct SelectInOutCheck
   double Bounds[6];
   double Length;
   double Tolerance;
-  vtkStaticCellLocator* Locator;
+  vtkAbstractCellLocator* Locator;
   unsigned char* Hits;
   vtkSelectEnclosedPoints* Selector;
   vtkTypeBool InsideOut;
@@ -66,7 +67,7 @@ struct SelectInOutCheck
   vtkSMPThreadLocalObject<vtkGenericCell> Cell;
 
   SelectInOutCheck(vtkIdType numPts, vtkDataSet* ds, vtkPolyData* surface, double bds[6],
-    double tol, vtkStaticCellLocator* loc, unsigned char* hits, vtkSelectEnclosedPoints* sel,
+    double tol, vtkAbstractCellLocator* loc, unsigned char* hits, vtkSelectEnclosedPoints* sel,
     vtkTypeBool io)
     : NumPts(numPts)
     , DataSet(ds)
@@ -129,10 +130,18 @@ struct SelectInOutCheck
   void Reduce() {}
 
   static void Execute(vtkIdType numPts, vtkDataSet* ds, vtkPolyData* surface, double bds[6],
-    double tol, vtkStaticCellLocator* loc, unsigned char* hits, vtkSelectEnclosedPoints* sel)
+    double tol, vtkAbstractCellLocator* loc, unsigned char* hits, vtkSelectEnclosedPoints* sel)
   {
     SelectInOutCheck inOut(numPts, ds, surface, bds, tol, loc, hits, sel, sel->GetInsideOut());
-    vtkSMPTools::For(0, numPts, inOut);
+    if (loc->CanQueryConcurrently())
+    {
+      vtkSMPTools::For(0, numPts, inOut);
+    }
+    else
+    {
+      inOut.Initialize();
+      inOut(0, numPts);
+    }
   }
 }; // SelectInOutCheck
 
@@ -164,12 +173,7 @@ vtkSelectEnclosedPoints::~vtkSelectEnclosedPoints()
     this->InsideOutsideArray->Delete();
   }
 
-  if (this->CellLocator)
-  {
-    vtkAbstractCellLocator* loc = this->CellLocator;
-    this->CellLocator = nullptr;
-    loc->Delete();
-  }
+  this->SetCellLocator(nullptr);
 
   this->CellIds->Delete();
   this->Cell->Delete();
@@ -485,7 +489,10 @@ int vtkSelectEnclosedPoints::FillInputPortInformation(int port, vtkInformation*
 //------------------------------------------------------------------------------
 void vtkSelectEnclosedPoints::Complete()
 {
-  this->CellLocator->FreeSearchStructure();
+  if (this->CellLocator)
+  {
+    this->CellLocator->FreeSearchStructure();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -507,4 +514,6 @@ void vtkSelectEnclosedPoints::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Inside Out: " << (this->InsideOut ? "On\n" : "Off\n");
 
   os << indent << "Tolerance: " << this->Tolerance << "\n";
+
+  os << indent << "Cell Locator: " << this->CellLocator << "\n";
 }
@@ -55,7 +55,6 @@
 
 class vtkUnsignedCharArray;
 class vtkAbstractCellLocator;
-class vtkStaticCellLocator;
 class vtkIdList;
 class vtkGenericCell;
 class vtkRandomPool;
@@ -130,6 +129,18 @@ public:
   vtkGetMacro(Tolerance, double);
   ///@}
 
+  ///@{
+  /**
+   * Specify the locator used to find the cells of the surface along the
+   * rays. By default a vtkStaticCellLocator is created. A vtkBVHCellLocator
+   * may be faster on large surfaces made of cells of very different sizes.
+   * The points are tested concurrently, unless the locator does not
+   * support concurrent queries, such as a vtkOBBTree.
+   */
+  virtual void SetCellLocator(vtkAbstractCellLocator* locator);
+  vtkGetObjectMacro(CellLocator, vtkAbstractCellLocator);
+  ///@}
+
   ///@{
   /**
    * This is a backdoor that can be used to test many points for containment.
@@ -174,7 +185,7 @@ protected:
   vtkUnsignedCharArray* InsideOutsideArray;
 
   // Internal structures for accelerating the intersection test
-  vtkStaticCellLocator* CellLocator;
+  vtkAbstractCellLocator* CellLocator;
   vtkIdList* CellIds;
   vtkGenericCell* Cell;
   vtkPolyData* Surface;
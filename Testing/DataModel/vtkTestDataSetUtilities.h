@@ -0,0 +1,342 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestDataSetUtilities.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file   vtkTestDataSetUtilities.h
+ * @brief  helpers shared by the tests of the threaded code paths
+ *
+ * The tests of the classes and filters processing their data with
+ * vtkSMPTools compare the threaded results with the results of the
+ * sequential code path. These helpers check conditions, select a threaded
+ * or the sequential SMP backend, compare data sets exactly, tuple by tuple
+ * and cell by cell, and run a filter along both code paths.
+ */
+
+#ifndef vtkTestDataSetUtilities_h
+#define vtkTestDataSetUtilities_h
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Print the condition and its line, then return EXIT_FAILURE from the calling
+ * test function, if the condition is false.
+ */
+#define VTK_TEST_CHECK(cond)                                                                       \
+  do                                                                                               \
+  {                                                                                                \
+    if (!(cond))                                                                                   \
+    {                                                                                              \
+      std::cerr << "Failed (line " << __LINE__ << "): " #cond << std::endl;                        \
+      return EXIT_FAILURE;                                                                         \
+    }                                                                                              \
+  } while (false)
+
+namespace vtkTestDataSetUtilities
+{
+/**
+ * Use the STDThread backend with several threads, even on a single core, for
+ * the lifetime of the object, and restore the previous backend afterwards.
+ * Tests return VTK_SKIP_RETURN_CODE (125) when the backend is not available.
+ */
+class ThreadedBackend
+{
+public:
+  ThreadedBackend(int numberOfThreads = 4)
+    : PreviousBackend(vtkSMPTools::GetBackend())
+    , Available(vtkSMPTools::SetBackend("STDThread"))
+  {
+    if (this->Available)
+    {
+      vtkSMPTools::Initialize(numberOfThreads);
+    }
+  }
+
+  ~ThreadedBackend()
+  {
+    vtkSMPTools::Initialize();
+    vtkSMPTools::SetBackend(this->PreviousBackend.c_str());
+  }
+
+  bool IsAvailable() const { return this->Available; }
+
+private:
+  ThreadedBackend(const ThreadedBackend&) = delete;
+  void operator=(const ThreadedBackend&) = delete;
+
+  std::string PreviousBackend;
+  bool Available;
+};
+
+/**
+ * Call the functor with the Sequential backend, and return its result. The
+ * backend in use is restored afterwards.
+ */
+template <typename TFunctor>
+typename std::decay<decltype(std::declval<TFunctor&>()())>::type RunSequentially(TFunctor&& run)
+{
+  typename std::decay<decltype(run())>::type result{};
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ std::string("Sequential") }, [&]() { result = run(); });
+  return result;
+}
+
+/**
+ * Call the functor with the Sequential backend, then with the backend in
+ * use, and return whether both calls return equal results.
+ */
+template <typename TFunctor>
+bool SameAsSequentialBackend(TFunctor&& run)
+{
+  const auto sequential = RunSequentially(run);
+  return run() == sequential;
+}
+
+/**
+ * Whether the tuple id of the 3 components array is (x, y, z), up to the
+ * tolerance.
+ */
+inline bool HasTuple(
+  vtkDataArray* array, vtkIdType id, double x, double y, double z, double tol = 1e-12)
+{
+  double t[3];
+  array->GetTuple(id, t);
+  return std::abs(t[0] - x) < tol && std::abs(t[1] - y) < tol && std::abs(t[2] - z) < tol;
+}
+
+/**
+ * Whether the cell cellId of the data set has the given point ids, in the
+ * same order.
+ */
+inline bool HasCellPoints(vtkDataSet* dataSet, vtkIdType cellId, const std::vector<vtkIdType>& ids)
+{
+  vtkNew<vtkIdList> cellPts;
+  dataSet->GetCellPoints(cellId, cellPts);
+  return cellPts->GetNumberOfIds() == static_cast<vtkIdType>(ids.size()) &&
+    std::equal(ids.begin(), ids.end(), cellPts->GetPointer(0));
+}
+
+/**
+ * Whether the attributes have the same arrays, in the same order, with the
+ * same names, types and values.
+ */
+inline bool SameAttributes(vtkDataSetAttributes* expected, vtkDataSetAttributes* actual)
+{
+  if (expected->GetNumberOfArrays() != actual->GetNumberOfArrays())
+  {
+    std::cerr << "Expected " << expected->GetNumberOfArrays() << " arrays, got "
+              << actual->GetNumberOfArrays() << std::endl;
+    return false;
+  }
+  for (int i = 0; i < expected->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* e = expected->GetArray(i);
+    vtkDataArray* a = actual->GetArray(i);
+    if (!e || !a)
+    {
+      if (e != a)
+      {
+        std::cerr << "Array " << i << " is not a data array in both outputs" << std::endl;
+        return false;
+      }
+      continue;
+    }
+    const std::string name = e->GetName() ? e->GetName() : "";
+    if ((a->GetName() ? a->GetName() : "") != name || e->GetDataType() != a->GetDataType() ||
+      e->GetNumberOfTuples() != a->GetNumberOfTuples() ||
+      e->GetNumberOfComponents() != a->GetNumberOfComponents())
+    {
+      std::cerr << "Array " << i << " (" << name << ") differs" << std::endl;
+      return false;
+    }
+    const int numComps = e->GetNumberOfComponents();
+    for (vtkIdType t = 0; t < e->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        if (e->GetComponent(t, c) != a->GetComponent(t, c))
+        {
+          std::cerr << "Tuple " << t << " of array " << name << " differs" << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Whether the data sets have the same coordinates for all their points.
+ */
+inline bool SamePoints(vtkDataSet* expected, vtkDataSet* actual)
+{
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints())
+  {
+    std::cerr << "Expected " << expected->GetNumberOfPoints() << " points, got "
+              << actual->GetNumberOfPoints() << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i)
+  {
+    double e[3], a[3];
+    expected->GetPoint(i, e);
+    actual->GetPoint(i, a);
+    if (e[0] != a[0] || e[1] != a[1] || e[2] != a[2])
+    {
+      std::cerr << "Point " << i << " differs" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Whether the data sets have the same points, the same cells (types and
+ * point ids, in the same order) and the same point and cell data.
+ */
+inline bool SameDataSets(vtkDataSet* expected, vtkDataSet* actual)
+{
+  if (expected->GetNumberOfCells() != actual->GetNumberOfCells())
+  {
+    std::cerr << "Expected " << expected->GetNumberOfCells() << " cells, got "
+              << actual->GetNumberOfCells() << std::endl;
+    return false;
+  }
+  vtkPointSet* expectedPointSet = vtkPointSet::SafeDownCast(expected);
+  vtkPointSet* actualPointSet = vtkPointSet::SafeDownCast(actual);
+  if (expectedPointSet && actualPointSet && expectedPointSet->GetPoints() &&
+    actualPointSet->GetPoints() &&
+    expectedPointSet->GetPoints()->GetDataType() != actualPointSet->GetPoints()->GetDataType())
+  {
+    std::cerr << "Points of different types" << std::endl;
+    return false;
+  }
+  if (!SamePoints(expected, actual))
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> e, a;
+  for (vtkIdType i = 0; i < expected->GetNumberOfCells(); ++i)
+  {
+    expected->GetCellPoints(i, e);
+    actual->GetCellPoints(i, a);
+    bool same = expected->GetCellType(i) == actual->GetCellType(i) &&
+      e->GetNumberOfIds() == a->GetNumberOfIds();
+    for (vtkIdType j = 0; same && j < e->GetNumberOfIds(); ++j)
+    {
+      same = e->GetId(j) == a->GetId(j);
+    }
+    if (!same)
+    {
+      std::cerr << "Cell " << i << " differs" << std::endl;
+      return false;
+    }
+  }
+  return SameAttributes(expected->GetPointData(), actual->GetPointData()) &&
+    SameAttributes(expected->GetCellData(), actual->GetCellData());
+}
+
+/**
+ * Update the filter with its SequentialProcessing option on, then off, and
+ * return whether both outputs are the same data sets.
+ */
+template <typename TFilter>
+bool SameAsSequential(TFilter* filter)
+{
+  filter->SequentialProcessingOn();
+  filter->Update();
+  vtkSmartPointer<vtkDataSet> sequential =
+    vtkSmartPointer<vtkDataSet>::Take(filter->GetOutput()->NewInstance());
+  sequential->DeepCopy(filter->GetOutput());
+  filter->SequentialProcessingOff();
+  filter->Update();
+  return SameDataSets(sequential, filter->GetOutput());
+}
+
+/**
+ * Two straight polylines along x, of 3 points from the origin and of 2 points
+ * from (0, 5, 0), 1 apart. Their cells have the ids 10 and 11 in a "CellIds"
+ * cell array.
+ */
+inline vtkSmartPointer<vtkPolyData> MakeStraightPolyLines()
+{
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  const vtkIdType line0[3] = { 0, 1, 2 };
+  const vtkIdType line1[2] = { 3, 4 };
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(2, 0, 0);
+  points->InsertNextPoint(0, 5, 0);
+  points->InsertNextPoint(1, 5, 0);
+  lines->InsertNextCell(3, line0);
+  lines->InsertNextCell(2, line1);
+  cellIds->InsertNextValue(10);
+  cellIds->InsertNextValue(11);
+  input->SetPoints(points);
+  input->SetLines(lines);
+  input->GetCellData()->AddArray(cellIds);
+  return input;
+}
+
+/**
+ * A closed, non planar loop of numberOfPoints points around the z axis, whose
+ * last point id is its first one.
+ */
+inline vtkSmartPointer<vtkPolyData> MakeClosedLoop(int numberOfPoints)
+{
+  auto loop = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(numberOfPoints + 1);
+  for (int i = 0; i < numberOfPoints; ++i)
+  {
+    const double t = 2.0 * vtkMath::Pi() * i / numberOfPoints;
+    lines->InsertCellPoint(
+      points->InsertNextPoint(std::cos(t), std::sin(t), 0.4 * std::sin(3 * t)));
+  }
+  lines->InsertCellPoint(0);
+  loop->SetPoints(points);
+  loop->SetLines(lines);
+  return loop;
+}
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkTestDataSetUtilities.h